@@ -6,6 +6,7 @@
 #include "expr/expression.h"
 #include "aggregate_plan.h"
 #include <value.h>
+#include <pthread.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,7 +36,15 @@ typedef enum {
   QEXEC_F_NOROWS = 0x800,
 
   /* Do not stringify result values. Send them in their proper types */
-  QEXEC_F_TYPED = 0x1000
+  QEXEC_F_TYPED = 0x1000,
+
+  // Reducers emit mergeable partial state (binary blobs) instead of final
+  // values, for shard-local pre-aggregation (see aggregate/partials.h)
+  QEXEC_F_PARTIALS = 0x2000,
+
+  // Stateless cursor: no server-side cursor state; the reply carries the last
+  // emitted docId as a continuation token and RESUMEAFTER restarts past it
+  QEXEC_F_STATELESS_CURSOR = 0x4000
 
 } QEFlags;
 
@@ -89,11 +98,52 @@ typedef struct {
 
   /** Query timeout in milliseconds */
   uint32_t tmoMS;
+
+  /* Stateless cursor: resume floor from RESUMEAFTER, and the last docId the
+   * reply serializer emitted (the next continuation token) */
+  t_docId resumeAfter;
+  t_docId lastDocId;
+
+  /* Slow log arming: the command line kept for attribution, set when the
+   * request was instrumented because SLOWLOG_THRESHOLD_MS is active */
+  sds slowlogCmd;
+
+  /* Set when this request holds one slot of its spec's concurrent-query
+   * quota (released at free) */
+  int queryQuotaHeld;
   uint32_t tmoPolicy;
 
   /** Cursor settings */
   unsigned cursorMaxIdle;
   unsigned cursorChunkSize;
+
+  /** When the result cache is recording this request's reply, the recorder
+   * the reply helpers mirror into (see result_cache.h); NULL otherwise */
+  struct CachedReply *replyRecord;
+
+  /** FT.PROFILE instrumentation; NULL for regular requests */
+  struct QueryProfile *profile;
+
+  /** SCORER EXPR:<expression> - the parsed scoring expression, owned here
+   * until the pipeline's scoring processor takes it */
+  struct RSExpr *scoreExpr;
+
+  /**
+   * Cursor read-ahead staging (CURSOR_READAHEAD): rows pulled by a background
+   * task between FT.CURSOR READ calls. Guarded by `lock`; see
+   * cursorPrefetchTask in aggregate_exec.c for the claim/cancel protocol.
+   */
+  struct {
+    SearchResult *rows;  // staged rows, served before the live pipeline
+    uint32_t len, pos;
+    int endRC;      // terminal RS_RESULT code hit while staging, or RS_RESULT_OK
+    int active;     // a background task is pending or running
+    int started;    // the task has entered (or passed) its GIL section
+    int claimed;    // a READ arrived first - task must not touch the pipeline
+    int cancelled;  // the request is being freed - task performs the free
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+  } prefetch;
 } AREQ;
 
 /**
@@ -208,6 +258,19 @@ ResultProcessor *Grouper_GetRP(Grouper *gr);
  */
 void Grouper_AddReducer(Grouper *g, Reducer *r, RLookupKey *dst);
 
+/* Emit mergeable partial blobs instead of final values (WITHPARTIALS) */
+void Grouper_SetPartials(Grouper *g);
+
+/** Whether every reducer of this grouper supports merging partial results */
+int Grouper_CanMerge(const Grouper *gr);
+
+/**
+ * Fold the groups accumulated in `src` into `dst`. Both groupers must share
+ * the same group keys and reducer list. `src` stays intact (its owner still
+ * frees it). Returns 0 when some reducer has no Merge implementation.
+ */
+int Grouper_MergePartial(Grouper *dst, Grouper *src);
+
 void AREQ_Execute(AREQ *req, RedisModuleCtx *outctx);
 void AREQ_Free(AREQ *req);
 
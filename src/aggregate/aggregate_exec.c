@@ -2,12 +2,87 @@
 #include "redisearch.h"
 #include "search_ctx.h"
 #include "aggregate.h"
+#include "trace.h"
 #include "cursor.h"
+#include "concurrent_ctx.h"
 #include "rmutil/util.h"
+#include "result_cache.h"
+#include "config.h"
+#include "profile.h"
+#include "query_node.h"
+#include "util/arr.h"
+#include "rmutil/sds.h"
+#include <strings.h>
 
 typedef enum { COMMAND_AGGREGATE, COMMAND_SEARCH, COMMAND_EXPLAIN } CommandType;
 static void runCursor(RedisModuleCtx *outputCtx, Cursor *cursor, size_t num);
 
+/* Reply helpers used by the serialization below: they write to the client
+ * and, when the result cache is recording this request, mirror the element
+ * into the recorder so the reply can be replayed on a future hit */
+static void replyLongLong(AREQ *req, RedisModuleCtx *ctx, long long v) {
+  RedisModule_ReplyWithLongLong(ctx, v);
+  if (req->replyRecord) CachedReply_LongLong(req->replyRecord, v);
+}
+
+static void replyDouble(AREQ *req, RedisModuleCtx *ctx, double v) {
+  RedisModule_ReplyWithDouble(ctx, v);
+  if (req->replyRecord) CachedReply_Double(req->replyRecord, v);
+}
+
+static void replyStringBuffer(AREQ *req, RedisModuleCtx *ctx, const char *s, size_t n) {
+  RedisModule_ReplyWithStringBuffer(ctx, s, n);
+  if (req->replyRecord) CachedReply_StringBuffer(req->replyRecord, s, n);
+}
+
+static void replySimpleString(AREQ *req, RedisModuleCtx *ctx, const char *s) {
+  RedisModule_ReplyWithSimpleString(ctx, s);
+  if (req->replyRecord) CachedReply_SimpleString(req->replyRecord, s);
+}
+
+static void replyNull(AREQ *req, RedisModuleCtx *ctx) {
+  RedisModule_ReplyWithNull(ctx);
+  if (req->replyRecord) CachedReply_Null(req->replyRecord);
+}
+
+static void replyValue(AREQ *req, RedisModuleCtx *ctx, const RSValue *v) {
+  RSValue_SendReply(ctx, v, req->reqflags & QEXEC_F_TYPED);
+  if (req->replyRecord) CachedReply_Value(req->replyRecord, v, req->reqflags & QEXEC_F_TYPED);
+}
+
+/* Postponed-length arrays: the recorder stores the final count in place */
+static size_t replyBeginArray(AREQ *req, RedisModuleCtx *ctx) {
+  RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+  return req->replyRecord ? CachedReply_BeginArray(req->replyRecord) : 0;
+}
+
+static void replyEndArray(AREQ *req, RedisModuleCtx *ctx, size_t token, long long len) {
+  RedisModule_ReplySetArrayLength(ctx, len);
+  if (req->replyRecord) CachedReply_EndArray(req->replyRecord, token, len);
+}
+
+/* Per-thread scratch for formatting reply elements. Reused across rows and
+ * requests, so serializing a page formats in place and emits through
+ * ReplyWithStringBuffer instead of allocating a RedisModuleString per row
+ * (those stay attached to the context until the command ends). Grows to the
+ * largest element this thread ever formatted and is never released */
+static __thread struct {
+  char *buf;
+  size_t cap;
+} replyScratch_g;
+
+static char *replyScratch(size_t n) {
+  if (replyScratch_g.cap < n) {
+    size_t newcap = replyScratch_g.cap ? replyScratch_g.cap : 256;
+    while (newcap < n) {
+      newcap *= 2;
+    }
+    replyScratch_g.buf = rm_realloc(replyScratch_g.buf, newcap);
+    replyScratch_g.cap = newcap;
+  }
+  return replyScratch_g.buf;
+}
+
 /**
  * Get the sorting key of the result. This will be the sorting key of the last
  * RLookup registry. Returns NULL if there is no sorting key
@@ -29,24 +104,27 @@ static size_t serializeResult(AREQ *req, RedisModuleCtx *outctx, const SearchRes
   const uint32_t options = req->reqflags;
   const RSDocumentMetadata *dmd = r->dmd;
   size_t count = 0;
+  if (r->docId) {
+    req->lastDocId = r->docId;  // stateless-cursor continuation token
+  }
 
   if (dmd && (req->reqflags & QEXEC_F_IS_SEARCH)) {
     size_t n;
     const char *s = DMD_KeyPtrLen(dmd, &n);
-    RedisModule_ReplyWithStringBuffer(outctx, s, n);
+    replyStringBuffer(req, outctx, s, n);
     count++;
   }
 
   if (options & QEXEC_F_SEND_SCORES) {
-    RedisModule_ReplyWithDouble(outctx, r->score);
+    replyDouble(req, outctx, r->score);
     count++;
   }
   if (options & QEXEC_F_SEND_PAYLOADS) {
     count++;
     if (dmd && dmd->payload) {
-      RedisModule_ReplyWithStringBuffer(outctx, dmd->payload->data, dmd->payload->len);
+      replyStringBuffer(req, outctx, dmd->payload->data, dmd->payload->len);
     } else {
-      RedisModule_ReplyWithNull(outctx);
+      replyNull(req, outctx);
     }
   }
 
@@ -55,36 +133,44 @@ static size_t serializeResult(AREQ *req, RedisModuleCtx *outctx, const SearchRes
     const RSValue *sortkey = getSortKey(req, r);
     if (sortkey) {
       switch (sortkey->t) {
-        case RSValue_Number:
-          /* Serialize double - by prepending "%" to the number, so the coordinator/client can
+        case RSValue_Number: {
+          /* Serialize double - by prepending "#" to the number, so the coordinator/client can
            * tell it's a double and not just a numeric string value */
-          RedisModule_ReplyWithString(
-              outctx, RedisModule_CreateStringPrintf(outctx, "#%.17g", sortkey->numval));
+          char *buf = replyScratch(32);
+          int n = snprintf(buf, 32, "#%.17g", sortkey->numval);
+          replyStringBuffer(req, outctx, buf, n);
           break;
-        case RSValue_String:
+        }
+        case RSValue_String: {
           /* Serialize string - by prepending "$" to it */
-
-          RedisModule_ReplyWithString(
-              outctx, RedisModule_CreateStringPrintf(outctx, "$%s", sortkey->strval));
+          char *buf = replyScratch(sortkey->strval.len + 1);
+          buf[0] = '$';
+          memcpy(buf + 1, sortkey->strval.str, sortkey->strval.len);
+          replyStringBuffer(req, outctx, buf, sortkey->strval.len + 1);
           break;
-        case RSValue_RedisString:
-          RedisModule_ReplyWithString(
-              outctx, RedisModule_CreateStringPrintf(
-                          outctx, "$%s", RedisModule_StringPtrLen(sortkey->rstrval, NULL)));
+        }
+        case RSValue_RedisString: {
+          size_t n;
+          const char *s = RedisModule_StringPtrLen(sortkey->rstrval, &n);
+          char *buf = replyScratch(n + 1);
+          buf[0] = '$';
+          memcpy(buf + 1, s, n);
+          replyStringBuffer(req, outctx, buf, n + 1);
           break;
+        }
         default:
           // NIL, or any other type:
-          RedisModule_ReplyWithNull(outctx);
+          replyNull(req, outctx);
       }
     } else {
-      RedisModule_ReplyWithNull(outctx);
+      replyNull(req, outctx);
     }
   }
 
   if (!(options & QEXEC_F_SEND_NOFIELDS)) {
     count++;
     size_t nfields = 0;
-    REDISMODULE_BEGIN_ARRAY(outctx);
+    size_t arrTok = replyBeginArray(req, outctx);
     RLookup *lk = AGPLN_GetLookup(&req->ap, NULL, AGPLN_GETLOOKUP_LAST);
 
     for (const RLookupKey *kk = lk->head; kk; kk = kk->next) {
@@ -98,14 +184,42 @@ static size_t serializeResult(AREQ *req, RedisModuleCtx *outctx, const SearchRes
       }
 
       nfields++;
-      RedisModule_ReplyWithSimpleString(outctx, kk->name);
-      RSValue_SendReply(outctx, v, req->reqflags & QEXEC_F_TYPED);
+      replySimpleString(req, outctx, kk->name);
+      replyValue(req, outctx, v);
     }
-    REDISMODULE_END_ARRAY(outctx, nfields * 2);
+    replyEndArray(req, outctx, arrTok, nfields * 2);
   }
   return count;
 }
 
+/* Cost checker armed for each execution slice: enforces the request timeout
+ * inside heavy iterator operations - where per-result ticks cannot reach -
+ * and offers the GIL at the adaptive quantum between them */
+static int execCostCheck(void *arg) {
+  AREQ *req = arg;
+  if (req->conc.isLocked) {
+    ConcurrentSearch_CheckTimer(&req->conc);
+  }
+  if (!req->tmoMS) {
+    return 0;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  long long ms = (now.tv_sec - req->qiter.startTime.tv_sec) * 1000LL +
+                 (now.tv_nsec - req->qiter.startTime.tv_nsec) / 1000000;
+  if (ms >= (long long)req->tmoMS) {
+    req->qiter.state = QITR_S_TIMEDOUT;
+    return 1;
+  }
+  return 0;
+}
+
+/* Yield point inside the execution slice: on async (pool) execution the conc
+ * context is armed, and the adaptive quantum decides when to hand the GIL
+ * (and the index read lock with it) to whoever is waiting. The relock
+ * revalidates the registered keys, so iterators stay correct across GC */
+#define EXEC_YIELD_TICK(req)                      if ((req)->conc.isLocked) {                       CONCURRENT_CTX_TICK(&(req)->conc);            }
+
 /**
  * Sends a chunk of <n> rows, optionally also sending the preamble
  */
@@ -115,12 +229,59 @@ static int sendChunk(AREQ *req, RedisModuleCtx *outctx, size_t limit) {
   SearchResult r = {0};
   int rc = RS_RESULT_EOF;
   ResultProcessor *rp = req->qiter.endProc;
-
-  RedisModule_ReplyWithArray(outctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+  // The whole pull is one reader slice: no structural writer (GC apply,
+  // teardown) can move index blocks under the pipeline's iterators. The
+  // yield ticks release and retake it together with the GIL
+  IndexSpec *spec = req->sctx ? req->sctx->spec : NULL;
+  if (spec) {
+    IndexSpec_LockRead(spec);
+    req->conc.indexSpec = spec;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &req->qiter.startTime);
+  RS_CostAccountingArm(execCostCheck, req);
+
+  size_t topArrTok = replyBeginArray(req, outctx);
+
+  if (req->prefetch.pos < req->prefetch.len || req->prefetch.endRC != RS_RESULT_OK) {
+    // Rows staged by the read-ahead task. The totals were accumulated when the
+    // task pulled them, so the count can be written up front.
+    replyLongLong(req, outctx, req->qiter.totalResults);
+    nelem++;
+    while (req->prefetch.pos < req->prefetch.len && nrows < limit) {
+      SearchResult *sr = &req->prefetch.rows[req->prefetch.pos++];
+      nrows++;
+      if (!(req->reqflags & QEXEC_F_NOROWS)) {
+        nelem += serializeResult(req, outctx, sr);
+      }
+      SearchResult_Destroy(sr);
+    }
+    if (req->prefetch.pos < req->prefetch.len) {
+      // The client asked for fewer rows than were staged; keep the remainder
+      rc = RS_RESULT_OK;
+      goto done;
+    }
+    free(req->prefetch.rows);
+    req->prefetch.rows = NULL;
+    req->prefetch.len = req->prefetch.pos = 0;
+    rc = req->prefetch.endRC;
+    if (rc != RS_RESULT_OK) {
+      goto done;
+    }
+    // The staged batch is drained and the pipeline is still live - keep pulling
+    while (nrows++ < limit && (rc = rp->Next(rp, &r)) == RS_RESULT_OK) {
+      nelem += serializeResult(req, outctx, &r);
+      SearchResult_Clear(&r);
+      EXEC_YIELD_TICK(req);
+    }
+    goto done;
+  }
 
   rc = rp->Next(rp, &r);
-  RedisModule_ReplyWithLongLong(outctx, req->qiter.totalResults);
+  replyLongLong(req, outctx, req->qiter.totalResults);
   nelem++;
+  if (rc == RS_RESULT_OK) {
+    RS_TRACE_FIRST_RESULT(req->query);
+  }
   if (rc == RS_RESULT_OK && nrows++ < limit && !(req->reqflags & QEXEC_F_NOROWS)) {
     nelem += serializeResult(req, outctx, &r);
   }
@@ -134,6 +295,10 @@ static int sendChunk(AREQ *req, RedisModuleCtx *outctx, size_t limit) {
     // Serialize it as a search result
     nelem += serializeResult(req, outctx, &r);
     SearchResult_Clear(&r);
+    if (nrows % RSTRACE_NRESULTS_INTERVAL == 0) {
+      RS_TRACE_NRESULTS(req->query, nrows);
+    }
+    EXEC_YIELD_TICK(req);
   }
 
 done:
@@ -143,7 +308,13 @@ done:
   }
   // Reset the total results length:
   req->qiter.totalResults = 0;
-  RedisModule_ReplySetArrayLength(outctx, nelem);
+  replyEndArray(req, outctx, topArrTok, nelem);
+  RS_TRACE_REPLY_FLUSHED(req->query, nrows);
+  RS_CostAccountingDisarm();
+  if (spec) {
+    req->conc.indexSpec = NULL;
+    IndexSpec_UnlockIndex(spec);
+  }
   return REDISMODULE_OK;
 }
 
@@ -152,12 +323,88 @@ void AREQ_Execute(AREQ *req, RedisModuleCtx *outctx) {
   AREQ_Free(req);
 }
 
+/* Collect the literal terms a parsed query depends on, for epoch-based cache
+ * invalidation. Node types whose result set any write can change (numeric,
+ * geo, tag, prefix expansion, NOT, ...) set *dependsOnAll instead */
+static void collectQueryTerms(const QueryNode *n, const char ***terms, size_t **lens,
+                              int *dependsOnAll) {
+  if (!n || *dependsOnAll) {
+    return;
+  }
+  switch (n->type) {
+    case QN_TOKEN:
+      *terms = array_append(*terms, (const char *)n->tn.str);
+      *lens = array_append(*lens, (size_t)n->tn.len);
+      return;
+    case QN_PHRASE:
+      for (int i = 0; i < n->pn.numChildren; ++i) {
+        collectQueryTerms(n->pn.children[i], terms, lens, dependsOnAll);
+      }
+      return;
+    case QN_UNION:
+      for (int i = 0; i < n->un.numChildren; ++i) {
+        collectQueryTerms(n->un.children[i], terms, lens, dependsOnAll);
+      }
+      return;
+    case QN_OPTIONAL:
+      collectQueryTerms(n->opt.child, terms, lens, dependsOnAll);
+      return;
+    case QN_NULL:
+      return;
+    default:
+      // NOT, numeric, geo, tag, prefix/fuzzy/lexrange expansion, ids,
+      // wildcard: per-term epochs cannot cover these
+      *dependsOnAll = 1;
+      return;
+  }
+}
+
+static sds buildCacheKey(RedisModuleString **argv, int argc) {
+  sds key = sdsempty();
+  for (int i = 0; i < argc; ++i) {
+    size_t n;
+    const char *s = RedisModule_StringPtrLen(argv[i], &n);
+    key = sdscatlen(key, s, n);
+    key = sdscatlen(key, "\0", 1);
+  }
+  return key;
+}
+
+/* Execute a cacheable request: the reply is recorded while it streams to the
+ * client and stored on success, with the query's term epochs captured */
+static void execWithResultCache(AREQ *r, RedisModuleCtx *ctx, ResultCache *rcache, sds cacheKey,
+                                long long ttlMs) {
+  r->replyRecord = CachedReply_New();
+  sendChunk(r, ctx, -1);
+
+  CachedReply *rec = r->replyRecord;
+  r->replyRecord = NULL;
+  if (r->stateflags & QEXEC_S_ERROR) {
+    CachedReply_Free(rec);
+  } else {
+    ARRAY_INLINE_STORAGE(const char *, 8) termsStorage;
+    ARRAY_INLINE_STORAGE(size_t, 8) lensStorage;
+    const char **terms = array_new_inline(const char *, termsStorage);
+    size_t *lens = array_new_inline(size_t, lensStorage);
+    int dependsOnAll = 0;
+    collectQueryTerms(r->ast.root, &terms, &lens, &dependsOnAll);
+    ResultCache_Put(rcache, cacheKey, sdslen(cacheKey), rec, terms, lens, array_len(terms),
+                    dependsOnAll, ttlMs);
+    array_free(terms);
+    array_free(lens);
+  }
+  AREQ_Free(r);
+}
+
 static int buildRequest(RedisModuleCtx *ctx, RedisModuleString **argv, int argc, int type,
-                        QueryError *status, AREQ **r) {
+                        int profile, QueryError *status, AREQ **r) {
 
   int rc = REDISMODULE_ERR;
   const char *indexname = RedisModule_StringPtrLen(argv[1], NULL);
   *r = AREQ_New();
+  if (profile) {
+    (*r)->profile = QueryProfile_New();
+  }
   RedisSearchCtx *sctx = NULL;
   RedisModuleCtx *thctx = NULL;
 
@@ -165,6 +412,23 @@ static int buildRequest(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
     (*r)->reqflags |= QEXEC_F_IS_SEARCH;
   }
 
+  // Slow log arming: instrument with the profile machinery and keep the
+  // command line, so an over-threshold run can be attributed stage by stage.
+  // The reply shape is untouched - only FT.PROFILE renders the profile
+  if (!profile && RSGlobalConfig.slowlogThresholdMs > 0) {
+    (*r)->profile = QueryProfile_New();
+    sds cmd = sdsempty();
+    for (int i = 0; i < argc; i++) {
+      size_t n;
+      const char *s = RedisModule_StringPtrLen(argv[i], &n);
+      cmd = sdscatlen(cmd, s, n);
+      if (i + 1 < argc) {
+        cmd = sdscatlen(cmd, " ", 1);
+      }
+    }
+    (*r)->slowlogCmd = cmd;
+  }
+
   if (AREQ_Compile(*r, argv + 2, argc - 2, status) != REDISMODULE_OK) {
     assert(QueryError_HasError(status));
     goto done;
@@ -192,6 +456,9 @@ static int buildRequest(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
   }
 
   rc = AREQ_BuildPipeline(*r, 0, status);
+  if (rc == REDISMODULE_OK && (*r)->profile) {
+    QueryProfile_InstrumentPipeline((*r)->profile, &(*r)->qiter);
+  }
 
 done:
   if (rc != REDISMODULE_OK && *r) {
@@ -205,7 +472,7 @@ done:
 }
 
 static int execCommandCommon(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
-                             CommandType type) {
+                             CommandType type, int profile, int onThread) {
   // Index name is argv[1]
   if (argc < 2) {
     return RedisModule_WrongArity(ctx);
@@ -215,16 +482,100 @@ static int execCommandCommon(RedisModuleCtx *ctx, RedisModuleString **argv, int
   AREQ *r = NULL;
   QueryError status = {0};
 
-  if (buildRequest(ctx, argv, argc, type, &status, &r) != REDISMODULE_OK) {
+  if (buildRequest(ctx, argv, argc, type, profile, &status, &r) != REDISMODULE_OK) {
     goto error;
   }
 
+  // Tenant admission: one quota slot per in-flight search/aggregate command
+  if (r->sctx && r->sctx->spec && r->sctx->spec->maxConcurrentQueries > 0) {
+    IndexSpec *qsp = r->sctx->spec;
+    if (__atomic_add_fetch(&qsp->activeQueries, 1, __ATOMIC_ACQ_REL) >
+        (uint32_t)qsp->maxConcurrentQueries) {
+      __atomic_sub_fetch(&qsp->activeQueries, 1, __ATOMIC_ACQ_REL);
+      QueryError_SetError(&status, QUERY_EQUOTA, "Too many concurrent queries for this index");
+      AREQ_Free(r);
+      r = NULL;
+      goto error;
+    }
+    r->queryQuotaHeld = 1;
+  }
+
+  if (onThread && !profile && !(r->reqflags & QEXEC_F_IS_CURSOR)) {
+    // Arm the yield machinery: the dispatcher holds the GIL on our behalf,
+    // and the execution ticks hand it (plus the index read lock) over at the
+    // adaptive quantum so long queries stop monopolizing the server
+    r->conc.isLocked = 1;
+    ConcurrentSearchCtx_ResetClock(&r->conc);
+  }
+
+  if (profile) {
+    if (r->reqflags & QEXEC_F_IS_CURSOR) {
+      QueryError_SetError(&status, QUERY_EPARSEARGS, "FT.PROFILE does not support cursors");
+      goto error;
+    }
+    // [results, profile]
+    RedisModule_ReplyWithArray(ctx, 2);
+    sendChunk(r, ctx, -1);
+    QueryProfile_Reply(r->profile, ctx);
+    AREQ_Free(r);
+    return REDISMODULE_OK;
+  }
+
+  if (r->reqflags & QEXEC_F_STATELESS_CURSOR) {
+    // No retained state: emission must be raw docId order, so the score-sorted
+    // FT.SEARCH shape, sorting, grouping and the stateful cursor are all off
+    // the table - this is an FT.AGGREGATE full-scan export mode
+    if ((r->reqflags & (QEXEC_F_IS_CURSOR | QEXEC_F_IS_SEARCH)) ||
+        AGPLN_FindStep(&r->ap, NULL, NULL, PLN_T_GROUP) != NULL) {
+      QueryError_SetError(&status, QUERY_EPARSEARGS,
+                          "STATELESSCURSOR requires a plain FT.AGGREGATE scan "
+                          "(no GROUPBY, WITHCURSOR or FT.SEARCH)");
+      goto error;
+    }
+    const PLN_ArrangeStep *arng =
+        (const PLN_ArrangeStep *)AGPLN_FindStep(&r->ap, NULL, NULL, PLN_T_ARRANGE);
+    if (arng && arng->sortKeys) {
+      QueryError_SetError(&status, QUERY_EPARSEARGS,
+                          "STATELESSCURSOR cannot combine with SORTBY");
+      goto error;
+    }
+    r->qiter.resumeAfterId = r->resumeAfter;
+    // [rows, token]: token is the last emitted docId, 0 when the scan is done
+    RedisModule_ReplyWithArray(ctx, 2);
+    sendChunk(r, ctx, -1);
+    RedisModule_ReplyWithLongLong(ctx, r->lastDocId);
+    AREQ_Free(r);
+    return REDISMODULE_OK;
+  }
+
   if (r->reqflags & QEXEC_F_IS_CURSOR) {
     int rc = AREQ_StartCursor(r, ctx, r->sctx->spec->name, &status);
     if (rc != REDISMODULE_OK) {
       goto error;
     }
   } else {
+    long long ttl = RSGlobalConfig.resultCacheTTLMS;
+    if (ttl > 0) {
+      // Opt-in result cache: first-page (offset 0) requests only
+      const PLN_ArrangeStep *arng =
+          (const PLN_ArrangeStep *)AGPLN_FindStep(&r->ap, NULL, NULL, PLN_T_ARRANGE);
+      if (!arng || arng->offset == 0) {
+        IndexSpec *spec = r->sctx->spec;
+        if (!spec->resultCache) {
+          spec->resultCache = ResultCache_New();
+        }
+        sds cacheKey = buildCacheKey(argv, argc);
+        const CachedReply *hit = ResultCache_Get(spec->resultCache, cacheKey, sdslen(cacheKey));
+        if (hit) {
+          CachedReply_Send(hit, ctx);
+          AREQ_Free(r);
+        } else {
+          execWithResultCache(r, ctx, spec->resultCache, cacheKey, ttl);
+        }
+        sdsfree(cacheKey);
+        return REDISMODULE_OK;
+      }
+    }
     // Execute() will call free when appropriate.
     AREQ_Execute(r, ctx);
   }
@@ -237,17 +588,68 @@ error:
   return QueryError_ReplyAndClear(ctx, &status);
 }
 
+/* Pool continuations for the read commands: parse, execute and serialize run
+ * on a worker with the blocked client's context; the reply ships on unblock */
+static void aggregateCommandConcurrent(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
+                                       struct ConcurrentCmdCtx *cmdCtx) {
+  execCommandCommon(ctx, argv, argc, COMMAND_AGGREGATE, 0, 1);
+}
+
+static void searchCommandConcurrent(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
+                                    struct ConcurrentCmdCtx *cmdCtx) {
+  execCommandCommon(ctx, argv, argc, COMMAND_SEARCH, 0, 1);
+}
+
 int RSAggregateCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
-  return execCommandCommon(ctx, argv, argc, COMMAND_AGGREGATE);
+  if (CheckConcurrentSupport(ctx)) {
+    return ConcurrentSearch_HandleRedisCommand(CONCURRENT_POOL_SEARCH, aggregateCommandConcurrent,
+                                               ctx, argv, argc);
+  }
+  return execCommandCommon(ctx, argv, argc, COMMAND_AGGREGATE, 0, 0);
 }
 int RSSearchCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
-  return execCommandCommon(ctx, argv, argc, COMMAND_SEARCH);
+  if (CheckConcurrentSupport(ctx)) {
+    return ConcurrentSearch_HandleRedisCommand(CONCURRENT_POOL_SEARCH, searchCommandConcurrent,
+                                               ctx, argv, argc);
+  }
+  return execCommandCommon(ctx, argv, argc, COMMAND_SEARCH, 0, 0);
+}
+
+/* FT.PROFILE <index> SEARCH|AGGREGATE QUERY <query args...>
+ * Runs the query with counters on every index iterator and result processor,
+ * replying with [results, profile] */
+int RSProfileCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+  if (argc < 5) {
+    return RedisModule_WrongArity(ctx);
+  }
+  const char *subtype = RedisModule_StringPtrLen(argv[2], NULL);
+  CommandType type;
+  if (!strcasecmp(subtype, "SEARCH")) {
+    type = COMMAND_SEARCH;
+  } else if (!strcasecmp(subtype, "AGGREGATE")) {
+    type = COMMAND_AGGREGATE;
+  } else {
+    return RedisModule_ReplyWithError(ctx, "No `SEARCH` or `AGGREGATE` provided");
+  }
+  if (strcasecmp(RedisModule_StringPtrLen(argv[3], NULL), "QUERY")) {
+    return RedisModule_ReplyWithError(ctx, "The QUERY keyword is expected");
+  }
+
+  // Rebuild the argument vector as <cmd> <index> <query args...>
+  int nargc = argc - 2;
+  RedisModuleString **nargv = rm_malloc(nargc * sizeof(*nargv));
+  nargv[0] = argv[0];
+  nargv[1] = argv[1];
+  memcpy(nargv + 2, argv + 4, (argc - 4) * sizeof(*nargv));
+  int rc = execCommandCommon(ctx, nargv, nargc, type, 1, 0);
+  rm_free(nargv);
+  return rc;
 }
 
 char *RS_GetExplainOutput(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
                           QueryError *status) {
   AREQ *r = NULL;
-  if (buildRequest(ctx, argv, argc, COMMAND_EXPLAIN, status, &r) != REDISMODULE_OK) {
+  if (buildRequest(ctx, argv, argc, COMMAND_EXPLAIN, 0, status, &r) != REDISMODULE_OK) {
     return NULL;
   }
   char *ret = QAST_DumpExplain(&r->ast, r->sctx->spec);
@@ -257,6 +659,130 @@ char *RS_GetExplainOutput(RedisModuleCtx *ctx, RedisModuleString **argv, int arg
 
 static void runCursor(RedisModuleCtx *outputCtx, Cursor *cursor, size_t num);
 
+/**
+ * Cursor read-ahead (CURSOR_READAHEAD). After a batch is replied and the cursor
+ * is paused, the next batch is pulled into req->prefetch.rows on the concurrent
+ * pool, overlapping server compute with the client's think time. The protocol
+ * (all flags under prefetch.lock):
+ *
+ * - `active` is set by the scheduler before the task is submitted, and cleared
+ *   by the task as its very last action under the lock.
+ * - The task sets `started` only after it has acquired the GIL. Since a READ
+ *   (or a cursor purge) also runs with the GIL held, observing `started` there
+ *   means the task is already past its GIL section and will publish shortly -
+ *   waiting on `cond` is safe. Observing `!started` means the task has not
+ *   touched the pipeline and can be told to back off via `claimed`/`cancelled`
+ *   without blocking.
+ * - `claimed`: a READ arrived before the task got going; the task bails out
+ *   without touching the pipeline and the READ pulls rows synchronously.
+ * - `cancelled`: the cursor is being freed; the task owns the request and
+ *   performs the AREQ_Free itself.
+ */
+static void cursorPrefetchTask(void *arg) {
+  AREQ *req = arg;
+  RedisModuleCtx *thctx = req->sctx->redisCtx;
+
+  pthread_mutex_lock(&req->prefetch.lock);
+  if (req->prefetch.claimed || req->prefetch.cancelled) {
+    goto bail;
+  }
+  pthread_mutex_unlock(&req->prefetch.lock);
+
+  RedisModule_ThreadSafeContextLock(thctx);
+  pthread_mutex_lock(&req->prefetch.lock);
+  if (req->prefetch.claimed || req->prefetch.cancelled) {
+    RedisModule_ThreadSafeContextUnlock(thctx);
+    goto bail;
+  }
+  req->prefetch.started = 1;
+  pthread_mutex_unlock(&req->prefetch.lock);
+
+  ConcurrentSearchCtx_ReopenKeys(&req->conc);
+  IndexSpec_LockRead(req->sctx->spec);
+  clock_gettime(CLOCK_MONOTONIC, &req->qiter.startTime);
+  RS_CostAccountingArm(execCostCheck, req);
+  size_t num = req->cursorChunkSize ? req->cursorChunkSize : RSGlobalConfig.cursorReadSize;
+  if (num > (size_t)RSGlobalConfig.cursorReadSize) {
+    // Don't let a huge COUNT balloon the staging buffer; the remainder of the
+    // batch is pulled live once the staged rows are drained
+    num = RSGlobalConfig.cursorReadSize;
+  }
+  SearchResult *rows = calloc(num, sizeof(*rows));
+  uint32_t n = 0;
+  int rc = RS_RESULT_OK;
+  ResultProcessor *rp = req->qiter.endProc;
+  while (n < num && (rc = rp->Next(rp, &rows[n])) == RS_RESULT_OK) {
+    n++;
+  }
+  RS_CostAccountingDisarm();
+  IndexSpec_UnlockIndex(req->sctx->spec);
+  RedisModule_ThreadSafeContextUnlock(thctx);
+
+  pthread_mutex_lock(&req->prefetch.lock);
+  req->prefetch.rows = rows;
+  req->prefetch.len = n;
+  req->prefetch.pos = 0;
+  req->prefetch.endRC = rc;
+  req->prefetch.active = 0;
+  // If `cancelled` was raised after we set `started`, the canceller is waiting
+  // on the condvar and will perform the free itself - just publish and signal.
+  pthread_cond_broadcast(&req->prefetch.cond);
+  pthread_mutex_unlock(&req->prefetch.lock);
+  return;
+
+bail: {
+  int doFree = req->prefetch.cancelled;
+  req->prefetch.active = 0;
+  req->prefetch.started = 0;
+  req->prefetch.claimed = 0;
+  pthread_cond_broadcast(&req->prefetch.cond);
+  pthread_mutex_unlock(&req->prefetch.lock);
+  if (doFree) {
+    // The cursor was purged before we ran; we own the request now. AREQ_Free
+    // frees the request's own thread-safe context, so take the GIL through a
+    // scratch context of ours rather than through thctx
+    RedisModuleCtx *freeCtx = RedisModule_GetThreadSafeContext(NULL);
+    RedisModule_ThreadSafeContextLock(freeCtx);
+    AREQ_Free(req);
+    RedisModule_ThreadSafeContextUnlock(freeCtx);
+    RedisModule_FreeThreadSafeContext(freeCtx);
+  }
+}
+}
+
+/** Submit a read-ahead task for the paused cursor, unless one is still in
+ * flight or staged rows are still waiting to be served */
+static void cursorScheduleReadAhead(AREQ *req) {
+  pthread_mutex_lock(&req->prefetch.lock);
+  if (req->prefetch.active || req->prefetch.pos < req->prefetch.len ||
+      req->prefetch.endRC != RS_RESULT_OK) {
+    pthread_mutex_unlock(&req->prefetch.lock);
+    return;
+  }
+  req->prefetch.active = 1;
+  req->prefetch.started = 0;
+  req->prefetch.claimed = 0;
+  pthread_mutex_unlock(&req->prefetch.lock);
+  ConcurrentSearch_ThreadPoolRun(cursorPrefetchTask, req, CONCURRENT_POOL_SEARCH);
+}
+
+/** Called with the GIL held before a READ touches the pipeline. Either claims
+ * the pipeline back from a task that has not started, or waits for a task that
+ * is already past its GIL section to publish */
+static void cursorAwaitReadAhead(AREQ *req) {
+  pthread_mutex_lock(&req->prefetch.lock);
+  if (req->prefetch.active) {
+    if (!req->prefetch.started) {
+      req->prefetch.claimed = 1;
+    } else {
+      while (req->prefetch.active) {
+        pthread_cond_wait(&req->prefetch.cond, &req->prefetch.lock);
+      }
+    }
+  }
+  pthread_mutex_unlock(&req->prefetch.lock);
+}
+
 int AREQ_StartCursor(AREQ *r, RedisModuleCtx *outctx, const char *lookupName, QueryError *err) {
   Cursor *cursor = Cursors_Reserve(&RSCursors, lookupName, r->cursorMaxIdle, err);
   if (cursor == NULL) {
@@ -296,11 +822,17 @@ static void runCursor(RedisModuleCtx *outputCtx, Cursor *cursor, size_t num) {
   } else {
     // Update the idle timeout
     Cursor_Pause(cursor);
+    // Read-ahead needs the concurrent pool; SAFEMODE runs without one
+    if (RSGlobalConfig.cursorReadAhead && RSGlobalConfig.concurrentMode) {
+      cursorScheduleReadAhead(req);
+    }
     return;
   }
 
 delcursor:
-  AREQ_Free(req);
+  // Go through the free callback; a claimed read-ahead task may still be in
+  // flight, in which case the free is handed off to it
+  Cursor_FreeExecState(req);
   if (cursor) {
     cursor->execState = NULL;
   }
@@ -312,6 +844,22 @@ delcursor:
  * FT.CURSOR DEL {index} {CID}
  * FT.CURSOR GC {index}
  */
+static void cursorRead(RedisModuleCtx *ctx, uint64_t cid, size_t count);
+
+/* Thread-pool continuation of FT.CURSOR READ: runs on the cursor execution
+ * class with the GIL taken by the dispatcher, assembling the reply into the
+ * blocked client's context; RedisModule_UnblockClient ships it when the
+ * handler returns */
+static void cursorReadConcurrent(RedisModuleCtx *ctx, RedisModuleString **argv, int argc,
+                                 struct ConcurrentCmdCtx *cmdCtx) {
+  long long cid = 0, count = 0;
+  RedisModule_StringToLongLong(argv[3], &cid);  // validated before dispatch
+  if (argc > 5) {
+    RedisModule_StringToLongLong(argv[5], &count);
+  }
+  cursorRead(ctx, cid, count);
+}
+
 static void cursorRead(RedisModuleCtx *ctx, uint64_t cid, size_t count) {
   Cursor *cursor = Cursors_TakeForExecution(&RSCursors, cid);
   if (cursor == NULL) {
@@ -319,6 +867,7 @@ static void cursorRead(RedisModuleCtx *ctx, uint64_t cid, size_t count) {
     return;
   }
   AREQ *req = cursor->execState;
+  cursorAwaitReadAhead(req);
   ConcurrentSearchCtx_ReopenKeys(&req->conc);
   runCursor(ctx, cursor, count);
 }
@@ -351,6 +900,12 @@ int RSCursorCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
         return REDISMODULE_OK;
       }
     }
+    if (CheckConcurrentSupport(ctx)) {
+      // Continue the cursor on the execution pool so a burst of reads does
+      // not serialize interactive commands behind it on the main thread
+      return ConcurrentSearch_HandleRedisCommand(CONCURRENT_POOL_CURSOR, cursorReadConcurrent,
+                                                 ctx, argv, argc);
+    }
     cursorRead(ctx, cid, count);
 
   } else if (cmdc == 'D') {
@@ -373,5 +928,18 @@ int RSCursorCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 
 void Cursor_FreeExecState(void *p) {
   AREQ *r = p;
-  AREQ_Free(p);
+  pthread_mutex_lock(&r->prefetch.lock);
+  if (r->prefetch.active) {
+    if (!r->prefetch.started) {
+      // The task has not touched the pipeline; hand it the request to free
+      r->prefetch.cancelled = 1;
+      pthread_mutex_unlock(&r->prefetch.lock);
+      return;
+    }
+    while (r->prefetch.active) {
+      pthread_cond_wait(&r->prefetch.cond, &r->prefetch.lock);
+    }
+  }
+  pthread_mutex_unlock(&r->prefetch.lock);
+  AREQ_Free(r);
 }
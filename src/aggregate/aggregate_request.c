@@ -1,4 +1,6 @@
 #include "aggregate.h"
+#include "trace.h"
+#include "../slowlog.h"
 #include "reducer.h"
 
 #include <query.h>
@@ -7,7 +9,10 @@
 #include <util/arr.h>
 #include <rmutil/util.h>
 #include "ext/default.h"
+#include "profile.h"
+#include "config.h"
 #include "extension.h"
+#include "expr/exprast.h"
 
 /**
  * Ensures that the user has not requested one of the 'extended' features. Extended
@@ -169,6 +174,18 @@ static int handleCommonArgs(AREQ *req, ArgsCursor *ac, QueryError *status, int a
     if (parseCursorSettings(req, ac, status) != REDISMODULE_OK) {
       return ARG_ERROR;
     }
+  } else if (AC_AdvanceIfMatch(ac, "WITHPARTIALS")) {
+    req->reqflags |= QEXEC_F_PARTIALS;
+  } else if (AC_AdvanceIfMatch(ac, "STATELESSCURSOR")) {
+    req->reqflags |= QEXEC_F_STATELESS_CURSOR;
+  } else if (AC_AdvanceIfMatch(ac, "RESUMEAFTER")) {
+    long long docId;
+    if (AC_GetLongLong(ac, &docId, 0) != AC_OK || docId < 0) {
+      QueryError_SetError(status, QUERY_EPARSEARGS, "Bad RESUMEAFTER value");
+      return ARG_ERROR;
+    }
+    req->resumeAfter = docId;
+    req->reqflags |= QEXEC_F_STATELESS_CURSOR;
   } else if (AC_AdvanceIfMatch(ac, "_NUM_SSTRING")) {
     req->reqflags |= QEXEC_F_TYPED;
   } else {
@@ -587,7 +604,13 @@ static int handleLoad(AREQ *req, ArgsCursor *ac, QueryError *status) {
 }
 
 AREQ *AREQ_New(void) {
-  return calloc(1, sizeof(AREQ));
+  AREQ *req = calloc(1, sizeof(AREQ));
+  // The globally configured timeout applies unless the request overrides it
+  req->tmoMS = RSGlobalConfig.queryTimeoutMS;
+  req->tmoPolicy = RSGlobalConfig.timeoutPolicy;
+  pthread_mutex_init(&req->prefetch.lock, NULL);
+  pthread_cond_init(&req->prefetch.cond, NULL);
+  return req;
 }
 
 int AREQ_Compile(AREQ *req, RedisModuleString **argv, int argc, QueryError *status) {
@@ -721,7 +744,14 @@ int AREQ_ApplyContext(AREQ *req, RedisSearchCtx *sctx, QueryError *status) {
     QueryError_SetErrorFmt(status, QUERY_EINVAL, "No such language %s", opts->language);
     return REDISMODULE_ERR;
   }
-  if (opts->scorerName && Extensions_GetScoringFunction(NULL, opts->scorerName) == NULL) {
+  if (opts->scorerName && !strncmp(opts->scorerName, "EXPR:", 5)) {
+    // Scoring expression: parse once here, compile in the pipeline build
+    const char *e = opts->scorerName + 5;
+    req->scoreExpr = ExprAST_Parse(e, strlen(e), status);
+    if (!req->scoreExpr) {
+      return REDISMODULE_ERR;
+    }
+  } else if (opts->scorerName && Extensions_GetScoringFunction(NULL, opts->scorerName) == NULL) {
     QueryError_SetErrorFmt(status, QUERY_EINVAL, "No such scorer %s", opts->scorerName);
     return REDISMODULE_ERR;
   }
@@ -733,6 +763,9 @@ int AREQ_ApplyContext(AREQ *req, RedisSearchCtx *sctx, QueryError *status) {
   QueryAST *ast = &req->ast;
 
   int rv = QAST_Parse(ast, sctx, &req->searchopts, req->query, strlen(req->query), status);
+  if (rv == REDISMODULE_OK) {
+    RS_TRACE_PARSE_DONE(req->query);
+  }
   if (rv != REDISMODULE_OK) {
     return REDISMODULE_ERR;
   }
@@ -746,15 +779,50 @@ int AREQ_ApplyContext(AREQ *req, RedisSearchCtx *sctx, QueryError *status) {
   }
 
   ConcurrentSearchCtx_Init(sctx->redisCtx, &req->conc);
-  req->rootiter = QAST_Iterate(ast, opts, sctx, &req->conc, status);
+  // Highlighting no longer forces offset decoding on the whole scan: the
+  // readers run with the offset-skipping twins and the highlighter restores
+  // offset publishing only for the final page's re-seeks
+  req->rootiter = QAST_Iterate(ast, opts, sctx, &req->conc, req->profile, status);
   if (!req->rootiter) {
     return REDISMODULE_ERR;
   }
+  RS_TRACE_ITER_BUILT(req->query, req->rootiter->NumEstimated(req->rootiter->ctx));
+
+  // Admission control: the root iterator's estimate (term doc counts, trie
+  // expansion fan-out, range sizes) is known before any record is decoded.
+  // Over-budget queries are rejected, or - under the DEGRADE policy - rebuilt
+  // with prefix/fuzzy expansions capped hard and re-estimated first
+  if (RSGlobalConfig.queryCostBudget > 0) {
+    size_t est = req->rootiter->NumEstimated(req->rootiter->ctx);
+    if (est > (size_t)RSGlobalConfig.queryCostBudget) {
+      // profiled queries skip the rebuild: the profiler already wrapped the
+      // first pass's iterators, and rebuilding would leave it holding them
+      if (RSGlobalConfig.queryCostDegrade && !req->profile) {
+#define QUERY_COST_DEGRADED_EXPANSIONS 5
+        req->rootiter->Free(req->rootiter);
+        long long saved = sctx->spec->maxPrefixExpansions;
+        sctx->spec->maxPrefixExpansions = QUERY_COST_DEGRADED_EXPANSIONS;
+        req->rootiter = QAST_Iterate(ast, opts, sctx, &req->conc, req->profile, status);
+        sctx->spec->maxPrefixExpansions = saved;
+        if (!req->rootiter) {
+          return REDISMODULE_ERR;
+        }
+        est = req->rootiter->NumEstimated(req->rootiter->ctx);
+      }
+      if (est > (size_t)RSGlobalConfig.queryCostBudget) {
+        QueryError_SetErrorFmt(status, QUERY_ECOSTBUDGET,
+                               "Estimated query cost %zu exceeds budget %lld", est,
+                               RSGlobalConfig.queryCostBudget);
+        return REDISMODULE_ERR;
+      }
+    }
+  }
 
   return REDISMODULE_OK;
 }
 
-static ResultProcessor *buildGroupRP(PLN_GroupStep *gstp, RLookup *srclookup, QueryError *err) {
+static ResultProcessor *buildGroupRP(AREQ *req, PLN_GroupStep *gstp, RLookup *srclookup,
+                                     QueryError *err) {
   const RLookupKey *srckeys[gstp->nproperties], *dstkeys[gstp->nproperties];
   for (size_t ii = 0; ii < gstp->nproperties; ++ii) {
     const char *fldname = gstp->properties[ii] + 1;  // account for the @-
@@ -784,12 +852,22 @@ static ResultProcessor *buildGroupRP(PLN_GroupStep *gstp, RLookup *srclookup, Qu
       return NULL;
     }
 
+    if ((req->reqflags & QEXEC_F_PARTIALS) && !rr->FinalizePartial) {
+      QueryError_SetErrorFmt(err, QUERY_EPARSEARGS,
+                             "Reducer %s cannot emit mergeable partials", pr->name);
+      rr->Free(rr);
+      return NULL;
+    }
+
     // Set the destination key for the grouper!
     RLookupKey *dstkey =
         RLookup_GetKey(&gstp->lookup, pr->alias, RLOOKUP_F_OCREAT | RLOOKUP_F_NOINCREF);
     Grouper_AddReducer(grp, rr, dstkey);
   }
 
+  if (req->reqflags & QEXEC_F_PARTIALS) {
+    Grouper_SetPartials(grp);
+  }
   return Grouper_GetRP(grp);
 }
 
@@ -806,11 +884,40 @@ static ResultProcessor *pushRP(AREQ *req, ResultProcessor *rp, ResultProcessor *
   return rp;
 }
 
+/* Whether the group step actually reads this key - as a grouping property or
+ * as a reducer argument. Keys that are merely LOADed die at the group
+ * boundary, so loading them ahead of the grouper is pure wasted document IO
+ * (projection pushdown: only the referenced subset reaches the loader) */
+static int groupStepReferencesKey(const PLN_GroupStep *gstp, const RLookupKey *kk) {
+  for (size_t ii = 0; ii < gstp->nproperties; ++ii) {
+    const char *p = gstp->properties[ii];
+    if (*p == '@') {
+      p++;
+    }
+    if (!strcmp(p, kk->name)) {
+      return 1;
+    }
+  }
+  for (size_t ii = 0; ii < array_len(gstp->reducers); ++ii) {
+    ArgsCursor ac = gstp->reducers[ii].args;  // by-value copy; don't consume the original
+    const char *s;
+    while (AC_GetString(&ac, &s, NULL, 0) == AC_OK) {
+      if (*s == '@') {
+        s++;
+      }
+      if (!strcmp(s, kk->name)) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
 static ResultProcessor *getGroupRP(AREQ *req, PLN_GroupStep *gstp, ResultProcessor *rpUpstream,
                                    QueryError *status) {
   AGGPlan *pln = &req->ap;
   RLookup *lookup = AGPLN_GetLookup(pln, &gstp->base, AGPLN_GETLOOKUP_PREV);
-  ResultProcessor *groupRP = buildGroupRP(gstp, lookup, status);
+  ResultProcessor *groupRP = buildGroupRP(req, gstp, lookup, status);
 
   if (!groupRP) {
     return NULL;
@@ -823,7 +930,8 @@ static ResultProcessor *getGroupRP(AREQ *req, PLN_GroupStep *gstp, ResultProcess
     // See if we need a loader step?
     const RLookupKey **kklist = NULL;
     for (RLookupKey *kk = firstLk->head; kk; kk = kk->next) {
-      if ((kk->flags & RLOOKUP_F_DOCSRC) && (!(kk->flags & RLOOKUP_F_SVSRC))) {
+      if ((kk->flags & RLOOKUP_F_DOCSRC) && (!(kk->flags & RLOOKUP_F_SVSRC)) &&
+          groupStepReferencesKey(gstp, kk)) {
         *array_ensure_tail(&kklist, const RLookupKey *) = kk;
       }
     }
@@ -872,7 +980,8 @@ static ResultProcessor *getArrangeRP(AREQ *req, AGGPlan *pln, const PLN_BaseStep
       }
     }
 
-    rp = RPSorter_NewByFields(limit, sortkeys, nkeys, astp->sortAscMap);
+    rp = RPSorter_NewByFields(limit, sortkeys, nkeys, astp->sortAscMap,
+                              req->sctx ? req->sctx->spec->sortables : NULL);
     up = pushRP(req, rp, up);
   }
 
@@ -948,8 +1057,30 @@ int buildImplicitPipeline(AREQ *req, QueryError *Status) {
 
   /** Create a scorer if there is no subsequent sorter within this grouping */
   if (!hasQuerySortby(&req->ap)) {
-    rp = getScorerRP(req);
-    PUSH_RP();
+    if (req->scoreExpr) {
+      // Scoring expression: bind its properties and hand it (with ownership)
+      // to the evaluating processor, which compiles the numeric-only case to
+      // a flat program at setup. No WAND hookup - an expression's score has
+      // no per-term impact bound
+      if (!ExprAST_GetLookupKeys(req->scoreExpr, first, Status)) {
+        return REDISMODULE_ERR;
+      }
+      rp = RPEvaluator_NewScorer(req->scoreExpr, first, sctx->spec->sortables);
+      req->scoreExpr = NULL;
+      PUSH_RP();
+    } else {
+      rp = getScorerRP(req);
+      PUSH_RP();
+
+      // WAND: the TFIDF/BM25 family scores are bounded by freq * idf * weight per term, so
+      // iterators which know their impact bounds may skip documents and blocks that cannot
+      // enter the top-k heap. The heap's minimum score already flows through qiter.minScore
+      const char *scorer = req->searchopts.scorerName;
+      if ((!scorer || !strcmp(scorer, DEFAULT_SCORER_NAME) || !strcmp(scorer, BM25_SCORER_NAME)) &&
+          req->rootiter->SetMaxScoreThresholdRef) {
+        req->rootiter->SetMaxScoreThresholdRef(req->rootiter->ctx, &req->qiter.minScore);
+      }
+    }
   }
   return REDISMODULE_OK;
 }
@@ -1011,6 +1142,150 @@ error:
   return REDISMODULE_ERR;
 }
 
+/*******************************************************************************
+ * Plan-time expression rewrites. Before the pipeline is built, APPLY/FILTER
+ * expressions are parsed up front and rewritten: constant subtrees are folded
+ * to literals, APPLY steps whose output can never be observed are dropped,
+ * and subtrees identical to an earlier APPLY's whole expression are replaced
+ * with a reference to that APPLY's alias, so the work runs once per row
+ * instead of once per occurrence.
+ ******************************************************************************/
+
+/* Strip a leading '@' from a property reference argument */
+static const char *stripAtPrefix(const char *s) {
+  return *s == '@' ? s + 1 : s;
+}
+
+/* Returns 1 if the output of the APPLY step `stp` can never be observed:
+ * either a later APPLY overwrites its alias, or a GROUP discards it, with no
+ * intervening reference to the alias. Unknown step types are treated as
+ * readers. */
+static int applyStepIsDead(const AGGPlan *pln, const PLN_BaseStep *stp) {
+  const char *alias = stp->alias;
+  if (!alias) {
+    return 0;
+  }
+  for (const DLLIST_node *nn = stp->llnodePln.next; nn != &pln->steps; nn = nn->next) {
+    const PLN_BaseStep *cur = DLLIST_ITEM(nn, PLN_BaseStep, llnodePln);
+    switch (cur->type) {
+      case PLN_T_APPLY:
+      case PLN_T_FILTER: {
+        const PLN_MapFilterStep *mstp = (const PLN_MapFilterStep *)cur;
+        if (mstp->parsedExpr && ExprAST_UsesProperty(mstp->parsedExpr, alias)) {
+          return 0;
+        }
+        if (cur->type == PLN_T_APPLY && cur->alias && !strcmp(cur->alias, alias)) {
+          return 1;  // Overwritten before any read
+        }
+        break;
+      }
+      case PLN_T_ARRANGE: {
+        const PLN_ArrangeStep *astp = (const PLN_ArrangeStep *)cur;
+        if (astp->sortKeys && astp->sortKeys != PLN_SORTKEYS_DFLSCORE) {
+          for (size_t ii = 0; ii < array_len(astp->sortKeys); ++ii) {
+            if (!strcmp(astp->sortKeys[ii], alias)) {
+              return 0;
+            }
+          }
+        }
+        break;
+      }
+      case PLN_T_GROUP: {
+        const PLN_GroupStep *gstp = (const PLN_GroupStep *)cur;
+        for (size_t ii = 0; ii < gstp->nproperties; ++ii) {
+          if (!strcmp(stripAtPrefix(gstp->properties[ii]), alias)) {
+            return 0;
+          }
+        }
+        for (size_t ii = 0; ii < array_len(gstp->reducers); ++ii) {
+          ArgsCursor tmp = gstp->reducers[ii].args;
+          while (!AC_IsAtEnd(&tmp)) {
+            if (!strcmp(stripAtPrefix(AC_GetStringNC(&tmp, NULL)), alias)) {
+              return 0;
+            }
+          }
+        }
+        return 1;  // The group rebuilds the row set; the field is discarded
+      }
+      case PLN_T_LOAD:
+        break;  // Reads document fields, not pipeline fields
+      default:
+        return 0;
+    }
+  }
+  return 0;  // Reached the end of the plan - the field is part of the output
+}
+
+static int rewritePlanExpressions(AREQ *req, QueryError *status) {
+  AGGPlan *pln = &req->ap;
+
+  // Parse and fold every APPLY/FILTER expression
+  for (DLLIST_node *nn = pln->steps.next; nn != &pln->steps; nn = nn->next) {
+    PLN_BaseStep *stp = DLLIST_ITEM(nn, PLN_BaseStep, llnodePln);
+    if (stp->type != PLN_T_APPLY && stp->type != PLN_T_FILTER) {
+      continue;
+    }
+    PLN_MapFilterStep *mstp = (PLN_MapFilterStep *)stp;
+    mstp->parsedExpr = ExprAST_Parse(mstp->rawExpr, strlen(mstp->rawExpr), status);
+    if (!mstp->parsedExpr) {
+      return REDISMODULE_ERR;
+    }
+    mstp->parsedExpr = ExprAST_FoldConstants(mstp->parsedExpr);
+  }
+
+  // Drop APPLY steps whose output can never be observed
+  for (DLLIST_node *nn = pln->steps.next; nn != &pln->steps;) {
+    PLN_BaseStep *stp = DLLIST_ITEM(nn, PLN_BaseStep, llnodePln);
+    nn = nn->next;
+    if (stp->type == PLN_T_APPLY && applyStepIsDead(pln, stp)) {
+      AGPLN_PopStep(pln, stp);
+      if (stp->dtor) {
+        stp->dtor(stp);
+      }
+    }
+  }
+
+  // Reuse earlier APPLY results for identical subtrees. Candidates are only
+  // valid within one reduction section, while their alias is intact and the
+  // properties they read are unchanged.
+  PLN_MapFilterStep **cands = array_new(PLN_MapFilterStep *, 8);
+  for (DLLIST_node *nn = pln->steps.next; nn != &pln->steps; nn = nn->next) {
+    PLN_BaseStep *stp = DLLIST_ITEM(nn, PLN_BaseStep, llnodePln);
+    if (PLN_IsReduce(stp)) {
+      cands = array_trimm_len(cands, 0);
+      continue;
+    }
+    if (stp->type != PLN_T_APPLY && stp->type != PLN_T_FILTER) {
+      continue;
+    }
+    PLN_MapFilterStep *mstp = (PLN_MapFilterStep *)stp;
+    for (size_t ii = 0; ii < array_len(cands); ++ii) {
+      ExprAST_ReplaceEqual(&mstp->parsedExpr, cands[ii]->parsedExpr, cands[ii]->base.alias);
+    }
+    if (stp->type != PLN_T_APPLY || !stp->alias) {
+      continue;
+    }
+    // This step writes its alias: invalidate candidates it overwrites or
+    // whose expression reads the overwritten field
+    for (size_t ii = 0; ii < array_len(cands);) {
+      if (!strcmp(cands[ii]->base.alias, stp->alias) ||
+          ExprAST_UsesProperty(cands[ii]->parsedExpr, stp->alias)) {
+        cands[ii] = cands[array_len(cands) - 1];
+        cands = array_trimm_len(cands, array_len(cands) - 1);
+      } else {
+        ++ii;
+      }
+    }
+    // Trees that are already a bare literal or property reference are not
+    // worth substituting
+    if (mstp->parsedExpr->t != RSExpr_Literal && mstp->parsedExpr->t != RSExpr_Property) {
+      cands = array_append(cands, mstp);
+    }
+  }
+  array_free(cands);
+  return REDISMODULE_OK;
+}
+
 int AREQ_BuildPipeline(AREQ *req, int options, QueryError *status) {
   if (!(options & AREQ_BUILDPIPELINE_NO_ROOT)) {
     if (buildImplicitPipeline(req, status) != REDISMODULE_OK) {
@@ -1021,6 +1296,10 @@ int AREQ_BuildPipeline(AREQ *req, int options, QueryError *status) {
   AGGPlan *pln = &req->ap;
   ResultProcessor *rp = NULL, *rpUpstream = req->qiter.endProc;
 
+  if (rewritePlanExpressions(req, status) != REDISMODULE_OK) {
+    goto error;
+  }
+
   // Whether we've applied a SORTBY yet..
   int hasArrange = 0;
 
@@ -1051,9 +1330,12 @@ int AREQ_BuildPipeline(AREQ *req, int options, QueryError *status) {
         PLN_MapFilterStep *mstp = (PLN_MapFilterStep *)stp;
         // Ensure the lookups can actually find what they need
         RLookup *curLookup = AGPLN_GetLookup(pln, stp, AGPLN_GETLOOKUP_PREV);
-        mstp->parsedExpr = ExprAST_Parse(mstp->rawExpr, strlen(mstp->rawExpr), status);
+        // Parsed (and rewritten) up front by rewritePlanExpressions()
         if (!mstp->parsedExpr) {
-          goto error;
+          mstp->parsedExpr = ExprAST_Parse(mstp->rawExpr, strlen(mstp->rawExpr), status);
+          if (!mstp->parsedExpr) {
+            goto error;
+          }
         }
 
         if (!ExprAST_GetLookupKeys(mstp->parsedExpr, curLookup, status)) {
@@ -1063,9 +1345,11 @@ int AREQ_BuildPipeline(AREQ *req, int options, QueryError *status) {
         if (stp->type == PLN_T_APPLY) {
           RLookupKey *dstkey =
               RLookup_GetKey(curLookup, stp->alias, RLOOKUP_F_OCREAT | RLOOKUP_F_NOINCREF);
-          rp = RPEvaluator_NewProjector(mstp->parsedExpr, curLookup, dstkey);
+          rp = RPEvaluator_NewProjector(mstp->parsedExpr, curLookup, dstkey,
+                                        req->sctx ? req->sctx->spec->sortables : NULL);
         } else {
-          rp = RPEvaluator_NewFilter(mstp->parsedExpr, curLookup);
+          rp = RPEvaluator_NewFilter(mstp->parsedExpr, curLookup,
+                                     req->sctx ? req->sctx->spec->sortables : NULL);
         }
         PUSH_RP();
         break;
@@ -1137,6 +1421,43 @@ error:
 }
 
 void AREQ_Free(AREQ *req) {
+  if (req->queryQuotaHeld && req->sctx && req->sctx->spec) {
+    __atomic_sub_fetch(&req->sctx->spec->activeQueries, 1, __ATOMIC_ACQ_REL);
+    req->queryQuotaHeld = 0;
+  }
+  if (req->qiter.aggMemCharged && req->sctx && req->sctx->spec) {
+    __atomic_sub_fetch(&req->sctx->spec->aggMemUsed, req->qiter.aggMemCharged, __ATOMIC_ACQ_REL);
+    req->qiter.aggMemCharged = 0;
+  }
+  // Slow-log capture, before the profiled processors are torn down: if this
+  // armed request ran long enough, record it with per-stage attribution
+  if (req->slowlogCmd && req->profile && req->sctx && req->sctx->spec &&
+      req->qiter.startTime.tv_sec) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long ms = (now.tv_sec - req->qiter.startTime.tv_sec) * 1000LL +
+                   (now.tv_nsec - req->qiter.startTime.tv_nsec) / 1000000;
+    if (ms >= RSGlobalConfig.slowlogThresholdMs) {
+      IndexSpec *spec = req->sctx->spec;
+      if (!spec->slowlog) {
+        spec->slowlog = SlowLog_New();
+      }
+      SlowLog_Add(spec->slowlog, ms, req->slowlogCmd,
+                  QueryProfile_Format(req->profile, sdsempty()));
+      req->slowlogCmd = NULL;  // ownership moved to the log
+    }
+  }
+  sdsfree(req->slowlogCmd);
+  req->slowlogCmd = NULL;
+
+  if (req->scoreExpr) {
+    ExprAST_Free(req->scoreExpr);
+    req->scoreExpr = NULL;
+  }
+  if (req->profile) {
+    QueryProfile_Free(req->profile);
+    req->profile = NULL;
+  }
   // First, free the result processors
   ResultProcessor *rp = req->qiter.endProc;
   while (rp) {
@@ -1144,6 +1465,7 @@ void AREQ_Free(AREQ *req) {
     rp->Free(rp);
     rp = next;
   }
+  QITR_DrainResultPool(&req->qiter);
   if (req->rootiter) {
     req->rootiter->Free(req->rootiter);
     req->rootiter = NULL;
@@ -1160,6 +1482,14 @@ void AREQ_Free(AREQ *req) {
 
   ConcurrentSearchCtx_Free(&req->conc);
 
+  // Discard any staged read-ahead rows that were never served
+  for (uint32_t ii = req->prefetch.pos; ii < req->prefetch.len; ++ii) {
+    SearchResult_Destroy(&req->prefetch.rows[ii]);
+  }
+  free(req->prefetch.rows);
+  pthread_mutex_destroy(&req->prefetch.lock);
+  pthread_cond_destroy(&req->prefetch.cond);
+
   // Finally, free the context. If we are a cursor, some more
   // cleanup is required since we also now own the
   // detached ("Thread Safe") context.
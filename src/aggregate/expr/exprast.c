@@ -186,6 +186,206 @@ void ExprAST_Free(RSExpr *e) {
   RSExpr_Free(e);
 }
 
+/*******************************************************************************
+ * Plan-time rewrites. These run once per query, before the pipeline is built;
+ * see the rewrite pass in aggregate_request.c for how they are applied over
+ * the plan steps.
+ ******************************************************************************/
+
+int RSExpr_Equal(const RSExpr *a, const RSExpr *b) {
+  if (a->t != b->t) {
+    return 0;
+  }
+  switch (a->t) {
+    case RSExpr_Literal:
+      return RSValue_Equal(&a->literal, &b->literal);
+    case RSExpr_Property:
+      return !strcmp(a->property.key, b->property.key);
+    case RSExpr_Op:
+      return a->op.op == b->op.op && RSExpr_Equal(a->op.left, b->op.left) &&
+             RSExpr_Equal(a->op.right, b->op.right);
+    case RSExpr_Predicate:
+      return a->pred.cond == b->pred.cond && RSExpr_Equal(a->pred.left, b->pred.left) &&
+             RSExpr_Equal(a->pred.right, b->pred.right);
+    case RSExpr_Inverted:
+      return RSExpr_Equal(a->inverted.child, b->inverted.child);
+    case RSExpr_Function:
+      if (strcasecmp(a->func.name, b->func.name) || a->func.args->len != b->func.args->len) {
+        return 0;
+      }
+      for (size_t ii = 0; ii < a->func.args->len; ++ii) {
+        if (!RSExpr_Equal(a->func.args->args[ii], b->func.args->args[ii])) {
+          return 0;
+        }
+      }
+      return 1;
+  }
+  return 0;
+}
+
+int ExprAST_UsesProperty(const RSExpr *e, const char *prop) {
+  switch (e->t) {
+    case RSExpr_Property:
+      return !strcmp(e->property.key, prop);
+    case RSExpr_Op:
+      return ExprAST_UsesProperty(e->op.left, prop) || ExprAST_UsesProperty(e->op.right, prop);
+    case RSExpr_Predicate:
+      return ExprAST_UsesProperty(e->pred.left, prop) ||
+             ExprAST_UsesProperty(e->pred.right, prop);
+    case RSExpr_Inverted:
+      return ExprAST_UsesProperty(e->inverted.child, prop);
+    case RSExpr_Function:
+      for (size_t ii = 0; ii < e->func.args->len; ++ii) {
+        if (ExprAST_UsesProperty(e->func.args->args[ii], prop)) {
+          return 1;
+        }
+      }
+      return 0;
+    default:
+      return 0;
+  }
+}
+
+/* Functions whose result depends on the evaluated row rather than on the
+ * arguments alone; calls to these are never folded */
+static int funcIsRowDependent(const char *name) {
+  return !strcasecmp(name, "matched_terms");
+}
+
+static int exprIsLiteral(const RSExpr *e) {
+  return e->t == RSExpr_Literal;
+}
+
+/* A node may be folded when all of its direct operands are already literals;
+ * the bottom-up recursion in ExprAST_FoldConstants makes this transitive */
+static int exprIsFoldable(const RSExpr *e) {
+  switch (e->t) {
+    case RSExpr_Op:
+      return exprIsLiteral(e->op.left) && exprIsLiteral(e->op.right);
+    case RSExpr_Predicate:
+      return exprIsLiteral(e->pred.left) && exprIsLiteral(e->pred.right);
+    case RSExpr_Inverted:
+      return exprIsLiteral(e->inverted.child);
+    case RSExpr_Function:
+      if (!e->func.Call || funcIsRowDependent(e->func.name)) {
+        return 0;
+      }
+      for (size_t ii = 0; ii < e->func.args->len; ++ii) {
+        if (!exprIsLiteral(e->func.args->args[ii])) {
+          return 0;
+        }
+      }
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+/* Build an owning literal node out of an evaluated value, or NULL when the
+ * value has no literal representation (arrays, redis strings) */
+static RSExpr *literalFromValue(RSValue *v) {
+  v = RSValue_Dereference(v);
+  switch (v->t) {
+    case RSValue_Number:
+      return RS_NewNumberLiteral(v->numval);
+    case RSValue_Null:
+      return RS_NewNullLiteral();
+    case RSValue_String: {
+      RSExpr *e = newExpr(RSExpr_Literal);
+      e->literal = RS_StaticValue(RSValue_String);
+      char *copy = malloc(v->strval.len + 1);
+      memcpy(copy, v->strval.str, v->strval.len);
+      copy[v->strval.len] = '\0';
+      e->literal.strval.str = copy;
+      e->literal.strval.len = v->strval.len;
+      e->literal.strval.stype = RSString_Malloc;
+      return e;
+    }
+    default:
+      return NULL;
+  }
+}
+
+RSExpr *ExprAST_FoldConstants(RSExpr *e) {
+  if (!e) {
+    return NULL;
+  }
+  // Fold the children first, so constant subtrees collapse upwards
+  switch (e->t) {
+    case RSExpr_Op:
+      e->op.left = ExprAST_FoldConstants(e->op.left);
+      e->op.right = ExprAST_FoldConstants(e->op.right);
+      break;
+    case RSExpr_Predicate:
+      e->pred.left = ExprAST_FoldConstants(e->pred.left);
+      e->pred.right = ExprAST_FoldConstants(e->pred.right);
+      break;
+    case RSExpr_Inverted:
+      e->inverted.child = ExprAST_FoldConstants(e->inverted.child);
+      break;
+    case RSExpr_Function:
+      for (size_t ii = 0; ii < e->func.args->len; ++ii) {
+        e->func.args->args[ii] = ExprAST_FoldConstants(e->func.args->args[ii]);
+      }
+      break;
+    default:
+      return e;
+  }
+  if (!exprIsFoldable(e)) {
+    return e;
+  }
+
+  QueryError tmpErr = {0};
+  ExprEval ev = {.err = &tmpErr, .lookup = NULL, .res = NULL, .srcrow = NULL, .root = e};
+  BlkAlloc_Init(&ev.stralloc);
+  RSValue res = RSVALUE_STATIC;
+  RSExpr *folded = NULL;
+  if (ExprEval_Eval(&ev, &res) == EXPR_EVAL_OK) {
+    folded = literalFromValue(&res);
+  }
+  RSValue_Clear(&res);
+  BlkAlloc_FreeAll(&ev.stralloc, NULL, NULL, 0);
+  QueryError_ClearError(&tmpErr);
+  if (!folded) {
+    // Evaluation failed (e.g. bad operand types): keep the subtree as-is and
+    // let the same error surface per row at execution time, as before
+    return e;
+  }
+  RSExpr_Free(e);
+  return folded;
+}
+
+size_t ExprAST_ReplaceEqual(RSExpr **root, const RSExpr *pattern, const char *prop) {
+  RSExpr *e = *root;
+  if (RSExpr_Equal(e, pattern)) {
+    RSExpr_Free(e);
+    *root = RS_NewProp(prop, strlen(prop));
+    return 1;
+  }
+  size_t n = 0;
+  switch (e->t) {
+    case RSExpr_Op:
+      n += ExprAST_ReplaceEqual(&e->op.left, pattern, prop);
+      n += ExprAST_ReplaceEqual(&e->op.right, pattern, prop);
+      break;
+    case RSExpr_Predicate:
+      n += ExprAST_ReplaceEqual(&e->pred.left, pattern, prop);
+      n += ExprAST_ReplaceEqual(&e->pred.right, pattern, prop);
+      break;
+    case RSExpr_Inverted:
+      n += ExprAST_ReplaceEqual(&e->inverted.child, pattern, prop);
+      break;
+    case RSExpr_Function:
+      for (size_t ii = 0; ii < e->func.args->len; ++ii) {
+        n += ExprAST_ReplaceEqual(&e->func.args->args[ii], pattern, prop);
+      }
+      break;
+    default:
+      break;
+  }
+  return n;
+}
+
 void ExprAST_Print(const RSExpr *e) {
   RSExpr_Print(e);
 }
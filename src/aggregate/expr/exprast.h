@@ -20,6 +20,27 @@ RSExpr *RS_NewFunc(const char *str, size_t len, RSArgList *args, RSFunction cb);
 RSExpr *RS_NewProp(const char *str, size_t len);
 RSExpr *RS_NewPredicate(RSCondition cond, RSExpr *left, RSExpr *right);
 RSExpr *RS_NewInverted(RSExpr *child);
+
+/** Structural equality of two parsed expressions */
+int RSExpr_Equal(const RSExpr *a, const RSExpr *b);
+
+/** Whether the expression references the given property anywhere */
+int ExprAST_UsesProperty(const RSExpr *e, const char *prop);
+
+/**
+ * Plan-time constant folding: collapse subtrees whose operands are all
+ * literals into a single literal by evaluating them once. Returns the
+ * (possibly replaced) root; subtrees that cannot or should not be folded are
+ * left as parsed.
+ */
+RSExpr *ExprAST_FoldConstants(RSExpr *root);
+
+/**
+ * Replace every subtree structurally equal to `pattern` with a property
+ * reference to `prop` (common-subexpression reuse). Returns the number of
+ * replacements made.
+ */
+size_t ExprAST_ReplaceEqual(RSExpr **root, const RSExpr *pattern, const char *prop);
 #ifdef __cplusplus
 }
 #endif
@@ -207,6 +207,233 @@ int ExprEval_Eval(ExprEval *evaluator, RSValue *result) {
   return evalInternal(evaluator, evaluator->root, result);
 }
 
+/*******************************************************************************
+ * Compiled numeric programs.
+ *
+ * Expressions over numbers only - arithmetic, comparisons, boolean logic and
+ * numeric properties/literals - are by far the common APPLY/FILTER shape, and
+ * the tree walk above pays per-row recursion, RSValue boxing and refcount
+ * traffic for every node. Such an AST is compiled once, at processor creation,
+ * into a flat postfix program executed on a small double stack: one tight
+ * loop per row, no allocation, no boxing. Anything the compiler does not
+ * recognize (function calls, string literals) simply yields no program and
+ * the tree interpreter runs as before.
+ ******************************************************************************/
+
+typedef enum {
+  NP_CONST,    // push a constant
+  NP_LOAD,     // push a row property, converting to number
+  NP_LOADCOL,  // like NP_LOAD, but a numeric-sortable column serves the
+               // common case with a single array access
+  NP_ADD, NP_SUB, NP_MUL, NP_DIV, NP_MOD, NP_POW,
+  NP_EQ, NP_NE, NP_LT, NP_LE, NP_GT, NP_GE,
+  NP_AND, NP_OR,
+  NP_NOT,
+} NumProgOp;
+
+typedef struct {
+  uint8_t op;
+  union {
+    double cnst;                  // NP_CONST
+    const RLookupKey *lookupObj;  // NP_LOAD
+  };
+} NumProgInstr;
+
+typedef struct {
+  NumProgInstr *instrs;
+  size_t len;
+  size_t cap;
+  /* The program contains comparisons or boolean logic. The interpreter
+   * compares string values AS strings, so when a strict program loads a
+   * non-numeric value it bails out and the row is re-evaluated by the tree
+   * interpreter, preserving exact semantics. Arithmetic-only programs coerce
+   * strings to numbers exactly like the interpreter does */
+  int strict;
+} NumProgram;
+
+/* Third NumProgram_Eval outcome besides EXPR_EVAL_OK/ERR: this row needs the
+ * tree interpreter */
+#define NUMPROG_EVAL_BAIL 2
+
+#define NUMPROG_MAX_STACK 32
+
+static int numProgEmit(NumProgram *p, NumProgInstr instr) {
+  if (p->len == p->cap) {
+    p->cap = p->cap ? p->cap * 2 : 8;
+    p->instrs = realloc(p->instrs, p->cap * sizeof(*p->instrs));
+  }
+  p->instrs[p->len++] = instr;
+  return 1;
+}
+
+/* Postorder-compile `e` into `p`. Returns 0 if the expression is not a pure
+ * numeric program; `depth` tracks the evaluation stack to keep it bounded */
+static int numProgCompile(NumProgram *p, const RSExpr *e, size_t *depth, size_t *maxDepth) {
+#define COMPILE_BINARY(l, r, opcode)                              do {                                                              if (!numProgCompile(p, l, depth, maxDepth) ||                       !numProgCompile(p, r, depth, maxDepth)) {                     return 0;                                                     }                                                               numProgEmit(p, (NumProgInstr){.op = opcode});                   (*depth)--;                                                   } while (0)
+
+  switch (e->t) {
+    case RSExpr_Literal:
+      if (e->literal.t != RSValue_Number) {
+        return 0;
+      }
+      if (++(*depth) > NUMPROG_MAX_STACK) {
+        return 0;
+      }
+      if (*depth > *maxDepth) *maxDepth = *depth;
+      return numProgEmit(p, (NumProgInstr){.op = NP_CONST, .cnst = e->literal.numval});
+
+    case RSExpr_Property:
+      if (!e->property.lookupObj) {
+        return 0;
+      }
+      if (++(*depth) > NUMPROG_MAX_STACK) {
+        return 0;
+      }
+      if (*depth > *maxDepth) *maxDepth = *depth;
+      return numProgEmit(
+          p, (NumProgInstr){.op = (e->property.lookupObj->flags & RLOOKUP_F_SVSRC) ? NP_LOADCOL
+                                                                                   : NP_LOAD,
+                            .lookupObj = e->property.lookupObj});
+
+    case RSExpr_Op: {
+      uint8_t opcode;
+      switch (e->op.op) {
+        case '+': opcode = NP_ADD; break;
+        case '-': opcode = NP_SUB; break;
+        case '*': opcode = NP_MUL; break;
+        case '/': opcode = NP_DIV; break;
+        case '%': opcode = NP_MOD; break;
+        case '^': opcode = NP_POW; break;
+        default: return 0;
+      }
+      COMPILE_BINARY(e->op.left, e->op.right, opcode);
+      return 1;
+    }
+
+    case RSExpr_Predicate: {
+      uint8_t opcode;
+      p->strict = 1;
+      switch (e->pred.cond) {
+        case RSCondition_Eq: opcode = NP_EQ; break;
+        case RSCondition_Ne: opcode = NP_NE; break;
+        case RSCondition_Lt: opcode = NP_LT; break;
+        case RSCondition_Le: opcode = NP_LE; break;
+        case RSCondition_Gt: opcode = NP_GT; break;
+        case RSCondition_Ge: opcode = NP_GE; break;
+        case RSCondition_And: opcode = NP_AND; break;
+        case RSCondition_Or: opcode = NP_OR; break;
+        default: return 0;
+      }
+      COMPILE_BINARY(e->pred.left, e->pred.right, opcode);
+      return 1;
+    }
+
+    case RSExpr_Inverted:
+      p->strict = 1;
+      if (!numProgCompile(p, e->inverted.child, depth, maxDepth)) {
+        return 0;
+      }
+      numProgEmit(p, (NumProgInstr){.op = NP_NOT});
+      return 1;
+
+    default:
+      return 0;
+  }
+#undef COMPILE_BINARY
+}
+
+/* Compile the AST, or return NULL when it is not numeric-only */
+static NumProgram *NumProgram_Compile(const RSExpr *root) {
+  NumProgram *p = calloc(1, sizeof(*p));
+  size_t depth = 0, maxDepth = 0;
+  if (!numProgCompile(p, root, &depth, &maxDepth)) {
+    free(p->instrs);
+    free(p);
+    return NULL;
+  }
+  return p;
+}
+
+static void NumProgram_Free(NumProgram *p) {
+  if (p) {
+    free(p->instrs);
+    free(p);
+  }
+}
+
+/* Execute over one row. Same error surface as the interpreter: missing
+ * properties and non-numeric values set `err` and fail the evaluation */
+static int NumProgram_Eval(const NumProgram *p, const RLookupRow *srcrow, t_docId docId,
+                           const RSSortingTable *sortables, double *out, QueryError *err) {
+  double stack[NUMPROG_MAX_STACK];
+  size_t sp = 0;
+
+  for (size_t i = 0; i < p->len; i++) {
+    const NumProgInstr *ins = &p->instrs[i];
+    switch (ins->op) {
+      case NP_CONST:
+        stack[sp++] = ins->cnst;
+        break;
+      case NP_LOADCOL: {
+        // One array access when the value sits in its sortable column and no
+        // earlier stage overrode it in the row
+        const RLookupKey *k = ins->lookupObj;
+        if (sortables && docId &&
+            !(srcrow->dyn && array_len(srcrow->dyn) > k->dstidx && srcrow->dyn[k->dstidx])) {
+          double d;
+          if (SortingTable_ColumnGet(sortables, k->svidx, docId, &d)) {
+            stack[sp++] = d;
+            break;
+          }
+        }
+      }
+      // fall through - the boxed load preserves exact semantics
+      case NP_LOAD: {
+        RSValue *value = RLookup_GetItem(ins->lookupObj, srcrow);
+        if (!value) {
+          QueryError_SetError(err, QUERY_ENOPROPVAL, NULL);
+          return EXPR_EVAL_ERR;
+        }
+        value = RSValue_Dereference(value);
+        if (value->t != RSValue_Number) {
+          if (p->strict) {
+            return NUMPROG_EVAL_BAIL;
+          }
+          double n;
+          if (!RSValue_ToNumber(value, &n)) {
+            return EXPR_EVAL_ERR;
+          }
+          stack[sp++] = n;
+          break;
+        }
+        stack[sp++] = value->numval;
+        break;
+      }
+#define BINOP(opcode, expr)                     case opcode: {                                  double r = stack[--sp];                       double l = stack[sp - 1];                     stack[sp - 1] = (expr);                       break;                                      }
+      BINOP(NP_ADD, l + r)
+      BINOP(NP_SUB, l - r)
+      BINOP(NP_MUL, l * r)
+      BINOP(NP_DIV, l / r)
+      BINOP(NP_MOD, (double)((long long)l % (long long)r))
+      BINOP(NP_POW, pow(l, r))
+      BINOP(NP_EQ, l == r)
+      BINOP(NP_NE, l != r)
+      BINOP(NP_LT, l < r)
+      BINOP(NP_LE, l <= r)
+      BINOP(NP_GT, l > r)
+      BINOP(NP_GE, l >= r)
+      BINOP(NP_AND, (l != 0) && (r != 0))
+      BINOP(NP_OR, (l != 0) || (r != 0))
+#undef BINOP
+      case NP_NOT:
+        stack[sp - 1] = stack[sp - 1] == 0;
+        break;
+    }
+  }
+  *out = stack[0];
+  return EXPR_EVAL_OK;
+}
+
 int ExprAST_GetLookupKeys(RSExpr *expr, RLookup *lookup, QueryError *err) {
 #define RECURSE(v)                                             \
   if (ExprAST_GetLookupKeys(v, lookup, err) != EXPR_EVAL_OK) { \
@@ -266,6 +493,11 @@ struct RPEvaluator {
   RSValue *val;
   const RLookupKey *outkey;
   int isFilter;
+  // Set by the scorer constructor, which owns its ast (no plan step does)
+  RSExpr *ownedAst;
+  NumProgram *prog;  // non-NULL when the expression compiled to a numeric program
+  // Column source for NP_LOADCOL; may be NULL (boxed loads still work)
+  const RSSortingTable *sortables;
 };
 
 #define RESULT_EVAL_ERR RS_RESULT_MAX + 1
@@ -287,6 +519,22 @@ static int rpevalCommon(RPEvaluator *pc, SearchResult *r) {
     pc->val = RS_NewValue(RSValue_Undef);
   }
 
+  if (pc->prog) {
+    double out;
+    int prc = NumProgram_Eval(pc->prog, &r->rowdata, r->docId, pc->sortables, &out, pc->eval.err);
+    if (prc == EXPR_EVAL_ERR) {
+      return RS_RESULT_ERROR;
+    }
+    if (prc == EXPR_EVAL_OK) {
+      RSValue_Clear(pc->val);
+      pc->val->numval = out;
+      pc->val->t = RSValue_Number;
+      return RS_RESULT_OK;
+    }
+    // NUMPROG_EVAL_BAIL: a strict program met a non-numeric value - this row
+    // gets the interpreter below
+  }
+
   rc = ExprEval_Eval(&pc->eval, pc->val);
   if (rc == EXPR_EVAL_ERR) {
     return RS_RESULT_ERROR;
@@ -324,16 +572,42 @@ static int rpevalNext_filter(ResultProcessor *rp, SearchResult *r) {
   return rc;
 }
 
+static int rpevalNext_score(ResultProcessor *rp, SearchResult *r) {
+  RPEvaluator *pc = (RPEvaluator *)rp;
+  int rc = rpevalCommon(pc, r);
+  if (rc != RS_RESULT_OK) {
+    return rc;
+  }
+  double score;
+  int ok = RSValue_ToNumber(pc->val, &score);
+  // Clear leaves a reference's type behind with its target gone; reset it so
+  // the next evaluation (or the teardown decref) does not release it again
+  RSValue_Clear(pc->val);
+  pc->val->t = RSValue_Undef;
+  if (!ok) {
+    QueryError_SetError(pc->base.parent->err, QUERY_EGENERIC,
+                        "Scoring expression did not evaluate to a number");
+    return RS_RESULT_ERROR;
+  }
+  r->score = score;
+  return RS_RESULT_OK;
+}
+
 static void rpevalFree(ResultProcessor *rp) {
   RPEvaluator *ee = (RPEvaluator *)rp;
   if (ee->val) {
     RSValue_Decref(ee->val);
   }
+  if (ee->ownedAst) {
+    ExprAST_Free(ee->ownedAst);
+  }
+  NumProgram_Free(ee->prog);
   BlkAlloc_FreeAll(&ee->eval.stralloc, NULL, NULL, 0);
   free(ee);
 }
 static ResultProcessor *RPEvaluator_NewCommon(const RSExpr *ast, const RLookup *lookup,
-                                              const RLookupKey *dstkey, int isFilter) {
+                                              const RLookupKey *dstkey, int isFilter,
+                                              const RSSortingTable *sortables) {
   RPEvaluator *rp = calloc(1, sizeof(*rp));
   rp->base.Next = isFilter ? rpevalNext_filter : rpevalNext_project;
   rp->base.Free = rpevalFree;
@@ -341,15 +615,28 @@ static ResultProcessor *RPEvaluator_NewCommon(const RSExpr *ast, const RLookup *
   rp->eval.lookup = lookup;
   rp->eval.root = ast;
   rp->outkey = dstkey;
+  rp->prog = NumProgram_Compile(ast);
+  rp->sortables = sortables;
   BlkAlloc_Init(&rp->eval.stralloc);
   return &rp->base;
 }
 
 ResultProcessor *RPEvaluator_NewProjector(const RSExpr *ast, const RLookup *lookup,
-                                          const RLookupKey *dstkey) {
-  return RPEvaluator_NewCommon(ast, lookup, dstkey, 0);
+                                          const RLookupKey *dstkey,
+                                          const RSSortingTable *sortables) {
+  return RPEvaluator_NewCommon(ast, lookup, dstkey, 0, sortables);
 }
 
-ResultProcessor *RPEvaluator_NewFilter(const RSExpr *ast, const RLookup *lookup) {
-  return RPEvaluator_NewCommon(ast, lookup, NULL, 1);
+ResultProcessor *RPEvaluator_NewFilter(const RSExpr *ast, const RLookup *lookup,
+                                       const RSSortingTable *sortables) {
+  return RPEvaluator_NewCommon(ast, lookup, NULL, 1, sortables);
+}
+
+ResultProcessor *RPEvaluator_NewScorer(RSExpr *ast, const RLookup *lookup,
+                                       const RSSortingTable *sortables) {
+  RPEvaluator *rp = (RPEvaluator *)RPEvaluator_NewCommon(ast, lookup, NULL, 0, sortables);
+  rp->base.Next = rpevalNext_score;
+  rp->base.name = "ExprScorer";
+  rp->ownedAst = ast;
+  return &rp->base;
 }
@@ -152,7 +152,9 @@ void ExprEval_Cleanup(ExprEval *ev);
  * @note The ast needs to be paired with the appropriate RLookupKey objects. This
  * can be done by calling EXPR_GetLookupKeys()
  */
-ResultProcessor *RPEvaluator_NewProjector(const RSExpr *ast, const RLookup *lookup, const RLookupKey *dstkey);
+ResultProcessor *RPEvaluator_NewProjector(const RSExpr *ast, const RLookup *lookup,
+                                          const RLookupKey *dstkey,
+                                          const RSSortingTable *sortables);
 
 /**
  * Creates a new result processor in the form of a filter. The filter will
@@ -164,7 +166,18 @@ ResultProcessor *RPEvaluator_NewProjector(const RSExpr *ast, const RLookup *look
  * 
  * See notes for NewProjector()
  */
-ResultProcessor *RPEvaluator_NewFilter(const RSExpr *ast, const RLookup *lookup);
+ResultProcessor *RPEvaluator_NewFilter(const RSExpr *ast, const RLookup *lookup,
+                                       const RSSortingTable *sortables);
+
+/**
+ * Creates a scoring processor: evaluates `ast` on each upstream result and
+ * writes the numeric outcome to the result's score (SCORER EXPR:...).
+ * Numeric-only expressions run through the compiled program like APPLY does.
+ * Unlike the other constructors this one takes ownership of the ast, since
+ * no plan step holds it.
+ */
+ResultProcessor *RPEvaluator_NewScorer(RSExpr *ast, const RLookup *lookup,
+                                       const RSSortingTable *sortables);
 
 #ifdef __cplusplus
 }
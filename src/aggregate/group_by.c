@@ -3,6 +3,9 @@
 #include <util/block_alloc.h>
 #include <util/khash.h>
 #include "reducer.h"
+#include "config.h"
+#include <sys/param.h>
+#include <unistd.h>
 
 /**
  * A group represents the allocated context of all reducers in a group, and the
@@ -39,6 +42,33 @@ KHASH_MAP_INIT_INT64(khid, Group *);
 #define GROUPS_PER_BLOCK 1024
 #define GROUPER_NSRCKEYS(g) ((g)->nkeys)
 
+/*******************************************************************************
+ * Spill-to-disk grouping (grace hash, one level).
+ *
+ * A high-cardinality GROUPBY is unbounded in RAM: every distinct key owns a
+ * Group plus per-reducer state. When GROUPBY_MAX_MEMORY is configured and the
+ * table estimate passes it, group CREATION stops: rows belonging to existing
+ * groups keep accumulating in place, while rows for unseen groups are
+ * serialized - just the group keys and each reducer's source key, which is
+ * why every reducer must be spillSafe - into one of GROUPER_NSPILL temp
+ * files by group-hash partition. After the in-memory groups are yielded, the
+ * partitions are replayed one at a time through the normal accumulation
+ * path, each bounded to its own share of the key space. A partition that
+ * still exceeds the ceiling is processed in RAM regardless (no recursive
+ * repartitioning); rows whose captured values are not scalars (arrays from
+ * multi-value fields) also stay in RAM, overshooting the ceiling rather
+ * than dropping data.
+ ******************************************************************************/
+
+#define GROUPER_NSPILL 16
+// rough per-group overhead beyond the Group struct: khash slot + reducer state
+#define GROUP_MEM_OVERHEAD 96
+
+typedef struct {
+  FILE *f;
+  size_t nrows;
+} SpillPartition;
+
 typedef struct Grouper {
   // Result processor base, for use in row processing
   ResultProcessor base;
@@ -59,11 +89,23 @@ typedef struct Grouper {
   const RLookupKey **dstkeys;
   size_t nkeys;
 
+  // When set, reducers yield their mergeable partial state (FinalizePartial)
+  // instead of final values
+  int partials;
+
   // array of reducers
   Reducer **reducers;
 
   // Used for maintaining state when yielding groups
   khiter_t iter;
+
+  // Spill state (see the block comment above)
+  size_t maxMemory;            // RSGlobalConfig.groupByMaxMemory, snapshotted
+  int spilling;                // ceiling hit - new groups go to disk
+  const RLookupKey **capKeys;  // keys captured per spilled row
+  size_t nCapKeys;
+  SpillPartition spill[GROUPER_NSPILL];
+  int replayPart;  // partition currently replayed at yield time; -1 before
 } Grouper;
 
 /**
@@ -76,6 +118,11 @@ typedef struct Grouper {
 static Group *createGroup(Grouper *g, const RSValue **groupvals, size_t ngrpvals) {
   size_t numReducers = array_len(g->reducers);
   size_t elemSize = GROUP_BYTESIZE(g);
+  // a group's footprint is its struct plus its reducer instances; charge the
+  // struct and a flat per-reducer estimate against the spec's quota
+  if (!QITR_ChargeMemory(g->base.parent, elemSize + numReducers * 64)) {
+    return NULL;
+  }
   Group *group = BlkAlloc_Alloc(&g->groupsAlloc, elemSize, GROUPS_PER_BLOCK * elemSize);
   memset(group, 0, elemSize);
 
@@ -94,9 +141,270 @@ static Group *createGroup(Grouper *g, const RSValue **groupvals, size_t ngrpvals
   return group;
 }
 
+/* A grouper can absorb another's table iff every reducer implements Merge */
+int Grouper_CanMerge(const Grouper *g) {
+  for (size_t ii = 0; ii < GROUPER_NREDUCERS(g); ++ii) {
+    if (!g->reducers[ii]->Merge) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Fold `src`'s groups into `dst`. Both groupers must have been built with the
+ * same keys and the same reducer list (the intended use is thread-local
+ * partials of one GROUPBY - see the parallel-groupby notes in the commit
+ * history; nothing in-tree segments the upstream yet, but the mergeable
+ * reducers here are what the HLL and sketch reducers compose with). `src` is
+ * left intact and must still be freed by its owner. Returns 0 if any reducer
+ * cannot merge */
+int Grouper_MergePartial(Grouper *dst, Grouper *src) {
+  if (!Grouper_CanMerge(dst)) {
+    return 0;
+  }
+  size_t nreducers = GROUPER_NREDUCERS(dst);
+
+  for (khiter_t it = kh_begin(src->groups); it != kh_end(src->groups); ++it) {
+    if (!kh_exist(src->groups, it)) {
+      continue;
+    }
+    uint64_t hval = kh_key(src->groups, it);
+    Group *sgr = kh_value(src->groups, it);
+
+    khiter_t k = kh_get(khid, dst->groups, hval);
+    Group *dgr;
+    if (k == kh_end(dst->groups)) {
+      // new group in dst: seed it with the source group's key values
+      size_t nkeys = GROUPER_NSRCKEYS(dst);
+      const RSValue *groupvals[nkeys];
+      for (size_t ii = 0; ii < nkeys; ++ii) {
+        RSValue *v = RLookup_GetItem(dst->dstkeys[ii], &sgr->rowdata);
+        groupvals[ii] = v ? v : RS_NullVal();
+      }
+      dgr = createGroup(dst, groupvals, nkeys);
+      if (!dgr) {
+        return 0;  // quota exhausted mid-merge: the error state aborts the query
+      }
+      kh_set(khid, dst->groups, hval, dgr);
+    } else {
+      dgr = kh_value(dst->groups, k);
+    }
+
+    for (size_t ii = 0; ii < nreducers; ++ii) {
+      dst->reducers[ii]->Merge(dst->reducers[ii], dgr->accumdata[ii], sgr->accumdata[ii]);
+    }
+  }
+  return 1;
+}
+
+/* Whether this grouper may spill at all: a ceiling is configured and every
+ * reducer's row inputs are captured by its srckey */
+static int spillAllowed(const Grouper *g) {
+  if (!g->maxMemory) {
+    return 0;
+  }
+  for (size_t ii = 0; ii < GROUPER_NREDUCERS(g); ++ii) {
+    if (!g->reducers[ii]->spillSafe) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Lazily compute the captured-key set: group source keys plus each reducer's
+ * source key (COUNT has none) */
+static void spillInitCapKeys(Grouper *g) {
+  if (g->capKeys) {
+    return;
+  }
+  size_t max = g->nkeys + GROUPER_NREDUCERS(g);
+  g->capKeys = calloc(max, sizeof(*g->capKeys));
+  size_t n = 0;
+  for (size_t ii = 0; ii < g->nkeys; ++ii) {
+    g->capKeys[n++] = g->srckeys[ii];
+  }
+  for (size_t ii = 0; ii < GROUPER_NREDUCERS(g); ++ii) {
+    const RLookupKey *k = g->reducers[ii]->srckey;
+    int dup = 0;
+    for (size_t jj = 0; k && jj < n; ++jj) {
+      if (g->capKeys[jj] == k) {
+        dup = 1;
+        break;
+      }
+    }
+    if (k && !dup) {
+      g->capKeys[n++] = k;
+    }
+  }
+  g->nCapKeys = n;
+}
+
+/* Serialize one row into its partition. Returns 0 (do not spill) when a
+ * captured value is not a scalar */
+static int spillWriteRow(Grouper *g, uint64_t hval, RLookupRow *row) {
+  // pre-validate: scalars only
+  for (size_t ii = 0; ii < g->nCapKeys; ++ii) {
+    RSValue *v = RLookup_GetItem(g->capKeys[ii], row);
+    if (v) {
+      v = RSValue_Dereference(v);
+      if (v->t != RSValue_Number && v->t != RSValue_String && v->t != RSValue_RedisString &&
+          v->t != RSValue_Null) {
+        return 0;
+      }
+    }
+  }
+
+  SpillPartition *sp = &g->spill[hval % GROUPER_NSPILL];
+  if (!sp->f) {
+    sp->f = tmpfile();
+    if (!sp->f) {
+      return 0;  // cannot spill - keep the group in RAM
+    }
+  }
+
+  // assemble the row first so a failed write (disk full) never leaves a
+  // half-framed record behind; the row then stays in RAM instead
+  char stackbuf[512];
+  char *buf = stackbuf;
+  size_t cap = sizeof(stackbuf), len = 0;
+#define ROW_APPEND(p, n)                            do {                                                if (len + (n) > cap) {                              cap = MAX(cap * 2, len + (n));                    buf = buf == stackbuf ? memcpy(malloc(cap), stackbuf, len) : realloc(buf, cap);     }                                                 memcpy(buf + len, (p), (n));                      len += (n);                                     } while (0)
+
+  for (size_t ii = 0; ii < g->nCapKeys; ++ii) {
+    RSValue *v = RLookup_GetItem(g->capKeys[ii], row);
+    if (v) {
+      v = RSValue_Dereference(v);
+    }
+    uint8_t tag;
+    if (!v) {
+      tag = 0;
+      ROW_APPEND(&tag, 1);
+    } else if (v->t == RSValue_Null) {
+      tag = 3;
+      ROW_APPEND(&tag, 1);
+    } else if (v->t == RSValue_Number) {
+      tag = 1;
+      ROW_APPEND(&tag, 1);
+      ROW_APPEND(&v->numval, sizeof(double));
+    } else {
+      tag = 2;
+      size_t slen;
+      const char *s = RSValue_StringPtrLen(v, &slen);
+      uint32_t len32 = slen;
+      ROW_APPEND(&tag, 1);
+      ROW_APPEND(&len32, sizeof(len32));
+      ROW_APPEND(s, slen);
+    }
+  }
+#undef ROW_APPEND
+
+  long pos = ftell(sp->f);
+  int ok = fwrite(buf, 1, len, sp->f) == len;
+  if (buf != stackbuf) {
+    free(buf);
+  }
+  if (!ok) {
+    // drop the partial record so the rows already in the partition replay
+    // cleanly; this row's group is kept in RAM instead
+    fflush(sp->f);
+    if (pos >= 0 && ftruncate(fileno(sp->f), pos) == 0) {
+      fseek(sp->f, pos, SEEK_SET);
+    }
+    clearerr(sp->f);
+    return 0;
+  }
+  sp->nrows++;
+  return 1;
+}
+
+/* Read one spilled row back into `row`. Returns 0 at EOF */
+static int spillReadRow(Grouper *g, FILE *f, RLookupRow *row) {
+  for (size_t ii = 0; ii < g->nCapKeys; ++ii) {
+    uint8_t tag;
+    if (fread(&tag, 1, 1, f) != 1) {
+      return 0;  // clean EOF before the first field
+    }
+    RSValue *v = NULL;
+    if (tag == 1) {
+      double d;
+      if (fread(&d, sizeof(d), 1, f) != 1) return 0;
+      v = RS_NumVal(d);
+    } else if (tag == 2) {
+      uint32_t len;
+      if (fread(&len, sizeof(len), 1, f) != 1) return 0;
+      char *buf = malloc(len + 1);
+      if (fread(buf, 1, len, f) != len) {
+        free(buf);
+        return 0;
+      }
+      buf[len] = 0;
+      v = RS_StringVal(buf, len);
+    } else if (tag == 3) {
+      v = RS_NullVal();
+    }
+    if (v) {
+      RLookup_WriteOwnKey((RLookupKey *)g->capKeys[ii], row, v);
+    }
+  }
+  return 1;
+}
+
+static void invokeGroupReducers(Grouper *g, RLookupRow *srcrow);
+
+/* Free the current group table (yielded groups included) so a partition can
+ * be accumulated into a fresh one */
+static void clearGroupsForReplay(Grouper *g) {
+  for (khiter_t it = kh_begin(g->groups); it != kh_end(g->groups); ++it) {
+    if (!kh_exist(g->groups, it)) {
+      continue;
+    }
+    Group *gr = kh_value(g->groups, it);
+    for (size_t ii = 0; ii < GROUPER_NREDUCERS(g); ++ii) {
+      Reducer *rr = g->reducers[ii];
+      if (rr->FreeInstance) {
+        rr->FreeInstance(rr, gr->accumdata[ii]);
+      }
+    }
+    RLookupRow_Cleanup(&gr->rowdata);
+  }
+  kh_clear(khid, g->groups);
+  BlkAlloc_FreeAll(&g->groupsAlloc, NULL, NULL, 0);
+  BlkAlloc_Init(&g->groupsAlloc);
+}
+
+/* Replay the next non-empty spilled partition into the (cleared) group
+ * table. Returns 1 when a partition was loaded, 0 when none remain */
+static int spillReplayNextPartition(Grouper *g, ResultProcessor *base) {
+  while (++g->replayPart < GROUPER_NSPILL) {
+    SpillPartition *sp = &g->spill[g->replayPart];
+    if (!sp->f || !sp->nrows) {
+      if (sp->f) {
+        fclose(sp->f);
+        sp->f = NULL;
+      }
+      continue;
+    }
+    clearGroupsForReplay(g);
+    g->spilling = 0;  // partitions accumulate fully in RAM - no re-spill
+    rewind(sp->f);
+    RLookupRow row = {0};
+    while (spillReadRow(g, sp->f, &row)) {
+      invokeGroupReducers(g, &row);
+      RLookupRow_Wipe(&row);
+    }
+    RLookupRow_Cleanup(&row);
+    fclose(sp->f);
+    sp->f = NULL;
+    base->parent->totalResults += kh_size(g->groups);
+    g->iter = kh_begin(khid);
+    return 1;
+  }
+  return 0;
+}
+
 static int Grouper_rpYield(ResultProcessor *base, SearchResult *r) {
   Grouper *g = (Grouper *)base;
 
+yieldNext:
   while (g->iter != kh_end(g->groups)) {
     if (!kh_exist(g->groups, g->iter)) {
       g->iter++;
@@ -106,7 +414,8 @@ static int Grouper_rpYield(ResultProcessor *base, SearchResult *r) {
     Group *gr = kh_value(g->groups, g->iter);
     for (size_t ii = 0; ii < GROUPER_NREDUCERS(g); ++ii) {
       Reducer *rd = g->reducers[ii];
-      RSValue *v = rd->Finalize(rd, gr->accumdata[ii]);
+      RSValue *v = g->partials ? rd->FinalizePartial(rd, gr->accumdata[ii])
+                               : rd->Finalize(rd, gr->accumdata[ii]);
       if (v) {
         RLookup_WriteOwnKey(rd->dstkey, &r->rowdata, v);
 
@@ -127,6 +436,9 @@ static int Grouper_rpYield(ResultProcessor *base, SearchResult *r) {
     return RS_RESULT_OK;
   }
 
+  if (spillReplayNextPartition(g, base)) {
+    goto yieldNext;
+  }
   return RS_RESULT_EOF;
 }
 
@@ -162,7 +474,19 @@ static void extractGroups(Grouper *g, const RSValue **xarr, size_t xpos, size_t
     // Get or create the group
     khiter_t k = kh_get(khid, g->groups, hval);  // first have to get ieter
     if (k == kh_end(g->groups)) {                // k will be equal to kh_end if key not present
+      if (!g->spilling && g->replayPart < 0 && g->maxMemory &&
+          kh_size(g->groups) * (GROUP_BYTESIZE(g) + GROUP_MEM_OVERHEAD) >= g->maxMemory &&
+          spillAllowed(g)) {
+        spillInitCapKeys(g);
+        g->spilling = 1;
+      }
+      if (g->spilling && spillWriteRow(g, hval, res)) {
+        return;
+      }
       group = createGroup(g, xarr, xlen);
+      if (!group) {
+        return;  // quota exhausted: the iterator error state stops the query
+      }
       kh_set(khid, g->groups, hval, group);
     } else {
       group = kh_value(g->groups, k);
@@ -223,13 +547,30 @@ static void invokeGroupReducers(Grouper *g, RLookupRow *srcrow) {
 }
 
 static int Grouper_rpAccum(ResultProcessor *base, SearchResult *res) {
+  RM_ALLOC_TAG_SCOPE(RM_TAG_GROUPER);
   Grouper *g = (Grouper *)base;
 
   int rc;
 
-  while ((rc = base->upstream->Next(base->upstream, res)) == RS_RESULT_OK) {
-    invokeGroupReducers(g, &res->rowdata);
-    SearchResult_Clear(res);
+  if (base->upstream->NextChunk) {
+    ResultChunk chunk;
+    while ((rc = ResultProcessor_NextChunk(base->upstream, &chunk)) == RS_RESULT_OK) {
+      for (uint32_t i = 0; i < chunk.len; i++) {
+        invokeGroupReducers(g, &chunk.rows[i].rowdata);
+        SearchResult_Clear(&chunk.rows[i]);
+      }
+      if (base->parent->state == QITR_S_ABORTED) {
+        return RS_RESULT_ERROR;  // a group charge hit the memory quota
+      }
+    }
+  } else {
+    while ((rc = base->upstream->Next(base->upstream, res)) == RS_RESULT_OK) {
+      invokeGroupReducers(g, &res->rowdata);
+      SearchResult_Clear(res);
+      if (base->parent->state == QITR_S_ABORTED) {
+        return RS_RESULT_ERROR;
+      }
+    }
   }
   if (rc == RS_RESULT_EOF) {
     base->Next = Grouper_rpYield;
@@ -271,6 +612,12 @@ static void Grouper_rpFree(ResultProcessor *grrp) {
   if (g->reducers) {
     array_free(g->reducers);
   }
+  for (int ii = 0; ii < GROUPER_NSPILL; ++ii) {
+    if (g->spill[ii].f) {
+      fclose(g->spill[ii].f);
+    }
+  }
+  free(g->capKeys);
   free(g->srckeys);
   free(g->dstkeys);
   free(g);
@@ -289,12 +636,20 @@ Grouper *Grouper_New(const RLookupKey **srckeys, const RLookupKey **dstkeys, siz
     g->dstkeys[ii] = dstkeys[ii];
   }
 
+  g->maxMemory = RSGlobalConfig.groupByMaxMemory;
+  g->replayPart = -1;
+
   g->base.name = "Grouper";
   g->base.Next = Grouper_rpAccum;
   g->base.Free = Grouper_rpFree;
   return g;
 }
 
+/* Emit mergeable partial blobs instead of final values (WITHPARTIALS) */
+void Grouper_SetPartials(Grouper *g) {
+  g->partials = 1;
+}
+
 void Grouper_AddReducer(Grouper *g, Reducer *r, RLookupKey *dstkey) {
   Reducer **rpp = array_ensure_tail(&g->reducers, Reducer *);
   *rpp = r;
@@ -0,0 +1,269 @@
+#include "partials.h"
+#include "../util/tdigest.h"
+#include "../rmalloc.h"
+#include "../dep/hll/hll.h"
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+/* A parsed view of any partial blob. Quantile centroids and distinct hashes
+ * point into the source blob */
+typedef struct {
+  AggPartialKind kind;
+  uint64_t count;  // COUNT / SUM count / MINMAX matches / STDDEV n
+  double a, b;     // SUM total / MINMAX val / STDDEV mean,M2 / QUANTILE pct,compression
+  uint32_t n;      // QUANTILE centroids / DISTINCT hashes
+  const char *items;
+  uint8_t bits;  // HLL
+  const char *registers;
+} AggPartialView;
+
+static int partialParse(const char *blob, size_t len, AggPartialView *v) {
+  if (len < 1) {
+    return 0;
+  }
+  memset(v, 0, sizeof(*v));
+  v->kind = (AggPartialKind)(uint8_t)blob[0];
+  const char *p = blob + 1;
+  size_t rem = len - 1;
+#define TAKE(dst, sz)            \
+  do {                           \
+    if (rem < (sz)) return 0;    \
+    memcpy(dst, p, sz);          \
+    p += (sz);                   \
+    rem -= (sz);                 \
+  } while (0)
+  switch (v->kind) {
+    case AGG_PARTIAL_COUNT:
+      TAKE(&v->count, 8);
+      break;
+    case AGG_PARTIAL_SUM:
+    case AGG_PARTIAL_AVG:
+    case AGG_PARTIAL_MIN:
+    case AGG_PARTIAL_MAX:
+      TAKE(&v->count, 8);
+      TAKE(&v->a, 8);
+      break;
+    case AGG_PARTIAL_STDDEV:
+      TAKE(&v->count, 8);
+      TAKE(&v->a, 8);
+      TAKE(&v->b, 8);
+      break;
+    case AGG_PARTIAL_QUANTILE:
+      TAKE(&v->a, 8);
+      TAKE(&v->b, 8);
+      TAKE(&v->n, 4);
+      if (rem != (size_t)v->n * 16) return 0;
+      v->items = p;
+      break;
+    case AGG_PARTIAL_DISTINCT:
+      TAKE(&v->n, 4);
+      if (rem != (size_t)v->n * 8) return 0;
+      v->items = p;
+      break;
+    case AGG_PARTIAL_HLL:
+      TAKE(&v->bits, 1);
+      if (v->bits < 4 || v->bits > 20 || rem != (size_t)1 << v->bits) return 0;
+      v->registers = p;
+      break;
+    default:
+      return 0;
+  }
+#undef TAKE
+  return 1;
+}
+
+static char *fixedBlob(AggPartialKind kind, const void *fields, size_t flen, size_t *outlen) {
+  char *out = rm_malloc(1 + flen);
+  out[0] = kind;
+  memcpy(out + 1, fields, flen);
+  *outlen = 1 + flen;
+  return out;
+}
+
+static int u64cmp(const void *a, const void *b) {
+  uint64_t x, y;
+  memcpy(&x, a, 8);
+  memcpy(&y, b, 8);
+  return x < y ? -1 : x > y;
+}
+
+char *AggPartial_Merge(const char *dst, size_t dstlen, const char *src, size_t srclen,
+                       size_t *outlen) {
+  AggPartialView d, s;
+  if (!partialParse(dst, dstlen, &d) || !partialParse(src, srclen, &s) || d.kind != s.kind) {
+    return NULL;
+  }
+  switch (d.kind) {
+    case AGG_PARTIAL_COUNT: {
+      uint64_t count = d.count + s.count;
+      return fixedBlob(d.kind, &count, 8, outlen);
+    }
+    case AGG_PARTIAL_SUM:
+    case AGG_PARTIAL_AVG: {
+      struct {
+        uint64_t count;
+        double total;
+      } f = {d.count + s.count, d.a + s.a};
+      return fixedBlob(d.kind, &f, 16, outlen);
+    }
+    case AGG_PARTIAL_MIN:
+    case AGG_PARTIAL_MAX: {
+      struct {
+        uint64_t n;
+        double val;
+      } f = {d.count + s.count, 0};
+      if (!d.count) {
+        f.val = s.a;
+      } else if (!s.count) {
+        f.val = d.a;
+      } else {
+        f.val = d.kind == AGG_PARTIAL_MIN ? (d.a < s.a ? d.a : s.a) : (d.a > s.a ? d.a : s.a);
+      }
+      return fixedBlob(d.kind, &f, 16, outlen);
+    }
+    case AGG_PARTIAL_STDDEV: {
+      // Chan et al. parallel variance: combine (n, mean, M2) pairs exactly
+      struct {
+        uint64_t n;
+        double mean, m2;
+      } f;
+      f.n = d.count + s.count;
+      if (!f.n) {
+        f.mean = f.m2 = 0;
+      } else {
+        double delta = s.a - d.a;
+        f.mean = d.a + delta * ((double)s.count / f.n);
+        f.m2 = d.b + s.b + delta * delta * ((double)d.count * s.count / f.n);
+      }
+      return fixedBlob(d.kind, &f, 24, outlen);
+    }
+    case AGG_PARTIAL_QUANTILE: {
+      // fold both centroid sets through a digest at the larger compression,
+      // then re-extract - the same operation TDigest_Merge performs
+      double compression = d.b > s.b ? d.b : s.b;
+      TDigest *td = TDigest_New(compression);
+      for (int which = 0; which < 2; which++) {
+        const AggPartialView *v = which ? &s : &d;
+        for (uint32_t i = 0; i < v->n; i++) {
+          double mean, weight;
+          memcpy(&mean, v->items + i * 16, 8);
+          memcpy(&weight, v->items + i * 16 + 8, 8);
+          TDigest_Add(td, mean, weight);
+        }
+      }
+      size_t cap = TDigest_NumCentroids(td);
+      double *means = rm_malloc((cap ? cap : 1) * sizeof(double));
+      double *weights = rm_malloc((cap ? cap : 1) * sizeof(double));
+      size_t n = TDigest_GetCentroids(td, means, weights, cap);
+      TDigest_Free(td);
+      size_t len = 1 + 8 + 8 + 4 + n * 16;
+      char *out = rm_malloc(len);
+      out[0] = d.kind;
+      memcpy(out + 1, &d.a, 8);  // pct travels with the digest
+      memcpy(out + 9, &compression, 8);
+      uint32_t n32 = n;
+      memcpy(out + 17, &n32, 4);
+      for (size_t i = 0; i < n; i++) {
+        memcpy(out + 21 + i * 16, &means[i], 8);
+        memcpy(out + 21 + i * 16 + 8, &weights[i], 8);
+      }
+      rm_free(means);
+      rm_free(weights);
+      *outlen = len;
+      return out;
+    }
+    case AGG_PARTIAL_DISTINCT: {
+      // exact: sorted union of the two hash sets
+      size_t total = (size_t)d.n + s.n;
+      uint64_t *all = rm_malloc((total ? total : 1) * 8);
+      memcpy(all, d.items, (size_t)d.n * 8);
+      memcpy(all + d.n, s.items, (size_t)s.n * 8);
+      qsort(all, total, 8, u64cmp);
+      size_t uniq = 0;
+      for (size_t i = 0; i < total; i++) {
+        if (!uniq || all[uniq - 1] != all[i]) {
+          all[uniq++] = all[i];
+        }
+      }
+      size_t len = 1 + 4 + uniq * 8;
+      char *out = rm_malloc(len);
+      out[0] = d.kind;
+      uint32_t n32 = uniq;
+      memcpy(out + 1, &n32, 4);
+      memcpy(out + 5, all, uniq * 8);
+      rm_free(all);
+      *outlen = len;
+      return out;
+    }
+    case AGG_PARTIAL_HLL: {
+      if (d.bits != s.bits) {
+        return NULL;  // registers of different precisions do not fold
+      }
+      struct HLL a = {0}, b = {0};
+      hll_load(&a, d.registers, (size_t)1 << d.bits);
+      hll_load(&b, s.registers, (size_t)1 << s.bits);
+      hll_merge(&a, &b);
+      size_t len = 1 + 1 + ((size_t)1 << d.bits);
+      char *out = rm_malloc(len);
+      out[0] = d.kind;
+      out[1] = d.bits;
+      memcpy(out + 2, a.registers, (size_t)1 << d.bits);
+      hll_destroy(&a);
+      hll_destroy(&b);
+      *outlen = len;
+      return out;
+    }
+    default:
+      return NULL;
+  }
+}
+
+int AggPartial_Finalize(const char *blob, size_t len, double *out) {
+  AggPartialView v;
+  if (!partialParse(blob, len, &v)) {
+    return 0;
+  }
+  switch (v.kind) {
+    case AGG_PARTIAL_COUNT:
+      *out = (double)v.count;
+      return 1;
+    case AGG_PARTIAL_SUM:
+      *out = v.a;
+      return 1;
+    case AGG_PARTIAL_AVG:
+      *out = v.count ? v.a / v.count : 0;
+      return 1;
+    case AGG_PARTIAL_MIN:
+    case AGG_PARTIAL_MAX:
+      *out = v.count ? v.a : 0;
+      return 1;
+    case AGG_PARTIAL_STDDEV:
+      *out = v.count > 1 ? sqrt(v.b / (v.count - 1)) : 0;
+      return 1;
+    case AGG_PARTIAL_QUANTILE: {
+      TDigest *td = TDigest_New(v.b);
+      for (uint32_t i = 0; i < v.n; i++) {
+        double mean, weight;
+        memcpy(&mean, v.items + i * 16, 8);
+        memcpy(&weight, v.items + i * 16 + 8, 8);
+        TDigest_Add(td, mean, weight);
+      }
+      *out = TDigest_Quantile(td, v.a);
+      TDigest_Free(td);
+      return 1;
+    }
+    case AGG_PARTIAL_DISTINCT:
+      *out = (double)v.n;
+      return 1;
+    case AGG_PARTIAL_HLL: {
+      struct HLL h = {0};
+      hll_load(&h, v.registers, (size_t)1 << v.bits);
+      *out = (double)(uint64_t)hll_count(&h);
+      hll_destroy(&h);
+      return 1;
+    }
+    default:
+      return 0;
+  }
+}
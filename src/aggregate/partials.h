@@ -0,0 +1,53 @@
+#ifndef AGG_PARTIALS_H
+#define AGG_PARTIALS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "redisearch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Mergeable partial-aggregation blobs: with WITHPARTIALS, a shard's GROUPBY
+ * emits each reducer's intermediate state - a tagged, little-endian binary
+ * value - instead of the final number. A coordinator folds the blobs from
+ * every shard with AggPartial_Merge and extracts the exact result with
+ * AggPartial_Finalize, which makes cross-shard AVG, STDDEV, QUANTILE and
+ * distinct counts correct instead of a merge of per-shard finals.
+ *
+ * Layouts (after the leading kind byte):
+ *   COUNT     u64 count
+ *   SUM/AVG   u64 count | f64 total
+ *   MIN/MAX   u64 numMatches | f64 val
+ *   STDDEV    u64 n | f64 mean | f64 M2
+ *   QUANTILE  f64 pct | f64 compression | u32 n | n * (f64 mean | f64 weight)
+ *   DISTINCT  u32 n | n * u64 element hashes (exact set union on merge)
+ *   HLL       u8 registerIndexBits | 2^bits register bytes
+ */
+typedef enum {
+  AGG_PARTIAL_COUNT = 1,
+  AGG_PARTIAL_SUM = 2,
+  AGG_PARTIAL_AVG = 3,
+  AGG_PARTIAL_MIN = 4,
+  AGG_PARTIAL_MAX = 5,
+  AGG_PARTIAL_STDDEV = 6,
+  AGG_PARTIAL_QUANTILE = 7,
+  AGG_PARTIAL_DISTINCT = 8,
+  AGG_PARTIAL_HLL = 9,
+} AggPartialKind;
+
+/* Fold `src` into `dst` (both blobs of the same kind), returning a freshly
+ * rm_malloc'd merged blob, or NULL on malformed/mismatched inputs */
+char *AggPartial_Merge(const char *dst, size_t dstlen, const char *src, size_t srclen,
+                       size_t *outlen);
+
+/* Extract the final numeric result from a blob. Returns 0 on a malformed
+ * blob, 1 on success */
+int AggPartial_Finalize(const char *blob, size_t len, double *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
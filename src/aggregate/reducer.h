@@ -51,6 +51,15 @@ typedef struct Reducer {
   /** Numeric ID identifying this reducer */
   uint32_t reducerId;
 
+  /**
+   * All row inputs of this reducer are covered by `srckey` (or it reads no
+   * row values at all, like COUNT). The grouper may then capture spilled
+   * rows by serializing just the group and reducer source keys. Reducers
+   * reading additional keys (e.g. FIRST_VALUE's BY property) leave this 0,
+   * which disables spilling for the whole grouper.
+   */
+  int spillSafe;
+
   /**
    * Creates a new per-group instance of this reducer. This is used to create
    * actual data. The reducer structure itself, on the other hand, may be
@@ -81,6 +90,23 @@ typedef struct Reducer {
    */
   void (*Free)(struct Reducer *r);
 
+  /**
+   * Folds `srcInstance` into `dstInstance`, so that finalizing the
+   * destination yields the same result as if every row had been Add()ed to
+   * it directly. Optional - NULL means partial results of this reducer
+   * cannot be merged (see Grouper_MergePartial). `srcInstance` is left in a
+   * finalizable/freeable state.
+   */
+  int (*Merge)(struct Reducer *parent, void *dstInstance, void *srcInstance);
+
+  /**
+   * Serializes the instance's mergeable state as a tagged binary blob (see
+   * aggregate/partials.h) returned as an RSValue string, for shard-local
+   * partial aggregation. NULL means this reducer cannot emit partials and
+   * WITHPARTIALS requests using it are rejected.
+   */
+  RSValue *(*FinalizePartial)(struct Reducer *parent, void *instance);
+
 } Reducer;
 
 static inline void Reducer_GenericFree(Reducer *r) {
@@ -1,4 +1,6 @@
 #include <aggregate/reducer.h>
+#include <aggregate/partials.h>
+#include <string.h>
 #include <util/block_alloc.h>
 
 typedef struct {
@@ -18,15 +20,31 @@ static int counterAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
   return 1;
 }
 
+static int counterMerge(Reducer *r, void *dst, void *src) {
+  ((counterData *)dst)->count += ((counterData *)src)->count;
+  return 1;
+}
+
 static RSValue *counterFinalize(Reducer *r, void *instance) {
   counterData *dd = instance;
   return RS_NumVal(dd->count);
 }
 
+static RSValue *counterFinalizePartial(Reducer *parent, void *instance) {
+  char blob[1 + 8];
+  blob[0] = AGG_PARTIAL_COUNT;
+  uint64_t count = ((counterData *)instance)->count;
+  memcpy(blob + 1, &count, 8);
+  return RS_NewCopiedString(blob, sizeof(blob));
+}
+
 Reducer *RDCRCount_New(const ReducerOptions *unused) {
   Reducer *r = calloc(1, sizeof(*r));
   r->Add = counterAdd;
+  r->Merge = counterMerge;
+  r->spillSafe = 1;
   r->Finalize = counterFinalize;
+  r->FinalizePartial = counterFinalizePartial;
   r->Free = Reducer_GenericFree;
   r->NewInstance = counterNewInstance;
   return r;
@@ -1,4 +1,5 @@
 #include <aggregate/reducer.h>
+#include <aggregate/partials.h>
 #include <util/block_alloc.h>
 #include <util/khash.h>
 #include <util/fnv.h>
@@ -45,6 +46,23 @@ static int distinctAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
   return 1;
 }
 
+static int distinctMerge(Reducer *r, void *dst, void *src) {
+  distinctCounter *d = dst, *s = src;
+  for (khiter_t it = kh_begin(s->dedup); it != kh_end(s->dedup); ++it) {
+    if (!kh_exist(s->dedup, it)) {
+      continue;
+    }
+    uint64_t hval = kh_key(s->dedup, it);
+    khiter_t k = kh_get(khid, d->dedup, hval);
+    if (k == kh_end(d->dedup)) {
+      d->count++;
+      int ret;
+      kh_put(khid, d->dedup, hval, &ret);
+    }
+  }
+  return 1;
+}
+
 static RSValue *distinctFinalize(Reducer *parent, void *ctx) {
   distinctCounter *ctr = ctx;
   return RS_NumVal(ctr->count);
@@ -57,6 +75,27 @@ static void distinctFreeInstance(Reducer *r, void *p) {
   kh_destroy(khid, ctr->dedup);
 }
 
+static RSValue *distinctFinalizePartial(Reducer *parent, void *ctx) {
+  distinctCounter *ctr = ctx;
+  uint32_t n = kh_size(ctr->dedup);
+  size_t len = 1 + 4 + (size_t)n * 8;
+  char *blob = rm_malloc(len);
+  blob[0] = AGG_PARTIAL_DISTINCT;
+  memcpy(blob + 1, &n, 4);
+  size_t at = 5;
+  for (khiter_t it = kh_begin(ctr->dedup); it != kh_end(ctr->dedup); ++it) {
+    if (!kh_exist(ctr->dedup, it)) {
+      continue;
+    }
+    uint64_t h = kh_key(ctr->dedup, it);
+    memcpy(blob + at, &h, 8);
+    at += 8;
+  }
+  RSValue *v = RS_NewCopiedString(blob, len);
+  rm_free(blob);
+  return v;
+}
+
 Reducer *RDCRCountDistinct_New(const ReducerOptions *options) {
   Reducer *r = calloc(1, sizeof(*r));
   if (!ReducerOpts_GetKey(options, &r->srckey)) {
@@ -64,7 +103,10 @@ Reducer *RDCRCountDistinct_New(const ReducerOptions *options) {
     return NULL;
   }
   r->Add = distinctAdd;
+  r->Merge = distinctMerge;
+  r->spillSafe = 1;
   r->Finalize = distinctFinalize;
+  r->FinalizePartial = distinctFinalizePartial;
   r->Free = Reducer_GenericFree;
   r->FreeInstance = distinctFreeInstance;
   r->NewInstance = distinctNewInstance;
@@ -77,11 +119,20 @@ typedef struct {
   const RLookupKey *key;
 } distinctishCounter;
 
+/* COUNT_DISTINCTISH / HLL accept an optional precision argument: the number
+ * of register-index bits (4..20, default HLL_PRECISION_BITS). 14 bits = 16KB
+ * of registers per group at ~0.8% standard error, against ~6.5% for the
+ * 256-byte default */
+typedef struct {
+  Reducer base;
+  uint8_t bits;
+} HLLReducer;
+
 static void *distinctishNewInstance(Reducer *parent) {
   BlkAlloc *ba = &parent->alloc;
   distinctishCounter *ctr =
       BlkAlloc_Alloc(ba, sizeof(*ctr), 1024 * sizeof(*ctr));  // malloc(sizeof(*ctr));
-  hll_init(&ctr->hll, HLL_PRECISION_BITS);
+  hll_init(&ctr->hll, ((HLLReducer *)parent)->bits);
   ctr->key = parent->srckey;
   return ctr;
 }
@@ -94,11 +145,25 @@ static int distinctishAdd(Reducer *parent, void *instance, const RLookupRow *src
   }
 
   uint64_t hval = RSValue_Hash(val, 0x5f61767a);
-  uint32_t val32 = (uint32_t)hval ^ (uint32_t)(hval >> 32);
-  hll_add_hash(&ctr->hll, val32);
+  // Finalize the hash before folding: fnv's high bits barely change between
+  // short, similar keys, and the HLL indexes registers by the TOP bits - a
+  // plain xor-fold left nearly every input in the same few registers
+  // (measured: 4000 distinct keys estimated as 53). Murmur-style mixing
+  // restores full avalanche
+  hval ^= hval >> 33;
+  hval *= 0xff51afd7ed558ccdULL;
+  hval ^= hval >> 33;
+  hval *= 0xc4ceb9fe1a85ec53ULL;
+  hval ^= hval >> 33;
+  hll_add_hash(&ctr->hll, (uint32_t)hval);
   return 1;
 }
 
+static int distinctishMerge(Reducer *r, void *dst, void *src) {
+  distinctishCounter *d = dst, *s = src;
+  return hll_merge(&d->hll, &s->hll) == 0;
+}
+
 static RSValue *distinctishFinalize(Reducer *parent, void *instance) {
   distinctishCounter *ctr = instance;
   return RS_NumVal((uint64_t)hll_count(&ctr->hll));
@@ -129,16 +194,46 @@ static RSValue *hllFinalize(Reducer *parent, void *ctx) {
   return ret;
 }
 
+/* Shared by COUNT_DISTINCTISH and HLL: the registers are the mergeable state */
+static RSValue *hllFinalizePartial(Reducer *parent, void *instance) {
+  distinctishCounter *ctr = instance;
+  size_t regs = (size_t)1 << ctr->hll.bits;
+  size_t len = 1 + 1 + regs;
+  char *blob = rm_malloc(len);
+  blob[0] = AGG_PARTIAL_HLL;
+  blob[1] = ctr->hll.bits;
+  memcpy(blob + 2, ctr->hll.registers, regs);
+  RSValue *v = RS_NewCopiedString(blob, len);
+  rm_free(blob);
+  return v;
+}
+
 static Reducer *newHllCommon(const ReducerOptions *options, int isRaw) {
-  Reducer *r = calloc(1, sizeof(*r));
+  HLLReducer *hr = calloc(1, sizeof(*hr));
+  Reducer *r = &hr->base;
   if (!ReducerOpts_GetKey(options, &r->srckey)) {
-    free(r);
+    free(hr);
     return NULL;
   }
+  hr->bits = HLL_PRECISION_BITS;
+  if (AC_NumRemaining(options->args)) {
+    unsigned long long bits;
+    int rc = AC_GetUnsignedLongLong(options->args, &bits, 0);
+    if (rc != AC_OK || bits < 4 || bits > 20) {
+      QERR_MKBADARGS_FMT(options->status, "HLL precision for %s must be between 4 and 20",
+                         options->name);
+      free(hr);
+      return NULL;
+    }
+    hr->bits = bits;
+  }
   r->Add = distinctishAdd;
+  r->Merge = distinctishMerge;
+  r->spillSafe = 1;
   r->Free = Reducer_GenericFree;
   r->FreeInstance = distinctishFreeInstance;
   r->NewInstance = distinctishNewInstance;
+  r->FinalizePartial = hllFinalizePartial;
 
   if (isRaw) {
     r->reducerId = REDUCER_T_HLL;
@@ -232,6 +327,24 @@ static void hllsumFreeInstance(Reducer *r, void *p) {
   hll_destroy(&ctr->hll);
 }
 
+static RSValue *hllsumFinalizePartial(Reducer *parent, void *ctx) {
+  hllSumCtx *ctr = ctx;
+  if (!ctr->hll.bits) {
+    // no payloads seen: an empty sketch at the default precision merges cleanly
+    char blob[2 + (1 << HLL_PRECISION_BITS)] = {AGG_PARTIAL_HLL, HLL_PRECISION_BITS};
+    return RS_NewCopiedString(blob, sizeof(blob));
+  }
+  size_t regs = (size_t)1 << ctr->hll.bits;
+  size_t len = 1 + 1 + regs;
+  char *blob = rm_malloc(len);
+  blob[0] = AGG_PARTIAL_HLL;
+  blob[1] = ctr->hll.bits;
+  memcpy(blob + 2, ctr->hll.registers, regs);
+  RSValue *v = RS_NewCopiedString(blob, len);
+  rm_free(blob);
+  return v;
+}
+
 Reducer *RDCRHLLSum_New(const ReducerOptions *options) {
   Reducer *r = calloc(1, sizeof(*r));
   if (!ReducerOpts_GetKey(options, &r->srckey)) {
@@ -241,6 +354,7 @@ Reducer *RDCRHLLSum_New(const ReducerOptions *options) {
   r->reducerId = REDUCER_T_HLLSUM;
   r->Add = hllsumAdd;
   r->Finalize = hllsumFinalize;
+  r->FinalizePartial = hllsumFinalizePartial;
   r->NewInstance = hllsumNewInstance;
   r->FreeInstance = hllsumFreeInstance;
   r->Free = Reducer_GenericFree;
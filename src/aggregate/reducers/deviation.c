@@ -1,4 +1,6 @@
 #include <aggregate/reducer.h>
+#include <aggregate/partials.h>
+#include <string.h>
 #include <math.h>
 
 typedef struct {
@@ -60,6 +62,17 @@ static RSValue *stddevFinalize(Reducer *parent, void *instance) {
   return RS_NumVal(stddev);
 }
 
+static RSValue *stddevFinalizePartial(Reducer *parent, void *instance) {
+  devCtx *dctx = instance;
+  char blob[1 + 8 + 8 + 8];
+  blob[0] = AGG_PARTIAL_STDDEV;
+  uint64_t n = dctx->n;
+  memcpy(blob + 1, &n, 8);
+  memcpy(blob + 9, &dctx->newM, 8);
+  memcpy(blob + 17, &dctx->newS, 8);
+  return RS_NewCopiedString(blob, sizeof(blob));
+}
+
 Reducer *RDCRStdDev_New(const ReducerOptions *options) {
   Reducer *r = calloc(1, sizeof(*r));
   if (!ReducerOptions_GetKey(options, &r->srckey)) {
@@ -67,7 +80,9 @@ Reducer *RDCRStdDev_New(const ReducerOptions *options) {
     return NULL;
   }
   r->Add = stddevAdd;
+  r->spillSafe = 1;
   r->Finalize = stddevFinalize;
+  r->FinalizePartial = stddevFinalizePartial;
   r->Free = Reducer_GenericFree;
   r->NewInstance = stddevNewInstance;
   r->reducerId = REDUCER_T_STDDEV;
@@ -1,4 +1,6 @@
 #include <aggregate/reducer.h>
+#include <aggregate/partials.h>
+#include <string.h>
 #include <float.h>
 
 typedef enum { Minmax_Min = 1, Minmax_Max = 2 } MinmaxMode;
@@ -49,11 +51,34 @@ static int minmaxAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
   return 1;
 }
 
+static int minmaxMerge(Reducer *r, void *dst, void *src) {
+  minmaxCtx *d = dst, *s = src;
+  if (s->numMatches == 0) {
+    return 1;
+  }
+  if (d->numMatches == 0 || (d->mode == Minmax_Max && s->val > d->val) ||
+      (d->mode == Minmax_Min && s->val < d->val)) {
+    d->val = s->val;
+  }
+  d->numMatches += s->numMatches;
+  return 1;
+}
+
 static RSValue *minmaxFinalize(Reducer *parent, void *instance) {
   minmaxCtx *ctx = instance;
   return RS_NumVal(ctx->numMatches ? ctx->val : 0);
 }
 
+static RSValue *minmaxFinalizePartial(Reducer *parent, void *instance) {
+  minmaxCtx *ctx = instance;
+  char blob[1 + 8 + 8];
+  blob[0] = ctx->mode == Minmax_Min ? AGG_PARTIAL_MIN : AGG_PARTIAL_MAX;
+  uint64_t n = ctx->numMatches;
+  memcpy(blob + 1, &n, 8);
+  memcpy(blob + 9, &ctx->val, 8);
+  return RS_NewCopiedString(blob, sizeof(blob));
+}
+
 static Reducer *newMinMax(const ReducerOptions *options, MinmaxMode mode) {
   MinmaxReducer *r = calloc(1, sizeof(*r));
   if (!ReducerOpts_GetKey(options, &r->base.srckey)) {
@@ -62,7 +87,10 @@ static Reducer *newMinMax(const ReducerOptions *options, MinmaxMode mode) {
   }
   r->base.NewInstance = minmaxNewInstance;
   r->base.Add = minmaxAdd;
+  r->base.Merge = minmaxMerge;
+  r->base.spillSafe = 1;
   r->base.Finalize = minmaxFinalize;
+  r->base.FinalizePartial = minmaxFinalizePartial;
   r->base.Free = Reducer_GenericFree;
   r->mode = mode;
   return &r->base;
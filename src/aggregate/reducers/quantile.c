@@ -1,6 +1,14 @@
 #include <aggregate/reducer.h>
-#include "util/quantile.h"
+#include "util/tdigest.h"
+#include <aggregate/partials.h>
+#include "rmalloc.h"
+#include <string.h>
 
+/* Quantiles are estimated with a merging t-digest (util/tdigest.c): O(1)
+ * amortized insert against the GK stream's buffered merge passes, and two
+ * digests can be folded together, so QUANTILE composes with partial-group
+ * merging. The optional resolution argument doubles as the digest's
+ * compression factor */
 typedef struct {
   Reducer base;
   double pct;
@@ -9,13 +17,13 @@ typedef struct {
 
 static void *quantileNewInstance(Reducer *parent) {
   QTLReducer *qt = (QTLReducer *)parent;
-  return NewQuantileStream(&qt->pct, 1, qt->resolution);
+  return TDigest_New(qt->resolution);
 }
 
 static int quantileAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
   double d;
   QTLReducer *qt = (QTLReducer *)rbase;
-  QuantStream *qs = ctx;
+  TDigest *td = ctx;
   RSValue *v = RLookup_GetItem(rbase->srckey, row);
   if (!v) {
     return 1;
@@ -23,28 +31,59 @@ static int quantileAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
 
   if (v->t != RSValue_Array) {
     if (RSValue_ToNumber(v, &d)) {
-      QS_Insert(qs, d);
+      TDigest_Add(td, d, 1);
     }
   } else {
     uint32_t sz = RSValue_ArrayLen(v);
     for (uint32_t i = 0; i < sz; i++) {
       if (RSValue_ToNumber(RSValue_ArrayItem(v, i), &d)) {
-        QS_Insert(qs, d);
+        TDigest_Add(td, d, 1);
       }
     }
   }
   return 1;
 }
 
+static int quantileMerge(Reducer *r, void *dst, void *src) {
+  TDigest_Merge(dst, src);
+  return 1;
+}
+
 static RSValue *quantileFinalize(Reducer *r, void *ctx) {
-  QuantStream *qs = ctx;
+  TDigest *td = ctx;
   QTLReducer *qt = (QTLReducer *)r;
-  double value = QS_Query(qs, qt->pct);
+  double value = TDigest_Quantile(td, qt->pct);
   return RS_NumVal(value);
 }
 
 static void quantileFreeInstance(Reducer *unused, void *p) {
-  QS_Free(p);
+  TDigest_Free(p);
+}
+
+static RSValue *quantileFinalizePartial(Reducer *rbase, void *ctx) {
+  TDigest *td = ctx;
+  QTLReducer *qt = (QTLReducer *)rbase;
+  size_t cap = TDigest_NumCentroids(td);
+  double *means = rm_malloc((cap ? cap : 1) * sizeof(double));
+  double *weights = rm_malloc((cap ? cap : 1) * sizeof(double));
+  size_t n = TDigest_GetCentroids(td, means, weights, cap);
+  double compression = TDigest_Compression(td);
+  size_t len = 1 + 8 + 8 + 4 + n * 16;
+  char *blob = rm_malloc(len);
+  blob[0] = AGG_PARTIAL_QUANTILE;
+  memcpy(blob + 1, &qt->pct, 8);
+  memcpy(blob + 9, &compression, 8);
+  uint32_t n32 = n;
+  memcpy(blob + 17, &n32, 4);
+  for (size_t i = 0; i < n; i++) {
+    memcpy(blob + 21 + i * 16, &means[i], 8);
+    memcpy(blob + 21 + i * 16 + 8, &weights[i], 8);
+  }
+  RSValue *v = RS_NewCopiedString(blob, len);
+  rm_free(means);
+  rm_free(weights);
+  rm_free(blob);
+  return v;
 }
 
 Reducer *RDCRQuantile_New(const ReducerOptions *options) {
@@ -81,9 +120,12 @@ Reducer *RDCRQuantile_New(const ReducerOptions *options) {
 
   r->base.NewInstance = quantileNewInstance;
   r->base.Add = quantileAdd;
+  r->base.Merge = quantileMerge;
+  r->base.spillSafe = 1;
   r->base.Free = Reducer_GenericFree;
   r->base.FreeInstance = quantileFreeInstance;
   r->base.Finalize = quantileFinalize;
+  r->base.FinalizePartial = quantileFinalizePartial;
   return &r->base;
 
 error:
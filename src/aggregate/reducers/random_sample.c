@@ -80,6 +80,7 @@ Reducer *RDCRRandomSample_New(const ReducerOptions *options) {
   ret->len = samplesize;
   Reducer *rbase = &ret->base;
   rbase->Add = sampleAdd;
+  rbase->spillSafe = 1;
   rbase->Finalize = sampleFinalize;
   rbase->Free = Reducer_GenericFree;
   rbase->FreeInstance = sampleFreeInstance;
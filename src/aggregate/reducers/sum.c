@@ -1,4 +1,5 @@
 #include <aggregate/reducer.h>
+#include <aggregate/partials.h>
 
 typedef struct {
   size_t count;
@@ -8,7 +9,6 @@ typedef struct {
 typedef struct {
   Reducer base;
   int isAvg;
-  const RLookupKey *srckey;
 } SumReducer;
 
 #define BLOCK_SIZE 32 * sizeof(sumCtx)
@@ -24,7 +24,7 @@ static int sumAdd(Reducer *baseparent, void *instance, const RLookupRow *row) {
   sumCtx *ctr = instance;
   const SumReducer *parent = (const SumReducer *)baseparent;
   ctr->count++;
-  const RSValue *v = RLookup_GetItem(parent->srckey, row);
+  const RSValue *v = RLookup_GetItem(parent->base.srckey, row);
   if (v && v->t == RSValue_Number) {
     ctr->total += v->numval;
   } else {  // try to convert value to number
@@ -36,6 +36,13 @@ static int sumAdd(Reducer *baseparent, void *instance, const RLookupRow *row) {
   return 1;
 }
 
+static int sumMerge(Reducer *baseparent, void *dst, void *src) {
+  sumCtx *d = dst, *s = src;
+  d->count += s->count;
+  d->total += s->total;
+  return 1;
+}
+
 static RSValue *sumFinalize(Reducer *baseparent, void *instance) {
   sumCtx *ctr = instance;
   SumReducer *parent = (SumReducer *)baseparent;
@@ -50,15 +57,29 @@ static RSValue *sumFinalize(Reducer *baseparent, void *instance) {
   return RS_NumVal(v);
 }
 
+static RSValue *sumFinalizePartial(Reducer *baseparent, void *instance) {
+  sumCtx *ctr = instance;
+  const SumReducer *parent = (const SumReducer *)baseparent;
+  char blob[1 + 8 + 8];
+  blob[0] = parent->isAvg ? AGG_PARTIAL_AVG : AGG_PARTIAL_SUM;
+  uint64_t count = ctr->count;
+  memcpy(blob + 1, &count, 8);
+  memcpy(blob + 9, &ctr->total, 8);
+  return RS_NewCopiedString(blob, sizeof(blob));
+}
+
 static Reducer *newReducerCommon(const ReducerOptions *options, int isAvg) {
   SumReducer *r = calloc(1, sizeof(*r));
-  if (!ReducerOpts_GetKey(options, &r->srckey)) {
+  if (!ReducerOpts_GetKey(options, &r->base.srckey)) {
     free(r);
     return NULL;
   }
   r->base.NewInstance = sumNewInstance;
   r->base.Add = sumAdd;
+  r->base.Merge = sumMerge;
+  r->base.spillSafe = 1;
   r->base.Finalize = sumFinalize;
+  r->base.FinalizePartial = sumFinalizePartial;
   r->base.Free = Reducer_GenericFree;
   r->isAvg = isAvg;
   return &r->base;
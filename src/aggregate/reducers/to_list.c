@@ -77,6 +77,7 @@ Reducer *RDCRToList_New(const ReducerOptions *opts) {
     return NULL;
   }
   r->Add = tolistAdd;
+  r->spillSafe = 1;
   r->Finalize = tolistFinalize;
   r->Free = Reducer_GenericFree;
   r->FreeInstance = tolistFreeInstance;
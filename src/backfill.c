@@ -0,0 +1,142 @@
+#include "backfill.h"
+#include "search_ctx.h"
+#include "document.h"
+#include "doc_table.h"
+#include "config.h"
+#include "rmalloc.h"
+#include "dep/thpool/thpool.h"
+#include <string.h>
+#include <unistd.h>
+
+// Documents reindexed per GIL slice; the rate budget spaces the slices out
+#define BACKFILL_BATCH_DOCS 64
+
+static threadpool backfillPool_g;
+
+typedef struct {
+  char *indexName;
+} BackfillJob;
+
+static void backfillDone(RSAddDocumentCtx *aCtx, RedisModuleCtx *ctx, void *unused) {
+}
+
+/* Re-add one document through the replace pipeline, loading only the schema's
+ * fields from its hash (HashGet per field - no HGETALL round trip, and fields
+ * outside the schema are not dragged along) */
+static int backfillReindexOne(RedisModuleCtx *ctx, RedisSearchCtx *sctx,
+                              const RSDocumentMetadata *dmd) {
+  IndexSpec *sp = sctx->spec;
+  size_t keyLen;
+  const char *keyStr = DMD_KeyPtrLen(dmd, &keyLen);
+  RedisModuleString *keyName = RedisModule_CreateString(ctx, keyStr, keyLen);
+
+  RedisModuleKey *kobj = RedisModule_OpenKey(ctx, keyName, REDISMODULE_READ);
+  if (!kobj) {
+    RedisModule_FreeString(ctx, keyName);
+    return 0;  // hash gone; the index entry will be collected elsewhere
+  }
+
+  RedisModuleString **argv = rm_malloc(sp->numFields * 2 * sizeof(*argv));
+  size_t nelem = 0;
+  for (uint16_t i = 0; i < sp->numFields; i++) {
+    RedisModuleString *val = NULL;
+    if (RedisModule_HashGet(kobj, REDISMODULE_HASH_CFIELDS, sp->fields[i].name, &val, NULL) !=
+            REDISMODULE_OK ||
+        !val) {
+      continue;
+    }
+    argv[nelem++] = RedisModule_CreateString(ctx, sp->fields[i].name, strlen(sp->fields[i].name));
+    argv[nelem++] = val;
+  }
+  RedisModule_CloseKey(kobj);
+
+  int rc = 0;
+  if (nelem) {
+    AddDocumentOptions opts = {0};
+    opts.options = DOCUMENT_ADD_REPLACE | DOCUMENT_ADD_CURTHREAD;
+    opts.numFieldElems = nelem;
+    opts.fieldsArray = argv;
+    opts.donecb = backfillDone;
+    QueryError status = {0};
+    rc = RS_AddDocument(sctx, keyName, &opts, &status) == REDISMODULE_OK;
+    QueryError_ClearError(&status);
+  }
+  for (size_t i = 0; i < nelem; i++) {
+    RedisModule_FreeString(ctx, argv[i]);
+  }
+  rm_free(argv);
+  RedisModule_FreeString(ctx, keyName);
+  return rc;
+}
+
+static void backfillRun(void *arg) {
+  BackfillJob *job = arg;
+  RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+  t_docId cursor = 1;
+  t_docId ceiling = 0;
+  uint64_t specId = 0;
+  int first = 1;
+
+  for (;;) {
+    RedisModule_ThreadSafeContextLock(ctx);
+    RedisSearchCtx *sctx = NewSearchCtxC(ctx, job->indexName, false);
+    if (!sctx) {
+      RedisModule_ThreadSafeContextUnlock(ctx);
+      break;  // index dropped: abandon
+    }
+    IndexSpec *sp = sctx->spec;
+    if (first) {
+      specId = sp->uniqueId;
+      ceiling = sp->docs.maxDocId;  // docs added after this already carry the new field
+      sp->backfillTotal = ceiling;
+      sp->backfillScanned = 0;
+      sp->backfillReindexed = 0;
+      sp->backfillActive = 1;
+      first = 0;
+    } else if (sp->uniqueId != specId) {
+      SearchCtx_Free(sctx);
+      RedisModule_ThreadSafeContextUnlock(ctx);
+      break;  // a same-name recreate: that index never had our schema change
+    }
+
+    t_docId end = cursor + BACKFILL_BATCH_DOCS;
+    if (end > ceiling + 1) {
+      end = ceiling + 1;
+    }
+    for (; cursor < end; cursor++) {
+      const RSDocumentMetadata *dmd = DocTable_Get(&sp->docs, cursor);
+      if (dmd && !(DMD_Flags(dmd) & Document_Deleted)) {
+        sp->backfillReindexed += backfillReindexOne(ctx, sctx, dmd);
+      }
+      sp->backfillScanned++;
+    }
+    int done = cursor > ceiling;
+    if (done) {
+      sp->backfillActive = 0;
+    }
+    SearchCtx_Free(sctx);
+    RedisModule_ThreadSafeContextUnlock(ctx);
+    if (done) {
+      break;
+    }
+
+    // the budget: BACKFILL_DOCS_PER_SEC spaces out the slices
+    long long rate = RSGlobalConfig.backfillDocsPerSec;
+    if (rate > 0) {
+      usleep((useconds_t)((uint64_t)BACKFILL_BATCH_DOCS * 1000000 / rate));
+    }
+  }
+
+  RedisModule_FreeThreadSafeContext(ctx);
+  rm_free(job->indexName);
+  rm_free(job);
+}
+
+void Backfill_Start(const IndexSpec *sp) {
+  if (!backfillPool_g) {
+    backfillPool_g = thpool_init(1);
+  }
+  BackfillJob *job = rm_calloc(1, sizeof(*job));
+  job->indexName = rm_strdup(sp->name);
+  thpool_add_work(backfillPool_g, backfillRun, job);
+}
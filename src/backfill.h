@@ -0,0 +1,32 @@
+#ifndef BACKFILL_H
+#define BACKFILL_H
+
+#include "spec.h"
+#include "redismodule.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Throttled online reindexing after a schema change: a background task walks
+ * the document table in id order, reloads each document's schema fields from
+ * its hash and re-adds it through the normal replace pipeline, so the new
+ * field's postings appear without a client-driven reindex. The task resolves
+ * the index by name in short GIL slices (nothing held across them) and paces
+ * itself with the BACKFILL_DOCS_PER_SEC budget, so query latency stays flat
+ * for the duration. Re-added documents get fresh ids above the captured scan
+ * ceiling and are never revisited; documents added after the ALTER already
+ * carry the new field.
+ *
+ * Triggered by FT.ALTER ... SCHEMA ADD ... BACKFILL; progress is visible via
+ * FT.DEBUG BACKFILL_STATUS.
+ */
+
+/* Queue a backfill scan of the spec (by name; safe against drops) */
+void Backfill_Start(const IndexSpec *sp);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
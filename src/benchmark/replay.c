@@ -0,0 +1,384 @@
+/* Query replay load generator.
+ *
+ * Reads a JSONL query log - one object per line, e.g.
+ *
+ *   {"template": "title-search", "cmd": ["FT.SEARCH", "idx", "hello world"]}
+ *
+ * and replays the commands against a live module at a configurable
+ * concurrency and target QPS, reporting a latency histogram (p50/p99/p999)
+ * per query template. Lines without a "template" are grouped under their
+ * first two command words.
+ *
+ *   make replay
+ *   ./replay -f queries.jsonl [-h host] [-p port] [-c threads] [-q qps] [-n loops]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <hiredis/hiredis.h>
+
+#define MAX_CMD_ARGS 32
+#define MAX_TEMPLATES 256
+#define HIST_BUCKETS 64
+
+typedef struct Histogram Histogram;
+
+typedef struct {
+  char *template;
+  Histogram *hist;  // resolved once at load time; threads only record into it
+  char *argv[MAX_CMD_ARGS];
+  size_t argvlen[MAX_CMD_ARGS];
+  int argc;
+} ReplayCmd;
+
+/* log-bucketed latency histogram: bucket i covers [1<<(i/2) .. ) microseconds
+ * interleaved with its midpoint, giving ~41% resolution steps */
+struct Histogram {
+  const char *name;
+  uint64_t buckets[HIST_BUCKETS];
+  uint64_t count;
+  uint64_t errors;
+  uint64_t sumUs;
+};
+
+static Histogram templates_g[MAX_TEMPLATES];
+static int numTemplates_g = 0;
+static pthread_mutex_t histLock_g = PTHREAD_MUTEX_INITIALIZER;
+
+static int bucketFor(uint64_t us) {
+  int b = 0;
+  uint64_t lo = 1, mid = 1;
+  while (b + 2 < HIST_BUCKETS && us >= lo * 2) {
+    lo *= 2;
+    b += 2;
+  }
+  mid = lo + lo / 2;
+  if (us >= mid && b + 1 < HIST_BUCKETS) {
+    b += 1;
+  }
+  return b;
+}
+
+static uint64_t bucketLowerUs(int b) {
+  uint64_t lo = 1ull << (b / 2);
+  return (b & 1) ? lo + lo / 2 : lo;
+}
+
+static void Histogram_Add(Histogram *h, uint64_t us, int isError) {
+  pthread_mutex_lock(&histLock_g);
+  h->buckets[bucketFor(us)]++;
+  h->count++;
+  h->sumUs += us;
+  h->errors += !!isError;
+  pthread_mutex_unlock(&histLock_g);
+}
+
+static uint64_t Histogram_Percentile(const Histogram *h, double pct) {
+  uint64_t target = (uint64_t)(h->count * pct / 100.0);
+  uint64_t seen = 0;
+  for (int i = 0; i < HIST_BUCKETS; i++) {
+    seen += h->buckets[i];
+    if (seen > target) {
+      return bucketLowerUs(i);
+    }
+  }
+  return bucketLowerUs(HIST_BUCKETS - 1);
+}
+
+/* resolve/register a histogram by template name. Called only from the
+ * single-threaded loading phase; during replay the threads go through the
+ * pointer cached on each command */
+static Histogram *templateHistogram(const char *name) {
+  for (int i = 0; i < numTemplates_g; i++) {
+    if (!strcmp(templates_g[i].name, name)) {
+      return &templates_g[i];
+    }
+  }
+  if (numTemplates_g == MAX_TEMPLATES) {
+    return &templates_g[0];
+  }
+  templates_g[numTemplates_g].name = strdup(name);
+  return &templates_g[numTemplates_g++];
+}
+
+/* ----------------------------------------------------------------------------
+ * Minimal JSONL field extraction. We only need a top-level string field and a
+ * top-level array of strings; escapes inside strings are unescaped for the
+ * common cases (\" \\ \/ \n \t \r).
+ */
+
+static const char *skipWs(const char *p) {
+  while (*p == ' ' || *p == '\t') p++;
+  return p;
+}
+
+/* parse the JSON string starting at the opening quote; returns a malloc'd
+ * unescaped copy and advances *pp past the closing quote, or NULL */
+static char *parseJsonString(const char **pp) {
+  const char *p = *pp;
+  if (*p != '"') return NULL;
+  p++;
+  size_t cap = 32, len = 0;
+  char *out = malloc(cap);
+  while (*p && *p != '"') {
+    char c = *p++;
+    if (c == '\\' && *p) {
+      char e = *p++;
+      switch (e) {
+        case 'n': c = '\n'; break;
+        case 't': c = '\t'; break;
+        case 'r': c = '\r'; break;
+        default: c = e; break;  // covers \" \\ \/ and passes others through
+      }
+    }
+    if (len + 1 >= cap) {
+      cap *= 2;
+      out = realloc(out, cap);
+    }
+    out[len++] = c;
+  }
+  if (*p != '"') {
+    free(out);
+    return NULL;
+  }
+  out[len] = '\0';
+  *pp = p + 1;
+  return out;
+}
+
+/* find `"key":` at the top level of the line and return a pointer just past
+ * the colon, or NULL. Good enough for machine-written logs: the key is only
+ * searched for outside of string values */
+static const char *findKey(const char *line, const char *key) {
+  size_t klen = strlen(key);
+  int inStr = 0;
+  for (const char *p = line; *p; p++) {
+    if (inStr) {
+      if (*p == '\\' && p[1]) p++;
+      else if (*p == '"') inStr = 0;
+      continue;
+    }
+    if (*p == '"') {
+      if (!strncmp(p + 1, key, klen) && p[1 + klen] == '"') {
+        const char *q = skipWs(p + 2 + klen);
+        if (*q == ':') {
+          return skipWs(q + 1);
+        }
+      }
+      inStr = 1;
+    }
+  }
+  return NULL;
+}
+
+/* parse one log line into cmd; returns 0 on unusable lines */
+static int parseLine(const char *line, ReplayCmd *cmd) {
+  memset(cmd, 0, sizeof(*cmd));
+  const char *arr = findKey(line, "cmd");
+  if (!arr || *arr != '[') {
+    return 0;
+  }
+  const char *p = skipWs(arr + 1);
+  while (*p && *p != ']' && cmd->argc < MAX_CMD_ARGS) {
+    char *s = parseJsonString(&p);
+    if (!s) {
+      goto fail;
+    }
+    cmd->argvlen[cmd->argc] = strlen(s);
+    cmd->argv[cmd->argc++] = s;
+    p = skipWs(p);
+    if (*p == ',') p = skipWs(p + 1);
+  }
+  if (cmd->argc == 0) {
+    goto fail;
+  }
+
+  const char *t = findKey(line, "template");
+  if (t && *t == '"') {
+    cmd->template = parseJsonString(&t);
+  }
+  if (!cmd->template) {
+    // default grouping: command name + first argument
+    size_t n = strlen(cmd->argv[0]) + (cmd->argc > 1 ? strlen(cmd->argv[1]) + 1 : 0);
+    cmd->template = malloc(n + 1);
+    strcpy(cmd->template, cmd->argv[0]);
+    if (cmd->argc > 1) {
+      strcat(cmd->template, " ");
+      strcat(cmd->template, cmd->argv[1]);
+    }
+  }
+  return 1;
+
+fail:
+  for (int i = 0; i < cmd->argc; i++) {
+    free(cmd->argv[i]);
+  }
+  return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static ReplayCmd *cmds_g;
+static size_t numCmds_g = 0;
+static size_t loops_g = 1;
+static int qps_g = 0;  // 0 = unthrottled
+static int concurrency_g = 4;
+static const char *host_g = "127.0.0.1";
+static int port_g = 6379;
+
+static uint64_t nowUs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+static size_t nextIdx_g = 0;
+static pthread_mutex_t idxLock_g = PTHREAD_MUTEX_INITIALIZER;
+
+static long takeNext(void) {
+  pthread_mutex_lock(&idxLock_g);
+  long ret = -1;
+  if (nextIdx_g < numCmds_g * loops_g) {
+    ret = nextIdx_g++ % numCmds_g;
+  }
+  pthread_mutex_unlock(&idxLock_g);
+  return ret;
+}
+
+static void *replayThread(void *arg) {
+  (void)arg;
+  redisContext *c = redisConnect(host_g, port_g);
+  if (!c || c->err) {
+    fprintf(stderr, "cannot connect to %s:%d: %s\n", host_g, port_g, c ? c->errstr : "alloc");
+    return NULL;
+  }
+
+  // per-thread pacing interval for the global QPS target
+  uint64_t intervalUs = qps_g > 0 ? (1000000ull * concurrency_g) / qps_g : 0;
+  uint64_t nextFire = nowUs();
+
+  long i;
+  while ((i = takeNext()) >= 0) {
+    if (intervalUs) {
+      uint64_t now = nowUs();
+      if (now < nextFire) {
+        usleep(nextFire - now);
+      }
+      nextFire += intervalUs;
+    }
+    ReplayCmd *cmd = &cmds_g[i];
+    uint64_t t0 = nowUs();
+    redisReply *reply =
+        redisCommandArgv(c, cmd->argc, (const char **)cmd->argv, cmd->argvlen);
+    uint64_t dt = nowUs() - t0;
+    int isErr = !reply || reply->type == REDIS_REPLY_ERROR;
+    Histogram_Add(cmd->hist, dt, isErr);
+    if (reply) {
+      freeReplyObject(reply);
+    } else {
+      // connection-level failure; reconnect and continue
+      redisFree(c);
+      c = redisConnect(host_g, port_g);
+      if (!c || c->err) {
+        break;
+      }
+    }
+  }
+  if (c) {
+    redisFree(c);
+  }
+  return NULL;
+}
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s -f <queries.jsonl> [-h host] [-p port] [-c concurrency] "
+          "[-q qps] [-n loops]\n",
+          prog);
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  const char *file = NULL;
+  int opt;
+  while ((opt = getopt(argc, argv, "f:h:p:c:q:n:")) != -1) {
+    switch (opt) {
+      case 'f': file = optarg; break;
+      case 'h': host_g = optarg; break;
+      case 'p': port_g = atoi(optarg); break;
+      case 'c': concurrency_g = atoi(optarg); break;
+      case 'q': qps_g = atoi(optarg); break;
+      case 'n': loops_g = strtoul(optarg, NULL, 10); break;
+      default: usage(argv[0]);
+    }
+  }
+  if (!file || concurrency_g < 1 || loops_g < 1) {
+    usage(argv[0]);
+  }
+
+  FILE *fp = fopen(file, "r");
+  if (!fp) {
+    perror(file);
+    return 1;
+  }
+  size_t cap = 1024;
+  cmds_g = malloc(cap * sizeof(*cmds_g));
+  char *line = NULL;
+  size_t lineCap = 0;
+  ssize_t ll;
+  size_t skipped = 0;
+  while ((ll = getline(&line, &lineCap, fp)) != -1) {
+    if (ll < 2) continue;
+    if (numCmds_g == cap) {
+      cap *= 2;
+      cmds_g = realloc(cmds_g, cap * sizeof(*cmds_g));
+    }
+    if (parseLine(line, &cmds_g[numCmds_g])) {
+      cmds_g[numCmds_g].hist = templateHistogram(cmds_g[numCmds_g].template);
+      numCmds_g++;
+    } else {
+      skipped++;
+    }
+  }
+  free(line);
+  fclose(fp);
+  if (!numCmds_g) {
+    fprintf(stderr, "no replayable commands in %s (%zu lines skipped)\n", file, skipped);
+    return 1;
+  }
+  fprintf(stderr, "loaded %zu commands (%zu skipped), %d threads, %s qps\n", numCmds_g, skipped,
+          concurrency_g, qps_g ? "throttled" : "max");
+
+  uint64_t start = nowUs();
+  pthread_t *threads = malloc(concurrency_g * sizeof(*threads));
+  for (int i = 0; i < concurrency_g; i++) {
+    pthread_create(&threads[i], NULL, replayThread, NULL);
+  }
+  for (int i = 0; i < concurrency_g; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  uint64_t elapsed = nowUs() - start;
+
+  uint64_t total = 0;
+  printf("%-32s %10s %8s %8s %8s %8s %8s\n", "template", "count", "errors", "avg_us", "p50_us",
+         "p99_us", "p999_us");
+  for (int i = 0; i < numTemplates_g; i++) {
+    Histogram *h = &templates_g[i];
+    if (!h->count) continue;
+    total += h->count;
+    printf("%-32s %10llu %8llu %8llu %8llu %8llu %8llu\n", h->name,
+           (unsigned long long)h->count, (unsigned long long)h->errors,
+           (unsigned long long)(h->sumUs / h->count),
+           (unsigned long long)Histogram_Percentile(h, 50),
+           (unsigned long long)Histogram_Percentile(h, 99),
+           (unsigned long long)Histogram_Percentile(h, 99.9));
+  }
+  printf("total: %llu requests in %.2fs (%.0f qps)\n", (unsigned long long)total,
+         elapsed / 1e6, total / (elapsed / 1e6));
+  return 0;
+}
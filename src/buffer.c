@@ -4,8 +4,15 @@
 #include <sys/param.h>
 
 void Buffer_Grow(Buffer *buf, size_t extraLen) {
+  // Double while small - young posting blocks otherwise realloc every few
+  // entries - then grow gently (20%, capped at 1MB) once the buffer is big
+  // enough that slack matters more than realloc count
   do {
-    buf->cap += MIN(1 + buf->cap / 5, 1024 * 1024);
+    if (buf->cap < 4096) {
+      buf->cap += MAX(buf->cap, 16);
+    } else {
+      buf->cap += MIN(buf->cap / 5, 1024 * 1024);
+    }
   } while (buf->offset + extraLen > buf->cap);
 
   buf->data = rm_realloc(buf->data, buf->cap);
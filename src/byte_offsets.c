@@ -1,4 +1,5 @@
 #include "byte_offsets.h"
+#include "spec.h"
 #include <arpa/inet.h>
 
 RSByteOffsets *NewByteOffsets() {
@@ -9,6 +10,7 @@ RSByteOffsets *NewByteOffsets() {
 void RSByteOffsets_Free(RSByteOffsets *offsets) {
   rm_free(offsets->offsets.data);
   rm_free(offsets->fields);
+  rm_free(offsets->rawData);
   rm_free(offsets);
 }
 
@@ -24,28 +26,67 @@ RSByteOffsetField *RSByteOffsets_AddField(RSByteOffsets *offsets, uint32_t field
   return field;
 }
 
+static inline uint32_t zigzagEncode(int32_t d) {
+  return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+}
+
+static inline int32_t zigzagDecode(uint32_t v) {
+  return (int32_t)((v >> 1) ^ -(v & 1));
+}
+
+/* Re-encode a stream of plain first-order deltas (as VVW_Write produces) into
+ * zigzagged deltas-of-deltas. Prose token gaps are near constant, so the
+ * second-order stream stays in one-byte varints even when the gaps themselves
+ * grow past the one-byte range */
+static void packOffsetDeltas(const char *data, size_t len, RSOffsetVector *out) {
+  Buffer src = {.data = (char *)data, .offset = len, .cap = len};
+  BufferReader r = NewBufferReader(&src);
+  Buffer dst;
+  Buffer_Init(&dst, len ? len : 1);
+  uint32_t lastDelta = 0;
+  while (!BufferReader_AtEnd(&r)) {
+    uint32_t delta = ReadVarint(&r);
+    Buffer_Reserve(&dst, 8);
+    WriteVarintBuffer(zigzagEncode((int32_t)(delta - lastDelta)), &dst);
+    lastDelta = delta;
+  }
+  Buffer_ShrinkToSize(&dst);
+  out->data = dst.data;
+  out->len = dst.offset;
+}
+
 void ByteOffsetWriter_Move(ByteOffsetWriter *w, RSByteOffsets *offsets) {
-  offsets->offsets.data = w->buf.data;
-  offsets->offsets.len = w->buf.offset;
+  packOffsetDeltas(w->buf.data, w->buf.offset, &offsets->offsets);
+  Buffer_Free(&w->buf);
   memset(&w->buf, 0, sizeof w->buf);
 }
 
 void RSByteOffsets_Serialize(const RSByteOffsets *offsets, Buffer *b) {
   BufferWriter w = NewBufferWriter(b);
 
-  Buffer_WriteU8(&w, offsets->numFields);
+  if (offsets->rawData) {
+    // Never touched since it was loaded - the record is still in serialized
+    // form, so it round-trips verbatim
+    Buffer_Write(&w, offsets->rawData, offsets->rawLen);
+    return;
+  }
+
+  WriteVarint(offsets->numFields, &w);
 
   for (size_t ii = 0; ii < offsets->numFields; ++ii) {
     Buffer_WriteU8(&w, offsets->fields[ii].fieldId);
-    Buffer_WriteU32(&w, offsets->fields[ii].firstTokPos);
-    Buffer_WriteU32(&w, offsets->fields[ii].lastTokPos);
+    WriteVarint(offsets->fields[ii].firstTokPos, &w);
+    WriteVarint(offsets->fields[ii].lastTokPos - offsets->fields[ii].firstTokPos, &w);
   }
 
-  Buffer_WriteU32(&w, offsets->offsets.len);
+  WriteVarint(offsets->offsets.len, &w);
   Buffer_Write(&w, offsets->offsets.data, offsets->offsets.len);
 }
 
-RSByteOffsets *LoadByteOffsets(Buffer *buf) {
+/* Decode the pre-packing record layout: fixed-width field table followed by a
+ * plain-delta offsets payload, which is repacked so iteration sees a single
+ * encoding */
+static RSByteOffsets *loadByteOffsetsLegacy(Buffer *buf) {
   BufferReader r = NewBufferReader(buf);
 
   RSByteOffsets *offsets = NewByteOffsets();
@@ -61,49 +102,89 @@ RSByteOffsets *LoadByteOffsets(Buffer *buf) {
   }
 
   uint32_t offsetsLen = Buffer_ReadU32(&r);
-  offsets->offsets.len = offsetsLen;
   if (offsetsLen) {
-    offsets->offsets.data = rm_malloc(offsetsLen);
-    Buffer_Read(&r, offsets->offsets.data, offsetsLen);
-  } else {
-    offsets->offsets.data = NULL;
+    packOffsetDeltas(buf->data + r.pos, offsetsLen, &offsets->offsets);
+  }
+
+  return offsets;
+}
+
+RSByteOffsets *LoadByteOffsets(Buffer *buf, int encver) {
+  if (encver < INDEX_MIN_PACKED_BYTEOFFSETS_VERSION) {
+    return loadByteOffsetsLegacy(buf);
   }
 
+  // Keep the serialized record as-is; the iterator parses it in place if a
+  // highlighter ever gets to this document. Note the wrapped buffer carries
+  // its length in cap, not offset
+  RSByteOffsets *offsets = NewByteOffsets();
+  offsets->rawLen = buf->cap;
+  offsets->rawData = rm_malloc(buf->cap);
+  memcpy(offsets->rawData, buf->data, buf->cap);
   return offsets;
 }
 
 int RSByteOffset_Iterate(const RSByteOffsets *offsets, uint32_t fieldId,
                          RSByteOffsetIterator *iter) {
-  const RSByteOffsetField *offField = NULL;
-  for (size_t ii = 0; ii < offsets->numFields; ++ii) {
-    if (offsets->fields[ii].fieldId == fieldId) {
-      offField = offsets->fields + ii;
-      break;
+  uint32_t firstTokPos = 0, lastTokPos = 0;
+  const char *payload = NULL;
+  uint32_t payloadLen = 0;
+
+  if (offsets->rawData) {
+    // Parse the serialized header in place. Nothing is materialized on the
+    // shared metadata, so concurrent readers need no synchronization
+    Buffer raw = {.data = offsets->rawData, .offset = offsets->rawLen, .cap = offsets->rawLen};
+    BufferReader r = NewBufferReader(&raw);
+    uint32_t numFields = ReadVarint(&r);
+    int found = 0;
+    for (uint32_t ii = 0; ii < numFields; ++ii) {
+      uint8_t fid = Buffer_ReadU8(&r);
+      uint32_t firstTok = ReadVarint(&r);
+      uint32_t tokSpan = ReadVarint(&r);
+      if (fid == fieldId) {
+        found = 1;
+        firstTokPos = firstTok;
+        lastTokPos = firstTok + tokSpan;
+      }
     }
-  }
-  if (!offField) {
-    return REDISMODULE_ERR;
+    if (!found) {
+      return REDISMODULE_ERR;
+    }
+    payloadLen = ReadVarint(&r);
+    payload = raw.data + r.pos;
+  } else {
+    const RSByteOffsetField *offField = NULL;
+    for (size_t ii = 0; ii < offsets->numFields; ++ii) {
+      if (offsets->fields[ii].fieldId == fieldId) {
+        offField = offsets->fields + ii;
+        break;
+      }
+    }
+    if (!offField) {
+      return REDISMODULE_ERR;
+    }
+    firstTokPos = offField->firstTokPos;
+    lastTokPos = offField->lastTokPos;
+    payload = offsets->offsets.data;
+    payloadLen = offsets->offsets.len;
   }
 
-  // printf("Generating iterator for fieldId=%lu. BeginPos=%lu. EndPos=%lu\n", fieldId,
-  //        offField->firstTokPos, offField->lastTokPos);
-
   iter->buf.cap = 0;
-  iter->buf.data = offsets->offsets.data;
-  iter->buf.offset = offsets->offsets.len;
+  iter->buf.data = (char *)payload;
+  iter->buf.offset = payloadLen;
   iter->rdr = NewBufferReader(&iter->buf);
   iter->curPos = 1;
-  iter->endPos = offField->lastTokPos;
+  iter->endPos = lastTokPos;
 
   iter->lastValue = 0;
+  iter->lastDelta = 0;
 
-  while (iter->curPos < offField->firstTokPos && !BufferReader_AtEnd(&iter->rdr)) {
-    // printf("Seeking & incrementing\n");
-    iter->lastValue = ReadVarint(&iter->rdr) + iter->lastValue;
+  while (iter->curPos < firstTokPos && !BufferReader_AtEnd(&iter->rdr)) {
+    iter->lastDelta += (uint32_t)zigzagDecode(ReadVarint(&iter->rdr));
+    iter->lastValue += iter->lastDelta;
     iter->curPos++;
   }
 
-  // printf("Iterator is now at %lu\n", iter->curPos);
   iter->curPos--;
   return REDISMODULE_OK;
 }
@@ -113,6 +194,24 @@ uint32_t RSByteOffsetIterator_Next(RSByteOffsetIterator *iter) {
     return RSBYTEOFFSET_EOF;
   }
 
-  iter->lastValue = ReadVarint(&iter->rdr) + iter->lastValue;
+  iter->lastDelta += (uint32_t)zigzagDecode(ReadVarint(&iter->rdr));
+  iter->lastValue += iter->lastDelta;
+  return iter->lastValue;
+}
+
+uint32_t RSByteOffsetIterator_SkipTo(RSByteOffsetIterator *iter, uint32_t tokPos) {
+  if (tokPos > iter->endPos) {
+    iter->curPos = iter->endPos + 1;
+    return RSBYTEOFFSET_EOF;
+  }
+  while (iter->curPos < tokPos) {
+    if (BufferReader_AtEnd(&iter->rdr) || iter->curPos >= iter->endPos) {
+      iter->curPos = iter->endPos + 1;
+      return RSBYTEOFFSET_EOF;
+    }
+    iter->lastDelta += (uint32_t)zigzagDecode(ReadVarint(&iter->rdr));
+    iter->lastValue += iter->lastDelta;
+    iter->curPos++;
+  }
   return iter->lastValue;
-}
\ No newline at end of file
+}
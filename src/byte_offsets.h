@@ -5,6 +5,10 @@
 #include "varint.h"
 #include "rmalloc.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct __attribute__((packed)) RSByteOffsetMap {
   // ID this belongs to.
   uint16_t fieldId;
@@ -23,6 +27,11 @@ typedef struct RSByteOffsets {
   RSByteOffsetField *fields;
   // How many fields
   uint8_t numFields;
+  // Serialized record as loaded from an RDB. Most loaded documents are never
+  // highlighted, so the record is kept verbatim and parsed in place by the
+  // iterator only when a highlighter actually touches the document.
+  char *rawData;
+  uint32_t rawLen;
 } RSByteOffsets;
 
 RSByteOffsets *NewByteOffsets();
@@ -41,7 +50,7 @@ RSByteOffsetField *RSByteOffsets_AddField(RSByteOffsets *offsets, uint32_t field
                                           uint32_t startPos);
 
 void RSByteOffsets_Serialize(const RSByteOffsets *offsets, Buffer *b);
-RSByteOffsets *LoadByteOffsets(Buffer *buf);
+RSByteOffsets *LoadByteOffsets(Buffer *buf, int encver);
 
 typedef VarintVectorWriter ByteOffsetWriter;
 
@@ -66,6 +75,7 @@ typedef struct {
   BufferReader rdr;
   Buffer buf;
   uint32_t lastValue;
+  uint32_t lastDelta;
   uint32_t curPos;
   uint32_t endPos;
 } RSByteOffsetIterator;
@@ -86,4 +96,16 @@ int RSByteOffset_Iterate(const RSByteOffsets *offsets, uint32_t fieldId,
  */
 uint32_t RSByteOffsetIterator_Next(RSByteOffsetIterator *iter);
 
-#endif
\ No newline at end of file
+/**
+ * Skip the iterator directly to the given token position, decoding the
+ * intervening deltas in one tight loop rather than surfacing each intermediate
+ * offset. Returns the byte offset of tokPos, or RSBYTEOFFSET_EOF if the
+ * position lies beyond the field's token stream.
+ */
+uint32_t RSByteOffsetIterator_SkipTo(RSByteOffsetIterator *iter, uint32_t tokPos);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
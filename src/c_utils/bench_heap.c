@@ -0,0 +1,132 @@
+/* Microbenchmark for the sorter heaps: binary min-max layout vs. the 4-ary
+ * mode, driven with the RPSorter access pattern (bounded top-k: insert, evict
+ * the min when over k, drain max-first at the end) over several score
+ * distributions. Reports ns per processed element and comparison counts.
+ *
+ *   cmake --build <build> --target bench_heap
+ *   ./bench_heap [num_elements]
+ */
+#include "util/minmax_heap.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+static uint64_t nowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t cmpCount_g;
+static int cmpDouble(const void *a, const void *b, const void *ctx) {
+  (void)ctx;
+  cmpCount_g++;
+  double da = *(const double *)a, db = *(const double *)b;
+  return da < db ? -1 : da > db ? 1 : 0;
+}
+
+typedef void (*fillFunc)(double *vals, size_t n);
+
+static uint32_t rngState_g;
+static uint32_t rngNext(void) {
+  rngState_g ^= rngState_g << 13;
+  rngState_g ^= rngState_g >> 17;
+  rngState_g ^= rngState_g << 5;
+  return rngState_g;
+}
+
+static void fillUniform(double *vals, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    vals[i] = (double)rngNext() / UINT32_MAX;
+  }
+}
+static void fillAscending(double *vals, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    vals[i] = (double)i;
+  }
+}
+static void fillDescending(double *vals, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    vals[i] = (double)(n - i);
+  }
+}
+static void fillFewDistinct(double *vals, size_t n) {
+  // tf-idf-like plateaus: many ties, few distinct scores
+  for (size_t i = 0; i < n; i++) {
+    vals[i] = (double)(rngNext() % 16);
+  }
+}
+
+typedef struct {
+  const char *name;
+  fillFunc fill;
+} Dist;
+
+static const Dist dists[] = {
+    {"uniform", fillUniform},
+    {"ascending", fillAscending},
+    {"descending", fillDescending},
+    {"few-distinct", fillFewDistinct},
+};
+
+/* run the sorter pattern; returns a checksum of the drained order */
+static double runTopK(heap_t *h, double *vals, size_t n, size_t k) {
+  for (size_t i = 0; i < n; i++) {
+    if (h->count < k) {
+      mmh_insert(h, &vals[i]);
+    } else {
+      double *min = mmh_peek_min(h);
+      if (vals[i] > *min) {
+        mmh_pop_min(h);
+        mmh_insert(h, &vals[i]);
+      }
+    }
+  }
+  double checksum = 0;
+  void *v;
+  double rank = 1;
+  while ((v = mmh_pop_max(h)) != NULL) {
+    checksum += *(double *)v * rank;
+    rank += 1;
+  }
+  return checksum;
+}
+
+int main(int argc, char **argv) {
+  size_t n = 200000;
+  if (argc > 1) {
+    n = strtoul(argv[1], NULL, 10);
+  }
+  double *vals = malloc(n * sizeof(*vals));
+  const size_t ks[] = {10, 100, 1000};
+
+  printf("%-14s %6s | %9s %12s | %9s %12s | %s\n", "dist", "k", "mmh ns/el", "mmh cmps",
+         "4ary ns/el", "4ary cmps", "match");
+  for (size_t di = 0; di < sizeof(dists) / sizeof(dists[0]); di++) {
+    for (size_t ki = 0; ki < sizeof(ks) / sizeof(ks[0]); ki++) {
+      size_t k = ks[ki];
+      double results[2], ns[2];
+      uint64_t cmps[2];
+      for (int mode = 0; mode < 2; mode++) {
+        rngState_g = 0xdecafbad;
+        dists[di].fill(vals, n);
+        heap_t *h = mmh_init_with_size(k + 1, cmpDouble, NULL, NULL);
+        h->dary = mode;  // mode 0 forces the binary min-max layout
+        cmpCount_g = 0;
+        uint64_t t0 = nowNs();
+        results[mode] = runTopK(h, vals, n, k);
+        ns[mode] = (double)(nowNs() - t0) / n;
+        cmps[mode] = cmpCount_g;
+        mmh_free(h);
+      }
+      printf("%-14s %6zu | %9.1f %12llu | %9.1f %12llu | %s\n", dists[di].name, k, ns[0],
+             (unsigned long long)cmps[0], ns[1], (unsigned long long)cmps[1],
+             results[0] == results[1] ? "OK" : "MISMATCH");
+    }
+  }
+  free(vals);
+  return 0;
+}
@@ -1,8 +1,13 @@
 #include "cndict_loader.h"
 #include "dep/miniz/miniz.h"
 #include "buffer.h"
+#include "config.h"
 #include <arpa/inet.h>  // htonl, etc.
 #include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 extern const char ChineseDict[];
 extern const size_t ChineseDictCompressedLength;
@@ -11,6 +16,132 @@ extern const size_t ChineseDictFullLength;
 typedef enum { Record_HasSynonyms = 0x01 << 5, Record_HasFrequency = 0x02 << 5 } RecordFlags;
 #define LEXTYPE_MASK 0x1F
 
+/*
+ * The dictionary is parsed out of one persistent, read-only image of the
+ * decompressed records. Terms and synonyms point straight into that image
+ * instead of being strdup'ed one by one - the image IS the string storage,
+ * which cuts both the load time and a heap object per entry. Loading is
+ * already lazy (first use of a Chinese-language field; see maybeFrisoInit in
+ * tokenize_cn.c).
+ *
+ * When CNDICT_CACHE names a file, the image is written there once and then
+ * mmap'd read-only, so shards restarting on the same host reuse the kernel
+ * page cache instead of each decompressing and faulting in a private copy.
+ * Without it, the image lives in an ordinary private allocation.
+ */
+
+#define CNDICT_CACHE_MAGIC 0x434e4443u  // "CNDC"
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t imageLen;
+} CnDictCacheHeader;
+
+/* Decompress the embedded dictionary into `dst` (of ChineseDictFullLength
+ * bytes). Returns the image length */
+static size_t decompressDict(char *dst) {
+  // Before doing anything, verify the version:
+  const char *inbuf = ChineseDict;
+  uint32_t version = htonl(*(uint32_t *)inbuf);
+  inbuf += 4;
+  assert(version == 0);
+
+  mz_ulong dstLen = ChineseDictFullLength;
+  int rv = mz_uncompress((unsigned char *)dst, &dstLen, (const unsigned char *)inbuf,
+                         ChineseDictCompressedLength);
+  if (rv != MZ_OK) {
+    printf("Failed to decompress: %s. Full Len=%lu. DestLen=%lu\n", mz_error(rv), dstLen,
+           ChineseDictCompressedLength);
+    abort();
+  }
+  return dstLen;
+}
+
+/* Try to mmap a previously written cache image. Returns NULL on any
+ * mismatch - the caller falls back to building it */
+static const char *mapDictCache(const char *path, size_t *len) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  CnDictCacheHeader hdr;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(hdr) ||
+      read(fd, &hdr, sizeof(hdr)) != sizeof(hdr) || hdr.magic != CNDICT_CACHE_MAGIC ||
+      hdr.version != 0 || (size_t)st.st_size != sizeof(hdr) + hdr.imageLen) {
+    close(fd);
+    return NULL;
+  }
+  void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return NULL;
+  }
+  *len = hdr.imageLen;
+  return (const char *)map + sizeof(hdr);
+}
+
+/* Write the image next to `path` and rename into place, so concurrently
+ * starting shards either see a complete file or none */
+static void writeDictCache(const char *path, const char *image, size_t len) {
+  char tmp[1024];
+  snprintf(tmp, sizeof(tmp), "%s.tmp.%d", path, (int)getpid());
+  int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return;
+  }
+  CnDictCacheHeader hdr = {
+      .magic = CNDICT_CACHE_MAGIC, .version = 0, .imageLen = len};
+  if (write(fd, &hdr, sizeof(hdr)) != (ssize_t)sizeof(hdr) ||
+      write(fd, image, len) != (ssize_t)len) {
+    close(fd);
+    unlink(tmp);
+    return;
+  }
+  close(fd);
+  if (rename(tmp, path) != 0) {
+    unlink(tmp);
+  }
+}
+
+/* Obtain the persistent dictionary image: the mmap'd cache when configured
+ * and available, a private decompressed buffer otherwise. Never freed - the
+ * dictionary borrows its strings from it for the process lifetime */
+static const char *getDictImage(size_t *len) {
+  static const char *image = NULL;
+  static size_t imageLen = 0;
+  if (image) {
+    *len = imageLen;
+    return image;
+  }
+
+  const char *cachePath = RSGlobalConfig.cnDictCache;
+  if (cachePath) {
+    image = mapDictCache(cachePath, &imageLen);
+    if (image) {
+      *len = imageLen;
+      return image;
+    }
+  }
+
+  char *built = malloc(ChineseDictFullLength);
+  imageLen = decompressDict(built);
+  if (cachePath) {
+    writeDictCache(cachePath, built, imageLen);
+    // Prefer the shared mapping when it can be established; the private
+    // buffer is dropped in its favor
+    const char *mapped = mapDictCache(cachePath, &imageLen);
+    if (mapped) {
+      free(built);
+      *len = imageLen;
+      return image = mapped;
+    }
+  }
+  *len = imageLen;
+  return image = built;
+}
+
 typedef struct {
   friso_dic_t dic;
   BufferReader *rdr;
@@ -27,7 +158,7 @@ static int readRecord(ReaderCtx *ctx) {
 
   uint32_t lexType = c & LEXTYPE_MASK;
 
-  // Determine term length...
+  // Determine term length... the term stays a pointer into the image
   const char *term = rdr->buf->data + rdr->pos;
   size_t termLen = strlen(term);
 
@@ -44,14 +175,13 @@ static int readRecord(ReaderCtx *ctx) {
   if (numSyns) {
     syns = new_array_list_with_opacity(numSyns);
 
-    // Read the synonyms
+    // Read the synonyms - image-backed like the term
     for (size_t ii = 0; ii < numSyns; ++ii) {
       const char *curSyn = rdr->buf->data + rdr->pos;
 
       size_t synLen = strlen(curSyn);
       rdr->pos += synLen + 1;
-      // Store the synonym somewhere?
-      array_list_add(syns, strdup(curSyn));
+      array_list_add(syns, (void *)curSyn);
     }
   }
 
@@ -62,37 +192,28 @@ static int readRecord(ReaderCtx *ctx) {
     freq = htonl(freq);
   }
 
-  // printf("Adding record TYPE: %u. TERM: %s. NSYNS: %u\n", lexType, term, numSyns);
-  friso_dic_add_with_fre(ctx->dic, lexType, strdup(term), syns, freq);
+  // A duplicate would make friso free the replaced entry's image-backed
+  // strings; the generator doesn't emit duplicates, but guard anyway
+  if (friso_dic_match(ctx->dic, lexType, (fstring)term)) {
+    if (syns) {
+      free_array_list(syns);
+    }
+    return 1;
+  }
+
+  friso_dic_add_with_fre(ctx->dic, lexType, (fstring)term, syns, freq);
   return 1;
 }
 
 // Read the format
 int ChineseDictLoad(friso_dic_t d) {
-  // Before doing anything, verify the version:
-  uint32_t version;
-  const char *inbuf = ChineseDict;
-  version = htonl(*(uint32_t *)inbuf);
-  inbuf += 4;
-  assert(version == 0);
-
-  // First load the symbol..
-  char *expanded = malloc(ChineseDictFullLength);
-  mz_ulong dstLen = ChineseDictFullLength;
-  int rv = mz_uncompress((unsigned char *)expanded, &dstLen, (const unsigned char *)inbuf,
-                         ChineseDictCompressedLength);
-  if (rv != MZ_OK) {
-    printf("Failed to decompress: %s. Full Len=%lu. DestLen=%lu\n", mz_error(rv), dstLen,
-           ChineseDictCompressedLength);
-    printf("SrcLen|DstLen: 0%lx\n", dstLen | ChineseDictCompressedLength);
-    abort();
-  }
-  assert(rv == MZ_OK);
+  size_t imageLen = 0;
+  const char *image = getDictImage(&imageLen);
 
   // Now, let's see if we can read the records...
   Buffer tmpBuf;
-  tmpBuf.data = expanded;
-  tmpBuf.cap = dstLen;
+  tmpBuf.data = (char *)image;
+  tmpBuf.cap = imageLen;
   tmpBuf.offset = 0;
   BufferReader reader = NewBufferReader(&tmpBuf);
 
@@ -101,6 +222,5 @@ int ChineseDictLoad(friso_dic_t d) {
     // Do nothing
   }
 
-  free(expanded);
   return 0;
-}
\ No newline at end of file
+}
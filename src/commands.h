@@ -9,12 +9,15 @@
 #define RS_CREATE_CMD RS_CMD_PREFIX ".CREATE"
 #define RS_ADD_CMD RS_CMD_PREFIX ".ADD"
 #define RS_SAFEADD_CMD RS_CMD_PREFIX ".SAFEADD"
+#define RS_APPLYDELTA_CMD RS_CMD_PREFIX ".APPLYDELTA"
+#define RS_ADDBATCH_CMD RS_CMD_PREFIX ".ADDBATCH"
 #define RS_SETPAYLOAD_CMD RS_CMD_PREFIX ".SETPAYLOAD"
 #define RS_ADDHASH_CMD RS_CMD_PREFIX ".ADDHASH"
 #define RS_SAFEADDHASH_CMD RS_CMD_PREFIX ".SAFEADDHASH"
 #define RS_INFO_CMD RS_CMD_PREFIX ".INFO"
 #define RS_SEARCH_CMD RS_CMD_PREFIX ".SEARCH"
 #define RS_AGGREGATE_CMD RS_CMD_PREFIX ".AGGREGATE"
+#define RS_PROFILE_CMD RS_CMD_PREFIX ".PROFILE"
 
 #define RS_EXPLAIN_CMD RS_CMD_PREFIX ".EXPLAIN"
 #define RS_EXPLAINCLI_CMD RS_CMD_PREFIX ".EXPLAINCLI"
@@ -28,6 +31,8 @@
 #define RS_SUGGET_CMD RS_CMD_PREFIX ".SUGGET"
 #define RS_SUGDEL_CMD RS_CMD_PREFIX ".SUGDEL"
 #define RS_SUGLEN_CMD RS_CMD_PREFIX ".SUGLEN"
+#define RS_SUGCOMPACT_CMD RS_CMD_PREFIX ".SUGCOMPACT"
+#define RS_SUGSTATS_CMD RS_CMD_PREFIX ".SUGSTATS"
 
 #define RS_CURSOR_CMD RS_CMD_PREFIX ".CURSOR"
 
@@ -1,21 +1,281 @@
 #include "concurrent_ctx.h"
-#include "dep/thpool/thpool.h"
+#include "spec.h"
 #include <unistd.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <util/arr.h>
 #include <assert.h>
 
-static threadpool *threadpools_g = NULL;
+/* Work-stealing scheduler replacing the per-pool shared queues: one set of
+ * workers, each with its own deque. Submission round-robins across the
+ * deques; a worker drains its own deque newest-first and steals oldest-first
+ * from the others when empty, so long-running tasks of one class no longer
+ * blockade queued work of another behind a single shared queue, and subtask
+ * fan-outs (field preprocessing, trie expansion, and whatever parallel query
+ * work lands next) get scheduled at task granularity across every core.
+ *
+ * The pool ids remain as task classes. They decide one property: whether a
+ * task may take the GIL. Joiners that lend their thread to the scheduler
+ * while waiting (ConcurrentSearch_StealOne) must never execute a GIL-taking
+ * task - the joiner may itself hold the GIL, and stealing a task that locks
+ * it would self-deadlock */
 
 int CONCURRENT_POOL_INDEX = -1;
 int CONCURRENT_POOL_SEARCH = -1;
+int CONCURRENT_POOL_PREPROCESS = -1;
+int CONCURRENT_POOL_TRIE = -1;
+int CONCURRENT_POOL_CURSOR = -1;
+
+/* Small and fixed: preprocessing subtasks are short and CPU bound, and the
+ * submitting indexing thread keeps working while they run */
+#define CONCURRENT_PREPROCESS_POOL_SIZE 4
+
+/* Same sizing rationale for the trie-traversal subtasks fanned out by
+ * Trie_ExpandParallel */
+#define CONCURRENT_TRIE_POOL_SIZE 4
+
+/* Workers added for FT.CURSOR READ continuations, so a burst of export
+ * cursors competes with interactive commands through the scheduler instead
+ * of serializing on the main thread */
+#define CONCURRENT_CURSOR_POOL_SIZE 4
+
+/* Upper bound on scheduler workers; the deque directory is sized once so
+ * worker startup never moves it under running threads */
+#define WS_MAX_WORKERS 128
+
+typedef struct {
+  void (*fn)(void *);
+  void *arg;
+  uint8_t gilFree;
+  uint8_t lane;
+  uint64_t enqueuedNs;
+} WSTask;
+
+/* Priority lanes: a worker (and a thief) serves the highest nonempty lane,
+ * except that a lower lane whose oldest task has waited past its deadline is
+ * served first - interactive traffic wins, but nothing starves */
+#define WS_LANE_INTERACTIVE 0
+#define WS_LANE_CURSOR 1
+#define WS_LANE_BACKGROUND 2
+#define WS_NUM_LANES 3
+
+/* Age past which a waiting lane overrides higher-priority traffic */
+static const uint64_t wsLaneDeadlineNs[WS_NUM_LANES] = {0, 50ULL * 1000000, 200ULL * 1000000};
+
+typedef struct {
+  WSTask *ring;
+  size_t cap;
+  size_t head;   // index of the oldest task (the steal end)
+  size_t count;
+} WSLaneQ;
+
+typedef struct {
+  WSLaneQ lanes[WS_NUM_LANES];
+  pthread_mutex_t lock;
+} WSDeque;
+
+typedef struct {
+  WSDeque deques[WS_MAX_WORKERS];
+  pthread_t threads[WS_MAX_WORKERS];
+  int nthreads;
+  /* Sleep/wake: `queued` counts undone tasks and is maintained under
+   * sleepLock, so a submission racing a worker's empty scan cannot lose its
+   * wakeup */
+  pthread_mutex_t sleepLock;
+  pthread_cond_t sleepCond;
+  size_t queued;
+  unsigned rr;
+} WSScheduler;
+
+static WSScheduler wsSched_g = {.sleepLock = PTHREAD_MUTEX_INITIALIZER,
+                                .sleepCond = PTHREAD_COND_INITIALIZER};
+static __thread int wsWorkerId = -1;
+
+static uint64_t wsNowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void wsDequePush(WSDeque *d, const WSTask *t) {
+  pthread_mutex_lock(&d->lock);
+  WSLaneQ *q = &d->lanes[t->lane];
+  if (q->count == q->cap) {
+    size_t newcap = q->cap ? q->cap * 2 : 16;
+    WSTask *fresh = malloc(newcap * sizeof(*fresh));
+    for (size_t i = 0; i < q->count; i++) {
+      fresh[i] = q->ring[(q->head + i) % q->cap];
+    }
+    free(q->ring);
+    q->ring = fresh;
+    q->cap = newcap;
+    q->head = 0;
+  }
+  q->ring[(q->head + q->count) % q->cap] = *t;
+  q->count++;
+  pthread_mutex_unlock(&d->lock);
+}
+
+/* Under the deque lock: pick the lane to serve - the highest-priority
+ * nonempty one unless a lower lane's oldest task is past its deadline. In
+ * urgent mode only an interactive or overdue pick is returned: the caller
+ * wants to look for interactive work elsewhere before settling for fresh
+ * lower-lane tasks here */
+static WSLaneQ *wsPickLane(WSDeque *d, int urgentOnly) {
+  WSLaneQ *best = NULL;
+  int bestOverdue = 0;
+  uint64_t now = 0;
+  for (int l = WS_NUM_LANES - 1; l >= 0; --l) {
+    WSLaneQ *q = &d->lanes[l];
+    if (!q->count) {
+      continue;
+    }
+    if (!best) {
+      best = q;
+      continue;
+    }
+    // `best` is a lower lane; it keeps the pick only when overdue
+    if (now == 0) {
+      now = wsNowNs();
+    }
+    const WSTask *oldest = &best->ring[best->head];
+    uint64_t deadline = wsLaneDeadlineNs[oldest->lane];
+    if (deadline && now - oldest->enqueuedNs > deadline) {
+      bestOverdue = 1;
+    } else {
+      best = q;
+      bestOverdue = 0;
+    }
+  }
+  if (urgentOnly && best && best != &d->lanes[WS_LANE_INTERACTIVE] && !bestOverdue) {
+    // A sole lower-lane pick never went through the comparison above -
+    // evaluate its age before deferring it to the fallback pass
+    const WSTask *oldest = &best->ring[best->head];
+    uint64_t deadline = wsLaneDeadlineNs[oldest->lane];
+    if (!(deadline && wsNowNs() - oldest->enqueuedNs > deadline)) {
+      return NULL;
+    }
+  }
+  return best;
+}
 
+/* Pop the newest task of the picked lane - the worker's own end */
+static int wsDequePopBottom(WSDeque *d, WSTask *out, int urgentOnly) {
+  pthread_mutex_lock(&d->lock);
+  WSLaneQ *q = wsPickLane(d, urgentOnly);
+  if (!q) {
+    pthread_mutex_unlock(&d->lock);
+    return 0;
+  }
+  q->count--;
+  *out = q->ring[(q->head + q->count) % q->cap];
+  pthread_mutex_unlock(&d->lock);
+  return 1;
+}
+
+/* Steal the oldest task of the picked lane. When gilFreeOnly is set, the
+ * oldest GIL-free task anywhere in the deque is taken instead - subtasks must
+ * stay reachable even when queued GIL tasks sit ahead of them, or a joiner
+ * lending its thread could wait on work nothing will run (the starvation the
+ * old dedicated pools existed to prevent) */
+static int wsDequeStealTop(WSDeque *d, WSTask *out, int gilFreeOnly, int urgentOnly) {
+  pthread_mutex_lock(&d->lock);
+  if (!gilFreeOnly) {
+    WSLaneQ *q = wsPickLane(d, urgentOnly);
+    if (!q) {
+      pthread_mutex_unlock(&d->lock);
+      return 0;
+    }
+    *out = q->ring[q->head];
+    q->head = (q->head + 1) % q->cap;
+    q->count--;
+    pthread_mutex_unlock(&d->lock);
+    return 1;
+  }
+  for (int l = 0; l < WS_NUM_LANES; l++) {
+    WSLaneQ *q = &d->lanes[l];
+    for (size_t i = 0; i < q->count; i++) {
+      size_t at = (q->head + i) % q->cap;
+      if (!q->ring[at].gilFree) {
+        continue;
+      }
+      *out = q->ring[at];
+      // close the hole, preserving queue order
+      for (size_t j = i; j + 1 < q->count; j++) {
+        q->ring[(q->head + j) % q->cap] = q->ring[(q->head + j + 1) % q->cap];
+      }
+      q->count--;
+      pthread_mutex_unlock(&d->lock);
+      return 1;
+    }
+  }
+  pthread_mutex_unlock(&d->lock);
+  return 0;
+}
+
+static void wsMarkDone(void) {
+  pthread_mutex_lock(&wsSched_g.sleepLock);
+  wsSched_g.queued--;
+  pthread_mutex_unlock(&wsSched_g.sleepLock);
+}
+
+/* Find a task. Urgency-major: the first pass serves interactive (or overdue)
+ * work anywhere - own deque, then steals - before the second pass settles for
+ * fresh lower-lane work, so a worker's queued background never runs ahead of
+ * another deque's interactive traffic */
+static int wsFindWork(int self, WSTask *out, int gilFreeOnly) {
+  WSScheduler *s = &wsSched_g;
+  int n = s->nthreads;
+  int start = self >= 0 ? self + 1 : (int)(s->rr + 1);
+  for (int pass = 0; pass < 2; pass++) {
+    int urgent = pass == 0;
+    if (gilFreeOnly) {
+      if (urgent) {
+        continue;  // the gil-free scan has its own lane order
+      }
+    } else if (self >= 0 && wsDequePopBottom(&s->deques[self], out, urgent)) {
+      return 1;
+    }
+    for (int i = 0; i < n; i++) {
+      if (wsDequeStealTop(&s->deques[(start + i) % n], out, gilFreeOnly, urgent)) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static void *wsWorker(void *arg) {
+  wsWorkerId = (int)(intptr_t)arg;
+  WSScheduler *s = &wsSched_g;
+  while (1) {
+    WSTask t;
+    if (wsFindWork(wsWorkerId, &t, 0)) {
+      wsMarkDone();
+      t.fn(t.arg);
+      continue;
+    }
+    pthread_mutex_lock(&s->sleepLock);
+    while (s->queued == 0) {
+      pthread_cond_wait(&s->sleepCond, &s->sleepLock);
+    }
+    pthread_mutex_unlock(&s->sleepLock);
+  }
+  return NULL;
+}
+
+/* Add `numThreads` workers to the scheduler, returning the pool's class id.
+ * Kept as the pool-creation entry point so callers are unchanged */
 int ConcurrentSearch_CreatePool(int numThreads) {
-  if (!threadpools_g) {
-    threadpools_g = array_new(threadpool, 4);
+  static int nextPoolId = 0;
+  WSScheduler *s = &wsSched_g;
+  for (int i = 0; i < numThreads && s->nthreads < WS_MAX_WORKERS; i++) {
+    int id = s->nthreads;
+    pthread_mutex_init(&s->deques[id].lock, NULL);
+    s->nthreads++;
+    pthread_create(&s->threads[id], NULL, wsWorker, (void *)(intptr_t)id);
   }
-  int poolId = array_len(threadpools_g);
-  threadpools_g = array_append(threadpools_g, thpool_init(numThreads));
-  return poolId;
+  return nextPoolId++;
 }
 
 /** Start the concurrent search thread pool. Should be called when initializing the module */
@@ -33,9 +293,74 @@ void ConcurrentSearch_ThreadPoolStart() {
       numProcs = RSGlobalConfig.indexPoolSize;
     }
     CONCURRENT_POOL_INDEX = ConcurrentSearch_CreatePool(numProcs);
+
+    // Field preprocessors fan out here from Document_AddToIndexes, and fuzzy
+    // trie expansion fans out per root subtree; both submitters join their
+    // subtasks by lending their thread to the scheduler, so unlike the old
+    // fixed pools no dedicated workers are required for progress - these
+    // sizes just add capacity for the fan-outs
+    CONCURRENT_POOL_PREPROCESS = ConcurrentSearch_CreatePool(CONCURRENT_PREPROCESS_POOL_SIZE);
+    CONCURRENT_POOL_TRIE = ConcurrentSearch_CreatePool(CONCURRENT_TRIE_POOL_SIZE);
+    CONCURRENT_POOL_CURSOR = ConcurrentSearch_CreatePool(CONCURRENT_CURSOR_POOL_SIZE);
   }
 }
 
+/* Run a function on the concurrent thread pool */
+void ConcurrentSearch_ThreadPoolRun(void (*func)(void *), void *arg, int type) {
+  WSScheduler *s = &wsSched_g;
+  assert(s->nthreads > 0);  // submissions require a started scheduler
+  WSTask t = {.fn = func,
+              .arg = arg,
+              // Only the subtask classes are guaranteed GIL-free; search
+              // commands and indexing tasks take the GIL inside
+              .gilFree = type == CONCURRENT_POOL_PREPROCESS || type == CONCURRENT_POOL_TRIE,
+              // Interactive search beats cursor continuations beats
+              // everything background (indexing, GC slices, subtasks)
+              .lane = type == CONCURRENT_POOL_SEARCH   ? WS_LANE_INTERACTIVE
+                      : type == CONCURRENT_POOL_CURSOR ? WS_LANE_CURSOR
+                                                       : WS_LANE_BACKGROUND,
+              .enqueuedNs = wsNowNs()};
+  unsigned slot = __atomic_fetch_add(&s->rr, 1, __ATOMIC_RELAXED) % (unsigned)s->nthreads;
+  wsDequePush(&s->deques[slot], &t);
+  pthread_mutex_lock(&s->sleepLock);
+  s->queued++;
+  pthread_cond_signal(&s->sleepCond);
+  pthread_mutex_unlock(&s->sleepLock);
+}
+
+/* Lend the calling thread to the scheduler for one task: used by joiners
+ * waiting on their fanned-out subtasks, instead of parking while work sits
+ * queued. Only GIL-free tasks are taken - the caller may hold the GIL.
+ * Returns 1 if a task ran */
+__thread RSCostAccounting RSCostAcct_tls = {0};
+
+void RS_CostAccountingArm(int (*check)(void *arg), void *arg) {
+  RSCostAcct_tls.cost = 0;
+  RSCostAcct_tls.nextCheck = RS_COST_CHECK_INTERVAL;
+  RSCostAcct_tls.check = check;
+  RSCostAcct_tls.arg = arg;
+  RSCostAcct_tls.aborted = 0;
+}
+
+void RS_CostAccountingDisarm(void) {
+  RSCostAcct_tls.check = NULL;
+  RSCostAcct_tls.aborted = 0;
+}
+
+size_t ConcurrentSearch_QueueDepth(void) {
+  return __atomic_load_n(&wsSched_g.queued, __ATOMIC_RELAXED);
+}
+
+int ConcurrentSearch_StealOne(void) {
+  WSTask t;
+  if (!wsSched_g.nthreads || !wsFindWork(wsWorkerId, &t, 1)) {
+    return 0;
+  }
+  wsMarkDone();
+  t.fn(t.arg);
+  return 1;
+}
+
 typedef struct ConcurrentCmdCtx {
   RedisModuleBlockedClient *bc;
   RedisModuleCtx *ctx;
@@ -45,12 +370,6 @@ typedef struct ConcurrentCmdCtx {
   int options;
 } ConcurrentCmdCtx;
 
-/* Run a function on the concurrent thread pool */
-void ConcurrentSearch_ThreadPoolRun(void (*func)(void *), void *arg, int type) {
-  threadpool p = threadpools_g[type];
-  thpool_add_work(p, func, arg);
-}
-
 static void threadHandleCommand(void *p) {
   ConcurrentCmdCtx *ctx = p;
   // Lock GIL if needed
@@ -124,13 +443,18 @@ void ConcurrentSearchCtx_ReopenKeys(ConcurrentSearchCtx *ctx) {
 
 /** Check the elapsed timer, and release the lock if enough time has passed */
 int ConcurrentSearch_CheckTimer(ConcurrentSearchCtx *ctx) {
-  static struct timespec now;
+  struct timespec now;
   clock_gettime(CLOCK_MONOTONIC_RAW, &now);
 
   long long durationNS = (long long)1000000000 * (now.tv_sec - ctx->lastTime.tv_sec) +
                          (now.tv_nsec - ctx->lastTime.tv_nsec);
+  // Adaptive quantum: yield at the fairness cadence only when work is
+  // actually queued behind us; an idle scheduler stretches the slice so the
+  // unlock/relock (and key reopen) overhead amortizes
+  long long quantum =
+      ConcurrentSearch_QueueDepth() ? CONCURRENT_TIMEOUT_NS : CONCURRENT_TIMEOUT_IDLE_NS;
   // Timeout - release the thread safe context lock and let other threads run as well
-  if (durationNS > CONCURRENT_TIMEOUT_NS) {
+  if (durationNS > quantum) {
     ConcurrentSearchCtx_Unlock(ctx);
 
     // Right after releasing, we try to acquire the lock again.
@@ -157,6 +481,7 @@ void ConcurrentSearchCtx_Init(RedisModuleCtx *rctx, ConcurrentSearchCtx *ctx) {
   ctx->isLocked = 0;
   ctx->numOpenKeys = 0;
   ctx->openKeys = NULL;
+  ctx->indexSpec = NULL;
   ConcurrentSearchCtx_ResetClock(ctx);
 }
 
@@ -168,6 +493,7 @@ void ConcurrentSearchCtx_InitSingle(ConcurrentSearchCtx *ctx, RedisModuleCtx *rc
   ctx->openKeys = calloc(1, sizeof(*ctx->openKeys));
   ctx->openKeys->cb = cb;
   ctx->openKeys->keyFlags = mode;
+  ctx->indexSpec = NULL;
 }
 
 void ConcurrentSearchCtx_Free(ConcurrentSearchCtx *ctx) {
@@ -224,9 +550,15 @@ void ConcurrentSearchCtx_Lock(ConcurrentSearchCtx *ctx) {
   RedisModule_ThreadSafeContextLock(ctx->ctx);
   ctx->isLocked = 1;
   ConcurrentSearchCtx_ReopenKeys(ctx);
+  if (ctx->indexSpec) {
+    IndexSpec_LockRead(ctx->indexSpec);
+  }
 }
 
 void ConcurrentSearchCtx_Unlock(ConcurrentSearchCtx *ctx) {
+  if (ctx->indexSpec) {
+    IndexSpec_UnlockIndex(ctx->indexSpec);
+  }
   ConcurrentSearchCtx_CloseKeys(ctx);
   RedisModule_ThreadSafeContextUnlock(ctx->ctx);
   ctx->isLocked = 0;
@@ -5,12 +5,15 @@
 #include "redismodule.h"
 #include "config.h"
 #include <time.h>
-#include <dep/thpool/thpool.h>
 
 #if defined(__FreeBSD__)
 #define CLOCK_MONOTONIC_RAW CLOCK_MONOTONIC
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /** Concurrent Search Exection Context.
  *
  * We allow queries to run concurrently, each running on its own thread, locking the redis GIL
@@ -57,6 +60,11 @@ typedef struct {
   ConcurrentKeyCtx *openKeys;
   uint32_t numOpenKeys;
   uint32_t isLocked;
+  /* When set, the spec's index read lock is juggled together with the GIL:
+   * released before every yield and retaken (after the keys reopen) on every
+   * relock - so the reader never holds the index lock without the GIL, which
+   * is the invariant the per-spec rwlock's writers rely on */
+  struct IndexSpec *indexSpec;
 } ConcurrentSearchCtx;
 
 /** The maximal size of the concurrent query thread pool. Since only one thread is operational at a
@@ -77,9 +85,14 @@ typedef struct {
  * calls to clock_gettime() */
 #define CONCURRENT_TICK_CHECK 50
 
-/** The timeout after which we try to switch to another query thread - in Nanoseconds */
+/** The yield quantum when other work is queued behind us - in Nanoseconds */
 #define CONCURRENT_TIMEOUT_NS 100000
 
+/** The quantum with an empty scheduler queue: with no one to be fair to, the
+ * GIL juggling (and the key reopens it pays for) is stretched out instead of
+ * taxing light-load latency at the contended cadence */
+#define CONCURRENT_TIMEOUT_IDLE_NS (CONCURRENT_TIMEOUT_NS * 20)
+
 /* Add a "monitored" key to the context. When keys are open during concurrent execution, they need
  * to be closed before we yield execution and release the GIL, and reopened when we get back the
  * execution context.
@@ -117,8 +130,19 @@ void ConcurrentSearch_ThreadPoolStart();
 /* Create a new thread pool, and return its identifying id */
 int ConcurrentSearch_CreatePool(int numThreads);
 
+/* Lend the calling thread to the scheduler for one queued GIL-free task.
+ * Returns 1 if a task ran, 0 when nothing eligible was queued */
+int ConcurrentSearch_StealOne(void);
+
+/* Undone tasks currently queued on the scheduler. A racy snapshot - it feeds
+ * heuristics (the adaptive yield quantum), not invariants */
+size_t ConcurrentSearch_QueueDepth(void);
+
 extern int CONCURRENT_POOL_INDEX;
 extern int CONCURRENT_POOL_SEARCH;
+extern int CONCURRENT_POOL_PREPROCESS;
+extern int CONCURRENT_POOL_TRIE;
+extern int CONCURRENT_POOL_CURSOR;
 
 /* Run a function on the concurrent thread pool */
 void ConcurrentSearch_ThreadPoolRun(void (*func)(void *), void *arg, int type);
@@ -128,6 +152,50 @@ void ConcurrentSearch_ThreadPoolRun(void (*func)(void *), void *arg, int type);
  */
 int ConcurrentSearch_CheckTimer(ConcurrentSearchCtx *ctx);
 
+/**
+ * Cooperative cost-based preemption. The per-result ticks bound how often a
+ * query yields between results, but a single heavy iterator operation (a
+ * pathological intersection skip, an adversarial wildcard traversal) can run
+ * for tens of milliseconds inside one result. Iterators therefore account
+ * fine-grained cost units - a decoded record, a synthetic candidate - into a
+ * thread-local counter; every RS_COST_CHECK_INTERVAL units the armed checker
+ * runs (timeout enforcement plus a yield opportunity), and when it requests
+ * an abort the iterators report EOF so the pipeline drains what it has.
+ * Unarmed (no query executing on the thread) the accounting is one branch.
+ */
+typedef struct {
+  uint64_t cost;
+  uint64_t nextCheck;
+  int (*check)(void *arg);  // nonzero return = abort the traversal
+  void *arg;
+  int aborted;
+} RSCostAccounting;
+
+extern __thread RSCostAccounting RSCostAcct_tls;
+
+#define RS_COST_CHECK_INTERVAL 4096
+
+/* Account n cost units; returns nonzero when the checker has requested an
+ * abort, which iterators treat as EOF */
+static inline int RS_AccountCost(unsigned n) {
+  RSCostAccounting *acct = &RSCostAcct_tls;
+  if (!acct->check) {
+    return 0;
+  }
+  acct->cost += n;
+  if (acct->cost >= acct->nextCheck && !acct->aborted) {
+    acct->nextCheck = acct->cost + RS_COST_CHECK_INTERVAL;
+    if (acct->check(acct->arg)) {
+      acct->aborted = 1;
+    }
+  }
+  return acct->aborted;
+}
+
+/* Arm/disarm the calling thread's cost accounting around an execution slice */
+void RS_CostAccountingArm(int (*check)(void *arg), void *arg);
+void RS_CostAccountingDisarm(void);
+
 /** Initialize and reset a concurrent search ctx */
 void ConcurrentSearchCtx_Init(RedisModuleCtx *rctx, ConcurrentSearchCtx *ctx);
 
@@ -208,4 +276,7 @@ static inline int CheckConcurrentSupport(RedisModuleCtx *ctx) {
   return 1;
 }
 
+#ifdef __cplusplus
+}
+#endif
 #endif
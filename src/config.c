@@ -65,6 +65,119 @@ CONFIG_GETTER(getExtLoad) {
   }
 }
 
+// DELTALOG_DIR
+CONFIG_SETTER(setDeltaLogDir) {
+  if (*offset >= argc) {
+    return REDISMODULE_ERR;
+  }
+  config->deltaLogDir = RedisModule_StringPtrLen(argv[(*offset)++], NULL);
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getDeltaLogDir) {
+  if (config->deltaLogDir) {
+    return sdsnew(config->deltaLogDir);
+  } else {
+    return NULL;
+  }
+}
+
+// COLD_BLOCK_MINUTES
+CONFIG_SETTER(setColdBlockMinutes) {
+  if (*offset >= argc) {
+    return REDISMODULE_ERR;
+  }
+  long long val;
+  if (RedisModule_StringToLongLong(argv[(*offset)++], &val) != REDISMODULE_OK || val < 0) {
+    return REDISMODULE_ERR;
+  }
+  config->coldBlockMinutes = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getColdBlockMinutes) {
+  return sdscatprintf(sdsempty(), "%lld", config->coldBlockMinutes);
+}
+
+// BACKFILL_DOCS_PER_SEC
+CONFIG_SETTER(setBackfillDocsPerSec) {
+  if (*offset >= argc) {
+    return REDISMODULE_ERR;
+  }
+  long long val;
+  if (RedisModule_StringToLongLong(argv[(*offset)++], &val) != REDISMODULE_OK || val < 0) {
+    return REDISMODULE_ERR;
+  }
+  config->backfillDocsPerSec = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getBackfillDocsPerSec) {
+  return sdscatprintf(sdsempty(), "%lld", config->backfillDocsPerSec);
+}
+
+// QUERY_COST_BUDGET
+CONFIG_SETTER(setQueryCostBudget) {
+  if (*offset >= argc) {
+    return REDISMODULE_ERR;
+  }
+  long long val;
+  if (RedisModule_StringToLongLong(argv[(*offset)++], &val) != REDISMODULE_OK || val < 0) {
+    return REDISMODULE_ERR;
+  }
+  config->queryCostBudget = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getQueryCostBudget) {
+  return sdscatprintf(sdsempty(), "%lld", config->queryCostBudget);
+}
+
+// QUERY_COST_POLICY
+CONFIG_SETTER(setQueryCostPolicy) {
+  if (*offset >= argc) {
+    return REDISMODULE_ERR;
+  }
+  const char *s = RedisModule_StringPtrLen(argv[(*offset)++], NULL);
+  if (!strcasecmp(s, "REJECT")) {
+    config->queryCostDegrade = 0;
+  } else if (!strcasecmp(s, "DEGRADE")) {
+    config->queryCostDegrade = 1;
+  } else {
+    return REDISMODULE_ERR;
+  }
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getQueryCostPolicy) {
+  return sdsnew(config->queryCostDegrade ? "DEGRADE" : "REJECT");
+}
+
+// SLOWLOG_THRESHOLD_MS
+CONFIG_SETTER(setSlowlogThreshold) {
+  if (*offset >= argc) {
+    return REDISMODULE_ERR;
+  }
+  long long val;
+  if (RedisModule_StringToLongLong(argv[(*offset)++], &val) != REDISMODULE_OK || val < 0) {
+    return REDISMODULE_ERR;
+  }
+  config->slowlogThresholdMs = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getSlowlogThreshold) {
+  return sdscatprintf(sdsempty(), "%lld", config->slowlogThresholdMs);
+}
+
+// REPLICATE_EFFECTS
+CONFIG_SETTER(setReplicateEffects) {
+  config->replicateEffects = 1;
+  return REDISMODULE_OK;
+}
+
+CONFIG_BOOLEAN_GETTER(getReplicateEffects, replicateEffects, 0)
+
 // SAFEMODE
 CONFIG_SETTER(setSafemode) {
   config->concurrentMode = 0;
@@ -199,6 +312,19 @@ CONFIG_GETTER(getFrisoINI) {
   return config->frisoIni ? sdsnew(config->frisoIni) : NULL;
 }
 
+// CNDICT_CACHE
+CONFIG_SETTER(setCnDictCache) {
+  if (*offset == argc) {
+    RETURN_ERROR("Missing argument");
+  }
+  const char *path = RedisModule_StringPtrLen(argv[(*offset)++], NULL);
+  config->cnDictCache = path;
+  return REDISMODULE_OK;
+}
+CONFIG_GETTER(getCnDictCache) {
+  return config->cnDictCache ? sdsnew(config->cnDictCache) : NULL;
+}
+
 // ON_TIMEOUT
 CONFIG_SETTER(setOnTimeout) {
   if (*offset == argc) {
@@ -246,6 +372,96 @@ CONFIG_GETTER(getForkGcInterval) {
   return sdscatprintf(ss, "%lu", config->forkGcRunIntervalSec);
 }
 
+// FORK_GC_TERM_BUDGET
+CONFIG_SETTER(setForkGcTermBudget) {
+  long long val;
+  if (readLongLongLimit(argv, argc, offset, &val, 0, LLONG_MAX) != REDISMODULE_OK) {
+    return REDISMODULE_ERR;
+  }
+  config->forkGcTermBudget = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getForkGcTermBudget) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->forkGcTermBudget);
+}
+
+// GROUPBY_MAX_MEMORY
+CONFIG_SETTER(setGroupByMaxMemory) {
+  long long val;
+  if (readLongLongLimit(argv, argc, offset, &val, 0, LLONG_MAX) != REDISMODULE_OK) {
+    return REDISMODULE_ERR;
+  }
+  config->groupByMaxMemory = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getGroupByMaxMemory) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lu", config->groupByMaxMemory);
+}
+
+// CURSOR_READAHEAD
+CONFIG_SETTER(setCursorReadAhead) {
+  long long val;
+  if (readLongLongLimit(argv, argc, offset, &val, 0, 1) != REDISMODULE_OK) {
+    return REDISMODULE_ERR;
+  }
+  config->cursorReadAhead = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getCursorReadAhead) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%d", config->cursorReadAhead);
+}
+
+// RESULT_CACHE_TTL
+CONFIG_SETTER(setResultCacheTTL) {
+  long long val;
+  if (readLongLongLimit(argv, argc, offset, &val, 0, LLONG_MAX) != REDISMODULE_OK) {
+    return REDISMODULE_ERR;
+  }
+  config->resultCacheTTLMS = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getResultCacheTTL) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lld", config->resultCacheTTLMS);
+}
+
+// SPELLCHECK_FREQ_THRESHOLD
+CONFIG_SETTER(setSpellcheckFreqThreshold) {
+  long long val;
+  if (readLongLongLimit(argv, argc, offset, &val, 1, LLONG_MAX) != REDISMODULE_OK) {
+    return REDISMODULE_ERR;
+  }
+  config->spellcheckFreqThreshold = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getSpellcheckFreqThreshold) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%lld", config->spellcheckFreqThreshold);
+}
+
+// TERMS_IN_SPEC
+CONFIG_SETTER(setTermsInSpec) {
+  long long val;
+  if (readLongLongLimit(argv, argc, offset, &val, 0, 1) != REDISMODULE_OK) {
+    return REDISMODULE_ERR;
+  }
+  config->termsInSpec = val;
+  return REDISMODULE_OK;
+}
+
+CONFIG_GETTER(getTermsInSpec) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%d", config->termsInSpec);
+}
+
 CONFIG_SETTER(setMinPhoneticTermLen) {
   long long val;
   if (readLongLongLimit(argv, argc, offset, &val, 1, LLONG_MAX) != REDISMODULE_OK) {
@@ -335,6 +551,36 @@ RSConfigOptions RSGlobalConfigOptions = {
          .setValue = setExtLoad,
          .getValue = getExtLoad,
          .flags = RSCONFIGVAR_F_IMMUTABLE},
+        {.name = "DELTALOG_DIR",
+         .helpText = "Directory for per-index append-only delta logs of committed documents",
+         .setValue = setDeltaLogDir,
+         .getValue = getDeltaLogDir,
+         .flags = RSCONFIGVAR_F_IMMUTABLE},
+        {.name = "REPLICATE_EFFECTS",
+         .helpText = "Replicate computed index deltas instead of re-tokenizing on replicas",
+         .setValue = setReplicateEffects,
+         .getValue = getReplicateEffects,
+         .flags = RSCONFIGVAR_F_FLAG},
+        {.name = "SLOWLOG_THRESHOLD_MS",
+         .helpText = "Record slower search commands in the per-index slow log (0 disables)",
+         .setValue = setSlowlogThreshold,
+         .getValue = getSlowlogThreshold},
+        {.name = "QUERY_COST_BUDGET",
+         .helpText = "Reject or degrade queries whose estimated cost exceeds this (0 disables)",
+         .setValue = setQueryCostBudget,
+         .getValue = getQueryCostBudget},
+        {.name = "QUERY_COST_POLICY",
+         .helpText = "REJECT or DEGRADE over-budget queries",
+         .setValue = setQueryCostPolicy,
+         .getValue = getQueryCostPolicy},
+        {.name = "BACKFILL_DOCS_PER_SEC",
+         .helpText = "Rate budget for online schema backfill (0 = unthrottled)",
+         .setValue = setBackfillDocsPerSec,
+         .getValue = getBackfillDocsPerSec},
+        {.name = "COLD_BLOCK_MINUTES",
+         .helpText = "Compress index blocks untouched for this many minutes (0 disables)",
+         .setValue = setColdBlockMinutes,
+         .getValue = getColdBlockMinutes},
         {.name = "SAFEMODE",
          .helpText = "Perform all operations in main thread",
          .setValue = setSafemode,
@@ -386,6 +632,12 @@ RSConfigOptions RSGlobalConfigOptions = {
          .setValue = setFrisoINI,
          .getValue = getFrisoINI,
          .flags = RSCONFIGVAR_F_IMMUTABLE},
+        {.name = "CNDICT_CACHE",
+         .helpText = "Path for the decompressed Chinese dictionary image, mmap'd read-only and "
+                     "shared across shards on the same host via the page cache",
+         .setValue = setCnDictCache,
+         .getValue = getCnDictCache,
+         .flags = RSCONFIGVAR_F_IMMUTABLE},
         {.name = "ON_TIMEOUT",
          .helpText = "Action to perform when search timeout is exceeded (choose RETURN or FAIL)",
          .setValue = setOnTimeout,
@@ -403,6 +655,39 @@ RSConfigOptions RSGlobalConfigOptions = {
          .setValue = setGcPolicy,
          .getValue = getGcPolicy,
          .flags = RSCONFIGVAR_F_IMMUTABLE},
+        {.name = "FORK_GC_TERM_BUDGET",
+         .helpText = "Maximum terms one fork GC cycle scans (0 - unlimited). Bounds fork "
+                     "lifetime and copy-on-write growth",
+         .setValue = setForkGcTermBudget,
+         .getValue = getForkGcTermBudget},
+        {.name = "GROUPBY_MAX_MEMORY",
+         .helpText = "Approximate GROUPBY table memory ceiling in bytes per request; groups "
+                     "beyond it spill to temp files and are processed per partition "
+                     "(0 - unlimited)",
+         .setValue = setGroupByMaxMemory,
+         .getValue = getGroupByMaxMemory},
+        {.name = "CURSOR_READAHEAD",
+         .helpText = "When 1, FT.CURSOR READ precomputes the next batch on the concurrent "
+                     "pool while the client processes the current one",
+         .setValue = setCursorReadAhead,
+         .getValue = getCursorReadAhead},
+        {.name = "RESULT_CACHE_TTL",
+         .helpText = "TTL in milliseconds for cached first-page search replies; 0 disables "
+                     "the result cache. Writes invalidate affected entries earlier through "
+                     "per-term epochs",
+         .setValue = setResultCacheTTL,
+         .getValue = getResultCacheTTL},
+        {.name = "SPELLCHECK_FREQ_THRESHOLD",
+         .helpText = "Terms whose inverted index holds at least this many documents are "
+                     "considered correctly spelled without a dictionary scan",
+         .setValue = setSpellcheckFreqThreshold,
+         .getValue = getSpellcheckFreqThreshold},
+        {.name = "TERMS_IN_SPEC",
+         .helpText = "When 1, new indexes store term inverted indexes inside the index spec "
+                     "instead of one Redis key per term (affects indexes created after the "
+                     "change)",
+         .setValue = setTermsInSpec,
+         .getValue = getTermsInSpec},
         {.name = "FORK_GC_RUN_INTERVAL",
          .helpText = "interval in which to run the fork gc (relevant only when fork gc is used)",
          .setValue = setForkGcInterval,
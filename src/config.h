@@ -78,6 +78,56 @@ typedef struct {
   GCPolicy gcPolicy;
   GCPolicy forkGcRunIntervalSec;
   size_t forkGcSleepBeforeExit;
+  // Maximum terms a single fork GC cycle scans (0 = unlimited). Bounding the slice bounds
+  // both the fork's lifetime and its copy-on-write amplification under write load
+  size_t forkGcTermBudget;
+
+  // Approximate per-request GROUPBY table memory ceiling in bytes. Once a
+  // grouper's table estimate passes this, new groups spill to temp files and
+  // are processed partition by partition (0 - unlimited)
+  size_t groupByMaxMemory;
+
+  // When nonzero, FT.CURSOR READ schedules computation of the next batch on
+  // the concurrent pool right after replying, overlapping server compute
+  // with client think time
+  int cursorReadAhead;
+
+  // When nonzero, newly created indexes keep their term inverted indexes in
+  // a spec-owned dictionary instead of one Redis key per term
+  int termsInSpec;
+  // Directory for per-index append-only delta logs (NULL = disabled)
+  const char *deltaLogDir;
+  // Minutes an index block must stay untouched before the tiering sweep
+  // compresses it in place (0 = disabled)
+  long long coldBlockMinutes;
+  // Rate budget for online schema backfill (documents per second; 0 = unthrottled)
+  long long backfillDocsPerSec;
+  // Admission control: reject/degrade queries whose estimated index-record
+  // cost exceeds this (0 = disabled)
+  long long queryCostBudget;
+  // What to do with an over-budget query: 0 = reject, 1 = degrade (cap prefix
+  // expansions hard, then reject only if still over)
+  int queryCostDegrade;
+  // Record search commands slower than this, with per-stage attribution, in
+  // the per-index slow log (0 = disabled)
+  long long slowlogThresholdMs;
+  // Ship computed indexing effects to replicas instead of verbatim commands
+  int replicateEffects;
+
+  // A spellchecked term whose inverted index holds at least this many docs is
+  // treated as correctly spelled without consulting the dictionary trie
+  long long spellcheckFreqThreshold;
+
+  // TTL in milliseconds for the hot-query result cache; 0 (the default)
+  // disables caching entirely. Entries are additionally invalidated by
+  // per-term write epochs, so the TTL only bounds staleness from writes the
+  // epochs cannot attribute
+  long long resultCacheTTLMS;
+
+  // Optional path for the decompressed Chinese-dictionary image. When set,
+  // the image is written once and mmap'd read-only, so shards restarting on
+  // the same host share it through the page cache
+  const char *cnDictCache;
 
   // Chained configuration data
   void *chainedConfig;
@@ -156,7 +206,9 @@ sds RSConfig_GetInfoString(const RSConfig *config);
     .indexPoolSize = CONCURRENT_INDEX_POOL_DEFAULT_SIZE, .poolSizeNoAuto = 0,                   \
     .gcScanSize = GC_SCANSIZE, .minPhoneticTermLen = DEFAULT_MIN_PHONETIC_TERM_LEN,             \
     .gcPolicy = GCPolicy_Default, .forkGcRunIntervalSec = DEFAULT_FORK_GC_RUN_INTERVAL,         \
-    .forkGcSleepBeforeExit = 0,                                                                 \
+    .forkGcSleepBeforeExit = 0, .forkGcTermBudget = 0, .groupByMaxMemory = 0, .cursorReadAhead = 0,                                                                 \
+    .termsInSpec = 0, .deltaLogDir = NULL, .coldBlockMinutes = 0, .backfillDocsPerSec = 5000, .queryCostBudget = 0, .queryCostDegrade = 0, .slowlogThresholdMs = 0, .replicateEffects = 0, .spellcheckFreqThreshold = 1, .cnDictCache = NULL,                        \
+    .resultCacheTTLMS = 0,                                                                      \
   }
 
 #endif
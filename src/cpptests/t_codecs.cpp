@@ -0,0 +1,161 @@
+#include "../buffer.h"
+#include "../inverted_index.h"
+#include "../index_result.h"
+#include "../varint.h"
+#include "../qint.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+class CodecsTest : public ::testing::Test {};
+
+// Every on-disk posting encoder/decoder pair must round-trip its postings
+// exactly, across delta shapes from dense runs to sparse jumps
+TEST_F(CodecsTest, testEncoderDecoderRoundTrip) {
+  static const uint32_t flagCombos[] = {
+      Index_StoreFreqs | Index_StoreTermOffsets | Index_StoreFieldFlags,
+      Index_StoreFreqs | Index_StoreTermOffsets | Index_StoreFieldFlags | Index_WideSchema,
+      Index_StoreFreqs | Index_StoreFieldFlags,
+      Index_StoreFreqs | Index_StoreFieldFlags | Index_WideSchema,
+      Index_StoreFreqs,
+      Index_StoreFieldFlags,
+      Index_StoreFieldFlags | Index_WideSchema,
+      Index_StoreFieldFlags | Index_StoreTermOffsets,
+      Index_StoreFieldFlags | Index_StoreTermOffsets | Index_WideSchema,
+      Index_StoreTermOffsets,
+      Index_StoreFreqs | Index_StoreTermOffsets,
+      Index_DocIdsOnly,
+      Index_DocIdsOnly | Index_PackedDocIds,
+  };
+  static const uint32_t deltas[] = {1, 1, 1, 5, 16, 100, 255, 256, 10000, 1 << 20, 3, 1};
+  const size_t N = sizeof(deltas) / sizeof(deltas[0]);
+
+  for (size_t ci = 0; ci < sizeof(flagCombos) / sizeof(flagCombos[0]); ++ci) {
+    uint32_t flags = flagCombos[ci];
+    IndexEncoder enc = InvertedIndex_GetEncoder((IndexFlags)flags);
+    IndexDecoderProcs procs = InvertedIndex_GetDecoder(flags);
+    ASSERT_TRUE(enc != NULL) << "no encoder for flags " << flags;
+    ASSERT_TRUE(procs.decoder != NULL) << "no decoder for flags " << flags;
+
+    RSIndexResult *rec = NewTokenRecord(NULL, 1);
+    rec->freq = 7;
+    rec->fieldMask = (flags & Index_WideSchema) ? ((t_fieldMask)1 << 40) : 0x15;
+
+    VarintVectorWriter vvwStorage, *vvw = &vvwStorage;
+    VVW_Init(vvw, 16);
+    for (uint32_t p = 1; p <= 4; ++p) {
+      VVW_Write(vvw, p * 3);
+    }
+    VVW_Truncate(vvw);
+    rec->term.offsets.data = VVW_GetByteData(vvw);
+    rec->term.offsets.len = VVW_GetByteLength(vvw);
+    rec->offsetsSz = rec->term.offsets.len;
+
+    Buffer buf;
+    Buffer_Init(&buf, 64);
+    BufferWriter bw = NewBufferWriter(&buf);
+    for (size_t i = 0; i < N; ++i) {
+      size_t sz = enc(&bw, deltas[i], rec);
+      ASSERT_GT(sz, 0) << "flags " << flags;
+    }
+
+    RSIndexResult *out = NewTokenRecord(NULL, 1);
+    IndexDecoderCtx dctx = {};
+    dctx.num = RS_FIELDMASK_ALL;
+    BufferReader br = NewBufferReader(&buf);
+    size_t decoded = 0;
+    while (!BufferReader_AtEnd(&br)) {
+      ASSERT_TRUE(procs.decoder(&br, &dctx, out)) << "flags " << flags;
+      // decoders emit the raw delta; it must match what was encoded
+      ASSERT_EQ(deltas[decoded], *(uint32_t *)&out->docId) << "flags " << flags << " at "
+                                                           << decoded;
+      if (flags & Index_StoreFreqs) {
+        ASSERT_EQ(7, out->freq);
+      }
+      if (flags & Index_StoreFieldFlags) {
+        ASSERT_EQ(rec->fieldMask, out->fieldMask);
+      }
+      decoded++;
+    }
+    ASSERT_EQ(N, decoded) << "flags " << flags;
+
+    Buffer_Free(&buf);
+    VVW_Cleanup(vvw);
+    rec->term.offsets.data = NULL;
+    rec->term.offsets.len = 0;
+    IndexResult_Free(rec);
+    IndexResult_Free(out);
+  }
+}
+
+// The packed (Elias-Fano) offset vectors must decode to the same positions
+// the varint form was given, through Next, SkipTo and Rewind alike
+TEST_F(CodecsTest, testPackedOffsets) {
+  std::vector<uint32_t> positions;
+  uint32_t at = 0;
+  for (int i = 0; i < 200; ++i) {
+    at += 1 + (i * 7) % 23;
+    positions.push_back(at);
+  }
+
+  Buffer packed;
+  Buffer_Init(&packed, 64);
+  size_t len = OffsetVector_PackedEncode(&positions[0], positions.size(), &packed);
+  ASSERT_GT(len, 0);
+  RSOffsetVector v = {packed.data, (uint32_t)packed.offset};
+  ASSERT_TRUE(OffsetVector_IsPacked(&v));
+
+  EFOffsetReader rd;
+  ASSERT_TRUE(EFOffsetReader_Init(&rd, v.data, v.len));
+  for (size_t i = 0; i < positions.size(); ++i) {
+    ASSERT_EQ(positions[i], EFOffsetReader_Next(&rd)) << "at " << i;
+  }
+  ASSERT_EQ(RS_OFFSETVECTOR_EOF, EFOffsetReader_Next(&rd));
+
+  // SkipTo lands on the first position >= target, Rewind restarts
+  EFOffsetReader_Rewind(&rd);
+  for (size_t i = 0; i < positions.size(); i += 17) {
+    EFOffsetReader_Rewind(&rd);
+    ASSERT_EQ(positions[i], EFOffsetReader_SkipTo(&rd, positions[i]));
+  }
+  EFOffsetReader_Rewind(&rd);
+  ASSERT_EQ(positions[0], EFOffsetReader_SkipTo(&rd, 1));
+  EFOffsetReader_Rewind(&rd);
+  ASSERT_EQ(RS_OFFSETVECTOR_EOF, EFOffsetReader_SkipTo(&rd, positions.back() + 1));
+
+  // a corrupt blob must fail Init instead of parsing garbage
+  EFOffsetReader bad;
+  char junk[3] = {0, 1, 2};
+  EXPECT_FALSE(EFOffsetReader_Init(&bad, junk, 0));
+
+  Buffer_Free(&packed);
+}
+
+// qint groups carry 1-4 integers; every width combination must round-trip
+TEST_F(CodecsTest, testQint) {
+  static const uint32_t vals[] = {0, 1, 0xff, 0x100, 0xffff, 0x10000, 0xffffff, 0x1000000,
+                                  0xffffffff};
+  const size_t NV = sizeof(vals) / sizeof(vals[0]);
+
+  for (size_t a = 0; a < NV; ++a) {
+    for (size_t b = 0; b < NV; b += 2) {
+      Buffer buf;
+      Buffer_Init(&buf, 32);
+      BufferWriter bw = NewBufferWriter(&buf);
+      uint32_t in[4] = {vals[a], vals[b], vals[(a + b) % NV], vals[(a * 3 + 1) % NV]};
+      uint32_t expected[4];
+      memcpy(expected, in, sizeof(in));
+      // qint_encode shifts its input array down to nothing as it writes
+      ASSERT_GT(qint_encode(&bw, in, 4), 0);
+
+      uint32_t out[4] = {0};
+      BufferReader br = NewBufferReader(&buf);
+      qint_decode(&br, out, 4);
+      for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(expected[i], out[i]);
+      }
+      Buffer_Free(&buf);
+    }
+  }
+}
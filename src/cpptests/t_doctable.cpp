@@ -0,0 +1,113 @@
+#include "../doc_table.h"
+#include "../config.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <set>
+
+class DocTableTest : public ::testing::Test {};
+
+// The id map and metadata storage must stay consistent through growth,
+// lookups by both directions, and binary keys
+TEST_F(DocTableTest, testPutGetConsistency) {
+  DocTable dt = NewDocTable(8, 100000);
+  const size_t N = 5000;
+  std::set<t_docId> seen;
+
+  for (size_t i = 0; i < N; ++i) {
+    char buf[64];
+    size_t n = snprintf(buf, sizeof buf, "key-%zu", i);
+    t_docId id = DocTable_Put(&dt, buf, n, i * 0.5, 0, NULL, 0);
+    ASSERT_NE(0, id);
+    ASSERT_TRUE(seen.insert(id).second) << "duplicate id " << id;
+
+    // duplicate put must not mint a second id
+    ASSERT_EQ(0, DocTable_Put(&dt, buf, n, 1.0, 0, NULL, 0));
+  }
+  ASSERT_EQ(N, dt.size - 1);  // slot 0 is reserved
+
+  for (size_t i = 0; i < N; ++i) {
+    char buf[64];
+    size_t n = snprintf(buf, sizeof buf, "key-%zu", i);
+    t_docId id = DocTable_GetId(&dt, buf, n);
+    ASSERT_NE(0, id);
+    // Get returns a borrowed pointer, valid while the table holds the doc
+    RSDocumentMetadata *dmd = DocTable_Get(&dt, id);
+    ASSERT_TRUE(dmd != NULL);
+    size_t klen;
+    const char *kp = DMD_KeyPtrLen(dmd, &klen);
+    ASSERT_EQ(n, klen);
+    ASSERT_EQ(0, memcmp(kp, buf, n));
+    ASSERT_EQ((float)(i * 0.5), dmd->score);
+  }
+
+  // unknown keys resolve to 0, out-of-range ids to NULL
+  ASSERT_EQ(0, DocTable_GetId(&dt, "nope", 4));
+  ASSERT_TRUE(DocTable_Get(&dt, N + 100) == NULL);
+
+  DocTable_Free(&dt);
+}
+
+TEST_F(DocTableTest, testDeleteAndRefcounts) {
+  DocTable dt = NewDocTable(8, 100000);
+
+  t_docId id = DocTable_Put(&dt, "doomed", 6, 1.0, 0, NULL, 0);
+  ASSERT_NE(0, id);
+
+  // hold a reference across the delete, as a parked reader would; Get only
+  // borrows, so take one explicitly
+  RSDocumentMetadata *held = DocTable_Get(&dt, id);
+  ASSERT_TRUE(held != NULL);
+  DMD_Incref(held);
+
+  ASSERT_EQ(1, DocTable_Delete(&dt, "doomed", 6));
+  ASSERT_TRUE(DMD_Flags(held) & Document_Deleted);
+  // the key no longer resolves, and the id no longer yields metadata
+  ASSERT_EQ(0, DocTable_GetId(&dt, "doomed", 6));
+  ASSERT_TRUE(DocTable_Get(&dt, id) == NULL);
+  // deleting twice is a no-op
+  ASSERT_EQ(0, DocTable_Delete(&dt, "doomed", 6));
+
+  // the held reference stays readable until released
+  size_t klen;
+  const char *kp = DMD_KeyPtrLen(held, &klen);
+  ASSERT_EQ(6, klen);
+  ASSERT_EQ(0, memcmp(kp, "doomed", 6));
+  DMD_Decref(held);
+
+  // the key can be indexed again under a fresh id
+  t_docId id2 = DocTable_Put(&dt, "doomed", 6, 2.0, 0, NULL, 0);
+  ASSERT_NE(0, id2);
+  ASSERT_NE(id, id2);
+
+  DocTable_Free(&dt);
+}
+
+// Binary keys (embedded NULs) and keys longer than the id-map's inline
+// bucket storage must round-trip like short printable ones
+TEST_F(DocTableTest, testBinaryAndLongKeys) {
+  DocTable dt = NewDocTable(8, 100000);
+
+  static const char bin[] = "bin\x00key\x01with\x02nuls";
+  const size_t binLen = sizeof(bin) - 1;
+  t_docId binId = DocTable_Put(&dt, bin, binLen, 1.0, 0, NULL, 0);
+  ASSERT_NE(0, binId);
+  ASSERT_EQ(binId, DocTable_GetId(&dt, bin, binLen));
+  // the NUL-prefixed sibling is a different key
+  ASSERT_EQ(0, DocTable_GetId(&dt, bin, binLen - 1));
+
+  std::string lng(DOCIDMAP_INLINE_KEYLEN * 5, 'x');
+  lng += "-tail";
+  t_docId longId = DocTable_Put(&dt, lng.data(), lng.size(), 1.0, 0, NULL, 0);
+  ASSERT_NE(0, longId);
+  ASSERT_EQ(longId, DocTable_GetId(&dt, lng.data(), lng.size()));
+
+  RSDocumentMetadata *dmd = DocTable_Get(&dt, longId);
+  ASSERT_TRUE(dmd != NULL);
+  size_t klen;
+  const char *kp = DMD_KeyPtrLen(dmd, &klen);
+  ASSERT_EQ(lng.size(), klen);
+  ASSERT_EQ(0, memcmp(kp, lng.data(), klen));
+
+  DocTable_Free(&dt);
+}
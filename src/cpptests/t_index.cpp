@@ -640,12 +640,14 @@ TEST_F(IndexTest, testBuffer) {
 
   ASSERT_TRUE(l == strlen(x) + 1);
   ASSERT_TRUE(Buffer_Offset(w.buf) == l);
-  ASSERT_EQ(Buffer_Capacity(w.buf), 14);
+  // double-while-small growth: 2 grows by MAX(cap, 16) to 18 on first write
+  ASSERT_EQ(Buffer_Capacity(w.buf), 18);
 
   l = WriteVarint(1337654, &w);
   ASSERT_TRUE(l == 3);
   ASSERT_EQ(Buffer_Offset(w.buf), 15);
-  ASSERT_EQ(Buffer_Capacity(w.buf), 17);
+  // the varint fits in the existing slack, no further growth
+  ASSERT_EQ(Buffer_Capacity(w.buf), 18);
 
   Buffer_Truncate(w.buf, 0);
 
@@ -976,27 +978,27 @@ TEST_F(IndexTest, testDocTable) {
     RSDocumentMetadata *dmd = DocTable_Get(&dt, i + 1);
     DMD_Incref(dmd);
     ASSERT_TRUE(dmd != NULL);
-    ASSERT_TRUE(dmd->flags & Document_HasPayload);
+    ASSERT_TRUE(DMD_Flags(dmd) & Document_HasPayload);
     ASSERT_STREQ(dmd->keyPtr, buf);
     char *pl = dmd->payload->data;
     ASSERT_TRUE(!(strncmp(pl, (char *)buf, dmd->payload->len)));
 
     ASSERT_EQ((int)dmd->score, i);
-    ASSERT_EQ((int)dmd->flags, (int)(Document_DefaultFlags | Document_HasPayload));
+    ASSERT_EQ((int)DMD_Flags(dmd), (int)(Document_DefaultFlags | Document_HasPayload));
 
-    t_docId xid = DocIdMap_Get(&dt.dim, buf, strlen(buf));
+    t_docId xid = DocIdMap_Get(&dt.dim, &dt, buf, strlen(buf));
 
     ASSERT_EQ((int)xid, i + 1);
 
     int rc = DocTable_Delete(&dt, dmd->keyPtr, sdslen(dmd->keyPtr));
     ASSERT_EQ(1, rc);
-    ASSERT_TRUE((int)(dmd->flags & Document_Deleted));
+    ASSERT_TRUE((int)(DMD_Flags(dmd) & Document_Deleted));
     DMD_Decref(dmd);
     dmd = DocTable_Get(&dt, i + 1);
     ASSERT_TRUE(!dmd);
   }
 
-  ASSERT_FALSE(DocIdMap_Get(&dt.dim, "foo bar", strlen("foo bar")));
+  ASSERT_FALSE(DocIdMap_Get(&dt.dim, &dt, "foo bar", strlen("foo bar")));
   ASSERT_FALSE(DocTable_Get(&dt, N + 2));
 
   t_docId strDocId = DocTable_Put(&dt, "Hello", 5, 1.0, 0, NULL, 0);
@@ -1005,12 +1007,12 @@ TEST_F(IndexTest, testDocTable) {
   // Test that binary keys also work here
   static const char binBuf[] = {"Hello\x00World"};
   const size_t binBufLen = 11;
-  ASSERT_FALSE(DocIdMap_Get(&dt.dim, binBuf, binBufLen));
+  ASSERT_FALSE(DocIdMap_Get(&dt.dim, &dt, binBuf, binBufLen));
   t_docId binDocId = DocTable_Put(&dt, binBuf, binBufLen, 1.0, 0, NULL, 0);
   ASSERT_TRUE(binDocId);
   ASSERT_NE(binDocId, strDocId);
-  ASSERT_EQ(binDocId, DocIdMap_Get(&dt.dim, binBuf, binBufLen));
-  ASSERT_EQ(strDocId, DocIdMap_Get(&dt.dim, "Hello", 5));
+  ASSERT_EQ(binDocId, DocIdMap_Get(&dt.dim, &dt, binBuf, binBufLen));
+  ASSERT_EQ(strDocId, DocIdMap_Get(&dt.dim, &dt, "Hello", 5));
   DocTable_Free(&dt);
 }
 
@@ -1041,7 +1043,8 @@ TEST_F(IndexTest, testSortable) {
   ASSERT_TRUE(RSValue_IsNull(v->values[0]));
   RSSortingVector_Put(v, 0, str, RS_SORTABLE_STR);
   ASSERT_EQ(v->values[0]->t, RSValue_String);
-  ASSERT_EQ(v->values[0]->strval.stype, RSString_RMAlloc);
+  // short sortables are stored in the value's inline slot
+  ASSERT_EQ(v->values[0]->strval.stype, RSString_Inline);
 
   ASSERT_TRUE(RSValue_IsNull(v->values[1]));
   ASSERT_TRUE(RSValue_IsNull(v->values[2]));
@@ -396,3 +396,54 @@ TEST_F(QueryTest, testTags) {
   ASSERT_STREQ("lorem ipsum", n->tag.children[3]->tn.str);
   IndexSpec_Free(ctx.spec);
 }
+
+// The parsed-plan cache must serve the same tree shape on repeat parses,
+// stay out of spec-less parses, and stop matching after a schema change
+TEST_F(QueryTest, testPlanCache) {
+  static const char *args[] = {"SCHEMA", "title", "text", "body", "text"};
+  QueryError err = {QueryErrorCode(0)};
+  IndexSpec *spec = IndexSpec_Parse("idx", args, sizeof(args) / sizeof(*args), &err);
+  ASSERT_FALSE(QueryError_HasError(&err)) << QueryError_GetError(&err);
+  RedisSearchCtx ctx = SEARCH_CTX_STATIC(NULL, spec);
+
+  const char *q = "hello @title:world moon";
+  QueryNodeType rootType;
+  size_t nTokens;
+  {
+    QASTCXX first(ctx);
+    ASSERT_TRUE(first.parse(q)) << first.getError();
+    rootType = first.root->type;
+    nTokens = first.numTokens;
+  }
+  // repeat parse comes from the cache: same shape, same token accounting
+  for (int i = 0; i < 3; ++i) {
+    QASTCXX again(ctx);
+    ASSERT_TRUE(again.parse(q)) << again.getError();
+    ASSERT_EQ(rootType, again.root->type);
+    ASSERT_EQ(nTokens, again.numTokens);
+  }
+
+  // a spec-less parse (the extension API path: unfielded queries) must work
+  // and stay uncached
+  {
+    SearchOptionsCXX opts;
+    QueryAST qast = {0};
+    QueryError qerr = {QueryErrorCode(0)};
+    const char *plain = "hello world moon";
+    ASSERT_EQ(REDISMODULE_OK, QAST_Parse(&qast, NULL, &opts, plain, strlen(plain), &qerr));
+    ASSERT_TRUE(qast.root != NULL);
+    QAST_Destroy(&qast);
+  }
+
+  // a schema change bumps the epoch, so cached plans stop being served
+  uint64_t before = spec->schemaEpoch;
+  spec->schemaEpoch++;
+  {
+    QASTCXX fresh(ctx);
+    ASSERT_TRUE(fresh.parse(q)) << fresh.getError();
+    ASSERT_EQ(rootType, fresh.root->type);
+  }
+  spec->schemaEpoch = before;
+
+  IndexSpec_Free(spec);
+}
@@ -0,0 +1,135 @@
+#include "../spec.h"
+#include "../search_ctx.h"
+#include "../document.h"
+#include "../index_snapshot.h"
+#include "../config.h"
+#include "../redis_index.h"
+#include "../inverted_index.h"
+#include "redismock/util.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <set>
+
+class SnapshotTest : public ::testing::Test {};
+
+static void snapDoneCb(RSAddDocumentCtx *, RedisModuleCtx *, void *) {}
+
+static void snapAddDoc(RedisModuleCtx *ctx, IndexSpec *sp, const char *docid, const char *body) {
+  RMCK::ArgvList argv(ctx, "t1", body);
+  AddDocumentOptions options = {0};
+  options.options |= DOCUMENT_ADD_CURTHREAD;
+  options.numFieldElems = argv.size();
+  options.fieldsArray = argv;
+  options.donecb = snapDoneCb;
+  QueryError status = {QueryErrorCode(0)};
+  RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, sp);
+  RS_AddDocument(&sctx, RedisModule_CreateString(ctx, docid, strlen(docid)), &options, &status);
+  ASSERT_FALSE(QueryError_HasError(&status)) << QueryError_GetError(&status);
+}
+
+/* Find a term's inverted index by key suffix: snapshot keys embed the name
+ * of the spec that SAVED them, so this works across a reload into a spec
+ * created under a different name */
+static InvertedIndex *snapFindTermIndex(IndexSpec *sp, const char *term) {
+  if (!sp->termsDict) {
+    return NULL;
+  }
+  char suffix[128];
+  size_t sl = snprintf(suffix, sizeof suffix, "/%s", term);
+  dictIterator *it = dictGetIterator(sp->termsDict);
+  dictEntry *de;
+  InvertedIndex *found = NULL;
+  while ((de = dictNext(it)) != NULL) {
+    size_t kl;
+    const char *k = RedisModule_StringPtrLen((RedisModuleString *)dictGetKey(de), &kl);
+    if (kl >= sl && memcmp(k + kl - sl, suffix, sl) == 0) {
+      KeysDictValue *kdv = (KeysDictValue *)dictGetVal(de);
+      found = (InvertedIndex *)kdv->p;
+      break;
+    }
+  }
+  dictReleaseIterator(it);
+  return found;
+}
+
+/* Collect the docIds a term's postings decode to; the snapshot restores the
+ * term dictionary, so this is the layer it must reproduce bit-exactly */
+static std::vector<t_docId> snapTermDocs(RedisModuleCtx *ctx, IndexSpec *sp, const char *term) {
+  std::vector<t_docId> out;
+  InvertedIndex *idx = snapFindTermIndex(sp, term);
+  if (!idx) {
+    return out;
+  }
+  IndexReader *ir = NewTermIndexReader(idx, sp, RS_FIELDMASK_ALL, NULL, 1);
+  RSIndexResult *r = NULL;
+  while (IR_Read(ir, &r) != INDEXREAD_EOF) {
+    out.push_back(r->docId);
+  }
+  IR_Free(ir);
+  return out;
+}
+
+// The RSIX snapshot blob must rebuild the term dictionary into an index that
+// answers queries identically, and reject corrupt blobs without loading
+TEST_F(SnapshotTest, testSaveLoadRoundTrip) {
+  RSGlobalConfig.termsInSpec = 1;
+
+  RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+  QueryError qerr = {QueryErrorCode(0)};
+  RMCK::ArgvList args(ctx, "FT.CREATE", "snapidx", "SCHEMA", "t1", "TEXT");
+  IndexSpec *sp = IndexSpec_CreateNew(ctx, args, args.size(), &qerr);
+  ASSERT_TRUE(sp != NULL);
+
+  for (int i = 0; i < 300; i++) {
+    char key[32], body[96];
+    snprintf(key, sizeof key, "doc%04d", i);
+    snprintf(body, sizeof body, "common term%04d %s", i, (i % 10 == 0) ? "decim" : "plain");
+    snapAddDoc(ctx, sp, key, body);
+  }
+
+  std::vector<t_docId> commonBefore = snapTermDocs(ctx, sp, "common");
+  std::vector<t_docId> decimBefore = snapTermDocs(ctx, sp, "decim");
+  ASSERT_EQ(300, commonBefore.size());
+  ASSERT_EQ(30, decimBefore.size());
+
+  size_t blobLen = 0;
+  char *blob = IndexSnapshot_Save(sp, &blobLen);
+  ASSERT_TRUE(blob != NULL);
+  ASSERT_GT(blobLen, 0);
+
+  IndexSpec_FreeWithKey(sp, ctx);
+
+  // header corruption must be refused without crashing, ownership staying
+  // with the caller; a flip that only grazes payload bytes may load, in
+  // which case the arena is detached before the stack copy dies
+  for (size_t cut = 0; cut < 64 && cut < blobLen; cut += 13) {
+    std::vector<char> copy(blob, blob + blobLen);
+    copy[cut] ^= 0x5a;
+    char fname[64];
+    snprintf(fname, sizeof fname, "snapcorrupt%zu", cut);
+    RMCK::ArgvList fargs(ctx, "FT.CREATE", fname, "SCHEMA", "t1", "TEXT");
+    IndexSpec *fresh = IndexSpec_CreateNew(ctx, fargs, fargs.size(), &qerr);
+    ASSERT_TRUE(fresh != NULL) << QueryError_GetError(&qerr);
+    int rc = IndexSnapshot_Load(ctx, fresh, &copy[0], blobLen);
+    if (rc == REDISMODULE_OK) {
+      fresh->snapshotArena = NULL;
+    }
+    IndexSpec_FreeWithKey(fresh, ctx);
+    QueryError_ClearError(&qerr);
+  }
+
+  // a clean reload over a fresh spec of the same shape serves the same docs
+  RMCK::ArgvList args2(ctx, "FT.CREATE", "snapidx2", "SCHEMA", "t1", "TEXT");
+  IndexSpec *sp2 = IndexSpec_CreateNew(ctx, args2, args2.size(), &qerr);
+  ASSERT_TRUE(sp2 != NULL);
+  char *heapBlob = (char *)rm_malloc(blobLen);
+  memcpy(heapBlob, blob, blobLen);
+  rm_free(blob);
+  ASSERT_EQ(REDISMODULE_OK, IndexSnapshot_Load(ctx, sp2, heapBlob, blobLen));
+
+  ASSERT_EQ(commonBefore, snapTermDocs(ctx, sp2, "common"));
+  ASSERT_EQ(decimBefore, snapTermDocs(ctx, sp2, "decim"));
+
+  IndexSpec_FreeWithKey(sp2, ctx);
+}
@@ -25,7 +25,9 @@ TEST_F(TagIndexTest, testCreate) {
   }
 
   ASSERT_EQ(v.size(), idx->values->cardinality);
-  ASSERT_EQ(300000, totalSZ);
+  // 1 byte per posting plus the packed-container tag byte each block opens
+  // with (tag postings are Index_PackedDocIds)
+  ASSERT_EQ(303000, totalSZ);
 
   IndexIterator *it = TagIndex_OpenReader(idx, NULL, "hello", 5, 1);
   ASSERT_TRUE(it != NULL);
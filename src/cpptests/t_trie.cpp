@@ -1,3 +1,4 @@
+#include "../rmalloc.h"
 #include <gtest/gtest.h>
 #include <trie/trie.h>
 #include <trie/trie_type.h>
@@ -105,4 +106,42 @@ TEST_F(TrieTest, testDeepEntry) {
   auto ret = trieIterRange(t, "1", "1Z");
   ASSERT_EQ(maxbuf, ret.size());
   TrieType_Free(t);
-}
\ No newline at end of file
+}
+
+// The snapshot trie image must rebuild an identical term set, and reject
+// truncated blobs instead of walking off them
+TEST_F(TrieTest, testSerializeImage) {
+  Trie *t = NewTrie();
+  const char *words[] = {"alpha", "alphabet", "beta", "betamax", "gamma", "g", "中文词"};
+  const size_t NW = sizeof(words) / sizeof(words[0]);
+  for (size_t i = 0; i < NW; ++i) {
+    ASSERT_TRUE(trieInsert(t, words[i]));
+  }
+
+  size_t blobLen = 0;
+  char *blob = TrieType_SerializeImage(t, &blobLen);
+  ASSERT_TRUE(blob != NULL);
+  ASSERT_GT(blobLen, 0);
+
+  Trie *t2 = TrieType_DeserializeImage(blob, blobLen);
+  ASSERT_TRUE(t2 != NULL);
+  ASSERT_EQ(t->size, t2->size);
+  // every term is reachable in the rebuilt trie: a full-range walk sees the
+  // same set
+  ElemSet orig = trieIterRange(t, NULL, NULL);
+  ElemSet rebuilt = trieIterRange(t2, NULL, NULL);
+  ASSERT_EQ(orig, rebuilt);
+  ASSERT_EQ(NW, orig.size());
+
+  // truncated images must fail cleanly
+  for (size_t cut = 0; cut < blobLen; cut += blobLen / 7 + 1) {
+    Trie *bad = TrieType_DeserializeImage(blob, cut);
+    if (bad) {
+      TrieType_Free(bad);
+    }
+  }
+
+  rm_free(blob);
+  TrieType_Free(t);
+  TrieType_Free(t2);
+}
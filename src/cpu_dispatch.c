@@ -0,0 +1,52 @@
+#include "cpu_dispatch.h"
+#include <stddef.h>
+
+static RSCpuLevel level_g;
+static int detected_g;
+
+RSCpuLevel RSCpu_Level(void) {
+  if (detected_g) {
+    return level_g;
+  }
+  RSCpuLevel lvl = RS_CPU_BASELINE;
+#if defined(__x86_64__) || defined(__i386__)
+  if (__builtin_cpu_supports("ssse3")) lvl = RS_CPU_SSSE3;
+  if (__builtin_cpu_supports("sse4.2")) lvl = RS_CPU_SSE4;
+  if (__builtin_cpu_supports("avx")) lvl = RS_CPU_AVX;
+  if (__builtin_cpu_supports("avx2")) lvl = RS_CPU_AVX2;
+  if (__builtin_cpu_supports("avx512f")) lvl = RS_CPU_AVX512;
+#endif
+  level_g = lvl;
+  detected_g = 1;
+  return level_g;
+}
+
+const char *RSCpu_LevelName(void) {
+  switch (RSCpu_Level()) {
+    case RS_CPU_BASELINE: return "baseline";
+    case RS_CPU_SSSE3: return "ssse3";
+    case RS_CPU_SSE4: return "sse4.2";
+    case RS_CPU_AVX: return "avx";
+    case RS_CPU_AVX2: return "avx2";
+    case RS_CPU_AVX512: return "avx512";
+  }
+  return "unknown";
+}
+
+#define MAX_DISPATCH_INITS 32
+
+static RSCpuDispatchInit inits_g[MAX_DISPATCH_INITS];
+static int numInits_g;
+
+void RSCpu_RegisterDispatch(RSCpuDispatchInit fn) {
+  if (numInits_g < MAX_DISPATCH_INITS) {
+    inits_g[numInits_g++] = fn;
+  }
+  fn();
+}
+
+void RSCpu_InitDispatch(void) {
+  for (int i = 0; i < numInits_g; i++) {
+    inits_g[i]();
+  }
+}
@@ -0,0 +1,45 @@
+#ifndef RS_CPU_DISPATCH_H_
+#define RS_CPU_DISPATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Runtime CPU feature selection for the multi-versioned hot kernels (qint
+ * decode, tokenizer separator scan, batch scorers, ...). Kernels are compiled
+ * per-function with __attribute__((target(...))) so one artifact carries
+ * every variant; at runtime each call site reads a function pointer or flag
+ * chosen from the detected level.
+ *
+ * A kernel's home TU defines an init function assigning its pointers/flags
+ * from RSCpu_Level() and registers it with RSCpu_RegisterDispatch from a
+ * constructor. Registration runs the init immediately - standalone binaries
+ * get their variants without module load - and RSCpu_InitDispatch re-runs
+ * all of them at RedisModule_OnLoad, where the chosen level is also logged.
+ */
+typedef enum {
+  RS_CPU_BASELINE = 0,
+  RS_CPU_SSSE3,
+  RS_CPU_SSE4,
+  RS_CPU_AVX,
+  RS_CPU_AVX2,
+  RS_CPU_AVX512,
+} RSCpuLevel;
+
+/* Highest level the running CPU supports; detected once and cached */
+RSCpuLevel RSCpu_Level(void);
+
+const char *RSCpu_LevelName(void);
+
+typedef void (*RSCpuDispatchInit)(void);
+
+void RSCpu_RegisterDispatch(RSCpuDispatchInit fn);
+
+/* Re-run every registered kernel init. Called at module load */
+void RSCpu_InitDispatch(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,7 +3,7 @@
 #include <assert.h>
 #include <err.h>
 
-#define Cursor_IsIdle(cur) ((cur)->pos != -1)
+#define Cursor_IsIdle(cur) (__atomic_load_n(&(cur)->state, __ATOMIC_ACQUIRE) == CURSOR_IDLE)
 CursorList RSCursors;
 
 static uint64_t curTimeNs() {
@@ -12,22 +12,58 @@ static uint64_t curTimeNs() {
   return tv.tv_nsec + (tv.tv_sec * 1000000000);
 }
 
-static void CursorList_Lock(CursorList *cl) {
-  pthread_mutex_lock(&cl->lock);
+static CursorShard *cursorShard(CursorList *cl, uint64_t cid) {
+  return &cl->shards[cid % RSCURSORS_NUM_SHARDS];
 }
 
-static void CursorList_Unlock(CursorList *cl) {
-  pthread_mutex_unlock(&cl->lock);
+static void CursorShard_Lock(CursorShard *sh) {
+  pthread_mutex_lock(&sh->lock);
+}
+
+static void CursorShard_Unlock(CursorShard *sh) {
+  pthread_mutex_unlock(&sh->lock);
 }
 
 void CursorList_Init(CursorList *cl) {
   memset(cl, 0, sizeof(*cl));
-  pthread_mutex_init(&cl->lock, NULL);
-  cl->lookup = kh_init(cursors);
-  Array_Init(&cl->idle);
+  for (size_t ii = 0; ii < RSCURSORS_NUM_SHARDS; ++ii) {
+    CursorShard *sh = &cl->shards[ii];
+    pthread_mutex_init(&sh->lock, NULL);
+    sh->lookup = kh_init(cursors);
+  }
   srand48(getpid());
 }
 
+/* Slot index a cursor id probes from. The shard selector consumed the id's
+ * low bits; mix the rest */
+static size_t cursorSlot(uint64_t cid) {
+  return (cid / RSCURSORS_NUM_SHARDS) % RSCURSORS_SHARD_SLOTS;
+}
+
+/* Under the shard lock: publish/retract the cursor in the fast-lookup slots */
+static void shardSlotInsert(CursorShard *sh, Cursor *cur) {
+  size_t at = cursorSlot(cur->id);
+  for (size_t i = 0; i < RSCURSORS_SHARD_SLOTS; ++i) {
+    size_t slot = (at + i) % RSCURSORS_SHARD_SLOTS;
+    if (__atomic_load_n(&sh->slots[slot], __ATOMIC_RELAXED) == NULL) {
+      __atomic_store_n(&sh->slots[slot], cur, __ATOMIC_RELEASE);
+      return;
+    }
+  }
+  // full - the cursor is reachable through the hash table's locked path only
+}
+
+static void shardSlotRemove(CursorShard *sh, Cursor *cur) {
+  size_t at = cursorSlot(cur->id);
+  for (size_t i = 0; i < RSCURSORS_SHARD_SLOTS; ++i) {
+    size_t slot = (at + i) % RSCURSORS_SHARD_SLOTS;
+    if (__atomic_load_n(&sh->slots[slot], __ATOMIC_RELAXED) == cur) {
+      __atomic_store_n(&sh->slots[slot], NULL, __ATOMIC_RELEASE);
+      return;
+    }
+  }
+}
+
 static CursorSpecInfo *findInfo(const CursorList *cl, const char *keyName, size_t *index) {
   for (size_t ii = 0; ii < cl->specsCount; ++ii) {
     if (!strcmp(cl->specs[ii]->keyName, keyName)) {
@@ -40,32 +76,24 @@ static CursorSpecInfo *findInfo(const CursorList *cl, const char *keyName, size_
   return NULL;
 }
 
-static void Cursor_RemoveFromIdle(Cursor *cur) {
-  Array *idle = &cur->parent->idle;
-  Cursor **ll = ARRAY_GETARRAY_AS(idle, Cursor **);
-  size_t n = ARRAY_GETSIZE_AS(idle, Cursor *);
-
-  if (n > 1) {
-    Cursor *last = ll[n - 1]; /** Last cursor - move to current position */
-    last->pos = cur->pos;
-    ll[last->pos] = last;
-  }
-
-  Array_Resize(idle, sizeof(Cursor *) * (n - 1));
-  if (cur->nextTimeoutNs == cur->parent->nextIdleTimeoutNs) {
-    cur->parent->nextIdleTimeoutNs = 0;
+/* Under the shard lock: transition an idle cursor to executing */
+static void Cursor_RemoveFromIdle(CursorShard *sh, Cursor *cur) {
+  __atomic_store_n(&cur->state, CURSOR_EXECUTING, __ATOMIC_RELEASE);
+  sh->numIdle--;
+  if (cur->nextTimeoutNs == sh->nextIdleTimeoutNs) {
+    sh->nextIdleTimeoutNs = 0;
   }
-  cur->pos = -1;
 }
 
 /* Doesn't lock - simply deallocates and decrements */
-static void Cursor_FreeInternal(Cursor *cur, khiter_t khi) {
+static void Cursor_FreeInternal(CursorShard *sh, Cursor *cur, khiter_t khi) {
   /* Decrement the used count */
-  assert(khi != kh_end(cur->parent->lookup));
-  assert(kh_get(cursors, cur->parent->lookup, cur->id) != kh_end(cur->parent->lookup));
-  kh_del(cursors, cur->parent->lookup, khi);
-  assert(kh_get(cursors, cur->parent->lookup, cur->id) == kh_end(cur->parent->lookup));
-  cur->specInfo->used--;
+  assert(khi != kh_end(sh->lookup));
+  assert(kh_get(cursors, sh->lookup, cur->id) != kh_end(sh->lookup));
+  kh_del(cursors, sh->lookup, khi);
+  assert(kh_get(cursors, sh->lookup, cur->id) == kh_end(sh->lookup));
+  shardSlotRemove(sh, cur);
+  __atomic_sub_fetch(&cur->specInfo->used, 1, __ATOMIC_RELAXED);
   if (cur->execState) {
     Cursor_FreeExecState(cur->execState);
     cur->execState = NULL;
@@ -73,24 +101,18 @@ static void Cursor_FreeInternal(Cursor *cur, khiter_t khi) {
   rm_free(cur);
 }
 
-static void Cursors_ForEach(CursorList *cl, void (*callback)(CursorList *, Cursor *, void *),
-                            void *arg) {
-  for (size_t ii = 0; ii < ARRAY_GETSIZE_AS(&cl->idle, Cursor *); ++ii) {
-    Cursor *cur = *ARRAY_GETITEM_AS(&cl->idle, ii, Cursor **);
-    Cursor *oldCur = NULL;
-    /**
-     * The cursor `cur` might have been changed in the callback, if it has been
-     * swapped with another one, as deletion means swapping the last cursor to
-     * the current position. We ensure that we do not 'skip' over this cursor
-     * (effectively skipping over the cursor that was just relocated).
-     */
-
-    while (cur && cur != oldCur) {
-      callback(cl, cur, arg);
-      oldCur = cur;
-      if (cl->idle.len > ii) {
-        cur = *ARRAY_GETITEM_AS(&cl->idle, ii, Cursor **);
-      }
+/* Under the shard lock: visit every idle cursor. The callback may free the
+ * cursor; iteration goes through the hash table, which tolerates deletion of
+ * the current entry */
+static void CursorShard_ForEach(CursorShard *sh, void (*callback)(CursorShard *, Cursor *, void *),
+                                void *arg) {
+  for (khiter_t it = kh_begin(sh->lookup); it != kh_end(sh->lookup); ++it) {
+    if (!kh_exist(sh->lookup, it)) {
+      continue;
+    }
+    Cursor *cur = kh_value(sh->lookup, it);
+    if (Cursor_IsIdle(cur)) {
+      callback(sh, cur, arg);
     }
   }
 }
@@ -100,11 +122,11 @@ typedef struct {
   int numCollected;
 } cursorGcCtx;
 
-static void cursorGcCb(CursorList *cl, Cursor *cur, void *arg) {
+static void cursorGcCb(CursorShard *sh, Cursor *cur, void *arg) {
   cursorGcCtx *ctx = arg;
   if (cur->nextTimeoutNs <= ctx->now) {
-    Cursor_RemoveFromIdle(cur);
-    Cursor_FreeInternal(cur, kh_get(cursors, cl->lookup, cur->id));
+    Cursor_RemoveFromIdle(sh, cur);
+    Cursor_FreeInternal(sh, cur, kh_get(cursors, sh->lookup, cur->id));
     ctx->numCollected++;
   }
 }
@@ -120,24 +142,31 @@ static void cursorGcCb(CursorList *cl, Cursor *cur, void *arg) {
  *
  * Garbage collection is throttled within a given interval as well.
  */
-static int Cursors_GCInternal(CursorList *cl, int force) {
+static int CursorShard_GCInternal(CursorShard *sh, int force) {
   uint64_t now = curTimeNs();
-  if (cl->nextIdleTimeoutNs && cl->nextIdleTimeoutNs > now) {
+  if (sh->nextIdleTimeoutNs && sh->nextIdleTimeoutNs > now) {
     return -1;
-  } else if (!force && now - cl->lastCollect < RSCURSORS_SWEEP_THROTTLE) {
+  } else if (!force && now - sh->lastCollect < RSCURSORS_SWEEP_THROTTLE) {
     return -1;
   }
 
-  cl->lastCollect = now;
+  sh->lastCollect = now;
   cursorGcCtx ctx = {.now = now};
-  Cursors_ForEach(cl, cursorGcCb, &ctx);
+  CursorShard_ForEach(sh, cursorGcCb, &ctx);
   return ctx.numCollected;
 }
 
 int Cursors_CollectIdle(CursorList *cl) {
-  CursorList_Lock(cl);
-  int rc = Cursors_GCInternal(cl, 1);
-  CursorList_Unlock(cl);
+  int rc = 0;
+  for (size_t ii = 0; ii < RSCURSORS_NUM_SHARDS; ++ii) {
+    CursorShard *sh = &cl->shards[ii];
+    CursorShard_Lock(sh);
+    int n = CursorShard_GCInternal(sh, 1);
+    if (n > 0) {
+      rc += n;
+    }
+    CursorShard_Unlock(sh);
+  }
   return rc;
 }
 
@@ -164,18 +193,17 @@ void CursorList_RemoveSpec(CursorList *cl, const char *k) {
   }
 }
 
-static void CursorList_IncrCounter(CursorList *cl) {
-  if (++cl->counter % RSCURSORS_SWEEP_INTERVAL) {
-    Cursors_GCInternal(cl, 0);
+static void CursorShard_IncrCounter(CursorShard *sh) {
+  if (++sh->counter % RSCURSORS_SWEEP_INTERVAL) {
+    CursorShard_GCInternal(sh, 0);
   }
 }
 
 /**
- * Cursor ID is a 64 bit opaque integer. The upper 32 bits consist of the PID
- * of the process which generated the cursor, and the lower 32 bits consist of
- * the counter at the time at which it was generated. This doesn't make it
- * particularly "secure" but it does prevent accidental collisions from both
- * a stuck client and a crashed server
+ * Cursor ID is a 64 bit opaque integer. Generated randomly, it determines the
+ * owning shard (id modulo the shard count). Randomness prevents accidental
+ * collisions from both a stuck client and a crashed server, and spreads a
+ * burst of cursors across the shards.
  */
 static uint64_t CursorList_GenerateId(CursorList *curlist) {
   uint64_t id = lrand48() + 1;  // 0 should never be returned as cursor id
@@ -184,103 +212,144 @@ static uint64_t CursorList_GenerateId(CursorList *curlist) {
 
 Cursor *Cursors_Reserve(CursorList *cl, const char *lookupName, unsigned interval,
                         QueryError *status) {
-  CursorList_Lock(cl);
-  CursorList_IncrCounter(cl);
   CursorSpecInfo *spec = findInfo(cl, lookupName, NULL);
   Cursor *cur = NULL;
 
   if (spec == NULL) {
     QueryError_SetErrorFmt(status, QUERY_ENOINDEX, "Index `%s` does not have cursors enabled",
                            lookupName);
-    goto done;
+    return NULL;
   }
 
-  if (spec->used >= spec->cap) {
-    Cursors_GCInternal(cl, 0);
-    if (spec->used >= spec->cap) {
-      /** Collect idle cursors now */
-      QueryError_SetError(status, QUERY_ELIMIT, "Too many cursors allocated for index");
-      goto done;
+  uint64_t id = CursorList_GenerateId(cl);
+  CursorShard *sh = cursorShard(cl, id);
+  CursorShard_Lock(sh);
+  CursorShard_IncrCounter(sh);
+
+  // Claim a capacity slot first: the atomic reserve-then-check keeps the cap
+  // exact even when shards admit concurrently under different locks
+  if (__atomic_add_fetch(&spec->used, 1, __ATOMIC_RELAXED) > spec->cap) {
+    // This shard's idle timeouts may free up capacity; a full sweep of every
+    // shard happens only if we are still over after it
+    CursorShard_GCInternal(sh, 0);
+    if (__atomic_load_n(&spec->used, __ATOMIC_RELAXED) > spec->cap) {
+      CursorShard_Unlock(sh);
+      Cursors_CollectIdle(cl);
+      CursorShard_Lock(sh);
+      if (__atomic_load_n(&spec->used, __ATOMIC_RELAXED) > spec->cap) {
+        __atomic_sub_fetch(&spec->used, 1, __ATOMIC_RELAXED);
+        QueryError_SetError(status, QUERY_ELIMIT, "Too many cursors allocated for index");
+        goto done;
+      }
     }
   }
 
   cur = rm_calloc(1, sizeof(*cur));
   cur->parent = cl;
   cur->specInfo = spec;
-  cur->id = CursorList_GenerateId(cl);
-  cur->pos = -1;
+  cur->id = id;
+  cur->state = CURSOR_EXECUTING;  // born claimed, idle only after Pause
   cur->timeoutIntervalMs = interval;
 
   int dummy;
-  khiter_t iter = kh_put(cursors, cl->lookup, cur->id, &dummy);
-  kh_value(cl->lookup, iter) = cur;
+  khiter_t iter = kh_put(cursors, sh->lookup, cur->id, &dummy);
+  kh_value(sh->lookup, iter) = cur;
+  shardSlotInsert(sh, cur);
 
 done:
-  if (cur) {
-    cur->specInfo->used++;
-  }
-  CursorList_Unlock(cl);
+  CursorShard_Unlock(sh);
   return cur;
 }
 
 int Cursor_Pause(Cursor *cur) {
-  CursorList *cl = cur->parent;
+  CursorShard *sh = cursorShard(cur->parent, cur->id);
   cur->nextTimeoutNs = curTimeNs() + ((uint64_t)cur->timeoutIntervalMs * 1000000);
 
-  CursorList_Lock(cl);
-  CursorList_IncrCounter(cl);
+  CursorShard_Lock(sh);
+  CursorShard_IncrCounter(sh);
 
-  if (cur->nextTimeoutNs < cl->nextIdleTimeoutNs || cl->nextIdleTimeoutNs == 0) {
-    cl->nextIdleTimeoutNs = cur->nextTimeoutNs;
+  if (cur->nextTimeoutNs < sh->nextIdleTimeoutNs || sh->nextIdleTimeoutNs == 0) {
+    sh->nextIdleTimeoutNs = cur->nextTimeoutNs;
   }
 
-  /* Add to idle list */
-  *(Cursor **)(ARRAY_ADD_AS(&cl->idle, Cursor *)) = cur;
-  cur->pos = ARRAY_GETSIZE_AS(&cl->idle, Cursor **) - 1;
-  CursorList_Unlock(cl);
+  /* Publish as idle - takers may claim it the moment the state lands */
+  sh->numIdle++;
+  __atomic_store_n(&cur->state, CURSOR_IDLE, __ATOMIC_RELEASE);
+  CursorShard_Unlock(sh);
 
   return REDISMODULE_OK;
 }
 
 Cursor *Cursors_TakeForExecution(CursorList *cl, uint64_t cid) {
-  CursorList_Lock(cl);
-  CursorList_IncrCounter(cl);
+  CursorShard *sh = cursorShard(cl, cid);
+
+  // Lock-free fast path: probe the shard's slots and claim the cursor with a
+  // single compare-and-swap. Frees are GIL-serialized with takes, so a slot
+  // observed here cannot point at reclaimed memory
+  size_t at = cursorSlot(cid);
+  for (size_t i = 0; i < RSCURSORS_SHARD_SLOTS; ++i) {
+    Cursor *cand = __atomic_load_n(&sh->slots[(at + i) % RSCURSORS_SHARD_SLOTS], __ATOMIC_ACQUIRE);
+    if (!cand) {
+      break;  // probe chain ends at the first empty slot
+    }
+    if (cand->id != cid) {
+      continue;
+    }
+    uint32_t idle = CURSOR_IDLE;
+    if (!__atomic_compare_exchange_n(&cand->state, &idle, CURSOR_EXECUTING, 0, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE)) {
+      return NULL;  // exists but is already executing
+    }
+    // idle-count and timeout-hint bookkeeping still happens under the lock
+    CursorShard_Lock(sh);
+    sh->numIdle--;
+    if (cand->nextTimeoutNs == sh->nextIdleTimeoutNs) {
+      sh->nextIdleTimeoutNs = 0;
+    }
+    CursorShard_Unlock(sh);
+    return cand;
+  }
+
+  // Slow path: spilled past the slots (or deleted): consult the hash table
+  CursorShard_Lock(sh);
+  CursorShard_IncrCounter(sh);
 
   Cursor *cur = NULL;
-  khiter_t iter = kh_get(cursors, cl->lookup, cid);
-  if (iter != kh_end(cl->lookup)) {
-    cur = kh_value(cl->lookup, iter);
-    if (cur->pos == -1) {
+  khiter_t iter = kh_get(cursors, sh->lookup, cid);
+  if (iter != kh_end(sh->lookup)) {
+    cur = kh_value(sh->lookup, iter);
+    if (!Cursor_IsIdle(cur)) {
       // Cursor is not idle!
       cur = NULL;
     } else {
       // Remove from idle
-      Cursor_RemoveFromIdle(cur);
+      Cursor_RemoveFromIdle(sh, cur);
     }
   }
 
-  CursorList_Unlock(cl);
+  CursorShard_Unlock(sh);
   return cur;
 }
 
 int Cursors_Purge(CursorList *cl, uint64_t cid) {
-  CursorList_Lock(cl);
-  CursorList_IncrCounter(cl);
+  CursorShard *sh = cursorShard(cl, cid);
+  CursorShard_Lock(sh);
+  CursorShard_IncrCounter(sh);
 
   int rc;
-  khiter_t iter = kh_get(cursors, cl->lookup, cid);
-  if (iter != kh_end(cl->lookup)) {
-    Cursor *cur = kh_value(cl->lookup, iter);
+  khiter_t iter = kh_get(cursors, sh->lookup, cid);
+  if (iter != kh_end(sh->lookup)) {
+    Cursor *cur = kh_value(sh->lookup, iter);
     if (Cursor_IsIdle(cur)) {
-      Cursor_RemoveFromIdle(cur);
+      Cursor_RemoveFromIdle(sh, cur);
     }
-    Cursor_FreeInternal(cur, iter);
+    Cursor_FreeInternal(sh, cur, iter);
     rc = REDISMODULE_OK;
 
   } else {
     rc = REDISMODULE_ERR;
   }
-  CursorList_Unlock(cl);
+  CursorShard_Unlock(sh);
   return rc;
 }
 
@@ -289,18 +358,25 @@ int Cursor_Free(Cursor *cur) {
 }
 
 void Cursors_RenderStats(CursorList *cl, const char *name, RedisModuleCtx *ctx) {
-  CursorList_Lock(cl);
   CursorSpecInfo *info = findInfo(cl, name, NULL);
   size_t n = 0;
+  size_t totalIdle = 0, totalOpen = 0;
+  for (size_t ii = 0; ii < RSCURSORS_NUM_SHARDS; ++ii) {
+    CursorShard *sh = &cl->shards[ii];
+    CursorShard_Lock(sh);
+    totalIdle += sh->numIdle;
+    totalOpen += kh_size(sh->lookup);
+    CursorShard_Unlock(sh);
+  }
 
   /** Output total information */
   RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
   RedisModule_ReplyWithSimpleString(ctx, "global_idle");
-  RedisModule_ReplyWithLongLong(ctx, ARRAY_GETSIZE_AS(&cl->idle, Cursor **));
+  RedisModule_ReplyWithLongLong(ctx, totalIdle);
   n += 2;
 
   RedisModule_ReplyWithSimpleString(ctx, "global_total");
-  RedisModule_ReplyWithLongLong(ctx, kh_size(cl->lookup));
+  RedisModule_ReplyWithLongLong(ctx, totalOpen);
   n += 2;
 
   if (info) {
@@ -309,22 +385,21 @@ void Cursors_RenderStats(CursorList *cl, const char *name, RedisModuleCtx *ctx)
     n += 2;
 
     RedisModule_ReplyWithSimpleString(ctx, "index_total");
-    RedisModule_ReplyWithLongLong(ctx, info->used);
+    RedisModule_ReplyWithLongLong(ctx, __atomic_load_n(&info->used, __ATOMIC_RELAXED));
     n += 2;
   }
 
   RedisModule_ReplySetArrayLength(ctx, n);
-  CursorList_Unlock(cl);
 }
 
-static void purgeCb(CursorList *cl, Cursor *cur, void *arg) {
+static void purgeCb(CursorShard *sh, Cursor *cur, void *arg) {
   CursorSpecInfo *info = arg;
   if (cur->specInfo != info) {
     return;
   }
 
-  Cursor_RemoveFromIdle(cur);
-  Cursor_FreeInternal(cur, kh_get(cursors, cl->lookup, cur->id));
+  Cursor_RemoveFromIdle(sh, cur);
+  Cursor_FreeInternal(sh, cur, kh_get(cursors, sh->lookup, cur->id));
 }
 
 void Cursors_PurgeWithName(CursorList *cl, const char *lookupName) {
@@ -332,5 +407,10 @@ void Cursors_PurgeWithName(CursorList *cl, const char *lookupName) {
   if (!info) {
     return;
   }
-  Cursors_ForEach(cl, purgeCb, info);
+  for (size_t ii = 0; ii < RSCURSORS_NUM_SHARDS; ++ii) {
+    CursorShard *sh = &cl->shards[ii];
+    CursorShard_Lock(sh);
+    CursorShard_ForEach(sh, purgeCb, info);
+    CursorShard_Unlock(sh);
+  }
 }
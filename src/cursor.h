@@ -4,9 +4,12 @@
 #include <unistd.h>
 #include <pthread.h>
 #include "util/khash.h"
-#include "util/array.h"
 #include "search_ctx.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef struct {
   char *keyName; /** Name of the key that refers to the spec */
   size_t cap;    /** Maximum number of cursors for the spec */
@@ -37,38 +40,46 @@ typedef struct Cursor {
   /** Initial timeout interval */
   unsigned timeoutIntervalMs;
 
-  /** Position within idle list */
-  int pos;
+  /** Lifecycle state (CURSOR_EXECUTING/CURSOR_IDLE), claimed by compare-and-
+   * swap so the hot take path needs no lock */
+  uint32_t state;
 } Cursor;
 
+#define CURSOR_EXECUTING 0
+#define CURSOR_IDLE 1
+
 KHASH_MAP_INIT_INT64(cursors, Cursor *);
-/**
- * Cursor list. This is the global cursor list and does not distinguish
- * between different specs.
- */
-typedef struct CursorList {
-  /** Cursor lookup by ID */
+
+/* Cursor bookkeeping is sharded by cursor id, so a burst of concurrent
+ * FT.CURSOR READs from the execution pool contends on one shard's lock
+ * rather than a single global one */
+#define RSCURSORS_NUM_SHARDS 16
+
+/* Per-shard lock-free lookup slots: enough for the shard's share of a large
+ * fan-out. Cursors beyond this spill to the hash table and take the locked
+ * path */
+#define RSCURSORS_SHARD_SLOTS 64
+
+typedef struct {
+  /** Cursor lookup by ID; the authoritative map, guarded by `lock` */
   khash_t(cursors) * lookup;
 
-  /** List of spec infos; we just iterate over this */
-  CursorSpecInfo **specs;
-  size_t specsCount;
+  /** Lock-free fast lookup: open-addressed by id hash, written (with atomic
+   * stores) only under `lock`, probed with atomic loads by the take path.
+   * Safe without deferred reclamation because cursor frees and takes are
+   * both GIL-serialized; the slots only ever point at live cursors while a
+   * reader can observe them */
+  Cursor *slots[RSCURSORS_SHARD_SLOTS];
 
-  /** List of idle cursors */
-  Array idle;
+  /** Number of idle cursors, for stats */
+  size_t numIdle;
 
   pthread_mutex_t lock;
 
-  /**
-   * Counter - this serves two purposes:
-   * 1) When counter % n == 0, a GC sweep is performed
-   * 2) Used to calculate a monotonically incrementing cursor ID.
-   */
+  /** When counter % n == 0, a GC sweep of this shard is performed */
   uint32_t counter;
 
-  /**
-   * Last time GC was performed.
-   */
+  /** Last time GC was performed */
   uint64_t lastCollect;
 
   /**
@@ -76,6 +87,20 @@ typedef struct CursorList {
    * This is used as a hint to avoid excessive sweeps.
    */
   uint64_t nextIdleTimeoutNs;
+} CursorShard;
+
+/**
+ * Cursor list. This is the global cursor list and does not distinguish
+ * between different specs.
+ */
+typedef struct CursorList {
+  CursorShard shards[RSCURSORS_NUM_SHARDS];
+
+  /** List of spec infos; we just iterate over this. Mutated under the GIL
+   * only; the per-spec `used` counters are atomic since shards decrement
+   * them under different locks */
+  CursorSpecInfo **specs;
+  size_t specsCount;
 } CursorList;
 
 // This resides in the background as a global. We could in theory make this
@@ -165,4 +190,7 @@ void Cursors_PurgeWithName(CursorList *cl, const char *lookupName);
 void Cursors_RenderStats(CursorList *cl, const char *key, RedisModuleCtx *ctx);
 
 void Cursor_FreeExecState(void *);
+#ifdef __cplusplus
+}
+#endif
 #endif
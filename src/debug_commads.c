@@ -1,4 +1,10 @@
 #include "debug_commads.h"
+#include "perf_counters.h"
+#include "rmalloc_track.h"
+#include "delta_log.h"
+#include "index_snapshot.h"
+#include "util/mempool.h"
+#include "util/block_alloc.h"
 #include "inverted_index.h"
 #include "index.h"
 #include "redis_index.h"
@@ -23,6 +29,11 @@
   RedisModule_ReplyWithLongLong(ctx, val);                    \
   len += 2;
 
+#define REPLY_WITH_DOUBLE(name, val, len)                     \
+  RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name)); \
+  RedisModule_ReplyWithDouble(ctx, val);                      \
+  len += 2;
+
 #define REPLY_WITH_Str(name, val)                             \
   RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name)); \
   RedisModule_ReplyWithStringBuffer(ctx, val, strlen(val));   \
@@ -183,6 +194,53 @@ end:
   return REDISMODULE_OK;
 }
 
+/* NUMIDX_STATS <index> <field> <min> <max>
+ * Columnar aggregation over a numeric range: count/sum/min/max in one leaf-array pass,
+ * without building a query pipeline */
+DEBUG_COMMAND(NumericIndexStats) {
+  if (argc != 4) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  RedisModuleKey *keyp = NULL;
+  RedisModuleString *keyName = getFieldKeyName(sctx->spec, argv[1]);
+  if (!keyName) {
+    RedisModule_ReplyWithError(sctx->redisCtx, "Could not find given field in index spec");
+    goto end;
+  }
+  double min, max;
+  if (RedisModule_StringToDouble(argv[2], &min) != REDISMODULE_OK ||
+      RedisModule_StringToDouble(argv[3], &max) != REDISMODULE_OK) {
+    RedisModule_ReplyWithError(sctx->redisCtx, "Bad range");
+    goto end;
+  }
+  NumericRangeTree *rt = OpenNumericIndex(sctx, keyName, &keyp);
+  if (!rt) {
+    RedisModule_ReplyWithError(sctx->redisCtx, "can not open numeric field");
+    goto end;
+  }
+
+  NumericFilter *flt = NewNumericFilter(min, max, 1, 1);
+  NumericRangeStats stats;
+  NumericRangeTree_RangeStats(rt, flt, &stats);
+  NumericFilter_Free(flt);
+
+  size_t len = 0;
+  RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+  REPLY_WITH_LONG_LONG("count", (long long)stats.count, len);
+  REPLY_WITH_DOUBLE("sum", stats.sum, len);
+  REPLY_WITH_DOUBLE("min", stats.count ? stats.min : 0, len);
+  REPLY_WITH_DOUBLE("max", stats.count ? stats.max : 0, len);
+  RedisModule_ReplySetArrayLength(ctx, len);
+
+end:
+  if (keyp) {
+    RedisModule_CloseKey(keyp);
+  }
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
 DEBUG_COMMAND(DumpNumericIndex) {
   if (argc != 2) {
     return RedisModule_WrongArity(ctx);
@@ -274,10 +332,12 @@ DEBUG_COMMAND(IdToDocId) {
     goto end;
   }
   RSDocumentMetadata *doc = DocTable_Get(&sctx->spec->docs, id);
-  if (!doc || (doc->flags & Document_Deleted)) {
+  if (!doc || (DMD_Flags(doc) & Document_Deleted)) {
     RedisModule_ReplyWithError(sctx->redisCtx, "document was removed");
   } else {
-    RedisModule_ReplyWithStringBuffer(sctx->redisCtx, doc->keyPtr, strlen(doc->keyPtr));
+    size_t keyLen;
+    const char *keyStr = DMD_KeyPtrLen(doc, &keyLen);
+    RedisModule_ReplyWithStringBuffer(sctx->redisCtx, keyStr, keyLen);
   }
 end:
   SearchCtx_Free(sctx);
@@ -297,6 +357,164 @@ DEBUG_COMMAND(DocIdToId) {
   return REDISMODULE_OK;
 }
 
+/* DOCTABLE_SCAN <index>
+ * Stream every live document id and key through the snapshot cursor - the
+ * export path around per-id DocTable_Get calls. Entries come out in table
+ * chain order, not id order */
+DEBUG_COMMAND(DocTableScan) {
+  if (argc != 1) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  RedisModule_ReplyWithArray(sctx->redisCtx, REDISMODULE_POSTPONED_ARRAY_LEN);
+  size_t total = 0;
+  DocTableCursor cursor = DocTable_Cursor(&sctx->spec->docs);
+  const RSDocumentMetadata *batch[DOCTABLE_CURSOR_BATCH];
+  size_t n;
+  while ((n = DocTableCursor_NextBatch(&cursor, batch, DOCTABLE_CURSOR_BATCH))) {
+    for (size_t i = 0; i < n; ++i) {
+      RedisModule_ReplyWithLongLong(sctx->redisCtx, batch[i]->id);
+      size_t keyLen;
+      const char *keyStr = DMD_KeyPtrLen(batch[i], &keyLen);
+      RedisModule_ReplyWithStringBuffer(sctx->redisCtx, keyStr, keyLen);
+      total += 2;
+    }
+  }
+  RedisModule_ReplySetArrayLength(sctx->redisCtx, total);
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
+/* DELTALOG <index>
+ * Resume position of the index's delta log: [records, last_key], or an error
+ * when no log is configured for the index */
+DEBUG_COMMAND(DeltaLogInfo) {
+  if (argc != 1) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  DeltaLog *dl = sctx->spec->deltaLog;
+  if (!dl) {
+    SearchCtx_Free(sctx);
+    return RedisModule_ReplyWithError(ctx, "Index has no delta log (DELTALOG_DIR not set)");
+  }
+  char lastKey[1024];
+  size_t n;
+  uint64_t records = DeltaLog_Position(dl, lastKey, sizeof(lastKey), &n);
+  RedisModule_ReplyWithArray(sctx->redisCtx, 2);
+  RedisModule_ReplyWithLongLong(sctx->redisCtx, records);
+  if (n) {
+    RedisModule_ReplyWithStringBuffer(sctx->redisCtx, lastKey, n);
+  } else {
+    RedisModule_ReplyWithNull(sctx->redisCtx);
+  }
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
+/* PARTITION_DROP <index> <partition>
+ * Drop a whole docId partition: every term-index entry keyed with the
+ * partition's suffix is removed outright (no posting-by-posting deletion),
+ * and the partition's documents are marked deleted in the table */
+DEBUG_COMMAND(PartitionDrop) {
+  if (argc != 2) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  long long part;
+  if (RedisModule_StringToLongLong(argv[1], &part) != REDISMODULE_OK || part < 0 ||
+      sctx->spec->partitionSpan <= 0 || !sctx->spec->termsDict) {
+    SearchCtx_Free(sctx);
+    return RedisModule_ReplyWithError(ctx, "Bad partition, or index is not partitioned");
+  }
+
+  // Exclusive writer slice: queries parked mid-yield may hold pointers into
+  // the partition's indexes - the same fence GC rewrites take
+  IndexSpec_LockWrite(sctx->spec);
+
+  // collect matching keys first: deleting while iterating is not safe
+  char suffix[32];
+  int suffixLen = snprintf(suffix, sizeof(suffix), "#p%lld", part);
+  RedisModuleString **doomed = array_new(RedisModuleString *, 8);
+  dictIterator *it = dictGetIterator(sctx->spec->termsDict);
+  dictEntry *de;
+  while ((de = dictNext(it))) {
+    size_t klen;
+    const char *kstr = RedisModule_StringPtrLen(dictGetKey(de), &klen);
+    if (klen > (size_t)suffixLen && !memcmp(kstr + klen - suffixLen, suffix, suffixLen)) {
+      doomed = array_append(doomed, (RedisModuleString *)dictGetKey(de));
+    }
+  }
+  dictReleaseIterator(it);
+  size_t dropped = array_len(doomed);
+  for (size_t i = 0; i < dropped; i++) {
+    // empty in place rather than delete: a parked reader's revalidation
+    // dereferences its index, so the object must outlive sleeping readers.
+    // The hollow entry is a few dozen bytes
+    KeysDictValue *kdv = dictFetchValue(sctx->spec->termsDict, doomed[i]);
+    if (kdv->cold) {
+      // snapshot-lazy: swap the extent for a fresh empty index
+      kdv->dtor(kdv->p);
+      kdv->p = NewInvertedIndex(sctx->spec->flags, 1);
+      kdv->dtor = InvertedIndex_Free;
+      kdv->cold = 0;
+    } else {
+      InvertedIndex_Reset(kdv->p);
+    }
+  }
+  array_free(doomed);
+  IndexSpec_BumpTermEpoch(sctx->spec);
+  IndexSpec_UnlockIndex(sctx->spec);
+
+  // mark the partition's documents deleted (metadata only - their postings
+  // just vanished wholesale with the dictionary entries)
+  t_docId from = part * sctx->spec->partitionSpan + (part == 0 ? 1 : 0);
+  t_docId to = (part + 1) * sctx->spec->partitionSpan;
+  size_t docsDropped = 0;
+  for (t_docId id = from; id < to && id <= sctx->spec->docs.maxDocId; id++) {
+    const RSDocumentMetadata *dmd = DocTable_Get(&sctx->spec->docs, id);
+    if (dmd && !(DMD_Flags(dmd) & Document_Deleted)) {
+      size_t keyLen;
+      const char *keyStr = DMD_KeyPtrLen(dmd, &keyLen);
+      docsDropped += DocTable_Delete(&sctx->spec->docs, keyStr, keyLen) ? 1 : 0;
+    }
+  }
+
+  RedisModule_ReplyWithArray(sctx->redisCtx, 2);
+  RedisModule_ReplyWithLongLong(sctx->redisCtx, dropped);
+  RedisModule_ReplyWithLongLong(sctx->redisCtx, docsDropped);
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
+/* BACKFILL_STATUS <index>
+ * Online-reindex progress: [active, scanned, total, reindexed] */
+DEBUG_COMMAND(BackfillStatus) {
+  if (argc != 1) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  RedisModule_ReplyWithArray(sctx->redisCtx, 4);
+  RedisModule_ReplyWithLongLong(sctx->redisCtx, sctx->spec->backfillActive);
+  RedisModule_ReplyWithLongLong(sctx->redisCtx, sctx->spec->backfillScanned);
+  RedisModule_ReplyWithLongLong(sctx->redisCtx, sctx->spec->backfillTotal);
+  RedisModule_ReplyWithLongLong(sctx->redisCtx, sctx->spec->backfillReindexed);
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
+/* SNAPSHOT_REFRESH <index>
+ * Queue a background rebuild of the index's cached snapshot blob */
+DEBUG_COMMAND(SnapshotRefresh) {
+  if (argc != 1) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  IndexSnapshot_ScheduleRefresh(sctx->spec);
+  SearchCtx_Free(sctx);
+  return RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
+
 DEBUG_COMMAND(DumpPhoneticHash) {
   if (argc != 1) {
     return RedisModule_WrongArity(ctx);
@@ -330,6 +548,83 @@ static int GCForceInvokeReplyTimeout(RedisModuleCtx *ctx, RedisModuleString **ar
   return REDISMODULE_OK;
 }
 
+/* GC_STATS <index>
+ * Export the garbage collector's counters and cycle-duration histogram for the index */
+DEBUG_COMMAND(GcShowStats) {
+  if (argc != 1) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  if (!sctx->spec->gc) {
+    RedisModule_ReplyWithError(sctx->redisCtx, "index has no garbage collector");
+    goto end;
+  }
+  GCContext_RenderStats(sctx->spec->gc, ctx);
+end:
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
+static void replyPoolStats(const mempool_stats_t *stats, void *privdata) {
+  void **args = privdata;
+  RedisModuleCtx *ctx = args[0];
+  size_t *n = args[1];
+  RedisModule_ReplyWithStringBuffer(ctx, stats->name, strlen(stats->name));
+  RedisModule_ReplyWithArray(ctx, 12);
+  RedisModule_ReplyWithStringBuffer(ctx, "gets", strlen("gets"));
+  RedisModule_ReplyWithLongLong(ctx, stats->numGets);
+  RedisModule_ReplyWithStringBuffer(ctx, "allocs", strlen("allocs"));
+  RedisModule_ReplyWithLongLong(ctx, stats->numAllocs);
+  RedisModule_ReplyWithStringBuffer(ctx, "releases", strlen("releases"));
+  RedisModule_ReplyWithLongLong(ctx, stats->numReleases);
+  RedisModule_ReplyWithStringBuffer(ctx, "overflows", strlen("overflows"));
+  RedisModule_ReplyWithLongLong(ctx, stats->numOverflows);
+  RedisModule_ReplyWithStringBuffer(ctx, "in_pool", strlen("in_pool"));
+  RedisModule_ReplyWithLongLong(ctx, stats->currentInPool);
+  RedisModule_ReplyWithStringBuffer(ctx, "capacity", strlen("capacity"));
+  RedisModule_ReplyWithLongLong(ctx, stats->currentCap);
+  (*n) += 2;
+}
+
+/* BLKALLOC_STATS
+ * Process-wide block-allocator counters (forward index entries/terms, query
+ * AST arenas, merge tables): sizing data for what used to be tuned blind */
+DEBUG_COMMAND(BlkAllocStats) {
+  if (argc != 0) {
+    return RedisModule_WrongArity(ctx);
+  }
+  BlkAllocGlobalStats st;
+  BlkAlloc_GetGlobalStats(&st);
+  RedisModule_ReplyWithArray(ctx, 10);
+  RedisModule_ReplyWithSimpleString(ctx, "blocks_live");
+  RedisModule_ReplyWithLongLong(ctx, st.blocksLive);
+  RedisModule_ReplyWithSimpleString(ctx, "blocks_peak");
+  RedisModule_ReplyWithLongLong(ctx, st.blocksPeak);
+  RedisModule_ReplyWithSimpleString(ctx, "blocks_total");
+  RedisModule_ReplyWithLongLong(ctx, st.blocksTotal);
+  RedisModule_ReplyWithSimpleString(ctx, "fixed_allocs");
+  RedisModule_ReplyWithLongLong(ctx, st.fixedAllocs);
+  RedisModule_ReplyWithSimpleString(ctx, "fixed_reuses");
+  RedisModule_ReplyWithLongLong(ctx, st.fixedReuses);
+  return REDISMODULE_OK;
+}
+
+/* MEMPOOL_STATS
+ * Export usage counters for every registered object pool (tokenizers, adding
+ * contexts; document metadata lives in its own paged slab and is not listed
+ * here). Counters are unlocked snapshots */
+DEBUG_COMMAND(MempoolStats) {
+  if (argc != 0) {
+    return RedisModule_WrongArity(ctx);
+  }
+  size_t n = 0;
+  void *args[2] = {ctx, &n};
+  RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+  mempool_visit_registered(replyPoolStats, args);
+  RedisModule_ReplySetArrayLength(ctx, n);
+  return REDISMODULE_OK;
+}
+
 DEBUG_COMMAND(GCForceInvoke) {
 #define INVOKATION_TIMEOUT 30000  // gc invocation timeout ms
   IndexSpec *sp = IndexSpec_Load(ctx, RedisModule_StringPtrLen(argv[0], NULL), 0);
@@ -480,17 +775,235 @@ typedef struct DebugCommandType {
   int (*callback)(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 } DebugCommandType;
 
+/* Postings-distribution walk over the terms dict: distinct terms, a log2
+ * postings-length histogram, block counts and plain-block fill factor, all
+ * attributed per folded field id via the block field-mask unions. Terms whose
+ * blocks carry no union (unknown) land in the unattributed bucket */
+#define FIELDSTATS_HIST_BUCKETS 16
+
+typedef struct {
+  size_t distinctTerms;
+  size_t postingsHist[FIELDSTATS_HIST_BUCKETS];
+  size_t blocks;
+  size_t fillNum, fillDen;  // summed offset/cap over plain, owned blocks
+} FieldDistStats;
+
+typedef struct {
+  FieldDistStats perField[64];
+  size_t unattributedTerms;
+  size_t totalTerms;
+} FieldStatsScan;
+
+static void fieldStatsScanCb(void *privdata, const dictEntry *de) {
+  FieldStatsScan *fss = privdata;
+  const KeysDictValue *kdv = dictGetVal(de);
+  if (kdv->cold) {
+    return;  // lazily hydrated snapshot entries: no postings in memory
+  }
+  InvertedIndex *idx = kdv->p;
+  fss->totalTerms++;
+
+  uint64_t un = 0;
+  size_t blocks = idx->size;
+  size_t fillNum = 0, fillDen = 0;
+  for (uint32_t b = 0; b < idx->size; b++) {
+    IndexBlock *blk = &idx->blocks[b];
+    un |= blk->fieldMaskUnion;
+    if (!blk->bufBorrowed && !blk->compressed && blk->buf.cap) {
+      fillNum += blk->buf.offset;
+      fillDen += blk->buf.cap;
+    }
+  }
+
+  int bucket = 0;
+  for (size_t d = idx->numDocs; d > 1 && bucket + 1 < FIELDSTATS_HIST_BUCKETS; d >>= 1) {
+    bucket++;
+  }
+
+  if (!un) {
+    fss->unattributedTerms++;
+    return;
+  }
+  while (un) {
+    int bit = __builtin_ctzll(un);
+    un &= un - 1;
+    FieldDistStats *f = &fss->perField[bit];
+    f->distinctTerms++;
+    f->postingsHist[bucket]++;
+    f->blocks += blocks;
+    f->fillNum += fillNum;
+    f->fillDen += fillDen;
+  }
+}
+
+DEBUG_COMMAND(FieldStats) {
+  if (argc != 1) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  IndexSpec *sp = sctx->spec;
+  FieldStatsScan fss;
+  memset(&fss, 0, sizeof(fss));
+  if (sp->termsDict) {
+    unsigned long cursor = 0;
+    while ((cursor = dictScan(sp->termsDict, cursor, fieldStatsScanCb, NULL, &fss)) != 0) {
+    }
+  }
+
+  int nFields = 0;
+  for (int i = 0; i < sp->numFields; i++) {
+    if (sp->fields[i].type == FIELD_FULLTEXT) {
+      nFields++;
+    }
+  }
+  RedisModule_ReplyWithArray(ctx, nFields * 2 + 4);
+  for (int i = 0; i < sp->numFields; i++) {
+    const FieldSpec *fs = &sp->fields[i];
+    if (fs->type != FIELD_FULLTEXT) {
+      continue;
+    }
+    const FieldDistStats *f = &fss.perField[fs->textOpts.id % 64];
+    const FieldIndexStats *w = &sp->fieldIdxStats[fs->textOpts.id % 64];
+    RedisModule_ReplyWithStringBuffer(ctx, fs->name, strlen(fs->name));
+    RedisModule_ReplyWithArray(ctx, 10 + FIELDSTATS_HIST_BUCKETS);
+    RedisModule_ReplyWithSimpleString(ctx, "inverted_bytes");
+    RedisModule_ReplyWithLongLong(ctx, w->invertedBytes);
+    RedisModule_ReplyWithSimpleString(ctx, "postings");
+    RedisModule_ReplyWithLongLong(ctx, w->postings);
+    RedisModule_ReplyWithSimpleString(ctx, "distinct_terms");
+    RedisModule_ReplyWithLongLong(ctx, f->distinctTerms);
+    RedisModule_ReplyWithSimpleString(ctx, "blocks");
+    RedisModule_ReplyWithLongLong(ctx, f->blocks);
+    RedisModule_ReplyWithSimpleString(ctx, "block_fill_permille");
+    RedisModule_ReplyWithLongLong(ctx, f->fillDen ? (long long)(f->fillNum * 1000 / f->fillDen) : 0);
+    RedisModule_ReplyWithSimpleString(ctx, "postings_len_log2_hist");
+    for (int b = 0; b < FIELDSTATS_HIST_BUCKETS; b++) {
+      RedisModule_ReplyWithLongLong(ctx, f->postingsHist[b]);
+    }
+  }
+  RedisModule_ReplyWithSimpleString(ctx, "total_terms");
+  RedisModule_ReplyWithLongLong(ctx, fss.totalTerms);
+  RedisModule_ReplyWithSimpleString(ctx, "unattributed_terms");
+  RedisModule_ReplyWithLongLong(ctx, fss.unattributedTerms);
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
+DEBUG_COMMAND(IteratorStats) {
+  if (argc < 1 || argc > 2) {
+    return RedisModule_WrongArity(ctx);
+  }
+  GET_SEARCH_CTX(argv[0])
+  IterRAStats *st = &sctx->spec->iterStats;
+  if (argc == 2) {
+    size_t len;
+    const char *sub = RedisModule_StringPtrLen(argv[1], &len);
+    if (len == 5 && !strncasecmp(sub, "RESET", 5)) {
+      memset(st, 0, sizeof(*st));
+      RedisModule_ReplyWithSimpleString(ctx, "OK");
+      goto end;
+    }
+    RedisModule_WrongArity(ctx);
+    goto end;
+  }
+  RedisModule_ReplyWithArray(ctx, 10);
+  RedisModule_ReplyWithSimpleString(ctx, "entries_decoded");
+  RedisModule_ReplyWithLongLong(ctx, __atomic_load_n(&st->entriesDecoded, __ATOMIC_RELAXED));
+  RedisModule_ReplyWithSimpleString(ctx, "entries_returned");
+  RedisModule_ReplyWithLongLong(ctx, __atomic_load_n(&st->entriesReturned, __ATOMIC_RELAXED));
+  RedisModule_ReplyWithSimpleString(ctx, "skipto_calls");
+  RedisModule_ReplyWithLongLong(ctx, __atomic_load_n(&st->skipToCalls, __ATOMIC_RELAXED));
+  RedisModule_ReplyWithSimpleString(ctx, "skipto_hits");
+  RedisModule_ReplyWithLongLong(ctx, __atomic_load_n(&st->skipToHits, __ATOMIC_RELAXED));
+  RedisModule_ReplyWithSimpleString(ctx, "blocks_entered");
+  RedisModule_ReplyWithLongLong(ctx, __atomic_load_n(&st->blocksEntered, __ATOMIC_RELAXED));
+end:
+  SearchCtx_Free(sctx);
+  return REDISMODULE_OK;
+}
+
+DEBUG_COMMAND(AllocStats) {
+#ifndef RS_ALLOC_TRACKING
+  return RedisModule_ReplyWithError(
+      ctx, "allocation tracking is not compiled in; configure with -DRS_ALLOC_TRACKING=ON");
+#else
+  RedisModule_ReplyWithArray(ctx, RM_TAG__MAX * 2);
+  for (int i = 0; i < RM_TAG__MAX; i++) {
+    RmAllocTagStats st;
+    st.liveBytes = __atomic_load_n(&rmAllocStats_g[i].liveBytes, __ATOMIC_RELAXED);
+    st.allocs = __atomic_load_n(&rmAllocStats_g[i].allocs, __ATOMIC_RELAXED);
+    st.frees = __atomic_load_n(&rmAllocStats_g[i].frees, __ATOMIC_RELAXED);
+    st.totalBytes = __atomic_load_n(&rmAllocStats_g[i].totalBytes, __ATOMIC_RELAXED);
+    RedisModule_ReplyWithSimpleString(ctx, rmAllocTagNames_g[i]);
+    RedisModule_ReplyWithArray(ctx, 8);
+    RedisModule_ReplyWithSimpleString(ctx, "live_bytes");
+    RedisModule_ReplyWithLongLong(ctx, st.liveBytes);
+    RedisModule_ReplyWithSimpleString(ctx, "allocs");
+    RedisModule_ReplyWithLongLong(ctx, st.allocs);
+    RedisModule_ReplyWithSimpleString(ctx, "frees");
+    RedisModule_ReplyWithLongLong(ctx, st.frees);
+    RedisModule_ReplyWithSimpleString(ctx, "total_bytes");
+    RedisModule_ReplyWithLongLong(ctx, st.totalBytes);
+  }
+  return REDISMODULE_OK;
+#endif
+}
+
+DEBUG_COMMAND(PerfCounters) {
+#ifndef RS_PERF_COUNTERS
+  return RedisModule_ReplyWithError(
+      ctx, "perf counters are not compiled in; configure with -DRS_PERF_COUNTERS=ON");
+#else
+  if (argc == 1) {
+    size_t len;
+    const char *sub = RedisModule_StringPtrLen(argv[0], &len);
+    if (len == 5 && !strncasecmp(sub, "RESET", 5)) {
+      PerfCounters_Reset();
+      return RedisModule_ReplyWithSimpleString(ctx, "OK");
+    }
+    return RedisModule_WrongArity(ctx);
+  }
+  RedisModule_ReplyWithArray(ctx, PERFCTR__MAX * 2);
+  for (int i = 0; i < PERFCTR__MAX; i++) {
+    uint64_t calls = __atomic_load_n(&perfCounters_g[i].calls, __ATOMIC_RELAXED);
+    uint64_t cycles = __atomic_load_n(&perfCounters_g[i].cycles, __ATOMIC_RELAXED);
+    RedisModule_ReplyWithSimpleString(ctx, perfCounterNames_g[i]);
+    RedisModule_ReplyWithArray(ctx, 6);
+    RedisModule_ReplyWithSimpleString(ctx, "calls");
+    RedisModule_ReplyWithLongLong(ctx, calls);
+    RedisModule_ReplyWithSimpleString(ctx, "cycles");
+    RedisModule_ReplyWithLongLong(ctx, cycles);
+    RedisModule_ReplyWithSimpleString(ctx, "cycles_per_call");
+    RedisModule_ReplyWithLongLong(ctx, calls ? (long long)(cycles / calls) : 0);
+  }
+  return REDISMODULE_OK;
+#endif
+}
+
 DebugCommandType commands[] = {{"DUMP_INVIDX", DumpInvertedIndex},
                                {"DUMP_NUMIDX", DumpNumericIndex},
                                {"DUMP_TAGIDX", DumpTagIndex},
                                {"INFO_TAGIDX", InfoTagIndex},
                                {"IDTODOCID", IdToDocId},
                                {"DOCIDTOID", DocIdToId},
+                               {"DOCTABLE_SCAN", DocTableScan},
+                               {"DELTALOG", DeltaLogInfo},
+                               {"SNAPSHOT_REFRESH", SnapshotRefresh},
+                               {"BACKFILL_STATUS", BackfillStatus},
+                               {"PARTITION_DROP", PartitionDrop},
                                {"DUMP_PHONETIC_HASH", DumpPhoneticHash},
                                {"DUMP_TERMS", DumpTerms},
                                {"INVIDX_SUMMARY", InvertedIndexSummary},
                                {"NUMIDX_SUMMARY", NumericIndexSummary},
+                               {"NUMIDX_STATS", NumericIndexStats},
                                {"GC_FORCEINVOKE", GCForceInvoke},
+                               {"GC_STATS", GcShowStats},
+                               {"MEMPOOL_STATS", MempoolStats},
+                               {"PERFCOUNTERS", PerfCounters},
+                               {"ITERATOR_STATS", IteratorStats},
+                               {"FIELD_STATS", FieldStats},
+                               {"ALLOC_STATS", AllocStats},
+                               {"BLKALLOC_STATS", BlkAllocStats},
                                {NULL, NULL}};
 
 int DebugCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
@@ -57,8 +57,16 @@ struct GarbageCollectorCtx {
   uint64_t specUniqueId;
 
   bool noLockMode;
+
+  /* Systematic term sweep: position of the fork-free full-coverage scan, advanced a few terms
+   * per cycle so every term is eventually repaired regardless of the sampling pick */
+  char *sweepCursor;
+  size_t sweepCursorLen;
 };
 
+// Terms the systematic sweep covers per cycle, in addition to the sampled pick
+#define GC_SWEEP_TERMS_PER_CYCLE 16
+
 /* Create a new garbage collector, with a string for the index name, and initial frequency */
 GarbageCollectorCtx *NewGarbageCollector(const RedisModuleString *k, float initialHZ,
                                          uint64_t specUniqueId, GCCallbacks *callbacks) {
@@ -101,9 +109,33 @@ size_t gc_RandomTerm(RedisModuleCtx *ctx, GarbageCollectorCtx *gc, int *status)
     *status = SPEC_STATUS_INVALID;
     goto end;
   }
-  // Select a weighted random term
   TimeSample ts;
-  char *term = IndexSpec_GetRandomTerm(sctx->spec, 20);
+  // Without a doc-to-terms map there is no exact per-term garbage counter, so estimate
+  // expected reclaimable bytes as posting size times the global delete fraction: sample a
+  // handful of random terms and collect the one with the largest postings. Under skewed
+  // delete patterns most garbage sits in the big terms the old single random pick rarely hit
+#define GC_TERM_CANDIDATES 8
+  char *term = NULL;
+  size_t bestSize = 0;
+  for (int i = 0; i < GC_TERM_CANDIDATES; i++) {
+    char *cand = IndexSpec_GetRandomTerm(sctx->spec, 20);
+    if (!cand) {
+      continue;
+    }
+    RedisModuleKey *candKey = NULL;
+    InvertedIndex *candIdx = Redis_OpenInvertedIndexEx(sctx, cand, strlen(cand), 0, &candKey);
+    size_t sz = candIdx ? candIdx->numDocs : 0;
+    if (candKey) {
+      RedisModule_CloseKey(candKey);
+    }
+    if (!term || sz > bestSize) {
+      free(term);
+      term = cand;
+      bestSize = sz;
+    } else {
+      free(cand);
+    }
+  }
   // if the index is empty we won't get anything here
   if (!term) {
     goto end;
@@ -125,7 +157,11 @@ size_t gc_RandomTerm(RedisModuleCtx *ctx, GarbageCollectorCtx *gc, int *status)
       gc_updateStats(sctx, gc, params.docsCollected, params.bytesCollected);
       totalCollected += params.bytesCollected;
       // blockNum 0 means error or we've finished
-      if (!blockNum) break;
+      if (!blockNum) {
+        // Full pass done - coalesce the under-filled blocks the repairs left behind
+        InvertedIndex_CompactBlocks(idx);
+        break;
+      }
 
       // After each iteration we yield execution
       // First we close the relevant keys we're touching
@@ -146,6 +182,61 @@ size_t gc_RandomTerm(RedisModuleCtx *ctx, GarbageCollectorCtx *gc, int *status)
                     totalCollected, totalRemoved, term);
   }
   free(term);
+
+  // Systematic sweep: repair the next few terms after the cursor, so the fork-free collector
+  // provably covers the whole dictionary over time, not just the sampled hot spots
+  if (sctx) {
+    TrieIterator *iter = Trie_Iterate(sctx->spec->terms, "", 0, 0, 1);
+    rune *rstr = NULL;
+    t_len slen = 0;
+    float score = 0;
+    int dist = 0;
+    int skipping = gc->sweepCursor != NULL;
+    size_t swept = 0;
+    char *lastTerm = NULL;
+    size_t lastTermLen = 0;
+    while (swept < GC_SWEEP_TERMS_PER_CYCLE &&
+           TrieIterator_Next(iter, &rstr, &slen, NULL, &score, &dist)) {
+      size_t termLen;
+      char *sterm = runesToStr(rstr, slen, &termLen);
+      if (skipping) {
+        if (termLen == gc->sweepCursorLen && !memcmp(sterm, gc->sweepCursor, termLen)) {
+          skipping = 0;
+        }
+        free(sterm);
+        continue;
+      }
+      RedisModuleKey *sKey = NULL;
+      InvertedIndex *sIdx = Redis_OpenInvertedIndexEx(sctx, sterm, termLen, 1, &sKey);
+      if (sIdx) {
+        IndexRepairParams params = {0};
+        InvertedIndex_Repair(sIdx, &sctx->spec->docs, 0, &params);
+        totalRemoved += params.docsCollected;
+        gc_updateStats(sctx, gc, params.docsCollected, params.bytesCollected);
+        totalCollected += params.bytesCollected;
+      }
+      if (sKey) {
+        RedisModule_CloseKey(sKey);
+      }
+      free(lastTerm);
+      lastTerm = sterm;
+      lastTermLen = termLen;
+      ++swept;
+    }
+    DFAFilter_Free(iter->ctx);
+    free(iter->ctx);
+    TrieIterator_Free(iter);
+
+    rm_free(gc->sweepCursor);
+    gc->sweepCursor = NULL;
+    gc->sweepCursorLen = 0;
+    if (swept == GC_SWEEP_TERMS_PER_CYCLE && lastTerm) {
+      // more to scan - remember where to pick up
+      gc->sweepCursor = rm_strndup(lastTerm, lastTermLen);
+      gc->sweepCursorLen = lastTermLen;
+    }
+    free(lastTerm);
+  }
   RedisModule_Log(ctx, "debug", "New HZ: %f\n", gc->hz);
 end:
   if (sctx) {
@@ -250,7 +341,10 @@ size_t gc_TagIndex(RedisModuleCtx *ctx, GarbageCollectorCtx *gc, int *status) {
     totalRemoved += params.docsCollected;
     gc_updateStats(sctx, gc, params.docsCollected, params.bytesCollected);
     // blockNum 0 means error or we've finished
-    if (!blockNum) break;
+    if (!blockNum) {
+      InvertedIndex_CompactBlocks(iv);
+      break;
+    }
 
     // After each iteration we yield execution
     // First we close the relevant keys we're touching
@@ -351,7 +445,10 @@ size_t gc_NumericIndex(RedisModuleCtx *ctx, GarbageCollectorCtx *gc, int *status
     totalRemoved += params.docsCollected;
     gc_updateStats(sctx, gc, params.docsCollected, params.bytesCollected);
     // blockNum 0 means error or we've finished
-    if (!blockNum) break;
+    if (!blockNum) {
+      InvertedIndex_CompactBlocks(nextNode->range->entries);
+      break;
+    }
 
     sctx = SearchCtx_Refresh(sctx, (RedisModuleString *)gc->keyName);
     // sctx null --> means it was deleted and we need to stop right now
@@ -437,6 +534,7 @@ void GC_OnTerm(void *privdata) {
   array_free(gc->numericGCCtx);
   RedisModule_ThreadSafeContextUnlock(ctx);
   RedisModule_FreeThreadSafeContext(ctx);
+  rm_free(gc->sweepCursor);
   free(gc);
 }
 
@@ -0,0 +1,132 @@
+#include "delta_log.h"
+#include "rmalloc.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <errno.h>
+
+// fdatasync once per this many appended bytes (and on close)
+#define DELTALOG_SYNC_BYTES (1 << 20)
+
+struct DeltaLog {
+  int fd;
+  pthread_mutex_t lock;
+  uint32_t refcount;
+  size_t unsynced;
+  uint64_t nrecords;
+  char *lastKey;
+  size_t lastKeyLen;
+  size_t lastKeyCap;
+};
+
+static void dlSetLastKey(DeltaLog *dl, const char *key, size_t n) {
+  if (dl->lastKeyCap < n + 1) {
+    dl->lastKeyCap = n + 1;
+    dl->lastKey = rm_realloc(dl->lastKey, dl->lastKeyCap);
+  }
+  memcpy(dl->lastKey, key, n);
+  dl->lastKey[n] = '\0';
+  dl->lastKeyLen = n;
+}
+
+/* Scan an existing log, recovering the record count and last key. A torn tail
+ * record (crash mid-append) is truncated away so appends resume on a clean
+ * boundary */
+static void dlRecover(DeltaLog *dl) {
+  struct stat st;
+  if (fstat(dl->fd, &st) != 0) {
+    return;
+  }
+  off_t pos = 0;
+  for (;;) {
+    uint32_t len;
+    ssize_t got = pread(dl->fd, &len, sizeof(len), pos);
+    if (got < (ssize_t)sizeof(len)) {
+      break;
+    }
+    // a length past the end of the file is a torn (or corrupt) tail record
+    if ((off_t)len > st.st_size - pos - (off_t)sizeof(len)) {
+      break;
+    }
+    char *key = rm_malloc(len);
+    got = pread(dl->fd, key, len, pos + sizeof(len));
+    if (got < (ssize_t)len) {
+      rm_free(key);
+      break;
+    }
+    dlSetLastKey(dl, key, len);
+    rm_free(key);
+    dl->nrecords++;
+    pos += sizeof(len) + len;
+  }
+  if (ftruncate(dl->fd, pos) == 0) {
+    lseek(dl->fd, pos, SEEK_SET);
+  }
+}
+
+DeltaLog *DeltaLog_Open(const char *dir, const char *indexName, int fresh) {
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s/%s.dlog", dir, indexName);
+  int fd = open(path, O_RDWR | O_CREAT | O_APPEND | (fresh ? O_TRUNC : 0), 0644);
+  if (fd < 0) {
+    return NULL;
+  }
+  DeltaLog *dl = rm_calloc(1, sizeof(*dl));
+  dl->fd = fd;
+  dl->refcount = 1;
+  pthread_mutex_init(&dl->lock, NULL);
+  dlRecover(dl);
+  return dl;
+}
+
+void DeltaLog_Incref(DeltaLog *dl) {
+  __atomic_add_fetch(&dl->refcount, 1, __ATOMIC_RELAXED);
+}
+
+void DeltaLog_Decref(DeltaLog *dl) {
+  if (__atomic_sub_fetch(&dl->refcount, 1, __ATOMIC_ACQ_REL) != 0) {
+    return;
+  }
+  fdatasync(dl->fd);
+  close(dl->fd);
+  pthread_mutex_destroy(&dl->lock);
+  rm_free(dl->lastKey);
+  rm_free(dl);
+}
+
+void DeltaLog_Append(DeltaLog *dl, const char *key, size_t n) {
+  uint32_t len = n;
+  struct iovec iov[2] = {{&len, sizeof(len)}, {(void *)key, n}};
+  pthread_mutex_lock(&dl->lock);
+  if (writev(dl->fd, iov, 2) == (ssize_t)(sizeof(len) + n)) {
+    dl->nrecords++;
+    dlSetLastKey(dl, key, n);
+    dl->unsynced += sizeof(len) + n;
+    if (dl->unsynced >= DELTALOG_SYNC_BYTES) {
+      fdatasync(dl->fd);
+      dl->unsynced = 0;
+    }
+  }
+  pthread_mutex_unlock(&dl->lock);
+}
+
+/* Snapshot the resume position under the lock - the indexer thread may be
+ * appending concurrently. Copies up to `cap` bytes of the last key into `buf`
+ * and returns the record count; *n is 0 when the log is empty */
+uint64_t DeltaLog_Position(DeltaLog *dl, char *buf, size_t cap, size_t *n) {
+  pthread_mutex_lock(&dl->lock);
+  uint64_t records = dl->nrecords;
+  *n = dl->lastKeyLen < cap ? dl->lastKeyLen : cap;
+  if (records) {
+    memcpy(buf, dl->lastKey, *n);
+  } else {
+    *n = 0;
+  }
+  pthread_mutex_unlock(&dl->lock);
+  return records;
+}
@@ -0,0 +1,50 @@
+#ifndef DELTA_LOG_H
+#define DELTA_LOG_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Optional per-index append-only delta log: one record per document key whose
+ * indexing committed, written to <DELTALOG_DIR>/<index>.dlog. A long backfill
+ * interrupted by a crash resumes from the last durable key (FT.DEBUG DELTALOG
+ * reports it) instead of restarting from zero.
+ *
+ * Records are `u32 length | key bytes`, appended under an internal lock (the
+ * indexer thread and unblockable adds both commit documents). The file is
+ * fdatasync'ed every DELTALOG_SYNC_BYTES of appends, so the reported position
+ * trails the very latest commits by at most that window - a resuming loader
+ * should replay a small overlap, which document upserts make idempotent.
+ *
+ * The log is refcounted: the spec holds one reference, and every in-flight
+ * document context holds another, so a commit that outlives an index drop
+ * appends onto a still-open log and the file closes with the last reference.
+ * Opening an existing log scans it, truncating a torn tail record.
+ */
+typedef struct DeltaLog DeltaLog;
+
+/* Open the log for `indexName` under `dir`. `fresh` truncates any leftover
+ * file (a newly created index must not inherit a dropped namesake's records);
+ * without it an existing log is recovered. Returns NULL when the file cannot
+ * be opened */
+DeltaLog *DeltaLog_Open(const char *dir, const char *indexName, int fresh);
+
+void DeltaLog_Incref(DeltaLog *dl);
+void DeltaLog_Decref(DeltaLog *dl);
+
+/* Append one committed document key */
+void DeltaLog_Append(DeltaLog *dl, const char *key, size_t n);
+
+/* Resume position: copies the last logged key (up to `cap` bytes) into `buf`,
+ * sets *n to its length (0 when empty) and returns the record count. Safe
+ * against concurrent appends */
+uint64_t DeltaLog_Position(DeltaLog *dl, char *buf, size_t cap, size_t *n);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
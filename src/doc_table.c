@@ -4,22 +4,150 @@
 #include <stdio.h>
 #include "redismodule.h"
 #include "util/fnv.h"
-#include "dep/triemap/triemap.h"
 #include "sortable.h"
 #include "rmalloc.h"
 #include "spec.h"
 #include "config.h"
 
-/* Creates a new DocTable with a given capacity */
+/* Paged slab backing every RSDocumentMetadata in the process. DMDs are
+ * allocated and released under the GIL, so the slab needs no locking;
+ * mass-expiry events recycle a million structs through the free list instead
+ * of hammering the allocator. Pages never move or shrink, so the pointers
+ * readers hold stay valid for the process lifetime. Strings and payloads
+ * attached to a DMD stay individually owned - only the fixed-size struct is
+ * slab-resident */
+RSDocumentMetadata **DMD_SlabPages = NULL;
+static uint32_t dmdSlabNumPages = 0;
+static uint32_t dmdSlabDirCap = 0;
+static uint32_t dmdSlabFreeHead = DMD_REF_NIL;
+// Ref 0 is the nil link; its slot is never handed out
+static uint32_t dmdSlabNextRef = 1;
+
+static RSDocumentMetadata *DMD_SlabGet(void) {
+  uint32_t ref = dmdSlabFreeHead;
+  if (ref != DMD_REF_NIL) {
+    dmdSlabFreeHead = DMD_Deref(ref)->next;
+  } else {
+    ref = dmdSlabNextRef++;
+    uint32_t page = ref >> DMD_SLAB_PAGE_BITS;
+    if (page >= dmdSlabNumPages) {
+      if (page >= dmdSlabDirCap) {
+        /* Publish a larger directory copy instead of realloc'ing in place: a
+         * concurrent chain walker that already loaded the old pointer keeps a
+         * directory whose live prefix is identical. Superseded copies are
+         * retired for a few KB over the process lifetime */
+        uint32_t newCap = dmdSlabDirCap ? dmdSlabDirCap * 2 : 64;
+        RSDocumentMetadata **dir = rm_calloc(newCap, sizeof(*dir));
+        if (dmdSlabNumPages) {
+          memcpy(dir, DMD_SlabPages, dmdSlabNumPages * sizeof(*dir));
+        }
+        __atomic_store_n(&DMD_SlabPages, dir, __ATOMIC_RELEASE);
+        dmdSlabDirCap = newCap;
+      }
+      DMD_SlabPages[page] = rm_malloc(DMD_SLAB_PAGE_SIZE * sizeof(RSDocumentMetadata));
+      dmdSlabNumPages = page + 1;
+    }
+  }
+  RSDocumentMetadata *dmd = DMD_Deref(ref);
+  memset(dmd, 0, sizeof(*dmd));
+  dmd->selfRef = ref;
+  return dmd;
+}
+
+static void DMD_SlabRelease(RSDocumentMetadata *dmd) {
+  dmd->next = dmdSlabFreeHead;
+  dmdSlabFreeHead = dmd->selfRef;
+}
+
 DocTable NewDocTable(size_t cap, size_t max_size) {
-  return (DocTable){.size = 1,
-                    .cap = cap,
-                    .maxDocId = 0,
-                    .memsize = 0,
-                    .sortablesSize = 0,
-                    .maxSize = max_size,
-                    .buckets = rm_calloc(cap, sizeof(DMDChain)),
-                    .dim = NewDocIdMap()};
+  DocTable t = {.size = 1,
+                .cap = cap,
+                .maxDocId = 0,
+                .memsize = 0,
+                .sortablesSize = 0,
+                .maxSize = max_size,
+                .buckets = rm_calloc(cap, sizeof(DMDChain)),
+                .dim = NewDocIdMap(),
+                .prefixes = NewTrieMap()};
+  for (int i = 0; i < DOCTABLE_NUM_SHARDS; i++) {
+    pthread_rwlock_init(&t.shardLocks[i], NULL);
+  }
+  return t;
+}
+
+static inline uint32_t docTableShard(uint32_t bucket) {
+  return bucket % DOCTABLE_NUM_SHARDS;
+}
+
+static void docTableLockAllShards(DocTable *t) {
+  for (int i = 0; i < DOCTABLE_NUM_SHARDS; i++) {
+    pthread_rwlock_wrlock(&t->shardLocks[i]);
+  }
+}
+
+static void docTableUnlockAllShards(DocTable *t) {
+  for (int i = 0; i < DOCTABLE_NUM_SHARDS; i++) {
+    pthread_rwlock_unlock(&t->shardLocks[i]);
+  }
+}
+
+/* Assign a key to the metadata, interning the shared prefix (everything up
+ * to and including the last ':') in the table's prefix map. Keys without a
+ * separator, and tables in id-array API mode, store the whole key as the
+ * suffix. Returns the bytes newly allocated for accounting */
+static size_t dmdAssignKey(DocTable *t, RSDocumentMetadata *dmd, const char *s, size_t n) {
+  const char *sep = t->idmap ? NULL : memrchr(s, ':', n);
+  size_t newBytes = 0;
+  dmd->keyPrefix = NULL;
+  if (sep && sep != s + n - 1) {  // a prefix needs a non-empty suffix
+    size_t plen = sep - s + 1;
+    DMDKeyPrefix *p = TrieMap_Find(t->prefixes, (char *)s, plen);
+    if (p == TRIEMAP_NOTFOUND) {
+      p = rm_malloc(sizeof(*p) + plen);
+      p->len = plen;
+      p->refcount = 1;  // the intern map's own reference
+      memcpy(p->str, s, plen);
+      TrieMap_Add(t->prefixes, (char *)s, plen, p, NULL);
+      newBytes += sizeof(DMDKeyPrefix) + plen;
+    }
+    p->refcount++;
+    dmd->keyPrefix = p;
+    s += plen;
+    n -= plen;
+  }
+  dmd->keyPtr = sdsnewlen(s, n);
+  return newBytes + sdsAllocSize(dmd->keyPtr);
+}
+
+static void prefixDecrefCb(void *p) {
+  DMDKeyPrefix_Decref(p);
+}
+
+/* Materialization scratch for prefix-compressed keys; grown once per thread
+ * and reused, since borrowers only need the bytes until their reply/copy */
+static __thread char *dmdKeyScratch = NULL;
+static __thread size_t dmdKeyScratchCap = 0;
+
+const char *DMD_KeyPtrLen(const RSDocumentMetadata *dmd, size_t *len) {
+  size_t slen = sdslen(dmd->keyPtr);
+  if (!dmd->keyPrefix) {
+    if (len) {
+      *len = slen;
+    }
+    return dmd->keyPtr;
+  }
+  size_t total = dmd->keyPrefix->len + slen;
+  if (dmdKeyScratchCap < total + 1) {
+    dmdKeyScratch = rm_realloc(dmdKeyScratch, total + 1);
+    dmdKeyScratchCap = total + 1;
+  }
+  memcpy(dmdKeyScratch, dmd->keyPrefix->str, dmd->keyPrefix->len);
+  memcpy(dmdKeyScratch + dmd->keyPrefix->len, dmd->keyPtr, slen);
+  dmdKeyScratch[total] = '\0';
+  if (len) {
+    *len = total;
+  }
+  return dmdKeyScratch;
 }
 
 static inline uint32_t DocTable_GetBucket(const DocTable *t, t_docId docId) {
@@ -66,7 +194,7 @@ void DocTable_EnableIdArray(DocTable *t) {
  *  If docId is not inside the table, we return NULL */
 
 int DMDChain_IsEmpty(const DMDChain *dmdChain) {
-  return !dmdChain->last;
+  return dmdChain->last == DMD_REF_NIL;
 }
 
 RSDocumentMetadata *DocTable_Get(const DocTable *t, t_docId docId) {
@@ -74,15 +202,19 @@ RSDocumentMetadata *DocTable_Get(const DocTable *t, t_docId docId) {
     return NULL;
   }
   uint32_t bucketIndex = DocTable_GetBucket(t, docId);
+  pthread_rwlock_t *lock =
+      (pthread_rwlock_t *)&t->shardLocks[docTableShard(bucketIndex)];
+  pthread_rwlock_rdlock(lock);
   DMDChain *dmdChain = &t->buckets[bucketIndex];
-  RSDocumentMetadata *currDmd = dmdChain->first;
+  RSDocumentMetadata *currDmd = DMD_Deref(dmdChain->first);
   while (currDmd) {
     if (currDmd->id == docId) {
-      return currDmd;
+      break;
     }
-    currDmd = currDmd->next;
+    currDmd = DMD_Deref(currDmd->next);
   }
-  return NULL;
+  pthread_rwlock_unlock(lock);
+  return currDmd;
 }
 
 int DocTable_Exists(const DocTable *t, t_docId docId) {
@@ -90,16 +222,90 @@ int DocTable_Exists(const DocTable *t, t_docId docId) {
     return 0;
   }
   uint32_t ix = DocTable_GetBucket(t, docId);
+  pthread_rwlock_t *lock = (pthread_rwlock_t *)&t->shardLocks[docTableShard(ix)];
+  pthread_rwlock_rdlock(lock);
   const DMDChain *chain = t->buckets + ix;
-  if (chain == NULL) {
-    return 0;
+  int found = 0;
+  for (const RSDocumentMetadata *md = DMD_Deref(chain->first); md; md = DMD_Deref(md->next)) {
+    if (md->id == docId && !(DMD_Flags(md) & Document_Deleted)) {
+      found = 1;
+      break;
+    }
   }
-  for (const RSDocumentMetadata *md = chain->first; md; md = md->next) {
-    if (md->id == docId && !(md->flags & Document_Deleted)) {
-      return 1;
+  pthread_rwlock_unlock(lock);
+  return found;
+}
+
+DocTableCursor DocTable_Cursor(const DocTable *t) {
+  DocTableCursor c = {.t = t, .epoch = t->maxDocId, .shard = 0, .bucket = 0, .ref = DMD_REF_NIL};
+  return c;
+}
+
+size_t DocTableCursor_NextBatch(DocTableCursor *c, const RSDocumentMetadata **out, size_t n) {
+  const DocTable *t = c->t;
+  size_t count = 0;
+
+  while (count < n && c->shard < DOCTABLE_NUM_SHARDS) {
+    pthread_rwlock_t *lock = (pthread_rwlock_t *)&t->shardLocks[c->shard];
+    pthread_rwlock_rdlock(lock);
+
+    const RSDocumentMetadata *cur;
+    RSDocumentMetadata *resume = NULL;
+    if (c->ref != DMD_REF_NIL) {
+      // Continue from the entry the previous batch stopped at. If it was
+      // unchained in the meantime its next link is nil, which ends the
+      // bucket early; our reference kept the struct itself alive
+      resume = DMD_Deref(c->ref);
+      c->ref = DMD_REF_NIL;
+      cur = resume;
+    } else {
+      cur = c->bucket < t->cap ? DMD_Deref(t->buckets[c->bucket].first) : NULL;
+    }
+
+    while (count < n) {
+      if (!cur) {
+        c->bucket += DOCTABLE_NUM_SHARDS;
+        if (c->bucket >= t->cap) {
+          break;
+        }
+        cur = DMD_Deref(t->buckets[c->bucket].first);
+        continue;
+      }
+      if (cur->id <= c->epoch && !(DMD_Flags(cur) & Document_Deleted)) {
+        out[count++] = cur;
+      }
+      cur = DMD_Deref(cur->next);
+    }
+
+    if (count == n) {
+      if (cur) {
+        // Batch filled mid-chain: pin the first unprocessed entry for resume
+        DMD_Incref((RSDocumentMetadata *)cur);
+        c->ref = cur->selfRef;
+      } else {
+        // Filled exactly at the chain's end - move past the bucket so the
+        // next batch does not replay it
+        c->bucket += DOCTABLE_NUM_SHARDS;
+      }
+    }
+    if (resume) {
+      DMD_Decref(resume);
+    }
+    pthread_rwlock_unlock(lock);
+
+    if (c->ref == DMD_REF_NIL && c->bucket >= t->cap) {
+      ++c->shard;
+      c->bucket = c->shard;
     }
   }
-  return 0;
+  return count;
+}
+
+void DocTableCursor_Stop(DocTableCursor *c) {
+  if (c->ref != DMD_REF_NIL) {
+    DMD_Decref(DMD_Deref(c->ref));
+    c->ref = DMD_REF_NIL;
+  }
 }
 
 RSDocumentMetadata *DocTable_GetByKeyR(const DocTable *t, RedisModuleString *s) {
@@ -116,7 +322,10 @@ static inline void DocTable_Set(DocTable *t, t_docId docId, RSDocumentMetadata *
     /* We have to grow the array capacity.
      * We only grow till we reach maxSize, then we starts to add the dmds to
      * the already existing chains.
+     * Growth moves the whole bucket array, so it must exclude every reader -
+     * take all the shard locks for its duration
      */
+    docTableLockAllShards(t);
     size_t oldcap = t->cap;
     // We grow by half of the current capacity with maximum of 1m
     t->cap += 1 + (t->cap ? MIN(t->cap / 2, 1024 * 1024) : 1);
@@ -125,29 +334,33 @@ static inline void DocTable_Set(DocTable *t, t_docId docId, RSDocumentMetadata *
 
     t->buckets = rm_realloc(t->buckets, t->cap * sizeof(DMDChain));
     for (; oldcap < t->cap; oldcap++) {
-      t->buckets[oldcap].first = NULL;
-      t->buckets[oldcap].last = NULL;
+      t->buckets[oldcap].first = DMD_REF_NIL;
+      t->buckets[oldcap].last = DMD_REF_NIL;
     }
+    docTableUnlockAllShards(t);
   }
 
+  pthread_rwlock_t *lock = &t->shardLocks[docTableShard(bucket)];
+  pthread_rwlock_wrlock(lock);
   DMDChain *chain = &t->buckets[bucket];
   DMD_Incref(dmd);
 
   // Adding the dmd to the chain
   if (DMDChain_IsEmpty(chain)) {
-    chain->first = chain->last = dmd;
+    chain->first = chain->last = dmd->selfRef;
   } else {
-    chain->last->next = dmd;
+    DMD_Deref(chain->last)->next = dmd->selfRef;
     dmd->prev = chain->last;
-    dmd->next = NULL;
-    chain->last = dmd;
+    dmd->next = DMD_REF_NIL;
+    chain->last = dmd->selfRef;
   }
+  pthread_rwlock_unlock(lock);
   DocTable_IdArrayPut(t, docId, dmd->keyPtr);
 }
 
 /** Get the docId of a key if it exists in the table, or 0 if it doesnt */
 t_docId DocTable_GetId(const DocTable *dt, const char *s, size_t n) {
-  return DocIdMap_Get(&dt->dim, s, n);
+  return DocIdMap_Get(&dt->dim, dt, s, n);
 }
 
 /* Set the payload for a document. Returns 1 if we set the payload, 0 if we couldn't find the
@@ -174,7 +387,7 @@ int DocTable_SetPayload(DocTable *t, t_docId docId, const char *data, size_t len
   dmd->payload->len = len;
   memcpy(dmd->payload->data, data, len);
 
-  dmd->flags |= Document_HasPayload;
+  DMD_SetFlags(dmd, Document_HasPayload);
   t->memsize += len;
   return 1;
 }
@@ -194,13 +407,13 @@ int DocTable_SetSortingVector(DocTable *t, t_docId docId, RSSortingVector *v) {
       SortingVector_Free(dmd->sortVector);
     }
     dmd->sortVector = NULL;
-    dmd->flags &= ~Document_HasSortVector;
+    DMD_ClearFlags(dmd, Document_HasSortVector);
     return 1;
   }
 
   /* Set th new vector and the flags accordingly */
   dmd->sortVector = v;
-  dmd->flags |= Document_HasSortVector;
+  DMD_SetFlags(dmd, Document_HasSortVector);
   t->sortablesSize += RSSortingVector_GetMemorySize(v);
 
   return 1;
@@ -213,7 +426,7 @@ int DocTable_SetByteOffsets(DocTable *t, t_docId docId, RSByteOffsets *v) {
   }
 
   dmd->byteOffsets = v;
-  dmd->flags |= Document_HasOffsetVector;
+  DMD_SetFlags(dmd, Document_HasOffsetVector);
   return 1;
 }
 
@@ -223,8 +436,9 @@ int DocTable_SetByteOffsets(DocTable *t, t_docId docId, RSByteOffsets *v) {
  * Return 0 if the document is already in the index  */
 t_docId DocTable_Put(DocTable *t, const char *s, size_t n, double score, u_char flags,
                      const char *payload, size_t payloadSize) {
+  RM_ALLOC_TAG_SCOPE(RM_TAG_DOCTABLE);
 
-  t_docId xid = DocIdMap_Get(&t->dim, s, n);
+  t_docId xid = DocIdMap_Get(&t->dim, t, s, n);
   // if the document is already in the index, return 0
   if (xid) {
     return 0;
@@ -243,12 +457,10 @@ t_docId DocTable_Put(DocTable *t, const char *s, size_t n, double score, u_char
     t->memsize += payloadSize + sizeof(RSPayload);
   }
 
-  sds keyPtr = sdsnewlen(s, n);
-
-  RSDocumentMetadata *dmd = rm_calloc(1, sizeof(RSDocumentMetadata));
-  dmd->keyPtr = keyPtr;
+  RSDocumentMetadata *dmd = DMD_SlabGet();
+  size_t keyBytes = dmdAssignKey(t, dmd, s, n);
   dmd->score = score;
-  dmd->flags = flags;
+  DMD_InitFlags(dmd, flags);
   dmd->payload = dpl;
   dmd->maxFreq = 1;
   dmd->id = docId;
@@ -256,8 +468,8 @@ t_docId DocTable_Put(DocTable *t, const char *s, size_t n, double score, u_char
 
   DocTable_Set(t, docId, dmd);
   ++t->size;
-  t->memsize += sizeof(RSDocumentMetadata) + sdsAllocSize(keyPtr);
-  DocIdMap_Put(&t->dim, s, n, docId);
+  t->memsize += sizeof(RSDocumentMetadata) + keyBytes;
+  DocIdMap_Put(&t->dim, t, s, n, docId);
   return docId;
 }
 
@@ -288,8 +500,7 @@ const char *DocTable_GetKey(DocTable *t, t_docId docId, size_t *lenp) {
     *lenp = 0;
     return NULL;
   }
-  *lenp = sdslen(dmd->keyPtr);
-  return dmd->keyPtr;
+  return DMD_KeyPtrLen(dmd, lenp);
 }
 
 /* Get the score for a document from the table. Returns 0 if docId is not in the table. */
@@ -302,21 +513,23 @@ void DMD_Free(RSDocumentMetadata *md) {
   if (md->payload) {
     rm_free(md->payload->data);
     rm_free(md->payload);
-    md->flags &= ~Document_HasPayload;
+    DMD_ClearFlags(md, Document_HasPayload);
     md->payload = NULL;
   }
   if (md->sortVector) {
     SortingVector_Free(md->sortVector);
     md->sortVector = NULL;
-    md->flags &= ~Document_HasSortVector;
+    DMD_ClearFlags(md, Document_HasSortVector);
   }
   if (md->byteOffsets) {
     RSByteOffsets_Free(md->byteOffsets);
     md->byteOffsets = NULL;
-    md->flags &= ~Document_HasOffsetVector;
+    DMD_ClearFlags(md, Document_HasOffsetVector);
   }
   sdsfree(md->keyPtr);
-  rm_free(md);
+  DMDKeyPrefix_Decref(md->keyPrefix);
+  md->keyPrefix = NULL;
+  DMD_SlabRelease(md);
 }
 
 void DocTable_Free(DocTable *t) {
@@ -325,38 +538,51 @@ void DocTable_Free(DocTable *t) {
     if (DMDChain_IsEmpty(chain)) {
       continue;
     }
-    RSDocumentMetadata *md = chain->first;
+    RSDocumentMetadata *md = DMD_Deref(chain->first);
     while (md) {
-      RSDocumentMetadata *next = md->next;
+      RSDocumentMetadata *next = DMD_Deref(md->next);
       DMD_Free(md);
       md = next;
     }
   }
   rm_free(t->buckets);
   rm_free(t->idmap);
+  rm_free(t->deletedMask);
   DocIdMap_Free(&t->dim);
+  for (int i = 0; i < DOCTABLE_NUM_SHARDS; i++) {
+    pthread_rwlock_destroy(&t->shardLocks[i]);
+  }
+  if (t->prefixes) {
+    // Every document dropped its reference above; releasing the intern map's
+    // own reference frees the prefix storage
+    TrieMap_Free(t->prefixes, prefixDecrefCb);
+    t->prefixes = NULL;
+  }
 }
 
 static void DocTable_DmdUnchain(DocTable *t, RSDocumentMetadata *md) {
   uint32_t bucketIndex = DocTable_GetBucket(t, md->id);
+  pthread_rwlock_t *lock = &t->shardLocks[docTableShard(bucketIndex)];
+  pthread_rwlock_wrlock(lock);
   DMDChain *dmdChain = &t->buckets[bucketIndex];
 
-  if (dmdChain->first == md) {
+  if (dmdChain->first == md->selfRef) {
     dmdChain->first = md->next;
   }
 
-  if (dmdChain->last == md) {
+  if (dmdChain->last == md->selfRef) {
     dmdChain->last = md->prev;
   }
 
-  if (md->prev) {
-    md->prev->next = md->next;
+  if (md->prev != DMD_REF_NIL) {
+    DMD_Deref(md->prev)->next = md->next;
   }
-  if (md->next) {
-    md->next->prev = md->prev;
+  if (md->next != DMD_REF_NIL) {
+    DMD_Deref(md->next)->prev = md->prev;
   }
-  md->next = NULL;
-  md->prev = NULL;
+  md->next = DMD_REF_NIL;
+  md->prev = DMD_REF_NIL;
+  pthread_rwlock_unlock(lock);
 }
 
 int DocTable_Delete(DocTable *t, const char *s, size_t n) {
@@ -369,7 +595,7 @@ int DocTable_Delete(DocTable *t, const char *s, size_t n) {
 }
 
 RSDocumentMetadata *DocTable_Pop(DocTable *t, const char *s, size_t n) {
-  t_docId docId = DocIdMap_Get(&t->dim, s, n);
+  t_docId docId = DocIdMap_Get(&t->dim, t, s, n);
   DocTable_IdArrayDel(t, docId);
 
   if (docId && docId <= t->maxDocId) {
@@ -379,10 +605,23 @@ RSDocumentMetadata *DocTable_Pop(DocTable *t, const char *s, size_t n) {
       return NULL;
     }
 
-    md->flags |= Document_Deleted;
+    DMD_SetFlags(md, Document_Deleted);
 
+    // record the id in the deleted bitmap for decode-time skipping
+    size_t byte = docId >> 3;
+    if (byte >= t->deletedMaskCap) {
+      size_t newCap = (t->maxDocId >> 3) + 64;
+      t->deletedMask = rm_realloc(t->deletedMask, newCap);
+      memset(t->deletedMask + t->deletedMaskCap, 0, newCap - t->deletedMaskCap);
+      t->deletedMaskCap = newCap;
+    }
+    t->deletedMask[byte] |= 1 << (docId & 7);
+    ++t->deletedCount;
+
+    // Delete the mapping while the metadata is still resolvable - the map
+    // compares long keys through it
+    DocIdMap_Delete(&t->dim, t, s, n);
     DocTable_DmdUnchain(t, md);
-    DocIdMap_Delete(&t->dim, s, n);
     --t->size;
 
     return md;
@@ -401,16 +640,18 @@ void DocTable_RdbSave(DocTable *t, RedisModuleIO *rdb) {
     if (DMDChain_IsEmpty(&t->buckets[i])) {
       continue;
     }
-    RSDocumentMetadata *dmd = t->buckets[i].first;
+    RSDocumentMetadata *dmd = DMD_Deref(t->buckets[i].first);
     while (dmd) {
 
-      RedisModule_SaveStringBuffer(rdb, dmd->keyPtr, sdslen(dmd->keyPtr));
+      size_t fullLen;
+      const char *fullKey = DMD_KeyPtrLen(dmd, &fullLen);
+      RedisModule_SaveStringBuffer(rdb, fullKey, fullLen);
       RedisModule_SaveUnsigned(rdb, dmd->id);
-      RedisModule_SaveUnsigned(rdb, dmd->flags);
+      RedisModule_SaveUnsigned(rdb, DMD_Flags(dmd));
       RedisModule_SaveUnsigned(rdb, dmd->maxFreq);
       RedisModule_SaveUnsigned(rdb, dmd->len);
       RedisModule_SaveFloat(rdb, dmd->score);
-      if (dmd->flags & Document_HasPayload) {
+      if (DMD_Flags(dmd) & Document_HasPayload) {
         if (dmd->payload) {
           // save an extra space for the null terminator to make the payload null terminated on
           RedisModule_SaveStringBuffer(rdb, dmd->payload->data, dmd->payload->len + 1);
@@ -419,11 +660,11 @@ void DocTable_RdbSave(DocTable *t, RedisModuleIO *rdb) {
         }
       }
 
-      if (dmd->flags & Document_HasSortVector) {
+      if (DMD_Flags(dmd) & Document_HasSortVector) {
         SortingVector_RdbSave(rdb, dmd->sortVector);
       }
 
-      if (dmd->flags & Document_HasOffsetVector) {
+      if (DMD_Flags(dmd) & Document_HasOffsetVector) {
         Buffer tmp;
         Buffer_Init(&tmp, 16);
         RSByteOffsets_Serialize(dmd->byteOffsets, &tmp);
@@ -431,7 +672,7 @@ void DocTable_RdbSave(DocTable *t, RedisModuleIO *rdb) {
         Buffer_Free(&tmp);
       }
       ++elements_written;
-      dmd = dmd->next;
+      dmd = DMD_Deref(dmd->next);
     }
   }
   assert(elements_written + 1 == t->size);
@@ -462,7 +703,7 @@ void DocTable_RdbLoad(DocTable *t, RedisModuleIO *rdb, int encver) {
   for (size_t i = 1; i < t->size; i++) {
     size_t len;
 
-    RSDocumentMetadata *dmd = rm_calloc(1, sizeof(RSDocumentMetadata));
+    RSDocumentMetadata *dmd = DMD_SlabGet();
     char *tmpPtr = RedisModule_LoadStringBuffer(rdb, &len);
     if (encver < INDEX_MIN_BINKEYS_VERSION) {
       // Previous versions would encode the NUL byte
@@ -472,7 +713,7 @@ void DocTable_RdbLoad(DocTable *t, RedisModuleIO *rdb, int encver) {
     dmd->keyPtr = sdsnewlen(tmpPtr, len);
     rm_free(tmpPtr);
 
-    dmd->flags = RedisModule_LoadUnsigned(rdb);
+    DMD_InitFlags(dmd, RedisModule_LoadUnsigned(rdb));
     dmd->maxFreq = 1;
     dmd->len = 1;
     if (encver > 1) {
@@ -488,70 +729,197 @@ void DocTable_RdbLoad(DocTable *t, RedisModuleIO *rdb, int encver) {
     dmd->score = RedisModule_LoadFloat(rdb);
     dmd->payload = NULL;
     // read payload if set
-    if (dmd->flags & Document_HasPayload) {
+    if (DMD_Flags(dmd) & Document_HasPayload) {
       dmd->payload = RedisModule_Alloc(sizeof(RSPayload));
       dmd->payload->data = RedisModule_LoadStringBuffer(rdb, &dmd->payload->len);
       dmd->payload->len--;
       t->memsize += dmd->payload->len + sizeof(RSPayload);
     }
     dmd->sortVector = NULL;
-    if (dmd->flags & Document_HasSortVector) {
+    if (DMD_Flags(dmd) & Document_HasSortVector) {
       dmd->sortVector = SortingVector_RdbLoad(rdb, encver);
       t->sortablesSize += RSSortingVector_GetMemorySize(dmd->sortVector);
     }
 
-    if (dmd->flags & Document_HasOffsetVector) {
+    if (DMD_Flags(dmd) & Document_HasOffsetVector) {
       size_t nTmp = 0;
       char *tmp = RedisModule_LoadStringBuffer(rdb, &nTmp);
       Buffer *bufTmp = Buffer_Wrap(tmp, nTmp);
-      dmd->byteOffsets = LoadByteOffsets(bufTmp);
+      dmd->byteOffsets = LoadByteOffsets(bufTmp, encver);
       free(bufTmp);
       rm_free(tmp);
     }
 
-    if (dmd->flags & Document_Deleted) {
+    if (DMD_Flags(dmd) & Document_Deleted) {
       DMD_Free(dmd);
     } else {
-      DocIdMap_Put(&t->dim, dmd->keyPtr, sdslen(dmd->keyPtr), dmd->id);
+      // Re-assign the key through the intern machinery so loaded tables get
+      // the same prefix sharing as freshly built ones
+      sds fullKey = dmd->keyPtr;
+      size_t keyBytes = dmdAssignKey(t, dmd, fullKey, sdslen(fullKey));
+      sdsfree(fullKey);
       DocTable_Set(t, dmd->id, dmd);
-      t->memsize += sizeof(RSDocumentMetadata) + len;
+      size_t kn;
+      const char *ks = DMD_KeyPtrLen(dmd, &kn);
+      DocIdMap_Put(&t->dim, t, ks, kn, dmd->id);
+      t->memsize += sizeof(RSDocumentMetadata) + keyBytes;
     }
   }
 }
 
-DocIdMap NewDocIdMap() {
+#define DOCIDMAP_INITIAL_BUCKETS 64
 
-  TrieMap *m = NewTrieMap();
-  return (DocIdMap){m};
+static uint64_t docIdMapHash(const char *s, size_t n) {
+  uint64_t h = fnv_64a_buf((void *)s, n, 0xcbf29ce484222325ULL);
+  return h ? h : 1;  // 0 is the empty-bucket marker
 }
 
-t_docId DocIdMap_Get(const DocIdMap *m, const char *s, size_t n) {
+/* How far a bucket sits from its ideal slot. Robin hood keeps these distances
+ * balanced: probes never run longer than the resident's own distance */
+static inline size_t probeDist(uint64_t hash, size_t pos, size_t mask) {
+  return (pos - (size_t)hash) & mask;
+}
 
-  void *val = TrieMap_Find(m->tm, (char *)s, n);
-  if (val && val != TRIEMAP_NOTFOUND) {
-    return *((t_docId *)val);
+/* Does the bucket hold `s`? Short keys compare inline; longer ones resolve
+ * through the document metadata, whose (prefix-compressed) storage is the
+ * single authoritative copy of the key bytes */
+static int bucketKeyEquals(const DocIdMap *m, const DocTable *t, const DocIdMapBucket *b,
+                           const char *s, size_t n) {
+  if (b->keyLen != n) {
+    return 0;
+  }
+  if (n <= DOCIDMAP_INLINE_KEYLEN) {
+    return !memcmp(b->ikey, s, n);
+  }
+  const RSDocumentMetadata *dmd = DocTable_Get((DocTable *)t, b->docId);
+  if (!dmd) {
+    return 0;
+  }
+  size_t plen = dmd->keyPrefix ? dmd->keyPrefix->len : 0;
+  if (plen && memcmp(dmd->keyPrefix->str, s, plen)) {
+    return 0;
+  }
+  return !memcmp(dmd->keyPtr, s + plen, n - plen);
+}
+
+/* Robin-hood insertion of a fully-formed bucket. The caller has already
+ * ensured capacity and the absence of the key */
+static void docIdMapInsert(DocIdMap *m, DocIdMapBucket b) {
+  size_t mask = m->nbuckets - 1;
+  size_t pos = b.hash & mask;
+  size_t dist = 0;
+  for (;;) {
+    DocIdMapBucket *cur = &m->buckets[pos];
+    if (!cur->hash) {
+      *cur = b;
+      m->nused++;
+      return;
+    }
+    size_t curDist = probeDist(cur->hash, pos, mask);
+    if (curDist < dist) {
+      // The resident is closer to home than we are - take its slot, keep
+      // inserting the displaced bucket
+      DocIdMapBucket tmp = *cur;
+      *cur = b;
+      b = tmp;
+      dist = curDist;
+    }
+    pos = (pos + 1) & mask;
+    dist++;
   }
-  return 0;
 }
 
-void *_docIdMap_replace(void *oldval, void *newval) {
-  if (oldval) {
-    rm_free(oldval);
+static void docIdMapGrow(DocIdMap *m) {
+  DocIdMapBucket *old = m->buckets;
+  size_t oldCount = m->nbuckets;
+  m->nbuckets *= 2;
+  m->buckets = rm_calloc(m->nbuckets, sizeof(*m->buckets));
+  m->nused = 0;
+  for (size_t i = 0; i < oldCount; i++) {
+    if (old[i].hash) {
+      docIdMapInsert(m, old[i]);  // key storage moves with the bucket
+    }
   }
-  return newval;
+  rm_free(old);
 }
 
-void DocIdMap_Put(DocIdMap *m, const char *s, size_t n, t_docId docId) {
+/* Locate the bucket holding the key, or SIZE_MAX */
+static size_t docIdMapFind(const DocIdMap *m, const DocTable *t, const char *s, size_t n,
+                           uint64_t hash) {
+  size_t mask = m->nbuckets - 1;
+  size_t pos = hash & mask;
+  size_t dist = 0;
+  for (;;) {
+    const DocIdMapBucket *cur = &m->buckets[pos];
+    if (!cur->hash || probeDist(cur->hash, pos, mask) < dist) {
+      return SIZE_MAX;  // the key would have been placed here
+    }
+    if (cur->hash == hash && bucketKeyEquals(m, t, cur, s, n)) {
+      return pos;
+    }
+    pos = (pos + 1) & mask;
+    dist++;
+  }
+}
 
-  t_docId *pd = rm_malloc(sizeof(t_docId));
-  *pd = docId;
-  TrieMap_Add(m->tm, (char *)s, n, pd, _docIdMap_replace);
+DocIdMap NewDocIdMap() {
+  DocIdMap m = {0};
+  m.nbuckets = DOCIDMAP_INITIAL_BUCKETS;
+  m.buckets = rm_calloc(m.nbuckets, sizeof(*m.buckets));
+  return m;
+}
+
+t_docId DocIdMap_Get(const DocIdMap *m, const DocTable *t, const char *s, size_t n) {
+  size_t pos = docIdMapFind(m, t, s, n, docIdMapHash(s, n));
+  return pos == SIZE_MAX ? 0 : m->buckets[pos].docId;
+}
+
+void DocIdMap_Put(DocIdMap *m, const DocTable *t, const char *s, size_t n, t_docId docId) {
+  uint64_t hash = docIdMapHash(s, n);
+  size_t pos = docIdMapFind(m, t, s, n, hash);
+  if (pos != SIZE_MAX) {
+    m->buckets[pos].docId = docId;
+    return;
+  }
+  // Grow at 75% load
+  if (m->nused + 1 > m->nbuckets - m->nbuckets / 4) {
+    docIdMapGrow(m);
+  }
+  DocIdMapBucket b = {.hash = hash, .docId = docId, .keyLen = n};
+  if (n <= DOCIDMAP_INLINE_KEYLEN) {
+    memcpy(b.ikey, s, n);
+  }
+  docIdMapInsert(m, b);
 }
 
 void DocIdMap_Free(DocIdMap *m) {
-  TrieMap_Free(m->tm, RedisModule_Free);
+  rm_free(m->buckets);
+  m->buckets = NULL;
+  m->nbuckets = m->nused = 0;
+}
+
+int DocIdMap_Delete(DocIdMap *m, const DocTable *t, const char *s, size_t n) {
+  size_t pos = docIdMapFind(m, t, s, n, docIdMapHash(s, n));
+  if (pos == SIZE_MAX) {
+    return 0;
+  }
+  // Backward-shift deletion keeps probe chains tight without tombstones
+  size_t mask = m->nbuckets - 1;
+  size_t hole = pos;
+  for (;;) {
+    size_t next = (hole + 1) & mask;
+    DocIdMapBucket *nb = &m->buckets[next];
+    if (!nb->hash || probeDist(nb->hash, next, mask) == 0) {
+      break;
+    }
+    m->buckets[hole] = *nb;
+    hole = next;
+  }
+  memset(&m->buckets[hole], 0, sizeof(m->buckets[hole]));
+  m->nused--;
+  return 1;
 }
 
-int DocIdMap_Delete(DocIdMap *m, const char *s, size_t n) {
-  return TrieMap_Delete(m->tm, (char *)s, n, rm_free);
+size_t DocIdMap_MemUsage(const DocIdMap *m) {
+  return m->nbuckets * sizeof(*m->buckets);
 }
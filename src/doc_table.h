@@ -2,46 +2,90 @@
 #define __DOC_TABLE_H__
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include "redismodule.h"
-#include "dep/triemap/triemap.h"
 #include "redisearch.h"
 #include "sortable.h"
 #include "byte_offsets.h"
 #include "rmutil/sds.h"
+#include "rmalloc.h"
+#include "dep/triemap/triemap.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
-// Retrieves the pointer and length for the document's key.
-static inline const char *DMD_KeyPtrLen(const RSDocumentMetadata *dmd, size_t *len) {
-  if (len) {
-    *len = sdslen(dmd->keyPtr);
+/* A key prefix shared by many documents of one table: refcounted by every
+ * DMD using it plus the table's intern map */
+typedef struct DMDKeyPrefix {
+  uint32_t len;
+  uint32_t refcount;
+  char str[];
+} DMDKeyPrefix;
+
+static inline void DMDKeyPrefix_Decref(DMDKeyPrefix *p) {
+  if (p && !--p->refcount) {
+    rm_free(p);
   }
-  return dmd->keyPtr;
 }
 
+/* Full length of the document's key, prefix included */
+static inline size_t DMD_KeyLen(const RSDocumentMetadata *dmd) {
+  return (dmd->keyPrefix ? dmd->keyPrefix->len : 0) + sdslen(dmd->keyPtr);
+}
+
+/* Retrieves the pointer and length for the document's key. For
+ * prefix-compressed keys the bytes are materialized into a per-thread scratch
+ * buffer: the pointer stays valid only until the next call on the same
+ * thread. Copy it if it must outlive that */
+const char *DMD_KeyPtrLen(const RSDocumentMetadata *dmd, size_t *len);
+
 // Convenience function to create a RedisModuleString from the document's key
 static inline RedisModuleString *DMD_CreateKeyString(const RSDocumentMetadata *dmd,
                                                      RedisModuleCtx *ctx) {
-  return RedisModule_CreateString(ctx, dmd->keyPtr, sdslen(dmd->keyPtr));
+  size_t n;
+  const char *s = DMD_KeyPtrLen(dmd, &n);
+  return RedisModule_CreateString(ctx, s, n);
 }
 
-/* Map between external id an incremental id */
+/* Map between external id an incremental id. An open-addressing robin-hood
+ * table: short keys live inline in their bucket, so the common
+ * GetId/Put/Delete probe touches one or two cache lines instead of chasing a
+ * trie node per character group. Longer keys are not stored at all - the
+ * bucket's docId resolves them against the document metadata's own
+ * (prefix-compressed) key storage, so each key's bytes exist exactly once */
+#define DOCIDMAP_INLINE_KEYLEN 16
+
+struct DocTable;
+
+typedef struct {
+  uint64_t hash;  // 0 marks an empty bucket
+  t_docId docId;
+  uint32_t keyLen;
+  char ikey[DOCIDMAP_INLINE_KEYLEN];  // only when keyLen <= DOCIDMAP_INLINE_KEYLEN
+} DocIdMapBucket;
+
 typedef struct {
-  TrieMap *tm;
+  DocIdMapBucket *buckets;
+  size_t nbuckets;  // always a power of two
+  size_t nused;
 } DocIdMap;
 
 DocIdMap NewDocIdMap();
 /* Get docId from a did-map. Returns 0  if the key is not in the map */
-t_docId DocIdMap_Get(const DocIdMap *m, const char *s, size_t n);
+t_docId DocIdMap_Get(const DocIdMap *m, const struct DocTable *t, const char *s, size_t n);
 
-/* Put a new doc id in the map if it does not already exist */
-void DocIdMap_Put(DocIdMap *m, const char *s, size_t n, t_docId docId);
+/* Put a new doc id in the map if it does not already exist. The document's
+ * metadata must already be resolvable through the table */
+void DocIdMap_Put(DocIdMap *m, const struct DocTable *t, const char *s, size_t n, t_docId docId);
 
-int DocIdMap_Delete(DocIdMap *m, const char *s, size_t n);
+/* Delete a mapping. The document's metadata must still be resolvable */
+int DocIdMap_Delete(DocIdMap *m, const struct DocTable *t, const char *s, size_t n);
 /* Free the doc id map */
 void DocIdMap_Free(DocIdMap *m);
 
+/* Resident bytes of the map */
+size_t DocIdMap_MemUsage(const DocIdMap *m);
+
 /* The DocTable is a simple mapping between incremental ids and the original document key and
  * metadata. It is also responsible for storing the id incrementor for the index and assigning
  * new
@@ -51,12 +95,45 @@ void DocIdMap_Free(DocIdMap *m);
  * the
  * same key. This may result in document duplication in results  */
 
+/* DMDs live in a process-wide paged slab: fixed-size pages addressed by a
+ * 32-bit (page,slot) reference. Chains link entries by reference rather than
+ * by pointer, halving the per-document link overhead, and sequentially
+ * allocated slots keep whole-table sweeps page-local. Reference 0 is
+ * reserved as the nil link. Allocation and release stay GIL-only, like the
+ * pool they replace; concurrent readers only dereference */
+#define DMD_SLAB_PAGE_BITS 12
+#define DMD_SLAB_PAGE_SIZE (1u << DMD_SLAB_PAGE_BITS)
+#define DMD_SLAB_SLOT_MASK (DMD_SLAB_PAGE_SIZE - 1)
+#define DMD_REF_NIL 0u
+
+/* Page directory of the slab. Grown by publishing a bigger copy, never by
+ * realloc, so a reader holding the old directory keeps a usable view (see
+ * DMD_SlabGet in doc_table.c) */
+extern RSDocumentMetadata **DMD_SlabPages;
+
+/* Resolve a slab reference to its entry; the nil reference resolves to NULL */
+static inline RSDocumentMetadata *DMD_Deref(uint32_t ref) {
+  if (ref == DMD_REF_NIL) {
+    return NULL;
+  }
+  RSDocumentMetadata **pages = __atomic_load_n(&DMD_SlabPages, __ATOMIC_ACQUIRE);
+  return &pages[ref >> DMD_SLAB_PAGE_BITS][ref & DMD_SLAB_SLOT_MASK];
+}
+
 typedef struct {
-  struct RSDocumentMetadata_s *first;
-  struct RSDocumentMetadata_s *last;
+  uint32_t first;
+  uint32_t last;
 } DMDChain;
 
-typedef struct {
+/* Bucket chains are guarded by a fixed set of shard rwlocks (bucket modulo
+ * shard count): readers resolving metadata take one shard read lock, writers
+ * chaining/unchaining a document take one shard write lock, and bucket-array
+ * growth takes every shard. Whole-table iteration (RDB save, drop,
+ * DocTable_ForEach users) and dmd lifetime management remain GIL-only, as
+ * before */
+#define DOCTABLE_NUM_SHARDS 32
+
+typedef struct DocTable {
   size_t size;
   // the maximum size this table is allowed to grow to
   size_t maxSize;
@@ -69,11 +146,62 @@ typedef struct {
   DocIdMap dim;
   const void **idmap;
   size_t idmapLen;
+
+  /* Interned key prefixes (bytes up to and including the last ':'), shared
+   * by every document whose key starts with them. NULL values never enter;
+   * disabled (left NULL-populated) when the id-array API mode is active */
+  TrieMap *prefixes;
+
+  pthread_rwlock_t shardLocks[DOCTABLE_NUM_SHARDS];
+
+  /* Bitmap of deleted docIds (ids are never reused), maintained by DocTable_Pop and consulted
+   * inside the posting decode loop so delete-heavy workloads skip dead entries before they
+   * bounce through the iterator protocol and the metadata lookup. Not persisted: after a
+   * restart the regular metadata check filters until the next deletes repopulate it */
+  uint8_t *deletedMask;
+  size_t deletedMaskCap;  // in bytes
+  // Number of documents ever deleted; GC scheduling reads it to gate and prioritize work
+  size_t deletedCount;
 } DocTable;
 
+/* Test whether a docId was deleted, through the deleted-id bitmap */
+static inline int DocTable_IsDeleted(const DocTable *t, t_docId docId) {
+  return (docId >> 3) < t->deletedMaskCap && (t->deletedMask[docId >> 3] & (1 << (docId & 7)));
+}
+
+/* The flag byte lives in the low bits of dmd->flagsRefs; the reference count
+ * occupies the bits above it, so one atomic word covers both */
+#define DMD_FLAGS_MASK 0xffu
+#define DMD_REF_UNIT (1u << 8)
+
+/* Read the flag byte. Safe from any thread */
+static inline RSDocumentFlags DMD_Flags(const RSDocumentMetadata *dmd) {
+  return (RSDocumentFlags)(__atomic_load_n(&dmd->flagsRefs, __ATOMIC_ACQUIRE) & DMD_FLAGS_MASK);
+}
+
+/* Atomically raise flag bits on a (possibly published) dmd */
+static inline void DMD_SetFlags(RSDocumentMetadata *dmd, RSDocumentFlags flags) {
+  __atomic_fetch_or(&dmd->flagsRefs, (uint32_t)flags & DMD_FLAGS_MASK, __ATOMIC_RELEASE);
+}
+
+/* Atomically drop flag bits on a (possibly published) dmd */
+static inline void DMD_ClearFlags(RSDocumentMetadata *dmd, RSDocumentFlags flags) {
+  __atomic_fetch_and(&dmd->flagsRefs, ~(uint32_t)flags, __ATOMIC_RELEASE);
+}
+
+/* Assign the initial flag byte of a freshly allocated dmd that no other
+ * thread can see yet (refcount bits start at zero). Masked like the write
+ * accessors, mirroring the truncation the old 8-bit bitfield applied */
+static inline void DMD_InitFlags(RSDocumentMetadata *dmd, RSDocumentFlags flags) {
+  dmd->flagsRefs = (uint32_t)flags & DMD_FLAGS_MASK;
+}
+
 /* increasing the ref count of the given dmd */
-#define DMD_Incref(md) \
-  if (md) ++md->ref_count;
+static inline void DMD_Incref(RSDocumentMetadata *dmd) {
+  if (dmd) {
+    __atomic_add_fetch(&dmd->flagsRefs, DMD_REF_UNIT, __ATOMIC_RELAXED);
+  }
+}
 
 #define DocTable_ForEach(dt, code)          \
   for (size_t i = 1; i < dt->cap; ++i) {    \
@@ -81,13 +209,45 @@ typedef struct {
     if (DMDChain_IsEmpty(chain)) {          \
       continue;                             \
     }                                       \
-    RSDocumentMetadata *dmd = chain->first; \
+    RSDocumentMetadata *dmd = DMD_Deref(chain->first); \
     while (dmd) {                           \
       code;                                 \
-      dmd = dmd->next;                      \
+      dmd = DMD_Deref(dmd->next);           \
     }                                       \
   }
 
+/* Snapshot cursor for bulk table scans (GC sweeps, export tooling). The
+ * cursor pins the table's maxDocId as its epoch at creation - documents added
+ * afterwards are not yielded - and walks the bucket chains shard by shard,
+ * taking each shard lock once per batch instead of once per entry. Entries
+ * come out in chain order, not docId order, and deleted documents are
+ * filtered. Documents deleted while the scan is paused between batches may be
+ * skipped along with the remainder of their chain; scan consumers tolerate
+ * that the same way they tolerate deletions landing right after a batch.
+ * Yielded pointers stay valid for the dmd's lifetime; a caller keeping one
+ * past its own batch processing must DMD_Incref it */
+typedef struct {
+  const DocTable *t;
+  t_docId epoch;
+  uint32_t shard;
+  uint32_t bucket;
+  // Resume reference: the first unprocessed entry of a bucket whose chain
+  // was longer than the batch. The cursor holds one reference on it
+  uint32_t ref;
+} DocTableCursor;
+
+#define DOCTABLE_CURSOR_BATCH 1000
+
+/* Initialize a cursor over the table, pinning the current maxDocId */
+DocTableCursor DocTable_Cursor(const DocTable *t);
+
+/* Fill out with up to n live entries; returns the count, 0 when the scan is
+ * done */
+size_t DocTableCursor_NextBatch(DocTableCursor *c, const RSDocumentMetadata **out, size_t n);
+
+/* Release an unfinished cursor's resume reference. Harmless on a drained one */
+void DocTableCursor_Stop(DocTableCursor *c);
+
 /* Creates a new DocTable with a given capacity */
 DocTable NewDocTable(size_t cap, size_t max_size);
 
@@ -180,7 +340,8 @@ void DMD_Free(RSDocumentMetadata *);
 
 /* Decrement the refcount of the DMD object, freeing it if we're the last reference */
 static inline void DMD_Decref(RSDocumentMetadata *dmd) {
-  if (dmd && !--dmd->ref_count) {
+  // The count hit zero when no refcount bits remain above the flag byte
+  if (dmd && __atomic_sub_fetch(&dmd->flagsRefs, DMD_REF_UNIT, __ATOMIC_ACQ_REL) < DMD_REF_UNIT) {
     DMD_Free(dmd);
   }
 }
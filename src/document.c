@@ -2,6 +2,7 @@
 #include <assert.h>
 
 #include "document.h"
+#include "delta_log.h"
 #include "forward_index.h"
 #include "numeric_filter.h"
 #include "numeric_index.h"
@@ -9,10 +10,13 @@
 #include "rmutil/util.h"
 #include "util/mempool.h"
 #include "spec.h"
+#include "result_cache.h"
 #include "tokenize.h"
 #include "util/logging.h"
 #include "rmalloc.h"
 #include "indexer.h"
+#include "commands.h"
+#include "redis_index.h"
 #include "tag_index.h"
 #include "aggregate/expr/expression.h"
 
@@ -31,6 +35,9 @@ static void freeDocumentContext(void *p) {
   if (aCtx->fwIdx) {
     ForwardIndexFree(aCtx->fwIdx);
   }
+  if (aCtx->pinnedStemmer) {
+    aCtx->pinnedStemmer->Free(aCtx->pinnedStemmer);
+  }
 
   free(aCtx->fspecs);
   free(aCtx->fdatas);
@@ -126,7 +133,17 @@ static int AddDocumentCtx_SetDocument(RSAddDocumentCtx *aCtx, IndexSpec *sp, Doc
 RSAddDocumentCtx *NewAddDocumentCtx(IndexSpec *sp, Document *b, QueryError *status) {
 
   if (!actxPool_g) {
-    actxPool_g = mempool_new(16, allocDocumentContext, freeDocumentContext);
+    // Recycled contexts carry a warmed ForwardIndex: block allocators keep their freed
+    // blocks, the entry hashtable keeps its bucket array, the vvw mempool its writers and
+    // the stemmer survives language-stable workloads - so a steady-state ingest performs no
+    // forward-index allocations at all. Size the warm set to cover every indexing thread
+    // with headroom, rather than a flat 16
+    // Contexts are handed from the submitting thread to the indexer and
+    // back; the per-thread caches keep the recycling (and the struct's cache
+    // lines) on whichever side releases them
+    actxPool_g = mempool_new_shared(4, RSGlobalConfig.indexPoolSize * 2 + 4, allocDocumentContext,
+                             freeDocumentContext);
+    mempool_register(actxPool_g, "addctx");
   }
 
   // Get a new context
@@ -137,6 +154,11 @@ RSAddDocumentCtx *NewAddDocumentCtx(IndexSpec *sp, Document *b, QueryError *stat
   aCtx->docFlags = 0;
   aCtx->client.bc = NULL;
   aCtx->next = NULL;
+  aCtx->deltaLog = sp->deltaLog;
+  if (aCtx->deltaLog) {
+    DeltaLog_Incref(aCtx->deltaLog);
+  }
+  aCtx->effectsSpecName = NULL;
   aCtx->specFlags = sp->flags;
   int indexerOptions = 0;
   if (sp->flags & Index_Temporary) {
@@ -175,6 +197,15 @@ RSAddDocumentCtx *NewAddDocumentCtx(IndexSpec *sp, Document *b, QueryError *stat
 }
 
 static void doReplyFinish(RSAddDocumentCtx *aCtx, RedisModuleCtx *ctx) {
+  // Effect replication: a successfully indexed document ships its computed
+  // postings downstream instead of the verbatim command
+  if (aCtx->effectsSpecName && !(aCtx->stateFlags & ACTX_F_ERRORED) &&
+      !QueryError_HasError(&aCtx->status) && aCtx->doc.docKey) {
+    sds blob = Document_SerializeEffects(aCtx, sdsempty());
+    RedisModule_Replicate(ctx, RS_APPLYDELTA_CMD, "csb", aCtx->effectsSpecName, aCtx->doc.docKey,
+                          blob, sdslen(blob));
+    sdsfree(blob);
+  }
   aCtx->donecb(aCtx, ctx, NULL);
   AddDocumentCtx_Free(aCtx);
 }
@@ -189,7 +220,244 @@ static void threadCallback(void *p) {
   Document_AddToIndexes(p);
 }
 
+/* ---- Effect replication ----
+ *
+ * Blob layout (little-endian):
+ *   u8 version=1 | f64 score | u32 payloadLen | payload bytes |
+ *   u32 maxFreq | u32 totalFreq |                  <- score normalization
+ *   u16 nfields | per field: u16 nameLen | name | u32 valLen | value |
+ *   u32 nterms | per term: u16 len | bytes | u32 freq | u32 noffsets |
+ *                varint fieldMask | u32 offLen | offset varint bytes
+ */
+#define EFFECTS_BLOB_VERSION 1
+
+int SpecSupportsEffectReplication(const IndexSpec *sp) {
+  for (uint16_t i = 0; i < sp->numFields; i++) {
+    if (sp->fields[i].type != FIELD_FULLTEXT || FieldSpec_IsSortable(&sp->fields[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+sds Document_SerializeEffects(RSAddDocumentCtx *aCtx, sds s) {
+  uint8_t ver = EFFECTS_BLOB_VERSION;
+  s = sdscatlen(s, &ver, 1);
+  double score = aCtx->doc.score;
+  s = sdscatlen(s, &score, 8);
+  uint32_t payloadLen = aCtx->doc.payloadSize;
+  s = sdscatlen(s, &payloadLen, 4);
+  if (payloadLen) {
+    s = sdscatlen(s, aCtx->doc.payload, payloadLen);
+  }
+  uint32_t maxFreq = aCtx->fwIdx ? aCtx->fwIdx->maxFreq : 0;
+  uint32_t totalFreq = aCtx->fwIdx ? aCtx->fwIdx->totalFreq : 0;
+  s = sdscatlen(s, &maxFreq, 4);
+  s = sdscatlen(s, &totalFreq, 4);
+
+  // the raw fields, so the replica's keyspace carries the document too - the
+  // verbatim command that used to do this is suppressed in effect mode
+  uint16_t nfields = aCtx->doc.numFields;
+  s = sdscatlen(s, &nfields, 2);
+  for (uint16_t i = 0; i < nfields; i++) {
+    uint16_t nameLen = strlen(aCtx->doc.fields[i].name);
+    s = sdscatlen(s, &nameLen, 2);
+    s = sdscatlen(s, aCtx->doc.fields[i].name, nameLen);
+    size_t vlen = 0;
+    const char *v = aCtx->doc.fields[i].text
+                        ? RedisModule_StringPtrLen(aCtx->doc.fields[i].text, &vlen)
+                        : NULL;
+    uint32_t valLen = vlen;
+    s = sdscatlen(s, &valLen, 4);
+    if (valLen) {
+      s = sdscatlen(s, v, valLen);
+    }
+  }
+
+  uint32_t nterms = 0;
+  size_t ntermsAt = sdslen(s);
+  s = sdscatlen(s, &nterms, 4);
+  if (aCtx->fwIdx) {
+    ForwardIndexIterator it = ForwardIndex_Iterate(aCtx->fwIdx);
+    ForwardIndexEntry *ent;
+    while ((ent = ForwardIndexIterator_Next(&it))) {
+      uint16_t tlen = ent->len;
+      s = sdscatlen(s, &tlen, 2);
+      s = sdscatlen(s, ent->term, tlen);
+      s = sdscatlen(s, &ent->freq, 4);
+      uint32_t noff = ent->vw ? VVW_GetCount(ent->vw) : 0;
+      s = sdscatlen(s, &noff, 4);
+      // the field mask as the same varint flavor the index itself uses
+      Buffer fmb;
+      Buffer_Init(&fmb, 20);
+      BufferWriter fmw = NewBufferWriter(&fmb);
+      WriteVarintFieldMask(ent->fieldMask, &fmw);
+      s = sdscatlen(s, fmb.data, fmb.offset);
+      Buffer_Free(&fmb);
+      uint32_t offLen = ent->vw ? VVW_GetByteLength(ent->vw) : 0;
+      s = sdscatlen(s, &offLen, 4);
+      if (offLen) {
+        s = sdscatlen(s, VVW_GetByteData(ent->vw), offLen);
+      }
+      nterms++;
+    }
+  }
+  memcpy(s + ntermsAt, &nterms, 4);
+  return s;
+}
+
+int ApplyDeltaCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+  if (argc != 4) {
+    return RedisModule_WrongArity(ctx);
+  }
+  RedisModule_AutoMemory(ctx);
+  RedisSearchCtx *sctx = NewSearchCtx(ctx, argv[1], true);
+  if (!sctx) {
+    return RedisModule_ReplyWithError(ctx, "Unknown Index name");
+  }
+  IndexSpec *sp = sctx->spec;
+  size_t blobLen, keyLen;
+  const char *blob = RedisModule_StringPtrLen(argv[3], &blobLen);
+  const char *key = RedisModule_StringPtrLen(argv[2], &keyLen);
+
+  Buffer b = {.data = (char *)blob, .offset = blobLen, .cap = blobLen};
+  BufferReader br = NewBufferReader(&b);
+  BufferReader *rd = &br;
+
+#define NEED(n)                                                   \
+  if (b.offset - rd->pos < (size_t)(n)) {                         \
+    SearchCtx_Free(sctx);                                         \
+    return RedisModule_ReplyWithError(ctx, "Malformed delta");    \
+  }
+  NEED(1 + 8 + 4);
+  uint8_t ver = BUFFER_READ_BYTE(rd);
+  if (ver != EFFECTS_BLOB_VERSION) {
+    SearchCtx_Free(sctx);
+    return RedisModule_ReplyWithError(ctx, "Unsupported delta version");
+  }
+  double score;
+  Buffer_Read(rd, &score, 8);
+  uint32_t payloadLen;
+  Buffer_Read(rd, &payloadLen, 4);
+  NEED(payloadLen);
+  const char *payload = b.data + rd->pos;
+  Buffer_Skip(rd, payloadLen);
+
+  NEED(4 + 4 + 2);
+  uint32_t docMaxFreq, docTotalFreq;
+  Buffer_Read(rd, &docMaxFreq, 4);
+  Buffer_Read(rd, &docTotalFreq, 4);
+  uint16_t nfields;
+  Buffer_Read(rd, &nfields, 2);
+
+  // replace semantics, like the verbatim SAFEADD the delta stands in for
+  if (DocTable_GetId(&sp->docs, key, keyLen)) {
+    if (DocTable_Delete(&sp->docs, key, keyLen)) {
+      --sp->stats.numDocuments;
+    }
+  }
+  t_docId docId =
+      DocTable_Put(&sp->docs, key, keyLen, score, 0, payloadLen ? payload : NULL, payloadLen);
+  if (!docId) {
+    SearchCtx_Free(sctx);
+    return RedisModule_ReplyWithError(ctx, "Could not assign document id");
+  }
+  ++sp->stats.numDocuments;
+  RSDocumentMetadata *md = DocTable_Get(&sp->docs, docId);
+  md->maxFreq = docMaxFreq;
+  md->len = docTotalFreq;
+
+  // mirror the document body into the keyspace hash
+  {
+    RedisModuleKey *k = RedisModule_OpenKey(ctx, argv[2], REDISMODULE_READ | REDISMODULE_WRITE);
+    for (uint16_t i = 0; i < nfields; i++) {
+      NEED(2);
+      uint16_t nameLen;
+      Buffer_Read(rd, &nameLen, 2);
+      NEED(nameLen + 4);
+      const char *name = b.data + rd->pos;
+      Buffer_Skip(rd, nameLen);
+      uint32_t valLen;
+      Buffer_Read(rd, &valLen, 4);
+      NEED(valLen);
+      const char *val = b.data + rd->pos;
+      Buffer_Skip(rd, valLen);
+      if (k) {
+        RedisModuleString *nameS = RedisModule_CreateString(ctx, name, nameLen);
+        RedisModuleString *valS = RedisModule_CreateString(ctx, val, valLen);
+        RedisModule_HashSet(k, 0, nameS, valS, NULL);
+      }
+    }
+    if (k) {
+      RedisModule_CloseKey(k);
+    }
+  }
+
+  NEED(4);
+  uint32_t nterms;
+  Buffer_Read(rd, &nterms, 4);
+  IndexEncoder encoder = InvertedIndex_GetEncoder(sp->flags);
+  for (uint32_t i = 0; i < nterms; i++) {
+    NEED(2);
+    uint16_t tlen;
+    Buffer_Read(rd, &tlen, 2);
+    NEED(tlen + 4 + 4);
+    const char *term = b.data + rd->pos;
+    Buffer_Skip(rd, tlen);
+    uint32_t freq, noff;
+    Buffer_Read(rd, &freq, 4);
+    Buffer_Read(rd, &noff, 4);
+    NEED(1);
+    t_fieldMask fieldMask = ReadVarintFieldMask(rd);
+    NEED(4);
+    uint32_t offLen;
+    Buffer_Read(rd, &offLen, 4);
+    NEED(offLen);
+    const char *offsets = b.data + rd->pos;
+    Buffer_Skip(rd, offLen);
+
+    IndexSpec_AddTerm(sp, term, tlen);
+    InvertedIndex *invidx =
+        sp->partitionSpan > 0
+            ? Redis_OpenInvertedIndexPart(sctx, term, tlen, 1,
+                                          (uint32_t)(docId / sp->partitionSpan))
+            : Redis_OpenInvertedIndexEx(sctx, term, tlen, 1, NULL);
+    if (!invidx) {
+      continue;
+    }
+    // the offsets arrive as the exact varint image the master's writer built
+    VarintVectorWriter vw = {.buf = {.data = (char *)offsets, .offset = offLen, .cap = offLen},
+                             .nmemb = noff};
+    ForwardIndexEntry ent = {.docId = docId,
+                             .freq = freq,
+                             .fieldMask = fieldMask,
+                             .term = term,
+                             .len = tlen,
+                             .vw = offLen ? &vw : NULL};
+    size_t sz = InvertedIndex_WriteForwardIndexEntry(invidx, encoder, &ent);
+    sp->stats.invertedSize += sz;
+    sp->stats.numRecords++;
+    IndexSpec_BumpTermEpoch(sp);
+  }
+  SearchCtx_Free(sctx);
+  RedisModule_ReplicateVerbatim(ctx);  // chained replicas apply the same delta
+  return RedisModule_ReplyWithSimpleString(ctx, "OK");
+#undef NEED
+}
+
 void AddDocumentCtx_Finish(RSAddDocumentCtx *aCtx) {
+  if (aCtx->deltaLog) {
+    // some failure paths set only the status, not ACTX_F_ERRORED - either one
+    // means the commit did not happen
+    if (!(aCtx->stateFlags & ACTX_F_ERRORED) && !QueryError_HasError(&aCtx->status) &&
+        aCtx->doc.docKey) {
+      size_t n;
+      const char *s = RedisModule_StringPtrLen(aCtx->doc.docKey, &n);
+      DeltaLog_Append(aCtx->deltaLog, s, n);
+    }
+    DeltaLog_Decref(aCtx->deltaLog);
+    aCtx->deltaLog = NULL;
+  }
   if (aCtx->stateFlags & ACTX_F_NOBLOCK) {
     doReplyFinish(aCtx, aCtx->client.sctx->redisCtx);
   } else {
@@ -293,6 +561,10 @@ void AddDocumentCtx_Submit(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx, uint32_
 }
 
 void AddDocumentCtx_Free(RSAddDocumentCtx *aCtx) {
+  if (aCtx->effectsSpecName) {
+    rm_free(aCtx->effectsSpecName);
+    aCtx->effectsSpecName = NULL;
+  }
   // Destroy the common fields:
   Document_FreeDetached(&aCtx->doc, aCtx->indexer->redisCtx);
 
@@ -337,6 +609,30 @@ void AddDocumentCtx_Free(RSAddDocumentCtx *aCtx) {
 
 #define FIELD_PREPROCESSOR FIELD_HANDLER
 
+/* Pick the tokenizer for one text field. Fields whose schema pins a language
+ * bypass the per-document plumbing and take a pre-bound tokenizer from the
+ * pool; everything else uses the context's document-language tokenizer. The
+ * returned tokenizer must be released iff it differs from aCtx->tokenizer */
+static RSTokenizer *fieldTokenizer(RSAddDocumentCtx *aCtx, const FieldSpec *fs) {
+  const char *flang = fs->textOpts.language;
+  if (!flang) {
+    return aCtx->tokenizer;
+  }
+  const char *dlang = aCtx->doc.language ? aCtx->doc.language : DEFAULT_LANGUAGE;
+  if (!strcasecmp(flang, dlang)) {
+    return aCtx->tokenizer;
+  }
+  if (!aCtx->pinnedStemmer || !ResetStemmer(aCtx->pinnedStemmer, SnowballStemmer, flang)) {
+    if (aCtx->pinnedStemmer) {
+      aCtx->pinnedStemmer->Free(aCtx->pinnedStemmer);
+    }
+    // NULL for languages without a snowball stemmer (chinese) - the tokenizer
+    // then simply does not stem
+    aCtx->pinnedStemmer = NewStemmer(SnowballStemmer, flang);
+  }
+  return GetTokenizer(flang, aCtx->pinnedStemmer, aCtx->tokenizer->ctx.stopwords);
+}
+
 FIELD_PREPROCESSOR(fulltextPreprocessor) {
   size_t fl;
   const char *c = RedisModule_StringPtrLen(field->text, &fl);
@@ -348,31 +644,48 @@ FIELD_PREPROCESSOR(fulltextPreprocessor) {
     ForwardIndexTokenizerCtx tokCtx;
     VarintVectorWriter *curOffsetWriter = NULL;
     RSByteOffsetField *curOffsetField = NULL;
-    if (aCtx->byteOffsets) {
+    // Fields which are never highlighted skip byte offsets too
+    if (aCtx->byteOffsets && !FieldSpec_IsNoOffsets(fs)) {
       curOffsetField =
           RSByteOffsets_AddField(aCtx->byteOffsets, fs->textOpts.id, aCtx->totalTokens + 1);
       curOffsetWriter = &aCtx->offsetsWriter;
     }
 
     ForwardIndexTokenizerCtx_Init(&tokCtx, aCtx->fwIdx, c, curOffsetWriter, fs->textOpts.id,
-                                  fs->textOpts.weight);
+                                  fs->textOpts.weight, FieldSpec_IsNoOffsets(fs));
 
     uint32_t options = TOKENIZE_DEFAULT_OPTIONS;
+    if (aCtx->doc.borrowedFields) {
+      // the text belongs to the caller's argv - normalize into a scratch
+      // buffer and have the forward index copy the tokens it keeps
+      options |= TOKENIZE_NOMODIFY;
+    }
     if (FieldSpec_IsNoStem(fs)) {
       options |= TOKENIZE_NOSTEM;
     }
     if (FieldSpec_IsPhonetics(fs)) {
       options |= TOKENIZE_PHONETICS;
     }
-    aCtx->tokenizer->Start(aCtx->tokenizer, (char *)c, fl, options);
+    RSTokenizer *tokenizer = fieldTokenizer(aCtx, fs);
+    if (tokenizer != aCtx->tokenizer) {
+      // token positions are document-global: continue from wherever the
+      // document tokenizer stands
+      tokenizer->ctx.lastOffset = aCtx->tokenizer->ctx.lastOffset;
+    }
+    tokenizer->Start(tokenizer, (char *)c, fl, options);
 
     Token tok;
     uint32_t lastTokPos = 0;
     uint32_t newTokPos;
-    while (0 != (newTokPos = aCtx->tokenizer->Next(aCtx->tokenizer, &tok))) {
+    while (0 != (newTokPos = tokenizer->Next(tokenizer, &tok))) {
       forwardIndexTokenFunc(&tokCtx, &tok);
       lastTokPos = newTokPos;
     }
+    if (tokenizer != aCtx->tokenizer) {
+      // hand the advanced position back before returning the tokenizer
+      aCtx->tokenizer->ctx.lastOffset = tokenizer->ctx.lastOffset;
+      Tokenizer_Release(tokenizer);
+    }
 
     if (curOffsetField) {
       curOffsetField->lastTokPos = lastTokPos;
@@ -388,6 +701,11 @@ FIELD_PREPROCESSOR(numericPreprocessor) {
     return -1;
   }
 
+  // Float32 fields round at ingestion, so the index and the sort vector agree on the value
+  if (FieldSpec_IsFloat32(fs)) {
+    fdata->numeric = (float)fdata->numeric;
+  }
+
   // If this is a sortable numeric value - copy the value to the sorting vector
   if (FieldSpec_IsSortable(fs)) {
     RSSortingVector_Put(aCtx->sv, fs->sortIdx, &fdata->numeric, RS_SORTABLE_NUM);
@@ -409,22 +727,25 @@ FIELD_BULK_CTOR(numericCtor) {
 }
 
 FIELD_PREPROCESSOR(geoPreprocessor) {
-  const char *c = RedisModule_StringPtrLen(field->text, NULL);
-  char *pos = strpbrk(c, " ,");
+  size_t len;
+  const char *c = RedisModule_StringPtrLen(field->text, &len);
+  const char *pos = strpbrk(c, " ,");
   if (!pos) {
     QueryError_SetCode(status, QUERY_EGEOFORMAT);
     return -1;
   }
-  *pos = '\0';
-  pos++;
-  fdata->geo.slon = (char *)c;
-  fdata->geo.slat = (char *)pos;
+  // the field text may be borrowed from the caller's argv and must not be
+  // split in place - keep private copies until the bulk indexer consumes them
+  fdata->geo.slon = strndup(c, pos - c);
+  fdata->geo.slat = strndup(pos + 1, len - (pos + 1 - c));
   return 0;
 }
 
 FIELD_BULK_INDEXER(geoIndexer) {
   GeoIndex gi = {.ctx = ctx, .sp = fs};
   int rv = GeoIndex_AddStrings(&gi, aCtx->doc.docId, fdata->geo.slon, fdata->geo.slat);
+  free(fdata->geo.slon);
+  free(fdata->geo.slat);
 
   if (rv == REDISMODULE_ERR) {
     QueryError_SetError(status, QUERY_EGENERIC, "Could not index geo value");
@@ -435,7 +756,7 @@ FIELD_BULK_INDEXER(geoIndexer) {
 
 FIELD_PREPROCESSOR(tagPreprocessor) {
 
-  fdata->tags = TagIndex_Preprocess(&fs->tagOpts, field);
+  fdata->tags = TagIndex_Preprocess(&fs->tagOpts, field, &fdata->tagsBuf);
 
   if (fdata->tags == NULL) {
     return 0;
@@ -464,7 +785,7 @@ FIELD_BULK_INDEXER(tagIndexer) {
     ctx->spec->stats.numRecords++;
   }
   if (fdata->tags) {
-    TagIndex_FreePreprocessedData(fdata->tags);
+    TagIndex_FreePreprocessedData(fdata->tags, fdata->tagsBuf);
   }
   return rc;
 }
@@ -502,28 +823,151 @@ const BulkIndexer *GetBulkIndexer(const FieldType ft) {
   }
 }
 
+/* Non-text preprocessors (numeric parsing, tag splitting, geo conversion)
+ * touch only their own fdata slot and their own sortable index entry, so for
+ * wide documents they can run as subtasks on CONCURRENT_POOL_PREPROCESS while
+ * this thread tokenizes the text fields. Below this many eligible fields the
+ * dispatch overhead outweighs the overlap */
+#define PREPROC_PARALLEL_MIN_FIELDS 8
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  size_t pending;
+} PreprocJoin;
+
+typedef struct {
+  RSAddDocumentCtx *aCtx;
+  int fieldIdx;
+  PreprocessorFunc pp;
+  QueryError status;  // private to the subtask; first error moves to the aCtx
+  int rc;
+  PreprocJoin *join;
+} PreprocSubtask;
+
+static void preprocSubtask(void *p) {
+  PreprocSubtask *t = p;
+  RSAddDocumentCtx *aCtx = t->aCtx;
+  t->rc = t->pp(aCtx, &aCtx->doc.fields[t->fieldIdx], aCtx->fspecs + t->fieldIdx,
+                aCtx->fdatas + t->fieldIdx, &t->status);
+  PreprocJoin *j = t->join;
+  pthread_mutex_lock(&j->lock);
+  if (--j->pending == 0) {
+    pthread_cond_signal(&j->cond);
+  }
+  pthread_mutex_unlock(&j->lock);
+}
+
 int Document_AddToIndexes(RSAddDocumentCtx *aCtx) {
   Document *doc = &aCtx->doc;
   int ourRv = REDISMODULE_OK;
+  PreprocSubtask *subtasks = NULL;
+  size_t numSubtasks = 0;
 
+  // count the fields eligible for subtask dispatch
+  size_t parallelizable = 0;
   for (int i = 0; i < doc->numFields; i++) {
     const FieldSpec *fs = aCtx->fspecs + i;
-    fieldData *fdata = aCtx->fdatas + i;
-    if (fs->name == NULL) {
-      LG_DEBUG("Skipping field %s not in index!", doc->fields[i].name);
-      continue;
+    if (fs->name && fs->type != FIELD_FULLTEXT && GetIndexPreprocessor(fs->type)) {
+      parallelizable++;
     }
+  }
 
-    // Get handler
-    PreprocessorFunc pp = GetIndexPreprocessor(fs->type);
-    if (pp == NULL) {
-      continue;
+  if (parallelizable >= PREPROC_PARALLEL_MIN_FIELDS && CONCURRENT_POOL_PREPROCESS != -1) {
+    PreprocJoin join;
+    pthread_mutex_init(&join.lock, NULL);
+    pthread_cond_init(&join.cond, NULL);
+    join.pending = parallelizable;
+    subtasks = calloc(parallelizable, sizeof(*subtasks));
+
+    for (int i = 0; i < doc->numFields; i++) {
+      const FieldSpec *fs = aCtx->fspecs + i;
+      if (!fs->name || fs->type == FIELD_FULLTEXT) {
+        continue;
+      }
+      PreprocessorFunc pp = GetIndexPreprocessor(fs->type);
+      if (!pp) {
+        continue;
+      }
+      PreprocSubtask *t = &subtasks[numSubtasks++];
+      t->aCtx = aCtx;
+      t->fieldIdx = i;
+      t->pp = pp;
+      t->join = &join;
+      ConcurrentSearch_ThreadPoolRun(preprocSubtask, t, CONCURRENT_POOL_PREPROCESS);
+    }
+
+    // text fields run here, overlapping with the subtasks
+    for (int i = 0; i < doc->numFields; i++) {
+      const FieldSpec *fs = aCtx->fspecs + i;
+      if (!fs->name || fs->type != FIELD_FULLTEXT) {
+        continue;
+      }
+      if (fulltextPreprocessor(aCtx, &doc->fields[i], fs, aCtx->fdatas + i, &aCtx->status) != 0) {
+        ourRv = REDISMODULE_ERR;
+        // subtasks still hold references into the context - join before bailing
+        break;
+      }
     }
 
-    if (pp(aCtx, &doc->fields[i], fs, fdata, &aCtx->status) != 0) {
-      ourRv = REDISMODULE_ERR;
+    pthread_mutex_lock(&join.lock);
+    while (join.pending) {
+      pthread_mutex_unlock(&join.lock);
+      // Lend this thread to the scheduler instead of parking: our subtasks
+      // (or other joiners' subtasks ahead of them) may be waiting for a worker
+      if (ConcurrentSearch_StealOne()) {
+        pthread_mutex_lock(&join.lock);
+        continue;
+      }
+      struct timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      ts.tv_nsec += 1000000;  // 1ms backstop against wakeup races
+      if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+      }
+      pthread_mutex_lock(&join.lock);
+      if (join.pending) {
+        pthread_cond_timedwait(&join.cond, &join.lock, &ts);
+      }
+    }
+    pthread_mutex_unlock(&join.lock);
+    pthread_mutex_destroy(&join.lock);
+    pthread_cond_destroy(&join.cond);
+
+    for (size_t t = 0; t < numSubtasks; t++) {
+      if (subtasks[t].rc != 0) {
+        ourRv = REDISMODULE_ERR;
+        if (!QueryError_HasError(&aCtx->status)) {
+          aCtx->status = subtasks[t].status;  // move ownership of the error
+          memset(&subtasks[t].status, 0, sizeof(subtasks[t].status));
+        }
+      }
+      QueryError_ClearError(&subtasks[t].status);
+    }
+    if (ourRv != REDISMODULE_OK) {
       goto cleanup;
     }
+  } else {
+    for (int i = 0; i < doc->numFields; i++) {
+      const FieldSpec *fs = aCtx->fspecs + i;
+      fieldData *fdata = aCtx->fdatas + i;
+      if (fs->name == NULL) {
+        LG_DEBUG("Skipping field %s not in index!", doc->fields[i].name);
+        continue;
+      }
+
+      // Get handler
+      PreprocessorFunc pp = GetIndexPreprocessor(fs->type);
+      if (pp == NULL) {
+        continue;
+      }
+
+      if (pp(aCtx, &doc->fields[i], fs, fdata, &aCtx->status) != 0) {
+        ourRv = REDISMODULE_ERR;
+        goto cleanup;
+      }
+    }
   }
 
   if (Indexer_Add(aCtx->indexer, aCtx) != 0) {
@@ -532,6 +976,7 @@ int Document_AddToIndexes(RSAddDocumentCtx *aCtx) {
   }
 
 cleanup:
+  free(subtasks);
   if (ourRv != REDISMODULE_OK) {
     QueryError_SetCode(&aCtx->status, QUERY_EGENERIC);
     AddDocumentCtx_Finish(aCtx);
@@ -617,6 +1062,11 @@ static void AddDocumentCtx_UpdateNoIndex(RSAddDocumentCtx *aCtx, RedisSearchCtx
 
   // Update the score
   md->score = doc->score;
+  // Score/payload/sortable updates can reorder cached results, and per-term
+  // epochs cannot attribute them - invalidate term entries too
+  if (sctx->spec->resultCache) {
+    ResultCache_OnUnattributedChange(sctx->spec->resultCache);
+  }
   // Set the payload if needed
   if (doc->payload) {
     DocTable_SetPayload(&sctx->spec->docs, docId, doc->payload, doc->payloadSize);
@@ -646,16 +1096,23 @@ static void AddDocumentCtx_UpdateNoIndex(RSAddDocumentCtx *aCtx, RedisSearchCtx
       }
 
       switch (fs->type) {
-        case FIELD_FULLTEXT:
+        case FIELD_FULLTEXT: {
           RSSortingVector_Put(md->sortVector, idx, (void *)RedisModule_StringPtrLen(f->text, NULL),
                               RS_SORTABLE_STR);
+          const RSValue *sval = md->sortVector->values[idx];
+          if (sval && sval->t == RSValue_String) {
+            SortingTable_ColumnPutStrKey(sctx->spec->sortables, idx, md->id,
+                                         SortingTable_StrKey(sval->strval.str, sval->strval.len));
+          }
           break;
+        }
         case FIELD_NUMERIC: {
           double numval;
           if (RedisModule_StringToDouble(f->text, &numval) == REDISMODULE_ERR) {
             BAIL("Could not parse numeric index value");
           }
           RSSortingVector_Put(md->sortVector, idx, &numval, RS_SORTABLE_NUM);
+          SortingTable_ColumnPut(sctx->spec->sortables, idx, md->id, numval);
           break;
         }
         default:
@@ -4,6 +4,7 @@
 #include "redismodule.h"
 #include "search_ctx.h"
 #include "redisearch.h"
+#include "rmutil/sds.h"
 #include "tokenize.h"
 #include "concurrent_ctx.h"
 #include "byte_offsets.h"
@@ -51,6 +52,9 @@ typedef struct Document {
   const char *payload;
   size_t payloadSize;
   int stringOwner;
+  // Field texts are the caller's argv strings, retained but not copied; they
+  // must not be modified in place (see Document_PrepareForAdd)
+  int borrowedFields;
 } Document;
 
 struct RSAddDocumentCtx;
@@ -145,6 +149,8 @@ void Document_Free(Document *doc);
 #define DOCUMENT_ADD_PARTIAL 0x02
 #define DOCUMENT_ADD_NOSAVE 0x04
 #define DOCUMENT_ADD_CURTHREAD 0x08  // Perform operation in main thread
+// Replicate the computed indexing effects instead of the verbatim command
+#define DOCUMENT_ADD_REPLICATE_EFFECTS 0x10
 
 struct ForwardIndex;
 union FieldData;
@@ -177,6 +183,8 @@ struct DocumentIndexer;
 /** Context used when indexing documents */
 typedef struct RSAddDocumentCtx {
   struct RSAddDocumentCtx *next;  // Next context in the queue
+  struct DeltaLog *deltaLog;      // Commit log reference held for the document's lifetime
+  char *effectsSpecName;          // Set when indexing effects replicate instead of the command
   Document doc;                   // Document which is being indexed
   union {
     RedisModuleBlockedClient *bc;  // Client
@@ -202,6 +210,10 @@ typedef struct RSAddDocumentCtx {
   FieldSpec *fspecs;
   RSTokenizer *tokenizer;
 
+  // Stemmer for fields whose schema pins a language other than the
+  // document's; survives context recycling like the forward index stemmer
+  Stemmer *pinnedStemmer;
+
   // Old document data. Contains sortables
   RSDocumentMetadata *oldMd;
 
@@ -257,6 +269,19 @@ void AddDocumentCtx_Finish(RSAddDocumentCtx *aCtx);
  */
 int Document_AddToIndexes(RSAddDocumentCtx *ctx);
 
+/* Effect replication: serialize the computed forward-index entries and
+ * document metadata of a finished add into a compact blob (see
+ * ApplyDeltaCommand), so replicas apply postings directly instead of
+ * re-tokenizing. Returns an sds the caller owns */
+sds Document_SerializeEffects(RSAddDocumentCtx *aCtx, sds s);
+
+/* Replica side: _FT.APPLYDELTA {index} {key} {blob} */
+int ApplyDeltaCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+
+/* Can this spec's mutations be effect-replicated? (every field a plain
+ * non-sortable TEXT field, so the blob captures the whole indexing effect) */
+int SpecSupportsEffectReplication(const IndexSpec *sp);
+
 /**
  * Free the AddDocumentCtx. Should be done once AddToIndexes() completes; or
  * when the client is unblocked.
@@ -298,6 +323,7 @@ DocumentField *Document_GetField(Document *d, const char *fieldName);
 
 // Document add functions:
 int RSAddDocumentCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int RSAddDocumentBatchCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int RSSafeAddDocumentCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int RSAddHashCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int RSSafeAddHashCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
@@ -182,6 +182,9 @@ int RS_AddDocument(RedisSearchCtx *sctx, RedisModuleString *name, const AddDocum
   if (addOptions & DOCUMENT_ADD_CURTHREAD) {
     aCtx->stateFlags |= ACTX_F_NOBLOCK;
   }
+  if (addOptions & DOCUMENT_ADD_REPLICATE_EFFECTS) {
+    aCtx->effectsSpecName = rm_strdup(sp->name);
+  }
 
   aCtx->donecb = opts->donecb;
   AddDocumentCtx_Submit(aCtx, sctx, addOptions);
@@ -250,6 +253,12 @@ static int doAddDocument(RedisModuleCtx *ctx, RedisModuleString **argv, int argc
   if (!canBlock) {
     opts.options |= DOCUMENT_ADD_CURTHREAD;
   }
+  // Effect replication: when the spec qualifies, the finished add ships its
+  // computed postings instead of this command replaying downstream
+  int effects = RSGlobalConfig.replicateEffects && SpecSupportsEffectReplication(sp);
+  if (effects) {
+    opts.options |= DOCUMENT_ADD_REPLICATE_EFFECTS;
+  }
   RedisSearchCtx sctx = {.redisCtx = ctx, .spec = sp};
   rv = RS_AddDocument(&sctx, argv[2], &opts, &status);
   if (rv != REDISMODULE_OK) {
@@ -258,7 +267,7 @@ static int doAddDocument(RedisModuleCtx *ctx, RedisModuleString **argv, int argc
     } else {
       RedisModule_ReplyWithError(ctx, QueryError_GetError(&status));
     }
-  } else {
+  } else if (!effects) {
     // Replicate *here*
     RedisModule_Replicate(ctx, RS_SAFEADD_CMD, "v", argv + 1, argc - 1);
   }
@@ -401,6 +410,78 @@ cleanup:
 int RSAddDocumentCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
   return doAddDocument(ctx, argv, argc, 1);
 }
+
+/* FT.ADDBATCH {index} {count} ({doc} {score} {nfields} {field value ...}) * count
+ *
+ * Index a batch of documents in one command invocation: the index spec is resolved once and
+ * every document runs on the calling thread, amortizing command dispatch and the per-document
+ * blocked-client machinery of FT.ADD. The reply is an array with one OK / error per document;
+ * a malformed document fails alone without aborting the rest of the batch */
+int RSAddDocumentBatchCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+  if (argc < 3) {
+    return RedisModule_WrongArity(ctx);
+  }
+  long long count;
+  if (RedisModule_StringToLongLong(argv[2], &count) != REDISMODULE_OK || count < 1) {
+    return RedisModule_ReplyWithError(ctx, "Invalid document count");
+  }
+
+  RedisModule_AutoMemory(ctx);
+  IndexSpec *sp = IndexSpec_Load(ctx, RedisModule_StringPtrLen(argv[1], NULL), 0);
+  if (!sp) {
+    return RedisModule_ReplyWithError(ctx, "Unknown index name");
+  }
+
+  RedisModule_ReplyWithArray(ctx, count);
+  int pos = 3;
+  for (long long i = 0; i < count; i++) {
+    // need at least: name, score, nfields
+    if (pos + 3 > argc) {
+      RedisModule_ReplyWithError(ctx, "Missing document arguments");
+      for (long long j = i + 1; j < count; j++) {
+        RedisModule_ReplyWithError(ctx, "Missing document arguments");
+      }
+      break;
+    }
+    RedisModuleString *name = argv[pos++];
+    double score;
+    long long nfields;
+    if (RedisModule_StringToDouble(argv[pos++], &score) != REDISMODULE_OK || score < 0 ||
+        score > 1.0) {
+      RedisModule_ReplyWithError(ctx, "Score must be between 0 and 1");
+      // cannot resync the cursor without nfields; abort the remainder
+      for (long long j = i + 1; j < count; j++) {
+        RedisModule_ReplyWithError(ctx, "Skipped after malformed document");
+      }
+      break;
+    }
+    if (RedisModule_StringToLongLong(argv[pos++], &nfields) != REDISMODULE_OK || nfields < 1 ||
+        pos + nfields * 2 > argc) {
+      RedisModule_ReplyWithError(ctx, "Invalid field count");
+      for (long long j = i + 1; j < count; j++) {
+        RedisModule_ReplyWithError(ctx, "Skipped after malformed document");
+      }
+      break;
+    }
+
+    AddDocumentOptions opts = {.donecb = replyCallback,
+                               .score = score,
+                               .numFieldElems = nfields * 2,
+                               .fieldsArray = &argv[pos],
+                               .options = DOCUMENT_ADD_CURTHREAD | DOCUMENT_ADD_REPLACE};
+    pos += nfields * 2;
+
+    QueryError status = {0};
+    RedisSearchCtx sctx = {.redisCtx = ctx, .spec = sp};
+    if (RS_AddDocument(&sctx, name, &opts, &status) != REDISMODULE_OK) {
+      RedisModule_ReplyWithError(
+          ctx, QueryError_HasError(&status) ? QueryError_GetError(&status) : "Could not add");
+      QueryError_ClearError(&status);
+    }
+    // on success the synchronous done callback has already written this document's reply
+  }
+  return REDISMODULE_OK;
+}
 int RSSafeAddDocumentCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
   return doAddDocument(ctx, argv, argc, 0);
 }
@@ -11,6 +11,7 @@ void Document_Init(Document *doc, RedisModuleString *docKey, double score, int n
   doc->language = lang;
   doc->payload = payload;
   doc->payloadSize = payloadSize;
+  doc->borrowedFields = 0;
 }
 
 Document *Document_Create(const char *docKey, size_t len, double score, const char *lang) {
@@ -51,8 +52,13 @@ void Document_PrepareForAdd(Document *doc, RedisModuleString *docKey, double sco
     // printf("indexing '%s' => '%s'\n", RedisModule_StringPtrLen(opts->fieldsArray[ii], NULL),
     //        RedisModule_StringPtrLen(opts->fieldsArray[ii + 1], NULL));
     doc->fields[n].name = RedisModule_StringPtrLen(opts->fieldsArray[ii], NULL);
-    doc->fields[n].text = RedisModule_CreateStringFromString(ctx, opts->fieldsArray[ii + 1]);
+    // Borrow the argv string instead of copying it - Document_Detach below
+    // retains it, which pins its lifetime to the indexing task. The only
+    // consumer that relied on owning the bytes is the tokenizer's in-place
+    // normalization, which borrowedFields switches to TOKENIZE_NOMODIFY
+    doc->fields[n].text = opts->fieldsArray[ii + 1];
   }
+  doc->borrowedFields = 1;
 
   Document_Detach(doc, ctx);
 }
@@ -4,13 +4,16 @@
 #include "../redisearch.h"
 #include "../spec.h"
 #include "../query.h"
+#include "../result_processor.h"
 #include "../synonym_map.h"
 #include "../dep/snowball/include/libstemmer.h"
 #include "default.h"
 #include "../tokenize.h"
 #include "../rmutil/vector.h"
 #include "../stemmer.h"
+#include "../cpu_dispatch.h"
 #include "../phonetic_manager.h"
+#include <immintrin.h>
 
 /******************************************************************************************
  *
@@ -28,10 +31,6 @@
 
 // recursively calculate tf-idf
 double tfidfRecursive(RSIndexResult *r, RSDocumentMetadata *dmd) {
-
-  if (r->type == RSResultType_Term) {
-    return r->weight * ((double)r->freq) * (r->term.term ? r->term.term->idf : 0);
-  }
   if (r->type & (RSResultType_Intersection | RSResultType_Union)) {
     double ret = 0;
     for (int i = 0; i < r->agg.numChildren; i++) {
@@ -39,7 +38,9 @@ double tfidfRecursive(RSIndexResult *r, RSDocumentMetadata *dmd) {
     }
     return r->weight * ret;
   }
-  return r->weight * (double)r->freq;
+  // term and virtual records alike: the record's static factor (weight, with
+  // idf folded in for terms at query-open time) times the frequency
+  return r->scoreCoeff * (double)r->freq;
 }
 
 /* internal common tf-idf function, where just the normalization method changes */
@@ -81,17 +82,35 @@ double TFIDFNormDocLenScorer(ScoringFunctionArgs *ctx, RSIndexResult *h, RSDocum
  *
  ******************************************************************************************/
 
+/* Fill the per-query constants on the first scored record: everything in the
+ * BM25 denominator except the frequency is fixed for the whole query */
+static inline void bm25EnsureScoreCtx(ScoringFunctionArgs *ctx) {
+  if (!ctx->scoreCtx.initialized) {
+    static const float b = 0.5;
+    static const float k1 = 1.2;
+    ctx->scoreCtx.bm25K = k1 * (1.0f - b + b * ctx->indexStats.avgDocLen);
+    for (uint32_t f = 0; f < RS_BM25_NORM_TABLE_SIZE; ++f) {
+      ctx->scoreCtx.bm25FreqNorm[f] = (double)f / ((double)f + ctx->scoreCtx.bm25K);
+    }
+    ctx->scoreCtx.initialized = 1;
+  }
+}
+
+/* The frequency-dependent factor f / (f + K): a table load for the common
+ * small frequencies, a divide for the rare large ones */
+static inline double bm25Norm(const RSQueryScoreCtx *sc, uint32_t freq) {
+  if (freq < RS_BM25_NORM_TABLE_SIZE) {
+    return sc->bm25FreqNorm[freq];
+  }
+  double f = (double)freq;
+  return f / (f + sc->bm25K);
+}
+
 /* recursively calculate score for each token, summing up sub tokens */
 static double bm25Recursive(ScoringFunctionArgs *ctx, RSIndexResult *r, RSDocumentMetadata *dmd) {
-  static const float b = 0.5;
-  static const float k1 = 1.2;
-  double f = (double)r->freq;
-
   if (r->type == RSResultType_Term) {
     double idf = (r->term.term ? r->term.term->idf : 0);
-
-    double ret = idf * f / (f + k1 * (1.0f - b + b * ctx->indexStats.avgDocLen));
-    return ret;
+    return idf * bm25Norm(&ctx->scoreCtx, r->freq);
   }
 
   if (r->type & (RSResultType_Intersection | RSResultType_Union)) {
@@ -101,13 +120,15 @@ static double bm25Recursive(ScoringFunctionArgs *ctx, RSIndexResult *r, RSDocume
     }
     return r->weight * ret;
   }
-  // default for virtual type -just disregard the idf
-  return r->weight * (r->freq ? f / (f + k1 * (1.0f - b + b * ctx->indexStats.avgDocLen)) : 0);
+  // default for virtual type - just disregard the idf (the table's zero entry
+  // keeps zero-frequency records at 0)
+  return r->weight * bm25Norm(&ctx->scoreCtx, r->freq);
 }
 
 /* BM25 scoring function */
 double BM25Scorer(ScoringFunctionArgs *ctx, RSIndexResult *r, RSDocumentMetadata *dmd,
                   double minScore) {
+  bm25EnsureScoreCtx(ctx);
   double score = dmd->score * bm25Recursive(ctx, r, dmd);
 
   // no need to factor the distance if tfidf is already below minimal score
@@ -119,6 +140,157 @@ double BM25Scorer(ScoringFunctionArgs *ctx, RSIndexResult *r, RSDocumentMetadata
   return score;
 }
 
+/******************************************************************************************
+ *
+ * Batch scoring entry points
+ *
+ * The chunked pipeline hands whole result chunks to these instead of making
+ * one indirect call per row. Flat term rows - every row of a broad
+ * single-term query - are gathered into parallel arrays and scored through a
+ * vectorized kernel, 8 documents per iteration; aggregate and virtual rows
+ * take the same recursive path the scalar call would. Flat rows also skip
+ * the GetSlop() indirection, since the slop of a non-aggregate result is
+ * always 1.
+ *
+ ******************************************************************************************/
+
+static int scorerCanUseAVX = 0;
+
+static void scorerInitDispatch(void) {
+  scorerCanUseAVX = RSCpu_Level() >= RS_CPU_AVX;
+}
+
+__attribute__((constructor)) static void scorerRegisterDispatch(void) {
+  RSCpu_RegisterDispatch(scorerInitDispatch);
+}
+
+/* out[i] = a[i] * b[i]: BM25's per-row work once the frequency factor comes
+ * from the per-query table */
+__attribute__((target("avx"))) static void scoreFlatMulKernelAVX(const double *a, const double *b,
+                                                                 double *out, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {  // 8 docs per iteration, two 4-wide lanes
+    _mm256_storeu_pd(out + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    _mm256_storeu_pd(out + i + 4,
+                     _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+  }
+  for (; i < n; ++i) {
+    out[i] = a[i] * b[i];
+  }
+}
+
+static void scoreFlatMulKernel(const double *a, const double *b, double *out, size_t n) {
+  if (scorerCanUseAVX) {
+    scoreFlatMulKernelAVX(a, b, out, n);
+    return;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = a[i] * b[i];
+  }
+}
+
+/* out[i] = as[i] / divs[i], for formulas whose document score is already
+ * folded into the numerator (TF-IDF associates as (dscore * tfidf) / norm) */
+__attribute__((target("avx"))) static void scoreFlatDivKernelAVX(const double *as,
+                                                                 const double *divs, double *out,
+                                                                 size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {  // 8 docs per iteration, two 4-wide lanes
+    _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_loadu_pd(as + i), _mm256_loadu_pd(divs + i)));
+    _mm256_storeu_pd(out + i + 4,
+                     _mm256_div_pd(_mm256_loadu_pd(as + i + 4), _mm256_loadu_pd(divs + i + 4)));
+  }
+  for (; i < n; ++i) {
+    out[i] = as[i] / divs[i];
+  }
+}
+
+static void scoreFlatDivKernel(const double *as, const double *divs, double *out, size_t n) {
+  if (scorerCanUseAVX) {
+    scoreFlatDivKernelAVX(as, divs, out, n);
+    return;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = as[i] / divs[i];
+  }
+}
+
+/* A row the kernels can take: a plain term hit with no offset aggregation */
+#define SCORER_ROW_IS_FLAT(r) ((r)->type == RSResultType_Term)
+
+static void tfidfBatchInternal(ScoringFunctionArgs *ctx, RSIndexResult **results,
+                               const RSDocumentMetadata **dmds, double *scores, size_t n,
+                               double minScore, int normMode) {
+  // fixed chunk-sized arrays, zero-filled: n is at most RESULT_CHUNK_LEN
+  // (the batch comes from one pipeline chunk); the kernels read only the
+  // nflat prefix, the initializer just keeps the compiler able to prove it
+  double as[RESULT_CHUNK_LEN] = {0}, divs[RESULT_CHUNK_LEN] = {0};
+  size_t flat[RESULT_CHUNK_LEN], nflat = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    RSIndexResult *r = results[i];
+    const RSDocumentMetadata *dmd = dmds[i];
+    if (!SCORER_ROW_IS_FLAT(r)) {
+      scores[i] = tfIdfInternal(ctx, r, (RSDocumentMetadata *)dmd, minScore, normMode);
+      continue;
+    }
+    if (dmd->score == 0) {  // the scalar path's early-out, kept off the kernel
+      scores[i] = 0;
+      continue;
+    }
+    // Mirrors tfidfRecursive's term case with the document score folded in
+    // and the maxfreq/doclen normalizer as the divisor
+    as[nflat] = dmd->score * (r->scoreCoeff * (double)r->freq);
+    divs[nflat] = normMode == NORM_MAXFREQ ? (double)dmd->maxFreq : dmd->len;
+    flat[nflat++] = i;
+  }
+
+  scoreFlatDivKernel(as, divs, as, nflat);
+  for (size_t j = 0; j < nflat; ++j) {
+    // dscore == 0 and the minScore cut both land on 0, like the scalar path;
+    // the slop divisor of a flat row is 1
+    scores[flat[j]] = as[j] < minScore ? 0 : as[j];
+  }
+}
+
+static void TFIDFBatchScorer(ScoringFunctionArgs *ctx, RSIndexResult **results,
+                             const RSDocumentMetadata **dmds, double *scores, size_t n,
+                             double minScore) {
+  tfidfBatchInternal(ctx, results, dmds, scores, n, minScore, NORM_MAXFREQ);
+}
+
+static void TFIDFNormDocLenBatchScorer(ScoringFunctionArgs *ctx, RSIndexResult **results,
+                                       const RSDocumentMetadata **dmds, double *scores, size_t n,
+                                       double minScore) {
+  tfidfBatchInternal(ctx, results, dmds, scores, n, minScore, NORM_DOCLEN);
+}
+
+static void BM25BatchScorer(ScoringFunctionArgs *ctx, RSIndexResult **results,
+                            const RSDocumentMetadata **dmds, double *scores, size_t n,
+                            double minScore) {
+  bm25EnsureScoreCtx(ctx);
+
+  double as[RESULT_CHUNK_LEN] = {0}, dscores[RESULT_CHUNK_LEN] = {0};
+  size_t flat[RESULT_CHUNK_LEN], nflat = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    RSIndexResult *r = results[i];
+    if (!SCORER_ROW_IS_FLAT(r)) {
+      scores[i] = BM25Scorer(ctx, r, (RSDocumentMetadata *)dmds[i], minScore);
+      continue;
+    }
+    // Mirrors bm25Recursive's term case: idf * (f / (f + K)) via the table
+    as[nflat] = (r->term.term ? r->term.term->idf : 0) * bm25Norm(&ctx->scoreCtx, r->freq);
+    dscores[nflat] = dmds[i]->score;
+    flat[nflat++] = i;
+  }
+
+  scoreFlatMulKernel(dscores, as, as, nflat);
+  for (size_t j = 0; j < nflat; ++j) {
+    scores[flat[j]] = as[j] < minScore ? 0 : as[j];
+  }
+}
+
 /******************************************************************************************
  *
  * Raw document-score scorer. Just returns the document score
@@ -199,6 +371,9 @@ double HammingDistanceScorer(ScoringFunctionArgs *ctx, RSIndexResult *h, RSDocum
 
 typedef struct {
   int isCn;
+  // set when the query language has no snowball stemmer, so the lookup is not
+  // retried for every term of the query
+  int stemmerUnavailable;
   union {
     struct {
       RSTokenizer *tokenizer;
@@ -255,11 +430,27 @@ static void expandCn(RSQueryExpanderCtx *ctx, RSToken *token) {
  * Stemmer based query expander
  *
  ******************************************************************************************/
+/* One memoized stemmer per worker thread, shared by every expansion running
+ * on it. Common query terms hit the stemmer's token cache across queries
+ * instead of re-running snowball; the stemmer is only replaced when a query
+ * switches language */
+static __thread Stemmer *queryStemmer_g;
+
+static Stemmer *getQueryStemmer(const char *language) {
+  if (queryStemmer_g) {
+    if (ResetStemmer(queryStemmer_g, SnowballStemmer, language)) {
+      return queryStemmer_g;
+    }
+    queryStemmer_g->Free(queryStemmer_g);
+  }
+  queryStemmer_g = NewStemmer(SnowballStemmer, language);
+  return queryStemmer_g;
+}
+
 int StemmerExpander(RSQueryExpanderCtx *ctx, RSToken *token) {
 
-  // we store the stemmer as private data on the first call to expand
+  // privdata only records whether this is the chinese tokenizing expander
   defaultExpanderCtx *dd = ctx->privdata;
-  struct sb_stemmer *sb;
 
   if (!ctx->privdata) {
     if (!strcasecmp(ctx->language, "chinese")) {
@@ -268,7 +459,6 @@ int StemmerExpander(RSQueryExpanderCtx *ctx, RSToken *token) {
     } else {
       dd = ctx->privdata = calloc(1, sizeof(*dd));
       dd->isCn = 0;
-      sb = dd->data.latin = sb_stemmer_new(ctx->language, NULL);
     }
   }
 
@@ -277,28 +467,36 @@ int StemmerExpander(RSQueryExpanderCtx *ctx, RSToken *token) {
     return REDISMODULE_OK;
   }
 
-  sb = dd->data.latin;
+  if (dd->stemmerUnavailable) {
+    return REDISMODULE_OK;
+  }
+
+  Stemmer *st = getQueryStemmer(ctx->language);
 
   // No stemmer available for this language - just return the node so we won't
   // be called again
-  if (!sb) {
+  if (!st) {
+    dd->stemmerUnavailable = 1;
     return REDISMODULE_OK;
   }
 
-  const sb_symbol *b = (const sb_symbol *)token->str;
-  const sb_symbol *stemmed = sb_stemmer_stem(sb, b, token->len);
-
-  if (stemmed) {
-    int sl = sb_stemmer_length(sb);
-
-    // Make a copy of the stemmed buffer with the + prefix given to stems
-    char *dup = malloc(sl + 2);
+  // One cached lookup yields the prefixed form, from which both expansions
+  // are derived
+  size_t sl;
+  const char *stem = st->Stem(st->ctx, token->str, token->len, &sl);
+  if (stem) {
+    // "+stem" plus the bare stem, which differs from the original token
+    // whenever the cache yields a non-identity result
+    ctx->ExpandToken(ctx, strndup(stem, sl), sl, 0x0);  // TODO: Set proper flags here
+    ctx->ExpandToken(ctx, strndup(stem + 1, sl - 1), sl - 1, 0x0);
+  } else {
+    // Identity stem: documents holding inflections of this token index them
+    // under "+token", so the prefixed form is still expanded
+    char *dup = malloc(token->len + 2);
     dup[0] = STEM_PREFIX;
-    memcpy(dup + 1, stemmed, sl + 1);
-    ctx->ExpandToken(ctx, dup, sl + 1, 0x0);  // TODO: Set proper flags here
-    if (sl != token->len || strncmp((const char *)stemmed, token->str, token->len)) {
-      ctx->ExpandToken(ctx, strndup((const char *)stemmed, sl), sl, 0x0);
-    }
+    memcpy(dup + 1, token->str, token->len);
+    dup[token->len + 1] = '\0';
+    ctx->ExpandToken(ctx, dup, token->len + 1, 0x0);
   }
   return REDISMODULE_OK;
 }
@@ -345,12 +543,24 @@ int SynonymExpand(RSQueryExpanderCtx *ctx, RSToken *token) {
     return REDISMODULE_OK;
   }
 
-  TermData *t_data = SynonymMap_GetIdsBySynonym(spec->smap, token->str, token->len);
+  // Expand from the shared read only copy: its term data carries the group
+  // ids pre-formatted as query tokens, and no per-query reference is taken -
+  // the borrow is only valid within this GIL slice, which expansion is
+  SynonymMap *smap = SynonymMap_GetReadOnly(spec->smap);
+  TermData *t_data = SynonymMap_GetIdsBySynonym(smap, token->str, token->len);
 
   if (t_data == NULL) {
     return REDISMODULE_OK;
   }
 
+  if (t_data->expansions) {
+    for (int i = 0; i < array_len(t_data->expansions); ++i) {
+      ctx->ExpandToken(ctx, strndup(t_data->expansions[i], t_data->expLens[i]),
+                       t_data->expLens[i], 0x0);
+    }
+    return REDISMODULE_OK;
+  }
+
   for (int i = 0; i < array_len(t_data->ids); ++i) {
     char buff[BUFF_LEN];
     int len = SynonymMap_IdToStr(t_data->ids[i], buff, BUFF_LEN);
@@ -417,36 +627,43 @@ void DefaultExpanderFree(void *p) {
 /* Register the default extension */
 int DefaultExtensionInit(RSExtensionCtx *ctx) {
 
+  /* The built-in scorers register through the v2 descriptor with
+   * needsOffsets clear: none of them read res->term.offsets, which is what
+   * lets the engine run its offset-skipping decoders under them */
+
   /* TF-IDF scorer is the default scorer */
-  if (ctx->RegisterScoringFunction(DEFAULT_SCORER_NAME, TFIDFScorer, NULL, NULL) ==
-      REDISEARCH_ERR) {
+  RSScoringFunctionDesc tfidfDesc = {.sf = TFIDFScorer, .bsf = TFIDFBatchScorer};
+  if (ctx->RegisterScoringFunctionV2(DEFAULT_SCORER_NAME, &tfidfDesc) == REDISEARCH_ERR) {
     return REDISEARCH_ERR;
   }
 
   /* DisMax-alike scorer */
-  if (ctx->RegisterScoringFunction(DISMAX_SCORER_NAME, DisMaxScorer, NULL, NULL) ==
-      REDISEARCH_ERR) {
+  RSScoringFunctionDesc dismaxDesc = {.sf = DisMaxScorer};
+  if (ctx->RegisterScoringFunctionV2(DISMAX_SCORER_NAME, &dismaxDesc) == REDISEARCH_ERR) {
     return REDISEARCH_ERR;
   }
 
   /* Register BM25 scorer */
-  if (ctx->RegisterScoringFunction(BM25_SCORER_NAME, BM25Scorer, NULL, NULL) == REDISEARCH_ERR) {
+  RSScoringFunctionDesc bm25Desc = {.sf = BM25Scorer, .bsf = BM25BatchScorer};
+  if (ctx->RegisterScoringFunctionV2(BM25_SCORER_NAME, &bm25Desc) == REDISEARCH_ERR) {
     return REDISEARCH_ERR;
   }
 
   /* Register HAMMING scorer */
-  if (ctx->RegisterScoringFunction(HAMMINGDISTANCE_SCORER, HammingDistanceScorer, NULL, NULL) ==
-      REDISEARCH_ERR) {
+  RSScoringFunctionDesc hammingDesc = {.sf = HammingDistanceScorer};
+  if (ctx->RegisterScoringFunctionV2(HAMMINGDISTANCE_SCORER, &hammingDesc) == REDISEARCH_ERR) {
     return REDISEARCH_ERR;
   }
   /* Register TFIDF.DOCNORM */
-  if (ctx->RegisterScoringFunction(TFIDF_DOCNORM_SCORER_NAME, TFIDFNormDocLenScorer, NULL, NULL) ==
-      REDISEARCH_ERR) {
+  RSScoringFunctionDesc docnormDesc = {.sf = TFIDFNormDocLenScorer,
+                                       .bsf = TFIDFNormDocLenBatchScorer};
+  if (ctx->RegisterScoringFunctionV2(TFIDF_DOCNORM_SCORER_NAME, &docnormDesc) == REDISEARCH_ERR) {
     return REDISEARCH_ERR;
   }
 
   /* Register DOCSCORE scorer */
-  if (ctx->RegisterScoringFunction(DOCSCORE_SCORER, DocScoreScorer, NULL, NULL) == REDISEARCH_ERR) {
+  RSScoringFunctionDesc docscoreDesc = {.sf = DocScoreScorer};
+  if (ctx->RegisterScoringFunctionV2(DOCSCORE_SCORER, &docscoreDesc) == REDISEARCH_ERR) {
     return REDISEARCH_ERR;
   }
 
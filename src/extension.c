@@ -53,6 +53,12 @@ int Ext_RegisterScoringFunction(const char *alias, RSScoringFunction func, RSFre
   ctx->privdata = privdata;
   ctx->ff = ff;
   ctx->sf = func;
+  ctx->bsf = NULL;
+  ctx->newInstance = NULL;
+  ctx->freeInstance = NULL;
+  // v1 registrations carry no capability info: assume the scorer reads
+  // offsets, which only costs the skipping optimization
+  ctx->needsOffsets = 1;
 
   /* Make sure that two scorers are never registered under the same name */
   if (TrieMap_Find(scorers_g, (char *)alias, strlen(alias)) != TRIEMAP_NOTFOUND) {
@@ -64,6 +70,45 @@ int Ext_RegisterScoringFunction(const char *alias, RSScoringFunction func, RSFre
   return REDISEARCH_OK;
 }
 
+/* Register a scorer from a full v2 descriptor: batch entry point and
+ * per-query instance lifecycle included. The scalar entry point remains
+ * mandatory so the scorer keeps working anywhere a batch cannot form */
+int Ext_RegisterScoringFunctionV2(const char *alias, const RSScoringFunctionDesc *desc) {
+  if (!desc || desc->sf == NULL || scorers_g == NULL) {
+    return REDISEARCH_ERR;
+  }
+  // An instance free without a constructor (or vice versa) is a registration bug
+  if (!!desc->NewInstance != !!desc->FreeInstance) {
+    return REDISEARCH_ERR;
+  }
+  if (TrieMap_Find(scorers_g, (char *)alias, strlen(alias)) != TRIEMAP_NOTFOUND) {
+    return REDISEARCH_ERR;
+  }
+  ExtScoringFunctionCtx *ctx = rm_new(ExtScoringFunctionCtx);
+  ctx->sf = desc->sf;
+  ctx->bsf = desc->bsf;
+  ctx->newInstance = desc->NewInstance;
+  ctx->freeInstance = desc->FreeInstance;
+  ctx->ff = desc->ff;
+  ctx->privdata = desc->privdata;
+  ctx->needsOffsets = desc->needsOffsets;
+  TrieMap_Add(scorers_g, (char *)alias, strlen(alias), ctx, NULL);
+  return REDISEARCH_OK;
+}
+
+/* Attach a batch scoring entry point to an already registered scorer alias */
+int Ext_RegisterBatchScoringFunction(const char *alias, RSBatchScoringFunction bsf) {
+  if (bsf == NULL || scorers_g == NULL) {
+    return REDISEARCH_ERR;
+  }
+  ExtScoringFunctionCtx *ctx = TrieMap_Find(scorers_g, (char *)alias, strlen(alias));
+  if (!ctx || (void *)ctx == TRIEMAP_NOTFOUND) {
+    return REDISEARCH_ERR;
+  }
+  ctx->bsf = bsf;
+  return REDISEARCH_OK;
+}
+
 /* Register a aquery expander */
 int Ext_RegisterQueryExpander(const char *alias, RSQueryTokenExpander exp, RSFreeFunction ff,
                               void *privdata) {
@@ -90,6 +135,9 @@ int Extension_Load(const char *name, RSExtensionInitFunc func) {
   RSExtensionCtx ctx = {
       .RegisterScoringFunction = Ext_RegisterScoringFunction,
       .RegisterQueryExpander = Ext_RegisterQueryExpander,
+      .RegisterBatchScoringFunction = Ext_RegisterBatchScoringFunction,
+      .apiVersion = RS_EXTENSION_API_VERSION,
+      .RegisterScoringFunctionV2 = Ext_RegisterScoringFunctionV2,
   };
 
   return func(&ctx);
@@ -14,8 +14,17 @@ void Extensions_Free();
 /* Context for saving a scoring function and its private data and free */
 typedef struct {
   RSScoringFunction sf;
+  /* Optional batch entry point; NULL when the scorer only has the scalar form */
+  RSBatchScoringFunction bsf;
+  /* Optional v2 per-query instance lifecycle */
+  void *(*newInstance)(ScoringFunctionArgs *args);
+  void (*freeInstance)(void *instance);
   RSFreeFunction ff;
   void *privdata;
+  /* Set when the scorer reads res->term.offsets (part of the scoring API):
+   * the offset-skipping decoders are then disabled for its queries. v1
+   * registrations get it conservatively; v2 descriptors declare it */
+  int needsOffsets;
 } ExtScoringFunctionCtx;
 
 /* Context for saving the a token expander and its free / privdata */
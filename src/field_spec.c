@@ -15,8 +15,10 @@ RSValueType fieldTypeToValueType(FieldType ft) {
   }
 }
 
-void FieldSpec_SetName(FieldSpec* fs, const char* name){
-  fs->name = rm_strdup(name);
+/* Point the field at an interned name owned by the spec's table; fields
+ * never own their names (FieldSpec_Cleanup frees nothing) */
+void FieldSpec_SetNameInterned(FieldSpec* fs, const char* interned){
+  fs->name = (char *)interned;
 }
 
 void FieldSpec_SetIndex(FieldSpec* fs, uint16_t index){
@@ -37,6 +39,7 @@ void FieldSpec_InitializeText(FieldSpec* fs){
   FieldSpec_Init(fs);
   fs->type = FIELD_FULLTEXT;
   fs->textOpts.weight = 1.0;
+  fs->textOpts.language = NULL;
 }
 
 void FieldSpec_InitializeNumeric(FieldSpec* fs){
@@ -84,10 +87,18 @@ void FieldSpec_TextNoStem(FieldSpec* fs){
   fs->options |= FieldSpec_NoStemming;
 }
 
+void FieldSpec_TextNoOffsets(FieldSpec* fs){
+  fs->options |= FieldSpec_NoOffsets;
+}
+
 void FieldSpec_TextSetWeight(FieldSpec* fs, double w){
   fs->textOpts.weight = w;
 }
 
+void FieldSpec_TextSetLanguage(FieldSpec* fs, const char* canonicalLang){
+  fs->textOpts.language = canonicalLang;
+}
+
 void FieldSpec_TextPhonetic(FieldSpec* fs){
   fs->options |= FieldSpec_Phonetics;
 }
@@ -105,10 +116,8 @@ void FieldSpec_SetNoIndex(FieldSpec* fs){
 }
 
 void FieldSpec_Cleanup(FieldSpec* fs){
-  if (fs->name) {
-    rm_free(fs->name);
-    fs->name = NULL;
-  }
+  // The name lives in the owning spec's intern table; nothing to free here
+  fs->name = NULL;
 }
 
 void FieldSpec_Free(FieldSpec* fs){
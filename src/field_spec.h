@@ -11,6 +11,12 @@ typedef enum {
   FieldSpec_NoStemming = 0x02,
   FieldSpec_NotIndexable = 0x04,
   FieldSpec_Phonetics = 0x08,
+  // Text field which contributes no term offsets (and no byte offsets): cheaper postings for
+  // fields that are filtered on but never highlighted or proximity-scored
+  FieldSpec_NoOffsets = 0x10,
+  // Numeric field whose values are stored at float32 precision, guaranteeing the 4-byte
+  // value encoding in the numeric index even for high-precision inputs
+  FieldSpec_NumericFloat32 = 0x20,
 } FieldSpecOptions;
 
 // Specific options for text fields
@@ -19,6 +25,10 @@ typedef struct {
   double weight;
   // bitwise id for field masks
   t_fieldId id;
+  // language pinned at creation time; NULL means the field follows the
+  // document's language. Points into the canonical supported-languages table,
+  // so it is never owned or freed
+  const char *language;
 } TextFieldOptions;
 
 // Flags for tag fields
@@ -64,6 +74,8 @@ typedef struct FieldSpec {
 #define FieldSpec_IsNoStem(fs) ((fs)->options & FieldSpec_NoStemming)
 #define FieldSpec_IsPhonetics(fs) ((fs)->options & FieldSpec_Phonetics)
 #define FieldSpec_IsIndexable(fs) (0 == ((fs)->options & FieldSpec_NotIndexable))
+#define FieldSpec_IsNoOffsets(fs) ((fs)->options & FieldSpec_NoOffsets)
+#define FieldSpec_IsFloat32(fs) ((fs)->options & FieldSpec_NumericFloat32)
 
 FieldSpec* FieldSpec_CreateText();
 FieldSpec* FieldSpec_CreateNumeric();
@@ -75,10 +87,12 @@ void FieldSpec_InitializeNumeric(FieldSpec* fs);
 void FieldSpec_InitializeGeo(FieldSpec* fs);
 void FieldSpec_InitializeTag(FieldSpec* fs);
 
-void FieldSpec_SetName(FieldSpec* fs, const char* name);
+void FieldSpec_SetNameInterned(FieldSpec* fs, const char* interned);
 void FieldSpec_SetIndex(FieldSpec* fs, uint16_t index);
 void FieldSpec_TextNoStem(FieldSpec* fs);
+void FieldSpec_TextNoOffsets(FieldSpec* fs);
 void FieldSpec_TextSetWeight(FieldSpec* fs, double w);
+void FieldSpec_TextSetLanguage(FieldSpec* fs, const char* canonicalLang);
 void FieldSpec_TextPhonetic(FieldSpec* fs);
 void FieldSpec_TagSetSeparator(FieldSpec* fs, char sep);
 void FieldSpec_SetSortable(FieldSpec* fs);
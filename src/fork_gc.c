@@ -1,4 +1,6 @@
 #include "fork_gc.h"
+#include "perf_counters.h"
+#include "index_snapshot.h"
 #include "util/arr.h"
 #include "search_ctx.h"
 #include "inverted_index.h"
@@ -14,59 +16,145 @@
 #define GC_WRITERFD 1
 #define GC_READERFD 0
 
+// The child used to issue one write(2) per 8-byte field and the parent one read(2) per field;
+// on indexes with millions of small terms the cycle was dominated by pipe syscalls. All pipe
+// traffic now goes through these buffers, so a frame of many terms crosses the pipe in one
+// syscall. The protocol bytes are unchanged
+#define GC_PIPE_BUFSZ (64 * 1024)
+
+// cap for the idle-cycle interval multiplier
+#define FORKGC_MAX_IDLE_BACKOFF 16
+
+
 static void ForkGc_updateStats(RedisSearchCtx *sctx, ForkGCCtx *gc, size_t recordsRemoved,
                                size_t bytesCollected) {
   sctx->spec->stats.numRecords -= recordsRemoved;
   sctx->spec->stats.invertedSize -= bytesCollected;
   gc->stats.totalCollected += bytesCollected;
+  gc->stats.totalDocsCollected += recordsRemoved;
+}
+
+static void ForkGc_FlushWrites(ForkGCCtx *gc) {
+  int fd = gc->pipefd[GC_WRITERFD];
+  size_t off = 0;
+  while (off < gc->pipeWriteLen) {
+    ssize_t n = write(fd, gc->pipeWriteBuf + off, gc->pipeWriteLen - off);
+    assert(n > 0);
+    off += n;
+  }
+  gc->pipeWriteLen = 0;
+}
+
+static void ForkGc_BufferedWrite(ForkGCCtx *gc, const void *data, size_t len) {
+  if (gc->pipeWriteLen + len > GC_PIPE_BUFSZ) {
+    ForkGc_FlushWrites(gc);
+  }
+  if (len > GC_PIPE_BUFSZ) {
+    // oversized payloads (large block buffers) bypass the buffer
+    int fd = gc->pipefd[GC_WRITERFD];
+    size_t off = 0;
+    while (off < len) {
+      ssize_t n = write(fd, (const char *)data + off, len - off);
+      assert(n > 0);
+      off += n;
+    }
+    return;
+  }
+  memcpy(gc->pipeWriteBuf + gc->pipeWriteLen, data, len);
+  gc->pipeWriteLen += len;
 }
 
-static void ForkGc_FDWriteLongLong(int fd, long long val) {
-  ssize_t size = write(fd, &val, sizeof(long long));
-  assert(size == sizeof(long long));
+static void ForkGc_FDWriteLongLong(ForkGCCtx *gc, long long val) {
+  ForkGc_BufferedWrite(gc, &val, sizeof(val));
 }
 
-static void ForkGc_FDWritePtr(int fd, void *val) {
-  ssize_t size = write(fd, &val, sizeof(void *));
-  assert(size == sizeof(void *));
+static void ForkGc_FDWritePtr(ForkGCCtx *gc, void *val) {
+  ForkGc_BufferedWrite(gc, &val, sizeof(val));
 }
 
-static void ForkGc_FDWriteBuffer(int fd, const char *buff, size_t len) {
-  ForkGc_FDWriteLongLong(fd, len);
+static void ForkGc_FDWriteBuffer(ForkGCCtx *gc, const char *buff, size_t len) {
+  ForkGc_FDWriteLongLong(gc, len);
   if (len > 0) {
-    ssize_t size = write(fd, buff, len);
-    assert(size == len);
+    ForkGc_BufferedWrite(gc, buff, len);
   }
 }
 
-static long long ForkGc_FDReadLongLong(int fd) {
+/* Fill `data` with exactly `len` bytes through the read buffer. Returns 0 on EOF */
+static int ForkGc_BufferedRead(ForkGCCtx *gc, void *data, size_t len) {
+  int fd = gc->pipefd[GC_READERFD];
+  size_t off = 0;
+  while (off < len) {
+    if (gc->pipeReadPos == gc->pipeReadLen) {
+      ssize_t n = read(fd, gc->pipeReadBuf, GC_PIPE_BUFSZ);
+      if (n <= 0) {
+        return 0;
+      }
+      gc->pipeReadLen = n;
+      gc->pipeReadPos = 0;
+    }
+    size_t avail = gc->pipeReadLen - gc->pipeReadPos;
+    size_t take = avail < len - off ? avail : len - off;
+    memcpy((char *)data + off, gc->pipeReadBuf + gc->pipeReadPos, take);
+    gc->pipeReadPos += take;
+    off += take;
+  }
+  return 1;
+}
+
+static long long ForkGc_FDReadLongLong(ForkGCCtx *gc) {
   long long ret;
-  ssize_t sizeRead = read(fd, &ret, sizeof(ret));
-  if (sizeRead != sizeof(ret)) {
+  if (!ForkGc_BufferedRead(gc, &ret, sizeof(ret))) {
     return 0;
   }
   return ret;
 }
 
-static void *ForkGc_FDReadPtr(int fd) {
+static void *ForkGc_FDReadPtr(ForkGCCtx *gc) {
   void *ret;
-  ssize_t sizeRead = read(fd, &ret, sizeof(ret));
-  if (sizeRead != sizeof(ret)) {
+  if (!ForkGc_BufferedRead(gc, &ret, sizeof(ret))) {
     return 0;
   }
   return ret;
 }
 
-static char *ForkGc_FDReadBuffer(int fd, size_t *len) {
-  *len = ForkGc_FDReadLongLong(fd);
+static char *ForkGc_FDReadBuffer(ForkGCCtx *gc, size_t *len) {
+  *len = ForkGc_FDReadLongLong(gc);
   if (*len == 0) {
     return NULL;
   }
   char *buff = rm_malloc(*len * sizeof(char));
-  read(fd, buff, *len);
+  if (!ForkGc_BufferedRead(gc, buff, *len)) {
+    rm_free(buff);
+    *len = 0;
+    return NULL;
+  }
   return buff;
 }
 
+/* Build the child's liveness snapshot: one batched cursor pass over the
+ * fork-frozen doc table, after which every posting scan tests a bit instead
+ * of taking a shard lock and walking a bucket chain per entry */
+static void ForkGc_BuildLiveness(ForkGCCtx *gc, const DocTable *t) {
+  gc->liveEpoch = t->maxDocId;
+  gc->liveDocs = rm_calloc((gc->liveEpoch >> 3) + 1, 1);
+  DocTableCursor cursor = DocTable_Cursor(t);
+  const RSDocumentMetadata *batch[DOCTABLE_CURSOR_BATCH];
+  size_t n;
+  while ((n = DocTableCursor_NextBatch(&cursor, batch, DOCTABLE_CURSOR_BATCH))) {
+    for (size_t i = 0; i < n; ++i) {
+      gc->liveDocs[batch[i]->id >> 3] |= 1 << (batch[i]->id & 7);
+    }
+  }
+}
+
+static inline int ForkGc_IsLive(const ForkGCCtx *gc, t_docId docId) {
+  return docId <= gc->liveEpoch && (gc->liveDocs[docId >> 3] & (1 << (docId & 7)));
+}
+
+static int ForkGc_DocExistsCb(t_docId docId, void *arg) {
+  return ForkGc_IsLive(arg, docId);
+}
+
 static bool ForkGc_InvertedIndexRepair(ForkGCCtx *gc, RedisSearchCtx *sctx, InvertedIndex *idx,
                                        void (*RepairCallback)(const RSIndexResult *, void *),
                                        void *arg) {
@@ -85,6 +173,8 @@ static bool ForkGc_InvertedIndexRepair(ForkGCCtx *gc, RedisSearchCtx *sctx, Inve
     IndexRepairParams params = {0};
     params.RepairCallback = RepairCallback;
     params.arg = arg;
+    params.DocExists = ForkGc_DocExistsCb;
+    params.existsArg = gc;
     numDocsBefore[i] = blk->numDocs;
     int repaired = IndexBlock_Repair(blk, &sctx->spec->docs, idx->flags, &params);
     // We couldn't repair the block - return 0
@@ -93,6 +183,11 @@ static bool ForkGc_InvertedIndexRepair(ForkGCCtx *gc, RedisSearchCtx *sctx, Inve
     }
 
     if (repaired > 0) {
+      if ((idx->flags & Index_PackedDocIds) && i != idx->size - 1) {
+        // Send completed blocks back in their fixed-width form. The tail block stays varint
+        // since the writer may still append to it
+        IndexBlock_PackDocIds(blk);
+      }
       blocksFixed = array_append(blocksFixed, i);
     }
 
@@ -102,33 +197,36 @@ static bool ForkGc_InvertedIndexRepair(ForkGCCtx *gc, RedisSearchCtx *sctx, Inve
 
   if (array_len(blocksFixed) == 0) {
     // no blocks was repaired
-    ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], 0);
+    ForkGc_FDWriteLongLong(gc, 0);
     array_free(blocksFixed);
     return false;
   }
 
   // write number of repaired blocks
-  ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], array_len(blocksFixed));
+  ForkGc_FDWriteLongLong(gc, array_len(blocksFixed));
 
   // write total bytes collected
-  ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], totalBytesCollected);
+  ForkGc_FDWriteLongLong(gc, totalBytesCollected);
 
   // write total docs collected
-  ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], totalDocsCollected);
+  ForkGc_FDWriteLongLong(gc, totalDocsCollected);
 
   // write total number of blocks
-  ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], idx->size);
+  ForkGc_FDWriteLongLong(gc, idx->size);
 
   for (int i = 0; i < array_len(blocksFixed); ++i) {
     // write fix block
     IndexBlock *blk = idx->blocks + blocksFixed[i];
-    ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], blocksFixed[i]);  // writing the block index
-    ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], blk->firstId);
-    ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], blk->lastId);
-    ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], blk->numDocs);
-    ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD],
-                           numDocsBefore[blocksFixed[i]]);  // send num docs before
-    ForkGc_FDWriteBuffer(gc->pipefd[GC_WRITERFD], IndexBlock_DataBuf(blk), IndexBlock_DataLen(blk));
+    ForkGc_FDWriteLongLong(gc, blocksFixed[i]);  // writing the block index
+    ForkGc_FDWriteLongLong(gc, blk->firstId);
+    ForkGc_FDWriteLongLong(gc, blk->lastId);
+    ForkGc_FDWriteLongLong(gc, blk->numDocs);
+    // the survivor-tightened pruning metadata, so the parent's swapped-in
+    // block keeps its max-impact bound and field-mask union
+    ForkGc_FDWriteLongLong(gc, blk->maxFreq);
+    ForkGc_FDWriteLongLong(gc, blk->fieldMaskUnion);
+    ForkGc_FDWriteLongLong(gc, numDocsBefore[blocksFixed[i]]);  // send num docs before
+    ForkGc_FDWriteBuffer(gc, IndexBlock_DataBuf(blk), IndexBlock_DataLen(blk));
   }
   array_free(blocksFixed);
   return true;
@@ -139,7 +237,7 @@ static void ForkGc_CollectTerm(ForkGCCtx *gc, RedisSearchCtx *sctx, char *term,
   InvertedIndex *idx = Redis_OpenInvertedIndexEx(sctx, term, strlen(term), 1, &idxKey);
   if (idx) {
     // inverted index name
-    ForkGc_FDWriteBuffer(gc->pipefd[GC_WRITERFD], term, termLen);
+    ForkGc_FDWriteBuffer(gc, term, termLen);
 
     ForkGc_InvertedIndexRepair(gc, sctx, idx, NULL, NULL);
   }
@@ -164,10 +262,46 @@ static void ForkGc_CollectGarbageFromInvIdx(ForkGCCtx *gc, RedisSearchCtx *sctx)
   t_len slen = 0;
   float score = 0;
   int dist = 0;
+  // Incremental mode: skip up to (and including) the previous cycle's cursor, and stop after
+  // the budgeted number of terms, leaving the rest for the next fork
+  size_t budget = RSGlobalConfig.forkGcTermBudget;
+  size_t processed = 0;
+  int skipping = gc->termCursor != NULL;
+  char *nextCursor = NULL;
+  size_t nextCursorLen = 0;
+
   while (TrieIterator_Next(iter, &rstr, &slen, NULL, &score, &dist)) {
     size_t termLen;
     char *term = runesToStr(rstr, slen, &termLen);
-    ForkGc_CollectTerm(gc, sctx, term, termLen);
+    if (skipping) {
+      // Resume after the exact cursor term - trie iteration order is stable but not
+      // necessarily lexicographic, so positional matching is the only safe resume
+      if (termLen == gc->termCursorLen && !memcmp(term, gc->termCursor, termLen)) {
+        skipping = 0;
+      }
+      free(term);
+      continue;
+    }
+    if (sctx->spec->partitionSpan > 0) {
+      // each partition is its own dictionary entry; collecting them
+      // separately keeps the per-term repair images (and the parent's apply
+      // slices) partition-sized
+      uint32_t maxPart = (uint32_t)(sctx->spec->docs.maxDocId / sctx->spec->partitionSpan);
+      for (uint32_t p = 0; p <= maxPart; p++) {
+        char pterm[1024];
+        int plen = snprintf(pterm, sizeof(pterm), "%.*s#p%u", (int)termLen, term, p);
+        if (plen > 0 && (size_t)plen < sizeof(pterm)) {
+          ForkGc_CollectTerm(gc, sctx, pterm, plen);
+        }
+      }
+    } else {
+      ForkGc_CollectTerm(gc, sctx, term, termLen);
+    }
+    if (budget && ++processed >= budget) {
+      nextCursor = term;
+      nextCursorLen = termLen;
+      break;
+    }
     free(term);
   }
   DFAFilter_Free(iter->ctx);
@@ -175,7 +309,69 @@ static void ForkGc_CollectGarbageFromInvIdx(ForkGCCtx *gc, RedisSearchCtx *sctx)
   TrieIterator_Free(iter);
 
   // we are done with terms
-  ForkGc_FDWriteBuffer(gc->pipefd[GC_WRITERFD], "\0", 1);
+  ForkGc_FDWriteBuffer(gc, "\0", 1);
+
+  // tell the parent where to resume next cycle (empty - scan wrapped, start over)
+  ForkGc_FDWriteBuffer(gc, nextCursor ? nextCursor : "",
+                       nextCursor ? nextCursorLen : 0);
+  free(nextCursor);
+}
+
+/* Mode marker written per numeric field: how the parent should apply the field's repairs */
+#define FGC_NUMERIC_MODE_REPAIR 0
+#define FGC_NUMERIC_MODE_REBUILD 1
+
+// Above this garbage fraction the child ships the field's live entries for a bottom-up
+// rebuild-and-swap instead of per-range repairs
+#define FGC_NUMERIC_REBUILD_RATIO 0.1
+
+/* Count the field's total and live entries by scanning the leaves (leaf docId sets are
+ * disjoint; inner retained ranges duplicate them) */
+static void ForkGc_NumericCensus(ForkGCCtx *gc, RedisSearchCtx *sctx, NumericRangeTree *rt,
+                                 size_t *total, size_t *live) {
+  *total = *live = 0;
+  NumericRangeTreeIterator *it = NumericRangeTreeIterator_New(rt);
+  NumericRangeNode *n;
+  while ((n = NumericRangeTreeIterator_Next(it))) {
+    if (!NumericRangeNode_IsLeaf(n) || !n->range) {
+      continue;
+    }
+    RSIndexResult *res = NULL;
+    IndexReader *ir = NewNumericReader(NULL, n->range->entries, NULL);
+    while (INDEXREAD_OK == IR_Read(ir, &res)) {
+      ++*total;
+      if (ForkGc_IsLive(gc, res->docId)) {
+        ++*live;
+      }
+    }
+    IR_Free(ir);
+  }
+  NumericRangeTreeIterator_Free(it);
+}
+
+/* Ship every live entry of the field; the parent rebuilds the tree bottom-up and swaps it in
+ * under a single revision bump, so readers never traverse half-repaired leaves */
+static void ForkGc_ShipNumericRebuild(ForkGCCtx *gc, RedisSearchCtx *sctx, NumericRangeTree *rt,
+                                      size_t live) {
+  ForkGc_FDWriteLongLong(gc, live);
+  NumericRangeTreeIterator *it = NumericRangeTreeIterator_New(rt);
+  NumericRangeNode *n;
+  while ((n = NumericRangeTreeIterator_Next(it))) {
+    if (!NumericRangeNode_IsLeaf(n) || !n->range) {
+      continue;
+    }
+    RSIndexResult *res = NULL;
+    IndexReader *ir = NewNumericReader(NULL, n->range->entries, NULL);
+    while (INDEXREAD_OK == IR_Read(ir, &res)) {
+      if (!ForkGc_IsLive(gc, res->docId)) {
+        continue;
+      }
+      ForkGc_FDWriteLongLong(gc, res->docId);
+      ForkGc_BufferedWrite(gc, &res->num.value, sizeof(double));
+    }
+    IR_Free(ir);
+  }
+  NumericRangeTreeIterator_Free(it);
 }
 
 static void ForkGc_CollectGarbageFromNumIdx(ForkGCCtx *gc, RedisSearchCtx *sctx) {
@@ -191,10 +387,23 @@ static void ForkGc_CollectGarbageFromNumIdx(ForkGCCtx *gc, RedisSearchCtx *sctx)
       NumericRangeNode *currNode = NULL;
 
       // numeric field name
-      ForkGc_FDWriteBuffer(gc->pipefd[GC_WRITERFD], numericFields[i]->name,
+      ForkGc_FDWriteBuffer(gc, numericFields[i]->name,
                            strlen(numericFields[i]->name) + 1);
       // numeric field unique id
-      ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], rt->uniqueId);
+      ForkGc_FDWriteLongLong(gc, rt->uniqueId);
+
+      // churny fields get the offline rebuild: the child ships live entries, the parent
+      // swaps in a freshly built tree
+      size_t total, live;
+      ForkGc_NumericCensus(gc, sctx, rt, &total, &live);
+      if (total && (double)(total - live) / total >= FGC_NUMERIC_REBUILD_RATIO) {
+        ForkGc_FDWriteLongLong(gc, FGC_NUMERIC_MODE_REBUILD);
+        ForkGc_ShipNumericRebuild(gc, sctx, rt, live);
+        if (idxKey) RedisModule_CloseKey(idxKey);
+        NumericRangeTreeIterator_Free(gcIterator);
+        continue;
+      }
+      ForkGc_FDWriteLongLong(gc, FGC_NUMERIC_MODE_REPAIR);
 
       while ((currNode = NumericRangeTreeIterator_Next(gcIterator))) {
         if (!currNode->range) {
@@ -209,25 +418,25 @@ static void ForkGc_CollectGarbageFromNumIdx(ForkGCCtx *gc, RedisSearchCtx *sctx)
           valuesDeleted = array_append(valuesDeleted, valueDeleted);
         }
         // write node pointer
-        ForkGc_FDWritePtr(gc->pipefd[GC_WRITERFD], currNode);
+        ForkGc_FDWritePtr(gc, currNode);
 
         bool repaired = ForkGc_InvertedIndexRepair(gc, sctx, currNode->range->entries,
                                                    ForkGc_CountDeletedCardinality, valuesDeleted);
 
         if (repaired) {
           // send reduced cardinality size
-          ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], currNode->range->card);
+          ForkGc_FDWriteLongLong(gc, currNode->range->card);
 
           // send reduced cardinality
           for (int i = 0; i < currNode->range->card; ++i) {
-            ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], valuesDeleted[i].appearances);
+            ForkGc_FDWriteLongLong(gc, valuesDeleted[i].appearances);
           }
         }
         array_free(valuesDeleted);
       }
 
       // we are done with the current field
-      ForkGc_FDWritePtr(gc->pipefd[GC_WRITERFD], 0);
+      ForkGc_FDWritePtr(gc, 0);
 
       if (idxKey) RedisModule_CloseKey(idxKey);
 
@@ -236,7 +445,7 @@ static void ForkGc_CollectGarbageFromNumIdx(ForkGCCtx *gc, RedisSearchCtx *sctx)
   }
 
   // we are done with numeric fields
-  ForkGc_FDWriteBuffer(gc->pipefd[GC_WRITERFD], "\0", 1);
+  ForkGc_FDWriteBuffer(gc, "\0", 1);
 }
 
 static void ForkGc_CollectGarbageFromTagIdx(ForkGCCtx *gc, RedisSearchCtx *sctx) {
@@ -251,10 +460,10 @@ static void ForkGc_CollectGarbageFromTagIdx(ForkGCCtx *gc, RedisSearchCtx *sctx)
       }
 
       // tag field name
-      ForkGc_FDWriteBuffer(gc->pipefd[GC_WRITERFD], tagFields[i]->name,
+      ForkGc_FDWriteBuffer(gc, tagFields[i]->name,
                            strlen(tagFields[i]->name) + 1);
       // numeric field unique id
-      ForkGc_FDWriteLongLong(gc->pipefd[GC_WRITERFD], tagIdx->uniqueId);
+      ForkGc_FDWriteLongLong(gc, tagIdx->uniqueId);
 
       TrieMapIterator *iter = TrieMap_Iterate(tagIdx->values, "", 0);
       char *ptr;
@@ -262,19 +471,19 @@ static void ForkGc_CollectGarbageFromTagIdx(ForkGCCtx *gc, RedisSearchCtx *sctx)
       InvertedIndex *value;
       while (TrieMapIterator_Next(iter, &ptr, &len, (void **)&value)) {
         // send inverted index pointer
-        ForkGc_FDWritePtr(gc->pipefd[GC_WRITERFD], value);
+        ForkGc_FDWritePtr(gc, value);
         // send repaired data
         ForkGc_InvertedIndexRepair(gc, sctx, value, NULL, NULL);
       }
 
       // we are done with the current field
-      ForkGc_FDWritePtr(gc->pipefd[GC_WRITERFD], 0);
+      ForkGc_FDWritePtr(gc, 0);
 
       if (idxKey) RedisModule_CloseKey(idxKey);
     }
   }
   // we are done with numeric fields
-  ForkGc_FDWriteBuffer(gc->pipefd[GC_WRITERFD], "\0", 1);
+  ForkGc_FDWriteBuffer(gc, "\0", 1);
 }
 
 static void ForkGc_CollectGarbage(ForkGCCtx *gc) {
@@ -288,12 +497,19 @@ static void ForkGc_CollectGarbage(ForkGCCtx *gc) {
     return;
   }
 
+  // Snapshot doc liveness once for the whole cycle; the memory image is
+  // frozen by the fork, so the bitmap cannot go stale
+  ForkGc_BuildLiveness(gc, &sctx->spec->docs);
+
   ForkGc_CollectGarbageFromInvIdx(gc, sctx);
 
   ForkGc_CollectGarbageFromNumIdx(gc, sctx);
 
   ForkGc_CollectGarbageFromTagIdx(gc, sctx);
 
+  rm_free(gc->liveDocs);
+  gc->liveDocs = NULL;
+
   if (sctx) {
     SearchCtx_Free(sctx);
     RedisModule_FreeThreadSafeContext(rctx);
@@ -313,26 +529,29 @@ typedef struct {
 } ForkGc_InvertedIndexData;
 
 static void ForkGc_ReadModifiedBlock(ForkGCCtx *gc, ModifiedBlock *blockModified) {
-  blockModified->blockIndex = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
-  blockModified->blk.firstId = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
-  blockModified->blk.lastId = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
-  blockModified->blk.numDocs = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
-  blockModified->numBlocksBefore = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
+  memset(&blockModified->blk, 0, sizeof(blockModified->blk));
+  blockModified->blockIndex = ForkGc_FDReadLongLong(gc);
+  blockModified->blk.firstId = ForkGc_FDReadLongLong(gc);
+  blockModified->blk.lastId = ForkGc_FDReadLongLong(gc);
+  blockModified->blk.numDocs = ForkGc_FDReadLongLong(gc);
+  blockModified->blk.maxFreq = ForkGc_FDReadLongLong(gc);
+  blockModified->blk.fieldMaskUnion = ForkGc_FDReadLongLong(gc);
+  blockModified->numBlocksBefore = ForkGc_FDReadLongLong(gc);
 
   Buffer *b = &blockModified->blk.buf;
-  b->data = ForkGc_FDReadBuffer(gc->pipefd[GC_READERFD], &b->offset);
+  b->data = ForkGc_FDReadBuffer(gc, &b->offset);
   b->cap = b->offset;
 }
 
 static bool ForkGc_ReadInvertedIndexFromFork(ForkGCCtx *gc, ForkGc_InvertedIndexData *idxData) {
-  long long blocksModifiedSize = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
+  long long blocksModifiedSize = ForkGc_FDReadLongLong(gc);
   if (blocksModifiedSize == 0) {
     return false;
   }
 
-  idxData->bytesCollected = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
-  idxData->docsCollected = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
-  ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);  // throw totalblocks in inverted index
+  idxData->bytesCollected = ForkGc_FDReadLongLong(gc);
+  idxData->docsCollected = ForkGc_FDReadLongLong(gc);
+  ForkGc_FDReadLongLong(gc);  // throw totalblocks in inverted index
 
   idxData->blocksModified = array_new(ModifiedBlock, blocksModifiedSize);
   for (int i = 0; i < blocksModifiedSize; ++i) {
@@ -343,23 +562,40 @@ static bool ForkGc_ReadInvertedIndexFromFork(ForkGCCtx *gc, ForkGc_InvertedIndex
   return true;
 }
 
+/* Swap repaired blocks in under the lock, but RETIRE the replaced blocks into `retired`
+ * instead of freeing them: the frees - often the slowest part of the apply phase - happen
+ * after the GIL is released, shrinking the query pause to the pointer swaps themselves.
+ * In-flight readers are revalidated through the gc marker on their next reopen as before */
 static void ForkGc_FixInvertedIndex(ForkGCCtx *gc, ForkGc_InvertedIndexData *idxData,
-                                    InvertedIndex *idx) {
+                                    InvertedIndex *idx, IndexBlock **retired) {
+  PERF_SCOPE(PERFCTR_GC_APPLY);
   for (int i = 0; i < array_len(idxData->blocksModified); ++i) {
     ModifiedBlock *blockModified = idxData->blocksModified + i;
     if (blockModified->numBlocksBefore == idx->blocks[blockModified->blockIndex].numDocs) {
-      indexBlock_Free(&idx->blocks[blockModified->blockIndex]);
+      gc->stats.totalBlocksRepaired++;
+      *array_ensure_tail(retired, IndexBlock) = idx->blocks[blockModified->blockIndex];
       idx->blocks[blockModified->blockIndex] = blockModified->blk;
     } else {
       gc->stats.gcBlocksDenied++;
-      Buffer_Free(&blockModified->blk.buf);
+      *array_ensure_tail(retired, IndexBlock) = blockModified->blk;
     }
   }
 }
 
+/* Free retired blocks outside the lock */
+static void ForkGc_FreeRetired(IndexBlock *retired) {
+  if (!retired) {
+    return;
+  }
+  for (size_t i = 0; i < array_len(retired); ++i) {
+    indexBlock_Free(&retired[i]);
+  }
+  array_free(retired);
+}
+
 static bool ForkGc_ReadInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx *rctx) {
   size_t len;
-  char *term = ForkGc_FDReadBuffer(gc->pipefd[GC_READERFD], &len);
+  char *term = ForkGc_FDReadBuffer(gc, &len);
   if (term == NULL || term[0] == '\0') {
     if (term) {
       rm_free(term);
@@ -375,6 +611,7 @@ static bool ForkGc_ReadInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx
 
   RedisModule_ThreadSafeContextLock(rctx);
   RedisModuleKey *idxKey = NULL;
+  IndexBlock *retired = NULL;
   RedisSearchCtx *sctx = NULL;
   sctx = NewSearchCtx(rctx, (RedisModuleString *)gc->keyName, false);
   if (!sctx || sctx->spec->uniqueId != gc->specUniqueId) {
@@ -389,7 +626,15 @@ static bool ForkGc_ReadInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx
     goto cleanup;
   }
 
-  ForkGc_FixInvertedIndex(gc, &idxData, idx);
+  // Exclusive writer slice: block swaps and compaction move data a reader
+  // slice may hold pointers into
+  IndexSpec_LockWrite(sctx->spec);
+  ForkGc_FixInvertedIndex(gc, &idxData, idx, &retired);
+  // Applying repairs can leave a run of under-filled blocks - coalesce them while we still
+  // hold the GIL
+  InvertedIndex_CompactBlocks(idx);
+  IndexSpec_BumpTermEpoch(sctx->spec);
+  IndexSpec_UnlockIndex(sctx->spec);
 
   ForkGc_updateStats(sctx, gc, idxData.docsCollected, idxData.bytesCollected);
 
@@ -404,6 +649,8 @@ cleanup:
   if (rctx) {
     RedisModule_ThreadSafeContextUnlock(rctx);
   }
+  // replaced buffers are released only after queries may run again
+  ForkGc_FreeRetired(retired);
   if (term) {
     rm_free(term);
   }
@@ -424,7 +671,7 @@ cleanup:
 
 static bool ForkGc_ReadNumericInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx *rctx) {
   size_t fieldNameLen;
-  char *fieldName = ForkGc_FDReadBuffer(gc->pipefd[GC_READERFD], &fieldNameLen);
+  char *fieldName = ForkGc_FDReadBuffer(gc, &fieldNameLen);
   if (fieldName == NULL || fieldName[0] == '\0') {
     if (fieldName) {
       rm_free(fieldName);
@@ -432,12 +679,55 @@ static bool ForkGc_ReadNumericInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisMo
     return false;
   }
 
-  uint64_t rtUniqueId = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
+  uint64_t rtUniqueId = ForkGc_FDReadLongLong(gc);
+
+  long long mode = ForkGc_FDReadLongLong(gc);
+  if (mode == FGC_NUMERIC_MODE_REBUILD) {
+    // read the complete live entry set, rebuild bottom-up and swap under one revision bump
+    long long nlive = ForkGc_FDReadLongLong(gc);
+    NumericBulkEntry *entries = rm_malloc((nlive ? nlive : 1) * sizeof(*entries));
+    for (long long i = 0; i < nlive; i++) {
+      entries[i].docId = ForkGc_FDReadLongLong(gc);
+      ForkGc_BufferedRead(gc, &entries[i].value, sizeof(double));
+    }
+
+    RedisModule_ThreadSafeContextLock(rctx);
+    RedisSearchCtx *sctx = NewSearchCtx(rctx, (RedisModuleString *)gc->keyName, false);
+    if (sctx && sctx->spec->uniqueId == gc->specUniqueId) {
+      RedisModuleString *kn = fmtRedisNumericIndexKey(sctx, fieldName);
+      RedisModuleKey *idxKey = NULL;
+      NumericRangeTree *rt = OpenNumericIndex(sctx, kn, &idxKey);
+      if (rt && rt->uniqueId == rtUniqueId) {
+        size_t before = rt->numEntries;
+        if (nlive) {
+          IndexSpec_LockWrite(sctx->spec);
+          NumericRangeTree_BulkLoad(rt, entries, nlive);
+          IndexSpec_UnlockIndex(sctx->spec);
+        }
+        if (before > (size_t)nlive) {
+          gc->stats.totalCollected += (before - nlive) * sizeof(NumericBulkEntry);
+        }
+      }
+      if (idxKey) {
+        RedisModule_CloseKey(idxKey);
+      }
+      RedisModule_FreeString(rctx, kn);
+    }
+    if (sctx) {
+      SearchCtx_Free(sctx);
+    }
+    RedisModule_ThreadSafeContextUnlock(rctx);
+    rm_free(entries);
+    rm_free(fieldName);
+    return true;
+  }
 
   NumericRangeNode *currNode = NULL;
   bool shouldReturn = false;
   RedisModuleString *keyName = NULL;
-  while ((currNode = ForkGc_FDReadPtr(gc->pipefd[GC_READERFD]))) {
+  IndexBlock *retired = NULL;
+  while ((currNode = ForkGc_FDReadPtr(gc))) {
+    retired = NULL;
 
     ForkGc_InvertedIndexData idxData = {0};
     if (!ForkGc_ReadInvertedIndexFromFork(gc, &idxData)) {
@@ -445,12 +735,12 @@ static bool ForkGc_ReadNumericInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisMo
     }
 
     // read reduced cardinality size
-    long long reduceCardinalitySize = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
+    long long reduceCardinalitySize = ForkGc_FDReadLongLong(gc);
     long long valuesDeleted[reduceCardinalitySize];
 
     // read reduced cardinality
     for (int i = 0; i < reduceCardinalitySize; ++i) {
-      valuesDeleted[i] = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
+      valuesDeleted[i] = ForkGc_FDReadLongLong(gc);
     }
 
     RedisModule_ThreadSafeContextLock(rctx);
@@ -472,7 +762,9 @@ static bool ForkGc_ReadNumericInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisMo
       CONTINUE;
     }
 
-    ForkGc_FixInvertedIndex(gc, &idxData, currNode->range->entries);
+    IndexSpec_LockWrite(sctx->spec);
+    ForkGc_FixInvertedIndex(gc, &idxData, currNode->range->entries, &retired);
+    IndexSpec_UnlockIndex(sctx->spec);
 
     ForkGc_updateStats(sctx, gc, idxData.docsCollected, idxData.bytesCollected);
 
@@ -511,6 +803,8 @@ static bool ForkGc_ReadNumericInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisMo
       RedisModule_CloseKey(idxKey);
     }
     RedisModule_ThreadSafeContextUnlock(rctx);
+    ForkGc_FreeRetired(retired);
+    retired = NULL;
     if (shouldReturn) {
       if (fieldName) {
         rm_free(fieldName);
@@ -527,7 +821,7 @@ static bool ForkGc_ReadNumericInvertedIndex(ForkGCCtx *gc, int *ret_val, RedisMo
 
 static bool ForkGc_ReadTagIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx *rctx) {
   size_t fieldNameLen;
-  char *fieldName = ForkGc_FDReadBuffer(gc->pipefd[GC_READERFD], &fieldNameLen);
+  char *fieldName = ForkGc_FDReadBuffer(gc, &fieldNameLen);
   if (fieldName == NULL || fieldName[0] == '\0') {
     if (fieldName) {
       rm_free(fieldName);
@@ -535,11 +829,12 @@ static bool ForkGc_ReadTagIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx *rct
     return false;
   }
 
-  uint64_t tagUniqueId = ForkGc_FDReadLongLong(gc->pipefd[GC_READERFD]);
+  uint64_t tagUniqueId = ForkGc_FDReadLongLong(gc);
   bool shouldReturn = false;
+  IndexBlock *retired = NULL;
   InvertedIndex *value = NULL;
   RedisModuleString *keyName = NULL;
-  while ((value = ForkGc_FDReadPtr(gc->pipefd[GC_READERFD]))) {
+  while ((value = ForkGc_FDReadPtr(gc))) {
     ForkGc_InvertedIndexData idxData = {0};
     if (!ForkGc_ReadInvertedIndexFromFork(gc, &idxData)) {
       continue;
@@ -559,7 +854,10 @@ static bool ForkGc_ReadTagIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx *rct
       RETURN;
     }
 
-    ForkGc_FixInvertedIndex(gc, &idxData, value);
+    retired = NULL;
+    IndexSpec_LockWrite(sctx->spec);
+    ForkGc_FixInvertedIndex(gc, &idxData, value, &retired);
+    IndexSpec_UnlockIndex(sctx->spec);
 
     ForkGc_updateStats(sctx, gc, idxData.docsCollected, idxData.bytesCollected);
 
@@ -577,6 +875,8 @@ static bool ForkGc_ReadTagIndex(ForkGCCtx *gc, int *ret_val, RedisModuleCtx *rct
       RedisModule_CloseKey(idxKey);
     }
     RedisModule_ThreadSafeContextUnlock(rctx);
+    ForkGc_FreeRetired(retired);
+    retired = NULL;
     if (shouldReturn) {
       if (fieldName) {
         rm_free(fieldName);
@@ -601,6 +901,21 @@ void ForkGc_ReadGarbageFromFork(ForkGCCtx *gc, int *ret_val) {
     goto done;
   }
 
+  // the child reports where the (possibly budgeted) term scan stopped
+  {
+    size_t len = 0;
+    char *cursor = ForkGc_FDReadBuffer(gc, &len);
+    rm_free(gc->termCursor);
+    gc->termCursor = NULL;
+    gc->termCursorLen = 0;
+    if (cursor && len) {
+      gc->termCursor = cursor;
+      gc->termCursorLen = len;
+    } else if (cursor) {
+      rm_free(cursor);
+    }
+  }
+
   while (ForkGc_ReadNumericInvertedIndex(gc, ret_val, rctx))
     ;
 
@@ -645,10 +960,15 @@ static int ForkGc_PeriodicCallback(RedisModuleCtx *ctx, void *privdata) {
   RedisModule_ThreadSafeContextLock(ctx);
   cpid = fork();  // duplicate the current process
   RedisModule_ThreadSafeContextUnlock(ctx);
+  // both directions start each cycle clean: a child that died mid-frame in a
+  // previous cycle must not leave protocol bytes behind
+  gc->pipeWriteLen = 0;
+  gc->pipeReadLen = gc->pipeReadPos = 0;
   if (cpid == 0) {
     // fork process
     close(gc->pipefd[GC_READERFD]);
     ForkGc_CollectGarbage(gc);
+    ForkGc_FlushWrites(gc);
     close(gc->pipefd[GC_WRITERFD]);
     sleep(RSGlobalConfig.forkGcSleepBeforeExit);
     _exit(EXIT_SUCCESS);
@@ -666,9 +986,36 @@ static int ForkGc_PeriodicCallback(RedisModuleCtx *ctx, void *privdata) {
 
   long long msRun = TimeSampler_DurationMS(&ts);
 
+  // The cycle's rewrites invalidated any cached snapshot blob; rebuild it in
+  // the background so the next BGSAVE streams instead of serializing
+  {
+    RedisModuleCtx *rctx = RedisModule_GetThreadSafeContext(NULL);
+    RedisModule_ThreadSafeContextLock(rctx);
+    RedisSearchCtx *sctx = NewSearchCtx(rctx, (RedisModuleString *)gc->keyName, false);
+    if (sctx) {
+      if (sctx->spec->uniqueId == gc->specUniqueId) {
+        IndexSnapshot_ScheduleRefresh(sctx->spec);
+      }
+      SearchCtx_Free(sctx);
+    }
+    RedisModule_ThreadSafeContextUnlock(rctx);
+    RedisModule_FreeThreadSafeContext(rctx);
+  }
+
   gc->stats.numCycles++;
   gc->stats.totalMSRun += msRun;
   gc->stats.lastRunTimeMs = msRun;
+  gc->stats.lastCycleCollected = gc->stats.totalCollected - totalCollectedBefore;
+  int bucket = msRun < 1 ? 0 : msRun < 10 ? 1 : msRun < 100 ? 2 : msRun < 1000 ? 3 : 4;
+  gc->stats.cycleMsHist[bucket]++;
+
+  // adapt the cycle interval to observed churn: idle cycles back off, productive ones reset
+  if (gc->stats.lastCycleCollected == 0) {
+    uint32_t next = (gc->idleBackoff ? gc->idleBackoff : 1) * 2;
+    gc->idleBackoff = next > FORKGC_MAX_IDLE_BACKOFF ? FORKGC_MAX_IDLE_BACKOFF : next;
+  } else {
+    gc->idleBackoff = 1;
+  }
 
   return ret_val;
 }
@@ -680,6 +1027,9 @@ void ForkGc_OnTerm(void *privdata) {
   RedisModule_FreeString(ctx, (RedisModuleString *)gc->keyName);
   RedisModule_ThreadSafeContextUnlock(ctx);
   RedisModule_FreeThreadSafeContext(ctx);
+  rm_free(gc->termCursor);
+  free(gc->pipeWriteBuf);
+  free(gc->pipeReadBuf);
   free(gc);
 }
 
@@ -701,6 +1051,15 @@ void ForkGc_RenderStats(RedisModuleCtx *ctx, void *gcCtx) {
     REPLY_KVNUM(n, "last_run_time_ms", (double)gc->stats.lastRunTimeMs);
     REPLY_KVNUM(n, "gc_numeric_trees_missed", (double)gc->stats.gcNumericNodesMissed);
     REPLY_KVNUM(n, "gc_blocks_denied", (double)gc->stats.gcBlocksDenied);
+    REPLY_KVNUM(n, "total_blocks_repaired", (double)gc->stats.totalBlocksRepaired);
+    REPLY_KVNUM(n, "total_docs_collected", (double)gc->stats.totalDocsCollected);
+    REPLY_KVNUM(n, "last_cycle_bytes_collected", (double)gc->stats.lastCycleCollected);
+    REPLY_KVNUM(n, "cycles_under_1ms", (double)gc->stats.cycleMsHist[0]);
+    REPLY_KVNUM(n, "cycles_under_10ms", (double)gc->stats.cycleMsHist[1]);
+    REPLY_KVNUM(n, "cycles_under_100ms", (double)gc->stats.cycleMsHist[2]);
+    REPLY_KVNUM(n, "cycles_under_1s", (double)gc->stats.cycleMsHist[3]);
+    REPLY_KVNUM(n, "cycles_over_1s", (double)gc->stats.cycleMsHist[4]);
+    REPLY_KVNUM(n, "current_idle_backoff", (double)gc->idleBackoff);
   }
   RedisModule_ReplySetArrayLength(ctx, n);
 }
@@ -709,8 +1068,10 @@ void ForkGc_OnDelete(void *ctx) {
 }
 
 struct timespec ForkGc_GetInterval(void *ctx) {
+  ForkGCCtx *gc = ctx;
   struct timespec interval;
-  interval.tv_sec = RSGlobalConfig.forkGcRunIntervalSec;
+  uint32_t backoff = gc && gc->idleBackoff ? gc->idleBackoff : 1;
+  interval.tv_sec = RSGlobalConfig.forkGcRunIntervalSec * backoff;
   interval.tv_nsec = 0;
   return interval;
 }
@@ -723,7 +1084,10 @@ ForkGCCtx *NewForkGC(const RedisModuleString *k, uint64_t specUniqueId, GCCallba
       .stats = {},
       .rdbPossiblyLoading = 1,
       .specUniqueId = specUniqueId,
+      .idleBackoff = 1,
   };
+  forkGc->pipeWriteBuf = malloc(GC_PIPE_BUFSZ);
+  forkGc->pipeReadBuf = malloc(GC_PIPE_BUFSZ);
 
   callbacks->onDelete = ForkGc_OnDelete;
   callbacks->onTerm = ForkGc_OnTerm;
@@ -3,6 +3,7 @@
 #define SRC_FORK_GC_H_
 
 #include "redismodule.h"
+#include "redisearch.h"
 #include "gc.h"
 
 typedef struct {
@@ -16,6 +17,14 @@ typedef struct {
 
   uint64_t gcNumericNodesMissed;
   uint64_t gcBlocksDenied;
+
+  // cumulative repair counters
+  uint64_t totalBlocksRepaired;
+  uint64_t totalDocsCollected;
+  // bytes collected by the most recent cycle
+  size_t lastCycleCollected;
+  // histogram of cycle durations: <1ms, <10ms, <100ms, <1s, >=1s
+  uint64_t cycleMsHist[5];
 } ForkGCStats;
 
 /* Internal definition of the garbage collector context (each index has one) */
@@ -34,6 +43,31 @@ typedef struct ForkGCCtx {
 
   int pipefd[2];
 
+  /* Per-cycle pipe buffering (see the buffered I/O helpers in fork_gc.c).
+   * The buffers live on the context, not at file scope: each spec's GC runs
+   * on its own timer thread, and concurrent cycles must not share stream
+   * state. Allocated once with the context */
+  char *pipeWriteBuf;
+  size_t pipeWriteLen;
+  char *pipeReadBuf;
+  size_t pipeReadLen, pipeReadPos;
+
+  /* Resume point of the incremental term scan (see FORK_GC_TERM_BUDGET): the last term the
+   * previous cycle processed, or NULL to start from the beginning. Owned by the context */
+  char *termCursor;
+  size_t termCursorLen;
+
+  /* Child-only: liveness snapshot of the doc table, built by one batched
+   * cursor pass at the start of a collection cycle. The posting scans test a
+   * bit per entry instead of taking a shard lock and walking a bucket chain */
+  uint8_t *liveDocs;
+  t_docId liveEpoch;
+
+  /* Write-rate feedback: cycles that reclaim nothing double the effective interval (up to
+   * 16x base), and any reclaiming cycle snaps it back - read-mostly indexes idle while
+   * churny ones are collected at full rate */
+  uint32_t idleBackoff;
+
 } ForkGCCtx;
 
 ForkGCCtx* NewForkGC(const RedisModuleString *k, uint64_t specUniqueId, GCCallbacks* callbacks);
@@ -33,7 +33,7 @@ static uint32_t khtHash(const KHTableEntry *entBase) {
 
 static KHTableEntry *allocBucketEntry(void *ptr) {
   BlkAlloc *alloc = ptr;
-  void *p = BlkAlloc_Alloc(alloc, sizeof(khIdxEntry), ENTRIES_PER_BLOCK * sizeof(khIdxEntry));
+  void *p = BlkAlloc_AllocFixed(alloc, sizeof(khIdxEntry), ENTRIES_PER_BLOCK * sizeof(khIdxEntry));
   return p;
 }
 
@@ -157,7 +157,7 @@ static khIdxEntry *makeEntry(ForwardIndex *idx, const char *s, size_t n, uint32_
 
 static void ForwardIndex_HandleToken(ForwardIndex *idx, const char *tok, size_t tokLen,
                                      uint32_t pos, float fieldScore, t_fieldId fieldId, int isStem,
-                                     int shouldCopy, bool addToTermsTrie) {
+                                     int shouldCopy, bool addToTermsTrie, int noOffsets) {
   // LG_DEBUG("token %.*s, hval %d\n", t.len, t.s, hval);
   ForwardIndexEntry *h = NULL;
   int isNew = 0;
@@ -203,7 +203,7 @@ static void ForwardIndex_HandleToken(ForwardIndex *idx, const char *tok, size_t
   h->freq += MAX(1, (uint32_t)score);
   idx->maxFreq = MAX(h->freq, idx->maxFreq);
   idx->totalFreq += h->freq;
-  if (h->vw) {
+  if (h->vw && !noOffsets) {
     VVW_Write(h->vw, pos);
   }
 
@@ -218,7 +218,7 @@ int forwardIndexTokenFunc(void *ctx, const Token *tokInfo) {
   const ForwardIndexTokenizerCtx *tokCtx = ctx;
   ForwardIndex_HandleToken(tokCtx->idx, tokInfo->tok, tokInfo->tokLen, tokInfo->pos,
                            tokCtx->fieldScore, tokCtx->fieldId, 0, tokInfo->flags & Token_CopyRaw,
-                           true);
+                           true, tokCtx->noOffsets);
 
   if (tokCtx->allOffsets) {
     VVW_Write(tokCtx->allOffsets, tokInfo->raw - tokCtx->doc);
@@ -227,7 +227,7 @@ int forwardIndexTokenFunc(void *ctx, const Token *tokInfo) {
   if (tokInfo->stem) {
     ForwardIndex_HandleToken(tokCtx->idx, tokInfo->stem, tokInfo->stemLen, tokInfo->pos,
                              tokCtx->fieldScore, tokCtx->fieldId, 1,
-                             tokInfo->flags & Token_CopyStem, true);
+                             tokInfo->flags & Token_CopyStem, true, tokCtx->noOffsets);
   }
 
   if (tokCtx->idx->smap) {
@@ -238,7 +238,8 @@ int forwardIndexTokenFunc(void *ctx, const Token *tokInfo) {
       for (int i = 0; i < array_len(t_data->ids); ++i) {
         synonym_len = SynonymMap_IdToStr(t_data->ids[i], synonym_buff, SYNONYM_BUFF_LEN);
         ForwardIndex_HandleToken(tokCtx->idx, synonym_buff, synonym_len, tokInfo->pos,
-                                 tokCtx->fieldScore, tokCtx->fieldId, 0, 1, true);
+                                 tokCtx->fieldScore, tokCtx->fieldId, 0, 1, true,
+                                 tokCtx->noOffsets);
       }
     }
   }
@@ -246,7 +247,7 @@ int forwardIndexTokenFunc(void *ctx, const Token *tokInfo) {
   if (tokInfo->phoneticsPrimary) {
     ForwardIndex_HandleToken(tokCtx->idx, tokInfo->phoneticsPrimary,
                              strlen(tokInfo->phoneticsPrimary), tokInfo->pos, tokCtx->fieldScore,
-                             tokCtx->fieldId, 0, 0, true);
+                             tokCtx->fieldId, 0, 0, true, tokCtx->noOffsets);
   }
 
   return 0;
@@ -46,16 +46,19 @@ typedef struct {
   ForwardIndex *idx;
   t_fieldId fieldId;
   float fieldScore;
+  // Field is FieldSpec_NoOffsets: its tokens contribute no term offsets
+  int noOffsets;
 } ForwardIndexTokenizerCtx;
 
 static inline void ForwardIndexTokenizerCtx_Init(ForwardIndexTokenizerCtx *ctx, ForwardIndex *idx,
                                                  const char *doc, VarintVectorWriter *vvw,
-                                                 t_fieldId fieldId, float score) {
+                                                 t_fieldId fieldId, float score, int noOffsets) {
   ctx->idx = idx;
   ctx->fieldId = fieldId;
   ctx->fieldScore = score;
   ctx->doc = doc;
   ctx->allOffsets = vvw;
+  ctx->noOffsets = noOffsets;
 }
 
 typedef struct {
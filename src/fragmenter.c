@@ -236,29 +236,32 @@ char *FragmentList_HighlightWholeDocS(const FragmentList *fragList, const Highli
   return docBuf;
 }
 
-static int fragSortCmp(const void *pa, const void *pb) {
-  const Fragment *a = *(const Fragment **)pa, *b = *(const Fragment **)pb;
-  if (a->score == b->score) {
-    return a - b;
-  }
-  return a->score > b->score ? -1 : 1;
-}
-
-static void FragmentList_Sort(FragmentList *fragList) {
-  if (fragList->sortedFrags) {
+/* Select the n best-scored fragments in one pass, without sorting the whole
+ * list. A running, score-ordered window of the best seen so far lets every
+ * fragment that cannot beat the current n-th best be dismissed with a single
+ * compare - on a huge document with thousands of candidate fragments only a
+ * handful ever get inserted. Equal scores keep the earlier fragment, as the
+ * full sort did */
+static void FragmentList_SelectBest(FragmentList *fragList, const Fragment **out, size_t n) {
+  if (n == 0) {
     return;
   }
-
-  const Fragment *origFrags = FragmentList_GetFragments(fragList);
-  fragList->sortedFrags = malloc(sizeof(*fragList->sortedFrags) * fragList->numFrags);
-
-  for (size_t ii = 0; ii < fragList->numFrags; ++ii) {
-    fragList->sortedFrags[ii] = origFrags + ii;
-  }
-
-  qsort(fragList->sortedFrags, fragList->numFrags, sizeof(fragList->sortedFrags[0]), fragSortCmp);
+  const Fragment *frags = FragmentList_GetFragments(fragList);
+  size_t filled = 0;
   for (size_t ii = 0; ii < fragList->numFrags; ++ii) {
-    ((Fragment *)fragList->sortedFrags[ii])->scoreRank = ii;
+    const Fragment *f = frags + ii;
+    if (filled == n && out[n - 1]->score >= f->score) {
+      continue;
+    }
+    size_t at = filled < n ? filled : n - 1;
+    while (at > 0 && out[at - 1]->score < f->score) {
+      out[at] = out[at - 1];
+      at--;
+    }
+    out[at] = f;
+    if (filled < n) {
+      filled++;
+    }
   }
 }
 
@@ -357,10 +360,7 @@ void FragmentList_HighlightFragments(FragmentList *fragList, const HighlightTags
       indexes[ii] = frags + ii;
     }
   } else if (order & HIGHLIGHT_ORDER_SCORE) {
-    FragmentList_Sort(fragList);
-    for (size_t ii = 0; ii < niovs; ++ii) {
-      indexes[ii] = fragList->sortedFrags[ii];
-    }
+    FragmentList_SelectBest(fragList, indexes, niovs);
     if (order & HIGHLIGHT_ORDER_POS) {
       qsort(indexes, niovs, sizeof indexes[0], sortByOrder);
     }
@@ -399,7 +399,6 @@ void FragmentList_Free(FragmentList *fragList) {
     Array_Free(&frags[ii].termLocs);
   }
   Array_Free(&fragList->frags);
-  free(fragList->sortedFrags);
   free(fragList->scratchFrags);
 }
 
@@ -422,10 +421,7 @@ void FragmentList_FragmentizeIter(FragmentList *fragList, const char *doc, size_
   size_t lastByteEnd = 0;
 
   while (FragmentTermIterator_Next(iter, &curTerm)) {
-    if (curTerm == NULL) {
-      fragList->numToksSinceLastMatch++;
-      continue;
-    }
+    fragList->numToksSinceLastMatch += iter->numGapToks;
 
     if (curTerm->tokPos == lastTokPos) {
       continue;
@@ -458,6 +454,7 @@ void FragmentTermIterator_InitOffsets(FragmentTermIterator *iter, RSByteOffsetIt
                                       RSOffsetIterator *offIter) {
   iter->offsetIter = offIter;
   iter->byteIter = byteOffsets;
+  iter->numGapToks = 0;
   iter->curByteOffset = RSByteOffsetIterator_Next(iter->byteIter);
 
   // Advance the offset iterator to the first offset we care about (i.e. that
@@ -474,11 +471,16 @@ int FragmentTermIterator_Next(FragmentTermIterator *iter, FragmentTerm **termInf
   }
 
   if (iter->byteIter->curPos < iter->curTokPos) {
-    iter->curByteOffset = RSByteOffsetIterator_Next(iter->byteIter);
-    // No matching term at this position.
-    // printf("IterPos=%lu. LastMatchPos=%u\n", iter->byteIter->curPos, iter->curTokPos);
-    *termInfo = NULL;
-    return 1;
+    // Skip the byte iterator straight to the next match rather than stepping
+    // through every intermediate token; only the gap size is kept so the
+    // fragmenter's token distance accounting stays intact.
+    iter->numGapToks = iter->curTokPos - iter->byteIter->curPos;
+    iter->curByteOffset = RSByteOffsetIterator_SkipTo(iter->byteIter, iter->curTokPos);
+    if (iter->curByteOffset == RSBYTEOFFSET_EOF) {
+      return 0;
+    }
+  } else {
+    iter->numGapToks = 0;
   }
 
   // printf("ByteOffset=%lu. LastMatchPos=%u\n", iter->curByteOffset, iter->curTokPos);
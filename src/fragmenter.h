@@ -55,6 +55,10 @@ typedef struct {
   RSQueryTerm *curMatchRec;
   uint32_t curTokPos;
   uint32_t curByteOffset;
+  // How many non-matching tokens were skipped over to reach the term most
+  // recently returned by Next(). The fragmenter folds this into its token
+  // distance accounting instead of visiting each gap token individually.
+  uint32_t numGapToks;
   FragmentTerm tmpTerm;
 } FragmentTermIterator;
 
@@ -101,9 +105,6 @@ typedef struct {
   // Array of fragments
   Array frags;
 
-  // Array of indexes (in frags), sorted by score
-  const Fragment **sortedFrags;
-
   // Scratch space, used internally
   const Fragment **scratchFrags;
 
@@ -130,7 +131,6 @@ static inline void FragmentList_Init(FragmentList *fragList, uint16_t maxDistanc
   fragList->numFrags = 0;
   fragList->maxDistance = maxDistance;
   fragList->estAvgWordSize = estWordSize;
-  fragList->sortedFrags = NULL;
   fragList->scratchFrags = NULL;
   Array_Init(&fragList->frags);
 }
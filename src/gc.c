@@ -1,6 +1,8 @@
 #include "gc.h"
 #include "fork_gc.h"
 #include "default_gc.h"
+#include "tiering.h"
+#include "search_ctx.h"
 #include "config.h"
 #include "redismodule.h"
 #include "rmalloc.h"
@@ -48,6 +50,7 @@ static RedisModuleBlockedClient* BlockClients_pop(BlockClients* ctx){
 GCContext* GCContext_CreateGC(RedisModuleString *keyName, float initialHZ, uint64_t uniqueId){
   GCContext* ret = rm_calloc(1, sizeof(GCContext));
   pthread_mutex_init(&ret->bClients.lock, NULL);
+  ret->keyName = keyName;
   switch (RSGlobalConfig.gcPolicy) {
     case GCPolicy_Fork:
       ret->gcCtx = (void*)NewForkGC(keyName, uniqueId, &ret->callbacks);
@@ -64,6 +67,18 @@ static int GCContext_PeriodicCallback(RedisModuleCtx *ctx, void *privdata) {
   GCContext* gc = privdata;
   int ret = gc->callbacks.periodicCallback(ctx, gc->gcCtx);
 
+  // Piggyback the cold-block tiering sweep on the GC cadence: one bounded,
+  // cursor-resumed batch per cycle, under a short exclusive slice
+  if (RSGlobalConfig.coldBlockMinutes > 0) {
+    RedisModule_ThreadSafeContextLock(ctx);
+    RedisSearchCtx *sctx = NewSearchCtx(ctx, gc->keyName, false);
+    if (sctx) {
+      IndexTiering_Sweep(sctx->spec, &gc->tieringCursor);
+      SearchCtx_Free(sctx);
+    }
+    RedisModule_ThreadSafeContextUnlock(ctx);
+  }
+
   RedisModuleBlockedClient* bClient = BlockClients_pop(&gc->bClients);
   if(bClient){
     RedisModule_UnblockClient(bClient, NULL);
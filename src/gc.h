@@ -29,6 +29,9 @@ typedef struct GCContext{
   struct RMUtilTimer *timer;
   BlockClients bClients;
   GCCallbacks callbacks;
+  // For the cold-block tiering sweep piggybacked on the GC timer
+  RedisModuleString *keyName;
+  unsigned long tieringCursor;
 }GCContext;
 
 GCContext* GCContext_CreateGC(RedisModuleString *keyName, float initialHZ, uint64_t uniqueId);
@@ -2,6 +2,8 @@
 #include "geo_index.h"
 #include "rmutil/util.h"
 #include "rmalloc.h"
+#include <math.h>
+#include <string.h>
 
 /* Add a docId to a geoindex key. Right now we just use redis' own GEOADD */
 int GeoIndex_AddStrings(GeoIndex *gi, t_docId docId, char *slon, char *slat) {
@@ -84,6 +86,198 @@ void GeoFilter_Free(GeoFilter *gf) {
   free(gf);
 }
 
+/******************************************************************************
+ * Native geo cell querying.
+ *
+ * GEOADD stores members scored by their 52-bit interleaved geohash, so a
+ * radius query does not need the GEORADIUS round trip: we compute the center
+ * cell and its eight neighbors at a precision fitted to the radius - exactly
+ * like redis core does internally - and walk the zset score range of each
+ * cell through the module API, refining candidates by haversine distance.
+ * This skips building and parsing a full RESP reply of every candidate.
+ ******************************************************************************/
+
+#define GEO_LAT_MIN (-85.05112878)
+#define GEO_LAT_MAX (85.05112878)
+#define GEO_LON_MIN (-180.0)
+#define GEO_LON_MAX (180.0)
+#define GEO_STEP_MAX 26
+#define GEO_EARTH_RADIUS_M 6372797.560856
+
+/* Spread the lower 32 bits of x to the even bit positions */
+static uint64_t geoInterleave64(uint32_t xlo, uint32_t ylo) {
+  static const uint64_t B[] = {0x5555555555555555ULL, 0x3333333333333333ULL,
+                               0x0F0F0F0F0F0F0F0FULL, 0x00FF00FF00FF00FFULL,
+                               0x0000FFFF0000FFFFULL};
+  static const unsigned S[] = {1, 2, 4, 8, 16};
+  uint64_t x = xlo, y = ylo;
+  x = (x | (x << S[4])) & B[4];
+  x = (x | (x << S[3])) & B[3];
+  x = (x | (x << S[2])) & B[2];
+  x = (x | (x << S[1])) & B[1];
+  x = (x | (x << S[0])) & B[0];
+  y = (y | (y << S[4])) & B[4];
+  y = (y | (y << S[3])) & B[3];
+  y = (y | (y << S[2])) & B[2];
+  y = (y | (y << S[1])) & B[1];
+  y = (y | (y << S[0])) & B[0];
+  return x | (y << 1);
+}
+
+/* Redis-compatible 52 bit geohash: latitude in the even bits, longitude in the odd bits, both
+ * scaled to 26 bit cell indexes */
+static uint64_t geoEncode(double lon, double lat) {
+  double latOff = (lat - GEO_LAT_MIN) / (GEO_LAT_MAX - GEO_LAT_MIN);
+  double lonOff = (lon - GEO_LON_MIN) / (GEO_LON_MAX - GEO_LON_MIN);
+  uint32_t ilat = (uint32_t)(latOff * (1ULL << GEO_STEP_MAX));
+  uint32_t ilon = (uint32_t)(lonOff * (1ULL << GEO_STEP_MAX));
+  return geoInterleave64(ilat, ilon);
+}
+
+static void geoDecode(uint64_t bits, double *lon, double *lat) {
+  uint32_t ilat = 0, ilon = 0;
+  for (int i = 0; i < GEO_STEP_MAX; i++) {
+    ilat |= (uint32_t)((bits >> (2 * i)) & 1) << i;
+    ilon |= (uint32_t)((bits >> (2 * i + 1)) & 1) << i;
+  }
+  double scale = (double)(1ULL << GEO_STEP_MAX);
+  // cell center
+  *lat = GEO_LAT_MIN + (ilat + 0.5) / scale * (GEO_LAT_MAX - GEO_LAT_MIN);
+  *lon = GEO_LON_MIN + (ilon + 0.5) / scale * (GEO_LON_MAX - GEO_LON_MIN);
+}
+
+static double geoHaversine(double lon1d, double lat1d, double lon2d, double lat2d) {
+  double lat1 = lat1d * M_PI / 180.0, lat2 = lat2d * M_PI / 180.0;
+  double u = sin((lat2 - lat1) / 2), v = sin((lon2d - lon1d) * M_PI / 360.0);
+  return 2.0 * GEO_EARTH_RADIUS_M * asin(sqrt(u * u + cos(lat1) * cos(lat2) * v * v));
+}
+
+static double geoExtentUnitToMeters(const char *unit) {
+  if (!unit || !strcasecmp(unit, "m")) return 1.0;
+  if (!strcasecmp(unit, "km")) return 1000.0;
+  if (!strcasecmp(unit, "ft")) return 0.3048;
+  if (!strcasecmp(unit, "mi")) return 1609.34;
+  return 1.0;
+}
+
+/* Pick the deepest cell precision at which a 3x3 cell block around the center is guaranteed
+ * to cover the circle's bounding box. Derived from the box extent in degrees rather than
+ * redis core's doubling heuristic, which under-sizes longitude cells at high latitudes */
+static int geoStepsByRadius(double radiusMeters, double lat) {
+  if (radiusMeters <= 0) return GEO_STEP_MAX;
+  double dLatDeg = radiusMeters / 110574.0;
+  double worstLat = fabs(lat) + dLatDeg;
+  if (worstLat > 85) worstLat = 85;
+  double dLonDeg = radiusMeters / (111320.0 * cos(worstLat * M_PI / 180.0));
+
+  int step = GEO_STEP_MAX;
+  while (step > 1 &&
+         ((GEO_LAT_MAX - GEO_LAT_MIN) / (double)(1ULL << step) < dLatDeg ||
+          (GEO_LON_MAX - GEO_LON_MIN) / (double)(1ULL << step) < dLonDeg)) {
+    step--;
+  }
+  return step;
+}
+
+typedef struct {
+  double min;
+  double max;
+} GeoHashRange;
+
+/* Compute the score ranges of the center cell and its 8 neighbors at a radius-fitted
+ * precision. Returns the number of (deduplicated) ranges written to `ranges[9]` */
+static int geoGetCoveringRanges(const GeoFilter *gf, GeoHashRange *ranges) {
+  double radiusM = gf->radius * geoExtentUnitToMeters(gf->unit);
+  int step = geoStepsByRadius(radiusM, gf->lat);
+  double scale = (double)(1ULL << step);
+
+  int64_t ilat = (int64_t)((gf->lat - GEO_LAT_MIN) / (GEO_LAT_MAX - GEO_LAT_MIN) * scale);
+  int64_t ilon = (int64_t)((gf->lon - GEO_LON_MIN) / (GEO_LON_MAX - GEO_LON_MIN) * scale);
+  int shift = 2 * (GEO_STEP_MAX - step);
+
+  int n = 0;
+  for (int dlat = -1; dlat <= 1; dlat++) {
+    for (int dlon = -1; dlon <= 1; dlon++) {
+      int64_t clat = ilat + dlat;
+      int64_t clon = ilon + dlon;
+      if (clat < 0 || clat >= (int64_t)scale) {
+        continue;  // no latitude wrap
+      }
+      // longitude wraps around
+      if (clon < 0) clon += (int64_t)scale;
+      if (clon >= (int64_t)scale) clon -= (int64_t)scale;
+
+      uint64_t cell = geoInterleave64((uint32_t)clat, (uint32_t)clon);
+      double lo = (double)(cell << shift);
+      double hi = (double)((cell + 1) << shift);
+      int dup = 0;
+      for (int i = 0; i < n; i++) {
+        if (ranges[i].min == lo) {
+          dup = 1;
+          break;
+        }
+      }
+      if (!dup) {
+        ranges[n++] = (GeoHashRange){.min = lo, .max = hi};
+      }
+    }
+  }
+  return n;
+}
+
+/* Walk the zset score ranges of the covering cells through the module API, refining each
+ * candidate by real distance. Returns a docId array like geoRangeLoad. Falls back to NULL
+ * (caller uses GEORADIUS) when the key cannot be opened as a zset */
+static t_docId *geoRangeLoadNative(const GeoIndex *gi, const GeoFilter *gf, size_t *num) {
+  *num = 0;
+  RedisModuleString *ks = IndexSpec_GetFormattedKey(gi->ctx->spec, gi->sp);
+  RedisModuleCtx *ctx = gi->ctx->redisCtx;
+  RedisModuleKey *key = RedisModule_OpenKey(ctx, ks, REDISMODULE_READ);
+  if (!key || RedisModule_KeyType(key) != REDISMODULE_KEYTYPE_ZSET) {
+    if (key) RedisModule_CloseKey(key);
+    return NULL;
+  }
+
+  GeoHashRange ranges[9];
+  int nranges = geoGetCoveringRanges(gf, ranges);
+  double radiusM = gf->radius * geoExtentUnitToMeters(gf->unit);
+
+  size_t cap = 64;
+  t_docId *docIds = rm_malloc(cap * sizeof(*docIds));
+
+  for (int i = 0; i < nranges; i++) {
+    if (RedisModule_ZsetFirstInScoreRange(key, ranges[i].min, ranges[i].max, 0, 1) !=
+        REDISMODULE_OK) {
+      continue;
+    }
+    while (!RedisModule_ZsetRangeEndReached(key)) {
+      double score;
+      RedisModuleString *member = RedisModule_ZsetRangeCurrentElement(key, &score);
+      if (member) {
+        double mlon, mlat;
+        geoDecode((uint64_t)score, &mlon, &mlat);
+        if (geoHaversine(gf->lon, gf->lat, mlon, mlat) <= radiusM) {
+          if (*num == cap) {
+            cap *= 2;
+            docIds = rm_realloc(docIds, cap * sizeof(*docIds));
+          }
+          long long did;
+          if (RedisModule_StringToLongLong(member, &did) == REDISMODULE_OK) {
+            docIds[(*num)++] = (t_docId)did;
+          }
+        }
+        RedisModule_FreeString(ctx, member);
+      }
+      if (!RedisModule_ZsetRangeNext(key)) {
+        break;
+      }
+    }
+    RedisModule_ZsetRangeStop(key);
+  }
+  RedisModule_CloseKey(key);
+  return docIds;
+}
+
 static int cmp_docids(const void *p1, const void *p2) {
   const t_docId *d1 = p1, *d2 = p2;
 
@@ -130,7 +324,12 @@ done:
 
 IndexIterator *NewGeoRangeIterator(GeoIndex *gi, const GeoFilter *gf, double weight) {
   size_t sz;
-  t_docId *docIds = geoRangeLoad(gi, gf, &sz);
+  // Prefer the in-module cell walk; fall back to the GEORADIUS round trip when the key
+  // cannot be accessed through the zset API
+  t_docId *docIds = geoRangeLoadNative(gi, gf, &sz);
+  if (!docIds) {
+    docIds = geoRangeLoad(gi, gf, &sz);
+  }
   if (!docIds) {
     return NULL;
   }
@@ -4,12 +4,31 @@
 #include "util/minmax.h"
 #include "toksep.h"
 #include <ctype.h>
+#include "inverted_index.h"
+#include "rmalloc.h"
 
 typedef struct {
   ResultProcessor base;
   int fragmentizeOptions;
   const FieldList *fields;
   const RLookup *lookup;
+  // set once the scan's offset-skipping decoders have been swapped back for
+  // the page's re-seeks
+  int offsetsRestored;
+  // Normalized per-field settings, merged with the defaults once on the first
+  // document and reused for every row; the merge is invariant across the query
+  ReturnedField *normFields;
+  // Resolved text field ids paired with normFields (-1 when the field is not
+  // a schema fulltext field), so rows don't repeat the schema hash lookup.
+  // Ids are copied rather than FieldSpec pointers: a schema alter may
+  // relocate the fields array between reader slices, but ids never change
+  int *normFieldIds;
+  ReturnedField defaultSpec;
+  int specsReady;
+  // iovec scratch shared across fields and documents instead of being
+  // reallocated per row
+  Array *iovsArr;
+  size_t iovsArrSize;
 } HlpProcessor;
 
 /**
@@ -24,6 +43,12 @@ typedef struct {
   // Index result, which contains the term offsets (word-wise)
   const RSIndexResult *indexResult;
 
+  // Offset iterator over the index result, opened lazily on the first
+  // fulltext field and rewound for each subsequent one so a multi-field
+  // summarize pays its setup once per document
+  RSOffsetIterator offsIter;
+  int offsIterValid;
+
   // Array used for in/out when writing fields. Optimization cache
   Array *iovsArr;
 
@@ -39,33 +64,33 @@ typedef struct {
  *
  * Returns true if the fragmentation succeeded, false otherwise.
  */
-static int fragmentizeOffsets(IndexSpec *spec, const char *fieldName, const char *fieldText,
-                              size_t fieldLen, const RSIndexResult *indexResult,
-                              const RSByteOffsets *byteOffsets, FragmentList *fragList,
-                              int options) {
-  const FieldSpec *fs = IndexSpec_GetField(spec, fieldName, strlen(fieldName));
-  if (!fs || fs->type != FIELD_FULLTEXT) {
-    return 0;
+static int fragmentizeOffsets(IndexSpec *spec, int fieldId, const char *fieldName,
+                              const char *fieldText, size_t fieldLen, hlpDocContext *docParams,
+                              FragmentList *fragList, int options) {
+  if (fieldId < 0) {
+    const FieldSpec *fs = IndexSpec_GetField(spec, fieldName, strlen(fieldName));
+    if (!fs || fs->type != FIELD_FULLTEXT) {
+      return 0;
+    }
+    fieldId = fs->textOpts.id;
+  }
+
+  if (!docParams->offsIterValid) {
+    docParams->offsIter = RSIndexResult_IterateOffsets(docParams->indexResult);
+    docParams->offsIterValid = 1;
+  } else {
+    docParams->offsIter.Rewind(docParams->offsIter.ctx);
   }
 
-  int rc = 0;
-  RSOffsetIterator offsIter = RSIndexResult_IterateOffsets(indexResult);
   FragmentTermIterator fragIter = {NULL};
   RSByteOffsetIterator bytesIter;
-  if (RSByteOffset_Iterate(byteOffsets, fs->textOpts.id, &bytesIter) != REDISMODULE_OK) {
-    goto done;
+  if (RSByteOffset_Iterate(docParams->byteOffsets, fieldId, &bytesIter) != REDISMODULE_OK) {
+    return 0;
   }
 
-  FragmentTermIterator_InitOffsets(&fragIter, &bytesIter, &offsIter);
+  FragmentTermIterator_InitOffsets(&fragIter, &bytesIter, &docParams->offsIter);
   FragmentList_FragmentizeIter(fragList, fieldText, fieldLen, &fragIter, options);
-  if (fragList->numFrags == 0) {
-    goto done;
-  }
-  rc = 1;
-
-done:
-  offsIter.Free(offsIter.ctx);
-  return rc;
+  return fragList->numFrags != 0;
 }
 
 // Strip spaces from a buffer in place. Returns the new length of the text,
@@ -160,10 +185,12 @@ static char *trimField(const ReturnedField *fieldInfo, const char *docStr, size_
   return ret;
 }
 
-static RSValue *summarizeField(IndexSpec *spec, const ReturnedField *fieldInfo,
+static RSValue *summarizeField(IndexSpec *spec, int fieldId, const ReturnedField *fieldInfo,
                                const char *fieldName, const RSValue *returnedField,
                                hlpDocContext *docParams, int options) {
 
+  RM_ALLOC_TAG_SCOPE(RM_TAG_FRAGMENTER);
+
   FragmentList frags;
   FragmentList_Init(&frags, 8, 6);
 
@@ -175,8 +202,8 @@ static RSValue *summarizeField(IndexSpec *spec, const ReturnedField *fieldInfo,
   size_t docLen;
   const char *docStr = RSValue_StringPtrLen(returnedField, &docLen);
   if (docParams->byteOffsets == NULL ||
-      !fragmentizeOffsets(spec, fieldName, docStr, docLen, docParams->indexResult,
-                          docParams->byteOffsets, &frags, options)) {
+      !fragmentizeOffsets(spec, fieldId, fieldName, docStr, docLen, docParams, &frags,
+                          options)) {
     if (fieldInfo->mode == SummarizeMode_Synopsis) {
       // If summarizing is requested then trim the field so that the user isn't
       // spammed with a large blob of text
@@ -251,20 +278,37 @@ static void resetIovsArr(Array **iovsArrp, size_t *curSize, size_t newSize) {
   *curSize = newSize;
 }
 
-static void processField(HlpProcessor *hlpCtx, hlpDocContext *docParams, ReturnedField *spec) {
+static void processField(HlpProcessor *hlpCtx, hlpDocContext *docParams, ReturnedField *spec,
+                         int fieldId) {
   const char *fName = spec->name;
   const RSValue *fieldValue = RLookup_GetItem(spec->lookupKey, docParams->row);
 
   if (fieldValue == NULL || !RSValue_IsString(fieldValue)) {
     return;
   }
-  RSValue *v = summarizeField(RP_SPEC(&hlpCtx->base), spec, fName, fieldValue, docParams,
+  RSValue *v = summarizeField(RP_SPEC(&hlpCtx->base), fieldId, spec, fName, fieldValue, docParams,
                               hlpCtx->fragmentizeOptions);
   if (v) {
     RLookup_WriteKey(spec->lookupKey, docParams->row, v);
   }
 }
 
+/* One-time reverse of the scan's offset skipping: the page's re-seeks need
+ * the term offsets the bulk scan deliberately did not decode. Every term
+ * reader is registered on the concurrent context, which is how we reach them */
+static void restoreOffsetVectors(ResultProcessor *rp) {
+  ConcurrentSearchCtx *conc = rp->parent->conc;
+  if (!conc) {
+    return;
+  }
+  for (uint32_t i = 0; i < conc->numOpenKeys; i++) {
+    ConcurrentKeyCtx *kc = &conc->openKeys[i];
+    if (kc->cb == IndexReader_OnReopen || kc->cb == IndexReader_OnReopenSpec) {
+      IndexReader_SetKeepOffsetVectors(kc->privdata);
+    }
+  }
+}
+
 static const RSIndexResult *getIndexResult(ResultProcessor *rp, t_docId docId) {
   IndexIterator *it = QITR_GetRootFilter(rp->parent);
   RSIndexResult *ir = NULL;
@@ -288,6 +332,11 @@ static int hlpNext(ResultProcessor *rbase, SearchResult *r) {
 
   // Get the index result for the current document from the root iterator.
   // The current result should not contain an index result
+  HlpProcessor *hl = (HlpProcessor *)rbase;
+  if (!hl->offsetsRestored) {
+    restoreOffsetVectors(rbase);
+    hl->offsetsRestored = 1;
+  }
   const RSIndexResult *ir = r->indexResult ? r->indexResult : getIndexResult(rbase, r->docId);
 
   // we can't work withot the inex result, just return QUEUED
@@ -295,13 +344,30 @@ static int hlpNext(ResultProcessor *rbase, SearchResult *r) {
     return RS_RESULT_OK;
   }
 
-  size_t numIovsArr = 0;
   const FieldList *fields = hlp->fields;
   RSDocumentMetadata *dmd = r->dmd;
   if (!dmd) {
     return RS_RESULT_OK;
   }
 
+  // Merge each requested field with the defaults once; the result is the same
+  // for every document in the query
+  if (!hlp->specsReady) {
+    if (fields->numFields) {
+      hlp->normFields = calloc(fields->numFields, sizeof(*hlp->normFields));
+      hlp->normFieldIds = calloc(fields->numFields, sizeof(*hlp->normFieldIds));
+      for (size_t ii = 0; ii < fields->numFields; ++ii) {
+        normalizeSettings(fields->fields + ii, &fields->defaultField, hlp->normFields + ii);
+        const char *name = hlp->normFields[ii].name;
+        const FieldSpec *fs = IndexSpec_GetField(RP_SPEC(&hlp->base), name, strlen(name));
+        hlp->normFieldIds[ii] = fs && fs->type == FIELD_FULLTEXT ? (int)fs->textOpts.id : -1;
+      }
+    } else {
+      normalizeSettings(NULL, &fields->defaultField, &hlp->defaultSpec);
+    }
+    hlp->specsReady = 1;
+  }
+
   hlpDocContext docParams = {.byteOffsets = dmd->byteOffsets,  // nl
                              .iovsArr = NULL,
                              .indexResult = ir,
@@ -314,32 +380,38 @@ static int hlpNext(ResultProcessor *rbase, SearchResult *r) {
         // Ignore - this is a field for `RETURN`, not `SUMMARIZE`
         continue;
       }
-      ReturnedField combinedSpec = {0};
-      normalizeSettings(ff, &fields->defaultField, &combinedSpec);
-      resetIovsArr(&docParams.iovsArr, &numIovsArr, combinedSpec.summarizeSettings.numFrags);
-      processField(hlp, &docParams, &combinedSpec);
+      ReturnedField *combinedSpec = hlp->normFields + ii;
+      resetIovsArr(&hlp->iovsArr, &hlp->iovsArrSize, combinedSpec->summarizeSettings.numFrags);
+      docParams.iovsArr = hlp->iovsArr;
+      processField(hlp, &docParams, combinedSpec, hlp->normFieldIds[ii]);
     }
   } else if (fields->defaultField.mode != SummarizeMode_None) {
     for (const RLookupKey *k = hlp->lookup->head; k; k = k->next) {
       if (k->flags & RLOOKUP_F_HIDDEN) {
         continue;
       }
-      ReturnedField spec = {0};
-      normalizeSettings(NULL, &fields->defaultField, &spec);
+      ReturnedField spec = hlp->defaultSpec;
       spec.lookupKey = k;
       spec.name = k->name;
-      resetIovsArr(&docParams.iovsArr, &numIovsArr, spec.summarizeSettings.numFrags);
-      processField(hlp, &docParams, &spec);
+      resetIovsArr(&hlp->iovsArr, &hlp->iovsArrSize, spec.summarizeSettings.numFrags);
+      docParams.iovsArr = hlp->iovsArr;
+      processField(hlp, &docParams, &spec, -1);
     }
   }
-  for (size_t ii = 0; ii < numIovsArr; ++ii) {
-    Array_Free(&docParams.iovsArr[ii]);
+  if (docParams.offsIterValid) {
+    docParams.offsIter.Free(docParams.offsIter.ctx);
   }
-  free(docParams.iovsArr);
   return RS_RESULT_OK;
 }
 
 static void hlpFree(ResultProcessor *p) {
+  HlpProcessor *hlp = (HlpProcessor *)p;
+  for (size_t ii = 0; ii < hlp->iovsArrSize; ++ii) {
+    Array_Free(&hlp->iovsArr[ii]);
+  }
+  free(hlp->iovsArr);
+  free(hlp->normFields);
+  free(hlp->normFieldIds);
   free(p);
 }
 
@@ -189,5 +189,8 @@ IndexIterator *NewIdListIterator(t_docId *ids, t_offset num, double weight) {
 
   ret->HasNext = NULL;
   ret->GetCurrent = NULL;
+  ret->SetMaxScoreThresholdRef = NULL;
+  ret->GetMaxScoreBound = NULL;
+  ret->ReadBatch = NULL;
   return ret;
 }
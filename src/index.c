@@ -1,5 +1,6 @@
 #include "forward_index.h"
 #include "index.h"
+#include "concurrent_ctx.h"
 #include "varint.h"
 #include "spec.h"
 #include <math.h>
@@ -9,6 +10,7 @@
 #include <stdlib.h>
 #include <sys/param.h>
 #include "rmalloc.h"
+#include "util/heap.h"
 
 static int UI_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit);
 static int UI_Next(void *ctx);
@@ -17,6 +19,8 @@ static int UI_ReadSorted(void *ctx, RSIndexResult **hit);
 static size_t UI_NumEstimated(void *ctx);
 static IndexCriteriaTester *UI_GetCriteriaTester(void *ctx);
 static size_t UI_Len(void *ctx);
+static void UI_SetMaxScoreThresholdRef(void *ctx, const double *ref);
+static int UI_ReadSortedHeap(void *ctx, RSIndexResult **hit);
 
 static int II_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit);
 static int II_Next(void *ctx);
@@ -26,6 +30,8 @@ static int II_ReadSorted(void *ctx, RSIndexResult **hit);
 static size_t II_NumEstimated(void *ctx);
 static size_t II_Len(void *ctx);
 static t_docId II_LastDocId(void *ctx);
+struct IntersectIterator;
+static void II_SortChildren(struct IntersectIterator *ic);
 
 #define CURRENT_RECORD(ii) (ii)->base.current
 
@@ -50,8 +56,30 @@ typedef struct {
   size_t nexpected;
   double weight;
   uint64_t len;
+
+  // WAND: reference to the query's evolving minimum top-k score (NULL when not scoring)
+  const double *maxScoreThresholdRef;
+
+  /* For wide unions a min-heap of the active children (keyed by their current docId) replaces
+   * the linear minimum scan, making each advance O(log n) instead of O(n). The heap is built
+   * lazily and marked dirty whenever something moves children under our feet (SkipTo, Rewind) */
+  heap_t *heap;
+  int heapDirty;
+  /* Children aggregated into the last returned result. They are advanced lazily, at the start
+   * of the next read, so the result's child records stay valid until then (the same contract
+   * the linear scan provides) */
+  IndexIterator **heapPending;
+  unsigned numPending;
 } UnionIterator;
 
+// Linear scanning beats the heap bookkeeping for small unions
+#define UNION_HEAP_MIN_CHILDREN 16
+
+static int UI_HeapCmp(const void *a, const void *b, const void *udata) {
+  t_docId ida = ((const IndexIterator *)a)->minId, idb = ((const IndexIterator *)b)->minId;
+  return ida < idb ? 1 : ida > idb ? -1 : 0;
+}
+
 static inline t_docId UI_LastDocId(void *ctx) {
   return ((UnionIterator *)ctx)->minDocId;
 }
@@ -62,6 +90,7 @@ static void UI_SyncIterList(UnionIterator *ui) {
   for (size_t ii = 0; ii < ui->num; ++ii) {
     ui->its[ii]->minId = 0;
   }
+  ui->heapDirty = 1;
 }
 
 /**
@@ -136,6 +165,9 @@ IndexIterator *NewUnionIterator(IndexIterator **its, int num, DocTable *dt, int
   it->Len = UI_Len;
   it->Abort = UI_Abort;
   it->Rewind = UI_Rewind;
+  it->SetMaxScoreThresholdRef = UI_SetMaxScoreThresholdRef;
+  it->GetMaxScoreBound = NULL;
+  it->ReadBatch = NULL;  // aggregate results carry child pointers; not batchable
   UI_SyncIterList(ctx);
 
   for (size_t i = 0; i < num; ++i) {
@@ -146,6 +178,16 @@ IndexIterator *NewUnionIterator(IndexIterator **its, int num, DocTable *dt, int
     }
   }
 
+  // Wide unions pay O(n) per advance in the linear scan; switch to the heap-based read.
+  // WAND pruning (enabled later via SetMaxScoreThresholdRef) sticks with the linear read,
+  // since its pivot step reorders children every advance anyway
+  if (it->mode == MODE_SORTED && ctx->num >= UNION_HEAP_MIN_CHILDREN) {
+    ctx->heap = heap_new(UI_HeapCmp, NULL);
+    ctx->heapPending = calloc(ctx->norig, sizeof(*ctx->heapPending));
+    ctx->heapDirty = 1;
+    it->Read = UI_ReadSortedHeap;
+  }
+
   const size_t maxresultsSorted = 1000;
   if (it->mode == MODE_SORTED && ctx->nexpected >= maxresultsSorted) {
     // make sure all the children support CriteriaTester
@@ -210,6 +252,83 @@ static size_t UI_NumEstimated(void *ctx) {
   return ui->nexpected;
 }
 
+static void UI_SetMaxScoreThresholdRef(void *ctx, const double *ref) {
+  UnionIterator *ui = ctx;
+  if (ui->base.mode == MODE_SORTED) {
+    ui->maxScoreThresholdRef = ref;
+    if (ui->base.Read == UI_ReadSortedHeap) {
+      // The WAND pivot wants the linear read, which re-derives the minimum each advance
+      ui->base.Read = UI_ReadSorted;
+    }
+  }
+}
+
+/* WAND pivot step. Walk the active children in ascending docId order, accumulating their
+ * score upper bounds; the first child at which the sum reaches the heap threshold is the
+ * pivot, and no document before the pivot's docId can enter the top-k heap. Children behind
+ * the pivot are skipped directly to it. Returns 0 if the whole union is exhausted (no pivot
+ * exists), 1 otherwise. A child with no known bound disables pruning for the call */
+static int UI_WandPivot(UnionIterator *ui) {
+  double threshold = *ui->maxScoreThresholdRef;
+  if (threshold <= 0 || ui->num == 0) {
+    return 1;
+  }
+
+#define WAND_MAX_CHILDREN 64
+  if (ui->num > WAND_MAX_CHILDREN) {
+    return 1;
+  }
+  IndexIterator *order[WAND_MAX_CHILDREN];
+  for (unsigned i = 0; i < ui->num; i++) {
+    IndexIterator *it = ui->its[i];
+    if (!it->GetMaxScoreBound || it->GetMaxScoreBound(it->ctx) == 0) {
+      return 1;  // unbounded child - cannot prune
+    }
+    // insertion sort by the child's current docId
+    unsigned j = i;
+    while (j && order[j - 1]->minId > it->minId) {
+      order[j] = order[j - 1];
+      --j;
+    }
+    order[j] = it;
+  }
+
+  double acc = 0;
+  IndexIterator *pivot = NULL;
+  for (unsigned i = 0; i < ui->num; i++) {
+    // The union's own weight multiplies the summed contributions at scoring time
+    acc += order[i]->GetMaxScoreBound(order[i]->ctx) * ui->weight;
+    if (acc >= threshold) {
+      pivot = order[i];
+      break;
+    }
+  }
+  if (!pivot) {
+    // Even all children together cannot reach the heap minimum - we are done
+    return 0;
+  }
+
+  t_docId pivotId = pivot->minId;
+  // Skip every child lagging behind the pivot directly to it: the docs in between are
+  // guaranteed to score below the threshold
+  for (unsigned i = 0; i < ui->num; i++) {
+    IndexIterator *it = ui->its[i];
+    if (it->minId >= pivotId || !it->minId) {
+      continue;
+    }
+    RSIndexResult *res = NULL;
+    int rc = it->SkipTo(it->ctx, pivotId, &res);
+    if (rc == INDEXREAD_EOF) {
+      i = UI_RemoveExhausted(ui, i);
+      continue;
+    }
+    if (res) {
+      it->minId = res->docId;
+    }
+  }
+  return 1;
+}
+
 static inline int UI_ReadUnsorted(void *ctx, RSIndexResult **hit) {
   UnionIterator *ui = ctx;
   int rc = INDEXREAD_OK;
@@ -238,6 +357,10 @@ static inline int UI_ReadSorted(void *ctx, RSIndexResult **hit) {
 
   do {
 
+    if (ui->maxScoreThresholdRef && !UI_WandPivot(ui)) {
+      break;
+    }
+
     // find the minimal iterator
     t_docId minDocId = UINT32_MAX;
     IndexIterator *minIt = NULL;
@@ -290,6 +413,75 @@ static inline int UI_ReadSorted(void *ctx, RSIndexResult **hit) {
   return INDEXREAD_EOF;
 }
 
+/* Heap-based variant of UI_ReadSorted for wide unions. The heap holds every active child
+ * keyed by its current docId; an advance polls the minimum, aggregates all children sitting
+ * on the same id, reads each one forward and re-offers it */
+static int UI_ReadSortedHeap(void *ctx, RSIndexResult **hit) {
+  UnionIterator *ui = ctx;
+  if (!IITER_HAS_NEXT(&ui->base)) {
+    return INDEXREAD_EOF;
+  }
+
+  if (!ui->heapDirty) {
+    // Advance the children we handed out last time and re-offer the live ones
+    for (unsigned i = 0; i < ui->numPending; i++) {
+      IndexIterator *it = ui->heapPending[i];
+      RSIndexResult *res = NULL;
+      if (it->Read(it->ctx, &res) != INDEXREAD_EOF) {
+        if (res) {
+          it->minId = res->docId;
+        }
+        heap_offer(&ui->heap, it);
+      }
+    }
+  }
+  ui->numPending = 0;
+
+  if (ui->heapDirty) {
+    // (Re)build the heap from the active list: read children which are still behind the
+    // last returned id and offer everything that is not exhausted
+    heap_clear(ui->heap);
+    for (unsigned i = 0; i < ui->num; i++) {
+      IndexIterator *it = ui->its[i];
+      int rc = INDEXREAD_OK;
+      RSIndexResult *res = NULL;
+      while (it->minId <= ui->minDocId && rc != INDEXREAD_EOF) {
+        rc = it->Read(it->ctx, &res);
+        if (res) {
+          it->minId = res->docId;
+        }
+      }
+      if (rc != INDEXREAD_EOF) {
+        heap_offer(&ui->heap, it);
+      } else {
+        i = UI_RemoveExhausted(ui, i);
+      }
+    }
+    ui->heapDirty = 0;
+  }
+
+  if (!heap_count(ui->heap)) {
+    IITER_SET_EOF(&ui->base);
+    return INDEXREAD_EOF;
+  }
+
+  AggregateResult_Reset(CURRENT_RECORD(ui));
+  CURRENT_RECORD(ui)->weight = ui->weight;
+
+  IndexIterator *it = heap_poll(ui->heap);
+  t_docId id = it->minId;
+  do {
+    AggregateResult_AddChild(CURRENT_RECORD(ui), IITER_CURRENT_RECORD(it));
+    ui->heapPending[ui->numPending++] = it;
+    it = heap_peek(ui->heap);
+  } while (it && it->minId == id && (it = heap_poll(ui->heap)));
+
+  ui->minDocId = id;
+  ui->len++;
+  *hit = CURRENT_RECORD(ui);
+  return INDEXREAD_OK;
+}
+
 /**
 Skip to the given docId, or one place after it
 @param ctx IndexReader context
@@ -302,6 +494,8 @@ at EOF
 static int UI_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
   UnionIterator *ui = ctx;
   assert(ui->base.mode == MODE_SORTED);
+  // The scan below moves children around; a heap-backed union must rebuild before its next read
+  ui->heapDirty = 1;
 
   // printf("UI %p skipto %d\n", ui, docId);
 
@@ -405,6 +599,10 @@ void UnionIterator_Free(IndexIterator *itbase) {
   }
 
   IndexResult_Free(CURRENT_RECORD(ui));
+  if (ui->heap) {
+    heap_free(ui->heap);
+    free(ui->heapPending);
+  }
   free(ui->its);
   free(ui->origits);
   free(ui);
@@ -416,7 +614,7 @@ static size_t UI_Len(void *ctx) {
 
 /* The context used by the intersection methods during iterating an intersect
  * iterator */
-typedef struct {
+typedef struct IntersectIterator {
   IndexIterator base;
   IndexIterator **its;
   IndexIterator *bestIt;
@@ -437,6 +635,12 @@ typedef struct {
   t_fieldMask fieldMask;
   double weight;
   size_t nexpected;
+
+  /* In-situ storage for `its` and `testers`: most intersections have 2-4
+   * children, so building and freeing them touches no allocator unless a
+   * wide query spills past the inline capacity */
+  ARRAY_INLINE_STORAGE(IndexIterator *, 4) itsStorage;
+  ARRAY_INLINE_STORAGE(IndexCriteriaTester *, 4) testersStorage;
 } IntersectIterator;
 
 void IntersectIterator_Free(IndexIterator *it) {
@@ -488,11 +692,11 @@ IndexIterator *NewIntersecIterator(IndexIterator **its, int num, DocTable *dt,
 #define INITIAL_LEN 10
   // printf("Creating new intersection iterator with fieldMask=%llx\n", fieldMask);
   IntersectIterator *ctx = calloc(1, sizeof(*ctx));
-  ctx->its = array_new(IndexIterator *, INITIAL_LEN);
-  ctx->testers = array_new(IndexCriteriaTester *, INITIAL_LEN);
+  ctx->its = array_new_inline(IndexIterator *, ctx->itsStorage);
+  ctx->testers = array_new_inline(IndexCriteriaTester *, ctx->testersStorage);
   ctx->bestIt = NULL;
-  IndexIterator **unsortedIts = array_new(IndexIterator *, INITIAL_LEN);
-  ;
+  ARRAY_INLINE_STORAGE(IndexIterator *, INITIAL_LEN) unsortedStorage;
+  IndexIterator **unsortedIts = array_new_inline(IndexIterator *, unsortedStorage);
   ctx->num = 0;
   ctx->lastDocId = 0;
   ctx->lastFoundId = 0;
@@ -547,6 +751,12 @@ IndexIterator *NewIntersecIterator(IndexIterator **its, int num, DocTable *dt,
     }
   }
 
+  // Drive the intersection from the smallest child: estimated-cardinality order saves query
+  // authors from having to hand-order their clauses. Phrase queries must keep query order
+  if (maxSlop < 0 && !inOrder && ctx->num > 1) {
+    II_SortChildren(ctx);
+  }
+
   if (array_len(ctx->its) == 0) {
     for (size_t i = 0; i < array_len(unsortedIts); ++i) {
       if (unsortedIts[i] != ctx->bestIt) {
@@ -564,10 +774,42 @@ IndexIterator *NewIntersecIterator(IndexIterator **its, int num, DocTable *dt,
       unsortedIts[i]->Free(unsortedIts[i]);
     }
   }
+  array_free(unsortedIts);  // no-op unless the list spilled past the inline capacity
 
   return it;
 }
 
+/* Order the intersection's children by how many results they are expected to yield, cheapest
+ * first, so the rarest term drives the leapfrog and the common ones gallop. Reordering changes
+ * the order in which children are aggregated into the result, so it is only legal for pure
+ * intersections - phrase matching (slop/inorder) depends on query order. The estimate
+ * subtracts what a child already produced, letting periodic re-sorts adapt as iterators
+ * drain */
+static int II_cmpEstimated(const void *a, const void *b) {
+  const IndexIterator *ia = *(IndexIterator *const *)a, *ib = *(IndexIterator *const *)b;
+  size_t ea = ia->NumEstimated((void *)ia->ctx), eb = ib->NumEstimated((void *)ib->ctx);
+  size_t la = ia->Len((void *)ia->ctx), lb = ib->Len((void *)ib->ctx);
+  ea = ea > la ? ea - la : 0;
+  eb = eb > lb ? eb - lb : 0;
+  return ea < eb ? -1 : ea > eb ? 1 : 0;
+}
+
+static void II_SortChildren(IntersectIterator *ic) {
+  for (int i = 0; i < ic->num; i++) {
+    if (!ic->its[i]) {
+      return;  // null children are positional sentinels; leave everything in place
+    }
+  }
+  qsort(ic->its, ic->num, sizeof(*ic->its), II_cmpEstimated);
+  // The per-child docId cache must follow its child
+  for (int i = 0; i < ic->num; i++) {
+    ic->docIds[i] = ic->its[i]->LastDocId(ic->its[i]->ctx);
+  }
+}
+
+// Re-evaluate the drive order every so many results
+#define II_RESORT_INTERVAL 1024
+
 static int II_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
   /* A seek with docId 0 is equivalent to a read */
   if (docId == 0) {
@@ -590,6 +832,19 @@ static int II_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
     // only read if we are not already at the seek to position
     if (ic->docIds[i] != docId) {
       rc = it->SkipTo(it->ctx, docId, &res);
+      // A seeker may report NOTFOUND while still short of the target when it exhausts a block;
+      // keep galloping instead of falling back to one-id stepping
+      while (rc == INDEXREAD_NOTFOUND && res && res->docId < docId) {
+        if (RS_AccountCost(1)) {
+          ic->base.isValid = 0;
+          return INDEXREAD_EOF;
+        }
+        t_docId prev = res->docId;
+        rc = it->SkipTo(it->ctx, docId, &res);
+        if (res && res->docId == prev) {
+          break;
+        }
+      }
       if (rc != INDEXREAD_EOF) {
         if (res) ic->docIds[i] = res->docId;
       }
@@ -711,6 +966,11 @@ static int II_ReadSorted(void *ctx, RSIndexResult **hit) {
   int i = 0;
 
   do {
+    // One candidate round per unit: adversarial intersections spin here for
+    // a long time without ever surfacing a result
+    if (RS_AccountCost(1)) {
+      goto eof;
+    }
 
     nh = 0;
     AggregateResult_Reset(ic->base.current);
@@ -729,6 +989,14 @@ static int II_ReadSorted(void *ctx, RSIndexResult **hit) {
           rc = it->Read(it->ctx, &h);
         } else {
           rc = it->SkipTo(it->ctx, ic->lastDocId, &h);
+          // Re-seek through block-boundary NOTFOUNDs which land short of the target
+          while (rc == INDEXREAD_NOTFOUND && h && h->docId < ic->lastDocId) {
+            t_docId prev = h->docId;
+            rc = it->SkipTo(it->ctx, ic->lastDocId, &h);
+            if (h && h->docId == prev) {
+              break;
+            }
+          }
         }
         // printf("II %p last docId %d, it %d read docId %d(%d), rc %d\n", ic, ic->lastDocId, i,
         //        h->docId, it->LastDocId(it->ctx), rc);
@@ -783,6 +1051,10 @@ static int II_ReadSorted(void *ctx, RSIndexResult **hit) {
       //      }
 
       ic->len++;
+      if (ic->maxSlop < 0 && !ic->inOrder && (ic->len & (II_RESORT_INTERVAL - 1)) == 0) {
+        // Adapt the drive order as children drain
+        II_SortChildren(ic);
+      }
       // printf("Returning OK\n");
       return INDEXREAD_OK;
     }
@@ -811,8 +1083,62 @@ typedef struct {
   t_docId maxDocId;
   size_t len;
   double weight;
+
+  /* For small exclusion sets the child is drained once into this bitmap (bit set = excluded),
+   * turning every SkipTo into a bit test instead of stepping the child id by id. Built lazily
+   * on first use; NULL when the child is too large for the bitmap treatment */
+  uint8_t *excluded;
 } NotIterator, NotContext;
 
+/* Bitmap mode applies when the whole docId space fits a modest allocation */
+#define NOT_BITMAP_MAX_DOCID (1 << 24)
+
+#define NOT_BITMAP_TEST(nc, id) ((nc)->excluded[(id) >> 3] & (1 << ((id)&7)))
+
+static void NI_EnsureBitmap(NotContext *nc) {
+  if (nc->excluded) {
+    return;
+  }
+  nc->excluded = calloc((nc->maxDocId >> 3) + 1, 1);
+  RSIndexResult *res = NULL;
+  while (nc->child->Read(nc->child->ctx, &res) != INDEXREAD_EOF) {
+    if (res->docId <= nc->maxDocId) {
+      nc->excluded[res->docId >> 3] |= 1 << (res->docId & 7);
+    }
+  }
+}
+
+/* Read for bitmap mode: emit consecutive ids whose bit is clear */
+static int NI_ReadBitmap(void *ctx, RSIndexResult **hit) {
+  NotContext *nc = ctx;
+  NI_EnsureBitmap(nc);
+  t_docId id = nc->lastDocId + 1;
+  while (id <= nc->maxDocId && NOT_BITMAP_TEST(nc, id)) {
+    ++id;
+  }
+  if (id > nc->maxDocId) {
+    return INDEXREAD_EOF;
+  }
+  nc->lastDocId = nc->base.current->docId = id;
+  if (hit) {
+    *hit = nc->base.current;
+  }
+  ++nc->len;
+  return INDEXREAD_OK;
+}
+
+/* SkipTo for bitmap mode: one bit test decides between an anti-match and a hit */
+static int NI_SkipToBitmap(void *ctx, t_docId docId, RSIndexResult **hit) {
+  NotContext *nc = ctx;
+  if (docId > nc->maxDocId) {
+    return INDEXREAD_EOF;
+  }
+  NI_EnsureBitmap(nc);
+  nc->lastDocId = nc->base.current->docId = docId;
+  *hit = nc->base.current;
+  return NOT_BITMAP_TEST(nc, docId) ? INDEXREAD_NOTFOUND : INDEXREAD_OK;
+}
+
 static void NI_Abort(void *ctx) {
   NotContext *nc = ctx;
   if (nc->child) {
@@ -824,13 +1150,15 @@ static void NI_Rewind(void *ctx) {
   NotContext *nc = ctx;
   nc->lastDocId = 0;
   nc->base.current->docId = 0;
-  if (nc->child) {
+  // the exclusion bitmap stays valid across rewinds - the child was fully drained to build it
+  if (nc->child && !nc->excluded) {
     nc->child->Rewind(nc->child->ctx);
   }
 }
 static void NI_Free(IndexIterator *it) {
 
   NotContext *nc = it->ctx;
+  free(nc->excluded);
   if (nc->child) {
     nc->child->Free(nc->child);
   }
@@ -959,6 +1287,9 @@ static int NI_ReadSorted(void *ctx, RSIndexResult **hit) {
   }
 
   while (cr->docId == nc->base.current->docId) {
+    if (RS_AccountCost(1)) {
+      return INDEXREAD_EOF;
+    }
     // advance our docId to the next possible id
     nc->base.current->docId++;
 
@@ -982,6 +1313,22 @@ ok:
   return INDEXREAD_OK;
 }
 
+/* Batched read for the NOT iterator: results are plain virtual records (docId only), so a
+ * batch is just the next run of ids absent from the child */
+static size_t NI_ReadBatch(void *ctx, RSIndexResult *results, size_t limit) {
+  NotContext *nc = ctx;
+  size_t n = 0;
+  RSIndexResult *hit;
+  while (n < limit) {
+    int rc = nc->base.Read(ctx, &hit);
+    if (rc != INDEXREAD_OK) {
+      break;
+    }
+    results[n++] = *hit;
+  }
+  return n;
+}
+
 /* We always have next, in case anyone asks... ;) */
 static int NI_HasNext(void *ctx) {
   NotContext *nc = ctx;
@@ -1028,12 +1375,21 @@ IndexIterator *NewNotIterator(IndexIterator *it, t_docId maxDocId, double weight
   ret->SkipTo = NI_SkipTo;
   ret->Abort = NI_Abort;
   ret->Rewind = NI_Rewind;
+  ret->SetMaxScoreThresholdRef = NULL;
+  ret->GetMaxScoreBound = NULL;
+  ret->ReadBatch = NI_ReadBatch;
   ret->GetCurrent = NULL;
   ret->mode = MODE_SORTED;
 
+  nc->excluded = NULL;
   if (nc->child && nc->child->mode == MODE_UNSORTED) {
     nc->childCT = nc->child->GetCriteriaTester(nc->child->ctx);
     ret->Read = NI_ReadUnsorted;
+  } else if (nc->child && maxDocId && maxDocId <= NOT_BITMAP_MAX_DOCID) {
+    // Small exclusion set over a bounded id space: answer negation with a bit test. The
+    // bitmap is built lazily on the first read/seek
+    ret->Read = NI_ReadBitmap;
+    ret->SkipTo = NI_SkipToBitmap;
   }
 
   return ret;
@@ -1081,6 +1437,10 @@ static int OI_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
     *hit = nc->base.current = res;
     return INDEXREAD_OK;
   }
+  // if the child is already past the requested id, this is a miss - no need to disturb it
+  if (res->docId > docId) {
+    goto ok;
+  }
   // read the next entry from the child
   int rc = nc->child->SkipTo(nc->child->ctx, docId, &nc->base.current);
 
@@ -1141,7 +1501,9 @@ static int OI_ReadSorted(void *ctx, RSIndexResult **hit) {
   if (nc->lastDocId >= nc->maxDocId) return INDEXREAD_EOF;
   nc->lastDocId++;
   if (!nc->child->current || nc->lastDocId > nc->child->current->docId) {
-    nc->child->Read(nc->child->ctx, &nc->base.current);
+    // seek rather than step: when the required side jumps ahead the child may be far behind,
+    // and probing it anywhere but at the current candidate is wasted decode work
+    nc->child->SkipTo(nc->child->ctx, nc->lastDocId, &nc->base.current);
   }
   if (nc->lastDocId == nc->child->current->docId) {
     *hit = nc->child->current;
@@ -1213,6 +1575,10 @@ IndexIterator *NewOptionalIterator(IndexIterator *it, t_docId maxDocId, double w
   ret->SkipTo = OI_SkipTo;
   ret->Abort = OI_Abort;
   ret->Rewind = OI_Rewind;
+  ret->SetMaxScoreThresholdRef = NULL;
+  ret->GetMaxScoreBound = NULL;
+  ret->ReadBatch = NULL;  // may yield the child's own records
+
   ret->mode = MODE_SORTED;
 
   if (nc->child->mode == MODE_UNSORTED) {
@@ -1246,7 +1612,7 @@ static void WI_Free(IndexIterator *it) {
 /* Read reads the next consecutive id, unless we're at the end */
 static int WI_Read(void *ctx, RSIndexResult **hit) {
   WildcardIteratorCtx *nc = ctx;
-  if (nc->current > nc->topId) {
+  if (nc->current > nc->topId || RS_AccountCost(1)) {
     return INDEXREAD_EOF;
   }
   CURRENT_RECORD(nc)->docId = nc->current++;
@@ -1275,6 +1641,18 @@ static int WI_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
   return INDEXREAD_OK;
 }
 
+/* Batched read for the wildcard iterator: consecutive ids, one memset-like fill */
+static size_t WI_ReadBatch(void *ctx, RSIndexResult *results, size_t limit) {
+  WildcardIteratorCtx *nc = ctx;
+  size_t n = 0;
+  while (n < limit && nc->current <= nc->topId) {
+    results[n] = *CURRENT_RECORD(nc);
+    results[n].docId = nc->current++;
+    n++;
+  }
+  return n;
+}
+
 static void WI_Abort(void *ctx) {
   WildcardIteratorCtx *nc = ctx;
   nc->current = nc->topId + 1;
@@ -1325,6 +1703,9 @@ IndexIterator *NewWildcardIterator(t_docId maxId) {
   ret->SkipTo = WI_SkipTo;
   ret->Abort = WI_Abort;
   ret->Rewind = WI_Rewind;
+  ret->SetMaxScoreThresholdRef = NULL;
+  ret->GetMaxScoreBound = NULL;
+  ret->ReadBatch = WI_ReadBatch;
   ret->GetCurrent = NULL;
   return ret;
 }
@@ -67,6 +67,24 @@ typedef struct indexIterator {
 
   /* Rewinde the iterator to the beginning and reset its state */
   void (*Rewind)(void *ctx);
+
+  /* Optional (may be NULL). Hand the iterator a reference to the query's evolving minimum
+   * top-k score (the sorter heap's smallest entry), enabling WAND-style skipping of blocks
+   * and documents whose best possible score cannot enter the heap. Only iterators which can
+   * prune safely - term readers and the union - implement this */
+  void (*SetMaxScoreThresholdRef)(void *ctx, const double *ref);
+
+  /* Optional (may be NULL). Batched read: decode up to `limit` results into the caller's
+   * arena in one call, amortizing per-entry virtual dispatch through the pipeline. A short
+   * count means EOF. Results are shallow copies valid until the next call into the iterator;
+   * iterators whose results carry child pointers (aggregates) leave this NULL and are read
+   * one record at a time */
+  size_t (*ReadBatch)(void *ctx, RSIndexResult *results, size_t limit);
+
+  /* Optional (may be NULL). An upper bound on the score contribution of any single document
+   * yielded by this iterator, or 0 if no bound is known. Used by the WAND union to pick its
+   * pivot */
+  double (*GetMaxScoreBound)(void *ctx);
 } IndexIterator;
 
 // static inline int IITER_HAS_NEXT(IndexIterator *ii) {
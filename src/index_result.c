@@ -3,6 +3,7 @@
 #include "rmalloc.h"
 #include <math.h>
 #include <sys/param.h>
+#include <emmintrin.h>
 
 /* Allocate a new aggregate result of a given type with a given capacity*/
 RSIndexResult *__newAggregateResult(size_t cap, RSResultType t, double weight) {
@@ -15,6 +16,7 @@ RSIndexResult *__newAggregateResult(size_t cap, RSResultType t, double weight) {
       .fieldMask = 0,
       .isCopy = 0,
       .weight = weight,
+      .scoreCoeff = weight,
       .agg = (RSAggregateResult){.numChildren = 0,
                                  .childrenCap = cap,
                                  .typeMask = 0x0000,
@@ -42,6 +44,9 @@ RSIndexResult *NewTokenRecord(RSQueryTerm *term, double weight) {
                          .isCopy = 0,
                          .freq = 0,
                          .weight = weight,
+                         // refined once the reader computes the real idf; termless
+                         // records score 0, as the idf factor always made them
+                         .scoreCoeff = weight * (term ? term->idf : 0),
                          .term = (RSTermRecord){
                              .term = term,
                              .offsets = (RSOffsetVector){},
@@ -58,6 +63,7 @@ RSIndexResult *NewNumericResult() {
                          .fieldMask = RS_FIELDMASK_ALL,
                          .freq = 1,
                          .weight = 1,
+                         .scoreCoeff = 1,
 
                          .num = (RSNumericRecord){.value = 0}};
   return res;
@@ -72,6 +78,7 @@ RSIndexResult *NewVirtualResult(double weight) {
       .fieldMask = 0,
       .freq = 0,
       .weight = weight,
+      .scoreCoeff = weight,
 
       .isCopy = 0,
   };
@@ -225,6 +232,119 @@ inline int RSIndexResult_IsAggregate(const RSIndexResult *r) {
   return (r->type & RS_RESULT_AGGREGATE) != 0;
 }
 #define __absdelta(x, y) (x > y ? x - y : y - x)
+
+/* How many offsets per term we decode onto the stack for the array kernel.
+ * Terms appearing more often than this in one document take the iterator
+ * fallback */
+#define OFFSET_DECODE_CAP 256
+
+/* Decode a term's delta-varint offsets into absolute positions. Returns the
+ * count, or SIZE_MAX when the vector holds more than cap entries */
+static size_t offsetVector_DecodeAll(const RSOffsetVector *v, uint32_t *out, size_t cap) {
+  if (OffsetVector_IsPacked(v)) {
+    EFOffsetReader r;
+    if (!EFOffsetReader_Init(&r, v->data, v->len) || r.n > cap) {
+      return SIZE_MAX;
+    }
+    size_t n = 0;
+    uint32_t val;
+    while ((val = EFOffsetReader_Next(&r)) != RS_OFFSETVECTOR_EOF) {
+      out[n++] = val;
+    }
+    return n;
+  }
+  Buffer buf = {.data = v->data, .offset = v->len, .cap = v->len};
+  BufferReader br = NewBufferReader(&buf);
+  uint32_t last = 0;
+  size_t n = 0;
+  while (!BufferReader_AtEnd(&br)) {
+    if (n == cap) {
+      return SIZE_MAX;
+    }
+    last += ReadVarint(&br);
+    out[n++] = last;
+  }
+  return n;
+}
+
+/* Minimal |a_i - b_j| over two sorted offset arrays. The walk holds each a
+ * entry and advances through b four lanes at a time; a distance <= 1 is as
+ * good as proximity gets, so it exits early - the same cutoff the iterator
+ * walk always applied */
+static uint32_t minDeltaArrays(const uint32_t *a, size_t na, const uint32_t *b, size_t nb) {
+  uint32_t best = UINT32_MAX;
+  const __m128i bias = _mm_set1_epi32((int32_t)0x80000000);
+  size_t j = 0;
+  for (size_t i = 0; i < na; ++i) {
+    uint32_t ai = a[i];
+    // Vectorized advance: skip b entries strictly below ai, four at a time.
+    // SSE2 only has signed compares, so both sides are bias-flipped
+    __m128i va = _mm_xor_si128(_mm_set1_epi32((int32_t)ai), bias);
+    while (j + 4 <= nb) {
+      __m128i vb = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(b + j)), bias);
+      int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(vb, va)));
+      if (mask == 0xF) {
+        j += 4;
+        continue;
+      }
+      j += __builtin_ctz(~mask);  // lanes below ai are the contiguous low bits
+      break;
+    }
+    while (j < nb && b[j] < ai) {
+      ++j;
+    }
+    if (j < nb) {
+      uint32_t d = b[j] - ai;
+      if (d < best) best = d;
+    }
+    if (j > 0) {
+      uint32_t d = ai - b[j - 1];
+      if (d < best) best = d;
+    }
+    if (best <= 1) {
+      return best;
+    }
+  }
+  return best;
+}
+
+/* The original iterator-based merge: one varint decode per step. Kept for
+ * aggregate children and for offset lists too long for the stack arrays */
+static uint32_t minOffsetDeltaIters(RSIndexResult *r1, RSIndexResult *r2) {
+  RSOffsetIterator v1 = RSIndexResult_IterateOffsets(r1);
+  RSOffsetIterator v2 = RSIndexResult_IterateOffsets(r2);
+  uint32_t p1 = v1.Next(v1.ctx, NULL);
+  uint32_t p2 = v2.Next(v2.ctx, NULL);
+  uint32_t cd = __absdelta(p2, p1);
+  while (cd > 1 && p1 != RS_OFFSETVECTOR_EOF && p2 != RS_OFFSETVECTOR_EOF) {
+    cd = MIN(__absdelta(p2, p1), cd);
+    if (p2 > p1) {
+      p1 = v1.Next(v1.ctx, NULL);
+    } else {
+      p2 = v2.Next(v2.ctx, NULL);
+    }
+  }
+  v1.Free(v1.ctx);
+  v2.Free(v2.ctx);
+  return cd;
+}
+
+/* Min distance between one pair of children. Term pairs go through the batch
+ * decode + array kernel; anything else (nested aggregates, oversized lists)
+ * takes the iterator walk */
+static uint32_t minOffsetDeltaPair(RSIndexResult *r1, RSIndexResult *r2) {
+  if (r1->type == RSResultType_Term && r2->type == RSResultType_Term) {
+    uint32_t a[OFFSET_DECODE_CAP], b[OFFSET_DECODE_CAP];
+    size_t na = offsetVector_DecodeAll(&r1->term.offsets, a, OFFSET_DECODE_CAP);
+    size_t nb = offsetVector_DecodeAll(&r2->term.offsets, b, OFFSET_DECODE_CAP);
+    if (na != SIZE_MAX && nb != SIZE_MAX) {
+      // walk the sparser list, scan the denser one vectorized
+      return na <= nb ? minDeltaArrays(a, na, b, nb) : minDeltaArrays(b, nb, a, na);
+    }
+  }
+  return minOffsetDeltaIters(r1, r2);
+}
+
 /**
 Find the minimal distance between members of the vectos.
 e.g. if V1 is {2,4,8} and V2 is {0,5,12}, the distance is 1 - abs(4-5)
@@ -240,7 +360,6 @@ int IndexResult_MinOffsetDelta(RSIndexResult *r) {
   int dist = 0;
   int num = agg->numChildren;
 
-  RSOffsetIterator v1, v2;
   int i = 0;
   while (i < num) {
     // if either
@@ -249,7 +368,7 @@ int IndexResult_MinOffsetDelta(RSIndexResult *r) {
       continue;
     }
     if (i == num) break;
-    v1 = RSIndexResult_IterateOffsets(agg->children[i]);
+    RSIndexResult *c1 = agg->children[i];
     i++;
 
     while (i < num && !RSIndexResult_HasOffsets(agg->children[i])) {
@@ -257,27 +376,11 @@ int IndexResult_MinOffsetDelta(RSIndexResult *r) {
       continue;
     }
     if (i == num) {
-      v1.Free(v1.ctx);
       dist = dist ? dist : 100;
       break;
     }
-    v2 = RSIndexResult_IterateOffsets(agg->children[i]);
-
-    uint32_t p1 = v1.Next(v1.ctx, NULL);
-    uint32_t p2 = v2.Next(v2.ctx, NULL);
-    int cd = __absdelta(p2, p1);
-    while (cd > 1 && p1 != RS_OFFSETVECTOR_EOF && p2 != RS_OFFSETVECTOR_EOF) {
-      cd = MIN(__absdelta(p2, p1), cd);
-      if (p2 > p1) {
-        p1 = v1.Next(v1.ctx, NULL);
-      } else {
-        p2 = v2.Next(v2.ctx, NULL);
-      }
-    }
-
-    v1.Free(v1.ctx);
-    v2.Free(v2.ctx);
 
+    uint32_t cd = minOffsetDeltaPair(c1, agg->children[i]);
     dist += cd * cd;
   }
 
@@ -330,7 +433,11 @@ int __indexResult_withinRangeInOrder(RSOffsetIterator *iters, uint32_t *position
       uint32_t lastPos = i ? positions[i - 1] : 0;
       // printf("Before: i=%d, pos=%d, lastPos %d\n", i, pos, lastPos);
 
-      // read while we are not in order
+      // read while we are not in order. A skipping encoding jumps straight to
+      // the first position past the previous term's
+      if (iters[i].SkipTo && pos != RS_OFFSETVECTOR_EOF && pos < lastPos) {
+        pos = iters[i].SkipTo(iters[i].ctx, lastPos, NULL);
+      }
       while (pos != RS_OFFSETVECTOR_EOF && pos < lastPos) {
         pos = iters[i].Next(iters[i].ctx, NULL);
         // printf("Reading: i=%d, pos=%d, lastPos %d\n", i, pos, lastPos);
@@ -433,6 +540,116 @@ int __indexResult_withinRangeUnordered(RSOffsetIterator *iters, uint32_t *positi
  * maxSlop.
  * e.g. for an exact match, the slop allowed is 0.
  */
+/* Exact-phrase fast path: verify an in-order, zero-slop aggregate by ANDing
+ * shifted per-term position bitmasks. Only matches within a 128-position
+ * window of the first term's first occurrence fit - the common title shape -
+ * and anything inconclusive falls back to the iterator merge: longer fields,
+ * non-term children, or adjacent terms sharing a position (where the merge's
+ * span arithmetic is laxer than strict adjacency).
+ * Returns 1 or 0 when conclusive, -1 when the caller must run the merge */
+static int __indexResult_maskWithinRange(const RSAggregateResult *r) {
+  int num = r->numChildren;
+  uint64_t mlo[num], mhi[num];
+  int n = 0, overflow = 0;
+  uint32_t base = 0;
+
+  for (int i = 0; i < num; i++) {
+    const RSIndexResult *ch = r->children[i];
+    if (!RSIndexResult_HasOffsets((RSIndexResult *)ch)) {
+      continue;
+    }
+    if (ch->type != RSResultType_Term) {
+      return -1;
+    }
+    const RSOffsetVector *v = &ch->term.offsets;
+    uint64_t lo = 0, hi = 0;
+    int first = (n == 0);
+    if (OffsetVector_IsPacked(v)) {
+      EFOffsetReader rd;
+      if (!EFOffsetReader_Init(&rd, v->data, v->len)) {
+        return -1;
+      }
+      uint32_t pos;
+      while ((pos = EFOffsetReader_Next(&rd)) != RS_OFFSETVECTOR_EOF) {
+        if (first) {
+          base = pos;
+          first = 0;
+        }
+        if (pos < base) {
+          continue;
+        }
+        uint32_t bit = pos - base;
+        if (bit >= 128) {
+          overflow = 1;
+          break;
+        }
+        if (bit < 64) {
+          lo |= 1ull << bit;
+        } else {
+          hi |= 1ull << (bit - 64);
+        }
+      }
+    } else {
+      Buffer b = (Buffer){.data = v->data, .offset = v->len, .cap = v->len};
+      BufferReader br = NewBufferReader(&b);
+      uint32_t pos = 0;
+      while (!BufferReader_AtEnd(&br)) {
+        pos += ReadVarint(&br);
+        if (first) {
+          base = pos;
+          first = 0;
+        }
+        if (pos < base) {
+          continue;
+        }
+        uint32_t bit = pos - base;
+        if (bit >= 128) {
+          overflow = 1;
+          break;
+        }
+        if (bit < 64) {
+          lo |= 1ull << bit;
+        } else {
+          hi |= 1ull << (bit - 64);
+        }
+      }
+    }
+    mlo[n] = lo;
+    mhi[n] = hi;
+    n++;
+  }
+
+  if (n == 0) {
+    return 1;
+  }
+  if (n >= 64) {
+    return -1;
+  }
+
+  // Term j of the phrase must sit j positions after term 0; shifting each
+  // mask right by its ordinal aligns every candidate start position on the
+  // same bit
+  uint64_t alo = ~0ull, ahi = ~0ull;
+  for (int i = 0; i < n; i++) {
+    alo &= (mlo[i] >> i) | (i ? (mhi[i] << (64 - i)) : 0);
+    ahi &= mhi[i] >> i;
+  }
+  if (alo | ahi) {
+    return 1;
+  }
+  if (overflow) {
+    return -1;
+  }
+  // A miss is only conclusive if no adjacent terms share a position: equal
+  // positions let the merge's negative gaps offset later ones
+  for (int i = 1; i < n; i++) {
+    if ((mlo[i - 1] & mlo[i]) || (mhi[i - 1] & mhi[i])) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
 int IndexResult_IsWithinRange(RSIndexResult *ir, int maxSlop, int inOrder) {
 
   // check if calculation is even relevant here...
@@ -443,6 +660,13 @@ int IndexResult_IsWithinRange(RSIndexResult *ir, int maxSlop, int inOrder) {
   RSAggregateResult *r = &ir->agg;
   int num = r->numChildren;
 
+  if (maxSlop == 0 && inOrder) {
+    int rc = __indexResult_maskWithinRange(r);
+    if (rc != -1) {
+      return rc;
+    }
+  }
+
   // Fill a list of iterators and the last read positions
   RSOffsetIterator iters[num];
   uint32_t positions[num];
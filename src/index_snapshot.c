@@ -0,0 +1,753 @@
+#include "index_snapshot.h"
+#include "inverted_index.h"
+#include "buffer.h"
+#include "rmalloc.h"
+#include "dep/thpool/thpool.h"
+#include "search_ctx.h"
+#include <string.h>
+#include <unistd.h>
+#include <stdio.h>
+
+/* Blob layout (all integers little-endian, fixed width, written sequentially):
+ *
+ *   u32 magic 'RSIX' | u32 version | u32 nsections
+ *   nsections * { u32 kind | u64 offset | u64 len }   <- offsets from blob start
+ *   section payloads
+ *
+ * TERMS section payload:
+ *   u64 count
+ *   count * {
+ *     u32 keyLen | key bytes
+ *     u32 flags | u64 lastId | u32 numDocs | u32 maxFreq | u32 numBlocks
+ *     numBlocks * { u64 firstId | u64 lastId | u32 numDocs | u32 maxFreq |
+ *                   u64 fieldMaskUnion | u64 dataLen | data bytes }
+ *   }
+ *
+ * Unknown section kinds are skipped on load, so new sections extend the
+ * format without a version break */
+
+#define SNAP_MAGIC 0x58495352u  // 'RSIX'
+#define SNAP_VERSION 1
+#define SNAP_SECTION_TERMS 1
+#define SNAP_SECTION_HOTTERMS 2
+
+/* Dictionaries at least this large load lazily: entries stay cold record
+ * extents into the blob, hydrated on first open (hot terms in the background),
+ * so restart answers queries without building millions of index objects */
+#define SNAP_LAZY_MIN_INDEXES 4096
+
+// builder/hydrator thread (lazily created, never destroyed)
+static threadpool snapshotPool_g;
+
+static void snapWriteU32(BufferWriter *bw, uint32_t v) {
+  Buffer_Write(bw, &v, sizeof(v));
+}
+
+static void snapWriteU64(BufferWriter *bw, uint64_t v) {
+  Buffer_Write(bw, &v, sizeof(v));
+}
+
+/* Bounds-checked sequential reader over the blob */
+typedef struct {
+  const char *cur;
+  const char *end;
+  int err;
+} SnapReader;
+
+static int snapRead(SnapReader *r, void *dst, size_t n) {
+  if (r->err || (size_t)(r->end - r->cur) < n) {
+    r->err = 1;
+    return 0;
+  }
+  memcpy(dst, r->cur, n);
+  r->cur += n;
+  return 1;
+}
+
+static uint32_t snapReadU32(SnapReader *r) {
+  uint32_t v = 0;
+  snapRead(r, &v, sizeof(v));
+  return v;
+}
+
+static uint64_t snapReadU64(SnapReader *r) {
+  uint64_t v = 0;
+  snapRead(r, &v, sizeof(v));
+  return v;
+}
+
+/* Advance past `n` raw bytes, returning their start (NULL on truncation) */
+static const char *snapReadRaw(SnapReader *r, size_t n) {
+  if (r->err || (size_t)(r->end - r->cur) < n) {
+    r->err = 1;
+    return NULL;
+  }
+  const char *p = r->cur;
+  r->cur += n;
+  return p;
+}
+
+/* A snapshot-lazy term entry: the extent of its record within the spec's
+ * snapshot arena. Hydrated on first open */
+typedef struct {
+  const char *body;
+  const char *bodyEnd;
+} SnapColdExtent;
+
+static void snapColdDtor(void *p) {
+  rm_free(p);
+}
+
+/* ---- Hot-term tracking ----
+ *
+ * A tiny frequent-items sketch per spec: query-side term opens hash into a
+ * fixed table; a colliding newcomer decays the incumbent and takes the slot
+ * when it reaches zero (space-saving style). The table rides along in the
+ * snapshot so post-restart hydration warms what queries actually touch */
+
+#define HOTTERMS_CAP 128
+
+typedef struct {
+  char *term;
+  uint32_t len;
+  uint64_t hits;
+} HotTermSlot;
+
+typedef struct HotTerms {
+  HotTermSlot slots[HOTTERMS_CAP];
+} HotTerms;
+
+static uint32_t hotTermsSlot(const char *key, size_t len) {
+  uint32_t h = 5381;
+  for (size_t i = 0; i < len; i++) {
+    h = h * 33 + (uint8_t)key[i];
+  }
+  return h % HOTTERMS_CAP;
+}
+
+void HotTerms_Hit(IndexSpec *sp, const char *key, size_t len) {
+  if (!sp->hotTerms) {
+    sp->hotTerms = rm_calloc(1, sizeof(*sp->hotTerms));
+  }
+  HotTermSlot *slot = &sp->hotTerms->slots[hotTermsSlot(key, len)];
+  if (slot->term && slot->len == len && memcmp(slot->term, key, len) == 0) {
+    slot->hits++;
+    return;
+  }
+  if (!slot->term) {
+    slot->term = rm_strndup(key, len);
+    slot->len = len;
+    slot->hits = 1;
+    return;
+  }
+  if (--slot->hits == 0) {
+    rm_free(slot->term);
+    slot->term = rm_strndup(key, len);
+    slot->len = len;
+    slot->hits = 1;
+  }
+}
+
+void HotTerms_Free(struct HotTerms *ht) {
+  if (!ht) {
+    return;
+  }
+  for (uint32_t i = 0; i < HOTTERMS_CAP; i++) {
+    rm_free(ht->slots[i].term);
+  }
+  rm_free(ht);
+}
+
+/* HOTTERMS section payload: u32 count, then count * { u32 len | bytes | u64 hits } */
+static void snapWriteHotTerms(BufferWriter *bw, const HotTerms *ht) {
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < HOTTERMS_CAP; i++) {
+    if (ht->slots[i].term) {
+      count++;
+    }
+  }
+  snapWriteU32(bw, count);
+  for (uint32_t i = 0; i < HOTTERMS_CAP; i++) {
+    if (!ht->slots[i].term) {
+      continue;
+    }
+    snapWriteU32(bw, ht->slots[i].len);
+    Buffer_Write(bw, ht->slots[i].term, ht->slots[i].len);
+    snapWriteU64(bw, ht->slots[i].hits);
+  }
+}
+
+/* Serialize one term dictionary entry: the key, the index header and the raw
+ * block images */
+static void snapWriteTermIndex(BufferWriter *bw, const dictEntry *entry) {
+  size_t keyLen;
+  const char *key = RedisModule_StringPtrLen(dictGetKey(entry), &keyLen);
+  const KeysDictValue *kdv = dictGetVal(entry);
+
+  snapWriteU32(bw, keyLen);
+  Buffer_Write(bw, (void *)key, keyLen);
+  if (kdv->cold) {
+    // never hydrated since the last load: its record bytes are already in
+    // snapshot format, pass them through verbatim
+    const SnapColdExtent *ext = kdv->p;
+    Buffer_Write(bw, (void *)ext->body, ext->bodyEnd - ext->body);
+    return;
+  }
+  const InvertedIndex *idx = kdv->p;
+  snapWriteU32(bw, idx->flags);
+  snapWriteU64(bw, idx->lastId);
+  snapWriteU32(bw, idx->numDocs);
+  snapWriteU32(bw, idx->maxFreq);
+  uint32_t liveBlocks = 0;
+  for (uint32_t i = 0; i < idx->size; i++) {
+    if (idx->blocks[i].numDocs > 0) {
+      ++liveBlocks;
+    }
+  }
+  snapWriteU32(bw, liveBlocks);
+  for (uint32_t i = 0; i < idx->size; i++) {
+    IndexBlock *blk = (IndexBlock *)&idx->blocks[i];
+    if (blk->numDocs == 0) {
+      continue;
+    }
+    // the snapshot stores raw images; a tier-compressed block inflates first
+    IndexBlock_EnsureDecompressed(blk);
+    snapWriteU64(bw, blk->firstId);
+    snapWriteU64(bw, blk->lastId);
+    snapWriteU32(bw, blk->numDocs);
+    snapWriteU32(bw, blk->maxFreq);
+    snapWriteU64(bw, blk->fieldMaskUnion);
+    snapWriteU64(bw, IndexBlock_DataLen(blk));
+    if (IndexBlock_DataLen(blk)) {
+      Buffer_Write(bw, IndexBlock_DataBuf(blk), IndexBlock_DataLen(blk));
+    }
+  }
+}
+
+/* Fill a section-table entry's offset and length in place */
+static void snapPatchSection(Buffer *b, size_t tableAt, uint64_t off, uint64_t len) {
+  memcpy(b->data + tableAt + sizeof(uint32_t), &off, sizeof(off));
+  memcpy(b->data + tableAt + sizeof(uint32_t) + sizeof(uint64_t), &len, sizeof(len));
+}
+
+char *IndexSnapshot_Save(const IndexSpec *sp, size_t *outlen) {
+  if (!sp->termsDict) {
+    return NULL;
+  }
+  Buffer b;
+  Buffer_Init(&b, 1024 * 1024);
+  BufferWriter bw = NewBufferWriter(&b);
+
+  snapWriteU32(&bw, SNAP_MAGIC);
+  snapWriteU32(&bw, SNAP_VERSION);
+  snapWriteU32(&bw, 2);  // nsections: TERMS + HOTTERMS (the latter possibly empty)
+  size_t tableAt = b.offset;
+  snapWriteU32(&bw, SNAP_SECTION_TERMS);
+  snapWriteU64(&bw, 0);  // offset, patched below
+  snapWriteU64(&bw, 0);  // len, patched below
+  size_t hotTableAt = b.offset;
+  snapWriteU32(&bw, SNAP_SECTION_HOTTERMS);
+  snapWriteU64(&bw, 0);
+  snapWriteU64(&bw, 0);
+  size_t sectionStart = b.offset;
+
+  snapWriteU64(&bw, dictSize(sp->termsDict));
+  dictIterator *iter = dictGetIterator(sp->termsDict);
+  dictEntry *entry;
+  while ((entry = dictNext(iter))) {
+    snapWriteTermIndex(&bw, entry);
+  }
+  dictReleaseIterator(iter);
+  size_t hotStart = b.offset;
+  if (sp->hotTerms) {
+    snapWriteHotTerms(&bw, sp->hotTerms);
+  }
+
+  // patch the section table now that the payload extents are known
+  snapPatchSection(&b, tableAt, sectionStart, hotStart - sectionStart);
+  snapPatchSection(&b, hotTableAt, hotStart, b.offset - hotStart);
+
+  *outlen = b.offset;
+  return b.data;  // ownership moves to the caller
+}
+
+/* One term record located by the scan pass: the key, and the extent of the
+ * index image within the blob that the build pass reconstructs from */
+typedef struct {
+  const char *key;
+  uint32_t keyLen;
+  const char *body;
+  const char *bodyEnd;
+  InvertedIndex *built;    // filled by the build pass; NULL on a malformed record
+  uint64_t builtBlocks;
+} SnapTermRecord;
+
+/* Walk one term record without building anything: validates the extents and
+ * leaves rec->body..bodyEnd delimiting the index image */
+static int snapScanTerm(SnapReader *r, SnapTermRecord *rec) {
+  rec->keyLen = snapReadU32(r);
+  rec->key = snapReadRaw(r, rec->keyLen);
+  rec->body = r->cur;
+  snapReadU32(r);  // flags
+  snapReadU64(r);  // lastId
+  snapReadU32(r);  // numDocs
+  snapReadU32(r);  // maxFreq
+  uint32_t nblocks = snapReadU32(r);
+  for (uint32_t i = 0; i < nblocks && !r->err; i++) {
+    snapReadRaw(r, 8 + 8 + 4 + 4 + 8);  // firstId, lastId, numDocs, maxFreq, fieldMaskUnion
+    uint64_t dataLen = snapReadU64(r);
+    snapReadRaw(r, dataLen);
+  }
+  rec->bodyEnd = r->cur;
+  return !r->err;
+}
+
+/* Free an index abandoned mid-build. Bypasses InvertedIndex_Free: nothing here
+ * is accounted in TotalIIBlocks yet, and this may run on a worker thread */
+static void snapFreeHalfBuilt(InvertedIndex *idx) {
+  for (uint32_t i = 0; i < idx->size; i++) {
+    if (!idx->blocks[i].bufBorrowed && idx->blocks[i].buf.data) {
+      rm_free(idx->blocks[i].buf.data);
+    }
+  }
+  rm_free(idx->blocks);
+  rm_free(idx);
+}
+
+/* Build one InvertedIndex from its scanned record: every completed block
+ * borrows its data straight from the blob; only the live tail block (which
+ * the writer may append to, and so realloc) is copied out. Runs on worker
+ * threads - it touches nothing but the record and the allocator */
+static void snapBuildIndex(void *arg) {
+  SnapTermRecord *rec = arg;
+  SnapReader r = {.cur = rec->body, .end = rec->bodyEnd};
+  uint32_t flags = snapReadU32(&r);
+  InvertedIndex *idx = NewInvertedIndex(flags, 0);
+  idx->lastId = snapReadU64(&r);
+  idx->numDocs = snapReadU32(&r);
+  idx->maxFreq = snapReadU32(&r);
+  idx->size = snapReadU32(&r);
+  // each block record carries at least 40 bytes of fixed fields: a count that
+  // cannot fit in the remaining payload is corruption, not a big index
+  if (idx->size > (size_t)(r.end - r.cur) / 40) {
+    r.err = 1;
+    idx->size = 0;
+  }
+  idx->blocks = rm_calloc(idx->size ? idx->size : 1, sizeof(IndexBlock));
+
+  for (uint32_t i = 0; i < idx->size && !r.err; ++i) {
+    IndexBlock *blk = &idx->blocks[i];
+    blk->firstId = snapReadU64(&r);
+    blk->lastId = snapReadU64(&r);
+    blk->numDocs = snapReadU32(&r);
+    blk->maxFreq = snapReadU32(&r);
+    blk->fieldMaskUnion = snapReadU64(&r);
+    uint64_t dataLen = snapReadU64(&r);
+    const char *data = snapReadRaw(&r, dataLen);
+    if (r.err) {
+      break;
+    }
+    if (i + 1 < idx->size) {
+      // completed block: point into the blob, zero copies
+      blk->buf.data = (char *)data;
+      blk->buf.cap = blk->buf.offset = dataLen;
+      blk->bufBorrowed = 1;
+    } else {
+      // tail block: the writer appends (and reallocs) it, so it owns its bytes
+      Buffer_Init(&blk->buf, dataLen ? dataLen : 1);
+      memcpy(blk->buf.data, data, dataLen);
+      blk->buf.offset = dataLen;
+    }
+  }
+  if (r.err) {
+    snapFreeHalfBuilt(idx);
+    return;  // rec->built stays NULL, the insert pass fails the load
+  }
+  rec->builtBlocks = idx->size;
+  rec->built = idx;
+}
+
+/* A worker's slice of the record array */
+typedef struct {
+  SnapTermRecord *recs;
+  uint64_t from, to;
+} SnapBuildSlice;
+
+static void snapBuildSlice(void *arg) {
+  SnapBuildSlice *slice = arg;
+  for (uint64_t i = slice->from; i < slice->to; ++i) {
+    snapBuildIndex(&slice->recs[i]);
+  }
+}
+
+// Reconstruction parallelizes from this many term records on
+#define SNAP_PARALLEL_MIN_INDEXES 256
+#define SNAP_LOAD_MAX_THREADS 8
+
+/* Load the TERMS section in three passes: scan the records (bounds checks and
+ * extents, sequential), rebuild the InvertedIndex objects (spread over a
+ * transient thread pool for large term counts - the blob is read-only and the
+ * build touches only the allocator), then insert into the keyspace dict, which
+ * is the only part that must stay on the loading thread */
+static int snapLoadTerms(RedisModuleCtx *ctx, IndexSpec *sp, SnapReader *r, int *lazyOut) {
+  sp->termsDict = IndexSpec_NewKeysDict();
+  uint64_t count = snapReadU64(r);
+  // a term record carries at least 28 bytes of fixed fields: a count that
+  // cannot fit in the remaining payload is corruption, not a big dictionary
+  if (r->err || count > (uint64_t)(r->end - r->cur) / 28) {
+    return REDISMODULE_ERR;
+  }
+
+  SnapTermRecord *recs = rm_calloc(count ? count : 1, sizeof(*recs));
+  uint64_t nrecs = 0;
+  while (nrecs < count && snapScanTerm(r, &recs[nrecs])) {
+    ++nrecs;
+  }
+  if (nrecs < count) {
+    rm_free(recs);
+    return REDISMODULE_ERR;
+  }
+
+  if (count >= SNAP_LAZY_MIN_INDEXES) {
+    *lazyOut = 1;
+    // large dictionary: insert cold extents only - queries hydrate on first
+    // open, the hot-term hydrator warms the rest in the background. The
+    // record bytes stay untouched (and unfaulted) in the arena until then
+    for (uint64_t i = 0; i < count; ++i) {
+      SnapColdExtent *ext = rm_malloc(sizeof(*ext));
+      ext->body = recs[i].body;
+      ext->bodyEnd = recs[i].bodyEnd;
+      RedisModuleString *keyName = RedisModule_CreateString(ctx, recs[i].key, recs[i].keyLen);
+      KeysDictValue *kdv = calloc(1, sizeof(*kdv));
+      kdv->dtor = snapColdDtor;
+      kdv->p = ext;
+      kdv->cold = 1;
+      dictAdd(sp->termsDict, keyName, kdv);
+      RedisModule_FreeString(ctx, keyName);
+    }
+    rm_free(recs);
+    return REDISMODULE_OK;
+  }
+
+  if (count >= SNAP_PARALLEL_MIN_INDEXES) {
+    // one persistent pool: the vendored thpool keys its workers' keepalive off
+    // a process-global, so destroying a transient pool would stop every other
+    // pool's workers (the cleaner, the snapshot builder) along with it
+    static threadpool loadPool;
+    static int nthreads;
+    if (!loadPool) {
+      long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+      // at least two workers: even a small machine overlaps the memcpy of one
+      // record with the allocator work of another
+      nthreads = ncpu < 2 ? 2 : (ncpu > SNAP_LOAD_MAX_THREADS ? SNAP_LOAD_MAX_THREADS : ncpu);
+      loadPool = thpool_init(nthreads);
+    }
+    int nslices = nthreads * 4;  // finer slices even out skewed term sizes
+    SnapBuildSlice *slices = rm_calloc(nslices, sizeof(*slices));
+    for (int i = 0; i < nslices; ++i) {
+      slices[i].recs = recs;
+      slices[i].from = count * i / nslices;
+      slices[i].to = count * (i + 1) / nslices;
+      thpool_add_work(loadPool, snapBuildSlice, &slices[i]);
+    }
+    thpool_wait(loadPool);
+    rm_free(slices);
+  } else {
+    for (uint64_t i = 0; i < count; ++i) {
+      snapBuildIndex(&recs[i]);
+    }
+  }
+
+  // account all built blocks at once, then insert; on any malformed record,
+  // unwind through the regular dtor (which re-subtracts them)
+  int rc = REDISMODULE_OK;
+  for (uint64_t i = 0; i < count; ++i) {
+    if (!recs[i].built) {
+      rc = REDISMODULE_ERR;
+    }
+    TotalIIBlocks += recs[i].builtBlocks;
+  }
+  for (uint64_t i = 0; i < count; ++i) {
+    InvertedIndex *idx = recs[i].built;
+    if (!idx) {
+      continue;
+    }
+    if (rc != REDISMODULE_OK) {
+      InvertedIndex_Free(idx);
+      continue;
+    }
+    if (idx->size == 0) {
+      InvertedIndex_AddBlock(idx, 0);
+    }
+    RedisModuleString *keyName = RedisModule_CreateString(ctx, recs[i].key, recs[i].keyLen);
+    KeysDictValue *kdv = calloc(1, sizeof(*kdv));
+    kdv->dtor = InvertedIndex_Free;
+    kdv->p = idx;
+    dictAdd(sp->termsDict, keyName, kdv);
+    RedisModule_FreeString(ctx, keyName);
+  }
+  rm_free(recs);
+  return rc;
+}
+
+/* Parse a HOTTERMS section into the spec's tracker, so the sketch keeps
+ * evolving from where the previous run left off */
+static void snapLoadHotTerms(IndexSpec *sp, SnapReader *r) {
+  uint32_t count = snapReadU32(r);
+  for (uint32_t i = 0; i < count && !r->err; i++) {
+    uint32_t klen = snapReadU32(r);
+    const char *key = snapReadRaw(r, klen);
+    uint64_t hits = snapReadU64(r);
+    if (r->err) {
+      break;
+    }
+    if (!sp->hotTerms) {
+      sp->hotTerms = rm_calloc(1, sizeof(*sp->hotTerms));
+    }
+    HotTermSlot *slot = &sp->hotTerms->slots[hotTermsSlot(key, klen)];
+    if (slot->term && slot->hits >= hits) {
+      continue;
+    }
+    rm_free(slot->term);
+    slot->term = rm_strndup(key, klen);
+    slot->len = klen;
+    slot->hits = hits;
+  }
+}
+
+typedef struct {
+  char *indexName;
+} SnapHydrateJob;
+
+/* Background hydration of the persisted hot terms: the spec may not be in the
+ * keyspace yet right after its RDB value loads, so resolution retries briefly.
+ * One GIL slice suffices - the hot table is small by construction */
+static void snapHydrateRun(void *arg) {
+  SnapHydrateJob *job = arg;
+  RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+  for (int attempt = 0; attempt < 100; attempt++) {
+    RedisModule_ThreadSafeContextLock(ctx);
+    RedisSearchCtx *sctx = NewSearchCtxC(ctx, job->indexName, false);
+    if (sctx) {
+      IndexSpec *sp = sctx->spec;
+      if (sp->hotTerms && sp->termsDict) {
+        IndexSpec_LockRead(sp);
+        for (uint32_t i = 0; i < HOTTERMS_CAP; i++) {
+          HotTermSlot *slot = &sp->hotTerms->slots[i];
+          if (!slot->term) {
+            continue;
+          }
+          RedisModuleString *keyName = RedisModule_CreateString(ctx, slot->term, slot->len);
+          KeysDictValue *kdv = dictFetchValue(sp->termsDict, keyName);
+          if (kdv && kdv->cold) {
+            IndexSnapshot_HydrateTerm(sp, kdv);
+          }
+          RedisModule_FreeString(ctx, keyName);
+        }
+        IndexSpec_UnlockIndex(sp);
+      }
+      SearchCtx_Free(sctx);
+      RedisModule_ThreadSafeContextUnlock(ctx);
+      break;
+    }
+    RedisModule_ThreadSafeContextUnlock(ctx);
+    usleep(100000);
+  }
+  RedisModule_FreeThreadSafeContext(ctx);
+  rm_free(job->indexName);
+  rm_free(job);
+}
+
+int IndexSnapshot_Load(RedisModuleCtx *ctx, IndexSpec *sp, char *blob, size_t len) {
+  SnapReader hdr = {.cur = blob, .end = blob + len};
+  if (snapReadU32(&hdr) != SNAP_MAGIC || snapReadU32(&hdr) > SNAP_VERSION) {
+    return REDISMODULE_ERR;
+  }
+  uint32_t nsections = snapReadU32(&hdr);
+  int rc = REDISMODULE_ERR;  // a blob without a terms section is malformed
+  int lazy = 0;
+  for (uint32_t i = 0; i < nsections && !hdr.err; ++i) {
+    uint32_t kind = snapReadU32(&hdr);
+    uint64_t off = snapReadU64(&hdr);
+    uint64_t slen = snapReadU64(&hdr);
+    if (hdr.err || off > len || slen > len - off) {
+      return REDISMODULE_ERR;
+    }
+    SnapReader sec = {.cur = blob + off, .end = blob + off + slen};
+    if (kind == SNAP_SECTION_TERMS) {
+      rc = snapLoadTerms(ctx, sp, &sec, &lazy);
+      if (rc != REDISMODULE_OK) {
+        return rc;
+      }
+    } else if (kind == SNAP_SECTION_HOTTERMS && slen > 0) {
+      snapLoadHotTerms(sp, &sec);
+    }
+    // unknown kinds: skipped via the table, no payload walk needed
+  }
+  if (rc == REDISMODULE_OK) {
+    sp->snapshotArena = blob;  // block buffers point into it; freed with the spec
+    if (lazy && sp->hotTerms) {
+      // warm the terms queries actually touch, off the loading thread
+      if (!snapshotPool_g) {
+        snapshotPool_g = thpool_init(1);
+      }
+      SnapHydrateJob *job = rm_calloc(1, sizeof(*job));
+      job->indexName = rm_strdup(sp->name);
+      thpool_add_work(snapshotPool_g, snapHydrateRun, job);
+    }
+  }
+  return rc;
+}
+
+InvertedIndex *IndexSnapshot_HydrateTerm(IndexSpec *sp, KeysDictValue *kdv) {
+  SnapColdExtent *ext = kdv->p;
+  SnapTermRecord rec = {.body = ext->body, .bodyEnd = ext->bodyEnd};
+  snapBuildIndex(&rec);
+  if (rec.built) {
+    TotalIIBlocks += rec.builtBlocks;
+    if (rec.built->size == 0) {
+      InvertedIndex_AddBlock(rec.built, 0);
+    }
+  } else {
+    // malformed extent (should not happen: the load scan validated it) -
+    // substitute an empty index so writers still have a target
+    rec.built = NewInvertedIndex(sp->flags, 1);
+  }
+  rm_free(ext);
+  kdv->p = rec.built;
+  kdv->dtor = InvertedIndex_Free;
+  kdv->cold = 0;
+  return rec.built;
+}
+
+/* ---- Background snapshot refresh ----
+ *
+ * One builder thread rebuilds cached blobs off the save path. Each slice
+ * resolves the spec by name under the GIL (holding nothing across slices, so
+ * an index drop cannot leave the builder with dangling pointers), serializes a
+ * bounded batch of terms via dictScan's resumable cursor, and releases. Any
+ * write during the build bumps the term epoch and the result is discarded;
+ * rehashes triggered by such writes may make dictScan revisit entries, which
+ * the same epoch check makes harmless */
+
+#define SNAP_REFRESH_BATCH 512
+
+typedef struct {
+  char *indexName;
+} SnapRefreshJob;
+
+typedef struct {
+  BufferWriter bw;
+  uint64_t count;
+  uint32_t scanned;
+} SnapRefreshScan;
+
+static void snapRefreshScanCb(void *privdata, const dictEntry *de) {
+  SnapRefreshScan *s = privdata;
+  snapWriteTermIndex(&s->bw, de);
+  s->count++;
+  s->scanned++;
+}
+
+static void snapRefreshRun(void *arg) {
+  SnapRefreshJob *job = arg;
+  RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+  Buffer b;
+  Buffer_Init(&b, 1024 * 1024);
+  SnapRefreshScan scan = {.bw = NewBufferWriter(&b), .count = 0};
+
+  // header + section table + count placeholder, patched at publish
+  snapWriteU32(&scan.bw, SNAP_MAGIC);
+  snapWriteU32(&scan.bw, SNAP_VERSION);
+  snapWriteU32(&scan.bw, 2);
+  size_t tableAt = b.offset;
+  snapWriteU32(&scan.bw, SNAP_SECTION_TERMS);
+  snapWriteU64(&scan.bw, 0);
+  snapWriteU64(&scan.bw, 0);
+  size_t hotTableAt = b.offset;
+  snapWriteU32(&scan.bw, SNAP_SECTION_HOTTERMS);
+  snapWriteU64(&scan.bw, 0);
+  snapWriteU64(&scan.bw, 0);
+  size_t sectionStart = b.offset;
+  snapWriteU64(&scan.bw, 0);  // term count, patched at publish
+
+  uint64_t epoch = 0;
+  uint64_t specId = 0;
+  unsigned long cursor = 0;
+  int ok = 0, first = 1;
+
+  for (;;) {
+    RedisModule_ThreadSafeContextLock(ctx);
+    RedisSearchCtx *sctx = NewSearchCtxC(ctx, job->indexName, false);
+    if (!sctx || !sctx->spec->termsDict) {
+      if (sctx) {
+        SearchCtx_Free(sctx);
+      }
+      RedisModule_ThreadSafeContextUnlock(ctx);
+      goto done;  // index gone (or not term-resident): abandon the build
+    }
+    IndexSpec *sp = sctx->spec;
+    if (first) {
+      epoch = __atomic_load_n(&sp->termWriteEpoch, __ATOMIC_ACQUIRE);
+      specId = sp->uniqueId;
+      first = 0;
+    } else if (sp->uniqueId != specId ||
+               __atomic_load_n(&sp->termWriteEpoch, __ATOMIC_ACQUIRE) != epoch) {
+      // the epoch alone cannot tell a same-name recreate apart (the new spec's
+      // counter may land on the captured value); the unique id can
+      SearchCtx_Free(sctx);
+      RedisModule_ThreadSafeContextUnlock(ctx);
+      goto done;  // a write (or a recreate) landed: no longer a consistent cut
+    }
+    // reader slice: GC rewrites take the write lock, so block images are stable
+    IndexSpec_LockRead(sp);
+    scan.scanned = 0;
+    while (scan.scanned < SNAP_REFRESH_BATCH &&
+           (cursor = dictScan(sp->termsDict, cursor, snapRefreshScanCb, NULL, &scan)) != 0) {
+    }
+    int finished = cursor == 0;
+    if (finished && __atomic_load_n(&sp->termWriteEpoch, __ATOMIC_ACQUIRE) == epoch) {
+      // publish: append the hot-term section, patch the table and the count,
+      // then hand the blob to the spec
+      size_t hotStart = b.offset;
+      if (sp->hotTerms) {
+        snapWriteHotTerms(&scan.bw, sp->hotTerms);
+      }
+      snapPatchSection(&b, tableAt, sectionStart, hotStart - sectionStart);
+      snapPatchSection(&b, hotTableAt, hotStart, b.offset - hotStart);
+      memcpy(b.data + sectionStart, &scan.count, sizeof(scan.count));
+      rm_free(sp->snapCache);
+      sp->snapCache = b.data;
+      sp->snapCacheLen = b.offset;
+      sp->snapCacheEpoch = epoch;
+      b.data = NULL;  // ownership moved
+      ok = 1;
+    }
+    IndexSpec_UnlockIndex(sp);
+    SearchCtx_Free(sctx);
+    RedisModule_ThreadSafeContextUnlock(ctx);
+    if (finished) {
+      goto done;
+    }
+  }
+
+done:
+  if (!ok && b.data) {
+    rm_free(b.data);
+  }
+  RedisModule_FreeThreadSafeContext(ctx);
+  rm_free(job->indexName);
+  rm_free(job);
+}
+
+void IndexSnapshot_ScheduleRefresh(const IndexSpec *sp) {
+  if (!sp->termsDict) {
+    return;
+  }
+  if (!snapshotPool_g) {
+    snapshotPool_g = thpool_init(1);
+  }
+  SnapRefreshJob *job = rm_calloc(1, sizeof(*job));
+  job->indexName = rm_strdup(sp->name);
+  thpool_add_work(snapshotPool_g, snapRefreshRun, job);
+}
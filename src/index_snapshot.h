@@ -0,0 +1,54 @@
+#ifndef INDEX_SNAPSHOT_H
+#define INDEX_SNAPSHOT_H
+
+#include "spec.h"
+#include "inverted_index.h"
+#include "redismodule.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Versioned binary snapshot of an index's heavyweight structures, designed for
+ * fast restart: one contiguous blob (header + section table + raw images) that
+ * is written sequentially in a single RDB string and loaded by parsing the
+ * header and fixing up pointers into the blob, instead of round-tripping every
+ * block through per-element RedisModule IO calls.
+ *
+ * The loaded blob is retained as the spec's snapshot arena: inverted-index
+ * blocks borrow their data directly from it (bufBorrowed), so loading copies
+ * only each index's live tail block. The section table keys sections by kind,
+ * so future sections (doctable pages, tries) extend the format without a
+ * version break for readers that skip unknown kinds.
+ */
+
+/* Serialize the spec's term indexes into a freshly allocated blob (rm_malloc).
+ * Returns NULL when the spec owns no term dictionary */
+char *IndexSnapshot_Save(const IndexSpec *sp, size_t *outlen);
+
+/* Rebuild sp->termsDict from a snapshot blob. On success the blob is retained
+ * as sp->snapshotArena (owned by the spec, freed with it) and REDISMODULE_OK
+ * is returned; on a malformed or unsupported blob the caller keeps ownership
+ * and REDISMODULE_ERR is returned */
+int IndexSnapshot_Load(RedisModuleCtx *ctx, IndexSpec *sp, char *blob, size_t len);
+
+/* Queue a background rebuild of the spec's cached snapshot blob. The builder
+ * thread serializes the term dictionary in short GIL slices while queries
+ * continue - only the epoch capture and the final publish quiesce - and
+ * discards the build if any write lands meanwhile. RDB save streams the cached
+ * blob in one call when its epoch still matches */
+void IndexSnapshot_ScheduleRefresh(const IndexSpec *sp);
+
+/* Hydrate a cold (snapshot-lazy) term entry into a real InvertedIndex,
+ * replacing kdv->p in place. Must run under the GIL. Returns the index */
+InvertedIndex *IndexSnapshot_HydrateTerm(IndexSpec *sp, KeysDictValue *kdv);
+
+/* Record a query hit on a term key, feeding the spec's hot-term tracker */
+void HotTerms_Hit(IndexSpec *sp, const char *key, size_t len);
+void HotTerms_Free(struct HotTerms *ht);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,4 +1,5 @@
 #include "indexer.h"
+#include "result_cache.h"
 #include "forward_index.h"
 #include "numeric_index.h"
 #include "inverted_index.h"
@@ -10,6 +11,7 @@
 
 static void writeIndexEntry(IndexSpec *spec, InvertedIndex *idx, IndexEncoder encoder,
                             ForwardIndexEntry *entry) {
+  RM_ALLOC_TAG_SCOPE(RM_TAG_POSTINGS);
   size_t sz = InvertedIndex_WriteForwardIndexEntry(idx, encoder, entry);
 
   // Update index statistics:
@@ -19,6 +21,17 @@ static void writeIndexEntry(IndexSpec *spec, InvertedIndex *idx, IndexEncoder en
   // Number of records
   spec->stats.numRecords++;
 
+  // Per-field attribution from the entry's folded mask: a posting touching
+  // several fields counts once per field
+  uint64_t fm = FoldFieldMask(entry->fieldMask);
+  while (fm) {
+    int bit = __builtin_ctzll(fm);
+    fm &= fm - 1;
+    spec->fieldIdxStats[bit].invertedBytes += sz;
+    spec->fieldIdxStats[bit].postings++;
+  }
+  IndexSpec_BumpTermEpoch(spec);
+
   /* Record the space saved for offset vectors */
   if (spec->flags & Index_StoreTermOffsets) {
     spec->stats.offsetVecsSize += VVW_GetByteLength(entry->vw);
@@ -158,10 +171,20 @@ static int writeMergedEntries(DocumentIndexer *indexer, RSAddDocumentCtx *aCtx,
       }
 
       RedisModuleKey *idxKey = NULL;
-      InvertedIndex *invidx = Redis_OpenInvertedIndexEx(ctx, fwent->term, fwent->len, 1, &idxKey);
-
-      if (invidx == NULL) {
-        continue;
+      long long span = ctx->spec->partitionSpan;
+      uint32_t curPart = 0;
+      InvertedIndex *invidx;
+      if (span > 0) {
+        // partitioned: open lazily per entry below, where the docId is known
+        invidx = NULL;
+      } else {
+        invidx = Redis_OpenInvertedIndexEx(ctx, fwent->term, fwent->len, 1, &idxKey);
+        if (invidx == NULL) {
+          continue;
+        }
+      }
+      if (ctx->spec->resultCache) {
+        ResultCache_OnTermWrite(ctx->spec->resultCache, fwent->term, fwent->len);
       }
 
       for (; fwent != NULL; fwent = fwent->next) {
@@ -184,6 +207,17 @@ static int writeMergedEntries(DocumentIndexer *indexer, RSAddDocumentCtx *aCtx,
 
         // Finally assign the document ID to the entry
         fwent->docId = docId;
+        if (span > 0) {
+          // a merged chain ascends in docId, so partition switches are rare
+          uint32_t part = (uint32_t)(docId / span);
+          if (!invidx || part != curPart) {
+            invidx = Redis_OpenInvertedIndexPart(ctx, fwent->term, fwent->len, 1, part);
+            curPart = part;
+          }
+          if (!invidx) {
+            continue;
+          }
+        }
         writeIndexEntry(ctx->spec, invidx, encoder, fwent);
       }
 
@@ -221,7 +255,11 @@ static void writeCurEntries(DocumentIndexer *indexer, RSAddDocumentCtx *aCtx, Re
 
     assert(ctx);
 
-    InvertedIndex *invidx = Redis_OpenInvertedIndexEx(ctx, entry->term, entry->len, 1, &idxKey);
+    InvertedIndex *invidx =
+        ctx->spec->partitionSpan > 0
+            ? Redis_OpenInvertedIndexPart(ctx, entry->term, entry->len, 1,
+                                          (uint32_t)(aCtx->doc.docId / ctx->spec->partitionSpan))
+            : Redis_OpenInvertedIndexEx(ctx, entry->term, entry->len, 1, &idxKey);
     if (invidx) {
       entry->docId = aCtx->doc.docId;
       assert(entry->docId);
@@ -262,10 +300,13 @@ static int makeDocumentId(RSAddDocumentCtx *aCtx, RedisSearchCtx *sctx, int repl
   if (replace) {
     RSDocumentMetadata *dmd = DocTable_PopR(table, doc->docKey);
     if (dmd) {
+      if (spec->resultCache) {
+        ResultCache_OnDocDelete(spec->resultCache);
+      }
       // decrease the number of documents in the index stats only if the document was there
       --spec->stats.numDocuments;
       aCtx->oldMd = dmd;
-      if (dmd->flags & Document_HasOnDemandDeletable) {
+      if (DMD_Flags(dmd) & Document_HasOnDemandDeletable) {
         // Delete all on-demand fields.. this means geo,but could mean other things..
         handleReplaceDelete(sctx, dmd->id);
       }
@@ -309,8 +350,13 @@ static void doAssignIds(RSAddDocumentCtx *cur, RedisSearchCtx *ctx) {
     RSDocumentMetadata *md = DocTable_Get(&spec->docs, cur->doc.docId);
     md->maxFreq = cur->fwIdx->maxFreq;
     md->len = cur->fwIdx->totalFreq;
+    if (spec->resultCache) {
+      ResultCache_OnDocChange(spec->resultCache);
+    }
 
     if (cur->sv) {
+      // Mirror the numeric entries into the per-field columns as well
+      SortingTable_IngestVector(spec->sortables, cur->doc.docId, cur->sv);
       DocTable_SetSortingVector(&spec->docs, cur->doc.docId, cur->sv);
       cur->sv = NULL;
     }
@@ -486,22 +532,33 @@ cleanup:
   }
 }
 
+size_t Indexer_Refill(DocumentIndexer *indexer);
+
 static void *Indexer_Run(void *p) {
   DocumentIndexer *indexer = p;
 
   while (1) {
-    pthread_mutex_lock(&indexer->lock);
-    while (indexer->head == NULL) {
-      pthread_cond_wait(&indexer->cond, &indexer->lock);
+    if (indexer->head == NULL && !Indexer_Refill(indexer)) {
+      // park until a producer signals; re-check the stack after setting the flag so a
+      // push racing with us cannot be lost
+      pthread_mutex_lock(&indexer->lock);
+      __atomic_store_n(&indexer->consumerWaiting, 1, __ATOMIC_SEQ_CST);
+      while (__atomic_load_n(&indexer->pushHead, __ATOMIC_SEQ_CST) == NULL) {
+        pthread_cond_wait(&indexer->cond, &indexer->lock);
+      }
+      __atomic_store_n(&indexer->consumerWaiting, 0, __ATOMIC_SEQ_CST);
+      pthread_mutex_unlock(&indexer->lock);
+      Indexer_Refill(indexer);
     }
 
     RSAddDocumentCtx *cur = indexer->head;
-    indexer->size--;
-
+    if (!cur) {
+      continue;
+    }
     if ((indexer->head = cur->next) == NULL) {
       indexer->tail = NULL;
     }
-    pthread_mutex_unlock(&indexer->lock);
+    __atomic_sub_fetch(&indexer->size, 1, __ATOMIC_SEQ_CST);
     Indexer_Process(indexer, cur);
     AddDocumentCtx_Finish(cur);
   }
@@ -515,20 +572,54 @@ int Indexer_Add(DocumentIndexer *indexer, RSAddDocumentCtx *aCtx) {
     return 0;
   }
 
-  pthread_mutex_lock(&indexer->lock);
+  // Lock-free push: producers only ever touch the atomic stack head, so submissions from
+  // the indexing pool never serialize on each other
+  RSAddDocumentCtx *old;
+  do {
+    old = __atomic_load_n(&indexer->pushHead, __ATOMIC_RELAXED);
+    aCtx->next = old;
+  } while (!__atomic_compare_exchange_n(&indexer->pushHead, &old, aCtx, 0, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED));
+  __atomic_add_fetch(&indexer->size, 1, __ATOMIC_SEQ_CST);
+
+  // wake the consumer only if it is actually parked
+  if (__atomic_load_n(&indexer->consumerWaiting, __ATOMIC_SEQ_CST)) {
+    pthread_mutex_lock(&indexer->lock);
+    pthread_cond_signal(&indexer->cond);
+    pthread_mutex_unlock(&indexer->lock);
+  }
+  return 0;
+}
 
+/* Consumer side: refill the private FIFO from the producer stack. Returns the number of
+ * items grabbed. Single consumer only. Non-static for the benefit of concurrency harnesses */
+size_t Indexer_Refill(DocumentIndexer *indexer) {
+  RSAddDocumentCtx *grabbed =
+      __atomic_exchange_n(&indexer->pushHead, NULL, __ATOMIC_ACQUIRE);
+  if (!grabbed) {
+    return 0;
+  }
+  // reverse the LIFO stack into submission (FIFO) order
+  size_t n = 0;
+  RSAddDocumentCtx *prev = NULL;
+  while (grabbed) {
+    RSAddDocumentCtx *next = grabbed->next;
+    grabbed->next = prev;
+    prev = grabbed;
+    grabbed = next;
+    ++n;
+  }
+  // append to the private chain
   if (indexer->tail) {
-    indexer->tail->next = aCtx;
-    indexer->tail = aCtx;
+    indexer->tail->next = prev;
   } else {
-    indexer->head = indexer->tail = aCtx;
+    indexer->head = prev;
   }
-
-  pthread_cond_signal(&indexer->cond);
-  pthread_mutex_unlock(&indexer->lock);
-
-  indexer->size++;
-  return 0;
+  while (prev->next) {
+    prev = prev->next;
+  }
+  indexer->tail = prev;
+  return n;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -13,15 +13,40 @@ typedef union FieldData {
     char *slon;
     char *slat;
   } geo;  // lon/lat pair
-  char **tags;
+  struct {
+    char **tags;
+    // Single buffer backing the tag slices in `tags`; freed together with it
+    char *tagsBuf;
+  };
 } fieldData;
 
+/* The indexing pipeline is two-staged by construction, and the stages are already decoupled:
+ *
+ *   1. TOKENIZE (parallel). Document_AddToIndexes runs on the CONCURRENT_POOL_INDEX thread
+ *      pool (documents with over SELF_EXEC_THRESHOLD bytes of text; smaller ones inline on
+ *      the caller) and performs all per-field preprocessing - tokenization, stemming,
+ *      synonym/phonetic expansion - into a private ForwardIndex. No shared index state is
+ *      touched and no indexer lock is held, so a stemming-heavy document only occupies its
+ *      own pool thread.
+ *
+ *   2. WRITE (serialized). Only after its forward index is complete does a document enter
+ *      this queue, and the DocumentIndexer thread does nothing but docId assignment, term
+ *      trie insertion and the merged inverted-index writes under the GIL.
+ *
+ * Keep that split intact when changing either side: any tokenization added to the write
+ * stage reintroduces the head-of-line blocking this design exists to avoid */
 typedef struct DocumentIndexer {
-  RSAddDocumentCtx *head;          // first item in the queue
-  RSAddDocumentCtx *tail;          // last item in the queue
-  pthread_mutex_t lock;            // lock - only used when adding or removing items from the queue
+  /* Lock-free MPSC submission: producers push onto this atomic LIFO head with a CAS loop and
+   * never contend with each other; the consumer detaches the whole stack in one exchange,
+   * reverses it to FIFO order and works off a private chain. The mutex and condition exist
+   * only to park and wake the consumer thread when the queue is empty */
+  RSAddDocumentCtx *pushHead;      // atomic producer stack
+  RSAddDocumentCtx *head;          // consumer-private FIFO: first item
+  RSAddDocumentCtx *tail;          // consumer-private FIFO: last item
+  int consumerWaiting;             // atomic: consumer is parked on the condition
+  pthread_mutex_t lock;            // only for parking/waking the consumer
   pthread_cond_t cond;             // condition - used to wait on items added to the queue
-  size_t size;                     // number of items in the queue
+  size_t size;                     // atomic: number of items submitted and not yet processed
   ConcurrentSearchCtx concCtx;     // GIL locking. This is repopulated with the relevant key data
   RedisModuleCtx *redisCtx;        // Context for keeping the spec key
   RedisModuleString *specKeyName;  // Cached, used for opening/closing the spec key.
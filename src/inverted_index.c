@@ -1,5 +1,13 @@
 #define QINT_API static
 #include "inverted_index.h"
+#include "perf_counters.h"
+#include "dep/miniz/miniz.h"
+
+// Coarse tiering clock (minutes); see tiering.c
+extern uint32_t IndexTieringClock_g;
+
+static inline void IndexReader_EnterBlock(IndexReader *ir);
+#include "concurrent_ctx.h"
 #include "math.h"
 #include "varint.h"
 #include <stdio.h>
@@ -17,7 +25,13 @@ uint64_t TotalIIBlocks = 0;
 #define INDEX_BLOCK_SIZE 100
 
 // Initial capacity (in bytes) of a new block
-#define INDEX_BLOCK_INITIAL_CAP 6
+/* Initial byte capacity of a block buffer. Blocks hold ~INDEX_BLOCK_SIZE
+ * entries; starting at 32 covers the first ~25 docids-only records without a
+ * realloc, while text blocks double from here (see Buffer_Grow) */
+#define INDEX_BLOCK_INITIAL_CAP 32
+
+// Record a skip entry for every N'th record in a block
+#define INDEX_BLOCK_SKIP_INTERVAL 16
 
 // The last block of the index
 #define INDEX_LAST_BLOCK(idx) (idx->blocks[idx->size - 1])
@@ -43,7 +57,9 @@ IndexBlock *InvertedIndex_AddBlock(InvertedIndex *idx, t_docId firstId) {
   TotalIIBlocks++;
   idx->size++;
   idx->blocks = rm_realloc(idx->blocks, idx->size * sizeof(IndexBlock));
-  idx->blocks[idx->size - 1] = (IndexBlock){.firstId = firstId, .lastId = firstId, .numDocs = 0};
+  idx->blocks[idx->size - 1] =
+      (IndexBlock){.firstId = firstId, .lastId = firstId, .numDocs = 0,
+                   .touchMin = IndexTieringClock_g};
   Buffer_Init(&INDEX_LAST_BLOCK(idx).buf, INDEX_BLOCK_INITIAL_CAP);
   return &INDEX_LAST_BLOCK(idx);
 }
@@ -56,14 +72,66 @@ InvertedIndex *NewInvertedIndex(IndexFlags flags, int initBlock) {
   idx->gcMarker = 0;
   idx->flags = flags;
   idx->numDocs = 0;
+  idx->maxFreq = 0;
+  idx->loadArena = NULL;
   if (initBlock) {
     InvertedIndex_AddBlock(idx, 0);
   }
   return idx;
 }
 
+/* Drop a block's skip entries. Called when the underlying buffer is rewritten (GC repair), which
+ * invalidates the recorded offsets. The entries are rebuilt lazily on the next SkipTo */
+static void IndexBlock_InvalidateSkips(IndexBlock *blk) {
+  rm_free(blk->skips);
+  blk->skips = NULL;
+  blk->numSkips = blk->skipsCap = 0;
+}
+
+/* Release a block's data buffer, respecting arena-borrowed buffers which are not individually
+ * owned. The block is left flagged as owning whatever buffer is installed next */
+static void IndexBlock_ReleaseBuffer(IndexBlock *blk) {
+  if (!blk->bufBorrowed) {
+    Buffer_Free(&blk->buf);
+  }
+  blk->bufBorrowed = 0;
+}
+
 void indexBlock_Free(IndexBlock *blk) {
-  Buffer_Free(&blk->buf);
+  IndexBlock_ReleaseBuffer(blk);
+  IndexBlock_InvalidateSkips(blk);
+}
+
+/* Append a skip entry to a block. `docId` is the id of the record starting at `offset`, and
+ * `prevId` the id of the record before it */
+static void IndexBlock_AddSkip(IndexBlock *blk, t_docId docId, t_docId prevId, uint32_t offset) {
+  if (blk->numSkips == blk->skipsCap) {
+    blk->skipsCap = blk->skipsCap ? blk->skipsCap * 2 : 4;
+    blk->skips = rm_realloc(blk->skips, blk->skipsCap * sizeof(*blk->skips));
+  }
+  blk->skips[blk->numSkips++] = (IndexBlockSkipEntry){.docId = docId, .prevId = prevId, .offset = offset};
+}
+
+/* Drop every posting in place: blocks are freed wholesale and one fresh block
+ * remains. Callers hold the exclusivity block swaps require; the gc-marker
+ * bump routes parked readers through the reseek path, where the now-empty
+ * index immediately yields EOF. Used by partition drops, where freeing the
+ * index itself would leave sleeping readers with a dangling pointer */
+void InvertedIndex_Reset(InvertedIndex *idx) {
+  TotalIIBlocks -= idx->size;
+  for (uint32_t i = 0; i < idx->size; i++) {
+    indexBlock_Free(&idx->blocks[i]);
+  }
+  rm_free(idx->loadArena);
+  idx->loadArena = NULL;
+  rm_free(idx->blocks);
+  idx->blocks = NULL;
+  idx->size = 0;
+  idx->lastId = 0;
+  idx->numDocs = 0;
+  idx->maxFreq = 0;
+  idx->gcMarker++;
+  InvertedIndex_AddBlock(idx, 0);
 }
 
 void InvertedIndex_Free(void *ctx) {
@@ -72,6 +140,7 @@ void InvertedIndex_Free(void *ctx) {
   for (uint32_t i = 0; i < idx->size; i++) {
     indexBlock_Free(&idx->blocks[i]);
   }
+  rm_free(idx->loadArena);
   rm_free(idx->blocks);
   rm_free(idx);
 }
@@ -86,6 +155,8 @@ static void IR_SetAtEnd(IndexReader *r, int value) {
 
 /* A callback called from the ConcurrentSearchCtx after regaining execution and reopening the
  * underlying term key. We check for changes in the underlying key, or possible deletion of it */
+static void indexReaderRevalidate(IndexReader *ir);
+
 void IndexReader_OnReopen(RedisModuleKey *k, void *privdata) {
 
   IndexReader *ir = privdata;
@@ -99,20 +170,38 @@ void IndexReader_OnReopen(RedisModuleKey *k, void *privdata) {
 
   // If the key is valid, we just reset the reader's buffer reader to the current block pointer
   ir->idx = RedisModule_ModuleTypeGetValue(k);
+  indexReaderRevalidate(ir);
+}
+
+/* Reopen callback for indexes living in the spec's own dictionary
+ * (Index_TermsInSpec / keysDict). There is no key to revalidate - the index
+ * lives and dies with the spec - but the GC may still have rewritten blocks
+ * while the reader slept, so the same marker check applies */
+void IndexReader_OnReopenSpec(RedisModuleKey *k, void *privdata) {
+  IndexReader *ir = privdata;
+  (void)k;
+  if (!ir->idx) {
+    return;
+  }
+  indexReaderRevalidate(ir);
+}
 
+static void indexReaderRevalidate(IndexReader *ir) {
   // the gc marker tells us if there is a chance the keys has undergone GC while we were asleep
   if (ir->gcMarker == ir->idx->gcMarker) {
     // no GC - we just go to the same offset we were at
     size_t offset = ir->br.pos;
-    ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
+    IndexReader_EnterBlock(ir);
     ir->br.pos = offset;
   } else {
     // if there has been a GC cycle on this key while we were asleep, the offset might not be valid
     // anymore. This means that we need to seek to last docId we were at
 
-    // reset the state of the reader
+    // reset the state of the reader. Block compaction may have removed blocks entirely, so the
+    // remembered block index cannot be trusted either - restart from the first block
     t_docId lastId = ir->lastId;
-    ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
+    ir->currentBlock = 0;
+    IndexReader_EnterBlock(ir);
     ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
 
     // seek to the previous last id
@@ -129,6 +218,39 @@ void IndexReader_OnReopen(RedisModuleKey *k, void *privdata) {
  *
  ******************************************************************************/
 
+/******************************************************************************
+ * Frequency quantization (Index_QuantizedFreqs).
+ *
+ * Frequencies are mapped to <= 6 bit log buckets before encoding: values up
+ * to 32 are kept exact, larger ones bucket to powers of two. Every codec then
+ * encodes the freq field in a single byte, and decode expands the bucket back
+ * to its representative value.
+ ******************************************************************************/
+
+#define FREQ_QUANT_EXACT_MAX 32
+// Largest bucket whose representative still fits 32 bits (32 << 26 == 2^31)
+#define FREQ_QUANT_MAX_BUCKET (FREQ_QUANT_EXACT_MAX + 26)
+
+static inline uint32_t FreqQuantize(uint32_t freq) {
+  if (freq <= FREQ_QUANT_EXACT_MAX) {
+    return freq;
+  }
+  uint32_t bucket = FREQ_QUANT_EXACT_MAX;
+  freq >>= 5;
+  while (freq) {
+    ++bucket;
+    freq >>= 1;
+  }
+  return bucket > FREQ_QUANT_MAX_BUCKET ? FREQ_QUANT_MAX_BUCKET : bucket;
+}
+
+static inline uint32_t FreqExpand(uint32_t bucket) {
+  if (bucket <= FREQ_QUANT_EXACT_MAX) {
+    return bucket;
+  }
+  return (uint32_t)FREQ_QUANT_EXACT_MAX << (bucket - FREQ_QUANT_EXACT_MAX);
+}
+
 #define ENCODER(f) static size_t f(BufferWriter *bw, uint32_t delta, RSIndexResult *res)
 
 // 1. Encode the full data of the record, delta, frequency, field mask and offset vector
@@ -206,6 +328,140 @@ ENCODER(encodeDocIdsOnly) {
   return WriteVarint(delta, bw);
 }
 
+/******************************************************************************
+ * Packed docids (Index_PackedDocIds).
+ *
+ * Blocks of such indexes begin with a one-byte tag. While a block is being
+ * written the tag is 0 and deltas are appended as plain varints. Once the
+ * block completes (INDEX_BLOCK_SIZE records) it is re-encoded in one pass to
+ * frame-of-reference form: the tag becomes the fixed byte width (1-4) of the
+ * largest delta, followed by all deltas at that width. Decoding a packed
+ * block is branch-free per record, and dense monotone id runs take 1-2 bytes
+ * per document instead of a varint.
+ ******************************************************************************/
+
+#define PACKED_TAG_VARINT 0
+
+/* Tag bit marking an "array" container: the payload holds absolute offsets from the block's
+ * firstId rather than chained deltas (the lower nibble is still the byte width). Offsets make
+ * every record independently addressable, so membership within a block becomes a binary search
+ * instead of a linear decode - the same access pattern a roaring array container provides for
+ * dense, tag-like terms. The pack step picks this form whenever it is no larger than the
+ * delta form */
+#define PACKED_TAG_ARRAY 0x10
+
+#define IndexBlock_PackedTag(blk) \
+  ((blk)->buf.offset ? *(uint8_t *)(blk)->buf.data : PACKED_TAG_VARINT)
+
+/* Read the i'th fixed-width value of a packed container */
+static inline uint32_t packedReadAt(const char *data, uint8_t width, uint32_t i) {
+  uint32_t v = 0;
+  memcpy(&v, data + 1 + (size_t)i * width, width);
+  return v;
+}
+
+// 8b. Packed docids: the tag byte is laid down on the first write to a block
+ENCODER(encodeDocIdsOnlyPacked) {
+  size_t sz = 0;
+  if (bw->buf->offset == 0) {
+    sz += Buffer_WriteU8(bw, PACKED_TAG_VARINT);
+  }
+  sz += WriteVarint(delta, bw);
+  return sz;
+}
+
+/* Re-encode a completed varint-tagged block to fixed-width deltas. Called once per block, when
+ * the writer moves on to a new one (and by GC after repairing a block) */
+void IndexBlock_PackDocIds(IndexBlock *blk) {
+  if (IndexBlock_PackedTag(blk) != PACKED_TAG_VARINT || blk->numDocs == 0) {
+    return;
+  }
+
+  uint32_t deltas[INDEX_BLOCK_SIZE];
+  uint32_t maxDelta = 0;
+  uint16_t n = 0;
+  BufferReader br = NewBufferReader(&blk->buf);
+  Buffer_Skip(&br, 1);
+  while (!BufferReader_AtEnd(&br) && n < INDEX_BLOCK_SIZE) {
+    deltas[n] = ReadVarint(&br);
+    if (deltas[n] > maxDelta) {
+      maxDelta = deltas[n];
+    }
+    ++n;
+  }
+  if (!BufferReader_AtEnd(&br)) {
+    // More records than a block should ever hold - leave it in varint form rather than
+    // dropping postings
+    return;
+  }
+
+#define PACKED_BYTE_WIDTH(max) \
+  ((max) <= 0xFF ? 1 : (max) <= 0xFFFF ? 2 : (max) <= 0xFFFFFF ? 3 : 4)
+
+  uint8_t width = PACKED_BYTE_WIDTH(maxDelta);
+
+  // Prefer the array container when the whole id range of the block fits the same byte width:
+  // equal size, but seekable by binary search
+  uint64_t range = blk->lastId - blk->firstId;
+  uint8_t tag = width;
+  // The offset conversion below requires the first record to be the usual delta 0 from firstId;
+  // anything else (e.g. a legacy absolute-id first record) stays in delta form
+  if (n && deltas[0] == 0 && range <= UINT32_MAX && PACKED_BYTE_WIDTH(range) <= width) {
+    width = PACKED_BYTE_WIDTH(range);
+    tag = PACKED_TAG_ARRAY | width;
+    // Convert chained deltas to absolute offsets from firstId
+    for (uint16_t i = 1; i < n; i++) {
+      deltas[i] += deltas[i - 1];
+    }
+  }
+
+  Buffer packed;
+  Buffer_Init(&packed, 1 + n * width);
+  BufferWriter bw = NewBufferWriter(&packed);
+  Buffer_WriteU8(&bw, tag);
+  for (uint16_t i = 0; i < n; i++) {
+    Buffer_Write(&bw, &deltas[i], width);
+  }
+
+  IndexBlock_ReleaseBuffer(blk);
+  blk->buf = packed;
+  // The rewrite moved every record, so any skip entries are stale
+  IndexBlock_InvalidateSkips(blk);
+}
+
+/* Expand a packed block back to the varint-tagged form, so it can be repaired record by record
+ * with the regular encoder */
+static void IndexBlock_UnpackDocIds(IndexBlock *blk) {
+  uint8_t tag = IndexBlock_PackedTag(blk);
+  if (tag == PACKED_TAG_VARINT) {
+    return;
+  }
+  uint8_t width = tag & 0x0F;
+
+  Buffer unpacked;
+  Buffer_Init(&unpacked, blk->buf.offset);
+  BufferWriter bw = NewBufferWriter(&unpacked);
+  Buffer_WriteU8(&bw, PACKED_TAG_VARINT);
+  BufferReader br = NewBufferReader(&blk->buf);
+  Buffer_Skip(&br, 1);
+  uint32_t prev = 0;
+  while (!BufferReader_AtEnd(&br)) {
+    uint32_t val = 0;
+    Buffer_Read(&br, &val, width);
+    if (tag & PACKED_TAG_ARRAY) {
+      // Array containers hold absolute offsets; convert back to deltas
+      WriteVarint(val - prev, &bw);
+      prev = val;
+    } else {
+      WriteVarint(val, &bw);
+    }
+  }
+
+  IndexBlock_ReleaseBuffer(blk);
+  blk->buf = unpacked;
+  IndexBlock_InvalidateSkips(blk);
+}
+
 /**
  * DeltaType{1,2} Float{3}(=1), IsInf{4}   -  Sign{5} IsDouble{6} Unused{7,8}
  * DeltaType{1,2} Float{3}(=0), Tiny{4}(1) -  Number{5,6,7,8}
@@ -398,6 +654,9 @@ IndexEncoder InvertedIndex_GetEncoder(IndexFlags flags) {
     case Index_DocIdsOnly:
       return encodeDocIdsOnly;
 
+    case Index_DocIdsOnly | Index_PackedDocIds:
+      return encodeDocIdsOnlyPacked;
+
     case Index_StoreNumeric:
       return encodeNumeric;
 
@@ -412,6 +671,7 @@ IndexEncoder InvertedIndex_GetEncoder(IndexFlags flags) {
 /* Write a forward-index entry to an index writer */
 size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder, t_docId docId,
                                        RSIndexResult *entry) {
+  PERF_SCOPE(PERFCTR_II_WRITE);
 
   // do not allow the same document to be written to the same index twice.
   // this can happen with duplicate tags for example
@@ -422,6 +682,9 @@ size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder,
 
   // see if we need to grow the current block
   if (blk->numDocs >= INDEX_BLOCK_SIZE) {
+    if (idx->flags & Index_PackedDocIds) {
+      IndexBlock_PackDocIds(blk);
+    }
     blk = InvertedIndex_AddBlock(idx, docId);
   } else if (blk->numDocs == 0) {
     blk->firstId = blk->lastId = docId;
@@ -429,10 +692,36 @@ size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder,
 
   delta = docId - blk->lastId;
   if (delta > UINT32_MAX) {
+    if (idx->flags & Index_PackedDocIds) {
+      IndexBlock_PackDocIds(blk);
+    }
     blk = InvertedIndex_AddBlock(idx, docId);
     delta = 0;
   }
 
+  // Every N'th record gets a skip entry, so SkipTo can jump into the block
+  if (blk->numDocs && blk->numDocs % INDEX_BLOCK_SKIP_INTERVAL == 0) {
+    IndexBlock_AddSkip(blk, docId, blk->lastId, blk->buf.offset);
+  }
+
+  // Track the block's and index's maximum score impact. Quantized buckets expand to their
+  // representative (an upper bound of the original frequency)
+  uint32_t impact =
+      (idx->flags & Index_QuantizedFreqs) ? FreqExpand(entry->freq) : (uint32_t)entry->freq;
+  if (impact > blk->maxFreq) {
+    blk->maxFreq = impact;
+  }
+  if (impact > idx->maxFreq) {
+    idx->maxFreq = impact;
+  }
+  blk->fieldMaskUnion |= FoldFieldMask(entry->fieldMask);
+
+  // One bulk reserve per entry: a qint group is at most 17 bytes, a wide
+  // (128-bit) field mask varint up to 19 and a varint length 5, plus the
+  // offsets payload - the encoder's writes then never grow the buffer
+  // mid-entry, and each check after this one is a predicted-taken branch
+  Buffer_Reserve(&blk->buf, 64 + entry->offsetsSz);
+
   BufferWriter bw = NewBufferWriter(&blk->buf);
 
   // printf("Writing docId %llu, delta %llu, flags %x\n", docId, delta, (int)idx->flags);
@@ -447,18 +736,59 @@ size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder,
 }
 
 /** Write a forward-index entry to the index */
+/* Per-thread scratch for Index_PackedOffsets: the forward index accumulates
+ * positions as varint deltas, and each posting's vector is re-encoded
+ * Elias-Fano here, once, on its way into the index */
+static __thread struct {
+  uint32_t *positions;
+  size_t cap;
+  Buffer out;
+} packedOffsets_tls;
+
+static void transcodePackedOffsets(RSIndexResult *rec) {
+  Buffer buf = {.data = (char *)rec->term.offsets.data,
+                .offset = rec->term.offsets.len,
+                .cap = rec->term.offsets.len};
+  BufferReader br = NewBufferReader(&buf);
+  uint32_t last = 0;
+  size_t n = 0;
+  while (!BufferReader_AtEnd(&br)) {
+    if (n == packedOffsets_tls.cap) {
+      packedOffsets_tls.cap = packedOffsets_tls.cap ? packedOffsets_tls.cap * 2 : 256;
+      packedOffsets_tls.positions =
+          rm_realloc(packedOffsets_tls.positions, packedOffsets_tls.cap * sizeof(uint32_t));
+    }
+    last += ReadVarint(&br);
+    packedOffsets_tls.positions[n++] = last;
+  }
+  if (!n) {
+    return;
+  }
+  if (!packedOffsets_tls.out.data) {
+    Buffer_Init(&packedOffsets_tls.out, 256);
+  }
+  size_t len = OffsetVector_PackedEncode(packedOffsets_tls.positions, n, &packedOffsets_tls.out);
+  rec->term.offsets.data = packedOffsets_tls.out.data;
+  rec->term.offsets.len = len;
+  rec->offsetsSz = len;
+}
+
 size_t InvertedIndex_WriteForwardIndexEntry(InvertedIndex *idx, IndexEncoder encoder,
                                             ForwardIndexEntry *ent) {
   RSIndexResult rec = {.type = RSResultType_Term,
                        .docId = ent->docId,
                        .offsetsSz = VVW_GetByteLength(ent->vw),
-                       .freq = ent->freq,
+                       .freq = (idx->flags & Index_QuantizedFreqs) ? FreqQuantize(ent->freq)
+                                                                   : ent->freq,
                        .fieldMask = ent->fieldMask};
 
   rec.term.term = NULL;
   if (ent->vw) {
     rec.term.offsets.data = VVW_GetByteData(ent->vw);
     rec.term.offsets.len = VVW_GetByteLength(ent->vw);
+    if ((idx->flags & Index_PackedOffsets) && rec.term.offsets.len) {
+      transcodePackedOffsets(&rec);
+    }
   }
   return InvertedIndex_WriteEntryGeneric(idx, encoder, ent->docId, &rec);
 }
@@ -474,12 +804,100 @@ size_t InvertedIndex_WriteNumericEntry(InvertedIndex *idx, t_docId docId, double
   return InvertedIndex_WriteEntryGeneric(idx, encodeNumeric, docId, &rec);
 }
 
+int IndexBlock_EnsureDecompressed(IndexBlock *blk) {
+  if (!blk->compressed) {
+    return 0;
+  }
+  mz_ulong rawLen = blk->rawLen;
+  char *raw = rm_malloc(rawLen ? rawLen : 1);
+  int rc = mz_uncompress((unsigned char *)raw, &rawLen, (const unsigned char *)blk->buf.data,
+                         blk->buf.offset);
+  if (rc != MZ_OK || rawLen != blk->rawLen) {
+    // cannot happen for images we compressed ourselves; keep the block usable
+    rm_free(raw);
+    return 0;
+  }
+  rm_free(blk->buf.data);  // compressed images are always owned, never borrowed
+  blk->buf.data = raw;
+  blk->buf.offset = blk->buf.cap = rawLen;
+  blk->compressed = 0;
+  return 1;
+}
+
+/* The coarse access clock the tiering sweep compares against (minutes). Set by
+ * the sweep; readers only stamp it, so a disabled tiering config costs a
+ * single store per block entry */
+uint32_t IndexTieringClock_g;
+
+
+__attribute__((constructor)) static void initTieringClock() {
+  IndexTieringClock_g = (uint32_t)(time(NULL) / 60);
+}
+
+/* Every reader lands on a block through here: stamp the access clock and
+ * inflate a tier-compressed image before anything reads it */
+static inline void IndexReader_EnterBlock(IndexReader *ir) {
+  IndexBlock *blk = &IR_CURRENT_BLOCK(ir);
+  ir->stats.blocksEntered++;
+  blk->touchMin = IndexTieringClock_g;
+  IndexBlock_EnsureDecompressed(blk);
+  ir->br = NewBufferReader(&blk->buf);
+}
+
 static void IndexReader_AdvanceBlock(IndexReader *ir) {
   ir->currentBlock++;
-  ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
+  IndexReader_EnterBlock(ir);
   ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
 }
 
+/* Advance past a block without entering it: block-skip loops consult only the
+ * header fields (maxFreq, fieldMaskUnion, ids), so a skipped tier-compressed
+ * block must stay compressed and untouched. Callers re-enter afterwards */
+static void IndexReader_PassBlock(IndexReader *ir) {
+  ir->currentBlock++;
+  ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
+}
+
+/* WAND block skipping: while the current block's best possible score cannot enter the query's
+ * top-k heap, move on to the next one. Blocks with unknown impact (maxFreq 0) are never
+ * skipped, and the last block is always decoded so EOF handling stays in one place */
+static void IndexReader_SkipLowImpactBlocks(IndexReader *ir) {
+  if (!ir->maxScoreThresholdRef || ir->impactFactor == 0) {
+    return;
+  }
+  double threshold = *ir->maxScoreThresholdRef;
+  if (threshold <= 0) {
+    return;
+  }
+  int passed = 0;
+  while (ir->currentBlock + 1 < ir->idx->size && IR_CURRENT_BLOCK(ir).maxFreq &&
+         IR_CURRENT_BLOCK(ir).maxFreq * ir->impactFactor < threshold) {
+    IndexReader_PassBlock(ir);
+    passed = 1;
+  }
+  if (passed) {
+    IndexReader_EnterBlock(ir);
+  }
+}
+
+/* Field-mask block skipping: while the current block holds no entry of the queried fields,
+ * move on to the next one. Blocks with an unknown union (0, e.g. RDB-loaded) are never
+ * skipped, and the last block is always decoded so EOF handling stays in one place */
+static void IndexReader_SkipNonMatchingFieldBlocks(IndexReader *ir) {
+  if (!ir->queryFieldMaskFolded) {
+    return;
+  }
+  int passed = 0;
+  while (ir->currentBlock + 1 < ir->idx->size && IR_CURRENT_BLOCK(ir).fieldMaskUnion &&
+         !(IR_CURRENT_BLOCK(ir).fieldMaskUnion & ir->queryFieldMaskFolded)) {
+    IndexReader_PassBlock(ir);
+    passed = 1;
+  }
+  if (passed) {
+    IndexReader_EnterBlock(ir);
+  }
+}
+
 /******************************************************************************
  * Index Decoder Implementations.
  *
@@ -505,98 +923,113 @@ static void IndexReader_AdvanceBlock(IndexReader *ir) {
 
 #define CHECK_FLAGS(ctx, res) return ((res->fieldMask & ctx->num) != 0)
 
-DECODER(readFreqsFlags) {
-  qint_decode3(br, (uint32_t *)&res->docId, &res->freq, (uint32_t *)&res->fieldMask);
-  // qint_decode3(br, &res->docId, &res->freq, &res->fieldMask);
-  CHECK_FLAGS(ctx, res);
-}
+/* Mask-checking decoders come in two specializations generated from one body:
+ * the base form tests the record's field mask against the query's, and the
+ * MatchAll twin - swapped in at reader creation when the query mask covers
+ * every field - returns unconditionally, removing the per-record test and its
+ * branch from the decode loop */
+#define MASK_DECODER_PAIR(name, ...) \
+  DECODER(name) {                    \
+    __VA_ARGS__                      \
+    CHECK_FLAGS(ctx, res);           \
+  }                                  \
+  DECODER(name##_MatchAll) {         \
+    __VA_ARGS__                      \
+    (void)ctx;                       \
+    return 1;                        \
+  }
+
+MASK_DECODER_PAIR(readFreqsFlags,
+  qint_decode3(br, (uint32_t *)&res->docId, &res->freq, (uint32_t *)&res->fieldMask);)
 
-DECODER(readFreqsFlagsWide) {
+MASK_DECODER_PAIR(readFreqsFlagsWide,
   uint32_t maskSz;
   qint_decode2(br, (uint32_t *)&res->docId, &res->freq);
-  res->fieldMask = ReadVarintFieldMask(br);
-  CHECK_FLAGS(ctx, res);
-}
+  res->fieldMask = ReadVarintFieldMask(br);)
 
-DECODER(readFreqOffsetsFlags) {
+MASK_DECODER_PAIR(readFreqOffsetsFlags,
   qint_decode4(br, (uint32_t *)&res->docId, &res->freq, (uint32_t *)&res->fieldMask,
                &res->offsetsSz);
   res->term.offsets.data = BufferReader_Current(br);
   res->term.offsets.len = res->offsetsSz;
-  Buffer_Skip(br, res->offsetsSz);
-  CHECK_FLAGS(ctx, res);
-}
+  Buffer_Skip(br, res->offsetsSz);)
+
+/* The seeker's per-record mask test is parameterized the same way as the
+ * decoders': the MatchAll twin tests nothing */
+#define SEEK_FOF_BODY(MASKTEST)                                \
+  uint32_t did = 0, freq = 0, offsz = 0;                       \
+  t_fieldMask fm = 0;                                          \
+  t_docId lastId = ir->lastId;                                 \
+  int rc = 0;                                                  \
+                                                               \
+  if (!BufferReader_AtEnd(br)) {                               \
+    size_t oldpos = br->pos;                                   \
+    qint_decode4(br, &did, &freq, (uint32_t *)&fm, &offsz);    \
+    Buffer_Skip(br, offsz);                                    \
+                                                               \
+    if (oldpos == 0 && did != 0) {                             \
+      /* Old RDB: Delta is not 0, but the docid itself */      \
+      lastId = did;                                            \
+    } else {                                                   \
+      lastId = (did += lastId);                                \
+    }                                                          \
+                                                               \
+    if (did > expid) {                                         \
+      /* overshoot */                                          \
+      goto done;                                               \
+    } else if (did == expid && (MASKTEST)) {                   \
+      rc = 1;                                                  \
+      goto done;                                               \
+    }                                                          \
+  }                                                            \
+                                                               \
+  while (!BufferReader_AtEnd(br)) {                            \
+    qint_decode4(br, &did, &freq, (uint32_t *)&fm, &offsz);    \
+    Buffer_Skip(br, offsz);                                    \
+    lastId = (did += lastId);                                  \
+    if (did > expid) {                                         \
+      /* Overshoot! */                                         \
+      break;                                                   \
+    } else if (did < expid) {                                  \
+      continue;                                                \
+    } else {                                                   \
+      /* equal! */                                             \
+      if (!(MASKTEST)) {                                       \
+        continue;                                              \
+      }                                                        \
+      rc = 1;                                                  \
+      break;                                                   \
+    }                                                          \
+  }                                                            \
+                                                               \
+done:                                                          \
+  res->docId = did;                                            \
+  res->freq = freq;                                            \
+  res->fieldMask = fm;                                         \
+  res->offsetsSz = offsz;                                      \
+  res->term.offsets.data = BufferReader_Current(br) - offsz;   \
+  res->term.offsets.len = offsz;                               \
+                                                               \
+  /* sync back! */                                             \
+  ir->lastId = lastId;                                         \
+  return rc;
 
 SKIPPER(seekFreqOffsetsFlags) {
-  uint32_t did = 0, freq = 0, offsz = 0;
-  t_fieldMask fm = 0;
-  t_docId lastId = ir->lastId;
-  int rc = 0;
-
-  if (!BufferReader_AtEnd(br)) {
-    size_t oldpos = br->pos;
-    qint_decode4(br, &did, &freq, (uint32_t *)&fm, &offsz);
-    Buffer_Skip(br, offsz);
-
-    if (oldpos == 0 && did != 0) {
-      // Old RDB: Delta is not 0, but the docid itself
-      lastId = did;
-    } else {
-      lastId = (did += lastId);
-    }
-
-    if (did > expid) {
-      // overshoot
-      goto done;
-    } else if (did == expid && (ctx->num & fm)) {
-      rc = 1;
-      goto done;
-    }
-  }
-
-  if (!BufferReader_AtEnd(br)) {
-    while (!BufferReader_AtEnd(br)) {
-      qint_decode4(br, &did, &freq, (uint32_t *)&fm, &offsz);
-      Buffer_Skip(br, offsz);
-      lastId = (did += lastId);
-      if (did > expid) {
-        // Overshoot!
-        break;
-      } else if (did < expid) {
-        continue;
-      } else {
-        // equal!
-        if (!(ctx->num & fm)) {
-          continue;
-        }
-        rc = 1;
-        break;
-      }
-    }
-  }
-
-done:
-  res->docId = did;
-  res->freq = freq;
-  res->fieldMask = fm;
-  res->offsetsSz = offsz;
-  res->term.offsets.data = BufferReader_Current(br) - offsz;
-  res->term.offsets.len = offsz;
+  SEEK_FOF_BODY(ctx->num & fm)
+}
 
-  // sync back!
-  ir->lastId = lastId;
-  return rc;
+SKIPPER(seekFreqOffsetsFlags_MatchAll) {
+  (void)ctx;
+  SEEK_FOF_BODY(1)
 }
 
-DECODER(readFreqOffsetsFlagsWide) {
+MASK_DECODER_PAIR(readFreqOffsetsFlagsWide,
   uint32_t maskSz;
 
   qint_decode3(br, (uint32_t *)&res->docId, &res->freq, &res->offsetsSz);
   res->fieldMask = ReadVarintFieldMask(br);
   res->term.offsets = (RSOffsetVector){.data = BufferReader_Current(br), .len = res->offsetsSz};
-  Buffer_Skip(br, res->offsetsSz);
-  CHECK_FLAGS(ctx, res);
-}
+  Buffer_Skip(br, res->offsetsSz);)
 
 // special decoder for decoding numeric results
 DECODER(readNumeric) {
@@ -650,34 +1083,26 @@ DECODER(readFreqs) {
   return 1;
 }
 
-DECODER(readFlags) {
-  qint_decode2(br, (uint32_t *)&res->docId, (uint32_t *)&res->fieldMask);
-  CHECK_FLAGS(ctx, res);
-}
+MASK_DECODER_PAIR(readFlags,
+  qint_decode2(br, (uint32_t *)&res->docId, (uint32_t *)&res->fieldMask);)
 
-DECODER(readFlagsWide) {
+MASK_DECODER_PAIR(readFlagsWide,
   res->docId = ReadVarint(br);
   res->freq = 1;
-  res->fieldMask = ReadVarintFieldMask(br);
-  CHECK_FLAGS(ctx, res);
-}
+  res->fieldMask = ReadVarintFieldMask(br);)
 
-DECODER(readFlagsOffsets) {
+MASK_DECODER_PAIR(readFlagsOffsets,
   qint_decode3(br, (uint32_t *)&res->docId, (uint32_t *)&res->fieldMask, &res->offsetsSz);
   res->term.offsets = (RSOffsetVector){.data = BufferReader_Current(br), .len = res->offsetsSz};
-  Buffer_Skip(br, res->offsetsSz);
-  CHECK_FLAGS(ctx, res);
-}
+  Buffer_Skip(br, res->offsetsSz);)
 
-DECODER(readFlagsOffsetsWide) {
+MASK_DECODER_PAIR(readFlagsOffsetsWide,
 
   qint_decode2(br, (uint32_t *)&res->docId, &res->offsetsSz);
   res->fieldMask = ReadVarintFieldMask(br);
   res->term.offsets = (RSOffsetVector){.data = BufferReader_Current(br), .len = res->offsetsSz};
 
-  Buffer_Skip(br, res->offsetsSz);
-  CHECK_FLAGS(ctx, res);
-}
+  Buffer_Skip(br, res->offsetsSz);)
 
 DECODER(readOffsets) {
   qint_decode2(br, (uint32_t *)&res->docId, &res->offsetsSz);
@@ -699,6 +1124,219 @@ DECODER(readDocIdsOnly) {
   return 1;  // Don't care about field mask
 }
 
+DECODER(readDocIdsOnlyPacked) {
+  if (br->pos == 0) {
+    // Consume the block's tag byte
+    Buffer_Skip(br, 1);
+  }
+  uint8_t tag = *(uint8_t *)br->buf->data;
+  if (tag == PACKED_TAG_VARINT) {
+    res->docId = ReadVarint(br);
+  } else if (tag & PACKED_TAG_ARRAY) {
+    // Absolute offsets: the delta is the difference from the previous record, which is
+    // addressable by position
+    uint8_t width = tag & 0x0F;
+    uint32_t i = (br->pos - 1) / width;
+    uint32_t cur = packedReadAt(br->buf->data, width, i);
+    res->docId = i ? cur - packedReadAt(br->buf->data, width, i - 1) : cur;
+    Buffer_Skip(br, width);
+  } else {
+    uint32_t delta = 0;
+    Buffer_Read(br, &delta, tag);
+    res->docId = delta;
+  }
+  res->freq = 1;
+  return 1;  // Don't care about field mask
+}
+
+/* Seeker for packed docid blocks. Array containers are binary-searched - for a dense term this
+ * makes SkipTo within a block O(log n) rather than a linear decode; other containers fall back
+ * to a scan */
+SKIPPER(seekDocIdsOnlyPacked) {
+  IndexBlock *blk = &IR_CURRENT_BLOCK(ir);
+  uint8_t tag = IndexBlock_PackedTag(blk);
+
+  if (tag & PACKED_TAG_ARRAY) {
+    uint8_t width = tag & 0x0F;
+    const char *data = blk->buf.data;
+    uint32_t nrec = (blk->buf.offset - 1) / width;
+    uint32_t target = expid > blk->firstId ? expid - blk->firstId : 0;
+
+    // Find the first record at or after the target, starting from the reader's position
+    uint32_t bottom = br->pos > 1 ? (br->pos - 1) / width : 0;
+    uint32_t top = nrec;
+    while (bottom < top) {
+      uint32_t mid = (bottom + top) / 2;
+      if (packedReadAt(data, width, mid) < target) {
+        bottom = mid + 1;
+      } else {
+        top = mid;
+      }
+    }
+
+    res->freq = 1;
+    if (bottom == nrec) {
+      // Every record in the block precedes the target
+      br->pos = blk->buf.offset;
+      ir->lastId = res->docId = blk->firstId + packedReadAt(data, width, nrec - 1);
+      return 0;
+    }
+    uint32_t val = packedReadAt(data, width, bottom);
+    br->pos = 1 + (size_t)(bottom + 1) * width;
+    ir->lastId = res->docId = blk->firstId + val;
+    return res->docId == expid;
+  }
+
+  // Varint or delta container: linear scan
+  while (!BufferReader_AtEnd(br)) {
+    size_t pos = br->pos;
+    readDocIdsOnlyPacked(br, ctx, res);
+    t_docId id = calculateId(ir->lastId, *(uint32_t *)&res->docId, pos == 0);
+    ir->lastId = res->docId = id;
+    if (id >= expid) {
+      return id == expid;
+    }
+  }
+  res->docId = ir->lastId;
+  res->freq = 1;
+  return 0;
+}
+
+/******************************************************************************
+ * Offset-skipping decoder variants. When the query carries no phrase, slop or
+ * highlight requirement, the offset vectors are dead weight: these twins of
+ * the offsets-bearing decoders hop over the varint run without publishing it.
+ ******************************************************************************/
+
+MASK_DECODER_PAIR(readFreqOffsetsFlagsSkipOff,
+  uint32_t offsz;
+  qint_decode4(br, (uint32_t *)&res->docId, &res->freq, (uint32_t *)&res->fieldMask, &offsz);
+  res->term.offsets = (RSOffsetVector){.data = NULL, .len = 0};
+  res->offsetsSz = 0;
+  Buffer_Skip(br, offsz);)
+
+MASK_DECODER_PAIR(readFreqOffsetsFlagsWideSkipOff,
+  uint32_t offsz;
+  qint_decode3(br, (uint32_t *)&res->docId, &res->freq, &offsz);
+  res->fieldMask = ReadVarintFieldMask(br);
+  res->term.offsets = (RSOffsetVector){.data = NULL, .len = 0};
+  res->offsetsSz = 0;
+  Buffer_Skip(br, offsz);)
+
+MASK_DECODER_PAIR(readFlagsOffsetsSkipOff,
+  uint32_t offsz;
+  qint_decode3(br, (uint32_t *)&res->docId, (uint32_t *)&res->fieldMask, &offsz);
+  res->term.offsets = (RSOffsetVector){.data = NULL, .len = 0};
+  res->offsetsSz = 0;
+  Buffer_Skip(br, offsz);)
+
+MASK_DECODER_PAIR(readFlagsOffsetsWideSkipOff,
+  uint32_t offsz;
+  qint_decode2(br, (uint32_t *)&res->docId, &offsz);
+  res->fieldMask = ReadVarintFieldMask(br);
+  res->term.offsets = (RSOffsetVector){.data = NULL, .len = 0};
+  res->offsetsSz = 0;
+  Buffer_Skip(br, offsz);)
+
+DECODER(readOffsetsSkipOff) {
+  uint32_t offsz;
+  qint_decode2(br, (uint32_t *)&res->docId, &offsz);
+  res->term.offsets = (RSOffsetVector){.data = NULL, .len = 0};
+  res->offsetsSz = 0;
+  Buffer_Skip(br, offsz);
+  return 1;
+}
+
+DECODER(readFreqsOffsetsSkipOff) {
+  uint32_t offsz;
+  qint_decode3(br, (uint32_t *)&res->docId, &res->freq, &offsz);
+  res->term.offsets = (RSOffsetVector){.data = NULL, .len = 0};
+  res->offsetsSz = 0;
+  Buffer_Skip(br, offsz);
+  return 1;
+}
+
+/* Swap the reader's decoder for the offset-skipping twin of its codec, when the query
+ * consumes no term offsets. The seeker is unaffected - it never publishes offsets to
+ * anyone who cares */
+void IndexReader_SetSkipOffsetVectors(IndexReader *ir) {
+  // a reader already on the MatchAll twins must stay on them
+  const int matchAll = ir->decoderCtx.num == RS_FIELDMASK_ALL;
+  switch ((uint32_t)ir->idx->flags & INDEX_STORAGE_MASK) {
+    case Index_StoreFreqs | Index_StoreFieldFlags | Index_StoreTermOffsets:
+      ir->decoders.decoder =
+          matchAll ? readFreqOffsetsFlagsSkipOff_MatchAll : readFreqOffsetsFlagsSkipOff;
+      break;
+    case Index_StoreFreqs | Index_StoreFieldFlags | Index_StoreTermOffsets | Index_WideSchema:
+      ir->decoders.decoder =
+          matchAll ? readFreqOffsetsFlagsWideSkipOff_MatchAll : readFreqOffsetsFlagsWideSkipOff;
+      break;
+    case Index_StoreFieldFlags | Index_StoreTermOffsets:
+      ir->decoders.decoder = matchAll ? readFlagsOffsetsSkipOff_MatchAll : readFlagsOffsetsSkipOff;
+      break;
+    case Index_StoreFieldFlags | Index_StoreTermOffsets | Index_WideSchema:
+      ir->decoders.decoder =
+          matchAll ? readFlagsOffsetsWideSkipOff_MatchAll : readFlagsOffsetsWideSkipOff;
+      break;
+    case Index_StoreTermOffsets:
+      ir->decoders.decoder = readOffsetsSkipOff;
+      break;
+    case Index_StoreFreqs | Index_StoreTermOffsets:
+      ir->decoders.decoder = readFreqsOffsetsSkipOff;
+      break;
+    default:
+      break;  // codec has no offsets to skip
+  }
+}
+
+/* Swap a filtered dispatch for its MatchAll twins. A reader whose query mask
+ * covers every field pays no per-record mask test; codecs without field flags
+ * are left alone - they never tested anything */
+static void indexDecoderSetMatchAll(IndexDecoderProcs *procs, uint32_t flags) {
+  switch (flags & INDEX_STORAGE_MASK) {
+    case Index_StoreFreqs | Index_StoreFieldFlags | Index_StoreTermOffsets:
+      procs->decoder = readFreqOffsetsFlags_MatchAll;
+      procs->seeker = seekFreqOffsetsFlags_MatchAll;
+      break;
+    case Index_StoreFreqs | Index_StoreFieldFlags | Index_StoreTermOffsets | Index_WideSchema:
+      procs->decoder = readFreqOffsetsFlagsWide_MatchAll;
+      break;
+    case Index_StoreFieldFlags:
+      procs->decoder = readFlags_MatchAll;
+      break;
+    case Index_StoreFieldFlags | Index_WideSchema:
+      procs->decoder = readFlagsWide_MatchAll;
+      break;
+    case Index_StoreFreqs | Index_StoreFieldFlags:
+      procs->decoder = readFreqsFlags_MatchAll;
+      break;
+    case Index_StoreFreqs | Index_StoreFieldFlags | Index_WideSchema:
+      procs->decoder = readFreqsFlagsWide_MatchAll;
+      break;
+    case Index_StoreFieldFlags | Index_StoreTermOffsets:
+      procs->decoder = readFlagsOffsets_MatchAll;
+      break;
+    case Index_StoreFieldFlags | Index_StoreTermOffsets | Index_WideSchema:
+      procs->decoder = readFlagsOffsetsWide_MatchAll;
+      break;
+    default:
+      break;
+  }
+}
+
+/* The reverse of IndexReader_SetSkipOffsetVectors: restore the offset-
+ * publishing decoder of the reader's codec (keeping the MatchAll
+ * specialization). Used by the highlighter, which scans with the skipping
+ * twins and re-enables offsets only for the final page's re-seeks */
+void IndexReader_SetKeepOffsetVectors(IndexReader *ir) {
+  const int matchAll = ir->decoderCtx.num == RS_FIELDMASK_ALL;
+  IndexDecoderProcs procs = InvertedIndex_GetDecoder((uint32_t)ir->idx->flags & INDEX_STORAGE_MASK);
+  if (matchAll) {
+    indexDecoderSetMatchAll(&procs, (uint32_t)ir->idx->flags);
+  }
+  ir->decoders = procs;
+}
+
 IndexDecoderProcs InvertedIndex_GetDecoder(uint32_t flags) {
 #define RETURN_DECODERS(reader, seeker_) \
   procs.decoder = reader;                \
@@ -733,6 +1371,9 @@ IndexDecoderProcs InvertedIndex_GetDecoder(uint32_t flags) {
     case Index_DocIdsOnly:
       RETURN_DECODERS(readDocIdsOnly, NULL);
 
+    case Index_DocIdsOnly | Index_PackedDocIds:
+      RETURN_DECODERS(readDocIdsOnlyPacked, seekDocIdsOnlyPacked);
+
     // (freqs, offsets)
     case Index_StoreFreqs | Index_StoreTermOffsets:
       RETURN_DECODERS(readFreqsOffsets, NULL);
@@ -864,17 +1505,30 @@ IndexCriteriaTester *IR_GetCriteriaTester(void *ctx) {
   return &irct->base;
 }
 
+/* Expand a quantized frequency bucket back to its representative value after decode */
+static inline void IR_ExpandFreq(IndexReader *ir) {
+  if (ir->idx->flags & Index_QuantizedFreqs) {
+    ir->record->freq = FreqExpand(ir->record->freq);
+  }
+}
+
 size_t IR_NumEstimated(void *ctx) {
   IndexReader *ir = ctx;
   return ir->idx->numDocs;
 }
 
 int IR_Read(void *ctx, RSIndexResult **e) {
+  PERF_SCOPE(PERFCTR_IR_READ);
 
   IndexReader *ir = ctx;
   if (IR_IS_AT_END(ir)) {
     goto eof;
   }
+  // If we are at a block boundary, the threshold may already rule the next blocks out
+  if (ir->br.pos == 0) {
+    IndexReader_SkipLowImpactBlocks(ir);
+    IndexReader_SkipNonMatchingFieldBlocks(ir);
+  }
   do {
 
     // if needed - skip to the next block (skipping empty blocks that may appear here due to GC)
@@ -884,9 +1538,12 @@ int IR_Read(void *ctx, RSIndexResult **e) {
         goto eof;
       }
       IndexReader_AdvanceBlock(ir);
+      IndexReader_SkipLowImpactBlocks(ir);
+      IndexReader_SkipNonMatchingFieldBlocks(ir);
     }
 
     size_t pos = ir->br.pos;
+    ir->stats.entriesDecoded++;
     int rv = ir->decoders.decoder(&ir->br, &ir->decoderCtx, ir->record);
     RSIndexResult *record = ir->record;
 
@@ -894,13 +1551,26 @@ int IR_Read(void *ctx, RSIndexResult **e) {
     uint32_t delta = *(uint32_t *)&record->docId;
     ir->lastId = record->docId = calculateId(ir->lastId, delta, pos == 0);
 
+    // Fine-grained preemption: one unit per decoded record, so even a long
+    // filtered run inside a single Read answers the timeout
+    if (RS_AccountCost(1)) {
+      goto eof;
+    }
+
     // The decoder also acts as a filter. A zero return value means that the
     // current record should not be processed.
     if (!rv) {
       continue;
     }
 
+    // Skip entries of deleted documents before they bounce through the whole pipeline
+    if (ir->sp && DocTable_IsDeleted(&ir->sp->docs, record->docId)) {
+      continue;
+    }
+
     ++ir->len;
+    ir->stats.entriesReturned++;
+    IR_ExpandFreq(ir);
     *e = record;
     return INDEXREAD_OK;
 
@@ -910,8 +1580,119 @@ eof:
   return INDEXREAD_EOF;
 }
 
+/* Batched variant of IR_Read: decode up to `limit` entries into the caller-provided arena in one
+ * call, amortizing the per-entry function call and validity checks of the iterator protocol.
+ * Returns the number of entries written; less than `limit` means the reader hit EOF. The results
+ * are shallow copies - term offsets still point into the index buffers, so they are only valid
+ * while the index is guaranteed not to move (i.e. until the GIL is yielded) */
+size_t IR_ReadMany(void *ctx, RSIndexResult *results, size_t limit) {
+  PERF_SCOPE(PERFCTR_IR_READ);
+  IndexReader *ir = ctx;
+  size_t n = 0;
+
+  if (IR_IS_AT_END(ir)) {
+    return 0;
+  }
+
+  while (n < limit) {
+    // skip to the next block, skipping empty blocks that may appear here due to GC
+    while (BufferReader_AtEnd(&ir->br)) {
+      if (ir->currentBlock + 1 == ir->idx->size) {
+        IR_SetAtEnd(ir, 1);
+        return n;
+      }
+      IndexReader_AdvanceBlock(ir);
+      IndexReader_SkipLowImpactBlocks(ir);
+      IndexReader_SkipNonMatchingFieldBlocks(ir);
+    }
+
+    size_t pos = ir->br.pos;
+    ir->stats.entriesDecoded++;
+    int rv = ir->decoders.decoder(&ir->br, &ir->decoderCtx, ir->record);
+    uint32_t delta = *(uint32_t *)&ir->record->docId;
+    ir->lastId = ir->record->docId = calculateId(ir->lastId, delta, pos == 0);
+
+    if (RS_AccountCost(1)) {
+      IR_SetAtEnd(ir, 1);
+      return n;
+    }
+
+    // The decoder also acts as a filter; skip record on zero return
+    if (!rv) {
+      continue;
+    }
+    if (ir->sp && DocTable_IsDeleted(&ir->sp->docs, ir->record->docId)) {
+      continue;
+    }
+    ++ir->len;
+    ir->stats.entriesReturned++;
+    IR_ExpandFreq(ir);
+    results[n++] = *ir->record;
+  }
+  return n;
+}
+
 #define BLOCK_MATCHES(blk, docId) ((blk).firstId <= docId && docId <= (blk).lastId)
 
+/* Lazily build skip entries for a block that has none (e.g. one loaded from an RDB). This costs
+ * one linear decode of the block; subsequent seeks into it become sub-linear */
+static void IndexBlock_BuildSkips(IndexBlock *blk, IndexFlags flags) {
+  IndexBlock_EnsureDecompressed(blk);
+  uint32_t readFlags = flags & INDEX_STORAGE_MASK;
+  IndexDecoderProcs decoders = InvertedIndex_GetDecoder(readFlags);
+  if (!decoders.decoder) {
+    return;
+  }
+
+  RSIndexResult *res =
+      readFlags == Index_StoreNumeric ? NewNumericResult() : NewTokenRecord(NULL, 1);
+  BufferReader br = NewBufferReader(&blk->buf);
+  t_docId lastId = blk->firstId;
+  uint32_t n = 0;
+
+  while (!BufferReader_AtEnd(&br)) {
+    static const IndexDecoderCtx empty = {0};
+    size_t pos = br.pos;
+    decoders.decoder(&br, &empty, res);
+    t_docId id = calculateId(lastId, *(uint32_t *)&res->docId, pos == 0);
+    if (n && n % INDEX_BLOCK_SKIP_INTERVAL == 0) {
+      IndexBlock_AddSkip(blk, id, lastId, pos);
+    }
+    lastId = id;
+    ++n;
+  }
+  IndexResult_Free(res);
+}
+
+/* If the current block has skip entries, jump the reader over records which are known to precede
+ * the requested id, so the decode loop only scans the tail of the skip interval */
+static void IndexReader_SkipWithinBlock(IndexReader *ir, t_docId docId) {
+  IndexBlock *blk = &IR_CURRENT_BLOCK(ir);
+  if (!blk->skips && blk->numDocs > INDEX_BLOCK_SKIP_INTERVAL) {
+    IndexBlock_BuildSkips(blk, ir->idx->flags);
+  }
+  if (!blk->numSkips) {
+    return;
+  }
+
+  // Find the last skip entry which does not overshoot the target
+  const IndexBlockSkipEntry *best = NULL;
+  uint32_t bottom = 0, top = blk->numSkips;
+  while (bottom < top) {
+    uint32_t mid = (bottom + top) / 2;
+    if (blk->skips[mid].docId <= docId) {
+      best = &blk->skips[mid];
+      bottom = mid + 1;
+    } else {
+      top = mid;
+    }
+  }
+  if (best && best->offset > ir->br.pos) {
+    ir->br.pos = best->offset;
+    ir->lastId = best->prevId;
+  }
+}
+
 static int IndexReader_SkipToBlock(IndexReader *ir, t_docId docId) {
   int rc = 0;
   InvertedIndex *idx = ir->idx;
@@ -923,6 +1704,19 @@ static int IndexReader_SkipToBlock(IndexReader *ir, t_docId docId) {
 
   uint32_t top = idx->size - 1;
   uint32_t bottom = ir->currentBlock + 1;
+
+  // Gallop forward before bisecting: intersections typically seek a short distance ahead, so
+  // probing 1, 2, 4... blocks brackets a nearby target in O(log distance) rather than
+  // O(log remaining)
+  uint32_t span = 1;
+  while (bottom + span <= top && idx->blocks[bottom + span - 1].lastId < docId) {
+    bottom += span;
+    span *= 2;
+  }
+  if (bottom + span - 1 < top) {
+    top = bottom + span - 1;
+  }
+
   uint32_t i = bottom;  //(bottom + top) / 2;
   while (bottom <= top) {
     const IndexBlock *blk = idx->blocks + i;
@@ -944,15 +1738,17 @@ static int IndexReader_SkipToBlock(IndexReader *ir, t_docId docId) {
 
 new_block:
   ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
-  ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
+  IndexReader_EnterBlock(ir);
   return rc;
 }
 
 int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
+  PERF_SCOPE(PERFCTR_IR_SKIPTO);
   IndexReader *ir = ctx;
   if (!docId) {
     return IR_Read(ctx, hit);
   }
+  ir->stats.skipToCalls++;
 
   if (IR_IS_AT_END(ir)) {
     goto eof;
@@ -962,6 +1758,11 @@ int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
     goto eof;
   }
 
+  // A seek costs at least a block jump plus an in-block scan
+  if (RS_AccountCost(2)) {
+    goto eof;
+  }
+
   if (!BLOCK_MATCHES(IR_CURRENT_BLOCK(ir), docId)) {
     IndexReader_SkipToBlock(ir, docId);
   } else if (BufferReader_AtEnd(&ir->br)) {
@@ -973,6 +1774,8 @@ int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
     }
   }
 
+  IndexReader_SkipWithinBlock(ir, docId);
+
   /**
    * We need to replicate the effects of IR_Read() without actually calling it
    * continuously.
@@ -1010,10 +1813,13 @@ int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
           IndexReader_AdvanceBlock(ir);
         }
       }
+      IR_ExpandFreq(ir);
       *hit = ir->record;
       return INDEXREAD_NOTFOUND;
     } else {
       // Found:
+      ir->stats.skipToHits++;
+      IR_ExpandFreq(ir);
       *hit = ir->record;
       if (BufferReader_AtEnd(&ir->br)) {
         if (ir->currentBlock < ir->idx->size - 1) {
@@ -1028,7 +1834,10 @@ int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
     while (INDEXREAD_EOF != (rc = IR_Read(ir, hit))) {
       rid = ir->lastId;
       if (rid < docId) continue;
-      if (rid == docId) return INDEXREAD_OK;
+      if (rid == docId) {
+        ir->stats.skipToHits++;
+        return INDEXREAD_OK;
+      }
       return INDEXREAD_NOTFOUND;
     }
   }
@@ -1049,15 +1858,21 @@ static void IndexReader_Init(const IndexSpec *sp, IndexReader *ret, InvertedInde
   ret->currentBlock = 0;
   ret->idx = idx;
   ret->gcMarker = idx->gcMarker;
+  memset(&ret->stats, 0, sizeof(ret->stats));
   ret->record = record;
   ret->len = 0;
   ret->weight = weight;
   ret->lastId = IR_CURRENT_BLOCK(ret).firstId;
+  IR_CURRENT_BLOCK(ret).touchMin = IndexTieringClock_g;
+  IndexBlock_EnsureDecompressed(&IR_CURRENT_BLOCK(ret));
   ret->br = NewBufferReader(&IR_CURRENT_BLOCK(ret).buf);
   ret->decoders = decoder;
   ret->decoderCtx = decoderCtx;
   ret->isValidP = NULL;
   ret->sp = sp;
+  ret->impactFactor = 0;
+  ret->maxScoreThresholdRef = NULL;
+  ret->queryFieldMaskFolded = 0;
   IR_SetAtEnd(ret, 0);
 }
 
@@ -1081,6 +1896,9 @@ IndexReader *NewTermIndexReader(InvertedIndex *idx, IndexSpec *sp, t_fieldMask f
   if (!decoder.decoder) {
     return NULL;
   }
+  if (fieldMask == RS_FIELDMASK_ALL) {
+    indexDecoderSetMatchAll(&decoder, (uint32_t)idx->flags);
+  }
 
   RSIndexResult *record = NewTokenRecord(term, weight);
   record->fieldMask = RS_FIELDMASK_ALL;
@@ -1088,10 +1906,31 @@ IndexReader *NewTermIndexReader(InvertedIndex *idx, IndexSpec *sp, t_fieldMask f
 
   IndexDecoderCtx dctx = {.num = fieldMask};
 
-  return NewIndexReaderGeneric(sp, idx, decoder, dctx, record, weight);
+  IndexReader *ret = NewIndexReaderGeneric(sp, idx, decoder, dctx, record, weight);
+  if (term) {
+    // Any document's score contribution through this term is at most freq * idf * weight
+    ret->impactFactor = term->idf * weight;
+    // Fold the now-known idf into the record's static scoring factor
+    record->scoreCoeff = weight * term->idf;
+  }
+  // Field-filtered readers of flag-carrying indexes may skip whole blocks
+  // through the per-block mask union
+  if ((idx->flags & Index_StoreFieldFlags) && fieldMask != RS_FIELDMASK_ALL) {
+    ret->queryFieldMaskFolded = FoldFieldMask(fieldMask);
+  }
+  return ret;
 }
 
 void IR_Free(IndexReader *ir) {
+  if (ir->sp) {
+    // fold this reader's read-amplification numbers into the spec totals
+    IterRAStats *agg = &((IndexSpec *)ir->sp)->iterStats;
+    __atomic_fetch_add(&agg->entriesDecoded, ir->stats.entriesDecoded, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&agg->entriesReturned, ir->stats.entriesReturned, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&agg->skipToCalls, ir->stats.skipToCalls, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&agg->skipToHits, ir->stats.skipToHits, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&agg->blocksEntered, ir->stats.blocksEntered, __ATOMIC_RELAXED);
+  }
 
   IndexResult_Free(ir->record);
   rm_free(ir);
@@ -1111,6 +1950,18 @@ void ReadIterator_Free(IndexIterator *it) {
   rm_free(it);
 }
 
+static void IR_SetMaxScoreThresholdRef(void *ctx, const double *ref) {
+  ((IndexReader *)ctx)->maxScoreThresholdRef = ref;
+}
+
+static double IR_GetMaxScoreBound(void *ctx) {
+  IndexReader *ir = ctx;
+  if (ir->impactFactor == 0 || !ir->idx->maxFreq) {
+    return 0;  // unknown - caller must not prune
+  }
+  return ir->impactFactor * ir->idx->maxFreq;
+}
+
 inline t_docId IR_LastDocId(void *ctx) {
   return ((IndexReader *)ctx)->lastId;
 }
@@ -1121,7 +1972,7 @@ void IR_Rewind(void *ctx) {
   IR_SetAtEnd(ir, 0);
   ir->currentBlock = 0;
   ir->gcMarker = ir->idx->gcMarker;
-  ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
+  IndexReader_EnterBlock(ir);
   ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
 }
 
@@ -1144,6 +1995,9 @@ IndexIterator *NewReadIterator(IndexReader *ir) {
   ri->Abort = IR_Abort;
   ri->Rewind = IR_Rewind;
   ri->HasNext = NULL;
+  ri->SetMaxScoreThresholdRef = IR_SetMaxScoreThresholdRef;
+  ri->GetMaxScoreBound = IR_GetMaxScoreBound;
+  ri->ReadBatch = IR_ReadMany;
   ri->isValid = !ir->atEnd_;
   ri->current = ir->record;
 
@@ -1156,6 +2010,12 @@ IndexIterator *NewReadIterator(IndexReader *ir) {
  * pointer. If an error occurred - returns -1
  */
 int IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepairParams *params) {
+  IndexBlock_EnsureDecompressed(blk);
+  if (flags & Index_PackedDocIds) {
+    // Fixed-width blocks cannot be rewritten record by record with the varint encoder, so expand
+    // them first. The caller re-packs completed blocks when it is done
+    IndexBlock_UnpackDocIds(blk);
+  }
   t_docId lastReadId = blk->firstId;
   bool isFirstRes = true;
 
@@ -1169,6 +2029,8 @@ int IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepa
 
   RSIndexResult *res = flags == Index_StoreNumeric ? NewNumericResult() : NewTokenRecord(NULL, 1);
   size_t frags = 0;
+  uint32_t survivorMaxFreq = 0;
+  uint64_t survivorMaskUnion = 0;
 
   uint32_t readFlags = flags & INDEX_STORAGE_MASK;
   IndexDecoderProcs decoders = InvertedIndex_GetDecoder(readFlags);
@@ -1194,7 +2056,8 @@ int IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepa
     }
     isFirstRes = false;
     lastReadId = res->docId;
-    int docExists = DocTable_Exists(dt, res->docId);
+    int docExists = params->DocExists ? params->DocExists(res->docId, params->existsArg)
+                                      : DocTable_Exists(dt, res->docId);
 
     // If we found a deleted document, we increment the number of found "frags",
     // and not write anything, so the reader will advance but the writer won't.
@@ -1207,6 +2070,15 @@ int IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepa
       params->bytesCollected += sz;
     } else {  // valid document
 
+      // Track the surviving records' maximum impact, mirroring the write
+      // path's quantization handling, so the repaired block's pruning bound
+      // tightens after deletions instead of going stale
+      uint32_t impact = (flags & Index_QuantizedFreqs) ? FreqExpand(res->freq) : res->freq;
+      if (impact > survivorMaxFreq) {
+        survivorMaxFreq = impact;
+      }
+      survivorMaskUnion |= FoldFieldMask(res->fieldMask);
+
       // If we're already operating in a repaired block, we do nothing if we found no holes yet, or
       // write back the record at the writer's top end if we've found a hole before
       if (frags) {
@@ -1234,8 +2106,25 @@ int IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepa
     // If we deleted stuff from this block, we need to change the number of docs and the data
     // pointer
     blk->numDocs -= frags;
-    blk->buf = repair;
-    Buffer_ShrinkToSize(&blk->buf);
+    if (blk->bufBorrowed) {
+      // The data lives in the index's load arena and cannot be realloc'ed - promote the
+      // repaired content to the block's own allocation
+      Buffer fresh;
+      Buffer_Init(&fresh, repair.offset ? repair.offset : 1);
+      memcpy(fresh.data, repair.data, repair.offset);
+      fresh.offset = repair.offset;
+      blk->buf = fresh;
+      blk->bufBorrowed = 0;
+    } else {
+      blk->buf = repair;
+      Buffer_ShrinkToSize(&blk->buf);
+    }
+    // The repaired buffer has different record offsets, so the skip entries no longer apply
+    IndexBlock_InvalidateSkips(blk);
+    // Only a repaired block gets the tightened bounds: an untouched one keeps
+    // its write-time values, which the survivor scan merely re-derived
+    blk->maxFreq = survivorMaxFreq;
+    blk->fieldMaskUnion = survivorMaskUnion;
   }
   if (blk->numDocs == 0) {
     // if we left with no elements we do need to keep the
@@ -1250,6 +2139,119 @@ int IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepa
   return frags;
 }
 
+/* Promote an arena-borrowed block to its own allocation, so the buffer may be grown in place */
+static void IndexBlock_Promote(IndexBlock *blk) {
+  if (!blk->bufBorrowed) {
+    return;
+  }
+  Buffer fresh;
+  Buffer_Init(&fresh, blk->buf.offset ? blk->buf.offset : 1);
+  memcpy(fresh.data, blk->buf.data, blk->buf.offset);
+  fresh.offset = blk->buf.offset;
+  blk->buf = fresh;
+  blk->bufBorrowed = 0;
+}
+
+/* Coalesce adjacent under-filled blocks left behind by delete-heavy workloads and GC repairs.
+ * Two neighbours are merged when their combined entry count still fits one block and the
+ * resulting id span keeps deltas in 32 bits. Returns the number of blocks merged away; when
+ * non-zero the gc marker has been bumped so sleeping readers re-seek on reopen (block indexes
+ * shift). Must be called under the same exclusivity guarantees as InvertedIndex_Repair */
+size_t InvertedIndex_CompactBlocks(InvertedIndex *idx) {
+  if (idx->size < 2) {
+    return 0;
+  }
+  uint32_t readFlags = idx->flags & INDEX_STORAGE_MASK;
+  IndexDecoderProcs decoders = InvertedIndex_GetDecoder(readFlags);
+  IndexEncoder encoder = InvertedIndex_GetEncoder(readFlags);
+  if (!decoders.decoder || !encoder) {
+    return 0;
+  }
+
+  RSIndexResult *res =
+      readFlags == Index_StoreNumeric ? NewNumericResult() : NewTokenRecord(NULL, 1);
+  size_t merged = 0;
+  uint32_t w = 0;
+
+  // Never touch the tail block - the writer may be mid-append into it
+  for (uint32_t r = 1; r < idx->size; r++) {
+    IndexBlock *dst = &idx->blocks[w];
+    IndexBlock *src = &idx->blocks[r];
+
+    // Blocks fully emptied by repair carry no data at all - drop them outright
+    if (src->numDocs == 0 && r != idx->size - 1) {
+      indexBlock_Free(src);
+      ++merged;
+      continue;
+    }
+
+    int canMerge = r != idx->size - 1 && dst->numDocs && src->numDocs &&
+                   dst->numDocs + src->numDocs <= INDEX_BLOCK_SIZE &&
+                   src->lastId - dst->firstId <= UINT32_MAX;
+
+    if (canMerge) {
+      // merging re-encodes both images: tier-compressed blocks inflate first
+      IndexBlock_EnsureDecompressed(dst);
+      IndexBlock_EnsureDecompressed(src);
+    }
+    if (!canMerge) {
+      if (++w != r) {
+        idx->blocks[w] = *src;
+      }
+      continue;
+    }
+
+    // Fixed-width containers cannot be appended to record by record
+    if (idx->flags & Index_PackedDocIds) {
+      IndexBlock_UnpackDocIds(dst);
+      IndexBlock_UnpackDocIds(src);
+    }
+    IndexBlock_Promote(dst);
+
+    // Re-encode src's records onto dst, re-basing the deltas
+    BufferReader br = NewBufferReader(&src->buf);
+    BufferWriter bw = NewBufferWriter(&dst->buf);
+    t_docId lastId = src->firstId;
+    while (!BufferReader_AtEnd(&br)) {
+      static const IndexDecoderCtx empty = {0};
+      size_t pos = br.pos;
+      decoders.decoder(&br, &empty, res);
+      t_docId id = calculateId(lastId, *(uint32_t *)&res->docId, pos == 0);
+      lastId = id;
+      encoder(&bw, id - dst->lastId, res);
+      dst->lastId = id;
+    }
+    dst->numDocs += src->numDocs;
+    // An unknown (zero) side makes the merged metadata unknown - claiming the
+    // known side's bound for the unknown side's entries would be wrong
+    dst->maxFreq = (src->maxFreq && dst->maxFreq) ? MAX(src->maxFreq, dst->maxFreq) : 0;
+    dst->fieldMaskUnion =
+        (src->fieldMaskUnion && dst->fieldMaskUnion) ? (src->fieldMaskUnion | dst->fieldMaskUnion)
+                                                     : 0;
+    IndexBlock_InvalidateSkips(dst);
+    indexBlock_Free(src);
+    ++merged;
+  }
+
+  IndexResult_Free(res);
+  if (!merged) {
+    return 0;
+  }
+
+  idx->size = w + 1;
+  idx->blocks = rm_realloc(idx->blocks, idx->size * sizeof(IndexBlock));
+  TotalIIBlocks -= merged;
+  // Re-pack merged blocks of packed indexes (the tail was not touched)
+  if (idx->flags & Index_PackedDocIds) {
+    for (uint32_t i = 0; i + 1 < idx->size; i++) {
+      IndexBlock_PackDocIds(&idx->blocks[i]);
+    }
+  }
+  // Block indexes have shifted - sleeping readers must re-seek rather than resume by offset
+  ++idx->gcMarker;
+  return merged;
+}
+
 int InvertedIndex_Repair(InvertedIndex *idx, DocTable *dt, uint32_t startBlock,
                          IndexRepairParams *params) {
   size_t limit = params->limit ? params->limit : SIZE_MAX;
@@ -1262,6 +2264,11 @@ int InvertedIndex_Repair(InvertedIndex *idx, DocTable *dt, uint32_t startBlock,
       continue;
     }
     int repaired = IndexBlock_Repair(&idx->blocks[startBlock], dt, idx->flags, params);
+    if ((idx->flags & Index_PackedDocIds) && startBlock != idx->size - 1) {
+      // Completed blocks go back to fixed-width form; the tail block stays varint since the
+      // writer may still append to it
+      IndexBlock_PackDocIds(&idx->blocks[startBlock]);
+    }
     // We couldn't repair the block - return 0
     if (repaired == -1) {
       return 0;
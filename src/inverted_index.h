@@ -18,12 +18,45 @@ extern "C" {
 
 extern uint64_t TotalIIBlocks;
 
+/* A skip entry inside an index block. Every INDEX_BLOCK_SKIP_INTERVAL-th record in a block gets
+ * an entry, letting SkipTo jump into the middle of a block instead of decoding it entry by entry.
+ * `prevId` is the id of the record preceding `offset`, needed to resume delta decoding there.
+ * Skip entries are an in-memory acceleration only - they are not persisted, and are rebuilt
+ * lazily for blocks loaded from an RDB */
+typedef struct {
+  t_docId docId;
+  t_docId prevId;
+  uint32_t offset;
+} IndexBlockSkipEntry;
+
 /* A single block of data in the index. The index is basically a list of blocks we iterate */
 typedef struct {
   t_docId firstId;
   t_docId lastId;
   Buffer buf;
+  IndexBlockSkipEntry *skips;
+  uint16_t numSkips;
+  uint16_t skipsCap;
   uint16_t numDocs;
+  /* The largest (decoded) term frequency in the block: an upper bound on any record's score
+   * impact, used for WAND-style block skipping. Zero means unknown (e.g. blocks loaded from
+   * an RDB), which disables pruning for the block */
+  uint32_t maxFreq;
+  /* Union of the (folded, see FoldFieldMask) field masks of the block's records: a
+   * field-filtered reader skips the whole block when the query's mask cannot intersect it.
+   * Zero means unknown, which disables the skip */
+  uint64_t fieldMaskUnion;
+  /* If set, buf.data points into the index's load arena rather than its own allocation. Such a
+   * buffer must never be freed or realloc'ed; any rewrite (GC repair, packing) first promotes
+   * the block to its own allocation */
+  uint8_t bufBorrowed;
+  /* Cold tiering (see tiering.c): set when buf holds the DEFLATE'd image of the
+   * block; rawLen is the decompressed size. Readers entering the block inflate
+   * it back in place. touchMin is the coarse last-access clock (minutes) the
+   * sweep compares against */
+  uint8_t compressed;
+  uint32_t rawLen;
+  uint32_t touchMin;
 } IndexBlock;
 
 typedef struct {
@@ -33,6 +66,13 @@ typedef struct {
   t_docId lastId;
   uint32_t numDocs;
   uint32_t gcMarker;
+  /* Largest decoded term frequency across the whole index (0 = unknown); the per-term score
+   * upper bound used by the WAND union */
+  uint32_t maxFreq;
+  /* One contiguous allocation backing the block buffers of an RDB-loaded index (NULL for
+   * indexes built incrementally). Loading into a single arena replaces one heap object per
+   * block with one per index and keeps sequential scans on adjacent memory */
+  char *loadArena;
 } InvertedIndex;
 
 struct indexReadCtx;
@@ -62,18 +102,33 @@ typedef struct {
   void (*RepairCallback)(const RSIndexResult *, void *);
   /** argument to pass to callback */
   void *arg;
+
+  /** in: optional liveness predicate replacing the per-entry doc table
+   * lookup (the fork GC child supplies a snapshot bitmap). NULL falls back
+   * to DocTable_Exists */
+  int (*DocExists)(t_docId docId, void *existsArg);
+  void *existsArg;
 } IndexRepairParams;
 
 /* Create a new inverted index object, with the given flag. If initBlock is 1, we create the first
  * block */
 InvertedIndex *NewInvertedIndex(IndexFlags flags, int initBlock);
 IndexBlock *InvertedIndex_AddBlock(InvertedIndex *idx, t_docId firstId);
+
+/* Drop every posting in place, leaving one fresh empty block. Caller holds
+ * writer exclusivity; parked readers reseek via the bumped gc marker */
+void InvertedIndex_Reset(InvertedIndex *idx);
 void indexBlock_Free(IndexBlock *blk);
 void InvertedIndex_Free(void *idx);
 
 #define IndexBlock_DataBuf(b) (b)->buf.data
 #define IndexBlock_DataLen(b) (b)->buf.offset
 
+/* Inflate a tier-compressed block back to its raw image, in place. No-op for
+ * uncompressed blocks; returns 1 when an inflate happened. Callers must hold
+ * the exclusivity the block's index requires for buffer swaps */
+int IndexBlock_EnsureDecompressed(IndexBlock *blk);
+
 int InvertedIndex_Repair(InvertedIndex *idx, DocTable *dt, uint32_t startBlock,
                          IndexRepairParams *params);
 
@@ -144,12 +199,46 @@ typedef struct IndexReader {
    */
   uint32_t gcMarker;
 
+  /* Read-amplification accounting for this reader, folded into the spec's
+   * totals when the reader is freed */
+  IterRAStats stats;
+
   /* boosting weight */
   double weight;
+
+  /* WAND support: per-occurrence score upper bound factor (idf * weight; 0 disables
+   * pruning), and a reference to the query's evolving minimum top-k score. When both are
+   * set, IR_Read skips blocks whose best possible score cannot enter the heap */
+  double impactFactor;
+  const double *maxScoreThresholdRef;
+
+  /* Folded form of the query's field mask when this reader decodes with a
+   * field filter; 0 when unfiltered. Blocks whose fieldMaskUnion cannot
+   * intersect it are skipped wholesale */
+  uint64_t queryFieldMaskFolded;
 } IndexReader;
 
+/* Collapse a (possibly 128-bit) field mask to 64 bits for the per-block
+ * union. Folding both sides preserves the no-intersection guarantee: a real
+ * intersection implies a folded one, so a zero folded intersection is always
+ * safe to skip on */
+static inline uint64_t FoldFieldMask(t_fieldMask m) {
+#if defined(__x86_64__) && !defined(RS_NO_U128)
+  return (uint64_t)m | (uint64_t)(m >> 64);
+#else
+  return m;
+#endif
+}
+
 void IndexReader_OnReopen(RedisModuleKey *k, void *privdata);
 
+/* Reopen callback for term indexes residing in the spec's own dictionary
+ * rather than in a Redis key; only re-seeks after GC block rewrites */
+void IndexReader_OnReopenSpec(RedisModuleKey *k, void *privdata);
+
+/* Restore offset publishing after a SetSkipOffsetVectors swap */
+void IndexReader_SetKeepOffsetVectors(IndexReader *ir);
+
 /* An index encoder is a callback that writes records to the index. It accepts a pre-calculated
  * delta for encoding */
 typedef size_t (*IndexEncoder)(BufferWriter *bw, uint32_t delta, RSIndexResult *record);
@@ -185,12 +274,22 @@ IndexReader *NewTermIndexReader(InvertedIndex *idx, IndexSpec *sp, t_fieldMask f
 /* free an index reader */
 void IR_Free(IndexReader *ir);
 
+/* Switch the reader to offset-skipping decode: offset vectors are hopped over without being
+ * published into results. Call only when the query has no phrase/slop/highlight needs */
+void IndexReader_SetSkipOffsetVectors(IndexReader *ir);
+
 /* Read an entry from an inverted index */
 int IR_GenericRead(IndexReader *ir, RSIndexResult *res);
 
 /* Read an entry from an inverted index into RSIndexResult */
 int IR_Read(void *ctx, RSIndexResult **e);
 
+/* Read up to `limit` entries in one call into the caller-provided array of results, amortizing
+ * per-entry call overhead in decode-heavy loops. Returns the number of entries filled; a short
+ * count means EOF was reached. The results are shallow copies whose offset vectors point into
+ * the index buffers - consume them before yielding the GIL */
+size_t IR_ReadMany(void *ctx, RSIndexResult *results, size_t limit);
+
 /* Move to the next entry in an inverted index, without reading the whole entry
  */
 int IR_Next(void *ctx);
@@ -221,6 +320,14 @@ IndexIterator *NewReadIterator(IndexReader *ir);
 
 int IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepairParams *params);
 
+/* For Index_PackedDocIds indexes: re-encode a completed varint block to fixed-width deltas.
+ * No-op on blocks which are already packed */
+void IndexBlock_PackDocIds(IndexBlock *blk);
+
+/* Coalesce adjacent under-filled blocks (and drop empty ones) after delete-heavy workloads.
+ * Returns the number of blocks removed. Requires the same exclusivity as InvertedIndex_Repair */
+size_t InvertedIndex_CompactBlocks(InvertedIndex *idx);
+
 static inline double CalculateIDF(size_t totalDocs, size_t termDocs) {
   return logb(1.0F + totalDocs / (termDocs ? termDocs : (double)1));
 }
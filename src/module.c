@@ -15,6 +15,11 @@
 #include "rmutil/util.h"
 #include "rmutil/args.h"
 #include "spec.h"
+#include "backfill.h"
+#include "slowlog.h"
+#include "cpu_dispatch.h"
+#include "result_cache.h"
+#include "strintern.h"
 #include "util/logging.h"
 #include "extension.h"
 #include "ext/default.h"
@@ -136,6 +141,9 @@ int IndexInfoCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     REPLY_KVSTR(nn, "type", SpecTypeNames[sp->fields[i].type]);
     if (sp->fields[i].type == FIELD_FULLTEXT) {
       REPLY_KVNUM(nn, SPEC_WEIGHT_STR, sp->fields[i].textOpts.weight);
+      const FieldIndexStats *fst = &sp->fieldIdxStats[sp->fields[i].textOpts.id % 64];
+      REPLY_KVNUM(nn, "inverted_bytes", fst->invertedBytes);
+      REPLY_KVNUM(nn, "postings", fst->postings);
     }
 
     if (sp->fields[i].type == FIELD_TAG) {
@@ -177,7 +185,13 @@ int IndexInfoCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
   REPLY_KVNUM(n, "doc_table_size_mb", sp->docs.memsize / (float)0x100000);
   REPLY_KVNUM(n, "sortable_values_size_mb", sp->docs.sortablesSize / (float)0x100000);
 
-  REPLY_KVNUM(n, "key_table_size_mb", TrieMap_MemUsage(sp->docs.dim.tm) / (float)0x100000);
+  REPLY_KVNUM(n, "key_table_size_mb", DocIdMap_MemUsage(&sp->docs.dim) / (float)0x100000);
+  // Per-subsystem accounting so per-index capacity planning stops being
+  // guesswork on shared shards
+  REPLY_KVNUM(n, "result_cache_size_mb", ResultCache_MemUsage(sp->resultCache) / (float)0x100000);
+  REPLY_KVNUM(n, "field_names_sz_mb", StrIntern_MemUsage(sp->fieldNames) / (float)0x100000);
+  REPLY_KVNUM(n, "deleted_mask_sz_mb", sp->docs.deletedMaskCap / (float)0x100000);
+  REPLY_KVNUM(n, "terms_size_mb", sp->stats.termsSize / (float)0x100000);
   REPLY_KVNUM(n, "records_per_doc_avg",
               (float)sp->stats.numRecords / (float)sp->stats.numDocuments);
   REPLY_KVNUM(n, "bytes_per_record_avg",
@@ -201,13 +215,18 @@ int IndexInfoCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
   return REDISMODULE_OK;
 }
 
-/* FT.MGET {index} {key} ...
- * Get document(s) by their id.
- * Currentlt it just performs HGETALL, but it's a future proof alternative allowing us to later on
- * replace the internal representation of the documents.
+/* FT.MGET {index} {key} ... [FIELDS {count} {field} ...]
+ * Get document(s) by their id, optionally projecting a field subset.
  *
- * If referred docs are missing or not HASH keys, we simply reply with Null, but the result will
- * be an array the same size of the ids list
+ * The whole batch runs over one shared RLookup: field keys resolve once, every
+ * hash key is opened up front in a prefetch pass, and SORTABLE fields are
+ * served straight from the document table without touching the hash at all.
+ * A trailing FIELDS clause (the literal word, a count, and exactly that many
+ * names) selects the fields to return as [name, value, ...] pairs; without it
+ * every stored field is returned, as before.
+ *
+ * If referred docs are missing or not HASH keys, we simply reply with Null, but
+ * the result will be an array the same size of the ids list
  */
 int GetDocumentsCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
   if (argc < 3) {
@@ -220,25 +239,109 @@ int GetDocumentsCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
     return RedisModule_ReplyWithError(ctx, "Unknown Index name");
   }
 
+  // A FIELDS clause only parses as such when its count covers exactly the
+  // remaining arguments - a document literally named FIELDS stays fetchable
+  size_t nids = argc - 2;
+  size_t nfields = 0;
+  RedisModuleString **fieldNames = NULL;
+  for (size_t i = 2; i + 1 < (size_t)argc; i++) {
+    const char *s = RedisModule_StringPtrLen(argv[i], NULL);
+    long long cnt;
+    if (!strcasecmp(s, "FIELDS") &&
+        RedisModule_StringToLongLong(argv[i + 1], &cnt) == REDISMODULE_OK && cnt > 0 &&
+        (size_t)argc == i + 2 + cnt) {
+      nids = i - 2;
+      nfields = cnt;
+      fieldNames = &argv[i + 2];
+      break;
+    }
+  }
+  if (nids == 0) {
+    SearchCtx_Free(sctx);
+    return RedisModule_ReplyWithError(ctx, "No document ids given");
+  }
+
+  // One lookup for the whole batch: field keys resolve once, and the spec
+  // cache marks sortable sources so those rows never open the hash
+  RLookup lookup;
+  RLookup_Init(&lookup, IndexSpec_GetSpecCache(sctx->spec));
+  const RLookupKey **keys = NULL;
+  if (nfields) {
+    keys = rm_malloc(nfields * sizeof(*keys));
+    for (size_t i = 0; i < nfields; i++) {
+      keys[i] = RLookup_GetKey(&lookup, RedisModule_StringPtrLen(fieldNames[i], NULL),
+                               RLOOKUP_F_OCREAT);
+    }
+  }
+
+  // Prefetch pass: resolve metadata and open every hash key before any row is
+  // materialized, so the loads below walk already-faulted keyspace entries
   const DocTable *dt = &sctx->spec->docs;
-  RedisModule_ReplyWithArray(ctx, argc - 2);
-  for (size_t i = 2; i < argc; i++) {
+  const RSDocumentMetadata **dmds = rm_calloc(nids, sizeof(*dmds));
+  RedisModuleKey **keyobjs = rm_calloc(nids, sizeof(*keyobjs));
+  for (size_t i = 0; i < nids; i++) {
+    t_docId id = DocTable_GetIdR(dt, argv[2 + i]);
+    if (!id) {
+      continue;  // not in the index, even if it exists in the keyspace
+    }
+    dmds[i] = DocTable_Get(dt, id);
+    keyobjs[i] = RedisModule_OpenKey(ctx, argv[2 + i], REDISMODULE_READ);
+  }
 
-    if (DocTable_GetIdR(dt, argv[i]) == 0) {
-      // Document does not exist in index; even though it exists in keyspace
+  RedisModule_ReplyWithArray(ctx, nids);
+  for (size_t i = 0; i < nids; i++) {
+    if (!dmds[i]) {
       RedisModule_ReplyWithNull(ctx);
       continue;
     }
-
-    Document doc;
-    if (Redis_LoadDocument(sctx, argv[i], &doc) == REDISMODULE_ERR) {
+    RLookupRow row = {0};
+    QueryError status = {0};
+    RLookupLoadOptions opts = {.keyobj = keyobjs[i],
+                               .sctx = sctx,
+                               .dmd = dmds[i],
+                               .keys = keys,
+                               .nkeys = nfields,
+                               .mode = nfields ? RLOOKUP_LOAD_KEYLIST : RLOOKUP_LOAD_ALLKEYS,
+                               .copyStrings = 1,
+                               .status = &status};
+    if (RLookup_LoadDocument(&lookup, &row, &opts) != REDISMODULE_OK) {
       RedisModule_ReplyWithNull(ctx);
+      RLookupRow_Cleanup(&row);
+      QueryError_ClearError(&status);
+      continue;
+    }
+    RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+    size_t n = 0;
+    if (nfields) {
+      for (size_t f = 0; f < nfields; f++) {
+        const RSValue *v = keys[f] ? RLookup_GetItem(keys[f], &row) : NULL;
+        if (!v) {
+          continue;
+        }
+        RedisModule_ReplyWithString(ctx, fieldNames[f]);
+        RSValue_SendReply(ctx, v, 0);
+        n += 2;
+      }
     } else {
-      Document_ReplyFields(ctx, &doc);
-      Document_Free(&doc);
+      for (const RLookupKey *kk = lookup.head; kk; kk = kk->next) {
+        const RSValue *v = RLookup_GetItem(kk, &row);
+        if (!v) {
+          continue;
+        }
+        // bulk strings, matching what Document_ReplyFields used to send
+        RedisModule_ReplyWithStringBuffer(ctx, kk->name, strlen(kk->name));
+        RSValue_SendReply(ctx, v, 0);
+        n += 2;
+      }
     }
+    RedisModule_ReplySetArrayLength(ctx, n);
+    RLookupRow_Cleanup(&row);
   }
 
+  rm_free(dmds);
+  rm_free(keyobjs);
+  rm_free(keys);
+  RLookup_Cleanup(&lookup);
   SearchCtx_Free(sctx);
 
   return REDISMODULE_OK;
@@ -275,6 +378,37 @@ int GetSingleDocumentCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
   return REDISMODULE_OK;
 }
 
+/* FT.SLOWLOG {index} [RESET]
+ * Read back (newest first) or clear the index's rolling slow-query log.
+ * Entries are [id, timestamp, ms, command, per-stage attribution] */
+int SlowlogCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+  if (argc < 2 || argc > 3) {
+    return RedisModule_WrongArity(ctx);
+  }
+  RedisModule_AutoMemory(ctx);
+  RedisSearchCtx *sctx = NewSearchCtx(ctx, argv[1], true);
+  if (sctx == NULL) {
+    return RedisModule_ReplyWithError(ctx, "Unknown Index name");
+  }
+  int rc = REDISMODULE_OK;
+  if (argc == 3) {
+    if (!RMUtil_StringEqualsCaseC(argv[2], "RESET")) {
+      rc = RedisModule_ReplyWithError(ctx, "Unknown subcommand");
+    } else {
+      if (sctx->spec->slowlog) {
+        SlowLog_Reset(sctx->spec->slowlog);
+      }
+      rc = RedisModule_ReplyWithSimpleString(ctx, "OK");
+    }
+  } else if (sctx->spec->slowlog) {
+    SlowLog_Reply(sctx->spec->slowlog, ctx);
+  } else {
+    RedisModule_ReplyWithArray(ctx, 0);
+  }
+  SearchCtx_Free(sctx);
+  return rc;
+}
+
 int SpellCheckCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 #define DICT_INITIAL_SIZE 5
 #define DEFAULT_LEV_DISTANCE 1
@@ -403,6 +537,7 @@ int QueryExplainCLICommand(RedisModuleCtx *ctx, RedisModuleString **argv, int ar
 
 int RSAggregateCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int RSSearchCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int RSProfileCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int RSCursorCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 
 /* FT.DEL {index} {doc_id}
@@ -449,6 +584,9 @@ int DeleteCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
   int rc = DocTable_DeleteR(&sp->docs, docKey);
   if (rc) {
     sp->stats.numDocuments--;
+    if (sp->resultCache) {
+      ResultCache_OnDocDelete(sp->resultCache);
+    }
 
     // If needed - delete the actual doc
     if (delDoc) {
@@ -787,6 +925,11 @@ int SynAddCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 
   uint32_t id = SynonymMap_AddRedisStr(sp->smap, argv + 2, argc - 2);
 
+  if (sp->resultCache) {
+    // Expansion changes are not attributable to term epochs
+    ResultCache_OnUnattributedChange(sp->resultCache);
+  }
+
   RedisModule_ReplyWithLongLong(ctx, id);
 
   return REDISMODULE_OK;
@@ -809,6 +952,11 @@ int SynUpdateCommandInternal(RedisModuleCtx *ctx, RedisModuleString *indexName,
 
   SynonymMap_UpdateRedisStr(sp->smap, synonyms, size, id);
 
+  if (sp->resultCache) {
+    // Expansion changes are not attributable to term epochs
+    ResultCache_OnUnattributedChange(sp->resultCache);
+  }
+
   RedisModule_ReplyWithSimpleString(ctx, "OK");
 
   return REDISMODULE_OK;
@@ -922,16 +1070,26 @@ int AlterIndexCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 
   const int schemaOffset = 4;
   QueryError status = {0};
+  int nschema = argc - schemaOffset;
 
-  if (argc - schemaOffset == 0) {
+  // trailing BACKFILL: reindex existing documents in the background
+  int backfill = 0;
+  if (nschema > 0 && RMUtil_StringEqualsCaseC(argv[argc - 1], "BACKFILL")) {
+    backfill = 1;
+    nschema--;
+  }
+  if (nschema == 0) {
     return RedisModule_ReplyWithError(ctx, "No fields provided");
   }
 
-  int rc = IndexSpec_AddFieldsRedisArgs(sp, argv + schemaOffset, argc - schemaOffset, &status);
+  int rc = IndexSpec_AddFieldsRedisArgs(sp, argv + schemaOffset, nschema, &status);
   if (!rc) {
     RedisModule_ReplyWithError(ctx, QueryError_GetError(&status));
     QueryError_ClearError(&status);
   } else {
+    if (backfill) {
+      Backfill_Start(sp);
+    }
     RedisModule_ReplyWithSimpleString(ctx, "OK");
   }
 
@@ -1027,6 +1185,10 @@ int RS_InitializeLibrary(RedisModuleCtx *ctx);
 
 int RediSearch_InitModuleInternal(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
 
+  // bind every multi-versioned kernel to the detected CPU level
+  RSCpu_InitDispatch();
+  RedisModule_Log(ctx, "notice", "CPU dispatch level: %s", RSCpu_LevelName());
+
   // Check that redis supports thread safe context. RC3 or below doesn't
   if (RedisModule_GetThreadSafeContext == NULL) {
     RedisModule_Log(ctx, "warning",
@@ -1118,6 +1280,11 @@ int RediSearch_InitModuleInternal(RedisModuleCtx *ctx, RedisModuleString **argv,
   RM_TRY(RedisModule_CreateCommand, ctx, RS_ADD_CMD, RSAddDocumentCommand, "write deny-oom", 1, 1,
          1);
 
+  RM_TRY(RedisModule_CreateCommand, ctx, RS_ADDBATCH_CMD, RSAddDocumentBatchCommand,
+         "write deny-oom", 1, 1, 1);
+
+  RM_TRY(RedisModule_CreateCommand, ctx, RS_APPLYDELTA_CMD, ApplyDeltaCommand, "write deny-oom", 1,
+         1, 1);
   RM_TRY(RedisModule_CreateCommand, ctx, RS_SAFEADD_CMD, RSSafeAddDocumentCommand, "write deny-oom",
          1, 1, 1);
 
@@ -1134,6 +1301,7 @@ int RediSearch_InitModuleInternal(RedisModuleCtx *ctx, RedisModuleString **argv,
 
   RM_TRY(RedisModule_CreateCommand, ctx, RS_SEARCH_CMD, RSSearchCommand, "readonly", 1, 1, 1);
   RM_TRY(RedisModule_CreateCommand, ctx, RS_AGGREGATE_CMD, RSAggregateCommand, "readonly", 1, 1, 1);
+  RM_TRY(RedisModule_CreateCommand, ctx, RS_PROFILE_CMD, RSProfileCommand, "readonly", 1, 1, 1);
 
   RM_TRY(RedisModule_CreateCommand, ctx, RS_GET_CMD, GetSingleDocumentCommand, "readonly", 1, 1, 1);
 
@@ -1162,6 +1330,12 @@ int RediSearch_InitModuleInternal(RedisModuleCtx *ctx, RedisModuleString **argv,
 
   RM_TRY(RedisModule_CreateCommand, ctx, RS_SUGGET_CMD, RSSuggestGetCommand, "readonly", 1, 1, 1);
 
+  RM_TRY(RedisModule_CreateCommand, ctx, RS_SUGCOMPACT_CMD, RSSuggestCompactCommand,
+         "write deny-oom", 1, 1, 1);
+
+  RM_TRY(RedisModule_CreateCommand, ctx, RS_SUGSTATS_CMD, RSSuggestStatsCommand, "readonly", 1, 1,
+         1);
+
   RM_TRY(RedisModule_CreateCommand, ctx, RS_CURSOR_CMD, RSCursorCommand, "readonly", 2, 2, 1);
 
   RM_TRY(RedisModule_CreateCommand, ctx, RS_SYNADD_CMD, SynAddCommand, "write", 1, 1, 1);
@@ -1174,6 +1348,8 @@ int RediSearch_InitModuleInternal(RedisModuleCtx *ctx, RedisModuleString **argv,
   RM_TRY(RedisModule_CreateCommand, ctx, RS_SYNDUMP_CMD, SynDumpCommand, "readonly", 1, 1, 1);
 
   RM_TRY(RedisModule_CreateCommand, ctx, RS_ALTER_CMD, AlterIndexCommand, "write", 1, 1, 1);
+  RM_TRY(RedisModule_CreateCommand, ctx, RS_CMD_PREFIX ".SLOWLOG", SlowlogCommand, "readonly", 1,
+         1, 1);
 
   RM_TRY(RedisModule_CreateCommand, ctx, RS_DEBUG, DebugCommand, "readonly", 1, 1, 1);
 
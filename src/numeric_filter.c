@@ -68,6 +68,7 @@ NumericFilter *NumericFilter_Parse(ArgsCursor *ac, QueryError *status) {
     NumericFilter_Free(nf);
     return NULL;
   }
+  NumericFilter_Precompute(nf);
   return nf;
 }
 
@@ -86,5 +87,6 @@ NumericFilter *NewNumericFilter(double min, double max, int inclusiveMin, int in
   f->fieldName = NULL;
   f->inclusiveMax = inclusiveMax;
   f->inclusiveMin = inclusiveMin;
+  NumericFilter_Precompute(f);
   return f;
 }
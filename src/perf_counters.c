@@ -0,0 +1,16 @@
+#include "perf_counters.h"
+#include <string.h>
+
+PerfCounter perfCounters_g[PERFCTR__MAX];
+
+const char *perfCounterNames_g[PERFCTR__MAX] = {
+    [PERFCTR_IR_READ] = "ir_read",
+    [PERFCTR_IR_SKIPTO] = "ir_skipto",
+    [PERFCTR_SORTER_INSERT] = "sorter_insert",
+    [PERFCTR_II_WRITE] = "ii_write_entry",
+    [PERFCTR_GC_APPLY] = "gc_apply",
+};
+
+void PerfCounters_Reset(void) {
+  memset(perfCounters_g, 0, sizeof(perfCounters_g));
+}
@@ -0,0 +1,71 @@
+#ifndef RS_PERF_COUNTERS_H_
+#define RS_PERF_COUNTERS_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Cycle counters for the hot-path choke points, compiled in with the
+ * RS_PERF_COUNTERS CMake option and dumped via FT.DEBUG PERFCOUNTERS. When
+ * the option is off the timing macros expand to nothing; when on, a counter
+ * costs two timestamp reads and two relaxed atomic adds per call. */
+typedef enum {
+  PERFCTR_IR_READ = 0,
+  PERFCTR_IR_SKIPTO,
+  PERFCTR_SORTER_INSERT,
+  PERFCTR_II_WRITE,
+  PERFCTR_GC_APPLY,
+  PERFCTR__MAX,
+} PerfCounterId;
+
+typedef struct {
+  uint64_t calls;
+  uint64_t cycles;
+} PerfCounter;
+
+extern PerfCounter perfCounters_g[PERFCTR__MAX];
+extern const char *perfCounterNames_g[PERFCTR__MAX];
+
+void PerfCounters_Reset(void);
+
+#ifdef RS_PERF_COUNTERS
+
+static inline uint64_t perfCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
+}
+
+typedef struct {
+  PerfCounterId id;
+  uint64_t t0;
+} PerfScope;
+
+static inline void perfScopeEnd(PerfScope *s) {
+  __atomic_fetch_add(&perfCounters_g[s->id].calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&perfCounters_g[s->id].cycles, perfCycles() - s->t0, __ATOMIC_RELAXED);
+}
+
+/* Times from here to the end of the enclosing scope, covering every return
+ * path of the function it opens */
+#define PERF_SCOPE(ctr) \
+  __attribute__((cleanup(perfScopeEnd))) PerfScope __perfScope_ = {ctr, perfCycles()}
+
+#else
+
+#define PERF_SCOPE(ctr) ((void)0)
+
+#endif  // RS_PERF_COUNTERS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
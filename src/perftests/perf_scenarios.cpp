@@ -0,0 +1,257 @@
+/* Pinned scenario benchmarks with baseline tracking.
+ *
+ * Indexes a deterministic synthetic corpus (zipf-ish vocabulary, fixed seed)
+ * and runs a fixed query mix, emitting one machine-readable line per metric:
+ *
+ *   METRIC <name> <value> <baseline> <tolerance> <status>
+ *
+ * Metrics are compared against the checked-in baseline file; a metric more
+ * than <tolerance> below its baseline fails the run (exit 1), so posting
+ * format and iterator changes cannot silently regress ingest or query
+ * throughput. Baselines are machine- and build-flag-dependent: re-pin with
+ * --update on the reference box after intentional changes.
+ *
+ *   ./perftest [--baseline <file>] [--docs <n>] [--update]
+ */
+#include <redismodule.h>
+#include <module.h>
+#include <version.h>
+#include "redismock.h"
+#include "util.h"
+#include <aggregate/aggregate.h>
+#include "spec.h"
+#include "search_ctx.h"
+#include "document.h"
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+
+REDISMODULE_INIT_SYMBOLS();
+
+extern "C" {
+uint64_t siphash(const uint8_t *in, const size_t inlen, const uint8_t *k) {
+  return 0;
+}
+uint64_t siphash_nocase(const uint8_t *in, const size_t inlen, const uint8_t *k) {
+  return 0;
+}
+static int my_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+  if (RedisModule_Init(ctx, "ft", REDISEARCH_MODULE_VERSION, REDISMODULE_APIVER_1) ==
+      REDISMODULE_ERR)
+    return REDISMODULE_ERR;
+  return RediSearch_InitModuleInternal(ctx, argv, argc);
+}
+int RSSearchCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+}
+
+static int nullArray(RedisModuleCtx *, long) {
+  return REDISMODULE_OK;
+}
+static int nullLongLong(RedisModuleCtx *, long long) {
+  return REDISMODULE_OK;
+}
+static int nullDouble(RedisModuleCtx *, double) {
+  return REDISMODULE_OK;
+}
+static size_t bytesReplied_g = 0;
+static int nullStrBuf(RedisModuleCtx *, const char *, size_t n) {
+  bytesReplied_g += n;
+  return REDISMODULE_OK;
+}
+static int nullSimple(RedisModuleCtx *, const char *) {
+  return REDISMODULE_OK;
+}
+static int nullError(RedisModuleCtx *, const char *s) {
+  fprintf(stderr, "query error: %s\n", s);
+  return REDISMODULE_OK;
+}
+static int nullNull(RedisModuleCtx *) {
+  return REDISMODULE_OK;
+}
+static int nullRString(RedisModuleCtx *, RedisModuleString *) {
+  return REDISMODULE_OK;
+}
+static void nullSetArrayLength(RedisModuleCtx *, long) {}
+
+static void donecb(RSAddDocumentCtx *, RedisModuleCtx *, void *) {}
+
+static uint64_t nowUs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ull + ts.tv_nsec / 1000;
+}
+
+// deterministic corpus: xorshift with a fixed seed
+static uint32_t rngState_g = 0x12345678;
+static uint32_t rngNext(void) {
+  rngState_g ^= rngState_g << 13;
+  rngState_g ^= rngState_g >> 17;
+  rngState_g ^= rngState_g << 5;
+  return rngState_g;
+}
+
+#define VOCAB 5000
+#define DOC_WORDS 40
+
+static void makeDoc(char *buf, size_t cap, size_t docNum) {
+  size_t off = 0;
+  off += snprintf(buf + off, cap - off, "common ");
+  if (docNum % 100 == 0) {
+    off += snprintf(buf + off, cap - off, "rareterm ");
+  }
+  for (int w = 0; w < DOC_WORDS && off + 16 < cap; w++) {
+    // square the uniform variate for a crude zipf-ish skew
+    uint64_t u = rngNext() % VOCAB;
+    uint32_t rank = (uint32_t)((u * u) / VOCAB);
+    off += snprintf(buf + off, cap - off, "w%04u ", rank);
+  }
+}
+
+typedef struct {
+  std::string name;
+  std::vector<const char *> args;
+} QueryScenario;
+
+int main(int argc, char **argv) {
+  const char *baselinePath = NULL;
+  size_t numDocs = 20000;
+  bool update = false;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--baseline") && i + 1 < argc) {
+      baselinePath = argv[++i];
+    } else if (!strcmp(argv[i], "--docs") && i + 1 < argc) {
+      numDocs = strtoul(argv[++i], NULL, 10);
+    } else if (!strcmp(argv[i], "--update")) {
+      update = true;
+    } else {
+      fprintf(stderr, "usage: %s [--baseline file] [--docs n] [--update]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (!baselinePath) {
+    baselinePath = "baseline.txt";
+  }
+
+  const char *arguments[] = {"SAFEMODE", "NOGC"};
+  RMCK_Bootstrap(my_OnLoad, arguments, 2);
+  RSGlobalConfig.termsInSpec = 1;
+
+  RedisModule_ReplyWithArray = nullArray;
+  RedisModule_ReplyWithLongLong = nullLongLong;
+  RedisModule_ReplyWithDouble = nullDouble;
+  RedisModule_ReplyWithStringBuffer = nullStrBuf;
+  RedisModule_ReplyWithSimpleString = nullSimple;
+  RedisModule_ReplyWithError = nullError;
+  RedisModule_ReplyWithNull = nullNull;
+  RedisModule_ReplyWithString = nullRString;
+  RedisModule_ReplySetArrayLength = nullSetArrayLength;
+
+  RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(NULL);
+  QueryError qerr = {QueryErrorCode(0)};
+  RMCK::ArgvList args(ctx, "FT.CREATE", "perfidx", "SCHEMA", "body", "TEXT");
+  IndexSpec *spec = IndexSpec_CreateNew(ctx, args, args.size(), &qerr);
+  assert(spec);
+
+  // ---- scenario 1: ingest ----
+  uint64_t t0 = nowUs();
+  for (size_t i = 0; i < numDocs; i++) {
+    char key[32], body[640];
+    snprintf(key, sizeof key, "doc%07zu", i);
+    makeDoc(body, sizeof body, i);
+
+    RMCK::ArgvList fields(ctx, "body", body);
+    AddDocumentOptions options = {0};
+    options.options |= DOCUMENT_ADD_CURTHREAD;
+    options.numFieldElems = fields.size();
+    options.fieldsArray = fields;
+    options.donecb = donecb;
+    QueryError status = {QueryErrorCode(0)};
+    RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, spec);
+    RS_AddDocument(&sctx, RedisModule_CreateString(ctx, key, strlen(key)), &options, &status);
+    assert(!QueryError_HasError(&status));
+  }
+  double ingestSecs = (nowUs() - t0) / 1e6;
+
+  std::map<std::string, double> metrics;
+  metrics["ingest_docs_per_sec"] = numDocs / ingestSecs;
+
+  // ---- scenario 2: fixed query mix ----
+  QueryScenario scenarios[] = {
+      {"query_common_term", {"FT.SEARCH", "perfidx", "common", "NOCONTENT", "LIMIT", "0", "10"}},
+      {"query_rare_term", {"FT.SEARCH", "perfidx", "rareterm", "NOCONTENT", "LIMIT", "0", "10"}},
+      {"query_intersection",
+       {"FT.SEARCH", "perfidx", "common rareterm", "NOCONTENT", "LIMIT", "0", "10"}},
+      {"query_union", {"FT.SEARCH", "perfidx", "w0001|w0002|w0003", "NOCONTENT", "LIMIT", "0",
+                       "10"}},
+      {"query_phrase",
+       {"FT.SEARCH", "perfidx", "\"common rareterm\"", "NOCONTENT", "LIMIT", "0", "10"}},
+  };
+  const int QUERY_REPS = 200;
+  for (auto &sc : scenarios) {
+    RMCK::ArgvList q(ctx, &sc.args[0], sc.args.size());
+    // warmup
+    for (int r = 0; r < 5; r++) {
+      RSSearchCommand(ctx, q, q.size());
+    }
+    t0 = nowUs();
+    for (int r = 0; r < QUERY_REPS; r++) {
+      RSSearchCommand(ctx, q, q.size());
+    }
+    double secs = (nowUs() - t0) / 1e6;
+    metrics[sc.name + "_qps"] = QUERY_REPS / secs;
+  }
+
+  // ---- baseline comparison ----
+  std::map<std::string, std::pair<double, double>> baseline;  // name -> (value, tolerance)
+  {
+    std::ifstream in(baselinePath);
+    std::string name;
+    double value, tol;
+    while (in >> name >> value >> tol) {
+      baseline[name] = {value, tol};
+    }
+  }
+
+  int failures = 0;
+  for (auto &m : metrics) {
+    auto it = baseline.find(m.first);
+    if (it == baseline.end()) {
+      printf("METRIC %s %.1f - - NEW\n", m.first.c_str(), m.second);
+      continue;
+    }
+    double base = it->second.first, tol = it->second.second;
+    bool ok = m.second >= base * (1.0 - tol);
+    printf("METRIC %s %.1f %.1f %.2f %s\n", m.first.c_str(), m.second, base, tol,
+           ok ? "OK" : "REGRESSION");
+    if (!ok) {
+      failures++;
+    }
+  }
+
+  if (update) {
+    std::ofstream out(baselinePath);
+    for (auto &m : metrics) {
+      double tol = 0.5;
+      auto it = baseline.find(m.first);
+      if (it != baseline.end()) {
+        tol = it->second.second;
+      }
+      out << m.first << " " << m.second << " " << tol << "\n";
+    }
+    fprintf(stderr, "baseline updated: %s\n", baselinePath);
+  }
+
+  IndexSpec_Free(spec);
+  if (failures) {
+    fprintf(stderr, "%d metric(s) regressed beyond tolerance\n", failures);
+    return 1;
+  }
+  printf("perf scenarios within tolerance\n");
+  return 0;
+}
@@ -0,0 +1,372 @@
+#include "profile.h"
+#include "rmalloc.h"
+#include "util/arr.h"
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+static inline uint64_t profNowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/****************************** iterator wrapper ******************************/
+
+typedef struct {
+  IndexIterator base;
+  IndexIterator *child;
+  ProfileIterNode *node;
+} ProfileIterator;
+
+/* The composite iterators read (and the union also writes) the child's
+ * cached isValid field through the IITER macros, so the wrapper mirrors the
+ * inner iterator's validity after every call that can change it */
+#define PI_SYNC(pi) ((pi)->base.isValid = (pi)->child->isValid)
+
+static int pi_Read(void *ctx, RSIndexResult **e) {
+  ProfileIterator *pi = ctx;
+  uint64_t t0 = profNowNs();
+  int rc = pi->child->Read(pi->child->ctx, e);
+  pi->node->ns += profNowNs() - t0;
+  pi->node->reads++;
+  PI_SYNC(pi);
+  return rc;
+}
+
+static int pi_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
+  ProfileIterator *pi = ctx;
+  uint64_t t0 = profNowNs();
+  int rc = pi->child->SkipTo(pi->child->ctx, docId, hit);
+  pi->node->ns += profNowNs() - t0;
+  pi->node->skips++;
+  if (rc != INDEXREAD_OK) {
+    pi->node->skipMisses++;
+  }
+  PI_SYNC(pi);
+  return rc;
+}
+
+static size_t pi_ReadBatch(void *ctx, RSIndexResult *results, size_t limit) {
+  ProfileIterator *pi = ctx;
+  uint64_t t0 = profNowNs();
+  size_t n = pi->child->ReadBatch(pi->child->ctx, results, limit);
+  pi->node->ns += profNowNs() - t0;
+  pi->node->reads += n;
+  PI_SYNC(pi);
+  return n;
+}
+
+static RSIndexResult *pi_GetCurrent(void *ctx) {
+  ProfileIterator *pi = ctx;
+  return IITER_CURRENT_RECORD(pi->child);
+}
+
+static size_t pi_NumEstimated(void *ctx) {
+  ProfileIterator *pi = ctx;
+  return pi->child->NumEstimated(pi->child->ctx);
+}
+
+static IndexCriteriaTester *pi_GetCriteriaTester(void *ctx) {
+  ProfileIterator *pi = ctx;
+  return pi->child->GetCriteriaTester(pi->child->ctx);
+}
+
+static t_docId pi_LastDocId(void *ctx) {
+  ProfileIterator *pi = ctx;
+  return pi->child->LastDocId(pi->child->ctx);
+}
+
+static int pi_HasNext(void *ctx) {
+  ProfileIterator *pi = ctx;
+  return IITER_HAS_NEXT(pi->child);
+}
+
+static size_t pi_Len(void *ctx) {
+  ProfileIterator *pi = ctx;
+  return pi->child->Len(pi->child->ctx);
+}
+
+static void pi_Abort(void *ctx) {
+  ProfileIterator *pi = ctx;
+  if (pi->child->Abort) {
+    pi->child->Abort(pi->child->ctx);
+  }
+  PI_SYNC(pi);
+}
+
+static void pi_Rewind(void *ctx) {
+  ProfileIterator *pi = ctx;
+  pi->child->Rewind(pi->child->ctx);
+  PI_SYNC(pi);
+}
+
+static void pi_SetMaxScoreThresholdRef(void *ctx, const double *ref) {
+  ProfileIterator *pi = ctx;
+  pi->child->SetMaxScoreThresholdRef(pi->child->ctx, ref);
+}
+
+static double pi_GetMaxScoreBound(void *ctx) {
+  ProfileIterator *pi = ctx;
+  return pi->child->GetMaxScoreBound(pi->child->ctx);
+}
+
+static void pi_Free(IndexIterator *self) {
+  ProfileIterator *pi = self->ctx;
+  pi->child->Free(pi->child);
+  rm_free(pi);
+}
+
+static IndexIterator *profileIterator_New(IndexIterator *child, ProfileIterNode *node) {
+  ProfileIterator *pi = rm_calloc(1, sizeof(*pi));
+  pi->child = child;
+  pi->node = node;
+  IndexIterator *it = &pi->base;
+  it->ctx = pi;
+  it->mode = child->mode;
+  it->isValid = child->isValid;
+  it->GetCurrent = pi_GetCurrent;
+  it->NumEstimated = pi_NumEstimated;
+  it->GetCriteriaTester = child->GetCriteriaTester ? pi_GetCriteriaTester : NULL;
+  it->Read = pi_Read;
+  it->SkipTo = child->SkipTo ? pi_SkipTo : NULL;
+  it->LastDocId = pi_LastDocId;
+  it->HasNext = pi_HasNext;
+  it->Free = pi_Free;
+  it->Len = pi_Len;
+  it->Abort = pi_Abort;
+  it->Rewind = pi_Rewind;
+  it->SetMaxScoreThresholdRef = child->SetMaxScoreThresholdRef ? pi_SetMaxScoreThresholdRef : NULL;
+  it->ReadBatch = child->ReadBatch ? pi_ReadBatch : NULL;
+  it->GetMaxScoreBound = child->GetMaxScoreBound ? pi_GetMaxScoreBound : NULL;
+  return it;
+}
+
+/****************************** processor wrapper ******************************/
+
+typedef struct RPProfile {
+  ResultProcessor base;
+  uint64_t rows;
+  uint64_t ns;
+} RPProfile;
+
+static int rpProfileNext(ResultProcessor *base, SearchResult *res) {
+  RPProfile *self = (RPProfile *)base;
+  uint64_t t0 = profNowNs();
+  int rc = base->upstream->Next(base->upstream, res);
+  self->ns += profNowNs() - t0;
+  if (rc == RS_RESULT_OK) {
+    self->rows++;
+  }
+  return rc;
+}
+
+static int rpProfileNextChunk(ResultProcessor *base, ResultChunk *chunk) {
+  RPProfile *self = (RPProfile *)base;
+  uint64_t t0 = profNowNs();
+  int rc = base->upstream->NextChunk(base->upstream, chunk);
+  self->ns += profNowNs() - t0;
+  if (rc == RS_RESULT_OK) {
+    self->rows += chunk->len;
+  }
+  return rc;
+}
+
+static void rpProfileFree(ResultProcessor *base) {
+  free(base);
+}
+
+/****************************** QueryProfile ******************************/
+
+QueryProfile *QueryProfile_New(void) {
+  QueryProfile *p = rm_calloc(1, sizeof(*p));
+  p->stack = array_new(ProfileIterNode *, 8);
+  p->rps = array_new(struct RPProfile *, 8);
+  return p;
+}
+
+static void profNodeFree(ProfileIterNode *n) {
+  if (!n) {
+    return;
+  }
+  for (size_t i = 0; i < array_len(n->children); ++i) {
+    profNodeFree(n->children[i]);
+  }
+  array_free(n->children);
+  rm_free(n->name);
+  rm_free(n);
+}
+
+void QueryProfile_Free(QueryProfile *p) {
+  if (!p) {
+    return;
+  }
+  profNodeFree(p->iterRoot);
+  array_free(p->stack);
+  array_free(p->rps);  // the profilers themselves are freed with the pipeline
+  rm_free(p);
+}
+
+static char *profNodeName(const QueryNode *n) {
+  switch (n->type) {
+    case QN_TOKEN: {
+      char buf[128];
+      snprintf(buf, sizeof(buf), "TERM %.*s", (int)n->tn.len, n->tn.str ? n->tn.str : "");
+      return rm_strdup(buf);
+    }
+    case QN_PHRASE:
+      return rm_strdup(n->pn.exact ? "EXACT-PHRASE" : "INTERSECT");
+    case QN_UNION:
+      return rm_strdup("UNION");
+    case QN_NUMERIC:
+      return rm_strdup("NUMERIC");
+    case QN_NOT:
+      return rm_strdup("NOT");
+    case QN_OPTIONAL:
+      return rm_strdup("OPTIONAL");
+    case QN_GEO:
+      return rm_strdup("GEO");
+    case QN_PREFX:
+      return rm_strdup("PREFIX");
+    case QN_IDS:
+      return rm_strdup("IDS");
+    case QN_WILDCARD:
+      return rm_strdup("WILDCARD");
+    case QN_TAG:
+      return rm_strdup("TAG");
+    case QN_FUZZY:
+      return rm_strdup("FUZZY");
+    case QN_LEXRANGE:
+      return rm_strdup("LEXRANGE");
+    default:
+      return rm_strdup("UNKNOWN");
+  }
+}
+
+void QueryProfile_EnterNode(QueryProfile *p, const QueryNode *n) {
+  ProfileIterNode *pn = rm_calloc(1, sizeof(*pn));
+  pn->name = profNodeName(n);
+  pn->children = array_new(ProfileIterNode *, 4);
+  if (array_len(p->stack)) {
+    ProfileIterNode *parent = p->stack[array_len(p->stack) - 1];
+    parent->children = array_append(parent->children, pn);
+  } else {
+    p->iterRoot = pn;
+  }
+  p->stack = array_append(p->stack, pn);
+}
+
+IndexIterator *QueryProfile_WrapIterator(QueryProfile *p, IndexIterator *it) {
+  ProfileIterNode *pn = p->stack[array_len(p->stack) - 1];
+  p->stack = array_trimm_len(p->stack, array_len(p->stack) - 1);
+  if (!it) {
+    return NULL;
+  }
+  return profileIterator_New(it, pn);
+}
+
+void QueryProfile_InstrumentPipeline(QueryProfile *p, QueryIterator *qitr) {
+  // Insert a profiler above every processor, starting from the root so the
+  // recorded order matches execution order. qitr->rootProc must keep
+  // pointing at the original index processor (QITR_GetRootFilter casts it)
+  ResultProcessor *chain[64];
+  size_t n = 0;
+  for (ResultProcessor *rp = qitr->endProc; rp && n < 64; rp = rp->upstream) {
+    chain[n++] = rp;
+  }
+  // walk from the root end
+  for (size_t i = n; i > 0; --i) {
+    ResultProcessor *rp = chain[i - 1];
+    RPProfile *prof = calloc(1, sizeof(*prof));
+    prof->base.name = rp->name;
+    prof->base.parent = qitr;
+    prof->base.upstream = rp;
+    prof->base.Next = rpProfileNext;
+    if (rp->NextChunk) {
+      prof->base.NextChunk = rpProfileNextChunk;
+    }
+    prof->base.Free = rpProfileFree;
+    if (i > 1) {
+      // splice between rp and its downstream processor
+      chain[i - 2]->upstream = &prof->base;
+    } else {
+      qitr->endProc = &prof->base;
+    }
+    p->rps = array_append(p->rps, prof);
+  }
+}
+
+static size_t profReplyIterNode(const ProfileIterNode *n, RedisModuleCtx *ctx) {
+  size_t nelem = 0;
+  RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+  RedisModule_ReplyWithSimpleString(ctx, "Type");
+  RedisModule_ReplyWithSimpleString(ctx, n->name);
+  RedisModule_ReplyWithSimpleString(ctx, "Reads");
+  RedisModule_ReplyWithLongLong(ctx, n->reads);
+  RedisModule_ReplyWithSimpleString(ctx, "Skips");
+  RedisModule_ReplyWithLongLong(ctx, n->skips);
+  RedisModule_ReplyWithSimpleString(ctx, "Skip misses");
+  RedisModule_ReplyWithLongLong(ctx, n->skipMisses);
+  RedisModule_ReplyWithSimpleString(ctx, "Time (ns)");
+  RedisModule_ReplyWithLongLong(ctx, n->ns);
+  nelem = 10;
+  if (array_len(n->children)) {
+    RedisModule_ReplyWithSimpleString(ctx, "Children");
+    RedisModule_ReplyWithArray(ctx, array_len(n->children));
+    for (size_t i = 0; i < array_len(n->children); ++i) {
+      profReplyIterNode(n->children[i], ctx);
+    }
+    nelem += 2;
+  }
+  RedisModule_ReplySetArrayLength(ctx, nelem);
+  return nelem;
+}
+
+static sds profFormatIterNode(sds s, const ProfileIterNode *n, int depth) {
+  s = sdscatprintf(s, "%*s%s reads=%llu skips=%llu misses=%llu ns=%llu\n", depth * 2, "", n->name,
+                   (unsigned long long)n->reads, (unsigned long long)n->skips,
+                   (unsigned long long)n->skipMisses, (unsigned long long)n->ns);
+  for (size_t i = 0; i < array_len(n->children); ++i) {
+    s = profFormatIterNode(s, n->children[i], depth + 1);
+  }
+  return s;
+}
+
+sds QueryProfile_Format(const QueryProfile *p, sds s) {
+  if (p->iterRoot) {
+    s = profFormatIterNode(s, p->iterRoot, 0);
+  }
+  for (size_t i = 0; i < array_len(p->rps); ++i) {
+    const RPProfile *rp = p->rps[i];
+    s = sdscatprintf(s, "%s rows=%llu ns=%llu\n", rp->base.name, (unsigned long long)rp->rows,
+                     (unsigned long long)rp->ns);
+  }
+  return s;
+}
+
+void QueryProfile_Reply(const QueryProfile *p, RedisModuleCtx *ctx) {
+  RedisModule_ReplyWithArray(ctx, 2);
+
+  // Iterator tree
+  RedisModule_ReplyWithArray(ctx, 2);
+  RedisModule_ReplyWithSimpleString(ctx, "Iterators profile");
+  if (p->iterRoot) {
+    profReplyIterNode(p->iterRoot, ctx);
+  } else {
+    RedisModule_ReplyWithNull(ctx);
+  }
+
+  // Processor chain, root to end
+  RedisModule_ReplyWithArray(ctx, 1 + array_len(p->rps));
+  RedisModule_ReplyWithSimpleString(ctx, "Result processors profile");
+  for (size_t i = 0; i < array_len(p->rps); ++i) {
+    const RPProfile *rp = p->rps[i];
+    RedisModule_ReplyWithArray(ctx, 6);
+    RedisModule_ReplyWithSimpleString(ctx, "Type");
+    RedisModule_ReplyWithSimpleString(ctx, rp->base.name);
+    RedisModule_ReplyWithSimpleString(ctx, "Rows");
+    RedisModule_ReplyWithLongLong(ctx, rp->rows);
+    RedisModule_ReplyWithSimpleString(ctx, "Time (ns)");
+    RedisModule_ReplyWithLongLong(ctx, rp->ns);
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "redismodule.h"
+#include "rmutil/sds.h"
+#include "index_iterator.h"
+#include "query_node.h"
+#include "result_processor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Instrumentation for FT.PROFILE: every index iterator the query evaluation
+ * produces is wrapped with a counting/timing decorator mirroring the AST's
+ * shape, and a timing processor is inserted above every result processor in
+ * the pipeline. With no profile attached (the normal case) nothing is
+ * wrapped and no overhead is paid */
+
+/* Per-iterator counters, arranged as a tree mirroring the query AST. Nodes
+ * are owned by the QueryProfile and outlive the iterators they instrument */
+typedef struct ProfileIterNode {
+  char *name;
+  struct ProfileIterNode **children;  // util/arr
+  uint64_t reads;
+  uint64_t skips;
+  uint64_t skipMisses;  // SkipTo calls that did not land on the target id
+  uint64_t ns;          // cumulative time inside Read/SkipTo/ReadBatch
+} ProfileIterNode;
+
+typedef struct QueryProfile {
+  ProfileIterNode *iterRoot;
+  /* Evaluation stack: the node whose subtree is currently being built */
+  ProfileIterNode **stack;  // util/arr
+  /* Pipeline profilers in upstream-to-downstream order; they stay alive
+   * until the request is freed, after the profile is rendered */
+  struct RPProfile **rps;  // util/arr
+} QueryProfile;
+
+QueryProfile *QueryProfile_New(void);
+void QueryProfile_Free(QueryProfile *p);
+
+/* Called by Query_EvalNode around each AST node's evaluation: Enter pushes a
+ * counter node named after `n`, Wrap pops it and returns `it` wrapped with
+ * the counting decorator (or `it` unchanged when it is NULL) */
+void QueryProfile_EnterNode(QueryProfile *p, const QueryNode *n);
+IndexIterator *QueryProfile_WrapIterator(QueryProfile *p, IndexIterator *it);
+
+/* Insert a timing processor above every processor in the built pipeline */
+void QueryProfile_InstrumentPipeline(QueryProfile *p, QueryIterator *qitr);
+
+/* Render the counters: [iterator tree, processor timings] */
+void QueryProfile_Reply(const QueryProfile *p, RedisModuleCtx *ctx);
+
+/* Append a compact text rendering of the profile (iterator tree and processor
+ * timings) to `s` - the slow log's per-stage attribution */
+sds QueryProfile_Format(const QueryProfile *p, sds s);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -5,6 +5,7 @@
 #include "buffer.h"
 #include "rmalloc.h"
 #include "qint.h"
+#include "cpu_dispatch.h"
 
 QINT_API size_t qint_encode(BufferWriter *bw, uint32_t arr[], int len) {
   if (len <= 0 || len > 4) return 0;
@@ -109,6 +110,111 @@ QINT_API size_t qint_encode4(BufferWriter *bw, uint32_t i1, uint32_t i2, uint32_
   return ret;
 }
 
+/******************************************************************************
+ * Vectorized decoding.
+ *
+ * The qint layout (leading control byte + 1..4 byte fields) is the same shape
+ * as group varint, so on x86 we can decode a whole group with one pshufb: a
+ * 256-entry table maps the control byte to a shuffle mask which scatters the
+ * packed field bytes into four 32 bit lanes. The scalar path remains both as a
+ * fallback for CPUs without SSSE3 and for groups close enough to the end of
+ * the buffer that an unaligned 16 byte load could touch unallocated memory.
+ ******************************************************************************/
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define QINT_HAVE_SSSE3_DECODE 1
+#include <tmmintrin.h>
+
+typedef struct {
+  uint8_t shuffle[16];
+  /* sizes[k]: total encoded size (control byte included) when the group holds k+1 fields */
+  uint8_t sizes[4];
+} qintShuffleEntry;
+
+QINT_API qintShuffleEntry qint_shuffleTable[256];
+QINT_API int qint_canUseSSSE3 = 0;
+
+/* The largest group: control byte + 4 * 4 byte fields. A SIMD decode loads 16 bytes past the
+ * control byte, so it requires this many readable bytes regardless of the actual group size */
+#define QINT_SIMD_MINBYTES 17
+
+__attribute__((constructor)) static void qint_initShuffleTable(void) {
+  for (int header = 0; header < 256; header++) {
+    qintShuffleEntry *e = &qint_shuffleTable[header];
+    int src = 0;
+    for (int field = 0; field < 4; field++) {
+      int nbytes = ((header >> (field * 2)) & 0x03) + 1;
+      for (int b = 0; b < 4; b++) {
+        // 0x80 in a pshufb mask zeroes the destination byte
+        e->shuffle[field * 4 + b] = b < nbytes ? src + b : 0x80;
+      }
+      src += nbytes;
+      e->sizes[field] = src + 1;
+    }
+  }
+}
+
+static void qint_initDispatch(void) {
+  qint_canUseSSSE3 = RSCpu_Level() >= RS_CPU_SSSE3;
+}
+
+__attribute__((constructor)) static void qint_registerDispatch(void) {
+  RSCpu_RegisterDispatch(qint_initDispatch);
+}
+
+__attribute__((target("ssse3"))) static inline __m128i qint_shuffleGroup(BufferReader *br) {
+  const uint8_t *p = (uint8_t *)BufferReader_Current(br);
+  __m128i data = _mm_loadu_si128((const __m128i *)(p + 1));
+  __m128i mask = _mm_loadu_si128((const __m128i *)qint_shuffleTable[*p].shuffle);
+  return _mm_shuffle_epi8(data, mask);
+}
+
+/* A SIMD decode is only legal when the reader has enough readable bytes left for a full-width
+ * load. `cap` covers allocated (not merely written) memory, which is all the load touches */
+#define QINT_SIMD_SAFE(br) \
+  (qint_canUseSSSE3 && (br)->buf->cap - (br)->pos >= QINT_SIMD_MINBYTES)
+
+__attribute__((target("ssse3"))) static size_t qint_decode2_ssse3(BufferReader *br, uint32_t *i,
+                                                                  uint32_t *i2) {
+  uint32_t vals[4];
+  const uint8_t *p = (uint8_t *)BufferReader_Current(br);
+  size_t sz = qint_shuffleTable[*p].sizes[1];
+  _mm_storeu_si128((__m128i *)vals, qint_shuffleGroup(br));
+  *i = vals[0];
+  *i2 = vals[1];
+  Buffer_Skip(br, sz);
+  return sz;
+}
+
+__attribute__((target("ssse3"))) static size_t qint_decode3_ssse3(BufferReader *br, uint32_t *i,
+                                                                  uint32_t *i2, uint32_t *i3) {
+  uint32_t vals[4];
+  const uint8_t *p = (uint8_t *)BufferReader_Current(br);
+  size_t sz = qint_shuffleTable[*p].sizes[2];
+  _mm_storeu_si128((__m128i *)vals, qint_shuffleGroup(br));
+  *i = vals[0];
+  *i2 = vals[1];
+  *i3 = vals[2];
+  Buffer_Skip(br, sz);
+  return sz;
+}
+
+__attribute__((target("ssse3"))) static size_t qint_decode4_ssse3(BufferReader *br, uint32_t *i,
+                                                                  uint32_t *i2, uint32_t *i3,
+                                                                  uint32_t *i4) {
+  uint32_t vals[4];
+  const uint8_t *p = (uint8_t *)BufferReader_Current(br);
+  size_t sz = qint_shuffleTable[*p].sizes[3];
+  _mm_storeu_si128((__m128i *)vals, qint_shuffleGroup(br));
+  *i = vals[0];
+  *i2 = vals[1];
+  *i3 = vals[2];
+  *i4 = vals[3];
+  Buffer_Skip(br, sz);
+  return sz;
+}
+#endif  // __x86_64__
+
 #define QINT_DECODE_VALUE(lval, bits, ptr, nused) \
   do {                                            \
     switch (bits) {                               \
@@ -167,6 +273,11 @@ QINT_API size_t qint_decode1(BufferReader *br, uint32_t *i) {
 }
 
 QINT_API size_t qint_decode2(BufferReader *br, uint32_t *i, uint32_t *i2) {
+#ifdef QINT_HAVE_SSSE3_DECODE
+  if (QINT_SIMD_SAFE(br)) {
+    return qint_decode2_ssse3(br, i, i2);
+  }
+#endif
   const uint8_t *p = (uint8_t *)BufferReader_Current(br);
   size_t total = 0, tmp = 0;
   QINT_DECODE_MULTI(*i, 0, p, total, tmp);
@@ -176,6 +287,11 @@ QINT_API size_t qint_decode2(BufferReader *br, uint32_t *i, uint32_t *i2) {
 }
 
 QINT_API size_t qint_decode3(BufferReader *br, uint32_t *i, uint32_t *i2, uint32_t *i3) {
+#ifdef QINT_HAVE_SSSE3_DECODE
+  if (QINT_SIMD_SAFE(br)) {
+    return qint_decode3_ssse3(br, i, i2, i3);
+  }
+#endif
   const uint8_t *p = (uint8_t *)BufferReader_Current(br);
   size_t total = 0, tmp = 0;
   QINT_DECODE_MULTI(*i, 0, p, total, tmp);
@@ -187,6 +303,11 @@ QINT_API size_t qint_decode3(BufferReader *br, uint32_t *i, uint32_t *i2, uint32
 
 QINT_API size_t qint_decode4(BufferReader *br, uint32_t *i, uint32_t *i2, uint32_t *i3,
                              uint32_t *i4) {
+#ifdef QINT_HAVE_SSSE3_DECODE
+  if (QINT_SIMD_SAFE(br)) {
+    return qint_decode4_ssse3(br, i, i2, i3, i4);
+  }
+#endif
   const uint8_t *p = (uint8_t *)BufferReader_Current(br);
   size_t total = 0, tmp = 0;
   QINT_DECODE_MULTI(*i, 0, p, total, tmp);
@@ -9,6 +9,10 @@
 #define QINT_API
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* QInt - fast encoding and decoding of up to 4 unsinged 32 bit integers  as variable width
  * integers. The algorithm uses a leading byte to encode the size of each integer in bits, and has a
  * table for the actual offsets of each integer, per possible leading byte */
@@ -49,4 +53,8 @@ QINT_API size_t qint_decode3(BufferReader *br, uint32_t *i, uint32_t *i2, uint32
 QINT_API size_t qint_decode4(BufferReader *br, uint32_t *i, uint32_t *i2, uint32_t *i3,
                              uint32_t *i4);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
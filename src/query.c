@@ -7,6 +7,7 @@
 #include "geo_index.h"
 #include "index.h"
 #include "query.h"
+#include "profile.h"
 #include "config.h"
 #include "query_parser/parser.h"
 #include "redis_index.h"
@@ -26,40 +27,85 @@
 
 static IndexIterator *getEOFIterator(void);
 
+/* Active per-query AST arena. Set around parsing, expansion and cache-hit
+ * cloning; node and child-array storage then comes from one bump allocator
+ * and teardown is a single arena reset instead of a recursive free. NULL
+ * (e.g. in unit tests constructing nodes directly) falls back to malloc,
+ * which the per-node QueryNode_InArena flag keeps distinguishable */
+static __thread BlkAlloc *queryASTArena_tls = NULL;
+
+#define QUERY_ARENA_BLOCK 4096
+
+static void *astAlloc(size_t n) {
+  if (queryASTArena_tls) {
+    // Round to 16 so every arena pointer satisfies the widest member
+    // alignment (the 128-bit field masks); the block data is 16-aligned
+    n = (n + 15) & ~(size_t)15;
+    void *p = BlkAlloc_Alloc(queryASTArena_tls, n, n > QUERY_ARENA_BLOCK ? n : QUERY_ARENA_BLOCK);
+    memset(p, 0, n);
+    return p;
+  }
+  return calloc(1, n);
+}
+
+/* Grow a node's child array by `need` slots, following the parent's storage
+ * mode. Arena growth abandons the old array in the arena (bounded waste,
+ * geometric growth); malloc'd parents realloc as before */
+static QueryNode **astGrowChildren(QueryNode *parent, QueryNode **children, int numChildren,
+                                   int *capChildren, int need) {
+  if (numChildren + need <= *capChildren) {
+    return children;
+  }
+  int newcap = *capChildren ? *capChildren * 2 : 4;
+  while (newcap < numChildren + need) {
+    newcap *= 2;
+  }
+  if (parent->opts.flags & QueryNode_InArena) {
+    assert(queryASTArena_tls);  // arena nodes only grow while their AST phase is active
+    QueryNode **fresh = astAlloc(newcap * sizeof(*fresh));
+    memcpy(fresh, children, numChildren * sizeof(*fresh));
+    children = fresh;
+  } else {
+    children = realloc(children, newcap * sizeof(*children));
+  }
+  *capChildren = newcap;
+  return children;
+}
+
 static void QueryTokenNode_Free(QueryTokenNode *tn) {
 
   if (tn->str) free(tn->str);
 }
 
-static void QueryPhraseNode_Free(QueryPhraseNode *pn) {
+static void QueryPhraseNode_Free(QueryPhraseNode *pn, int inArena) {
   for (int i = 0; i < pn->numChildren; i++) {
     QueryNode_Free(pn->children[i]);
   }
-  if (pn->children) {
+  if (pn->children && !inArena) {
     free(pn->children);
-    pn->children = NULL;
   }
+  pn->children = NULL;
 }
 
-static void QueryUnionNode_Free(QueryUnionNode *pn) {
+static void QueryUnionNode_Free(QueryUnionNode *pn, int inArena) {
   for (int i = 0; i < pn->numChildren; i++) {
     QueryNode_Free(pn->children[i]);
   }
-  if (pn->children) {
+  if (pn->children && !inArena) {
     free(pn->children);
-    pn->children = NULL;
   }
+  pn->children = NULL;
 }
 
-static void QueryTagNode_Free(QueryTagNode *tag) {
+static void QueryTagNode_Free(QueryTagNode *tag, int inArena) {
 
   for (int i = 0; i < tag->numChildren; i++) {
     QueryNode_Free(tag->children[i]);
   }
-  if (tag->children) {
+  if (tag->children && !inArena) {
     free(tag->children);
-    tag->children = NULL;
   }
+  tag->children = NULL;
   free((char *)tag->fieldName);
 }
 
@@ -71,15 +117,16 @@ static void QueryLexRangeNode_Free(QueryLexRangeNode *lx) {
 
 void QueryNode_Free(QueryNode *n) {
   if (!n) return;
+  const int inArena = !!(n->opts.flags & QueryNode_InArena);
   switch (n->type) {
     case QN_TOKEN:
       QueryTokenNode_Free(&n->tn);
       break;
     case QN_PHRASE:
-      QueryPhraseNode_Free(&n->pn);
+      QueryPhraseNode_Free(&n->pn, inArena);
       break;
     case QN_UNION:
-      QueryUnionNode_Free(&n->un);
+      QueryUnionNode_Free(&n->un, inArena);
       break;
     case QN_NUMERIC:
       NumericFilter_Free((void *)n->nn.nf);
@@ -103,6 +150,10 @@ void QueryNode_Free(QueryNode *n) {
       QueryTokenNode_Free(&n->fz.tok);
       break;
     case QN_LEXRANGE:
+      if (n->opts.flags & QueryNode_OwnsStrings) {
+        free((char *)n->lxrng.begin);
+        free((char *)n->lxrng.end);
+      }
       QueryLexRangeNode_Free(&n->lxrng);
       break;
     case QN_WILDCARD:
@@ -110,17 +161,19 @@ void QueryNode_Free(QueryNode *n) {
       break;
 
     case QN_TAG:
-      QueryTagNode_Free(&n->tag);
+      QueryTagNode_Free(&n->tag, inArena);
       break;
 
     case QN_NULL:
       break;
   }
-  free(n);
+  if (!inArena) {
+    free(n);
+  }
 }
 
 QueryNode *NewQueryNode(QueryNodeType type) {
-  QueryNode *s = calloc(1, sizeof(QueryNode));
+  QueryNode *s = astAlloc(sizeof(QueryNode));
   s->type = type;
   s->opts = (QueryNodeOptions){
       .fieldMask = RS_FIELDMASK_ALL,
@@ -129,6 +182,9 @@ QueryNode *NewQueryNode(QueryNodeType type) {
       .inOrder = 0,
       .weight = 1,
   };
+  if (queryASTArena_tls) {
+    s->opts.flags |= QueryNode_InArena;
+  }
   return s;
 }
 
@@ -309,8 +365,20 @@ IndexIterator *Query_EvalTokenNode(QueryEvalCtx *q, QueryNode *qn) {
 
   // printf("Opening reader.. `%s` FieldMask: %llx\n", term->str, EFFECTIVE_FIELDMASK(q, qn));
 
+  if (q->sctx->spec->partitionSpan > 0) {
+    IndexIterator *it = Redis_OpenPartitionedTermIterator(
+        q->sctx, term, q->docTable, EFFECTIVE_FIELDMASK(q, qn), q->conc, qn->opts.weight);
+    if (!it) {
+      Term_Free(term);
+    }
+    return it;
+  }
+
   IndexReader *ir = Redis_OpenReader(q->sctx, term, q->docTable, isSingleWord,
                                      EFFECTIVE_FIELDMASK(q, qn), q->conc, qn->opts.weight);
+  if (ir && q->skipOffsets) {
+    IndexReader_SetSkipOffsetVectors(ir);
+  }
   if (ir == NULL) {
     Term_Free(term);
     return NULL;
@@ -319,22 +387,210 @@ IndexIterator *Query_EvalTokenNode(QueryEvalCtx *q, QueryNode *qn) {
   return NewReadIterator(ir);
 }
 
+/******************************************************************************
+ * Prefix-expansion cache.
+ *
+ * Storefront-style traffic sends the same prefix queries over and over, and
+ * each one walks the trie to expand into up to maxPrefixExpansions terms.
+ * The expansion result depends only on the terms dictionary, so the expanded
+ * term list is kept in a small LRU keyed by "<spec uniqueId>/<prefix>" and
+ * validated against the spec's termsEpoch, which IndexSpec_AddTerm bumps on
+ * every new term: a hit skips the trie walk and goes straight to opening the
+ * term readers. Fuzzy expansions stay uncached. Entries of dropped specs age
+ * out through the LRU - unique ids are never reused, so they can only miss.
+ ******************************************************************************/
+
+#include "util/dllist.h"
+
+#define PREFIX_CACHE_MAX_ENTRIES 1024
+// Don't cache absurdly wide expansions (possible when maxPrefixExpansions is
+// unlimited)
+#define PREFIX_CACHE_MAX_TERMS 1024
+
+typedef struct {
+  DLLIST_node lru;
+  char *key;
+  uint64_t epoch;  // spec->termsEpoch when the entry was filled
+  char **terms;    // expanded terms, owned
+  uint32_t *lens;
+  size_t nterms;
+  int truncated;  // the walk stopped at the expansion limit
+} PrefixCacheEntry;
+
+static dict *prefixCache = NULL;
+static DLLIST prefixCacheLRU;
+
+static char *prefixCacheKey(const IndexSpec *sp, const char *prefix, size_t len) {
+  char *ret = rm_malloc(len + 24);
+  size_t n = snprintf(ret, len + 24, "%llu/", (unsigned long long)sp->uniqueId);
+  memcpy(ret + n, prefix, len);
+  ret[n + len] = '\0';
+  return ret;
+}
+
+static void prefixCacheEvict(PrefixCacheEntry *e) {
+  dllist_delete(&e->lru);
+  dictDelete(prefixCache, e->key);
+  for (size_t i = 0; i < e->nterms; i++) {
+    free(e->terms[i]);
+  }
+  rm_free(e->terms);
+  rm_free(e->lens);
+  rm_free(e->key);
+  rm_free(e);
+}
+
+static PrefixCacheEntry *PrefixCache_Get(const IndexSpec *sp, const char *prefix, size_t len) {
+  if (!prefixCache) {
+    return NULL;
+  }
+  char *key = prefixCacheKey(sp, prefix, len);
+  PrefixCacheEntry *e = dictFetchValue(prefixCache, key);
+  rm_free(key);
+  if (!e) {
+    return NULL;
+  }
+  if (e->epoch != sp->termsEpoch) {
+    // New terms entered the dictionary since the entry was filled
+    prefixCacheEvict(e);
+    return NULL;
+  }
+  dllist_delete(&e->lru);
+  dllist_prepend(&prefixCacheLRU, &e->lru);
+  return e;
+}
+
+/* Takes ownership of terms/lens (and the strings within) */
+static void PrefixCache_Put(const IndexSpec *sp, const char *prefix, size_t len, char **terms,
+                            uint32_t *lens, size_t nterms, int truncated) {
+  if (!prefixCache) {
+    prefixCache = dictCreate(&dictTypeHeapStrings, NULL);
+    dllist_init(&prefixCacheLRU);
+  }
+  char *key = prefixCacheKey(sp, prefix, len);
+  PrefixCacheEntry *old = dictFetchValue(prefixCache, key);
+  if (old) {
+    prefixCacheEvict(old);  // stale epoch - replace
+  }
+  if (dictSize(prefixCache) >= PREFIX_CACHE_MAX_ENTRIES) {
+    prefixCacheEvict(DLLIST_ITEM(prefixCacheLRU.prev, PrefixCacheEntry, lru));
+  }
+  PrefixCacheEntry *e = rm_malloc(sizeof(*e));
+  e->key = key;
+  e->epoch = sp->termsEpoch;
+  e->terms = terms;
+  e->lens = lens;
+  e->nterms = nterms;
+  e->truncated = truncated;
+  dictAdd(prefixCache, key, e);
+  dllist_prepend(&prefixCacheLRU, &e->lru);
+}
+
+/* Open a reader for one expanded term and append it to the iterator array */
+static void addExpandedTerm(QueryEvalCtx *q, const char *str, uint32_t len,
+                            QueryNodeOptions *opts, IndexIterator ***its, size_t *itsSz,
+                            size_t *itsCap) {
+  RSToken tok = (RSToken){
+      .str = (char *)str,
+      .len = len,
+      .expanded = 0,
+      .flags = 0,
+  };
+  RSQueryTerm *term = NewQueryTerm(&tok, q->tokenId++);
+
+  if (q->sctx->spec->partitionSpan > 0) {
+    IndexIterator *pit = Redis_OpenPartitionedTermIterator(
+        q->sctx, term, &q->sctx->spec->docs, q->opts->fieldmask & opts->fieldMask, q->conc, 1);
+    if (!pit) {
+      Term_Free(term);
+      return;
+    }
+    (*its)[(*itsSz)++] = pit;
+    if (*itsSz == *itsCap) {
+      *itsCap *= 2;
+      *its = realloc(*its, *itsCap * sizeof(**its));
+    }
+    return;
+  }
+
+  IndexReader *ir = Redis_OpenReader(q->sctx, term, &q->sctx->spec->docs, 0,
+                                     q->opts->fieldmask & opts->fieldMask, q->conc, 1);
+  if (ir && q->skipOffsets) {
+    IndexReader_SetSkipOffsetVectors(ir);
+  }
+  if (!ir) {
+    Term_Free(term);
+    return;
+  }
+
+  (*its)[(*itsSz)++] = NewReadIterator(ir);
+  if (*itsSz == *itsCap) {
+    *itsCap *= 2;
+    *its = realloc(*its, *itsCap * sizeof(**its));
+  }
+}
+
 static IndexIterator *iterateExpandedTerms(QueryEvalCtx *q, Trie *terms, const char *str,
                                            size_t len, int maxDist, int prefixMode,
                                            QueryNodeOptions *opts) {
+  size_t itsSz = 0, itsCap = 8;
+  IndexIterator **its;
+
+  // an upper limit on the number of expansions is enforced to avoid stuff like "*"
+  size_t maxExpansions = q->sctx->spec->maxPrefixExpansions;
+  int cacheable = maxDist == 0 && prefixMode;
+
+  if (cacheable) {
+    PrefixCacheEntry *e = PrefixCache_Get(q->sctx->spec, str, len);
+    // A truncated entry only satisfies limits it can fill
+    if (e && !(e->truncated && (maxExpansions == (size_t)-1 || maxExpansions > e->nterms))) {
+      size_t n = e->nterms;
+      if (maxExpansions != (size_t)-1 && n > maxExpansions) {
+        n = maxExpansions;
+      }
+      its = calloc(itsCap, sizeof(*its));
+      for (size_t i = 0; i < n; i++) {
+        addExpandedTerm(q, e->terms[i], e->lens[i], opts, &its, &itsSz, &itsCap);
+      }
+      goto done;
+    }
+  }
+
+  // Expensive fuzzy walks fan out across the root's subtrees; a NULL return
+  // means the walk was not worth parallelizing and the serial path runs
+  if (maxDist >= 2 && RSGlobalConfig.concurrentMode) {
+    size_t nexp = 0;
+    TrieExpansion *exps =
+        Trie_ExpandParallel(terms, str, len, maxDist, prefixMode, maxExpansions, &nexp);
+    if (exps) {
+      its = calloc(itsCap, sizeof(*its));
+      for (size_t i = 0; i < nexp; i++) {
+        if (q->sctx && q->sctx->redisCtx) {
+          RedisModule_Log(q->sctx->redisCtx, "debug", "Found fuzzy expansion: %s %f", exps[i].str,
+                          exps[i].score);
+        }
+        addExpandedTerm(q, exps[i].str, exps[i].len, opts, &its, &itsSz, &itsCap);
+        free(exps[i].str);
+      }
+      free(exps);
+      goto done;
+    }
+  }
+
   TrieIterator *it = Trie_Iterate(terms, str, len, maxDist, prefixMode);
   if (!it) return NULL;
 
-  size_t itsSz = 0, itsCap = 8;
-  IndexIterator **its = calloc(itsCap, sizeof(*its));
+  its = calloc(itsCap, sizeof(*its));
 
   rune *rstr = NULL;
   t_len slen = 0;
   float score = 0;
   int dist = 0;
 
-  // an upper limit on the number of expansions is enforced to avoid stuff like "*"
-  size_t maxExpansions = q->sctx->spec->maxPrefixExpansions;
+  char **collected = NULL;
+  uint32_t *collectedLens = NULL;
+  size_t ncollected = 0, collectedCap = 0;
+
   while (TrieIterator_Next(it, &rstr, &slen, NULL, &score, &dist) &&
          (itsSz < maxExpansions || maxExpansions == -1)) {
 
@@ -349,23 +605,31 @@ static IndexIterator *iterateExpandedTerms(QueryEvalCtx *q, Trie *terms, const c
       RedisModule_Log(q->sctx->redisCtx, "debug", "Found fuzzy expansion: %s %f", tok.str, score);
     }
 
-    RSQueryTerm *term = NewQueryTerm(&tok, q->tokenId++);
+    addExpandedTerm(q, tok.str, tok.len, opts, &its, &itsSz, &itsCap);
 
-    // Open an index reader
-    IndexReader *ir = Redis_OpenReader(q->sctx, term, &q->sctx->spec->docs, 0,
-                                       q->opts->fieldmask & opts->fieldMask, q->conc, 1);
-
-    free(tok.str);
-    if (!ir) {
-      Term_Free(term);
-      continue;
+    if (cacheable && ncollected <= PREFIX_CACHE_MAX_TERMS) {
+      if (ncollected == collectedCap) {
+        collectedCap = collectedCap ? collectedCap * 2 : 8;
+        collected = rm_realloc(collected, collectedCap * sizeof(*collected));
+        collectedLens = rm_realloc(collectedLens, collectedCap * sizeof(*collectedLens));
+      }
+      collected[ncollected] = tok.str;  // ownership moves to the collection
+      collectedLens[ncollected++] = tok.len;
+    } else {
+      free(tok.str);
     }
+  }
 
-    // Add the reader to the iterator array
-    its[itsSz++] = NewReadIterator(ir);
-    if (itsSz == itsCap) {
-      itsCap *= 2;
-      its = realloc(its, itsCap * sizeof(*its));
+  if (collected) {
+    if (ncollected <= PREFIX_CACHE_MAX_TERMS) {
+      PrefixCache_Put(q->sctx->spec, str, len, collected, collectedLens, ncollected,
+                      itsSz >= maxExpansions && maxExpansions != (size_t)-1);
+    } else {
+      for (size_t i = 0; i < ncollected; i++) {
+        free(collected[i]);
+      }
+      rm_free(collected);
+      rm_free(collectedLens);
     }
   }
 
@@ -373,6 +637,7 @@ static IndexIterator *iterateExpandedTerms(QueryEvalCtx *q, Trie *terms, const c
   free(it->ctx);
   TrieIterator_Free(it);
   // printf("Expanded %d terms!\n", itsSz);
+done:
   if (itsSz == 0) {
     free(its);
     return NULL;
@@ -411,6 +676,9 @@ static void rangeIterCb(const rune *r, size_t n, void *p) {
   RSQueryTerm *term = NewQueryTerm(&tok, ctx->q->tokenId++);
   IndexReader *ir = Redis_OpenReader(q->sctx, term, &q->sctx->spec->docs, 0,
                                      q->opts->fieldmask & ctx->opts->fieldMask, q->conc, 1);
+  if (ir && q->skipOffsets) {
+    IndexReader_SetSkipOffsetVectors(ir);
+  }
   free(tok.str);
   if (!ir) {
     Term_Free(term);
@@ -657,6 +925,65 @@ static IndexIterator *Query_EvalTagPrefixNode(QueryEvalCtx *q, TagIndex *idx, Qu
   return NewUnionIterator(its, itsSz, q->docTable, 1, weight);
 }
 
+/* Evaluate a lexicographic range over a tag field's value dictionary. The TrieMap iterates in
+ * trie order, not lexicographic order, so we scan the dictionary and filter against the bounds
+ * (both inclusive, NULL meaning open-ended), capped like prefix expansion */
+static IndexIterator *Query_EvalTagLexRangeNode(QueryEvalCtx *q, TagIndex *idx, QueryNode *qn,
+                                                IndexIteratorArray *iterout, double weight) {
+  if (!idx || !idx->values) {
+    return NULL;
+  }
+  const char *begin = qn->lxrng.begin, *end = qn->lxrng.end;
+  size_t nbegin = begin ? strlen(begin) : 0, nend = end ? strlen(end) : 0;
+
+  TrieMapIterator *it = TrieMap_Iterate(idx->values, "", 0);
+  if (!it) {
+    return NULL;
+  }
+
+  size_t itsSz = 0, itsCap = 8;
+  IndexIterator **its = calloc(itsCap, sizeof(*its));
+  size_t maxExpansions = q->sctx->spec->maxPrefixExpansions;
+
+  char *s;
+  tm_len_t sl;
+  void *ptr;
+  while (TrieMapIterator_Next(it, &s, &sl, &ptr) &&
+         (itsSz < maxExpansions || maxExpansions == -1)) {
+    if (begin) {
+      int c = memcmp(s, begin, MIN(sl, nbegin));
+      if (c < 0 || (c == 0 && sl < nbegin)) {
+        continue;
+      }
+    }
+    if (end) {
+      int c = memcmp(s, end, MIN(sl, nend));
+      if (c > 0 || (c == 0 && sl > nend)) {
+        continue;
+      }
+    }
+    IndexIterator *ret = TagIndex_OpenReader(idx, q->sctx->spec, s, sl, weight);
+    if (!ret) {
+      continue;
+    }
+    its[itsSz++] = ret;
+    if (itsSz == itsCap) {
+      itsCap *= 2;
+      its = realloc(its, itsCap * sizeof(*its));
+    }
+  }
+  TrieMapIterator_Free(it);
+
+  if (itsSz == 0) {
+    free(its);
+    return NULL;
+  }
+  for (size_t ii = 0; ii < itsSz; ++ii) {
+    *array_ensure_tail(iterout, IndexIterator *) = its[ii];
+  }
+  return NewUnionIterator(its, itsSz, q->docTable, 1, weight);
+}
+
 static IndexIterator *query_EvalSingleTagNode(QueryEvalCtx *q, TagIndex *idx, QueryNode *n,
                                               IndexIteratorArray *iterout, double weight) {
   IndexIterator *ret = NULL;
@@ -668,6 +995,9 @@ static IndexIterator *query_EvalSingleTagNode(QueryEvalCtx *q, TagIndex *idx, Qu
     case QN_PREFX:
       return Query_EvalTagPrefixNode(q, idx, n, iterout, weight);
 
+    case QN_LEXRANGE:
+      return Query_EvalTagLexRangeNode(q, idx, n, iterout, weight);
+
     case QN_PHRASE: {
       char *terms[n->pn.numChildren];
       for (int i = 0; i < n->pn.numChildren; i++) {
@@ -750,7 +1080,7 @@ static IndexIterator *Query_EvalTagNode(QueryEvalCtx *q, QueryNode *qn) {
   return ret;
 }
 
-IndexIterator *Query_EvalNode(QueryEvalCtx *q, QueryNode *n) {
+static IndexIterator *Query_EvalNodeDispatch(QueryEvalCtx *q, QueryNode *n) {
   switch (n->type) {
     case QN_TOKEN:
       return Query_EvalTokenNode(q, n);
@@ -785,14 +1115,181 @@ IndexIterator *Query_EvalNode(QueryEvalCtx *q, QueryNode *n) {
   return NULL;
 }
 
+IndexIterator *Query_EvalNode(QueryEvalCtx *q, QueryNode *n) {
+  if (q->prof) {
+    QueryProfile_EnterNode(q->prof, n);
+    IndexIterator *it = Query_EvalNodeDispatch(q, n);
+    return QueryProfile_WrapIterator(q->prof, it);
+  }
+  return Query_EvalNodeDispatch(q, n);
+}
+
 QueryNode *Query_Parse(QueryParseCtx *);
 
+/******************************************************************************
+ * Parsed-query plan cache.
+ *
+ * Dashboards tend to issue the same handful of query templates over and over;
+ * re-running the Lemon parser for each is pure overhead. We keep a small LRU
+ * cache from (spec uniqueId, language, raw query) to the parsed AST, and hand
+ * out deep clones on a hit - copy-on-evaluate, since evaluation and expansion
+ * mutate the tree. Every string a node references (tokens, tag field names,
+ * lex ranges, filter properties) is deep-copied, so clones never point into
+ * another request's query buffer.
+ ******************************************************************************/
+
+static char *cloneToken(const char *s, size_t n) {
+  if (!s) {
+    return NULL;
+  }
+  char *ret = malloc(n + 1);
+  memcpy(ret, s, n);
+  ret[n] = '\0';
+  return ret;
+}
+
+static QueryNode *QueryNode_Clone(const QueryNode *n) {
+  if (!n) {
+    return NULL;
+  }
+  QueryNode *ret = astAlloc(sizeof(*ret));
+  *ret = *n;
+  if (queryASTArena_tls) {
+    ret->opts.flags |= QueryNode_InArena;
+  } else {
+    ret->opts.flags &= ~QueryNode_InArena;
+  }
+
+  switch (n->type) {
+    case QN_TOKEN:
+      ret->tn.str = cloneToken(n->tn.str, n->tn.len);
+      break;
+    case QN_PREFX:
+      ret->pfx.str = cloneToken(n->pfx.str, n->pfx.len);
+      break;
+    case QN_FUZZY:
+      ret->fz.tok.str = cloneToken(n->fz.tok.str, n->fz.tok.len);
+      break;
+    case QN_PHRASE:
+      ret->pn.children = astAlloc(n->pn.numChildren * sizeof(*ret->pn.children));
+      ret->pn.capChildren = n->pn.numChildren;
+      for (int i = 0; i < n->pn.numChildren; i++) {
+        ret->pn.children[i] = QueryNode_Clone(n->pn.children[i]);
+      }
+      break;
+    case QN_UNION:
+      ret->un.children = astAlloc(n->un.numChildren * sizeof(*ret->un.children));
+      ret->un.capChildren = n->un.numChildren;
+      for (int i = 0; i < n->un.numChildren; i++) {
+        ret->un.children[i] = QueryNode_Clone(n->un.children[i]);
+      }
+      break;
+    case QN_TAG:
+      // The node owns its field name (QueryTagNode_Free releases it)
+      ret->tag.fieldName = cloneToken(n->tag.fieldName, n->tag.len);
+      ret->tag.children = astAlloc(n->tag.numChildren * sizeof(*ret->tag.children));
+      ret->tag.capChildren = n->tag.numChildren;
+      for (int i = 0; i < n->tag.numChildren; i++) {
+        ret->tag.children[i] = QueryNode_Clone(n->tag.children[i]);
+      }
+      break;
+    case QN_NOT:
+      ret->inverted.child = QueryNode_Clone(n->inverted.child);
+      break;
+    case QN_OPTIONAL:
+      ret->opt.child = QueryNode_Clone(n->opt.child);
+      break;
+    case QN_NUMERIC: {
+      NumericFilter *nf = malloc(sizeof(*nf));
+      *nf = *n->nn.nf;
+      nf->fieldName = strdup(n->nn.nf->fieldName);
+      ret->nn.nf = nf;
+      break;
+    }
+    case QN_GEO: {
+      GeoFilter *gf = malloc(sizeof(*gf));
+      *gf = *n->gn.gf;
+      gf->property = strdup(n->gn.gf->property);
+      gf->unit = n->gn.gf->unit ? strdup(n->gn.gf->unit) : NULL;
+      ret->gn.gf = gf;
+      break;
+    }
+    case QN_LEXRANGE:
+      ret->lxrng.begin = n->lxrng.begin ? strdup(n->lxrng.begin) : NULL;
+      ret->lxrng.end = n->lxrng.end ? strdup(n->lxrng.end) : NULL;
+      ret->opts.flags |= QueryNode_OwnsStrings;
+      break;
+    case QN_IDS:
+    case QN_WILDCARD:
+    case QN_NULL:
+      break;
+  }
+  return ret;
+}
+
+#include "util/dict.h"
+#include "util/dllist.h"
+
+#define QUERY_CACHE_MAX_ENTRIES 128
+
+typedef struct {
+  DLLIST_node lru;
+  char *key;
+  QueryNode *root;  // deep copy, owned by the entry
+  size_t numTokens;
+} QueryCacheEntry;
+
+static dict *queryCache = NULL;
+static DLLIST queryCacheLRU;
+
+static char *queryCacheKey(const RedisSearchCtx *sctx, const RSSearchOptions *opts, const char *q,
+                           size_t n) {
+  if (!sctx || !sctx->spec) {
+    // spec-less parse (extensions, library users): nothing stable to key on,
+    // bypass the cache
+    return NULL;
+  }
+  // the schema epoch keys out plans whose field bits a schema change stale'd
+  const char *lang = opts && opts->language ? opts->language : "";
+  char *ret = malloc(n + strlen(lang) + 64);
+  size_t off = sprintf(ret, "%llu.%llu/%s/", (unsigned long long)sctx->spec->uniqueId,
+                       (unsigned long long)sctx->spec->schemaEpoch, lang);
+  memcpy(ret + off, q, n);
+  ret[off + n] = '\0';
+  return ret;
+}
+
+static void queryCacheEvict(QueryCacheEntry *e) {
+  dllist_delete(&e->lru);
+  dictDelete(queryCache, e->key);
+  QueryNode_Free(e->root);
+  free(e->key);
+  free(e);
+}
+
 int QAST_Parse(QueryAST *dst, const RedisSearchCtx *sctx, const RSSearchOptions *opts,
                const char *q, size_t n, QueryError *status) {
   if (!dst->query) {
     dst->query = strndup(q, n);
     dst->nquery = n;
   }
+  BlkAlloc_Init(&dst->arena);
+  queryASTArena_tls = &dst->arena;
+
+  char *ckey = queryCacheKey(sctx, opts, q, n);
+  if (queryCache && ckey) {
+    QueryCacheEntry *e = dictFetchValue(queryCache, ckey);
+    if (e) {
+      free(ckey);
+      dllist_delete(&e->lru);
+      dllist_prepend(&queryCacheLRU, &e->lru);
+      dst->root = QueryNode_Clone(e->root);
+      dst->numTokens = e->numTokens;
+      queryASTArena_tls = NULL;
+      return REDISMODULE_OK;
+    }
+  }
+
   QueryParseCtx qpCtx = {// force multiline
                          .raw = dst->query,
                          .len = dst->nquery,
@@ -804,6 +1301,8 @@ int QAST_Parse(QueryAST *dst, const RedisSearchCtx *sctx, const RSSearchOptions
   //  dst->root);
   if (!dst->root) {
     if (QueryError_HasError(status)) {
+      free(ckey);
+      queryASTArena_tls = NULL;
       return REDISMODULE_ERR;
     } else {
       dst->root = NewQueryNode(QN_NULL);
@@ -814,9 +1313,33 @@ int QAST_Parse(QueryAST *dst, const RedisSearchCtx *sctx, const RSSearchOptions
       QueryNode_Free(dst->root);
       dst->root = NULL;
     }
+    free(ckey);
+    queryASTArena_tls = NULL;
     return REDISMODULE_ERR;
   }
   dst->numTokens = qpCtx.numTokens;
+
+  // Successful parse - remember a private copy of the tree for the next
+  // identical query. Spec-less parses have no key and stay uncached
+  if (ckey) {
+    if (!queryCache) {
+      queryCache = dictCreate(&dictTypeHeapStrings, NULL);
+      dllist_init(&queryCacheLRU);
+    }
+    if (dictSize(queryCache) >= QUERY_CACHE_MAX_ENTRIES) {
+      queryCacheEvict(DLLIST_ITEM(queryCacheLRU.prev, QueryCacheEntry, lru));
+    }
+    QueryCacheEntry *e = calloc(1, sizeof(*e));
+    e->key = ckey;
+    // The cache's private copy outlives this query: clone it off-arena
+    queryASTArena_tls = NULL;
+    e->root = QueryNode_Clone(dst->root);
+    e->numTokens = dst->numTokens;
+    dictAdd(queryCache, e->key, e);
+    dllist_prepend(&queryCacheLRU, &e->lru);
+    ckey = NULL;
+  }
+  queryASTArena_tls = NULL;
   return REDISMODULE_OK;
 }
 
@@ -833,14 +1356,70 @@ static IndexIterator *getEOFIterator(void) {
   return &eofIterator;
 }
 
+/* Does any node of the tree require term offsets (exact phrase, slop or in-order matching)? */
+static int QueryNode_NeedsOffsets(const QueryNode *n) {
+  if (!n) {
+    return 0;
+  }
+  if (n->opts.maxSlop >= 0 || n->opts.inOrder) {
+    return 1;
+  }
+  switch (n->type) {
+    case QN_PHRASE:
+      if (n->pn.exact) {
+        return 1;
+      }
+      for (int i = 0; i < n->pn.numChildren; i++) {
+        if (QueryNode_NeedsOffsets(n->pn.children[i])) {
+          return 1;
+        }
+      }
+      break;
+    case QN_UNION:
+      for (int i = 0; i < n->un.numChildren; i++) {
+        if (QueryNode_NeedsOffsets(n->un.children[i])) {
+          return 1;
+        }
+      }
+      break;
+    case QN_TAG:
+      for (int i = 0; i < n->tag.numChildren; i++) {
+        if (QueryNode_NeedsOffsets(n->tag.children[i])) {
+          return 1;
+        }
+      }
+      break;
+    case QN_NOT:
+      return QueryNode_NeedsOffsets(n->inverted.child);
+    case QN_OPTIONAL:
+      return QueryNode_NeedsOffsets(n->opt.child);
+    default:
+      break;
+  }
+  return 0;
+}
+
 IndexIterator *QAST_Iterate(const QueryAST *qast, const RSSearchOptions *opts, RedisSearchCtx *sctx,
-                            ConcurrentSearchCtx *conc, QueryError *status) {
+                            ConcurrentSearchCtx *conc, struct QueryProfile *prof,
+                            QueryError *status) {
+  // A scorer may read res->term.offsets (part of the scoring API). Built-ins
+  // declare they don't; an extension scorer without that declaration - or an
+  // unknown name, resolved to an error later - keeps real offset decoding
+  int scorerNeedsOffsets = 0;
+  if (opts->scorerName && *opts->scorerName) {
+    ExtScoringFunctionCtx *fx = Extensions_GetScoringFunction(NULL, opts->scorerName);
+    scorerNeedsOffsets = !fx || fx->needsOffsets;
+  }
   QueryEvalCtx qectx = {
       .conc = conc,
       .opts = opts,
       .numTokens = qast->numTokens,
       .docTable = &sctx->spec->docs,
       .sctx = sctx,
+      .prof = prof,
+      // Offset vectors are dead weight when nothing downstream reads them
+      .skipOffsets = !(opts->flags & (Search_InOrder | Search_HasSlop | Search_WithOffsets)) &&
+                     !scorerNeedsOffsets && !QueryNode_NeedsOffsets(qast->root),
   };
   IndexIterator *root = Query_EvalNode(&qectx, qast->root);
   if (!root) {
@@ -853,8 +1432,14 @@ IndexIterator *QAST_Iterate(const QueryAST *qast, const RSSearchOptions *opts, R
 }
 
 void QAST_Destroy(QueryAST *q) {
+  // Releases externally owned resources (strings, filters); the node and
+  // child-array storage falls with the arena below
   QueryNode_Free(q->root);
   q->root = NULL;
+  BlkAlloc_FreeAll(&q->arena, NULL, NULL, 0);
+  // FreeAll leaves the block pointers behind; re-init so destroy is
+  // idempotent (the cpptests wrapper destroys before every re-parse)
+  BlkAlloc_Init(&q->arena);
   q->numTokens = 0;
   free(q->query);
   q->nquery = 0;
@@ -875,7 +1460,10 @@ int QAST_Expand(QueryAST *q, const char *expander, RSSearchOptions *opts, RedisS
   ExtQueryExpanderCtx *xpc =
       Extensions_GetQueryExpander(&expCtx, expander ? expander : DEFAULT_EXPANDER_NAME);
   if (xpc && xpc->exp) {
+    // Expansion adds nodes to the AST - they belong in its arena
+    queryASTArena_tls = &q->arena;
     QueryNode_Expand(xpc->exp, &expCtx, &q->root);
+    queryASTArena_tls = NULL;
     if (xpc->ff) {
       xpc->ff(expCtx.privdata);
     }
@@ -921,7 +1509,7 @@ void QueryPhraseNode_AddChild(QueryNode *parent, QueryNode *child) {
   if (!child) return;
   QueryPhraseNode *pn = &parent->pn;
 
-  pn->children = realloc(pn->children, sizeof(QueryNode *) * (pn->numChildren + 1));
+  pn->children = astGrowChildren(parent, pn->children, pn->numChildren, &pn->capChildren, 1);
   pn->children[pn->numChildren++] = child;
 }
 
@@ -929,7 +1517,7 @@ void QueryUnionNode_AddChild(QueryNode *parent, QueryNode *child) {
   if (!child) return;
   QueryUnionNode *un = &parent->un;
 
-  un->children = realloc(un->children, sizeof(QueryNode *) * (un->numChildren + 1));
+  un->children = astGrowChildren(parent, un->children, un->numChildren, &un->capChildren, 1);
   un->children[un->numChildren++] = child;
 }
 
@@ -937,10 +1525,10 @@ void QueryTagNode_AddChildren(QueryNode *parent, QueryNode **children, size_t nu
   if (!children) return;
   QueryTagNode *tn = &parent->tag;
 
-  tn->children = realloc(tn->children, sizeof(QueryNode *) * (tn->numChildren + num));
+  tn->children = astGrowChildren(parent, tn->children, tn->numChildren, &tn->capChildren, num);
   for (size_t i = 0; i < num; i++) {
     if (children[i] && (children[i]->type == QN_TOKEN || children[i]->type == QN_PHRASE ||
-                        children[i]->type == QN_PREFX)) {
+                        children[i]->type == QN_PREFX || children[i]->type == QN_LEXRANGE)) {
       tn->children[tn->numChildren++] = children[i];
     }
   }
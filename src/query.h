@@ -5,6 +5,7 @@
 
 #include "index.h"
 #include "query_node.h"
+#include "util/block_alloc.h"
 #include "query_parser/tokenizer.h"
 #include "redis_index.h"
 #include "redismodule.h"
@@ -30,6 +31,10 @@ extern "C" {
 typedef struct QueryAST {
   size_t numTokens;
   QueryNode *root;
+
+  /* Bump arena backing the tree's node and child-array storage; reset
+   * wholesale by QAST_Destroy */
+  BlkAlloc arena;
   // User data and length, for use by scorers
   const void *udata;
   size_t udatalen;
@@ -83,8 +88,10 @@ void QAST_SetGlobalFilters(QueryAST *ast, const QAST_GlobalFilterOptions *option
  * @param conc Used to save state on the query
  * @return an iterator.
  */
+struct QueryProfile;
 IndexIterator *QAST_Iterate(const QueryAST *ast, const RSSearchOptions *options,
-                            RedisSearchCtx *sctx, ConcurrentSearchCtx *conc, QueryError *status);
+                            RedisSearchCtx *sctx, ConcurrentSearchCtx *conc,
+                            struct QueryProfile *prof, QueryError *status);
 
 /**
  * Expand the query using a pre-registered expander. Query expansion possibly
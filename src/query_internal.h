@@ -37,6 +37,11 @@ typedef struct {
   size_t numTokens;
   uint32_t tokenId;
   DocTable *docTable;
+  // Offsets are not consumed by this query - readers may use skip-offset decoders
+  int skipOffsets;
+  // Non-NULL when FT.PROFILE instruments this query: every evaluated node's
+  // iterator gets a counting wrapper
+  struct QueryProfile *prof;
 } QueryEvalCtx;
 
 struct QueryAST;
@@ -57,6 +57,7 @@ typedef enum {
 typedef struct {
   struct RSQueryNode **children;
   int numChildren;
+  int capChildren;
   int exact;
 
 } QueryPhraseNode;
@@ -73,6 +74,7 @@ typedef struct {
 typedef struct {
   struct RSQueryNode **children;
   int numChildren;
+  int capChildren;
 } QueryUnionNode;
 
 typedef struct {
@@ -81,6 +83,7 @@ typedef struct {
 
   struct RSQueryNode **children;
   int numChildren;
+  int capChildren;
 } QueryTagNode;
 
 typedef struct {
@@ -127,6 +130,13 @@ typedef struct {
 
 typedef enum {
   QueryNode_Verbatim = 0x01,
+  /* Set on cloned nodes whose borrowed strings (tag field name, lex range bounds) were
+   * deep-copied and are owned by the node itself */
+  QueryNode_OwnsStrings = 0x02,
+  /* The node struct (and its child arrays) live in the query AST's bump
+   * arena: QueryNode_Free releases only externally owned resources, the
+   * storage goes away with the arena in one reset */
+  QueryNode_InArena = 0x04,
 } QueryNodeFlags;
 
 /* Query attribute is a dynamic attribute that can be applied to any query node.
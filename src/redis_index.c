@@ -1,4 +1,5 @@
 #include "redis_index.h"
+#include "index_snapshot.h"
 #include "doc_table.h"
 #include "redismodule.h"
 #include "inverted_index.h"
@@ -51,6 +52,29 @@ void *InvertedIndex_RdbLoad(RedisModuleIO *rdb, int encver) {
     InvertedIndex_AddBlock(idx, 0);
   } else {
     idx->blocks = rm_realloc(idx->blocks, idx->size * sizeof(IndexBlock));
+
+    // Consolidate the completed blocks' buffers into one contiguous arena: one heap object per
+    // index instead of one per block, and sequential scans walk adjacent memory. The last block
+    // keeps its own allocation since the writer may still append (and realloc) it
+    size_t arenaLen = 0;
+    for (uint32_t i = 0; i + 1 < idx->size; i++) {
+      arenaLen += idx->blocks[i].buf.offset;
+    }
+    if (arenaLen) {
+      idx->loadArena = rm_malloc(arenaLen);
+      size_t off = 0;
+      for (uint32_t i = 0; i + 1 < idx->size; i++) {
+        IndexBlock *blk = &idx->blocks[i];
+        if (!blk->buf.offset) {
+          continue;
+        }
+        memcpy(idx->loadArena + off, blk->buf.data, blk->buf.offset);
+        RedisModule_Free(blk->buf.data);
+        blk->buf.data = idx->loadArena + off;
+        blk->bufBorrowed = 1;
+        off += blk->buf.offset;
+      }
+    }
   }
   return idx;
 }
@@ -94,6 +118,7 @@ unsigned long InvertedIndex_MemUsage(const void *value) {
   for (size_t i = 0; i < idx->size; i++) {
     ret += sizeof(IndexBlock);
     ret += IndexBlock_DataLen(&idx->blocks[i]);
+    ret += idx->blocks[i].numSkips * sizeof(IndexBlockSkipEntry);
   }
   return ret;
 }
@@ -283,10 +308,120 @@ const char *Redis_SelectRandomTerm(RedisSearchCtx *ctx, size_t *tlen) {
   return NULL;
 }
 
+/******************************************************************************
+ * Term open cache.
+ *
+ * Opening a term for reading costs a key-name format plus a keyspace lookup,
+ * per term, per query. Since an InvertedIndex pointer stays stable for as
+ * long as its key exists (writers and GC mutate it in place), we keep a
+ * small LRU cache from "<spec uniqueId>/<term>" to the index pointer and
+ * skip the keyspace entirely on a hit. The cache is only used on the read
+ * path, is dropped wholesale for a spec when its index is dropped or freed,
+ * and assumes - like the rest of the module - that nothing else deletes
+ * ft:* keys out from under us.
+ ******************************************************************************/
+
+#include "util/dllist.h"
+
+#define TERM_CACHE_MAX_ENTRIES 4096
+
+typedef struct {
+  DLLIST_node lru;
+  char *key;
+  InvertedIndex *idx;
+} TermCacheEntry;
+
+static dict *termCache = NULL;
+static DLLIST termCacheLRU;
+
+static char *termCacheKey(const IndexSpec *sp, const char *term, size_t len) {
+  char *ret = rm_malloc(len + 24);
+  size_t n = snprintf(ret, len + 24, "%llu/", (unsigned long long)sp->uniqueId);
+  memcpy(ret + n, term, len);
+  ret[n + len] = '\0';
+  return ret;
+}
+
+static void termCacheEvict(TermCacheEntry *e) {
+  dllist_delete(&e->lru);
+  dictDelete(termCache, e->key);
+  rm_free(e->key);
+  rm_free(e);
+}
+
+static InvertedIndex *TermCache_Get(const IndexSpec *sp, const char *term, size_t len) {
+  if (!termCache) {
+    return NULL;
+  }
+  char *key = termCacheKey(sp, term, len);
+  TermCacheEntry *e = dictFetchValue(termCache, key);
+  rm_free(key);
+  if (!e) {
+    return NULL;
+  }
+  // Move to the head of the LRU list
+  dllist_delete(&e->lru);
+  dllist_prepend(&termCacheLRU, &e->lru);
+  return e->idx;
+}
+
+static void TermCache_Put(const IndexSpec *sp, const char *term, size_t len, InvertedIndex *idx) {
+  if (!termCache) {
+    termCache = dictCreate(&dictTypeHeapStrings, NULL);
+    dllist_init(&termCacheLRU);
+  }
+  char *key = termCacheKey(sp, term, len);
+  if (dictFetchValue(termCache, key)) {
+    rm_free(key);
+    return;
+  }
+  if (dictSize(termCache) >= TERM_CACHE_MAX_ENTRIES) {
+    termCacheEvict(DLLIST_ITEM(termCacheLRU.prev, TermCacheEntry, lru));
+  }
+  TermCacheEntry *e = rm_malloc(sizeof(*e));
+  e->key = key;
+  e->idx = idx;
+  dictAdd(termCache, key, e);
+  dllist_prepend(&termCacheLRU, &e->lru);
+}
+
+/* Drop every cached term of the given spec. Called when the index is dropped or freed */
+void TermCache_OnSpecInvalidated(const IndexSpec *sp) {
+  if (!termCache) {
+    return;
+  }
+  char prefix[32];
+  size_t pflen = snprintf(prefix, sizeof(prefix), "%llu/", (unsigned long long)sp->uniqueId);
+  DLLIST_node *it = termCacheLRU.next;
+  while (it != &termCacheLRU) {
+    TermCacheEntry *e = DLLIST_ITEM(it, TermCacheEntry, lru);
+    it = it->next;
+    if (!strncmp(e->key, prefix, pflen)) {
+      termCacheEvict(e);
+    }
+  }
+}
+
+/* The dictionary holding term indexes for this spec, if any: either the
+ * spec-resident term dictionary (Index_TermsInSpec) or the API-mode keysDict */
+static dict *specTermsDict(const IndexSpec *sp) {
+  return sp->termsDict ? sp->termsDict : sp->keysDict;
+}
+
 static InvertedIndex *openIndexKeysDict(RedisSearchCtx *ctx, RedisModuleString *termKey,
                                         int write) {
-  KeysDictValue *kdv = dictFetchValue(ctx->spec->keysDict, termKey);
+  dict *d = specTermsDict(ctx->spec);
+  KeysDictValue *kdv = dictFetchValue(d, termKey);
   if (kdv) {
+    if (!write && d == ctx->spec->termsDict) {
+      size_t klen;
+      const char *kstr = RedisModule_StringPtrLen(termKey, &klen);
+      HotTerms_Hit(ctx->spec, kstr, klen);
+    }
+    if (kdv->cold) {
+      // snapshot-lazy entry: build the index from its record on first open
+      return IndexSnapshot_HydrateTerm(ctx->spec, kdv);
+    }
     return kdv->p;
   }
   if (!write) {
@@ -296,16 +431,70 @@ static InvertedIndex *openIndexKeysDict(RedisSearchCtx *ctx, RedisModuleString *
   kdv = calloc(1, sizeof(*kdv));
   kdv->dtor = InvertedIndex_Free;
   kdv->p = NewInvertedIndex(ctx->spec->flags, 1);
-  dictAdd(ctx->spec->keysDict, termKey, kdv);
+  dictAdd(d, termKey, kdv);
   return kdv->p;
 }
 
+RedisModuleString *fmtRedisTermKeyPart(RedisSearchCtx *ctx, const char *term, size_t len,
+                                       uint32_t part) {
+  return RedisModule_CreateStringPrintf(ctx->redisCtx, TERM_KEY_FORMAT "#p%u", ctx->spec->name,
+                                        (int)len, term, part);
+}
+
+InvertedIndex *Redis_OpenInvertedIndexPart(RedisSearchCtx *ctx, const char *term, size_t len,
+                                           int write, uint32_t part) {
+  RedisModuleString *termKey = fmtRedisTermKeyPart(ctx, term, len, part);
+  InvertedIndex *idx = openIndexKeysDict(ctx, termKey, write);
+  RedisModule_FreeString(ctx->redisCtx, termKey);
+  return idx;
+}
+
+IndexIterator *Redis_OpenPartitionedTermIterator(RedisSearchCtx *ctx, RSQueryTerm *term,
+                                                 DocTable *dt, t_fieldMask fieldMask,
+                                                 ConcurrentSearchCtx *csx, double weight) {
+  uint32_t maxPart = (uint32_t)(ctx->spec->docs.maxDocId / ctx->spec->partitionSpan);
+  IndexIterator **its = calloc(maxPart + 1, sizeof(*its));
+  int n = 0;
+  for (uint32_t p = 0; p <= maxPart; p++) {
+    InvertedIndex *idx = Redis_OpenInvertedIndexPart(ctx, term->str, term->len, 0, p);
+    if (!idx) {
+      continue;
+    }
+    // every reader's record owns (and frees) its term: partitions after the
+    // first take a clone, the first consumes the caller's term
+    RSQueryTerm *rterm = term;
+    if (n > 0) {
+      RSToken tok = {.str = term->str, .len = term->len, .expanded = 0, .flags = term->flags};
+      rterm = NewQueryTerm(&tok, term->id);
+    }
+    IndexReader *ir = NewTermIndexReader(idx, ctx->spec, fieldMask, rterm, weight);
+    if (csx) {
+      // spec-resident: nothing to reopen but GC rewrites still force a re-seek
+      RedisModuleString *termKey = fmtRedisTermKeyPart(ctx, rterm->str, rterm->len, p);
+      ConcurrentSearch_AddKey(csx, NULL, REDISMODULE_READ, termKey, IndexReader_OnReopenSpec, ir,
+                              NULL);
+      RedisModule_FreeString(ctx->redisCtx, termKey);
+    }
+    its[n++] = NewReadIterator(ir);
+  }
+  if (n == 0) {
+    free(its);
+    return NULL;
+  }
+  if (n == 1) {
+    IndexIterator *one = its[0];
+    free(its);
+    return one;
+  }
+  return NewUnionIterator(its, n, dt, 0, weight);
+}
+
 InvertedIndex *Redis_OpenInvertedIndexEx(RedisSearchCtx *ctx, const char *term, size_t len,
                                          int write, RedisModuleKey **keyp) {
   RedisModuleString *termKey = fmtRedisTermKey(ctx, term, len);
   InvertedIndex *idx = NULL;
 
-  if (!ctx->spec->keysDict) {
+  if (!specTermsDict(ctx->spec)) {
     RedisModuleKey *k = RedisModule_OpenKey(ctx->redisCtx, termKey,
                                             REDISMODULE_READ | (write ? REDISMODULE_WRITE : 0));
 
@@ -344,32 +533,54 @@ IndexReader *Redis_OpenReader(RedisSearchCtx *ctx, RSQueryTerm *term, DocTable *
                               int singleWordMode, t_fieldMask fieldMask, ConcurrentSearchCtx *csx,
                               double weight) {
 
-  RedisModuleString *termKey = fmtRedisTermKey(ctx, term->str, term->len);
   InvertedIndex *idx = NULL;
   RedisModuleKey *k = NULL;
-  if (!ctx->spec->keysDict) {
-    k = RedisModule_OpenKey(ctx->redisCtx, termKey, REDISMODULE_READ);
+  RedisModuleString *termKey = NULL;
+  int inDict = specTermsDict(ctx->spec) != NULL;
 
-    // we do not allow empty indexes when loading an existing index
-    if (k == NULL || RedisModule_KeyType(k) == REDISMODULE_KEYTYPE_EMPTY ||
-        RedisModule_ModuleTypeGetType(k) != InvertedIndexType) {
-      RedisModule_FreeString(ctx->redisCtx, termKey);
-      return NULL;
-    }
+  if (!inDict) {
+    // A cache hit skips the key formatting and keyspace lookup entirely. The concurrent
+    // context still re-opens the key on every yield, revalidating the pointer
+    idx = TermCache_Get(ctx->spec, term->str, term->len);
+  }
 
-    idx = RedisModule_ModuleTypeGetValue(k);
-  } else {
-    idx = openIndexKeysDict(ctx, termKey, 0);
-    if (!idx) {
-      RedisModule_FreeString(ctx->redisCtx, termKey);
-      return NULL;
+  if (!idx) {
+    termKey = fmtRedisTermKey(ctx, term->str, term->len);
+    if (!inDict) {
+      k = RedisModule_OpenKey(ctx->redisCtx, termKey, REDISMODULE_READ);
+
+      // we do not allow empty indexes when loading an existing index
+      if (k == NULL || RedisModule_KeyType(k) == REDISMODULE_KEYTYPE_EMPTY ||
+          RedisModule_ModuleTypeGetType(k) != InvertedIndexType) {
+        RedisModule_FreeString(ctx->redisCtx, termKey);
+        return NULL;
+      }
+
+      idx = RedisModule_ModuleTypeGetValue(k);
+      TermCache_Put(ctx->spec, term->str, term->len, idx);
+    } else {
+      idx = openIndexKeysDict(ctx, termKey, 0);
+      if (!idx) {
+        RedisModule_FreeString(ctx->redisCtx, termKey);
+        return NULL;
+      }
     }
   }
+
   IndexReader *ret = NewTermIndexReader(idx, ctx->spec, fieldMask, term, weight);
   if (csx) {
-    ConcurrentSearch_AddKey(csx, k, REDISMODULE_READ, termKey, IndexReader_OnReopen, ret, NULL);
+    // The reopen callback needs the key name even when the open itself was skipped
+    if (!termKey) {
+      termKey = fmtRedisTermKey(ctx, term->str, term->len);
+    }
+    // Spec-resident indexes have no key to revalidate - they live as long as
+    // the spec - but GC block rewrites still need the re-seek treatment
+    ConcurrentSearch_AddKey(csx, k, REDISMODULE_READ, termKey,
+                            inDict ? IndexReader_OnReopenSpec : IndexReader_OnReopen, ret, NULL);
+  }
+  if (termKey) {
+    RedisModule_FreeString(ctx->redisCtx, termKey);
   }
-  RedisModule_FreeString(ctx->redisCtx, termKey);
   return ret;
 }
 
@@ -378,6 +589,7 @@ int Redis_LoadDocumentR(RedisSearchCtx *ctx, RedisModuleString *key, Document *d
   RedisModuleCallReply *rep = NULL;
   doc->numFields = 0;
   doc->fields = NULL;
+  doc->borrowedFields = 0;
 
   rep = RedisModule_Call(ctx->redisCtx, "HGETALL", "s", key);
   if (rep == NULL || RedisModule_CallReplyType(rep) != REDISMODULE_REPLY_ARRAY) {
@@ -535,6 +747,7 @@ static int Redis_DeleteKey(RedisModuleCtx *ctx, RedisModuleString *s) {
 }
 
 int Redis_DropIndex(RedisSearchCtx *ctx, int deleteDocuments, int deleteSpecKey) {
+  TermCache_OnSpecInvalidated(ctx->spec);
 
   if (deleteDocuments) {
 
@@ -542,23 +755,27 @@ int Redis_DropIndex(RedisSearchCtx *ctx, int deleteDocuments, int deleteSpecKey)
     DocTable_ForEach(dt, Redis_DeleteKey(ctx->redisCtx, DMD_CreateKeyString(dmd, ctx->redisCtx)));
   }
 
-  rune *rstr = NULL;
-  t_len slen = 0;
-  float score = 0;
-  int dist = 0;
-  size_t termLen;
-
-  TrieIterator *it = Trie_Iterate(ctx->spec->terms, "", 0, 0, 1);
-  while (TrieIterator_Next(it, &rstr, &slen, NULL, &score, &dist)) {
-    char *res = runesToStr(rstr, slen, &termLen);
-    RedisModuleString *keyName = fmtRedisTermKey(ctx, res, strlen(res));
-    Redis_DropScanHandler(ctx->redisCtx, keyName, ctx);
-    RedisModule_FreeString(ctx->redisCtx, keyName);
-    free(res);
+  // Spec-resident term indexes are freed with the spec's dictionary; only
+  // keyspace-resident terms need the delete scan
+  if (!ctx->spec->termsDict) {
+    rune *rstr = NULL;
+    t_len slen = 0;
+    float score = 0;
+    int dist = 0;
+    size_t termLen;
+
+    TrieIterator *it = Trie_Iterate(ctx->spec->terms, "", 0, 0, 1);
+    while (TrieIterator_Next(it, &rstr, &slen, NULL, &score, &dist)) {
+      char *res = runesToStr(rstr, slen, &termLen);
+      RedisModuleString *keyName = fmtRedisTermKey(ctx, res, strlen(res));
+      Redis_DropScanHandler(ctx->redisCtx, keyName, ctx);
+      RedisModule_FreeString(ctx->redisCtx, keyName);
+      free(res);
+    }
+    DFAFilter_Free(it->ctx);
+    free(it->ctx);
+    TrieIterator_Free(it);
   }
-  DFAFilter_Free(it->ctx);
-  free(it->ctx);
-  TrieIterator_Free(it);
 
   // Delete the numeric, tag, and geo indexes which reside on separate keys
   for (size_t i = 0; i < ctx->spec->numFields; i++) {
@@ -8,6 +8,10 @@
 #include "concurrent_ctx.h"
 #include "spec.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Open an inverted index reader on a redis DMA string, for a specific term.
  * If singleWordMode is set to 1, we do not load the skip index, only the score index
  */
@@ -50,6 +54,10 @@ int Redis_OptimizeScanHandler(RedisModuleCtx *ctx, RedisModuleString *kn, void *
  */
 int Redis_DropIndex(RedisSearchCtx *ctx, int deleteDocuments, int deleteSpecKey);
 
+/* Drop all term-open-cache entries of a spec. Must be called whenever the spec's term keys may
+ * stop existing (index drop / spec free) */
+void TermCache_OnSpecInvalidated(const IndexSpec *sp);
+
 /* Drop all the index's internal keys using this scan handler */
 int Redis_DropScanHandler(RedisModuleCtx *ctx, RedisModuleString *kn, void *opaque);
 
@@ -60,6 +68,21 @@ int Redis_StatsScanHandler(RedisModuleCtx *ctx, RedisModuleString *kn, void *opa
  * TODO: Add index name to it
  */
 RedisModuleString *fmtRedisTermKey(RedisSearchCtx *ctx, const char *term, size_t len);
+
+/* Partitioned term key: the docId-range partition rides as a "#p<N>" suffix */
+RedisModuleString *fmtRedisTermKeyPart(RedisSearchCtx *ctx, const char *term, size_t len,
+                                       uint32_t part);
+
+/* Open one partition's term index (spec-resident dictionaries only) */
+InvertedIndex *Redis_OpenInvertedIndexPart(RedisSearchCtx *ctx, const char *term, size_t len,
+                                           int write, uint32_t part);
+
+/* Reader over every partition of a term: per-partition read iterators unioned
+ * together (partitions hold disjoint ascending docId ranges). NULL when no
+ * partition has the term */
+IndexIterator *Redis_OpenPartitionedTermIterator(RedisSearchCtx *ctx, RSQueryTerm *term,
+                                                 DocTable *dt, t_fieldMask fieldMask,
+                                                 ConcurrentSearchCtx *csx, double weight);
 RedisModuleString *fmtRedisSkipIndexKey(RedisSearchCtx *ctx, const char *term, size_t len);
 RedisModuleString *fmtRedisNumericIndexKey(RedisSearchCtx *ctx, const char *field);
 
@@ -72,4 +95,8 @@ void InvertedIndex_Digest(RedisModuleDigest *digest, void *value);
 int InvertedIndex_RegisterType(RedisModuleCtx *ctx);
 unsigned long InvertedIndex_MemUsage(const void *value);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
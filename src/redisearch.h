@@ -63,9 +63,16 @@ typedef enum {
 typedef struct RSDocumentMetadata_s {
   t_docId id;
 
-  /* The actual key of the document, not the internal incremental id */
+  /* The document key's suffix (an sds), following keyPrefix when one is set.
+   * When keyPrefix is NULL this is the whole user-defined key. Use the
+   * DMD_Key* accessors in doc_table.h rather than reading this directly */
   char *keyPtr;
 
+  /* Shared, refcounted key prefix (up to and including the last ':'),
+   * interned per doc-table so keys like product:region:... store the common
+   * part once. NULL when the key has no prefix or interning is disabled */
+  struct DMDKeyPrefix *keyPrefix;
+
   /* The a-priory document score as given by the user on insertion */
   float score;
 
@@ -75,8 +82,14 @@ typedef struct RSDocumentMetadata_s {
   /* The total weighted number of tokens in the document, weighted by field weights */
   uint32_t len : 24;
 
-  /* Document flags  */
-  RSDocumentFlags flags : 8;
+  /* Document flags (low byte) packed with the reference count (upper 24 bits)
+   * in a single word, so readers on concurrent threads can take a reference or
+   * observe deletion with one atomic access and no lock. Use the DMD_ accessors
+   * in doc_table.h rather than touching this directly. Together with this,
+   * score/maxFreq/len are written only before the document is published (or
+   * under the GIL for score on partial replace) and may be read without
+   * synchronization */
+  uint32_t flagsRefs;
 
   /* Optional user payload */
   RSPayload *payload;
@@ -85,10 +98,12 @@ typedef struct RSDocumentMetadata_s {
   /* Offsets of all terms in the document (in bytes). Used by highlighter */
   struct RSByteOffsets *byteOffsets;
 
-  uint32_t ref_count;
-
-  struct RSDocumentMetadata_s *next;
-  struct RSDocumentMetadata_s *prev;
+  /* Bucket-chain links and this entry's own slot, as 32-bit (page,slot)
+   * references into the global DMD slab (see doc_table.h). DMD_REF_NIL
+   * terminates a chain */
+  uint32_t next;
+  uint32_t prev;
+  uint32_t selfRef;
 } RSDocumentMetadata;
 
 /* Forward declaration of the opaque query object */
@@ -198,11 +213,25 @@ typedef struct RSOffsetVector {
 } RSOffsetVector;
 
 /* RSOffsetIterator is an interface for iterating offset vectors of aggregate and token records */
+/* Iterator read-amplification statistics. Accumulated per IndexReader while
+ * it lives, folded into its spec when it is freed, and dumped via
+ * FT.DEBUG ITERATOR_STATS */
+typedef struct {
+  size_t entriesDecoded;
+  size_t entriesReturned;
+  size_t skipToCalls;
+  size_t skipToHits;
+  size_t blocksEntered;
+} IterRAStats;
+
 typedef struct RSOffsetIterator {
   void *ctx;
   uint32_t (*Next)(void *ctx, RSQueryTerm **term);
   void (*Rewind)(void *ctx);
   void (*Free)(void *ctx);
+  /* Optional: consume and return the first remaining offset >= x, or
+   * RS_OFFSETVECTOR_EOF. NULL when the underlying encoding cannot skip */
+  uint32_t (*SkipTo)(void *ctx, uint32_t x, RSQueryTerm **term);
 } RSOffsetIterator;
 
 /* RSIndexRecord represents a single record of a document inside a term in the inverted index */
@@ -292,6 +321,12 @@ typedef struct RSIndexResult {
 
   /* Relative weight for scoring calculations. This is derived from the result's iterator weight */
   double weight;
+
+  /* Static per-query scoring factor: weight * idf for term records, the bare
+   * weight otherwise. Computed once when the query opens its readers, so the
+   * per-document scoring loop multiplies it by the frequency instead of
+   * re-deriving it per record */
+  double scoreCoeff;
 } RSIndexResult;
 
 #pragma pack()
@@ -315,6 +350,22 @@ typedef struct {
   double avgDocLen;
 } RSIndexStats;
 
+/* Entries in the per-query BM25 normalization table: term frequencies below
+ * this index a precomputed f / (f + K) instead of dividing per record */
+#define RS_BM25_NORM_TABLE_SIZE 64
+
+/* Per-query score context: static factors a scorer derives from the index
+ * stats once instead of once per document. Zero-initialized along with the
+ * args; the scoring function fills it lazily on its first record */
+typedef struct {
+  int initialized;
+  /* BM25: the frequency-independent denominator term k1 * (1 - b + b * avgDocLen) */
+  double bm25K;
+  /* BM25: f / (f + bm25K) for every frequency below the table size, so the
+   * per-record divide becomes a load. Rarer larger frequencies divide */
+  double bm25FreqNorm[RS_BM25_NORM_TABLE_SIZE];
+} RSQueryScoreCtx;
+
 /* The context given to a scoring function. It includes the payload set by the user or expander,
  * the
  * private data set by the extensionm and callback functions */
@@ -329,6 +380,13 @@ typedef struct {
   /* Index statistics to be used by scoring functions */
   RSIndexStats indexStats;
 
+  /* Hoisted per-query factors, owned by the scoring function */
+  RSQueryScoreCtx scoreCtx;
+
+  /* Per-query scorer state built by the v2 NewInstance hook; NULL for v1
+   * scorers and scorers that registered no lifecycle */
+  void *scorerInstance;
+
   /* The GetSlop() calback. Returns the cumulative "slop" or distance between the query terms,
    * that can be used to factor the result score */
   int (*GetSlop)(RSIndexResult *res);
@@ -338,6 +396,41 @@ typedef struct {
 typedef double (*RSScoringFunction)(ScoringFunctionArgs *ctx, RSIndexResult *res,
                                     RSDocumentMetadata *dmd, double minScore);
 
+/* Batch variant of the scoring callback: scores n results in one call, writing
+ * each row's score (RS_SCORE_FILTEROUT allowed) to scores[i]. results[i] and
+ * dmds[i] carry the same pair the scalar callback receives per row. Optional -
+ * scorers without one are driven row by row */
+typedef void (*RSBatchScoringFunction)(ScoringFunctionArgs *ctx, RSIndexResult **results,
+                                       const RSDocumentMetadata **dmds, double *scores, size_t n,
+                                       double minScore);
+
+/* Version of the extension API the engine implements. Extensions inspect
+ * RSExtensionCtx.apiVersion at init time and fall back to the v1 calls when
+ * running against an older engine */
+#define RS_EXTENSION_API_VERSION 2
+
+/* Full descriptor for a v2 scorer registration. Only sf is required; batch
+ * scoring and the per-query instance lifecycle are opt-in capabilities */
+typedef struct {
+  /* Scalar entry point; always used when no batch form exists */
+  RSScoringFunction sf;
+  /* Optional batch entry point (see RSBatchScoringFunction) */
+  RSBatchScoringFunction bsf;
+  /* Optional per-query state: called once when the query's scorer is set up,
+   * with the populated args; its return value is available to every scoring
+   * call as args->scorerInstance */
+  void *(*NewInstance)(ScoringFunctionArgs *args);
+  /* Frees what NewInstance returned, at query teardown */
+  void (*FreeInstance)(void *instance);
+  /* v1-compatible registration privdata and its per-query free */
+  RSFreeFunction ff;
+  void *privdata;
+  /* Set when the scoring function reads res->term.offsets. Scorers that
+   * leave it clear let the engine run its offset-skipping decoders. Scorers
+   * registered through the v1 call are assumed to need offsets */
+  int needsOffsets;
+} RSScoringFunctionDesc;
+
 /* The extension registeration context, containing the callbacks avaliable to the extension for
  * registering query expanders and scorers. */
 typedef struct RSExtensionCtx {
@@ -345,6 +438,16 @@ typedef struct RSExtensionCtx {
                                  void *privdata);
   int (*RegisterQueryExpander)(const char *alias, RSQueryTokenExpander exp, RSFreeFunction ff,
                                void *privdata);
+  /* Attach a batch entry point to an already registered scorer alias */
+  int (*RegisterBatchScoringFunction)(const char *alias, RSBatchScoringFunction bsf);
+
+  /* -- v2 -- */
+
+  /* The engine's RS_EXTENSION_API_VERSION; 0 when loaded by a v1 engine that
+   * predates the field (v1 zero-initialized the trailing struct bytes) */
+  int apiVersion;
+  /* Register a scorer with the full v2 descriptor */
+  int (*RegisterScoringFunctionV2)(const char *alias, const RSScoringFunctionDesc *desc);
 } RSExtensionCtx;
 
 /* An extension initialization function  */
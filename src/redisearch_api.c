@@ -1,4 +1,6 @@
 #include "spec.h"
+#include "result_cache.h"
+#include "strintern.h"
 #include "field_spec.h"
 #include "redisearch_api.h"
 #include "document.h"
@@ -9,32 +11,29 @@
 #include "query_internal.h"
 #include "numeric_filter.h"
 #include "query.h"
+#include "aggregate/partials.h"
 
 int RS_GetCApiVersion() {
   return REDISEARCH_CAPI_VERSION;
 }
 
-static dictType invidxDictType = {0};
+char *RS_AggPartialMerge(const char *a, size_t alen, const char *b, size_t blen, size_t *outlen) {
+  return AggPartial_Merge(a, alen, b, blen, outlen);
+}
 
-static void valFreeCb(void* unused, void* p) {
-  KeysDictValue* kdv = p;
-  if (kdv->dtor) {
-    kdv->dtor(kdv->p);
-  }
-  free(kdv);
+int RS_AggPartialFinalize(const char *blob, size_t len, double *out) {
+  return AggPartial_Finalize(blob, len, out);
+}
+
+void RS_FreeAggPartial(char *blob) {
+  rm_free(blob);
 }
 
 IndexSpec* RS_CreateIndex(const char* name, RSGetValueCallback getValue, void* getValueCtx) {
   IndexSpec* spec = NewIndexSpec(name);
   spec->flags |= Index_Temporary;  // temporary is so that we will not use threads!!
 
-  // Initialize only once:
-  if (!invidxDictType.valDestructor) {
-    invidxDictType = dictTypeHeapRedisStrings;
-    invidxDictType.valDestructor = valFreeCb;
-  }
-
-  spec->keysDict = dictCreate(&invidxDictType, NULL);
+  spec->keysDict = IndexSpec_NewKeysDict();
   spec->minPrefix = 0;
   spec->maxPrefixExpansions = -1;
   spec->getValue = getValue;
@@ -52,7 +51,7 @@ void RS_DropIndex(IndexSpec* sp) {
 
 static inline FieldSpec* RS_CreateField(IndexSpec* sp, const char* name) {
   FieldSpec* fs = IndexSpec_CreateField(sp);
-  FieldSpec_SetName(fs, name);
+  FieldSpec_SetNameInterned(fs, StrIntern_Get(sp->fieldNames, name, strlen(name)));
   return fs;
 }
 
@@ -123,6 +122,9 @@ int RS_DropDocument(IndexSpec* sp, const void* docKey, size_t len) {
     return 0;
   }
   int rc = DocTable_DeleteR(&sp->docs, docId);
+  if (rc && sp->resultCache) {
+    ResultCache_OnDocDelete(sp->resultCache);
+  }
   if (rc) {
     sp->stats.numDocuments--;
     return 1;
@@ -333,6 +335,9 @@ int moduleRegisterApi(const char* funcname, void* funcptr);
 
 int RS_InitializeLibrary(RedisModuleCtx* ctx) {
   REGISTER_API(GetCApiVersion, moduleRegisterApi);
+  REGISTER_API(AggPartialMerge, moduleRegisterApi);
+  REGISTER_API(AggPartialFinalize, moduleRegisterApi);
+  REGISTER_API(FreeAggPartial, moduleRegisterApi);
 
   REGISTER_API(CreateIndex, moduleRegisterApi);
   REGISTER_API(DropIndex, moduleRegisterApi);
@@ -7,7 +7,7 @@
 extern "C" {
 #endif
 
-#define REDISEARCH_CAPI_VERSION 1
+#define REDISEARCH_CAPI_VERSION 2
 
 #define MODULE_API_FUNC(T, N) extern T(*N)
 
@@ -44,6 +44,17 @@ typedef int (*RSGetValueCallback)(void* ctx, const char* fieldName, const void*
 
 MODULE_API_FUNC(int, RediSearch_GetCApiVersion)();
 
+/* Shard-local pre-aggregation (see aggregate/partials.h): fold two partial
+ * blobs of the same reducer kind into a freshly allocated merged blob (free
+ * with RediSearch_FreeAggPartial), or NULL on malformed/mismatched inputs */
+MODULE_API_FUNC(char *, RediSearch_AggPartialMerge)
+(const char *a, size_t alen, const char *b, size_t blen, size_t *outlen);
+
+/* Extract the exact final number from a partial blob. 0 on a malformed blob */
+MODULE_API_FUNC(int, RediSearch_AggPartialFinalize)(const char *blob, size_t len, double *out);
+
+MODULE_API_FUNC(void, RediSearch_FreeAggPartial)(char *blob);
+
 MODULE_API_FUNC(RSIndex*, RediSearch_CreateIndex)
 (const char* name, RSGetValueCallback getValue, void* getValueCtx);
 
@@ -138,6 +149,9 @@ MODULE_API_FUNC(void, RediSearch_ResultsIteratorReset)(RSResultsIterator* iter);
 
 #define RS_XAPIFUNC(X)           \
   X(GetCApiVersion)              \
+  X(AggPartialMerge)             \
+  X(AggPartialFinalize)          \
+  X(FreeAggPartial)              \
   X(CreateIndex)                 \
   X(DropIndex)                   \
   X(CreateTextField)             \
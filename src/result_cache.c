@@ -0,0 +1,317 @@
+#include "result_cache.h"
+#include "rmalloc.h"
+#include "util/arr.h"
+#include "util/fnv.h"
+#include "dep/triemap/triemap.h"
+#include <string.h>
+#include <time.h>
+
+/* Epoch buckets for term hashing. A collision only over-invalidates, never
+ * serves a stale reply */
+#define RESULT_CACHE_EPOCH_BUCKETS 4096
+
+/* Above this many entries the cache is flushed wholesale: the workload this
+ * serves is a small set of very hot queries, not a general LRU population */
+#define RESULT_CACHE_MAX_ENTRIES 128
+
+typedef struct {
+  char *key;
+  size_t keyLen;
+  size_t memUsed;  // this entry's accounted footprint
+  CachedReply *reply;
+  /* Captured epochs of the query's term buckets */
+  uint32_t *buckets;
+  uint64_t *epochs;
+  size_t nterms;
+  /* Which global counter the entry validates against: anyWriteEpoch when any
+   * write can change the result set, deleteEpoch otherwise */
+  int dependsOnAll;
+  uint64_t globalEpoch;
+  uint64_t deadlineMs;
+} ResultCacheEntry;
+
+struct ResultCache {
+  TrieMap *entries;
+  size_t numEntries;
+  size_t memUsed;
+  uint64_t termEpochs[RESULT_CACHE_EPOCH_BUCKETS];
+  uint64_t anyWriteEpoch;
+  uint64_t deleteEpoch;
+};
+
+static uint64_t rcNowMs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint32_t rcTermBucket(const char *term, size_t len) {
+  return fnv_64a_buf((void *)term, len, 0xcbf29ce484222325ULL) % RESULT_CACHE_EPOCH_BUCKETS;
+}
+
+/****************************** CachedReply ******************************/
+
+CachedReply *CachedReply_New(void) {
+  CachedReply *r = rm_calloc(1, sizeof(*r));
+  r->items = array_new(CachedReplyItem, 32);
+  return r;
+}
+
+void CachedReply_Free(CachedReply *r) {
+  if (!r) {
+    return;
+  }
+  for (size_t i = 0; i < array_len(r->items); ++i) {
+    rm_free(r->items[i].str);
+  }
+  array_free(r->items);
+  rm_free(r);
+}
+
+static CachedReplyItem *crAppend(CachedReply *r, uint8_t type) {
+  CachedReplyItem it = {.type = type};
+  r->items = array_append(r->items, it);
+  return &r->items[array_len(r->items) - 1];
+}
+
+size_t CachedReply_BeginArray(CachedReply *r) {
+  crAppend(r, CR_REPLY_ARRAY);
+  return array_len(r->items) - 1;
+}
+
+void CachedReply_EndArray(CachedReply *r, size_t token, long long len) {
+  r->items[token].ll = len;
+}
+
+void CachedReply_LongLong(CachedReply *r, long long v) {
+  crAppend(r, CR_REPLY_LONGLONG)->ll = v;
+}
+
+void CachedReply_Double(CachedReply *r, double v) {
+  crAppend(r, CR_REPLY_DOUBLE)->d = v;
+}
+
+void CachedReply_StringBuffer(CachedReply *r, const char *s, size_t n) {
+  CachedReplyItem *it = crAppend(r, CR_REPLY_STRBUF);
+  it->str = rm_strndup(s, n);
+  it->len = n;
+}
+
+void CachedReply_SimpleString(CachedReply *r, const char *s) {
+  CachedReplyItem *it = crAppend(r, CR_REPLY_SIMPLESTR);
+  it->str = rm_strdup(s);
+  it->len = strlen(s);
+}
+
+void CachedReply_Null(CachedReply *r) {
+  crAppend(r, CR_REPLY_NULL);
+}
+
+void CachedReply_Value(CachedReply *r, const RSValue *v, int typed) {
+  v = RSValue_Dereference(v);
+  switch (v->t) {
+    case RSValue_String:
+      CachedReply_StringBuffer(r, v->strval.str, v->strval.len);
+      return;
+    case RSValue_RedisString: {
+      size_t n;
+      const char *s = RedisModule_StringPtrLen(v->rstrval, &n);
+      CachedReply_StringBuffer(r, s, n);
+      return;
+    }
+    case RSValue_Number: {
+      char buf[128];
+      snprintf(buf, sizeof(buf), "%.12g", v->numval);
+      if (typed) {
+        CachedReplyItem *it = crAppend(r, CR_REPLY_ERROR);
+        it->str = rm_strdup(buf);
+        it->len = strlen(buf);
+      } else {
+        CachedReply_StringBuffer(r, buf, strlen(buf));
+      }
+      return;
+    }
+    case RSValue_Array: {
+      size_t tok = CachedReply_BeginArray(r);
+      for (uint32_t i = 0; i < v->arrval.len; i++) {
+        CachedReply_Value(r, v->arrval.vals[i], typed);
+      }
+      CachedReply_EndArray(r, tok, v->arrval.len);
+      return;
+    }
+    case RSValue_Null:
+    default:
+      CachedReply_Null(r);
+      return;
+  }
+}
+
+void CachedReply_Send(const CachedReply *r, RedisModuleCtx *ctx) {
+  for (size_t i = 0; i < array_len(r->items); ++i) {
+    const CachedReplyItem *it = &r->items[i];
+    switch (it->type) {
+      case CR_REPLY_ARRAY:
+        RedisModule_ReplyWithArray(ctx, it->ll);
+        break;
+      case CR_REPLY_LONGLONG:
+        RedisModule_ReplyWithLongLong(ctx, it->ll);
+        break;
+      case CR_REPLY_DOUBLE:
+        RedisModule_ReplyWithDouble(ctx, it->d);
+        break;
+      case CR_REPLY_STRBUF:
+        RedisModule_ReplyWithStringBuffer(ctx, it->str, it->len);
+        break;
+      case CR_REPLY_SIMPLESTR:
+        RedisModule_ReplyWithSimpleString(ctx, it->str);
+        break;
+      case CR_REPLY_ERROR:
+        RedisModule_ReplyWithError(ctx, it->str);
+        break;
+      case CR_REPLY_NULL:
+        RedisModule_ReplyWithNull(ctx);
+        break;
+    }
+  }
+}
+
+/****************************** ResultCache ******************************/
+
+ResultCache *ResultCache_New(void) {
+  ResultCache *rc = rm_calloc(1, sizeof(*rc));
+  rc->entries = NewTrieMap();
+  return rc;
+}
+
+static size_t rcEntryFootprint(const ResultCacheEntry *e) {
+  size_t sz = sizeof(*e) + e->keyLen + e->nterms * (sizeof(*e->buckets) + sizeof(*e->epochs));
+  for (size_t i = 0; i < array_len(e->reply->items); ++i) {
+    sz += sizeof(CachedReplyItem) + e->reply->items[i].len;
+  }
+  return sz;
+}
+
+static ResultCache *rcOwner_g;  // set around frees so footprints unaccount
+
+static void rcEntryFree(void *p) {
+  ResultCacheEntry *e = p;
+  if (rcOwner_g) {
+    rcOwner_g->memUsed -= e->memUsed;
+  }
+  CachedReply_Free(e->reply);
+  rm_free(e->key);
+  rm_free(e->buckets);
+  rm_free(e->epochs);
+  rm_free(e);
+}
+
+static void *rcEntryReplace(void *oldval, void *newval) {
+  // oldval is NULL when the key existed only as an interior trie node
+  if (oldval) {
+    rcEntryFree(oldval);
+  }
+  return newval;
+}
+
+void ResultCache_Free(ResultCache *rc) {
+  if (!rc) {
+    return;
+  }
+  TrieMap_Free(rc->entries, rcEntryFree);
+  rm_free(rc);
+}
+
+void ResultCache_OnTermWrite(ResultCache *rc, const char *term, size_t len) {
+  rc->termEpochs[rcTermBucket(term, len)]++;
+  rc->anyWriteEpoch++;
+}
+
+void ResultCache_OnDocChange(ResultCache *rc) {
+  rc->anyWriteEpoch++;
+}
+
+void ResultCache_OnDocDelete(ResultCache *rc) {
+  ResultCache_OnUnattributedChange(rc);
+}
+
+void ResultCache_OnUnattributedChange(ResultCache *rc) {
+  rc->deleteEpoch++;
+  rc->anyWriteEpoch++;
+}
+
+static int rcEntryValid(const ResultCache *rc, const ResultCacheEntry *e) {
+  if (rcNowMs() >= e->deadlineMs) {
+    return 0;
+  }
+  if (e->dependsOnAll) {
+    return e->globalEpoch == rc->anyWriteEpoch;
+  }
+  if (e->globalEpoch != rc->deleteEpoch) {
+    return 0;
+  }
+  for (size_t i = 0; i < e->nterms; ++i) {
+    if (rc->termEpochs[e->buckets[i]] != e->epochs[i]) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+const CachedReply *ResultCache_Get(ResultCache *rc, const char *key, size_t keyLen) {
+  ResultCacheEntry *e = TrieMap_Find(rc->entries, (char *)key, keyLen);
+  if (!e || (void *)e == TRIEMAP_NOTFOUND) {
+    return NULL;
+  }
+  if (!rcEntryValid(rc, e)) {
+    rcOwner_g = rc;
+    TrieMap_Delete(rc->entries, (char *)key, keyLen, rcEntryFree);
+    rcOwner_g = NULL;
+    rc->numEntries--;
+    return NULL;
+  }
+  return e->reply;
+}
+
+void ResultCache_Put(ResultCache *rc, const char *key, size_t keyLen, CachedReply *reply,
+                     const char **terms, const size_t *termLens, size_t nterms, int dependsOnAll,
+                     long long ttlMs) {
+  if (rc->numEntries >= RESULT_CACHE_MAX_ENTRIES) {
+    // The hot set this cache serves is small; wholesale flush beats
+    // maintaining an eviction order
+    TrieMap_Free(rc->entries, rcEntryFree);
+    rc->entries = NewTrieMap();
+    rc->numEntries = 0;
+    rc->memUsed = 0;
+  }
+
+  ResultCacheEntry *e = rm_calloc(1, sizeof(*e));
+  e->key = rm_strndup(key, keyLen);
+  e->keyLen = keyLen;
+  e->reply = reply;
+  e->dependsOnAll = dependsOnAll;
+  e->deadlineMs = rcNowMs() + ttlMs;
+  if (dependsOnAll) {
+    e->globalEpoch = rc->anyWriteEpoch;
+  } else {
+    e->globalEpoch = rc->deleteEpoch;
+    e->nterms = nterms;
+    e->buckets = rm_malloc(nterms * sizeof(*e->buckets));
+    e->epochs = rm_malloc(nterms * sizeof(*e->epochs));
+    for (size_t i = 0; i < nterms; ++i) {
+      e->buckets[i] = rcTermBucket(terms[i], termLens[i]);
+      e->epochs[i] = rc->termEpochs[e->buckets[i]];
+    }
+  }
+
+  e->memUsed = rcEntryFootprint(e);
+  rc->memUsed += e->memUsed;
+  rcOwner_g = rc;  // a replaced entry unaccounts through the free callback
+  if (TrieMap_Add(rc->entries, (char *)key, keyLen, e, rcEntryReplace)) {
+    rc->numEntries++;
+  }
+  rcOwner_g = NULL;
+}
+
+size_t ResultCache_MemUsage(const ResultCache *rc) {
+  return rc ? rc->memUsed : 0;
+}
@@ -0,0 +1,97 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include "redismodule.h"
+#include "value.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An opt-in cache of serialized first-page replies, held per index spec and
+ * keyed by the verbatim command line. Entries are invalidated by per-term
+ * write epochs - hashed into a fixed bucket table, so writes that do not
+ * touch a cached query's terms leave it alive - plus a global epoch for
+ * query shapes whose result set any write can change (numeric, NOT,
+ * prefixes, ...), and a TTL as the final backstop. Enabled by setting the
+ * RESULT_CACHE_TTL configuration to a nonzero number of milliseconds. All
+ * access happens under the GIL */
+
+/* One recorded reply element. Arrays carry their final element count, so a
+ * recorded reply replays without postponed lengths */
+typedef enum {
+  CR_REPLY_ARRAY,
+  CR_REPLY_LONGLONG,
+  CR_REPLY_DOUBLE,
+  CR_REPLY_STRBUF,
+  CR_REPLY_SIMPLESTR,
+  CR_REPLY_ERROR,
+  CR_REPLY_NULL
+} CachedReplyItemType;
+
+typedef struct {
+  uint8_t type;
+  long long ll;  // array length or integer payload
+  double d;
+  char *str;
+  size_t len;
+} CachedReplyItem;
+
+typedef struct CachedReply {
+  CachedReplyItem *items;  // util/arr array
+} CachedReply;
+
+CachedReply *CachedReply_New(void);
+void CachedReply_Free(CachedReply *r);
+
+/* Begin an array whose length is not yet known; returns a token for EndArray */
+size_t CachedReply_BeginArray(CachedReply *r);
+void CachedReply_EndArray(CachedReply *r, size_t token, long long len);
+
+void CachedReply_LongLong(CachedReply *r, long long v);
+void CachedReply_Double(CachedReply *r, double v);
+void CachedReply_StringBuffer(CachedReply *r, const char *s, size_t n);
+void CachedReply_SimpleString(CachedReply *r, const char *s);
+void CachedReply_Null(CachedReply *r);
+
+/* Record an RSValue the way RSValue_SendReply serializes it. Kept in sync
+ * with that function's wire shapes */
+void CachedReply_Value(CachedReply *r, const RSValue *v, int typed);
+
+/* Replay a recorded reply into the client context */
+void CachedReply_Send(const CachedReply *r, RedisModuleCtx *ctx);
+
+struct ResultCache;
+typedef struct ResultCache ResultCache;
+
+ResultCache *ResultCache_New(void);
+void ResultCache_Free(ResultCache *rc);
+
+/* Write-side invalidation hooks. All are cheap counter bumps */
+void ResultCache_OnTermWrite(ResultCache *rc, const char *term, size_t len);
+void ResultCache_OnDocChange(ResultCache *rc);
+void ResultCache_OnDocDelete(ResultCache *rc);
+/* A change per-term epochs cannot attribute (metadata updates, synonym
+ * changes): invalidates term entries the way a delete does */
+void ResultCache_OnUnattributedChange(ResultCache *rc);
+
+/* Look up a still-valid entry for the exact command line; NULL on miss,
+ * stale epochs, or expired TTL (stale entries are dropped on the way) */
+const CachedReply *ResultCache_Get(ResultCache *rc, const char *key, size_t keyLen);
+
+/* Store a recorded reply, taking ownership of it. terms/termLens name the
+ * query's literal terms, whose current epochs are captured; dependsOnAll
+ * marks query shapes any write can affect. ttlMs bounds the entry's life */
+void ResultCache_Put(ResultCache *rc, const char *key, size_t keyLen, CachedReply *reply,
+                     const char **terms, const size_t *termLens, size_t nterms, int dependsOnAll,
+                     long long ttlMs);
+
+/* Approximate resident bytes of the cached entries */
+size_t ResultCache_MemUsage(const ResultCache *rc);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,5 +1,7 @@
 #include "result_processor.h"
+#include "perf_counters.h"
 #include "query.h"
+#include "util/arr.h"
 #include "extension.h"
 #include <util/minmax_heap.h>
 #include "ext/default.h"
@@ -17,6 +19,7 @@ void QITR_Cleanup(QueryIterator *qitr) {
     }
     p = next;
   }
+  QITR_DrainResultPool(qitr);
 }
 
 void SearchResult_Clear(SearchResult *r) {
@@ -40,6 +43,49 @@ void SearchResult_Destroy(SearchResult *r) {
   RLookupRow_Cleanup(&r->rowdata);
 }
 
+SearchResult *QITR_PooledResult(QueryIterator *qitr) {
+  SearchResult *r = qitr->resultPool;
+  if (r) {
+    qitr->resultPool = r->poolNext;
+    r->docId = 0;
+    return r;
+  }
+  return calloc(1, sizeof(*r));
+}
+
+void QITR_RecycleResult(QueryIterator *qitr, SearchResult *r) {
+  SearchResult_Clear(r);
+  r->poolNext = qitr->resultPool;
+  qitr->resultPool = r;
+}
+
+int QITR_ChargeMemory(QueryIterator *qitr, size_t n) {
+  IndexSpec *spec = qitr->sctx ? qitr->sctx->spec : NULL;
+  if (!spec || spec->aggMemQuota <= 0) {
+    return 1;
+  }
+  if (__atomic_add_fetch(&spec->aggMemUsed, n, __ATOMIC_ACQ_REL) > (size_t)spec->aggMemQuota) {
+    __atomic_sub_fetch(&spec->aggMemUsed, n, __ATOMIC_ACQ_REL);
+    if (qitr->err) {
+      QueryError_SetError(qitr->err, QUERY_EQUOTA,
+                          "Aggregation memory quota exceeded for this index");
+    }
+    qitr->state = QITR_S_ABORTED;
+    return 0;
+  }
+  qitr->aggMemCharged += n;
+  return 1;
+}
+
+void QITR_DrainResultPool(QueryIterator *qitr) {
+  while (qitr->resultPool) {
+    SearchResult *next = qitr->resultPool->poolNext;
+    RLookupRow_Cleanup(&qitr->resultPool->rowdata);
+    free(qitr->resultPool);
+    qitr->resultPool = next;
+  }
+}
+
 static int RPGeneric_NextEOF(ResultProcessor *rp, SearchResult *res) {
   return RS_RESULT_EOF;
 }
@@ -51,11 +97,52 @@ static int RPGeneric_NextEOF(ResultProcessor *rp, SearchResult *res) {
  * downstream.
  ********************************************************************************************************************/
 
+/* How many results to pull from a batch-capable root iterator per refill */
+#define RPIDX_BATCH_SIZE 64
+
 typedef struct {
   ResultProcessor base;
   IndexIterator *iiter;
+
+  /* When the root iterator supports ReadBatch, results are pulled in chunks through here,
+   * amortizing the per-document virtual dispatch of the iterator protocol */
+  RSIndexResult batch[RPIDX_BATCH_SIZE];
+  uint32_t batchLen;
+  uint32_t batchPos;
+  int batchEof;
+  int resumed;  // the stateless-cursor floor seek has been performed
 } RPIndexIterator;
 
+/* Seek the root iterator past the stateless-cursor resume floor, once. The
+ * landing hit (SkipTo consumes it) is handed back as the first candidate;
+ * returns 0 at EOF, 1 with *r set, or -1 when there is nothing to resume */
+static int rpidxResume(RPIndexIterator *self, RSIndexResult **r) {
+  t_docId floor = self->base.parent->resumeAfterId;
+  if (!floor || self->resumed) {
+    return -1;
+  }
+  self->resumed = 1;
+  RSIndexResult *hit = NULL;
+  if (self->iiter->SkipTo) {
+    int rc = self->iiter->SkipTo(self->iiter->ctx, floor + 1, &hit);
+    if (rc == INDEXREAD_EOF || !hit) {
+      return 0;
+    }
+  } else {
+    // iterators without a seek (e.g. the shared eof iterator) resume by
+    // reading forward until the floor is cleared
+    int rc;
+    do {
+      rc = self->iiter->Read(self->iiter->ctx, &hit);
+      if (rc == INDEXREAD_EOF) {
+        return 0;
+      }
+    } while (!hit || hit->docId <= floor);
+  }
+  *r = hit;
+  return 1;
+}
+
 /* Next implementation */
 static int rpidxNext(ResultProcessor *base, SearchResult *res) {
   RPIndexIterator *self = (RPIndexIterator *)base;
@@ -70,18 +157,45 @@ static int rpidxNext(ResultProcessor *base, SearchResult *res) {
   RSDocumentMetadata *dmd;
   int rc;
 
+  switch (rpidxResume(self, &r)) {
+    case 0:
+      return RS_RESULT_EOF;
+    case 1:
+      goto have_hit;
+    default:
+      break;
+  }
+
   // Read from the root filter until we have a valid result
   while (1) {
-    rc = it->Read(it->ctx, &r);
-    // This means we are done!
-    if (rc == INDEXREAD_EOF) {
-      return RS_RESULT_EOF;
-    } else if (!r || rc == INDEXREAD_NOTFOUND) {
-      continue;
+    if (it->ReadBatch) {
+      if (self->batchPos == self->batchLen) {
+        if (self->batchEof) {
+          return RS_RESULT_EOF;
+        }
+        self->batchLen = it->ReadBatch(it->ctx, self->batch, RPIDX_BATCH_SIZE);
+        self->batchPos = 0;
+        if (self->batchLen < RPIDX_BATCH_SIZE) {
+          self->batchEof = 1;
+        }
+        if (self->batchLen == 0) {
+          return RS_RESULT_EOF;
+        }
+      }
+      r = &self->batch[self->batchPos++];
+    } else {
+      rc = it->Read(it->ctx, &r);
+      // This means we are done!
+      if (rc == INDEXREAD_EOF) {
+        return RS_RESULT_EOF;
+      } else if (!r || rc == INDEXREAD_NOTFOUND) {
+        continue;
+      }
     }
 
+  have_hit:
     dmd = DocTable_Get(&RP_SPEC(base)->docs, r->docId);
-    if (!dmd || (dmd->flags & Document_Deleted)) {
+    if (!dmd || (DMD_Flags(dmd) & Document_Deleted)) {
       continue;
     }
 
@@ -100,6 +214,81 @@ static int rpidxNext(ResultProcessor *base, SearchResult *res) {
   return RS_RESULT_OK;
 }
 
+/* Chunked pull: serve rows out of the current internal batch only - a refill
+ * overwrites the RSIndexResult array earlier rows point into, so a chunk
+ * never outlives its batch */
+static int rpidxNextChunk(ResultProcessor *base, ResultChunk *chunk) {
+  RPIndexIterator *self = (RPIndexIterator *)base;
+  IndexIterator *it = self->iiter;
+  chunk->len = 0;
+
+  if (!it) {
+    return RS_RESULT_EOF;
+  }
+
+  RSIndexResult *resumeHit = NULL;
+  switch (rpidxResume(self, &resumeHit)) {
+    case 0:
+      return RS_RESULT_EOF;
+    case 1: {
+      // emit the SkipTo landing hit as a one-row chunk; batching resumes on
+      // the next pull from wherever the seek left the iterator
+      RSDocumentMetadata *dmd = DocTable_Get(&RP_SPEC(base)->docs, resumeHit->docId);
+      if (dmd && !(DMD_Flags(dmd) & Document_Deleted)) {
+        base->parent->totalResults++;
+        SearchResult *res = &chunk->rows[chunk->len++];
+        memset(res, 0, sizeof(*res));
+        res->docId = resumeHit->docId;
+        res->indexResult = resumeHit;
+        res->score = 0;
+        res->dmd = dmd;
+        res->rowdata.sv = dmd->sortVector;
+        DMD_Incref(dmd);
+        return RS_RESULT_OK;
+      }
+      break;  // deleted: fall through to normal batching
+    }
+    default:
+      break;
+  }
+
+  // loop until the chunk has rows: a batch may consist entirely of deleted
+  // documents, and recursing per skipped batch could get deep
+  while (chunk->len == 0) {
+    if (self->batchPos == self->batchLen) {
+      if (self->batchEof) {
+        return RS_RESULT_EOF;
+      }
+      self->batchLen = it->ReadBatch(it->ctx, self->batch, RPIDX_BATCH_SIZE);
+      self->batchPos = 0;
+      if (self->batchLen < RPIDX_BATCH_SIZE) {
+        self->batchEof = 1;
+      }
+      if (self->batchLen == 0) {
+        return RS_RESULT_EOF;
+      }
+    }
+
+    while (self->batchPos < self->batchLen && chunk->len < RESULT_CHUNK_LEN) {
+      RSIndexResult *r = &self->batch[self->batchPos++];
+      RSDocumentMetadata *dmd = DocTable_Get(&RP_SPEC(base)->docs, r->docId);
+      if (!dmd || (DMD_Flags(dmd) & Document_Deleted)) {
+        continue;
+      }
+      base->parent->totalResults++;
+      SearchResult *res = &chunk->rows[chunk->len++];
+      memset(res, 0, sizeof(*res));  // chunk storage is raw - no caller-owned state to preserve
+      res->docId = r->docId;
+      res->indexResult = r;
+      res->score = 0;
+      res->dmd = dmd;
+      res->rowdata.sv = dmd->sortVector;
+      DMD_Incref(dmd);
+    }
+  }
+  return RS_RESULT_OK;
+}
+
 static void rpidxFree(ResultProcessor *iter) {
   free(iter);
 }
@@ -108,6 +297,9 @@ ResultProcessor *RPIndexIterator_New(IndexIterator *root) {
   RPIndexIterator *ret = calloc(1, sizeof(*ret));
   ret->iiter = root;
   ret->base.Next = rpidxNext;
+  if (root && root->ReadBatch) {
+    ret->base.NextChunk = rpidxNextChunk;
+  }
   ret->base.Free = rpidxFree;
   ret->base.name = "Index";
   return &ret->base;
@@ -135,6 +327,7 @@ void QITR_FreeChain(QueryIterator *qitr) {
     rp->Free(rp);
     rp = next;
   }
+  QITR_DrainResultPool(qitr);
 }
 
 /*******************************************************************************************************************
@@ -148,7 +341,9 @@ void QITR_FreeChain(QueryIterator *qitr) {
 typedef struct {
   ResultProcessor base;
   RSScoringFunction scorer;
+  RSBatchScoringFunction batchScorer;
   RSFreeFunction scorerFree;
+  void (*instanceFree)(void *instance);
   ScoringFunctionArgs scorerCtx;
 } RPScorer;
 
@@ -181,9 +376,62 @@ static int rpscoreNext(ResultProcessor *base, SearchResult *res) {
   return rc;
 }
 
+/* Chunked scoring: score an upstream chunk in place, compacting rows the
+ * scorer filters out */
+static int rpscoreNextChunk(ResultProcessor *base, ResultChunk *chunk) {
+  RPScorer *self = (RPScorer *)base;
+  int rc;
+
+  do {
+    rc = ResultProcessor_NextChunk(base->upstream, chunk);
+    if (rc != RS_RESULT_OK) {
+      return rc;
+    }
+    if (self->batchScorer) {
+      // One call scores the whole chunk through the extension's vectorized
+      // entry point
+      RSIndexResult *results[RESULT_CHUNK_LEN];
+      const RSDocumentMetadata *dmds[RESULT_CHUNK_LEN];
+      double scores[RESULT_CHUNK_LEN];
+      for (uint32_t i = 0; i < chunk->len; i++) {
+        results[i] = chunk->rows[i].indexResult;
+        dmds[i] = chunk->rows[i].dmd;
+      }
+      self->batchScorer(&self->scorerCtx, results, dmds, scores, chunk->len,
+                        base->parent->minScore);
+      for (uint32_t i = 0; i < chunk->len; i++) {
+        chunk->rows[i].score = scores[i];
+      }
+    }
+    uint32_t out = 0;
+    for (uint32_t i = 0; i < chunk->len; i++) {
+      SearchResult *res = &chunk->rows[i];
+      if (!self->batchScorer) {
+        res->score = self->scorer(&self->scorerCtx, res->indexResult, res->dmd,
+                                  base->parent->minScore);
+      }
+      if (res->score == RS_SCORE_FILTEROUT) {
+        base->parent->totalResults--;
+        SearchResult_Clear(res);
+        continue;
+      }
+      if (out != i) {
+        chunk->rows[out] = *res;
+        memset(res, 0, sizeof(*res));
+      }
+      out++;
+    }
+    chunk->len = out;
+  } while (chunk->len == 0);
+  return RS_RESULT_OK;
+}
+
 /* Free impl. for scorer - frees up the scorer privdata if needed */
 static void rpscoreFree(ResultProcessor *rp) {
   RPScorer *self = (RPScorer *)rp;
+  if (self->instanceFree && self->scorerCtx.scorerInstance) {
+    self->instanceFree(self->scorerCtx.scorerInstance);
+  }
   if (self->scorerFree) {
     self->scorerFree(self->scorerCtx.extdata);
   }
@@ -196,9 +444,16 @@ ResultProcessor *RPScorer_New(const ExtScoringFunctionCtx *funcs,
                               const ScoringFunctionArgs *fnargs) {
   RPScorer *ret = calloc(1, sizeof(*ret));
   ret->scorer = funcs->sf;
+  ret->batchScorer = funcs->bsf;
   ret->scorerFree = funcs->ff;
+  ret->instanceFree = funcs->freeInstance;
   ret->scorerCtx = *fnargs;
+  if (funcs->newInstance) {
+    // v2 per-query state: built once here, handed to every scoring call
+    ret->scorerCtx.scorerInstance = funcs->newInstance(&ret->scorerCtx);
+  }
   ret->base.Next = rpscoreNext;
+  ret->base.NextChunk = rpscoreNextChunk;
   ret->base.Free = rpscoreFree;
   ret->base.name = "Scorer";
   return &ret->base;
@@ -254,6 +509,8 @@ typedef struct {
     const RLookupKey **keys;
     size_t nkeys;
     uint64_t ascendMap;
+    // Columnar source for the single-numeric-sortable shape (may be NULL)
+    const RSSortingTable *sortables;
   } fieldcmp;
 
 } RPSorter;
@@ -267,8 +524,12 @@ static int rpsortNext_Yield(ResultProcessor *rp, SearchResult *r) {
     RLookupRow oldrow = r->rowdata;
     *r = *sr;
 
-    free(sr);
-    RLookupRow_Cleanup(&oldrow);
+    // recycle the shell with the consumer's previous row map, whose capacity
+    // the next accumulated row can reuse. Ownership of dmd moved into *r
+    sr->rowdata = oldrow;
+    sr->dmd = NULL;
+    sr->indexResult = NULL;
+    QITR_RecycleResult(rp->parent, sr);
     return RS_RESULT_OK;
   }
   return RS_RESULT_EOF;
@@ -292,7 +553,7 @@ static int rpsortNext_innerLoop(ResultProcessor *rp, SearchResult *r) {
   RPSorter *self = (RPSorter *)rp;
 
   if (self->pooledResult == NULL) {
-    self->pooledResult = calloc(1, sizeof(*self->pooledResult));
+    self->pooledResult = QITR_PooledResult(rp->parent);
   } else {
     RLookupRow_Wipe(&self->pooledResult->rowdata);
   }
@@ -314,6 +575,10 @@ static int rpsortNext_innerLoop(ResultProcessor *rp, SearchResult *r) {
   // If the pool size is 0 we always do that, letting the heap grow dynamically
   if (!self->size || self->pq->count + 1 < self->pq->size) {
 
+    // the heap grows by one retained row: that is what the memory quota tracks
+    if (!QITR_ChargeMemory(rp->parent, sizeof(*h))) {
+      return RS_RESULT_ERROR;
+    }
     // copy the index result to make it thread safe - but only if it is pushed to the heap
     h->indexResult = NULL;
     mmh_insert(self->pq, h);
@@ -346,7 +611,73 @@ static int rpsortNext_innerLoop(ResultProcessor *rp, SearchResult *r) {
   return RESULT_QUEUED;
 }
 
+/* Feed one upstream row (already detached into `h`) into the heap. Mirrors
+ * rpsortNext_innerLoop's insertion logic for the chunked path */
+static int rpsortFeed(RPSorter *self, SearchResult *h) {
+  PERF_SCOPE(PERFCTR_SORTER_INSERT);
+  ResultProcessor *rp = &self->base;
+  if (!self->size || self->pq->count + 1 < self->pq->size) {
+    if (!QITR_ChargeMemory(rp->parent, sizeof(*h))) {
+      QITR_RecycleResult(rp->parent, h);
+      return 0;
+    }
+    h->indexResult = NULL;
+    mmh_insert(self->pq, h);
+    if (h->score < rp->parent->minScore) {
+      rp->parent->minScore = h->score;
+    }
+    return 1;
+  }
+  SearchResult *minh = mmh_peek_min(self->pq);
+  if (minh->score > rp->parent->minScore) {
+    rp->parent->minScore = minh->score;
+  }
+  if (self->cmp(h, minh, self->cmpCtx) > 0) {
+    h->indexResult = NULL;
+    SearchResult *evicted = mmh_pop_min(self->pq);
+    mmh_insert(self->pq, h);
+    QITR_RecycleResult(rp->parent, evicted);
+  } else {
+    QITR_RecycleResult(rp->parent, h);
+  }
+  return 1;
+}
+
 static int rpsortNext_Accum(ResultProcessor *rp, SearchResult *r) {
+  RPSorter *self = (RPSorter *)rp;
+
+  // When the upstream can produce chunks, consume them wholesale - one
+  // virtual call per RESULT_CHUNK_LEN rows instead of one per row
+  if (rp->upstream->NextChunk) {
+    ResultChunk chunk;
+    int rc;
+    while ((rc = ResultProcessor_NextChunk(rp->upstream, &chunk)) == RS_RESULT_OK) {
+      for (uint32_t i = 0; i < chunk.len; i++) {
+        SearchResult *h = QITR_PooledResult(rp->parent);
+        RLookupRow pooledRow = h->rowdata;
+        *h = chunk.rows[i];
+        if (!h->rowdata.dyn) {
+          // adopt the recycled row map's capacity (index chunk rows carry none)
+          h->rowdata.dyn = pooledRow.dyn;
+        } else if (pooledRow.dyn) {
+          array_free(pooledRow.dyn);
+        }
+        if (!rpsortFeed(self, h)) {
+          // quota: release the rest of the chunk's references before aborting
+          for (uint32_t j = i + 1; j < chunk.len; j++) {
+            SearchResult_Clear(&chunk.rows[j]);
+          }
+          return RS_RESULT_ERROR;
+        }
+      }
+    }
+    if (rc != RS_RESULT_EOF) {
+      return rc;
+    }
+    rp->Next = rpsortNext_Yield;
+    return rpsortNext_Yield(rp, r);
+  }
+
   int rc;
   while ((rc = rpsortNext_innerLoop(rp, r)) == RESULT_QUEUED) {
     // Do nothing.
@@ -367,6 +698,96 @@ static inline int cmpByScore(const void *e1, const void *e2, const void *udata)
 }
 
 /* Compare results for the heap by sorting key */
+/* Single numeric SORTBY key: the overwhelmingly common aggregation shape.
+ * Compares raw doubles without the per-key loop or RSValue_Cmp dispatch,
+ * falling back to the generic comparison when either value is not (or not
+ * yet) a number */
+static int cmpBySingleNumericField(const void *e1, const void *e2, const void *udata) {
+  const RPSorter *self = udata;
+  const SearchResult *h1 = e1, *h2 = e2;
+  const RSValue *v1 = RLookup_GetItem(self->fieldcmp.keys[0], &h1->rowdata);
+  const RSValue *v2 = RLookup_GetItem(self->fieldcmp.keys[0], &h2->rowdata);
+  int ascending = SORTASCMAP_GETASC(self->fieldcmp.ascendMap, 0);
+
+  int rc;
+  if (v1 && v2) {
+    v1 = RSValue_Dereference(v1);
+    v2 = RSValue_Dereference(v2);
+    if (v1->t == RSValue_Number && v2->t == RSValue_Number) {
+      // same ordering (including NaN - both comparisons false) as RSValue_Cmp
+      rc = v1->numval > v2->numval ? 1 : (v1->numval < v2->numval ? -1 : 0);
+      if (rc != 0) {
+        return ascending ? -rc : rc;
+      }
+    } else {
+      rc = RSValue_Cmp(v1, v2);
+      if (rc != 0) {
+        return ascending ? -rc : rc;
+      }
+    }
+  } else {
+    // like the generic comparator, a missing value tie-breaks by docId
+    // without applying the field's sort direction
+    ascending = 0;
+  }
+  rc = h1->docId < h2->docId ? -1 : 1;
+  return ascending ? -rc : rc;
+}
+
+/* Columnar variant of the single-numeric comparator: when the sort key is a
+ * numeric sortable field with no row override, both values come straight from
+ * the field's column - one array access by docId instead of the
+ * row -> vector -> RSValue chain. Anything irregular falls back to the boxed
+ * comparator for identical semantics */
+static inline int sorterColumnVal(const RPSorter *self, const SearchResult *h, double *out) {
+  const RLookupKey *k = self->fieldcmp.keys[0];
+  if (h->rowdata.dyn && array_len(h->rowdata.dyn) > k->dstidx && h->rowdata.dyn[k->dstidx]) {
+    return 0;  // an APPLY overrode the field in this row
+  }
+  return SortingTable_ColumnGet(self->fieldcmp.sortables, k->svidx, h->docId, out);
+}
+
+static int cmpBySingleNumericColumn(const void *e1, const void *e2, const void *udata) {
+  const RPSorter *self = udata;
+  const SearchResult *h1 = e1, *h2 = e2;
+  double d1, d2;
+  if (sorterColumnVal(self, h1, &d1) && sorterColumnVal(self, h2, &d2)) {
+    int rc = d1 > d2 ? 1 : (d1 < d2 ? -1 : 0);
+    int ascending = SORTASCMAP_GETASC(self->fieldcmp.ascendMap, 0);
+    if (rc != 0) {
+      return ascending ? -rc : rc;
+    }
+    rc = h1->docId < h2->docId ? -1 : 1;
+    return ascending ? -rc : rc;
+  }
+  return cmpBySingleNumericField(e1, e2, udata);
+}
+
+/* Columnar variant for a single STRING sortable key: most comparisons resolve
+ * on the 8-byte big-endian collation prefix with one integer compare; prefix
+ * ties, missing keys and overridden rows fall back to the boxed comparator
+ * (whose RSValue_Cmp agrees with the prefix ordering by construction) */
+static inline int sorterStrKey(const RPSorter *self, const SearchResult *h, uint64_t *out) {
+  const RLookupKey *k = self->fieldcmp.keys[0];
+  if (h->rowdata.dyn && array_len(h->rowdata.dyn) > k->dstidx && h->rowdata.dyn[k->dstidx]) {
+    return 0;
+  }
+  return SortingTable_ColumnGetStrKey(self->fieldcmp.sortables, k->svidx, h->docId, out);
+}
+
+static int cmpBySingleStringColumn(const void *e1, const void *e2, const void *udata) {
+  const RPSorter *self = udata;
+  const SearchResult *h1 = e1, *h2 = e2;
+  uint64_t k1, k2;
+  if (sorterStrKey(self, h1, &k1) && sorterStrKey(self, h2, &k2) && k1 != k2) {
+    int rc = k1 < k2 ? -1 : 1;
+    return SORTASCMAP_GETASC(self->fieldcmp.ascendMap, 0) ? -rc : rc;
+  }
+  // equal prefixes need the full string walk; anything missing gets the
+  // generic handling
+  return cmpBySingleNumericField(e1, e2, udata);
+}
+
 static int cmpByFields(const void *e1, const void *e2, const void *udata) {
   const RPSorter *self = udata;
   const SearchResult *h1 = e1, *h2 = e2;
@@ -403,9 +824,20 @@ static void srDtor(void *p) {
 }
 
 ResultProcessor *RPSorter_NewByFields(size_t maxresults, const RLookupKey **keys, size_t nkeys,
-                                      uint64_t ascmap) {
+                                      uint64_t ascmap, const RSSortingTable *sortables) {
   RPSorter *ret = calloc(1, sizeof(*ret));
-  ret->cmp = nkeys ? cmpByFields : cmpByScore;
+  ret->cmp = nkeys == 1 ? cmpBySingleNumericField : (nkeys ? cmpByFields : cmpByScore);
+  // The columnar comparators apply when the single sort key is a sortable
+  // field of a spec we can reach the columns of
+  if (nkeys == 1 && sortables && (keys[0]->flags & RLOOKUP_F_SVSRC)) {
+    if (sortables->fields[keys[0]->svidx].type == RSValue_Number) {
+      ret->cmp = cmpBySingleNumericColumn;
+      ret->fieldcmp.sortables = sortables;
+    } else if (sortables->fields[keys[0]->svidx].type == RSValue_String) {
+      ret->cmp = cmpBySingleStringColumn;
+      ret->fieldcmp.sortables = sortables;
+    }
+  }
   ret->cmpCtx = ret;
   ret->fieldcmp.ascendMap = ascmap;
   ret->fieldcmp.keys = keys;
@@ -422,7 +854,7 @@ ResultProcessor *RPSorter_NewByFields(size_t maxresults, const RLookupKey **keys
 }
 
 ResultProcessor *RPSorter_NewByScore(size_t maxresults) {
-  return RPSorter_NewByFields(maxresults, NULL, 0, 0);
+  return RPSorter_NewByFields(maxresults, NULL, 0, 0, NULL);
 }
 
 void SortAscMap_Dump(uint64_t tt, size_t n) {
@@ -519,7 +951,7 @@ static int rploaderNext(ResultProcessor *base, SearchResult *r) {
 
   // Current behavior skips entire result if document does not exist.
   // I'm unusre if that's intentional or an oversight.
-  if (r->dmd == NULL || (r->dmd->flags & Document_Deleted)) {
+  if (r->dmd == NULL || (DMD_Flags(r->dmd) & Document_Deleted)) {
     return RS_RESULT_OK;
   }
   RedisSearchCtx *sctx = lc->base.parent->sctx;
@@ -73,6 +73,18 @@ typedef struct {
   QITRState state;
 
   struct timespec startTime;
+
+  // Freelist of recycled SearchResults shared by the pipeline's processors
+  // (see QITR_PooledResult / QITR_RecycleResult)
+  struct SearchResult *resultPool;
+
+  /* Stateless-cursor resume floor: when nonzero, the root processor seeks the
+   * index iterator past this docId before producing its first result */
+  t_docId resumeAfterId;
+
+  /* Accumulation bytes charged against the spec's aggMemQuota by the grouper
+   * and sorter stages; refunded when the request is freed */
+  size_t aggMemCharged;
 } QueryIterator, QueryProcessingCtx;
 
 IndexIterator *QITR_GetRootFilter(QueryIterator *it);
@@ -86,7 +98,7 @@ void QITR_FreeChain(QueryIterator *qitr);
  * And a list of fields loaded by the chain - currenly only by the loader, but possibly by
  * aggregators later on
  */
-typedef struct {
+typedef struct SearchResult {
   t_docId docId;
 
   // not all results have score - TBD
@@ -101,8 +113,29 @@ typedef struct {
 
   // Row data. Use RLookup_* functions to access
   RLookupRow rowdata;
+
+  // Freelist link, meaningful only while the result sits in the pipeline's
+  // recycle pool
+  struct SearchResult *poolNext;
 } SearchResult;
 
+/* Pop a recycled result from the pipeline's freelist, or allocate a fresh one.
+ * Recycled results come back cleared, with their row map capacity retained, so
+ * steady-state row churn touches no allocator */
+SearchResult *QITR_PooledResult(QueryIterator *qitr);
+
+/* Return a result to the freelist: its values are dropped, the row map keeps
+ * its capacity for the next row */
+void QITR_RecycleResult(QueryIterator *qitr, SearchResult *r);
+
+/* Release everything in the freelist. Called when the pipeline is torn down */
+void QITR_DrainResultPool(QueryIterator *qitr);
+
+/* Charge `n` bytes of accumulation memory against the spec's quota (see
+ * aggMemQuota). Returns 0 - with the iterator put into the error state - when
+ * the quota is exhausted; always succeeds on quota-less specs */
+int QITR_ChargeMemory(QueryIterator *qitr, size_t n);
+
 /* Result processor return codes */
 
 /** Possible return values from Next() */
@@ -128,6 +161,8 @@ typedef enum {
  * Result processor structure. This should be "Subclassed" by the actual
  * implementations
  */
+struct ResultChunk;
+
 typedef struct ResultProcessor {
   // Reference to the parent structure
   QueryIterator *parent;
@@ -151,10 +186,44 @@ typedef struct ResultProcessor {
    */
   int (*Next)(struct ResultProcessor *self, SearchResult *res);
 
+  /**
+   * Optional chunked variant of Next. Fills `chunk->rows[0..len)` and
+   * returns RS_RESULT_OK when at least one row was produced, or the
+   * terminating code otherwise. Rows reference live upstream state exactly
+   * like a single Next() result does, and stay valid until the next
+   * NextChunk/Next call on this processor; the caller owns their rowdata.
+   * Stages that cannot batch leave this NULL - consumers fall back to
+   * single-row pulls through ResultProcessor_NextChunk(), which never
+   * buffers across a non-chunked stage (a buffered row's indexResult may
+   * alias the iterator's single mutating result object).
+   */
+  int (*NextChunk)(struct ResultProcessor *self, struct ResultChunk *chunk);
+
   /** Frees the processor and any internal data related to it. */
   void (*Free)(struct ResultProcessor *self);
 } ResultProcessor;
 
+#define RESULT_CHUNK_LEN 64
+
+typedef struct ResultChunk {
+  SearchResult rows[RESULT_CHUNK_LEN];
+  uint32_t len;
+} ResultChunk;
+
+/* Pull a chunk from `up`: its own NextChunk when available, otherwise a
+ * single row via Next (see the NextChunk doc for why no buffering happens) */
+static inline int ResultProcessor_NextChunk(ResultProcessor *up, ResultChunk *chunk) {
+  if (up->NextChunk) {
+    return up->NextChunk(up, chunk);
+  }
+  // Next()'s contract lets it skip fields it does not produce, so the row must
+  // not carry stack garbage into the consumer (chunk storage is raw)
+  memset(&chunk->rows[0], 0, sizeof(chunk->rows[0]));
+  int rc = up->Next(up, &chunk->rows[0]);
+  chunk->len = rc == RS_RESULT_OK ? 1 : 0;
+  return rc;
+}
+
 /* Helper function - get the total from a processor, and if the Total callback is NULL, climb up
  * the
  * chain until we find a processor with a Total callback. This allows processors to avoid
@@ -194,8 +263,10 @@ ResultProcessor *RPScorer_New(const ExtScoringFunctionCtx *funcs,
 #define SORTASCMAP_GETASC(mm, pos) ((mm) & (1LLU << (pos)))
 void SortAscMap_Dump(uint64_t v, size_t n);
 
+/* sortables (optional) enables the columnar comparator when the single sort
+ * key is a numeric sortable field */
 ResultProcessor *RPSorter_NewByFields(size_t maxresults, const RLookupKey **keys, size_t nkeys,
-                                      uint64_t ascendingMap);
+                                      uint64_t ascendingMap, const RSSortingTable *sortables);
 
 ResultProcessor *RPSorter_NewByScore(size_t maxresults);
 
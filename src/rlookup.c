@@ -2,6 +2,9 @@
 #include <document.h>
 #include <assert.h>
 #include <util/arr.h>
+#include <util/flatdict.h>
+#include <util/dict.h>
+#include "rmalloc.h"
 
 static RLookupKey *createNewKey(RLookup *lookup, const char *name, size_t n, int flags,
                                 uint16_t idx) {
@@ -23,6 +26,12 @@ static RLookupKey *createNewKey(RLookup *lookup, const char *name, size_t n, int
     lookup->tail->next = ret;
     lookup->tail = ret;
   }
+
+  // Keep the interned-name map in sync so lookups stay O(1)
+  if (!lookup->byName) {
+    lookup->byName = FlatDict_New();
+  }
+  FlatDict_Set(lookup->byName, ret->name, ret);
   return ret;
 }
 
@@ -32,14 +41,7 @@ static RLookupKey *genKeyFromSpec(RLookup *lookup, const char *name, int flags)
     return NULL;
   }
 
-  const FieldSpec *fs = NULL;
-  for (size_t ii = 0; ii < cc->nfields; ++ii) {
-    if (!strcmp(cc->fields[ii].name, name)) {
-      fs = cc->fields + ii;
-      break;
-    }
-  }
-
+  const FieldSpec *fs = cc->byName ? FlatDict_Get(cc->byName, name) : NULL;
   if (!fs) {
     // Field does not exist in the schema at all
     return NULL;
@@ -47,7 +49,10 @@ static RLookupKey *genKeyFromSpec(RLookup *lookup, const char *name, int flags)
 
   uint16_t idx = lookup->rowlen++;
 
-  RLookupKey *ret = createNewKey(lookup, name, strlen(name), flags, idx);
+  // Borrow the snapshot's own copy of the field name: it outlives the lookup
+  // (the lookup pins the snapshot), so the per-query strdup is unnecessary
+  RLookupKey *ret =
+      createNewKey(lookup, fs->name, strlen(fs->name), flags & ~RLOOKUP_F_NAMEALLOC, idx);
   if (FieldSpec_IsSortable(fs)) {
     ret->flags |= RLOOKUP_F_SVSRC;
     ret->svidx = fs->sortIdx;
@@ -60,14 +65,11 @@ RLookupKey *RLookup_GetKeyEx(RLookup *lookup, const char *name, size_t n, int fl
   RLookupKey *ret = NULL;
   int isNew = 0;
 
-  for (RLookupKey *kk = lookup->head; kk; kk = kk->next) {
-    size_t origlen = strlen(kk->name);
-    if (origlen == n && !strncmp(kk->name, name, origlen)) {
-      if (flags & RLOOKUP_F_OEXCL) {
-        return NULL;
-      }
-      ret = kk;
-      break;
+  if (lookup->byName) {
+    // length-delimited probe: no stack copy needed
+    ret = FlatDict_GetN(lookup->byName, name, n);
+    if (ret && (flags & RLOOKUP_F_OEXCL)) {
+      return NULL;
     }
   }
 
@@ -204,6 +206,10 @@ void RLookup_Cleanup(RLookup *lk) {
     IndexSpecCache_Decref(lk->spcache);
     lk->spcache = NULL;
   }
+  if (lk->byName) {
+    FlatDict_Free(lk->byName);
+    lk->byName = NULL;
+  }
 
   lk->head = lk->tail = NULL;
   memset(lk, 0xff, sizeof(*lk));
@@ -277,8 +283,7 @@ static int getKeyCommon(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOption
   // In this case, the flag must be obtained via HGET
   if (!options->keyobj) {
     RedisModuleCtx *ctx = options->sctx->redisCtx;
-    RedisModuleString *keyName =
-        RedisModule_CreateString(ctx, options->dmd->keyPtr, strlen(options->dmd->keyPtr));
+    RedisModuleString *keyName = DMD_CreateKeyString(options->dmd, ctx);
     options->keyobj = RedisModule_OpenKey(ctx, keyName, REDISMODULE_READ);
     RedisModule_FreeString(ctx, keyName);
     if (!options->keyobj) {
@@ -348,8 +353,7 @@ static int RLookup_HGETALL(RLookup *it, RLookupRow *dst, RLookupLoadOptions *opt
   int rc = REDISMODULE_ERR;
   RedisModuleCallReply *rep = NULL;
   RedisModuleCtx *ctx = options->sctx->redisCtx;
-  RedisModuleString *krstr =
-      RedisModule_CreateString(ctx, options->dmd->keyPtr, sdslen(options->dmd->keyPtr));
+  RedisModuleString *krstr = DMD_CreateKeyString(options->dmd, ctx);
 
   rep = RedisModule_Call(ctx, "HGETALL", "s", krstr);
 
@@ -97,6 +97,10 @@ typedef struct RLookup {
   // If present, then GetKey will consult this list if the value is not found in
   // the existing list of keys.
   IndexSpecCache *spcache;
+
+  // Interned name -> RLookupKey map, kept in sync with the linked list so
+  // stage-setup key resolution is O(1) instead of a list scan per key
+  struct FlatDict *byName;
 } RLookup;
 
 // If the key cannot be found, do not mark it as an error, but create it and
@@ -4,9 +4,32 @@
 #include <stdlib.h>
 #include <string.h>
 #include "redismodule.h"
+#include "rmalloc_track.h"
 
 #ifdef REDIS_MODULE_TARGET /* Set this when compiling your code as a module */
 
+#ifdef RS_ALLOC_TRACKING
+
+/* Accounting shim: every allocation carries a size+tag header settled against
+ * the per-tag counters (see rmalloc_track.h) */
+static inline void *rm_malloc(size_t n) {
+  return RmTrack_Malloc(n);
+}
+static inline void *rm_calloc(size_t nelem, size_t elemsz) {
+  return RmTrack_Calloc(nelem, elemsz);
+}
+static inline void *rm_realloc(void *p, size_t n) {
+  return RmTrack_Realloc(p, n);
+}
+static inline void rm_free(void *p) {
+  RmTrack_Free(p);
+}
+static inline char *rm_strdup(const char *s) {
+  return RmTrack_Strdup(s);
+}
+
+#else
+
 static inline void *rm_malloc(size_t n) {
   return RedisModule_Alloc(n);
 }
@@ -23,6 +46,8 @@ static inline char *rm_strdup(const char *s) {
   return RedisModule_Strdup(s);
 }
 
+#endif /* RS_ALLOC_TRACKING */
+
 static char *rm_strndup(const char *s, size_t n) {
   char *ret = (char *)rm_malloc(n + 1);
 
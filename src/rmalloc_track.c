@@ -0,0 +1,115 @@
+#include "rmalloc_track.h"
+#include <string.h>
+
+RmAllocTagStats rmAllocStats_g[RM_TAG__MAX];
+
+const char *rmAllocTagNames_g[RM_TAG__MAX] = {
+    [RM_TAG_UNTAGGED] = "untagged",     [RM_TAG_POSTINGS] = "postings",
+    [RM_TAG_DOCTABLE] = "doctable",     [RM_TAG_VALUES] = "values",
+    [RM_TAG_GROUPER] = "grouper",       [RM_TAG_FRAGMENTER] = "fragmenter",
+};
+
+#ifdef RS_ALLOC_TRACKING
+
+#include "redismodule.h"
+
+#define TRACK_MAGIC 0x52414c4cu  // "RALL"
+#define TAG_STACK_DEPTH 16
+
+typedef struct {
+  uint64_t size;
+  uint32_t tag;
+  uint32_t magic;
+} TrackHeader;
+
+static __thread RmAllocTag tagStack_g[TAG_STACK_DEPTH];
+static __thread int tagDepth_g;
+
+void RmTrack_PushTag(RmAllocTag tag) {
+  if (tagDepth_g < TAG_STACK_DEPTH) {
+    tagStack_g[tagDepth_g] = tag;
+  }
+  tagDepth_g++;
+}
+
+void RmTrack_PopTag(void) {
+  if (tagDepth_g > 0) {
+    tagDepth_g--;
+  }
+}
+
+static RmAllocTag currentTag(void) {
+  if (tagDepth_g == 0) {
+    return RM_TAG_UNTAGGED;
+  }
+  int d = tagDepth_g <= TAG_STACK_DEPTH ? tagDepth_g : TAG_STACK_DEPTH;
+  return tagStack_g[d - 1];
+}
+
+static void settleAlloc(RmAllocTag tag, size_t n) {
+  __atomic_fetch_add(&rmAllocStats_g[tag].liveBytes, n, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&rmAllocStats_g[tag].allocs, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&rmAllocStats_g[tag].totalBytes, n, __ATOMIC_RELAXED);
+}
+
+static void settleFree(RmAllocTag tag, size_t n) {
+  __atomic_fetch_sub(&rmAllocStats_g[tag].liveBytes, n, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&rmAllocStats_g[tag].frees, 1, __ATOMIC_RELAXED);
+}
+
+void *RmTrack_Malloc(size_t n) {
+  TrackHeader *h = RedisModule_Alloc(sizeof(*h) + n);
+  h->size = n;
+  h->tag = currentTag();
+  h->magic = TRACK_MAGIC;
+  settleAlloc(h->tag, n);
+  return h + 1;
+}
+
+void *RmTrack_Calloc(size_t nelem, size_t elemsz) {
+  size_t n = nelem * elemsz;
+  void *p = RmTrack_Malloc(n);
+  memset(p, 0, n);
+  return p;
+}
+
+void RmTrack_Free(void *p) {
+  if (!p) {
+    return;
+  }
+  TrackHeader *h = (TrackHeader *)p - 1;
+  if (h->magic != TRACK_MAGIC) {
+    // not ours (allocated before the shim, or by Redis): pass through
+    RedisModule_Free(p);
+    return;
+  }
+  h->magic = 0;
+  settleFree(h->tag, h->size);
+  RedisModule_Free(h);
+}
+
+void *RmTrack_Realloc(void *p, size_t n) {
+  if (!p) {
+    return RmTrack_Malloc(n);
+  }
+  TrackHeader *h = (TrackHeader *)p - 1;
+  if (h->magic != TRACK_MAGIC) {
+    return RedisModule_Realloc(p, n);
+  }
+  settleFree(h->tag, h->size);
+  h = RedisModule_Realloc(h, sizeof(*h) + n);
+  h->size = n;
+  h->magic = TRACK_MAGIC;
+  // the block keeps its original tag across growth
+  settleAlloc(h->tag, n);
+  return h + 1;
+}
+
+char *RmTrack_Strdup(const char *s) {
+  size_t n = strlen(s) + 1;
+  char *ret = RmTrack_Malloc(n);
+  memcpy(ret, s, n);
+  return ret;
+}
+
+#endif  // RS_ALLOC_TRACKING
@@ -0,0 +1,64 @@
+#include "slowlog.h"
+#include "rmalloc.h"
+#include <string.h>
+
+struct SlowLog {
+  SlowLogEntry entries[SLOWLOG_MAX_ENTRIES];
+  uint32_t count;  // live entries (saturates at the capacity)
+  uint32_t pos;    // next write slot
+  uint64_t nextId;
+};
+
+SlowLog *SlowLog_New(void) {
+  return rm_calloc(1, sizeof(SlowLog));
+}
+
+static void entryClear(SlowLogEntry *e) {
+  sdsfree(e->cmd);
+  sdsfree(e->detail);
+  e->cmd = e->detail = NULL;
+}
+
+void SlowLog_Free(SlowLog *sl) {
+  if (!sl) {
+    return;
+  }
+  SlowLog_Reset(sl);
+  rm_free(sl);
+}
+
+void SlowLog_Add(SlowLog *sl, long long ms, sds cmd, sds detail) {
+  SlowLogEntry *e = &sl->entries[sl->pos];
+  entryClear(e);
+  e->id = sl->nextId++;
+  e->ts = time(NULL);
+  e->ms = ms;
+  e->cmd = cmd;
+  e->detail = detail;
+  sl->pos = (sl->pos + 1) % SLOWLOG_MAX_ENTRIES;
+  if (sl->count < SLOWLOG_MAX_ENTRIES) {
+    sl->count++;
+  }
+}
+
+void SlowLog_Reset(SlowLog *sl) {
+  for (uint32_t i = 0; i < SLOWLOG_MAX_ENTRIES; i++) {
+    entryClear(&sl->entries[i]);
+  }
+  sl->count = sl->pos = 0;
+}
+
+void SlowLog_Reply(const SlowLog *sl, RedisModuleCtx *ctx) {
+  RedisModule_ReplyWithArray(ctx, sl->count);
+  for (uint32_t i = 0; i < sl->count; i++) {
+    // newest first: walk backwards from the slot before `pos`
+    uint32_t at = (sl->pos + SLOWLOG_MAX_ENTRIES - 1 - i) % SLOWLOG_MAX_ENTRIES;
+    const SlowLogEntry *e = &sl->entries[at];
+    RedisModule_ReplyWithArray(ctx, 5);
+    RedisModule_ReplyWithLongLong(ctx, e->id);
+    RedisModule_ReplyWithLongLong(ctx, e->ts);
+    RedisModule_ReplyWithLongLong(ctx, e->ms);
+    RedisModule_ReplyWithStringBuffer(ctx, e->cmd, sdslen(e->cmd));
+    RedisModule_ReplyWithStringBuffer(ctx, e->detail, sdslen(e->detail));
+  }
+}
@@ -0,0 +1,48 @@
+#ifndef RS_SLOWLOG_H
+#define RS_SLOWLOG_H
+
+#include "redismodule.h"
+#include "rmutil/sds.h"
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Rolling per-index slow query log. When SLOWLOG_THRESHOLD_MS is set, every
+ * search command is instrumented with the FT.PROFILE machinery, and commands
+ * exceeding the threshold are recorded with their command line and the
+ * rendered per-stage attribution (iterator reads/skips and per-processor
+ * nanoseconds). The newest SLOWLOG_MAX_ENTRIES entries are retained per index
+ * and read back with FT.SLOWLOG {index} [RESET].
+ */
+
+#define SLOWLOG_MAX_ENTRIES 64
+
+typedef struct {
+  uint64_t id;
+  time_t ts;
+  long long ms;
+  sds cmd;     // the command line that was slow
+  sds detail;  // rendered per-stage attribution
+} SlowLogEntry;
+
+typedef struct SlowLog SlowLog;
+
+SlowLog *SlowLog_New(void);
+void SlowLog_Free(SlowLog *sl);
+
+/* Record one slow command. Takes ownership of `cmd` and `detail` */
+void SlowLog_Add(SlowLog *sl, long long ms, sds cmd, sds detail);
+
+void SlowLog_Reset(SlowLog *sl);
+
+/* Reply with the retained entries, newest first */
+void SlowLog_Reply(const SlowLog *sl, RedisModuleCtx *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
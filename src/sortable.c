@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <assert.h>
+#include <math.h>
 #include "dep/libnu/libnu.h"
 #include "rmutil/util.h"
 #include "rmutil/strings.h"
@@ -8,6 +9,63 @@
 #include "sortable.h"
 #include "buffer.h"
 
+/* A column holds either doubles (numeric fields) or collation keys (string
+ * fields); grow whichever array the field uses, padding with the missing
+ * marker */
+static void columnEnsure(RSSortingColumn *c, uint64_t docId, int isStr) {
+  if (docId < c->cap && (isStr ? c->strKeys != NULL : c->vals != NULL)) {
+    return;
+  }
+  size_t newCap = c->cap ? c->cap : 1024;
+  while (newCap <= docId) {
+    newCap *= 2;
+  }
+  if (isStr) {
+    size_t from = c->strKeys ? c->cap : 0;
+    c->strKeys = rm_realloc(c->strKeys, newCap * sizeof(*c->strKeys));
+    memset(c->strKeys + from, 0, (newCap - from) * sizeof(*c->strKeys));
+  } else {
+    size_t from = c->vals ? c->cap : 0;
+    c->vals = rm_realloc(c->vals, newCap * sizeof(*c->vals));
+    for (size_t i = from; i < newCap; i++) {
+      c->vals[i] = NAN;
+    }
+  }
+  c->cap = newCap;
+}
+
+void SortingTable_ColumnPut(RSSortingTable *tbl, int idx, uint64_t docId, double v) {
+  RSSortingColumn *c = &tbl->columns[idx];
+  columnEnsure(c, docId, 0);
+  c->vals[docId] = v;
+}
+
+void SortingTable_ColumnPutStrKey(RSSortingTable *tbl, int idx, uint64_t docId, uint64_t key) {
+  RSSortingColumn *c = &tbl->columns[idx];
+  columnEnsure(c, docId, 1);
+  c->strKeys[docId] = key;
+}
+
+void SortingTable_IngestVector(RSSortingTable *tbl, uint64_t docId,
+                               const struct RSSortingVector *sv) {
+  if (!sv) {
+    return;
+  }
+  for (int i = 0; i < sv->len; i++) {
+    const RSValue *v = sv->values[i];
+    if (v) {
+      v = RSValue_Dereference(v);
+      if (v->t == RSValue_Number) {
+        SortingTable_ColumnPut(tbl, i, docId, v->numval);
+      } else if (v->t == RSValue_String) {
+        // The vector stores the normalized form - key it as stored
+        SortingTable_ColumnPutStrKey(tbl, i, docId,
+                                     SortingTable_StrKey(v->strval.str, v->strval.len));
+      }
+    }
+  }
+}
+
 /* Create a sorting vector of a given length for a document */
 RSSortingVector *NewSortingVector(int len) {
   if (len > RS_SORTABLES_MAX) {
@@ -64,6 +122,7 @@ char *normalizeStr(const char *str) {
 
 /* Put a value in the sorting vector */
 void RSSortingVector_Put(RSSortingVector *tbl, int idx, const void *p, int type) {
+  RM_ALLOC_TAG_SCOPE(RM_TAG_VALUES);
   if (idx > RS_SORTABLES_MAX) {
     return;
   }
@@ -186,6 +245,10 @@ RSSortingTable *NewSortingTable(void) {
 }
 
 void SortingTable_Free(RSSortingTable *t) {
+  for (int i = 0; i < RS_SORTABLES_MAX; i++) {
+    rm_free(t->columns[i].vals);
+    rm_free(t->columns[i].strKeys);
+  }
   rm_free(t);
 }
 
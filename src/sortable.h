@@ -32,6 +32,17 @@ typedef struct RSSortingVector {
 
 #pragma pack()
 
+/* A typed column for one numeric sortable field: a contiguous array of
+ * doubles indexed by docId, maintained alongside the boxed sorting vectors.
+ * NAN marks a missing entry (the field parsers never produce NaN values).
+ * SORTBY and compiled numeric APPLY stages read these with one array access
+ * instead of the dmd -> vector -> RSValue chain */
+typedef struct {
+  double *vals;       // numeric fields
+  uint64_t *strKeys;  // string fields: big-endian collation-prefix keys, 0 = missing
+  size_t cap;         // in entries (docIds)
+} RSSortingColumn;
+
 /* RSSortingTable defines the length and names of the fields in a sorting vector. It is saved as
  * part of the spec */
 typedef struct {
@@ -40,6 +51,9 @@ typedef struct {
     const char *name;
     RSValueType type;
   } fields[RS_SORTABLES_MAX];
+
+  /* Columnar storage, populated only for numeric fields */
+  RSSortingColumn columns[RS_SORTABLES_MAX];
 } RSSortingTable;
 
 /* RSSortingKey describes the sorting of a query and is parsed from the redis command arguments */
@@ -79,6 +93,60 @@ int RSSortingVector_Cmp(RSSortingVector *self, RSSortingVector *other, RSSorting
 /* Put a value in the sorting vector */
 void RSSortingVector_Put(RSSortingVector *tbl, int idx, const void *p, int type);
 
+/* Record a numeric sortable value in the field's column */
+void SortingTable_ColumnPut(RSSortingTable *tbl, int idx, uint64_t docId, double v);
+
+/* Copy the numeric entries of a freshly-assigned sorting vector into the
+ * columns. Called wherever a document's sorting vector is installed */
+void SortingTable_IngestVector(RSSortingTable *tbl, uint64_t docId, const struct RSSortingVector *sv);
+
+/* Read a numeric sortable straight from the column. Returns 1 and fills *out
+ * when a value is present for the docId */
+static inline int SortingTable_ColumnGet(const RSSortingTable *tbl, int idx, uint64_t docId,
+                                         double *out) {
+  const RSSortingColumn *c = &tbl->columns[idx];
+  if (docId >= c->cap || !c->vals) {
+    return 0;
+  }
+  double d = c->vals[docId];
+  if (d != d) {  // NAN - missing
+    return 0;
+  }
+  *out = d;
+  return 1;
+}
+
+/* Build the 8-byte big-endian collation prefix of a (normalized) string.
+ * Integer comparison of two keys orders exactly like memcmp over the first 8
+ * bytes; equal keys (or the 0 key of an empty string) need the full compare */
+static inline uint64_t SortingTable_StrKey(const char *s, size_t n) {
+  uint64_t k = 0;
+  size_t m = n < 8 ? n : 8;
+  for (size_t i = 0; i < m; i++) {
+    k |= ((uint64_t)(unsigned char)s[i]) << (56 - 8 * i);
+  }
+  return k;
+}
+
+/* Record a string sortable's collation key in the field's column */
+void SortingTable_ColumnPutStrKey(RSSortingTable *tbl, int idx, uint64_t docId, uint64_t key);
+
+/* Read a string sortable's collation key. Returns 1 and fills *out when a
+ * key is present for the docId */
+static inline int SortingTable_ColumnGetStrKey(const RSSortingTable *tbl, int idx, uint64_t docId,
+                                               uint64_t *out) {
+  const RSSortingColumn *c = &tbl->columns[idx];
+  if (docId >= c->cap || !c->strKeys) {
+    return 0;
+  }
+  uint64_t k = c->strKeys[docId];
+  if (!k) {
+    return 0;
+  }
+  *out = k;
+  return 1;
+}
+
 /* Returns the value for a given index. Does not increment the refcount */
 static inline RSValue *RSSortingVector_Get(RSSortingVector *v, size_t index) {
   if (v->len <= index) {
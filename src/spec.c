@@ -1,4 +1,5 @@
 #include "rmutil/util.h"
+#include "dep/thpool/thpool.h"
 #include "spec.h"
 #include "util/logging.h"
 #include "util/misc.h"
@@ -13,16 +14,44 @@
 #include "tag_index.h"
 #include "redis_index.h"
 #include "indexer.h"
+#include "result_cache.h"
+#include "index_snapshot.h"
+#include "delta_log.h"
+#include "slowlog.h"
+#include "stemmer.h"
+#include "strintern.h"
+#include "util/flatdict.h"
+#include "dep/bloom/sb.h"
 
 void (*IndexSpec_OnCreate)(const IndexSpec *) = NULL;
 
 RedisModuleType *IndexSpecType;
 uint64_t spec_unique_ids = 0;
 
+static void keysDictValueFree(void *unused, void *p) {
+  KeysDictValue *kdv = p;
+  if (kdv->dtor) {
+    kdv->dtor(kdv->p);
+  }
+  free(kdv);
+}
+
+static dictType keysDictType = {0};
+
+dict *IndexSpec_NewKeysDict(void) {
+  // Initialize only once:
+  if (!keysDictType.valDestructor) {
+    keysDictType = dictTypeHeapRedisStrings;
+    keysDictType.valDestructor = keysDictValueFree;
+  }
+  return dictCreate(&keysDictType, NULL);
+}
+
 static const FieldSpec *getFieldCommon(const IndexSpec *spec, const char *name, size_t len,
                                        int useCase) {
   for (size_t i = 0; i < spec->numFields; i++) {
-    if (len != strlen(spec->fields[i].name)) {
+    // Field names are interned: their length rides in the header
+    if (len != StrIntern_Len(spec->fields[i].name)) {
       continue;
     }
     const FieldSpec *fs = spec->fields + i;
@@ -149,6 +178,23 @@ IndexSpec *IndexSpec_CreateNew(RedisModuleCtx *ctx, RedisModuleString **argv, in
     return NULL;
   }
 
+  if (RSGlobalConfig.termsInSpec) {
+    sp->flags |= Index_TermsInSpec;
+    sp->termsDict = IndexSpec_NewKeysDict();
+  }
+
+  if (sp->partitionSpan > 0 && !sp->termsDict) {
+    QueryError_SetError(status, QUERY_EPARSEARGS,
+                        SPEC_PARTITIONSPAN_STR " requires spec-resident term indexes (TERMSINSPEC)");
+    IndexSpec_Free(sp);
+    return NULL;
+  }
+
+  if (RSGlobalConfig.deltaLogDir) {
+    // fresh: a new index must not inherit a dropped namesake's log
+    sp->deltaLog = DeltaLog_Open(RSGlobalConfig.deltaLogDir, sp->name, 1);
+  }
+
   RedisModuleString *keyString = RedisModule_CreateStringPrintf(ctx, INDEX_SPEC_KEY_FMT, sp->name);
   RedisModuleKey *k = RedisModule_OpenKey(ctx, keyString, REDISMODULE_READ | REDISMODULE_WRITE);
 
@@ -170,7 +216,8 @@ IndexSpec *IndexSpec_CreateNew(RedisModuleCtx *ctx, RedisModuleString **argv, in
   // Start the garbage collector
   IndexSpec_StartGC(ctx, sp, GC_DEFAULT_HZ);
 
-  CursorList_AddSpec(&RSCursors, sp->name, RSCURSORS_DEFAULT_CAPACITY);
+  CursorList_AddSpec(&RSCursors, sp->name,
+                     sp->cursorQuota > 0 ? (size_t)sp->cursorQuota : RSCURSORS_DEFAULT_CAPACITY);
 
   // set the value in redis
   RedisModule_ModuleTypeSetValue(k, IndexSpecType, sp);
@@ -225,6 +272,10 @@ static int parseTextField(FieldSpec *sp, ArgsCursor *ac, QueryError *status) {
       FieldSpec_TextNoStem(sp);
       continue;
 
+    } else if (AC_AdvanceIfMatch(ac, SPEC_NOOFFSETS_STR)) {
+      FieldSpec_TextNoOffsets(sp);
+      continue;
+
     } else if (AC_AdvanceIfMatch(ac, SPEC_WEIGHT_STR)) {
       double d;
       if ((rc = AC_GetDouble(ac, &d, 0)) != AC_OK) {
@@ -234,6 +285,22 @@ static int parseTextField(FieldSpec *sp, ArgsCursor *ac, QueryError *status) {
       FieldSpec_TextSetWeight(sp, d);
       continue;
 
+    } else if (AC_AdvanceIfMatch(ac, SPEC_FIELDLANG_STR)) {
+      if (AC_IsAtEnd(ac)) {
+        QueryError_SetError(status, QUERY_EPARSEARGS, SPEC_FIELDLANG_STR " requires an argument");
+        return 0;
+      }
+      size_t langLen;
+      const char *lang = AC_GetStringNC(ac, &langLen);
+      const char *canonical = GetCanonicalLanguage(lang, langLen);
+      if (!canonical) {
+        QueryError_SetErrorFmt(status, QUERY_EINVAL, "Unsupported language `%.*s`", (int)langLen,
+                               lang);
+        return 0;
+      }
+      FieldSpec_TextSetLanguage(sp, canonical);
+      continue;
+
     } else if (AC_AdvanceIfMatch(ac, SPEC_PHONETIC_STR)) {
       if (AC_IsAtEnd(ac)) {
         QueryError_SetError(status, QUERY_EPARSEARGS, SPEC_PHONETIC_STR " requires an argument");
@@ -266,13 +333,14 @@ static int parseTextField(FieldSpec *sp, ArgsCursor *ac, QueryError *status) {
 
 /* Parse a field definition from argv, at *offset. We advance offset as we progress.
  *  Returns 1 on successful parse, 0 otherwise */
-static int parseFieldSpec(const char *name, ArgsCursor *ac, FieldSpec *sp, QueryError *status) {
+static int parseFieldSpec(StrInternTable *names, const char *name, ArgsCursor *ac, FieldSpec *sp,
+                          QueryError *status) {
   if (AC_IsAtEnd(ac)) {
     QueryError_SetErrorFmt(status, QUERY_EPARSEARGS, "Field `%s` does not have a type", name);
     return 0;
   }
 
-  FieldSpec_SetName(sp, name);
+  FieldSpec_SetNameInterned(sp, StrIntern_Get(names, name, strlen(name)));
 
   if (AC_AdvanceIfMatch(ac, SPEC_TEXT_STR)) {
     if (!parseTextField(sp, ac, status)) {
@@ -280,6 +348,11 @@ static int parseFieldSpec(const char *name, ArgsCursor *ac, FieldSpec *sp, Query
     }
   } else if (AC_AdvanceIfMatch(ac, NUMERIC_STR)) {
     FieldSpec_InitializeNumeric(sp);
+    if (AC_AdvanceIfMatch(ac, SPEC_FLOAT32_STR)) {
+      // Index the field's values at float32 precision: always the 4-byte value encoding,
+      // which e.g. halves value bytes for high-precision measurement data
+      sp->options |= FieldSpec_NumericFloat32;
+    }
 
   } else if (AC_AdvanceIfMatch(ac, GEO_STR)) {  // geo field
     FieldSpec_InitializeGeo(sp);
@@ -335,10 +408,15 @@ error:
  */
 static int IndexSpec_AddFieldsInternal(IndexSpec *sp, ArgsCursor *ac, QueryError *status,
                                        int isNew) {
-  if (sp->spcache) {
-    IndexSpecCache_Decref(sp->spcache);
-    sp->spcache = NULL;
-  }
+  // Schema mutation is a structural write: exclude reader slices, then retire
+  // the published snapshot - pinners keep theirs alive until they drop it
+  IndexSpec_LockWrite(sp);
+  IndexSpecCache *retired = __atomic_load_n(&sp->spcache, __ATOMIC_RELAXED);
+  if (retired) {
+    __atomic_store_n(&sp->spcache, NULL, __ATOMIC_RELEASE);
+    IndexSpecCache_Decref(retired);
+  }
+  IndexSpec_UnlockIndex(sp);
   const size_t prevNumFields = sp->numFields;
   const size_t prevSortLen = sp->sortables->len;
   int textId = -1;
@@ -360,7 +438,7 @@ static int IndexSpec_AddFieldsInternal(IndexSpec *sp, ArgsCursor *ac, QueryError
     }
     fs = IndexSpec_CreateField(sp);
 
-    if (!parseFieldSpec(fieldName, ac, fs, status)) {
+    if (!parseFieldSpec(sp->fieldNames, fieldName, ac, fs, status)) {
       goto reset;
     }
 
@@ -396,6 +474,7 @@ static int IndexSpec_AddFieldsInternal(IndexSpec *sp, ArgsCursor *ac, QueryError
     }
     fs = NULL;
   }
+  sp->schemaEpoch++;
   return 1;
 
 reset:
@@ -441,6 +520,8 @@ IndexSpec *IndexSpec_Parse(const char *name, const char **argv, int argc, QueryE
   ArgsCursor acStopwords = {0};
 
   ArgsCursor_InitCString(&ac, argv, argc);
+  long long partitionSpan = 0;
+  long long maxQueries = 0, maxAggMem = 0, maxCursors = 0;
   long long timeout = -1;
   int dummy;
 
@@ -451,9 +532,16 @@ IndexSpec *IndexSpec_Parse(const char *name, const char **argv, int argc, QueryE
       {AC_MKUNFLAG(SPEC_NOFIELDS_STR, &spec->flags, Index_StoreFieldFlags)},
       {AC_MKUNFLAG(SPEC_NOFREQS_STR, &spec->flags, Index_StoreFreqs)},
       {AC_MKBITFLAG(SPEC_SCHEMA_EXPANDABLE_STR, &spec->flags, Index_WideSchema)},
+      {AC_MKBITFLAG(SPEC_PACKEDDOCIDS_STR, &spec->flags, Index_PackedDocIds)},
+      {AC_MKBITFLAG(SPEC_PACKEDOFFSETS_STR, &spec->flags, Index_PackedOffsets)},
+      {AC_MKBITFLAG(SPEC_QUANTFREQS_STR, &spec->flags, Index_QuantizedFreqs)},
       // For compatibility
       {.name = "NOSCOREIDX", .target = &dummy, .type = AC_ARGTYPE_BOOLFLAG},
       {.name = SPEC_TEMPORARY_STR, .target = &timeout, .type = AC_ARGTYPE_LLONG},
+      {.name = SPEC_PARTITIONSPAN_STR, .target = &partitionSpan, .type = AC_ARGTYPE_LLONG},
+      {.name = SPEC_MAXQUERIES_STR, .target = &maxQueries, .type = AC_ARGTYPE_LLONG},
+      {.name = SPEC_MAXAGGMEM_STR, .target = &maxAggMem, .type = AC_ARGTYPE_LLONG},
+      {.name = SPEC_MAXCURSORS_STR, .target = &maxCursors, .type = AC_ARGTYPE_LLONG},
       {.name = SPEC_STOPWORDS_STR, .target = &acStopwords, .type = AC_ARGTYPE_SUBARGS},
       {.name = NULL}};
 
@@ -471,6 +559,40 @@ IndexSpec *IndexSpec_Parse(const char *name, const char **argv, int argc, QueryE
   }
   spec->timeout = timeout;
 
+  if (partitionSpan < 0) {
+    QueryError_SetError(status, QUERY_EPARSEARGS, SPEC_PARTITIONSPAN_STR " must be positive");
+    goto failure;
+  }
+  spec->partitionSpan = partitionSpan;
+  if (maxQueries < 0 || maxAggMem < 0 || maxCursors < 0) {
+    QueryError_SetError(status, QUERY_EPARSEARGS, "Quotas must be non-negative");
+    goto failure;
+  }
+  spec->maxConcurrentQueries = maxQueries;
+  spec->aggMemQuota = maxAggMem;
+  spec->cursorQuota = maxCursors;
+
+  if ((spec->flags & Index_QuantizedFreqs) && !(spec->flags & Index_StoreFreqs)) {
+    QueryError_SetError(status, QUERY_EPARSEARGS,
+                        SPEC_QUANTFREQS_STR " makes no sense together with " SPEC_NOFREQS_STR);
+    goto failure;
+  }
+
+  if ((spec->flags & Index_PackedOffsets) && !(spec->flags & Index_StoreTermOffsets)) {
+    QueryError_SetError(status, QUERY_EPARSEARGS,
+                        SPEC_PACKEDOFFSETS_STR " makes no sense together with " SPEC_NOOFFSETS_STR);
+    goto failure;
+  }
+
+  // Packed docids are a whole-index encoding; they cannot coexist with per-record payloads
+  if ((spec->flags & Index_PackedDocIds) &&
+      (spec->flags & (Index_StoreFreqs | Index_StoreTermOffsets | Index_StoreFieldFlags))) {
+    QueryError_SetError(status, QUERY_EPARSEARGS,
+                        SPEC_PACKEDDOCIDS_STR " requires " SPEC_NOFREQS_STR ", " SPEC_NOOFFSETS_STR
+                                              " and " SPEC_NOFIELDS_STR);
+    goto failure;
+  }
+
   if (AC_IsInitialized(&acStopwords)) {
     spec->stopwords = NewStopWordListCStr((const char **)acStopwords.objs, acStopwords.argc);
     spec->flags |= Index_HasCustomStopwords;
@@ -512,17 +634,68 @@ int IndexSpec_AddTerm(IndexSpec *sp, const char *term, size_t len) {
   if (isNew) {
     sp->stats.numTerms++;
     sp->stats.termsSize += len;
+    sp->termsEpoch++;
+    if (sp->termsBloom) {
+      SBChain_Add(sp->termsBloom, term, len);
+    }
   }
   return isNew;
 }
 
+#define TERMS_BLOOM_INITIAL_CAPACITY 1024
+#define TERMS_BLOOM_ERROR_RATE 0.01
+
+void IndexSpec_InitTermsBloom(IndexSpec *sp) {
+  if (sp->termsBloom || !sp->terms) {
+    return;
+  }
+  sp->termsBloom =
+      SB_NewChain(MAX(sp->stats.numTerms * 2, TERMS_BLOOM_INITIAL_CAPACITY),
+                  TERMS_BLOOM_ERROR_RATE, 0);
+
+  // One walk over the existing dictionary; new terms are added incrementally
+  // by IndexSpec_AddTerm from here on
+  TrieIterator *it = Trie_Iterate(sp->terms, "", 0, 0, 1);
+  rune *rstr = NULL;
+  t_len slen = 0;
+  float score = 0;
+  int dist = 0;
+  while (TrieIterator_Next(it, &rstr, &slen, NULL, &score, &dist)) {
+    size_t len;
+    char *s = runesToStr(rstr, slen, &len);
+    SBChain_Add(sp->termsBloom, s, len);
+    free(s);
+  }
+  DFAFilter_Free(it->ctx);
+  free(it->ctx);
+  TrieIterator_Free(it);
+}
+
+int IndexSpec_TermMaybeExists(const IndexSpec *sp, const char *term, size_t len) {
+  if (!sp->termsBloom) {
+    return 1;
+  }
+  return SBChain_Check(sp->termsBloom, term, len) != 0;
+}
+
 IndexSpecCache *IndexSpec_GetSpecCache(const IndexSpec *spec) {
-  if (!spec->spcache) {
-    ((IndexSpec *)spec)->spcache = IndexSpec_BuildSpecCache(spec);
+  IndexSpecCache *c = __atomic_load_n(&spec->spcache, __ATOMIC_ACQUIRE);
+  if (!c) {
+    // Lazy build: publish by compare-and-swap so two pinners racing the
+    // first build cannot leak the losing snapshot's publication reference
+    IndexSpecCache *fresh = IndexSpec_BuildSpecCache(spec);
+    IndexSpecCache *expected = NULL;
+    if (__atomic_compare_exchange_n(&((IndexSpec *)spec)->spcache, &expected, fresh, 0,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      c = fresh;
+    } else {
+      IndexSpecCache_Decref(fresh);
+      c = expected;
+    }
   }
 
-  spec->spcache->refcount++;
-  return spec->spcache;
+  __atomic_add_fetch(&c->refcount, 1, __ATOMIC_RELAXED);
+  return c;
 }
 
 IndexSpecCache *IndexSpec_BuildSpecCache(const IndexSpec *spec) {
@@ -530,17 +703,24 @@ IndexSpecCache *IndexSpec_BuildSpecCache(const IndexSpec *spec) {
   ret->nfields = spec->numFields;
   ret->fields = malloc(sizeof(*ret->fields) * ret->nfields);
   ret->refcount = 1;
+  ret->flags = spec->flags;
+  ret->stats = spec->stats;
+  ret->byName = FlatDict_New();
   for (size_t ii = 0; ii < spec->numFields; ++ii) {
     ret->fields[ii] = spec->fields[ii];
     ret->fields[ii].name = strdup(ret->fields[ii].name);
+    FlatDict_Set(ret->byName, ret->fields[ii].name, &ret->fields[ii]);
   }
   return ret;
 }
 
 void IndexSpecCache_Decref(IndexSpecCache *c) {
-  if (--c->refcount) {
+  if (__atomic_sub_fetch(&c->refcount, 1, __ATOMIC_ACQ_REL)) {
     return;
   }
+  if (c->byName) {
+    FlatDict_Free(c->byName);
+  }
   for (size_t ii = 0; ii < c->nfields; ++ii) {
     free(c->fields[ii].name);
   }
@@ -618,19 +798,38 @@ void IndexSpec_FreeWithKey(IndexSpec *sp, RedisModuleCtx *ctx) {
   RedisModule_CloseKey(kk);
 }
 static void IndexSpec_FreeInternals(IndexSpec *spec) {
+  // Exclude any reader slice still in flight before tearing structures down
+  IndexSpec_LockWrite(spec);
+  IndexSpec_UnlockIndex(spec);
+  TermCache_OnSpecInvalidated(spec);
   DropDocumentIndexer(spec->name);
   if (spec->gc) {
     GCContext_Stop(spec->gc);
   }
+  if (spec->resultCache) {
+    ResultCache_Free(spec->resultCache);
+    spec->resultCache = NULL;
+  }
 
   if (spec->terms) {
     TrieType_Free(spec->terms);
   }
+  if (spec->termsDict) {
+    dictRelease(spec->termsDict);  // frees the inverted indexes via the value dtor
+  }
+  rm_free(spec->snapshotArena);  // after the indexes: their blocks borrow from it
+  rm_free(spec->snapCache);
+  HotTerms_Free(spec->hotTerms);
+  SlowLog_Free(spec->slowlog);
+  if (spec->deltaLog) {
+    DeltaLog_Decref(spec->deltaLog);
+  }
+  if (spec->termsBloom) {
+    SBChain_Free(spec->termsBloom);
+  }
   DocTable_Free(&spec->docs);
   if (spec->fields != NULL) {
-    for (int i = 0; i < spec->numFields; i++) {
-      rm_free(spec->fields[i].name);
-    }
+    // Field names live in the intern table, freed below
     rm_free(spec->fields);
   }
 
@@ -660,6 +859,10 @@ static void IndexSpec_FreeInternals(IndexSpec *spec) {
     rm_free(spec->indexStrs);
     RedisModule_FreeThreadSafeContext(spec->strCtx);
   }
+  if (spec->fieldNames) {
+    StrIntern_Free(spec->fieldNames);
+  }
+  pthread_rwlock_destroy(&spec->indexLock);
   rm_free(spec);
 }
 
@@ -825,12 +1028,16 @@ IndexSpec *NewIndexSpec(const char *name) {
   sp->stopwords = DefaultStopWordList();
   sp->terms = NewTrie();
   sp->keysDict = NULL;
+  sp->termsDict = NULL;
+  sp->termsBloom = NULL;
   sp->minPrefix = RSGlobalConfig.minTermPrefix;
   sp->maxPrefixExpansions = RSGlobalConfig.maxPrefixExpansions;
   sp->getValue = NULL;
   sp->getValueCtx = NULL;
   sp->textFields = 0;
   memset(&sp->stats, 0, sizeof(sp->stats));
+  sp->fieldNames = StrIntern_New();
+  pthread_rwlock_init(&sp->indexLock, NULL);
   return sp;
 }
 
@@ -867,9 +1074,13 @@ int bit(t_fieldMask id) {
 }
 
 // Backwards compat version of load for rdbs with version < 8
-static void FieldSpec_RdbLoadCompat8(RedisModuleIO *rdb, FieldSpec *f, int encver) {
+static void FieldSpec_RdbLoadCompat8(RedisModuleIO *rdb, IndexSpec *sp, FieldSpec *f, int encver) {
 
-  f->name = RedisModule_LoadStringBuffer(rdb, NULL);
+  {
+    char *loadedName = RedisModule_LoadStringBuffer(rdb, NULL);
+    f->name = (char *)StrIntern_Get(sp->fieldNames, loadedName, strlen(loadedName));
+    RedisModule_Free(loadedName);
+  }
   // the old versions encoded the bit id of the field directly
   // we convert that to a power of 2
   if (encver < INDEX_MIN_WIDESCHEMA_VERSION) {
@@ -880,6 +1091,7 @@ static void FieldSpec_RdbLoadCompat8(RedisModuleIO *rdb, FieldSpec *f, int encve
   }
   f->type = RedisModule_LoadUnsigned(rdb);
   f->textOpts.weight = RedisModule_LoadDouble(rdb);
+  f->textOpts.language = NULL;
   f->tagOpts.flags = TAG_FIELD_DEFAULT_FLAGS;
   f->tagOpts.separator = ',';
   if (encver >= 4) {
@@ -897,20 +1109,27 @@ static void FieldSpec_RdbSave(RedisModuleIO *rdb, FieldSpec *f) {
   if (f->type == FIELD_FULLTEXT) {
     RedisModule_SaveUnsigned(rdb, f->textOpts.id);
     RedisModule_SaveDouble(rdb, f->textOpts.weight);
+    // pinned per-field language; empty string when the field follows the doc
+    const char *lang = f->textOpts.language ? f->textOpts.language : "";
+    RedisModule_SaveStringBuffer(rdb, lang, strlen(lang) + 1);
   } else if (f->type == FIELD_TAG) {
     RedisModule_SaveUnsigned(rdb, f->tagOpts.flags);
     RedisModule_SaveStringBuffer(rdb, &f->tagOpts.separator, 1);
   }
 }
 
-static void FieldSpec_RdbLoad(RedisModuleIO *rdb, FieldSpec *f, int encver) {
+static void FieldSpec_RdbLoad(RedisModuleIO *rdb, IndexSpec *sp, FieldSpec *f, int encver) {
 
   // Fall back to legacy encoding if needed
   if (encver < INDEX_MIN_TAGFIELD_VERSION) {
-    return FieldSpec_RdbLoadCompat8(rdb, f, encver);
+    return FieldSpec_RdbLoadCompat8(rdb, sp, f, encver);
   }
 
-  f->name = RedisModule_LoadStringBuffer(rdb, NULL);
+  {
+    char *loadedName = RedisModule_LoadStringBuffer(rdb, NULL);
+    f->name = (char *)StrIntern_Get(sp->fieldNames, loadedName, strlen(loadedName));
+    RedisModule_Free(loadedName);
+  }
   f->type = RedisModule_LoadUnsigned(rdb);
   f->options = RedisModule_LoadUnsigned(rdb);
   f->sortIdx = RedisModule_LoadSigned(rdb);
@@ -919,6 +1138,15 @@ static void FieldSpec_RdbLoad(RedisModuleIO *rdb, FieldSpec *f, int encver) {
   if (f->type == FIELD_FULLTEXT) {
     f->textOpts.id = RedisModule_LoadUnsigned(rdb);
     f->textOpts.weight = RedisModule_LoadDouble(rdb);
+    f->textOpts.language = NULL;
+    if (encver >= INDEX_MIN_FIELDLANG_VERSION) {
+      size_t langLen;
+      char *lang = RedisModule_LoadStringBuffer(rdb, &langLen);
+      if (langLen > 1) {
+        f->textOpts.language = GetCanonicalLanguage(lang, langLen - 1);
+      }
+      RedisModule_Free(lang);
+    }
   }
   // Load tag specific options
   if (f->type == FIELD_TAG) {
@@ -965,6 +1193,8 @@ void *IndexSpec_RdbLoad(RedisModuleIO *rdb, int encver) {
   }
   RedisModuleCtx *ctx = RedisModule_GetContextFromIO(rdb);
   IndexSpec *sp = rm_calloc(1, sizeof(IndexSpec));
+  pthread_rwlock_init(&sp->indexLock, NULL);
+  sp->fieldNames = StrIntern_New();
   sp->sortables = NewSortingTable();
   sp->terms = NULL;
   sp->docs = DocTable_New(1000);
@@ -982,7 +1212,7 @@ void *IndexSpec_RdbLoad(RedisModuleIO *rdb, int encver) {
   int maxSortIdx = -1;
   for (int i = 0; i < sp->numFields; i++) {
     FieldSpec *fs = sp->fields + i;
-    FieldSpec_RdbLoad(rdb, sp->fields + i, encver);
+    FieldSpec_RdbLoad(rdb, sp, sp->fields + i, encver);
     sp->fields[i].index = i;
     if (FieldSpec_IsSortable(fs)) {
       assert(fs->sortIdx < RS_SORTABLES_MAX);
@@ -995,8 +1225,23 @@ void *IndexSpec_RdbLoad(RedisModuleIO *rdb, int encver) {
   IndexStats_RdbLoad(rdb, &sp->stats);
 
   DocTable_RdbLoad(&sp->docs, rdb, encver);
-  /* For version 3 or up - load the generic trie */
-  if (encver >= 3) {
+  {
+    // Rebuild the numeric sortable columns off the loaded vectors
+    DocTable *dt = &sp->docs;
+    DocTable_ForEach(dt, SortingTable_IngestVector(sp->sortables, dmd->id, dmd->sortVector));
+  }
+  /* For version 3 or up - load the generic trie; from the image version one
+   * flat read replaces the per-key rebuild */
+  if (encver >= INDEX_MIN_TRIEIMAGE_VERSION) {
+    size_t trieLen;
+    char *trieBlob = RedisModule_LoadStringBuffer(rdb, &trieLen);
+    sp->terms = TrieType_DeserializeImage(trieBlob, trieLen);
+    RedisModule_Free(trieBlob);
+    if (!sp->terms) {
+      IndexSpec_Free(sp);
+      return NULL;
+    }
+  } else if (encver >= 3) {
     sp->terms = TrieType_GenericLoad(rdb, 0);
   } else {
     sp->terms = NewTrie();
@@ -1011,9 +1256,6 @@ void *IndexSpec_RdbLoad(RedisModuleIO *rdb, int encver) {
   sp->uniqueId = spec_unique_ids++;
 
   IndexSpec_StartGC(ctx, sp, GC_DEFAULT_HZ);
-  RedisModuleString *specKey = RedisModule_CreateStringPrintf(ctx, INDEX_SPEC_KEY_FMT, sp->name);
-  CursorList_AddSpec(&RSCursors, sp->name, RSCURSORS_DEFAULT_CAPACITY);
-  RedisModule_FreeString(ctx, specKey);
 
   sp->smap = NULL;
   if (sp->flags & Index_HasSmap) {
@@ -1027,6 +1269,48 @@ void *IndexSpec_RdbLoad(RedisModuleIO *rdb, int encver) {
   } else {
     sp->timeout = RedisModule_LoadUnsigned(rdb);
   }
+
+  if (encver >= INDEX_MIN_PARTITIONS_VERSION) {
+    sp->partitionSpan = RedisModule_LoadUnsigned(rdb);
+    sp->maxConcurrentQueries = RedisModule_LoadUnsigned(rdb);
+    sp->aggMemQuota = RedisModule_LoadUnsigned(rdb);
+    sp->cursorQuota = RedisModule_LoadUnsigned(rdb);
+  }
+
+  // only after the quota fields are in: the cursor list capacity comes from
+  // the loaded MAXCURSORS, not the calloc'd zero
+  CursorList_AddSpec(&RSCursors, sp->name,
+                     sp->cursorQuota > 0 ? (size_t)sp->cursorQuota : RSCURSORS_DEFAULT_CAPACITY);
+
+  if (RSGlobalConfig.deltaLogDir) {
+    sp->deltaLog = DeltaLog_Open(RSGlobalConfig.deltaLogDir, sp->name, 0);
+  }
+
+  sp->termsDict = NULL;
+  if (encver >= INDEX_MIN_SNAPSHOT_VERSION && (sp->flags & Index_TermsInSpec)) {
+    size_t snapLen;
+    char *snap = RedisModule_LoadStringBuffer(rdb, &snapLen);
+    if (IndexSnapshot_Load(ctx, sp, snap, snapLen) != REDISMODULE_OK) {
+      RedisModule_Free(snap);
+      IndexSpec_Free(sp);
+      return NULL;
+    }
+  } else if (encver >= INDEX_MIN_TERMSDICT_VERSION && (sp->flags & Index_TermsInSpec)) {
+    sp->termsDict = IndexSpec_NewKeysDict();
+    int iiEncver = RedisModule_LoadUnsigned(rdb);
+    uint64_t numIndexes = RedisModule_LoadUnsigned(rdb);
+    while (numIndexes--) {
+      size_t len;
+      char *s = RedisModule_LoadStringBuffer(rdb, &len);
+      RedisModuleString *keyName = RedisModule_CreateString(ctx, s, len);
+      RedisModule_Free(s);
+      KeysDictValue *kdv = calloc(1, sizeof(*kdv));
+      kdv->dtor = InvertedIndex_Free;
+      kdv->p = InvertedIndex_RdbLoad(rdb, iiEncver);
+      dictAdd(sp->termsDict, keyName, kdv);
+      RedisModule_FreeString(ctx, keyName);
+    }
+  }
   return sp;
 }
 
@@ -1045,7 +1329,12 @@ void IndexSpec_RdbSave(RedisModuleIO *rdb, void *value) {
   IndexStats_RdbSave(rdb, &sp->stats);
   DocTable_RdbSave(&sp->docs, rdb);
   // save trie of terms
-  TrieType_GenericSave(rdb, sp->terms, 0);
+  {
+    size_t trieLen = 0;
+    char *trieBlob = TrieType_SerializeImage(sp->terms, &trieLen);
+    RedisModule_SaveStringBuffer(rdb, trieBlob, trieLen);
+    rm_free(trieBlob);
+  }
 
   // If we have custom stopwords, save them
   if (sp->flags & Index_HasCustomStopwords) {
@@ -1056,6 +1345,31 @@ void IndexSpec_RdbSave(RedisModuleIO *rdb, void *value) {
     SynonymMap_RdbSave(rdb, sp->smap);
   }
   RedisModule_SaveUnsigned(rdb, sp->timeout);
+  RedisModule_SaveUnsigned(rdb, sp->partitionSpan);
+  RedisModule_SaveUnsigned(rdb, sp->maxConcurrentQueries);
+  RedisModule_SaveUnsigned(rdb, sp->aggMemQuota);
+  RedisModule_SaveUnsigned(rdb, sp->cursorQuota);
+
+  if (sp->flags & Index_TermsInSpec) {
+    // The spec owns the term indexes - persist them as one versioned snapshot
+    // blob. When the background builder's cached blob is still current (no
+    // term write since it was cut), stream it out directly: the save path
+    // then does no serialization work at all
+    uint64_t epoch = __atomic_load_n(&sp->termWriteEpoch, __ATOMIC_ACQUIRE);
+    if (sp->snapCache && sp->snapCacheEpoch == epoch) {
+      RedisModule_SaveStringBuffer(rdb, sp->snapCache, sp->snapCacheLen);
+    } else {
+      size_t snapLen = 0;
+      char *snap = IndexSnapshot_Save(sp, &snapLen);
+      RedisModule_SaveStringBuffer(rdb, snap, snapLen);
+      // adopt the fresh product as the cache - repeated saves of a quiet
+      // index reuse it (pointless but harmless in a BGSAVE fork child)
+      rm_free(sp->snapCache);
+      sp->snapCache = snap;
+      sp->snapCacheLen = snapLen;
+      sp->snapCacheEpoch = epoch;
+    }
+  }
 }
 
 void IndexSpec_Digest(RedisModuleDigest *digest, void *value) {
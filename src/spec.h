@@ -29,15 +29,24 @@ extern "C" {
 #define SPEC_NOHL_STR "NOHL"
 #define SPEC_SCHEMA_STR "SCHEMA"
 #define SPEC_SCHEMA_EXPANDABLE_STR "MAXTEXTFIELDS"
+#define SPEC_PACKEDDOCIDS_STR "PACKEDDOCIDS"
+#define SPEC_PACKEDOFFSETS_STR "PACKEDOFFSETS"
+#define SPEC_PARTITIONSPAN_STR "PARTITIONSPAN"
+#define SPEC_MAXQUERIES_STR "MAXQUERIES"
+#define SPEC_MAXAGGMEM_STR "MAXAGGMEM"
+#define SPEC_MAXCURSORS_STR "MAXCURSORS"
+#define SPEC_QUANTFREQS_STR "QUANTFREQS"
 #define SPEC_TEMPORARY_STR "TEMPORARY"
 #define SPEC_TEXT_STR "TEXT"
 #define SPEC_WEIGHT_STR "WEIGHT"
 #define SPEC_NOSTEM_STR "NOSTEM"
 #define SPEC_PHONETIC_STR "PHONETIC"
+#define SPEC_FIELDLANG_STR "LANGUAGE"
 #define SPEC_TAG_STR "TAG"
 #define SPEC_SORTABLE_STR "SORTABLE"
 #define SPEC_STOPWORDS_STR "STOPWORDS"
 #define SPEC_NOINDEX_STR "NOINDEX"
+#define SPEC_FLOAT32_STR "FLOAT32"
 #define SPEC_SEPARATOR_STR "SEPARATOR"
 
 static const char *SpecTypeNames[] = {[FIELD_FULLTEXT] = SPEC_TEXT_STR,
@@ -53,6 +62,12 @@ static const char *SpecTypeNames[] = {[FIELD_FULLTEXT] = SPEC_TEXT_STR,
 // The threshold after which we move to a special encoding for wide fields
 #define SPEC_WIDEFIELD_THRESHOLD 32
 
+/* Incremental per-field index statistics (see IndexSpec.fieldIdxStats) */
+typedef struct {
+  size_t invertedBytes;
+  size_t postings;
+} FieldIndexStats;
+
 typedef struct {
   size_t numDocuments;
   size_t numTerms;
@@ -81,6 +96,24 @@ typedef enum {
   Index_Temporary = 0x200,
   Index_DocIdsOnly = 0x00,
 
+  // For docids-only indexes: completed blocks are re-encoded as fixed-width
+  // frame-of-reference packed deltas instead of varints
+  Index_PackedDocIds = 0x800,
+
+  // Term frequencies are quantized to log buckets (<= 6 bits) before encoding, keeping the
+  // freq field single-byte in every codec at an imperceptible BM25 precision cost. Not part
+  // of INDEX_STORAGE_MASK: the wire codecs are unchanged, only the stored values are
+  Index_QuantizedFreqs = 0x1000,
+
+  // Term offset vectors are stored Elias-Fano packed instead of as varint
+  // deltas. Not part of INDEX_STORAGE_MASK: the postings codecs carry the
+  // offsets blob opaquely, only its internal encoding changes
+  Index_PackedOffsets = 0x4000,
+
+  // Term inverted indexes live in the spec's own dictionary instead of
+  // occupying one Redis key per term (see termsDict)
+  Index_TermsInSpec = 0x2000,
+
   // If any of the fields has phonetics. This is just a cache for quick lookup
   Index_HasPhonetic = 0x400
 } IndexFlags;
@@ -97,9 +130,24 @@ typedef uint16_t FieldSpecDedupeArray[SPEC_MAX_FIELDS];
 
 #define INDEX_STORAGE_MASK                                                                  \
   (Index_StoreFreqs | Index_StoreFieldFlags | Index_StoreTermOffsets | Index_StoreNumeric | \
-   Index_WideSchema)
-
-#define INDEX_CURRENT_VERSION 13
+   Index_WideSchema | Index_PackedDocIds)
+
+#define INDEX_CURRENT_VERSION 19
+// Versions from this one up may carry the spec-resident term dictionary
+#define INDEX_MIN_TERMSDICT_VERSION 14
+// Versions from this one up persist the term dictionary as one versioned
+// binary snapshot blob (see index_snapshot.h) instead of per-element IO
+#define INDEX_MIN_SNAPSHOT_VERSION 16
+// Versions from this one up store the terms trie as one flat image
+#define INDEX_MIN_TRIEIMAGE_VERSION 17
+// Versions from this one up persist the docId partition span
+#define INDEX_MIN_PARTITIONS_VERSION 18
+
+// Versions which encode a pinned per-field language for text fields
+#define INDEX_MIN_FIELDLANG_VERSION 19
+// Versions from this one up store byte offsets packed: varint field table,
+// zigzagged delta-of-delta payload
+#define INDEX_MIN_PACKED_BYTEOFFSETS_VERSION 15
 // Those versions contains doc table as array, we modified it to be array of linked lists
 #define INDEX_MIN_COMPACTED_DOCTABLE_VERSION 12
 #define INDEX_MIN_COMPAT_VERSION 2
@@ -131,6 +179,14 @@ typedef struct IndexSpec {
   int numFields;
 
   IndexStats stats;
+
+  // aggregated iterator read-amplification counters (runtime only)
+  IterRAStats iterStats;
+
+  // Per-field posting telemetry, attributed at write time from each entry's
+  // folded field mask (a posting touching several fields counts once per
+  // field). Indexed like the block field-mask unions: field id modulo 64
+  FieldIndexStats fieldIdxStats[64];
   IndexFlags flags;
 
   Trie *terms;
@@ -147,23 +203,152 @@ typedef struct IndexSpec {
 
   uint64_t uniqueId;
 
+  /* Bumped whenever a new term enters the terms trie; lets per-prefix caches
+   * (see the expansion cache in query.c) validate their entries cheaply */
+  uint64_t termsEpoch;
+
+  /* Bumped on every schema change (FT.ALTER SCHEMA ADD). Field bits are baked
+   * into parsed query trees, so the plan cache keys on this to drop plans
+   * whose field resolution a schema change invalidated */
+  uint64_t schemaEpoch;
+
+  /* Bloom prefilter over the terms dictionary, built lazily on first
+   * spellcheck use and maintained by IndexSpec_AddTerm afterwards. A negative
+   * answer proves a term unknown without touching the trie */
+  struct SBChain *termsBloom;
+
   RedisModuleCtx *strCtx;
   RedisModuleString **indexStrs;
   struct IndexSpecCache *spcache;
   long long timeout;
   dict *keysDict;
+
+  /* When Index_TermsInSpec is set: term -> InvertedIndex mapping owned by the
+   * spec, replacing the per-term "ft:{index}/{term}" Redis keys and their
+   * keyspace overhead. Keyed by the same formatted term key strings, so the
+   * lookup paths are shared with keysDict (see redis_index.c) */
+  dict *termsDict;
+
+  /* The snapshot blob the term indexes were loaded from, when this spec came
+   * out of an RDB written at INDEX_MIN_SNAPSHOT_VERSION or later: completed
+   * index blocks borrow their data from it, so it lives as long as the spec
+   * (NULL for specs built incrementally) */
+  char *snapshotArena;
+
+  /* Mutation epoch of the term dictionary: bumped on every term-index write
+   * and GC rewrite. A cached snapshot blob is valid while its epoch matches */
+  uint64_t termWriteEpoch;
+
+  /* Pre-serialized snapshot of the term indexes, built in the background (see
+   * IndexSnapshot_ScheduleRefresh): when fresh, RDB save streams it out with
+   * one call instead of serializing under the GIL */
+  char *snapCache;
+  size_t snapCacheLen;
+  uint64_t snapCacheEpoch;
+
+  /* Query-side hot-term tracker, persisted in the snapshot so hydration after
+   * restart warms the terms queries actually touch (see index_snapshot.c) */
+  struct HotTerms *hotTerms;
+
+  /* DocId sub-partitioning (see redis_index.c): postings of document d live in
+   * partition d / partitionSpan, each partition its own set of term-index
+   * entries keyed with a "#p<N>" suffix. Queries union the partitions, GC
+   * collects them independently, and a whole partition drops without touching
+   * individual postings. 0 = unpartitioned */
+  long long partitionSpan;
+
+  /* Tenant quotas (0 = unlimited): concurrent search/aggregate commands
+   * admitted, and bytes the grouper/sorter accumulation stages may hold.
+   * activeQueries / aggMemUsed are the live counters, maintained atomically
+   * so admission works from any dispatch thread */
+  long long maxConcurrentQueries;
+  long long aggMemQuota;
+  long long cursorQuota;  // per-spec cursor capacity override (0 = default)
+  uint32_t activeQueries;
+  size_t aggMemUsed;
+
+  /* Rolling slow-query log (see slowlog.h); created on first slow command */
+  struct SlowLog *slowlog;
+
+  /* Online-reindex progress (see backfill.h): ids scanned / the scan ceiling
+   * captured at start, documents actually re-added, and whether a task runs */
+  uint64_t backfillTotal;
+  uint64_t backfillScanned;
+  uint64_t backfillReindexed;
+  int backfillActive;
+
+  /* Append-only log of committed document keys (NULL unless DELTALOG_DIR is
+   * configured); lets an interrupted backfill resume from its last durable
+   * position (see delta_log.h) */
+  struct DeltaLog *deltaLog;
   long long minPrefix;
   long long maxPrefixExpansions;  // -1 unlimited
   RSGetValueCallback getValue;
   void *getValueCtx;
   size_t textFields;
+
+  /* Opt-in hot-query result cache (RESULT_CACHE_TTL config); created on the
+   * first cacheable query, NULL until then */
+  struct ResultCache *resultCache;
+
+  /* Interned field names: one stable storage per name with precomputed
+   * length/hash, shared by every FieldSpec (see strintern.h). Names live
+   * until the spec dies; snapshots keep their own copies since pins may
+   * outlive the spec */
+  struct StrInternTable *fieldNames;
+
+  /* Reader-writer lock over the index structures (inverted indexes, trie,
+   * numeric/tag trees). Query execution slices hold it for read; structural
+   * writers - the fork GC's apply phase, index teardown - take it for write.
+   * Every current holder also holds the GIL, so acquisitions never contend
+   * today; the lock names the discipline each future off-GIL read path needs
+   * so iterators stay valid without per-slice key reopens. A holder that
+   * releases the GIL mid-slice must either release this lock first (writers)
+   * or be a reader - a writer parked off-GIL while readers queue behind it
+   * under the GIL would deadlock */
+  pthread_rwlock_t indexLock;
 } IndexSpec;
 
+static inline void IndexSpec_LockRead(IndexSpec *sp) {
+  pthread_rwlock_rdlock(&sp->indexLock);
+}
+
+static inline void IndexSpec_LockWrite(IndexSpec *sp) {
+  pthread_rwlock_wrlock(&sp->indexLock);
+}
+
+static inline void IndexSpec_UnlockIndex(IndexSpec *sp) {
+  pthread_rwlock_unlock(&sp->indexLock);
+}
+
+/* Record a mutation of the term dictionary (writes are GIL-serialized; the
+ * atomic lets background readers sample the epoch without it) */
+static inline void IndexSpec_BumpTermEpoch(IndexSpec *sp) {
+  __atomic_add_fetch(&sp->termWriteEpoch, 1, __ATOMIC_RELEASE);
+}
+
 typedef struct {
   void (*dtor)(void *p);
   void *p;
+  /* Snapshot-lazy term entry: p is a cold record extent into the snapshot
+   * arena, hydrated into a real InvertedIndex on first open (see
+   * IndexSnapshot_HydrateTerm) */
+  uint8_t cold;
 } KeysDictValue;
 
+/* Create a dictionary mapping formatted key strings to KeysDictValue entries,
+ * for keysDict/termsDict */
+dict *IndexSpec_NewKeysDict(void);
+
+/* Build the terms bloom prefilter if it does not exist yet (one walk over the
+ * terms trie); no-op afterwards */
+void IndexSpec_InitTermsBloom(IndexSpec *sp);
+
+/* Can the term possibly exist in the terms dictionary? A zero answer is
+ * definitive; a nonzero one still needs the trie. Always "maybe" before the
+ * bloom filter has been built */
+int IndexSpec_TermMaybeExists(const IndexSpec *sp, const char *term, size_t len);
+
 extern RedisModuleType *IndexSpecType;
 
 /**
@@ -176,10 +361,23 @@ extern RedisModuleType *IndexSpecType;
  *
  * It is freed when its reference count hits 0
  */
+/* An immutable snapshot of the schema, published through an atomic pointer
+ * on the spec and pinned (refcounted) by query threads for their lifetime.
+ * Pinning happens under the GIL or the spec's index read lock; schema
+ * mutations republish under the index write lock, so a pinner can never
+ * observe the swap mid-flight and the retired snapshot lives until its last
+ * pin drops. The refcount is atomic, so the drops themselves need no lock */
 typedef struct IndexSpecCache {
   FieldSpec *fields;
   size_t nfields;
   size_t refcount;
+  // Interned field-name resolution: name -> &fields[i]. A flat SSE-probed
+  // map (see util/flatdict.h): schema lookups are the hottest map reads in
+  // query setup and never iterate during mutation
+  struct FlatDict *byName;
+  // Snapshotted alongside the fields, so readers need not touch the live spec
+  IndexFlags flags;
+  IndexStats stats;
 } IndexSpecCache;
 
 /**
@@ -212,9 +212,27 @@ void SpellCheck_SendReplyOnTerm(RedisModuleCtx *ctx, char *term, size_t len, RS_
 static bool SpellCheck_ReplyTermSuggestions(SpellCheckCtx *scCtx, char *term, size_t len,
                                             t_fieldMask fieldMask) {
 
-  // searching the term on the term trie, if its there we just return false
-  // because there is no need to return suggestions on it.
-  if (SpellCheck_IsTermExistsInTrie(scCtx->sctx->spec->terms, term, len, NULL)) {
+  // Frequent-term short circuit: one lookup of the term's inverted index
+  // replaces the automaton walk for the common correctly-spelled case. Rarer
+  // terms (below the threshold) still go through the full trie probe
+  bool inIndex = false;
+  RedisModuleKey *tk = NULL;
+  InvertedIndex *tidx = Redis_OpenInvertedIndexEx(scCtx->sctx, term, len, 0, &tk);
+  if (tidx && tidx->numDocs >= (size_t)RSGlobalConfig.spellcheckFreqThreshold) {
+    inIndex = true;
+  }
+  if (tk) {
+    RedisModule_CloseKey(tk);
+  }
+
+  // Bloom prefilter: a negative answer proves the term unknown, skipping the
+  // trie probe and going straight to the suggestion machinery
+  if (!inIndex && IndexSpec_TermMaybeExists(scCtx->sctx->spec, term, len)) {
+    inIndex = SpellCheck_IsTermExistsInTrie(scCtx->sctx->spec->terms, term, len, NULL);
+  }
+
+  // the term is in the index - there is no need to return suggestions on it.
+  if (inIndex) {
     if (scCtx->fullScoreInfo) {
       // if a full score info is requested we need to send information that
       // we found the term as is on the index
@@ -306,6 +324,8 @@ void SpellCheck_Reply(SpellCheckCtx *scCtx, QueryAST *q) {
   if (!SpellCheck_CheckTermDictsExistance(scCtx)) {
     return;
   }
+  // Build the bloom prefilter on first use; term probes below consult it
+  IndexSpec_InitTermsBloom(scCtx->sctx->spec);
   size_t results = 0;
 
   QueryNode **nodes = array_new(QueryNode *, NODES_INITIAL_SIZE);
@@ -1,6 +1,7 @@
 #include "stemmer.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <sys/param.h>
 #include <assert.h>
 #include "dep/snowball/include/libstemmer.h"
@@ -11,32 +12,81 @@ const char *__supportedLanguages[] = {"arabic",     "danish",   "dutch",     "en
                                       "tamil",      "turkish",  "chinese",   NULL};
 
 int IsSupportedLanguage(const char *language, size_t len) {
+  return GetCanonicalLanguage(language, len) != NULL;
+}
+
+const char *GetCanonicalLanguage(const char *language, size_t len) {
   for (int i = 0; __supportedLanguages[i] != NULL; i++) {
     if (!strncasecmp(language, __supportedLanguages[i],
                      MAX(len, strlen(__supportedLanguages[i])))) {
-      return 1;
+      return __supportedLanguages[i];
     }
   }
-  return 0;
+  return NULL;
 }
 
+/* Direct-mapped memoization of token -> stem. Corpora re-stem the same small vocabulary
+ * endlessly, and a Snowball call is orders of magnitude more expensive than a hash probe.
+ * An entry with a NULL stem records the (very common) identity result. Entries own their
+ * strings; collisions simply overwrite. Consumers copy the returned stem immediately
+ * (Token_CopyStem), so overwriting a previously returned entry is safe */
+#define STEMMER_CACHE_SIZE 4096
+#define STEMMER_CACHE_MAX_WORD 64
+
+typedef struct {
+  char *word;
+  uint16_t wordLen;
+  char *stem;  // prefixed form, NUL terminated; NULL = identity (no stem emitted)
+  uint16_t stemLen;
+} StemCacheEntry;
+
 struct sbStemmerCtx {
   struct sb_stemmer *sb;
   char *buf;
   size_t cap;
+  StemCacheEntry cache[STEMMER_CACHE_SIZE];
 };
 
+static uint32_t stemCacheHash(const char *word, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    h = (h ^ (uint8_t)word[i]) * 16777619u;
+  }
+  return h & (STEMMER_CACHE_SIZE - 1);
+}
+
 const char *__sbstemmer_Stem(void *ctx, const char *word, size_t len, size_t *outlen) {
   const sb_symbol *b = (const sb_symbol *)word;
   struct sbStemmerCtx *stctx = ctx;
   struct sb_stemmer *sb = stctx->sb;
 
+  StemCacheEntry *ce = NULL;
+  if (len <= STEMMER_CACHE_MAX_WORD) {
+    ce = &stctx->cache[stemCacheHash(word, len)];
+    if (ce->word && ce->wordLen == len && !memcmp(ce->word, word, len)) {
+      if (!ce->stem) {
+        return NULL;  // cached identity
+      }
+      *outlen = ce->stemLen;
+      return ce->stem;
+    }
+  }
+
   const sb_symbol *stemmed = sb_stemmer_stem(sb, b, (int)len);
   if (stemmed) {
     *outlen = sb_stemmer_length(sb);
 
     // if the stem and its origin are the same - don't do anything
     if (*outlen == len && strncasecmp(word, (const char *)stemmed, len) == 0) {
+      if (ce) {
+        // remember the identity result too - it is the most frequent outcome
+        free(ce->word);
+        free(ce->stem);
+        ce->word = strndup(word, len);
+        ce->wordLen = len;
+        ce->stem = NULL;
+        ce->stemLen = 0;
+      }
       return NULL;
     }
     // reserver one character for the '+' prefix
@@ -49,6 +99,14 @@ const char *__sbstemmer_Stem(void *ctx, const char *word, size_t len, size_t *ou
     }
     // the first location is saved for the + prefix
     memcpy(stctx->buf + 1, stemmed, *outlen + 1);
+    if (ce) {
+      free(ce->word);
+      free(ce->stem);
+      ce->word = strndup(word, len);
+      ce->wordLen = len;
+      ce->stem = strndup(stctx->buf, *outlen + 1);
+      ce->stemLen = *outlen;
+    }
     return (const char *)stctx->buf;
   }
   return NULL;
@@ -57,6 +115,10 @@ const char *__sbstemmer_Stem(void *ctx, const char *word, size_t len, size_t *ou
 void __sbstemmer_Free(Stemmer *s) {
   struct sbStemmerCtx *ctx = s->ctx;
   sb_stemmer_delete(ctx->sb);
+  for (size_t i = 0; i < STEMMER_CACHE_SIZE; i++) {
+    free(ctx->cache[i].word);
+    free(ctx->cache[i].stem);
+  }
   free(ctx->buf);
   free(ctx);
   free(s);
@@ -76,7 +138,8 @@ Stemmer *__newSnowballStemmer(const char *language) {
     return NULL;
   }
 
-  struct sbStemmerCtx *ctx = malloc(sizeof(*ctx));
+  // calloc: the memo cache must start with all entries empty
+  struct sbStemmerCtx *ctx = calloc(1, sizeof(*ctx));
   ctx->sb = sb;
   ctx->cap = 24;
   ctx->buf = malloc(ctx->cap);
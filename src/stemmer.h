@@ -27,6 +27,9 @@ Stemmer *NewStemmer(StemmerType type, const char *language);
 
 int ResetStemmer(Stemmer *stemmer, StemmerType type, const char *language);
 
+/* return the static canonical spelling of a supported language, or NULL */
+const char *GetCanonicalLanguage(const char *language, size_t len);
+
 /* check if a language is supported by our stemmers */
 int IsSupportedLanguage(const char *language, size_t len);
 
@@ -1,13 +1,29 @@
 #define __REDISEARCH_STOPORWORDS_C__
 #include "stopwords.h"
-#include "dep/triemap/triemap.h"
 #include "rmalloc.h"
 #include <ctype.h>
+#include <string.h>
+#include <stdlib.h>
 
 #define MAX_STOPWORDLIST_SIZE 1024
 
+/* Stopword lists are immutable once built (FT.CREATE fixes them), and every
+ * token of every document and query probes one. Instead of a generic trie we
+ * keep the lowercased words concatenated in one arena, sorted by (length,
+ * bytes), and Contains runs a binary search over the dense entry array - a
+ * handful of well-predicted comparisons over adjacent cache lines for the
+ * typical tiny lists. A 64-bit mask of present lengths rejects most
+ * real-world tokens before any comparison at all */
+typedef struct {
+  uint32_t off;
+  uint32_t len;
+} StopWordEntry;
+
 typedef struct StopWordList {
-  TrieMap *m;
+  StopWordEntry *entries;  // sorted by (len, bytes)
+  uint32_t nentries;
+  uint64_t lenMask;  // bit min(l, 63) set when some entry has length l
+  char *pool;        // concatenated entry bytes
   size_t refcount;
 } StopWordList;
 
@@ -34,8 +50,64 @@ int StopWordList_Contains(const StopWordList *sl, const char *term, size_t len)
   if (!sl || !term) {
     return 0;
   }
+  if (!(sl->lenMask & (1ULL << (len < 63 ? len : 63)))) {
+    return 0;
+  }
+  uint32_t lo = 0, hi = sl->nentries;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    const StopWordEntry *e = &sl->entries[mid];
+    int c = e->len != len ? (e->len < len ? -1 : 1) : memcmp(sl->pool + e->off, term, len);
+    if (c == 0) {
+      return 1;
+    }
+    if (c < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return 0;
+}
 
-  return TrieMap_Find(sl->m, (char *)term, len) != TRIEMAP_NOTFOUND;
+/* Sort order for construction: by length, then bytes - the same order the
+ * binary search in Contains probes */
+typedef struct {
+  const char *str;
+  uint32_t len;
+} swWord;
+
+static int swWordCmp(const void *a, const void *b) {
+  const swWord *wa = a, *wb = b;
+  if (wa->len != wb->len) {
+    return wa->len < wb->len ? -1 : 1;
+  }
+  return memcmp(wa->str, wb->str, wa->len);
+}
+
+/* Build the list from lowercased words. Duplicates are dropped */
+static StopWordList *swBuild(swWord *words, size_t n) {
+  StopWordList *sl = rm_calloc(1, sizeof(*sl));
+  sl->refcount = 1;
+  qsort(words, n, sizeof(*words), swWordCmp);
+
+  size_t poolLen = 0;
+  for (size_t i = 0; i < n; i++) {
+    poolLen += words[i].len;
+  }
+  sl->pool = rm_malloc(poolLen ? poolLen : 1);
+  sl->entries = rm_malloc((n ? n : 1) * sizeof(*sl->entries));
+  size_t off = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (i && swWordCmp(&words[i - 1], &words[i]) == 0) {
+      continue;  // duplicates are adjacent after the sort
+    }
+    memcpy(sl->pool + off, words[i].str, words[i].len);
+    sl->entries[sl->nentries++] = (StopWordEntry){.off = off, .len = words[i].len};
+    off += words[i].len;
+    sl->lenMask |= 1ULL << (words[i].len < 63 ? words[i].len : 63);
+  }
+  return sl;
 }
 
 /* Create a new stopword list from a list of redis strings */
@@ -56,9 +128,8 @@ StopWordList *NewStopWordListCStr(const char **strs, size_t len) {
   if (len > MAX_STOPWORDLIST_SIZE) {
     len = MAX_STOPWORDLIST_SIZE;
   }
-  StopWordList *sl = rm_malloc(sizeof(*sl));
-  sl->refcount = 1;
-  sl->m = NewTrieMap();
+  swWord *words = rm_malloc((len ? len : 1) * sizeof(*words));
+  size_t n = 0;
 
   for (size_t i = 0; i < len; i++) {
 
@@ -74,10 +145,14 @@ StopWordList *NewStopWordListCStr(const char **strs, size_t len) {
         t[pos] = tolower(t[pos]);
       }
     }
-    // printf("Adding stopword %s\n", t);
-    TrieMap_Add(sl->m, t, tlen, NULL, NULL);
-    free(t);
+    words[n].str = t;
+    words[n++].len = tlen;
+  }
+  StopWordList *sl = swBuild(words, n);
+  for (size_t i = 0; i < n; i++) {
+    free((char *)words[i].str);
   }
+  rm_free(words);
   return sl;
 }
 
@@ -96,7 +171,8 @@ void StopWordList_Unref(StopWordList *sl) {
   }
 
   if (sl) {
-    TrieMap_Free(sl->m, NULL);
+    rm_free(sl->entries);
+    rm_free(sl->pool);
   }
   rm_free(sl);
 }
@@ -104,31 +180,30 @@ void StopWordList_Unref(StopWordList *sl) {
 /* Load a stopword list from RDB */
 StopWordList *StopWordList_RdbLoad(RedisModuleIO *rdb, int encver) {
   uint64_t elements = RedisModule_LoadUnsigned(rdb);
-  StopWordList *sl = rm_malloc(sizeof(*sl));
-  sl->m = NewTrieMap();
-  sl->refcount = 1;
+  swWord *words = rm_malloc((elements ? elements : 1) * sizeof(*words));
+  size_t n = 0;
 
   while (elements--) {
     size_t len;
     char *str = RedisModule_LoadStringBuffer(rdb, &len);
-    TrieMap_Add(sl->m, str, len, NULL, NULL);
+    words[n].str = rm_strndup(str, len);
+    words[n++].len = len;
     RedisModule_Free(str);
   }
 
+  StopWordList *sl = swBuild(words, n);
+  for (size_t i = 0; i < n; i++) {
+    rm_free((char *)words[i].str);
+  }
+  rm_free(words);
   return sl;
 }
 
 /* Save a stopword list to RDB */
 void StopWordList_RdbSave(RedisModuleIO *rdb, StopWordList *sl) {
 
-  RedisModule_SaveUnsigned(rdb, sl->m->cardinality);
-  TrieMapIterator *it = TrieMap_Iterate(sl->m, "", 0);
-  char *str;
-  tm_len_t len;
-  void *ptr;
-
-  while (TrieMapIterator_Next(it, &str, &len, &ptr)) {
-    RedisModule_SaveStringBuffer(rdb, str, len);
+  RedisModule_SaveUnsigned(rdb, sl->nentries);
+  for (uint32_t i = 0; i < sl->nentries; i++) {
+    RedisModule_SaveStringBuffer(rdb, sl->pool + sl->entries[i].off, sl->entries[i].len);
   }
-  TrieMapIterator_Free(it);
 }
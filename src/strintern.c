@@ -0,0 +1,76 @@
+#include "strintern.h"
+#include "util/block_alloc.h"
+#include "util/fnv.h"
+#include "dep/triemap/triemap.h"
+#include "rmalloc.h"
+#include <string.h>
+#include <stddef.h>
+
+/* Entry layout in the arena: header, then the bytes, then a NUL. The public
+ * pointer is &str[0], so holders can use it as a plain C string */
+typedef struct {
+  uint32_t len;
+  uint64_t hash;
+  char str[];
+} InternEntry;
+
+#define ENTRY_OF(p) ((const InternEntry *)((const char *)(p)-offsetof(InternEntry, str)))
+
+struct StrInternTable {
+  TrieMap *byName;
+  BlkAlloc arena;
+  size_t memUsed;
+};
+
+#define STRINTERN_BLOCK 4096
+
+StrInternTable *StrIntern_New(void) {
+  StrInternTable *t = rm_calloc(1, sizeof(*t));
+  t->byName = NewTrieMap();
+  BlkAlloc_Init(&t->arena);
+  return t;
+}
+
+static void internNopFree(void *p) {
+  // values are interior pointers into the arena, freed wholesale below
+  (void)p;
+}
+
+void StrIntern_Free(StrInternTable *t) {
+  if (!t) {
+    return;
+  }
+  TrieMap_Free(t->byName, internNopFree);
+  BlkAlloc_FreeAll(&t->arena, NULL, NULL, 0);
+  rm_free(t);
+}
+
+const char *StrIntern_Get(StrInternTable *t, const char *s, size_t n) {
+  void *found = TrieMap_Find(t->byName, (char *)s, n);
+  if (found != TRIEMAP_NOTFOUND) {
+    return ((InternEntry *)found)->str;
+  }
+  size_t sz = sizeof(InternEntry) + n + 1;
+  // 8-align entries so the header fields sit naturally
+  sz = (sz + 7) & ~(size_t)7;
+  InternEntry *e = BlkAlloc_Alloc(&t->arena, sz, sz > STRINTERN_BLOCK ? sz : STRINTERN_BLOCK);
+  e->len = n;
+  e->hash = fnv_64a_buf((void *)s, n, 0xcbf29ce484222325ULL);
+  memcpy(e->str, s, n);
+  e->str[n] = '\0';
+  TrieMap_Add(t->byName, (char *)s, n, e, NULL);
+  t->memUsed += sz;
+  return e->str;
+}
+
+size_t StrIntern_MemUsage(const StrInternTable *t) {
+  return t ? t->memUsed : 0;
+}
+
+size_t StrIntern_Len(const char *interned) {
+  return ENTRY_OF(interned)->len;
+}
+
+uint64_t StrIntern_Hash(const char *interned) {
+  return ENTRY_OF(interned)->hash;
+}
@@ -0,0 +1,38 @@
+#ifndef STRINTERN_H
+#define STRINTERN_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A scoped string-interning table: each distinct string is stored once, in an
+ * arena owned by the table, and handed out as a stable NUL-terminated pointer
+ * valid for the table's lifetime. The bytes are prefixed by a header carrying
+ * the length and a precomputed hash, so holders of an interned pointer
+ * neither re-measure nor re-hash. Used per index spec for field names, which
+ * repeat across every document and query.
+ */
+typedef struct StrInternTable StrInternTable;
+
+StrInternTable *StrIntern_New(void);
+void StrIntern_Free(StrInternTable *t);
+
+/* Intern `n` bytes of `s`. Returns the canonical pointer - the same one for
+ * every equal string interned into this table */
+const char *StrIntern_Get(StrInternTable *t, const char *s, size_t n);
+
+/* Header access for a pointer returned by StrIntern_Get */
+size_t StrIntern_Len(const char *interned);
+uint64_t StrIntern_Hash(const char *interned);
+
+/* Resident bytes of the table's interned entries */
+size_t StrIntern_MemUsage(const StrInternTable *t);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
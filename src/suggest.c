@@ -151,6 +151,92 @@ int RSSuggestDelCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
   return RedisModule_ReplyWithLongLong(ctx, Trie_Delete(tree, str, len));
 }
 
+/*
+## FT.SUGCOMPACT key
+
+Rebuild a suggestion dictionary from its live entries, reclaiming the
+deleted nodes, dead payloads and one-child chains that SUGDEL/update churn
+leaves behind.
+
+### Parameters:
+
+   - key: the suggestion dictionary key.
+
+### Returns:
+
+Integer reply: the number of bytes reclaimed by the rebuild.
+*/
+int RSSuggestCompactCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+  RedisModule_AutoMemory(ctx); /* Use automatic memory management. */
+
+  if (argc != 2) return RedisModule_WrongArity(ctx);
+  RedisModule_ReplicateVerbatim(ctx);
+  RedisModuleKey *key = RedisModule_OpenKey(ctx, argv[1], REDISMODULE_READ | REDISMODULE_WRITE);
+  int type = RedisModule_KeyType(key);
+  if (type != REDISMODULE_KEYTYPE_EMPTY && RedisModule_ModuleTypeGetType(key) != TrieType) {
+    return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+  }
+
+  Trie *tree = RedisModule_ModuleTypeGetValue(key);
+  if (!tree) {
+    return RedisModule_ReplyWithLongLong(ctx, 0);
+  }
+  return RedisModule_ReplyWithLongLong(ctx, Trie_Compact(tree));
+}
+
+/*
+## FT.SUGSTATS key
+
+Fragmentation statistics for a suggestion dictionary: node counts, depth
+histogram and the bytes a FT.SUGCOMPACT would reclaim.
+
+### Parameters:
+
+   - key: the suggestion dictionary key.
+
+### Returns:
+
+Array reply: name/value pairs of statistics; the depth histogram is a nested
+array of node counts per depth (the last bucket aggregates deeper levels).
+*/
+int RSSuggestStatsCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+  RedisModule_AutoMemory(ctx); /* Use automatic memory management. */
+
+  if (argc != 2) return RedisModule_WrongArity(ctx);
+  RedisModuleKey *key = RedisModule_OpenKey(ctx, argv[1], REDISMODULE_READ);
+  int type = RedisModule_KeyType(key);
+  if (type != REDISMODULE_KEYTYPE_EMPTY && RedisModule_ModuleTypeGetType(key) != TrieType) {
+    return RedisModule_ReplyWithError(ctx, REDISMODULE_ERRORMSG_WRONGTYPE);
+  }
+
+  Trie *tree = RedisModule_ModuleTypeGetValue(key);
+  TrieStats stats;
+  Trie emptyTree = {0};
+  Trie_GatherStats(tree ? tree : &emptyTree, &stats);
+
+  RedisModule_ReplyWithArray(ctx, 16);
+  RedisModule_ReplyWithSimpleString(ctx, "num_entries");
+  RedisModule_ReplyWithLongLong(ctx, tree ? tree->size : 0);
+  RedisModule_ReplyWithSimpleString(ctx, "nodes");
+  RedisModule_ReplyWithLongLong(ctx, stats.nodes);
+  RedisModule_ReplyWithSimpleString(ctx, "deleted_nodes");
+  RedisModule_ReplyWithLongLong(ctx, stats.deletedNodes);
+  RedisModule_ReplyWithSimpleString(ctx, "single_child_nodes");
+  RedisModule_ReplyWithLongLong(ctx, stats.singleChildNodes);
+  RedisModule_ReplyWithSimpleString(ctx, "max_depth");
+  RedisModule_ReplyWithLongLong(ctx, stats.maxDepth);
+  RedisModule_ReplyWithSimpleString(ctx, "memory_bytes");
+  RedisModule_ReplyWithLongLong(ctx, stats.memBytes);
+  RedisModule_ReplyWithSimpleString(ctx, "wasted_bytes");
+  RedisModule_ReplyWithLongLong(ctx, stats.wastedBytes);
+  RedisModule_ReplyWithSimpleString(ctx, "depth_histogram");
+  RedisModule_ReplyWithArray(ctx, TRIE_STATS_DEPTH_BUCKETS);
+  for (int i = 0; i < TRIE_STATS_DEPTH_BUCKETS; ++i) {
+    RedisModule_ReplyWithLongLong(ctx, stats.depthHist[i]);
+  }
+  return REDISMODULE_OK;
+}
+
 /*
 ## FT.SUGGET key prefix [FUZZY] [MAX num] [WITHSCORES] [TRIM] [OPTIMIZE] [WITHPAYLOADS]
 
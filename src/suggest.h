@@ -9,6 +9,8 @@ int RSSuggestAddCommand(RedisModuleCtx *, RedisModuleString **, int);
 int RSSuggestDelCommand(RedisModuleCtx *, RedisModuleString **, int);
 int RSSuggestLenCommand(RedisModuleCtx *, RedisModuleString **, int);
 int RSSuggestGetCommand(RedisModuleCtx *, RedisModuleString **, int);
+int RSSuggestCompactCommand(RedisModuleCtx *, RedisModuleString **, int);
+int RSSuggestStatsCommand(RedisModuleCtx *, RedisModuleString **, int);
 
 #ifdef __cplusplus
 }
@@ -13,12 +13,21 @@ static TermData* TermData_New(char* term) {
   TermData* t_data = rm_malloc(sizeof(TermData));
   t_data->term = term;
   t_data->ids = array_new(uint32_t, INITIAL_CAPACITY);
+  t_data->expansions = NULL;
+  t_data->expLens = NULL;
   return t_data;
 }
 
 static void TermData_Free(TermData* t_data) {
   rm_free(t_data->term);
   array_free(t_data->ids);
+  if (t_data->expansions) {
+    for (uint32_t i = 0; i < array_len(t_data->expansions); ++i) {
+      rm_free(t_data->expansions[i]);
+    }
+    array_free(t_data->expansions);
+    array_free(t_data->expLens);
+  }
   rm_free(t_data);
 }
 
@@ -168,10 +177,25 @@ size_t SynonymMap_IdToStr(uint32_t id, char* buff, size_t len) {
   return bytes_written;
 }
 
+/* Pre-format the term's group ids as query tokens. Only done on read only
+ * copies, whose ids are frozen, so queries take the strings as-is */
+static void TermData_BuildExpansions(TermData* t_data) {
+  t_data->expansions = array_new(char*, array_len(t_data->ids));
+  t_data->expLens = array_new(uint32_t, array_len(t_data->ids));
+  for (uint32_t i = 0; i < array_len(t_data->ids); ++i) {
+    char buff[32];
+    size_t len = SynonymMap_IdToStr(t_data->ids[i], buff, sizeof(buff));
+    t_data->expansions = array_append(t_data->expansions, rm_strdup(buff));
+    t_data->expLens = array_append(t_data->expLens, (uint32_t)len);
+  }
+}
+
 static void SynonymMap_CopyEntry(SynonymMap* smap, uint64_t key, TermData* t_data) {
   int ret;
   khiter_t k = kh_put(SynMapKhid, smap->h_table, key, &ret);
-  kh_value(smap->h_table, k) = TermData_Copy(t_data);
+  TermData* copy = TermData_Copy(t_data);
+  TermData_BuildExpansions(copy);
+  kh_value(smap->h_table, k) = copy;
 }
 
 static SynonymMap* SynonymMap_GenerateReadOnlyCopy(SynonymMap* smap) {
@@ -195,6 +219,16 @@ SynonymMap* SynonymMap_GetReadOnlyCopy(SynonymMap* smap) {
   return smap->read_only_copy;
 }
 
+SynonymMap* SynonymMap_GetReadOnly(SynonymMap* smap) {
+  if (smap->is_read_only) {
+    return smap;
+  }
+  if (!smap->read_only_copy) {
+    smap->read_only_copy = SynonymMap_GenerateReadOnlyCopy(smap);
+  }
+  return smap->read_only_copy;
+}
+
 void SynonymMap_RdbSaveEntry(RedisModuleIO* rdb, uint64_t key, TermData* t_data) {
   RedisModule_SaveUnsigned(rdb, key);
   TermData_RdbSave(rdb, t_data);
@@ -7,14 +7,23 @@
 #include "util/arr.h"
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * Holding a term data
  *  term - the term itself
  *  ids - array of synonyms group ids that the term is belong to
+ *  expansions - the ids pre-formatted as query tokens ("~<id>"). Only built
+ *               for read-only copies, where the ids can no longer change, so
+ *               query expansion does not re-format them per occurrence
  */
 typedef struct {
   char* term;
   uint32_t* ids;
+  char** expansions;
+  uint32_t* expLens;
 } TermData;
 
 static const int SynMapKhid = 90;
@@ -118,6 +127,15 @@ size_t SynonymMap_IdToStr(uint32_t id, char* buff, size_t len);
  */
 SynonymMap* SynonymMap_GetReadOnlyCopy(SynonymMap* smap);
 
+/**
+ * Return a borrowed reference to the smap's read only copy, without taking a
+ * ref count. The pointer stays valid until the next SynonymMap_Update, which
+ * drops the copy - callers must finish with it inside the same GIL slice.
+ * Query expansion uses this to share one copy across all queries instead of
+ * taking a reference per query.
+ */
+SynonymMap* SynonymMap_GetReadOnly(SynonymMap* smap);
+
 /**
  * Macro for using SynonymMap_GetIdsBySynonym with NULL terminated string
  */
@@ -134,4 +152,8 @@ void SynonymMap_RdbSave(RedisModuleIO* rdb, void* value);
  */
 void* SynonymMap_RdbLoad(RedisModuleIO* rdb, int encver);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* SRC_SYNONYM_MAP_H_ */
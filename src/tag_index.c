@@ -60,11 +60,15 @@ static inline char *mySep(char sep, char **s, int trimSpace, size_t *toklen) {
 char *strtolower(char *str);
 
 /* Preprocess a document tag field, returning a vector of all tags split from the content */
-char **TagIndex_Preprocess(const TagFieldOptions *opts, const DocumentField *data) {
+char **TagIndex_Preprocess(const TagFieldOptions *opts, const DocumentField *data, char **buf) {
   size_t sz;
   char *p = (char *)RedisModule_StringPtrLen(data->text, &sz);
+  *buf = NULL;
   if (!p || sz == 0) return NULL;
   char **ret = array_new(char *, 4);
+  // One copy of the field backs every tag: the separator scan NUL-terminates and lowercases
+  // tokens in place, so the returned values are slices of this buffer rather than per-tag
+  // allocations. Documents carrying dozens of repeated tags stop hammering the allocator
   char *pp = p = strndup(p, sz);
   while (p) {
     // get the next token
@@ -77,11 +81,13 @@ char **TagIndex_Preprocess(const TagFieldOptions *opts, const DocumentField *dat
       if (!(opts->flags & TagField_CaseSensitive)) {
         tok = strtolower(tok);
       }
-      tok = strndup(tok, MIN(toklen, MAX_TAG_LEN));
+      if (toklen > MAX_TAG_LEN) {
+        tok[MAX_TAG_LEN] = '\0';
+      }
       ret = array_append(ret, tok);
     }
   }
-  free(pp);
+  *buf = pp;
   return ret;
 }
 
@@ -90,11 +96,14 @@ static inline size_t tagIndex_Put(TagIndex *idx, const char *value, size_t len,
 
   InvertedIndex *iv = TrieMap_Find(idx->values, (char *)value, len);
   if (iv == TRIEMAP_NOTFOUND) {
-    iv = NewInvertedIndex(Index_DocIdsOnly, 1);
+    // Tag postings are docids-only; the packed format re-encodes completed blocks into
+    // fixed-width containers - array containers for dense, status-like values - so hot tag
+    // filters get compact storage and binary-search membership per block
+    iv = NewInvertedIndex(Index_DocIdsOnly | Index_PackedDocIds, 1);
     TrieMap_Add(idx->values, (char *)value, len, iv, NULL);
   }
 
-  IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+  IndexEncoder enc = InvertedIndex_GetEncoder((uint32_t)iv->flags & INDEX_STORAGE_MASK);
   RSIndexResult rec = {.type = RSResultType_Virtual, .docId = docId, .offsetsSz = 0, .freq = 0};
 
   return InvertedIndex_WriteEntryGeneric(iv, enc, docId, &rec);
@@ -6,6 +6,7 @@
 #include "document.h"
 #include "value.h"
 #include "geo_index.h"
+#include "dep/triemap/triemap.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -104,12 +105,14 @@ TagIndex *NewTagIndex();
 
 void TagIndex_Free(void *p);
 
-/* Preprocess a document tag field, returning a vector of all tags split from the content */
-char **TagIndex_Preprocess(const TagFieldOptions *opts, const DocumentField *data);
+/* Preprocess a document tag field, returning a vector of all tags split from the content.
+ * The tags are slices of a single buffer returned through `buf`, which the caller owns and
+ * must free together with the array */
+char **TagIndex_Preprocess(const TagFieldOptions *opts, const DocumentField *data, char **buf);
 
-static inline void TagIndex_FreePreprocessedData(char **s) {
-  array_foreach(s, tmpv, { free(tmpv); });
+static inline void TagIndex_FreePreprocessedData(char **s, char *buf) {
   array_free(s);
+  free(buf);
 }
 
 /* Index a vector of pre-processed tags for a docId */
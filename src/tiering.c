@@ -0,0 +1,94 @@
+#include "tiering.h"
+#include "inverted_index.h"
+#include "config.h"
+#include "rmalloc.h"
+#include "util/dict.h"
+#include "dep/miniz/miniz.h"
+#include <time.h>
+#include <string.h>
+
+// Entries examined per sweep call: bounds the write-lock slice on huge dicts
+#define TIERING_SWEEP_BATCH 1024
+
+// Keep the compressed image only when it actually pays
+#define TIERING_MIN_SAVINGS_NUM 7  // compressed < 7/8 of raw
+#define TIERING_MIN_BLOCK_BYTES 64
+
+extern uint32_t IndexTieringClock_g;  // the readers' touch clock (inverted_index.c)
+
+typedef struct {
+  uint32_t now;
+  uint32_t maxAgeMin;
+  size_t compressed;
+  uint32_t scanned;
+} TieringScan;
+
+/* Compress one block image in place when it is cold and worth it */
+static void tieringVisitBlock(IndexBlock *blk, TieringScan *s) {
+  if (blk->compressed || blk->bufBorrowed || blk->numDocs == 0 ||
+      blk->buf.offset < TIERING_MIN_BLOCK_BYTES) {
+    return;
+  }
+  if (s->now - blk->touchMin < s->maxAgeMin) {
+    return;
+  }
+  mz_ulong bound = mz_compressBound(blk->buf.offset);
+  unsigned char *packed = rm_malloc(bound);
+  mz_ulong packedLen = bound;
+  int rc = mz_compress2(packed, &packedLen, (const unsigned char *)blk->buf.data, blk->buf.offset,
+                        MZ_DEFAULT_LEVEL);
+  if (rc != MZ_OK || packedLen * 8 >= (mz_ulong)blk->buf.offset * TIERING_MIN_SAVINGS_NUM) {
+    rm_free(packed);  // not worth keeping (or incompressible)
+    return;
+  }
+  blk->rawLen = blk->buf.offset;
+  rm_free(blk->buf.data);
+  blk->buf.data = rm_realloc(packed, packedLen);  // shed the bound slack
+  blk->buf.offset = blk->buf.cap = packedLen;
+  blk->compressed = 1;
+  // drop the skip entries too - they'd stay valid after an inflate (identical
+  // raw image), but a cold block should not hold auxiliary memory; they
+  // rebuild lazily on the next seek
+  rm_free(blk->skips);
+  blk->skips = NULL;
+  blk->numSkips = blk->skipsCap = 0;
+  s->compressed++;
+}
+
+static void tieringScanCb(void *privdata, const dictEntry *de) {
+  TieringScan *s = privdata;
+  s->scanned++;
+  const KeysDictValue *kdv = dictGetVal(de);
+  if (kdv->cold) {
+    return;  // snapshot-lazy entries are already at their minimal footprint
+  }
+  InvertedIndex *idx = kdv->p;
+  size_t before = s->compressed;
+  // never the tail block: the writer may be mid-append into it
+  for (uint32_t i = 0; i + 1 < idx->size; i++) {
+    tieringVisitBlock(&idx->blocks[i], s);
+  }
+  if (s->compressed != before) {
+    // buffer images moved: parked readers must reseek on reopen
+    idx->gcMarker++;
+  }
+}
+
+size_t IndexTiering_Sweep(IndexSpec *sp, unsigned long *cursor) {
+  if (RSGlobalConfig.coldBlockMinutes <= 0 || !sp->termsDict) {
+    return 0;
+  }
+  TieringScan s = {
+      .now = (uint32_t)(time(NULL) / 60),
+      .maxAgeMin = (uint32_t)RSGlobalConfig.coldBlockMinutes,
+  };
+  IndexTieringClock_g = s.now;
+
+  // exclusive slice: compression swaps buffers readers may hold pointers into
+  IndexSpec_LockWrite(sp);
+  while (s.scanned < TIERING_SWEEP_BATCH &&
+         (*cursor = dictScan(sp->termsDict, *cursor, tieringScanCb, NULL, &s)) != 0) {
+  }
+  IndexSpec_UnlockIndex(sp);
+  return s.compressed;
+}
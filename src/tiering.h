@@ -0,0 +1,30 @@
+#ifndef TIERING_H
+#define TIERING_H
+
+#include "spec.h"
+#include "redismodule.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Cold-block tiering: index blocks untouched for COLD_BLOCK_MINUTES are
+ * DEFLATE-compressed in place by an incremental sweep on the GC timer thread,
+ * and inflated back transparently when a reader enters them (see
+ * IndexReader_EnterBlock / IndexBlock_EnsureDecompressed). The long tail of
+ * rarely-queried terms shrinks to its compressed footprint while hot blocks
+ * stay raw.
+ */
+
+/* Advance the coarse access clock and sweep up to a bounded batch of the
+ * spec's terms, compressing blocks whose last touch is older than the
+ * configured threshold. `cursor` carries the resumable dictScan position
+ * across calls. Caller holds the GIL; the sweep takes the index write lock
+ * for the slice. Returns the number of blocks compressed */
+size_t IndexTiering_Sweep(IndexSpec *sp, unsigned long *cursor);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
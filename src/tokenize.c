@@ -1,6 +1,7 @@
 #include "forward_index.h"
 #include "stopwords.h"
 #include "tokenize.h"
+#include "cpu_dispatch.h"
 #include "toksep.h"
 #include "rmalloc.h"
 #include <ctype.h>
@@ -9,10 +10,96 @@
 #include <assert.h>
 #include "phonetic_manager.h"
 
+/*******************************************************************************
+ * Vectorized separator scanning.
+ *
+ * The scalar toksep() loop classifies one byte per iteration through
+ * ToksepMap_g, and on long bodies that lookup dominates tokenization. When
+ * SSSE3 is available, Start() instead classifies the whole text in one
+ * streaming pass into a separator bitmap (one bit per byte), 16 bytes per
+ * step: every separator (and NUL, which ends the scan) is an ASCII byte, so
+ * membership decomposes into two 16-entry nibble tables combined with
+ * pshufb - a byte c matches iff loNib[c & 0xF] has bit (c >> 4) set. Bytes
+ * with the high bit set shuffle to zero and never match, which is exactly
+ * right (multi-byte UTF-8 sequences are never separators). Next() then walks
+ * the bitmap with ctz instead of re-classifying bytes.
+ *
+ * The escape rule (a separator preceded by an unescaped backslash is
+ * literal) is applied per candidate at scan time, like the scalar loop does.
+ * In-place normalization only rewrites bytes of already-consumed tokens, so
+ * the bitmap stays valid for everything at or after the scan position.
+ ******************************************************************************/
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define TOKSEP_HAVE_SSSE3_SCAN 1
+#include <tmmintrin.h>
+
+static uint8_t toksepLoNib_g[16];
+static uint8_t toksepHiNib_g[16];
+static int toksep_canUseSSSE3 = 0;
+
+__attribute__((constructor)) static void toksep_initNibbleTables(void) {
+  for (int c = 0; c < 128; c++) {
+    if (c == 0 || istoksep(c)) {
+      toksepLoNib_g[c & 0x0F] |= 1 << (c >> 4);
+    }
+  }
+  for (int h = 0; h < 8; h++) {
+    toksepHiNib_g[h] = 1 << h;
+  }
+}
+
+static void toksep_initDispatch(void) {
+  toksep_canUseSSSE3 = RSCpu_Level() >= RS_CPU_SSSE3;
+}
+
+__attribute__((constructor)) static void toksep_registerDispatch(void) {
+  RSCpu_RegisterDispatch(toksep_initDispatch);
+}
+
+/* Bitmask of the separator-or-NUL bytes among the 16 at `p` */
+__attribute__((target("ssse3"))) static inline uint32_t toksepClassify16(const uint8_t *p) {
+  __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+  __m128i lo = _mm_shuffle_epi8(_mm_load_si128((const __m128i *)toksepLoNib_g), chunk);
+  __m128i hiNib = _mm_and_si128(_mm_srli_epi16(chunk, 4), _mm_set1_epi8(0x0F));
+  __m128i hi = _mm_shuffle_epi8(_mm_load_si128((const __m128i *)toksepHiNib_g), hiNib);
+  __m128i nomatch = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+  return ~(uint32_t)_mm_movemask_epi8(nomatch) & 0xFFFF;
+}
+
+/* Fill `bm` (pre-zeroed) with one bit per separator byte of text[0..len]
+ * inclusive - the NUL terminator at text[len] gets a bit too, so scans always
+ * find a sentinel */
+__attribute__((target("ssse3"))) static void toksepBuildBitmap(const uint8_t *text, size_t len,
+                                                               uint64_t *bm) {
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    uint64_t m = toksepClassify16(text + i);
+    bm[i >> 6] |= m << (i & 63);
+  }
+  for (; i <= len; ++i) {
+    if (!text[i] || ToksepMap_g[text[i]]) {
+      bm[i >> 6] |= 1ULL << (i & 63);
+    }
+  }
+}
+#endif  // TOKSEP_HAVE_SSSE3_SCAN
+
+// Normalization buffer
+#define MAX_NORMALIZE_SIZE 128
+
 typedef struct {
   RSTokenizer base;
   char **pos;
   Stemmer *stemmer;
+  // TOKENIZE_NOMODIFY scratch: tokens are normalized here instead of in
+  // place, so the returned Token stays valid until the next Next() call
+  char normBuf[MAX_NORMALIZE_SIZE];
+#ifdef TOKSEP_HAVE_SSSE3_SCAN
+  uint64_t *sepBitmap;    // one bit per text byte; built in Start(), reused across pool gets
+  size_t sepBitmapCap;    // capacity, in 64-bit words
+  const char *sepBmBase;  // buffer position bit 0 refers to (ctx->text moves as we consume)
+#endif
 } simpleTokenizer;
 
 static void simpleTokenizer_Start(RSTokenizer *base, char *text, size_t len, uint32_t options) {
@@ -22,14 +109,23 @@ static void simpleTokenizer_Start(RSTokenizer *base, char *text, size_t len, uin
   ctx->options = options;
   ctx->len = len;
   self->pos = &ctx->text;
+#ifdef TOKSEP_HAVE_SSSE3_SCAN
+  if (toksep_canUseSSSE3) {
+    size_t nwords = (len + 1 + 63) / 64;
+    if (nwords > self->sepBitmapCap) {
+      self->sepBitmap = realloc(self->sepBitmap, nwords * sizeof(*self->sepBitmap));
+      self->sepBitmapCap = nwords;
+    }
+    memset(self->sepBitmap, 0, nwords * sizeof(*self->sepBitmap));
+    toksepBuildBitmap((const uint8_t *)text, len, self->sepBitmap);
+    self->sepBmBase = text;
+  }
+#endif
 }
 
 // Shortest word which can/should actually be stemmed
 #define MIN_STEM_CANDIDATE_LEN 4
 
-// Normalization buffer
-#define MAX_NORMALIZE_SIZE 128
-
 /**
  * Normalizes text.
  * - s contains the raw token
@@ -69,6 +165,38 @@ static char *DefaultNormalize(char *s, char *dst, size_t *len) {
   return dst;
 }
 
+#ifdef TOKSEP_HAVE_SSSE3_SCAN
+/* Bitmap counterpart of toksep() - same contract, same escape handling */
+static inline char *toksepBitmap(simpleTokenizer *self, char **s, size_t *tokLen) {
+  char *orig = *s;
+  const char *text = self->sepBmBase;
+  const uint64_t *bm = self->sepBitmap;
+  size_t wi = (size_t)(orig - text) >> 6;
+  uint64_t w = bm[wi] & (~0ULL << ((orig - text) & 63));
+
+  for (;;) {
+    while (w) {
+      const char *cand = text + (wi << 6) + __builtin_ctzll(w);
+      if (!*cand) {
+        *s = NULL;
+        *tokLen = cand - orig;
+        return orig;
+      }
+      if (cand == orig || cand[-1] != '\\') {
+        *s = (char *)cand + 1;
+        *tokLen = cand - orig;
+        if (!cand[1]) {
+          *s = NULL;
+        }
+        return orig;
+      }
+      w &= w - 1;  // escaped - skip this candidate
+    }
+    w = bm[++wi];  // the terminator bit guarantees this ends
+  }
+}
+#endif  // TOKSEP_HAVE_SSSE3_SCAN
+
 // tokenize the text in the context
 uint32_t simpleTokenizer_Next(RSTokenizer *base, Token *t) {
   TokenizerCtx *ctx = &base->ctx;
@@ -76,18 +204,26 @@ uint32_t simpleTokenizer_Next(RSTokenizer *base, Token *t) {
   while (*self->pos != NULL) {
     // get the next token
     size_t origLen;
+#ifdef TOKSEP_HAVE_SSSE3_SCAN
+    char *tok = toksep_canUseSSSE3 ? toksepBitmap(self, self->pos, &origLen)
+                                   : toksep(self->pos, &origLen);
+#else
     char *tok = toksep(self->pos, &origLen);
+#endif
 
     // normalize the token
     size_t normLen = origLen;
 
-    char normalized_s[MAX_NORMALIZE_SIZE];
     char *normBuf;
+    uint32_t flags = Token_CopyStem;
     if (ctx->options & TOKENIZE_NOMODIFY) {
-      normBuf = normalized_s;
+      normBuf = self->normBuf;
       if (normLen > MAX_NORMALIZE_SIZE) {
         normLen = MAX_NORMALIZE_SIZE;
       }
+      // the normalized form lives in the scratch buffer above - consumers
+      // that keep it past this call must copy
+      flags |= Token_CopyRaw;
     } else {
       normBuf = tok;
     }
@@ -110,12 +246,12 @@ uint32_t simpleTokenizer_Next(RSTokenizer *base, Token *t) {
                  .pos = ++ctx->lastOffset,
                  .stem = NULL,
                  .phoneticsPrimary = NULL,
-                 .flags = Token_CopyStem};
+                 .flags = flags};
 
     // if we support stemming - try to stem the word
     if (!(ctx->options & TOKENIZE_NOSTEM) && self->stemmer && normLen >= MIN_STEM_CANDIDATE_LEN) {
       size_t sl;
-      const char *stem = self->stemmer->Stem(self->stemmer->ctx, tok, normLen, &sl);
+      const char *stem = self->stemmer->Stem(self->stemmer->ctx, normalized, normLen, &sl);
       if (stem) {
         t->stem = stem;
         t->stemLen = sl;
@@ -135,6 +271,9 @@ uint32_t simpleTokenizer_Next(RSTokenizer *base, Token *t) {
 }
 
 void simpleTokenizer_Free(RSTokenizer *self) {
+#ifdef TOKSEP_HAVE_SSSE3_SCAN
+  free(((simpleTokenizer *)self)->sepBitmap);
+#endif
   free(self);
 }
 
@@ -157,8 +296,14 @@ RSTokenizer *NewSimpleTokenizer(Stemmer *stemmer, StopWordList *stopwords, uint3
   return &t->base;
 }
 
-static mempool_t *tokpoolLatin_g = NULL;
-static mempool_t *tokpoolCn_g = NULL;
+/* Tokenizers are fetched on the thread that builds the document's forward
+ * index and released on whichever thread finishes the context, so a shared
+ * pool would need locking on the ingest hot path. Thread-local pools make
+ * every pool single-owner instead: an instance released on another thread
+ * simply joins that thread's pool. The indexing threads are long-lived, so
+ * pools are never torn down */
+static __thread mempool_t *tokpoolLatin_g = NULL;
+static __thread mempool_t *tokpoolCn_g = NULL;
 
 static void *newLatinTokenizerAlloc() {
   return NewSimpleTokenizer(NULL, NULL, 0);
@@ -182,6 +327,7 @@ RSTokenizer *GetTokenizer(const char *language, Stemmer *stemmer, StopWordList *
 RSTokenizer *GetChineseTokenizer(Stemmer *stemmer, StopWordList *stopwords) {
   if (!tokpoolCn_g) {
     tokpoolCn_g = mempool_new(16, newCnTokenizerAlloc, tokenizerFree);
+    mempool_register(tokpoolCn_g, "tokenizer-cn");
   }
 
   RSTokenizer *t = mempool_get(tokpoolCn_g);
@@ -192,6 +338,7 @@ RSTokenizer *GetChineseTokenizer(Stemmer *stemmer, StopWordList *stopwords) {
 RSTokenizer *GetSimpleTokenizer(Stemmer *stemmer, StopWordList *stopwords) {
   if (!tokpoolLatin_g) {
     tokpoolLatin_g = mempool_new(16, newLatinTokenizerAlloc, tokenizerFree);
+    mempool_register(tokpoolLatin_g, "tokenizer-latin");
   }
   RSTokenizer *t = mempool_get(tokpoolLatin_g);
   t->Reset(t, stemmer, stopwords, 0);
@@ -202,8 +349,18 @@ void Tokenizer_Release(RSTokenizer *t) {
   // In the future it would be nice to have an actual ID field or w/e, but for
   // now we can just compare callback pointers
   if (t->Next == simpleTokenizer_Next) {
+    // the releasing thread may never have created its pool - releases create
+    // it lazily just like gets do, so the instance is kept warm here
+    if (!tokpoolLatin_g) {
+      tokpoolLatin_g = mempool_new(16, newLatinTokenizerAlloc, tokenizerFree);
+      mempool_register(tokpoolLatin_g, "tokenizer-latin");
+    }
     mempool_release(tokpoolLatin_g, t);
   } else {
+    if (!tokpoolCn_g) {
+      tokpoolCn_g = mempool_new(16, newCnTokenizerAlloc, tokenizerFree);
+      mempool_register(tokpoolCn_g, "tokenizer-cn");
+    }
     mempool_release(tokpoolCn_g, t);
   }
 }
\ No newline at end of file
@@ -3,21 +3,37 @@
 #include "dep/friso/friso.h"
 #include "cndict_loader.h"
 #include <assert.h>
+#include <pthread.h>
 
 static friso_config_t config_g;
 static friso_t friso_g;
+static pthread_once_t frisoInit_g = PTHREAD_ONCE_INIT;
+
+/* Each worker thread segments with its own copy of the template config; the
+ * engine and its dictionary stay shared, and are read-only once initialized */
+static __thread friso_config_entry configTls_g;
+static __thread int configTlsReady_g;
+
+/* One record per surviving token of the current field. The word bytes live in
+ * the tokenizer's pool - friso reuses a single token buffer per task, so they
+ * must be copied out when segmenting ahead of consumption */
+typedef struct {
+  uint32_t wordOff;
+  uint32_t rawOff;
+  uint32_t wordLen;
+  uint32_t rawLen;
+} cnBatchToken;
 
 typedef struct {
   RSTokenizer base;
   friso_task_t fTask;
+  cnBatchToken *toks;
+  uint32_t numToks, capToks, curTok;
+  char *pool;
+  size_t poolLen, poolCap;
 } cnTokenizer;
 
-// TODO: This is just a global init
-static void maybeFrisoInit() {
-  if (friso_g) {
-    return;
-  }
-
+static void frisoInitGlobal(void) {
   const char *configfile = RSGlobalConfig.frisoIni;
   friso_g = friso_new();
   config_g = friso_new_config();
@@ -39,21 +55,32 @@ static void maybeFrisoInit() {
   config_g->en_sseg = 0;
 }
 
-static void cnTokenizer_Start(RSTokenizer *base, char *text, size_t len, uint32_t options) {
-  cnTokenizer *self = (cnTokenizer *)base;
-  base->ctx.text = text;
-  base->ctx.len = len;
-  base->ctx.options = options;
-  friso_set_text(self->fTask, text);
+static friso_config_t cnGetThreadConfig(void) {
+  if (!configTlsReady_g) {
+    configTls_g = *config_g;
+    configTlsReady_g = 1;
+  }
+  return &configTls_g;
 }
 
-static uint32_t cnTokenizer_Next(RSTokenizer *base, Token *t) {
+static void cnTokenizer_Start(RSTokenizer *base, char *text, size_t len, uint32_t options) {
   cnTokenizer *self = (cnTokenizer *)base;
   TokenizerCtx *ctx = &base->ctx;
+  ctx->text = text;
+  ctx->len = len;
+  ctx->options = options;
+
+  friso_config_t cfg = cnGetThreadConfig();
+  friso_set_text(self->fTask, text);
+  self->numToks = 0;
+  self->curTok = 0;
+  self->poolLen = 0;
+
+  // Segment the whole field in one go; Next() only pops records
   while (1) {
-    friso_token_t tok = config_g->next_token(friso_g, config_g, self->fTask);
+    friso_token_t tok = cfg->next_token(friso_g, cfg, self->fTask);
     if (tok == NULL) {
-      return 0;
+      break;
     }
 
     // Check if it's a stopword?
@@ -73,39 +100,67 @@ static uint32_t cnTokenizer_Next(RSTokenizer *base, Token *t) {
         break;
     }
 
-    // fprintf(stderr, "Pos: %u. Offset: %u. Len: %u. RLen: %u. Type: %u\n", tok->pos, tok->offset,
-    //         tok->length, tok->rlen, tok->type);
-
-    // We don't care if it's english, chinese, or a mix. They all get treated the same in
-    // the index.
-    *t = (Token){.tok = tok->word,
-                 .tokLen = tok->length,
-                 .raw = ctx->text + tok->offset,
-                 .rawLen = tok->rlen,
-                 .stem = NULL,
-                 .flags = Token_CopyRaw | Token_CopyStem,
-                 .pos = ++ctx->lastOffset};
+    if (self->numToks == self->capToks) {
+      self->capToks = self->capToks ? self->capToks * 2 : 32;
+      self->toks = realloc(self->toks, self->capToks * sizeof(*self->toks));
+    }
+    if (self->poolLen + tok->length > self->poolCap) {
+      self->poolCap = self->poolCap ? self->poolCap * 2 : 256;
+      if (self->poolCap < self->poolLen + tok->length) {
+        self->poolCap = self->poolLen + tok->length;
+      }
+      self->pool = realloc(self->pool, self->poolCap);
+    }
+    memcpy(self->pool + self->poolLen, tok->word, tok->length);
+    self->toks[self->numToks++] = (cnBatchToken){.wordOff = self->poolLen,
+                                                 .rawOff = tok->offset,
+                                                 .wordLen = tok->length,
+                                                 .rawLen = tok->rlen};
+    self->poolLen += tok->length;
+  }
+}
 
-    return t->pos;
+static uint32_t cnTokenizer_Next(RSTokenizer *base, Token *t) {
+  cnTokenizer *self = (cnTokenizer *)base;
+  TokenizerCtx *ctx = &base->ctx;
+  if (self->curTok >= self->numToks) {
+    return 0;
   }
+
+  const cnBatchToken *bt = &self->toks[self->curTok++];
+
+  // We don't care if it's english, chinese, or a mix. They all get treated the same in
+  // the index.
+  *t = (Token){.tok = self->pool + bt->wordOff,
+               .tokLen = bt->wordLen,
+               .raw = ctx->text + bt->rawOff,
+               .rawLen = bt->rawLen,
+               .stem = NULL,
+               .flags = Token_CopyRaw | Token_CopyStem,
+               .pos = ++ctx->lastOffset};
+
+  return t->pos;
 }
 
 static void cnTokenizer_Free(RSTokenizer *base) {
   cnTokenizer *self = (cnTokenizer *)base;
   friso_free_task(self->fTask);
+  free(self->toks);
+  free(self->pool);
   free(self);
 }
 
 static void cnTokenizer_Reset(RSTokenizer *base, Stemmer *stemmer, StopWordList *stopwords,
                               uint32_t opts) {
-  // Nothing to do here
+  base->ctx.stopwords = stopwords;
+  base->ctx.options = opts;
   base->ctx.lastOffset = 0;
 }
 
 RSTokenizer *NewChineseTokenizer(Stemmer *stemmer, StopWordList *stopwords, uint32_t opts) {
   cnTokenizer *tokenizer = calloc(1, sizeof(*tokenizer));
   tokenizer->fTask = friso_new_task();
-  maybeFrisoInit();
+  pthread_once(&frisoInit_g, frisoInitGlobal);
   tokenizer->base.ctx.options = opts;
   tokenizer->base.ctx.stopwords = stopwords;
   tokenizer->base.Start = cnTokenizer_Start;
@@ -113,4 +168,4 @@ RSTokenizer *NewChineseTokenizer(Stemmer *stemmer, StopWordList *stopwords, uint
   tokenizer->base.Free = cnTokenizer_Free;
   tokenizer->base.Reset = cnTokenizer_Reset;
   return &tokenizer->base;
-}
\ No newline at end of file
+}
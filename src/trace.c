@@ -0,0 +1,10 @@
+#include "trace.h"
+#include <stddef.h>
+
+RSTraceCallback rsTraceCb_g = NULL;
+void *rsTracePriv_g = NULL;
+
+void RSTrace_Register(RSTraceCallback cb, void *privdata) {
+  rsTraceCb_g = cb;
+  rsTracePriv_g = privdata;
+}
@@ -0,0 +1,61 @@
+#ifndef RS_TRACE_H_
+#define RS_TRACE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Query lifecycle trace points. Each fires a USDT probe (when built on a
+ * system with <sys/sdt.h>) so individual slow requests can be traced with
+ * bpftrace in production without recompiling, and also invokes the
+ * registered callback, which embedding code and tests can hook without any
+ * tracing tooling. Both carry the query string and a point-specific count.
+ * The overhead when nothing is attached is one predictable branch per point.
+ */
+typedef enum {
+  RSTRACE_PARSE_DONE = 0,   // query AST parsed; arg = 0
+  RSTRACE_ITER_BUILT,       // iterator tree constructed; arg = estimated results
+  RSTRACE_FIRST_RESULT,     // first row produced; arg = 1
+  RSTRACE_NRESULTS,         // every RSTRACE_NRESULTS_INTERVAL rows; arg = rows so far
+  RSTRACE_REPLY_FLUSHED,    // reply chunk written out; arg = rows in the chunk
+  RSTRACE__MAX,
+} RSTracePoint;
+
+#define RSTRACE_NRESULTS_INTERVAL 1000
+
+typedef void (*RSTraceCallback)(RSTracePoint point, const char *query, uint64_t arg,
+                                void *privdata);
+
+void RSTrace_Register(RSTraceCallback cb, void *privdata);
+
+extern RSTraceCallback rsTraceCb_g;
+extern void *rsTracePriv_g;
+
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define RS_DTRACE(name, q, a) DTRACE_PROBE2(redisearch, name, q, a)
+#else
+#define RS_DTRACE(name, q, a) ((void)0)
+#endif
+
+#define RS_TRACE_EMIT(name, point, q, a)                          \
+  do {                                                            \
+    RS_DTRACE(name, q, a);                                        \
+    if (rsTraceCb_g) {                                            \
+      rsTraceCb_g(point, q, (uint64_t)(a), rsTracePriv_g);        \
+    }                                                             \
+  } while (0)
+
+#define RS_TRACE_PARSE_DONE(q) RS_TRACE_EMIT(parse_done, RSTRACE_PARSE_DONE, q, 0)
+#define RS_TRACE_ITER_BUILT(q, est) RS_TRACE_EMIT(iter_built, RSTRACE_ITER_BUILT, q, est)
+#define RS_TRACE_FIRST_RESULT(q) RS_TRACE_EMIT(first_result, RSTRACE_FIRST_RESULT, q, 1)
+#define RS_TRACE_NRESULTS(q, n) RS_TRACE_EMIT(n_results, RSTRACE_NRESULTS, q, n)
+#define RS_TRACE_REPLY_FLUSHED(q, n) RS_TRACE_EMIT(reply_flushed, RSTRACE_REPLY_FLUSHED, q, n)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,299 @@
+#include "compact.h"
+#include <sys/param.h>
+
+/* Counting pass: one recursive walk sizes all arenas exactly, so the build
+ * performs a single allocation per arena and no growth */
+typedef struct {
+  uint32_t nodes;
+  uint32_t runes;
+  uint32_t payloadBytes;
+} buildCounts;
+
+static void countNodes(const TrieNode *cn, buildCounts *c) {
+  TrieNode *n = (TrieNode *)cn;
+  c->nodes++;
+  c->runes += n->len;
+  if (__trieNode_isTerminal(n) && !__trieNode_isDeleted(n) && n->payload) {
+    c->payloadBytes += n->payload->len;
+  }
+  for (t_len i = 0; i < n->numChildren; i++) {
+    countNodes(__trieNode_children(n)[i], c);
+  }
+}
+
+typedef struct {
+  CompactTrie *ct;
+  uint32_t nextNode;
+  uint32_t nextRune;
+  uint32_t nextPayload;
+} buildState;
+
+static int cmpChildRune(const void *a, const void *b) {
+  const TrieNode *na = *(const TrieNode **)a, *nb = *(const TrieNode **)b;
+  // Slot order is by FOLDED first rune - the same form the descent searches
+  // for - so children sharing a folded rune land adjacent. No subtraction:
+  // runes are unsigned and must compare as such
+  rune fa = runeFold(na->str[0]), fb = runeFold(nb->str[0]);
+  if (fa != fb) {
+    return fa < fb ? -1 : 1;
+  }
+  return na->str[0] < nb->str[0] ? -1 : na->str[0] > nb->str[0];
+}
+
+/* Fill slot `slot` from `tn` and lay its children out contiguously, slotted
+ * in folded-first-rune order for binary-search descent. The subtree score
+ * bound is recomputed exactly on the way back up, so the snapshot's pruning
+ * is tight even if the source trie's ratcheted bounds drifted */
+static void fillNode(const TrieNode *tn, uint32_t slot, uint32_t parent, buildState *bs) {
+  CompactTrie *ct = bs->ct;
+  CompactTrieNode *cn = &ct->nodes[slot];
+
+  cn->strOff = bs->nextRune;
+  cn->strLen = tn->len;
+  memcpy(&ct->runes[bs->nextRune], tn->str, sizeof(rune) * tn->len);
+  bs->nextRune += tn->len;
+  ct->firstRune[slot] = tn->len ? runeFold(tn->str[0]) : 0;
+
+  cn->parent = parent;
+  int live = __trieNode_isTerminal(tn) && !__trieNode_isDeleted(tn);
+  cn->flags = live ? TRIENODE_TERMINAL : 0;
+  cn->score = live ? tn->score : 0;
+  cn->payloadOff = 0;
+  cn->payloadLen = 0;
+  if (live && tn->payload) {
+    cn->payloadOff = bs->nextPayload;
+    cn->payloadLen = tn->payload->len;
+    memcpy(&ct->payloads[bs->nextPayload], tn->payload->data, tn->payload->len);
+    bs->nextPayload += tn->payload->len;
+  }
+
+  cn->numChildren = tn->numChildren;
+  cn->childBase = bs->nextNode;
+  bs->nextNode += tn->numChildren;
+  float bound = cn->score;
+  if (tn->numChildren) {
+    TrieNode *tnMut = (TrieNode *)tn;
+    const TrieNode **order = malloc(tn->numChildren * sizeof(*order));
+    memcpy(order, __trieNode_children(tnMut), tn->numChildren * sizeof(*order));
+    qsort(order, tn->numChildren, sizeof(*order), cmpChildRune);
+
+    for (t_len i = 0; i < tn->numChildren; i++) {
+      fillNode(order[i], cn->childBase + i, slot, bs);
+      bound = MAX(bound, ct->nodes[cn->childBase + i].maxChildScore);
+    }
+    free(order);
+  }
+  cn->maxChildScore = bound;
+}
+
+CompactTrie *CompactTrie_Build(const TrieNode *n) {
+  buildCounts counts = {0};
+  countNodes(n, &counts);
+
+  CompactTrie *ct = calloc(1, sizeof(*ct));
+  ct->numNodes = counts.nodes;
+  ct->numRunes = counts.runes;
+  ct->payloadsLen = counts.payloadBytes;
+  ct->nodes = malloc(counts.nodes * sizeof(*ct->nodes));
+  ct->runes = counts.runes ? malloc(counts.runes * sizeof(*ct->runes)) : NULL;
+  ct->firstRune = malloc(counts.nodes * sizeof(*ct->firstRune));
+  ct->payloads = counts.payloadBytes ? malloc(counts.payloadBytes) : NULL;
+
+  buildState bs = {.ct = ct, .nextNode = 1};
+  fillNode(n, 0, 0, &bs);
+  return ct;
+}
+
+void CompactTrie_Free(CompactTrie *ct) {
+  if (!ct) {
+    return;
+  }
+  free(ct->nodes);
+  free(ct->runes);
+  free(ct->firstRune);
+  free(ct->payloads);
+  free(ct);
+}
+
+/* Binary search for the slot range of children whose FOLDED first rune equals
+ * `r`. Children sharing a folded rune (e.g. 'H' and 'h') sit adjacent */
+static void findChildRange(const CompactTrie *ct, const CompactTrieNode *cn, rune r, uint32_t *lo,
+                           uint32_t *hi) {
+  uint32_t b = cn->childBase, e = cn->childBase + cn->numChildren;
+  uint32_t l = b, h = e;
+  while (l < h) {  // lower bound
+    uint32_t mid = l + (h - l) / 2;
+    if (ct->firstRune[mid] < r) {
+      l = mid + 1;
+    } else {
+      h = mid;
+    }
+  }
+  *lo = l;
+  h = e;
+  while (l < h) {  // upper bound
+    uint32_t mid = l + (h - l) / 2;
+    if (ct->firstRune[mid] <= r) {
+      l = mid + 1;
+    } else {
+      h = mid;
+    }
+  }
+  *hi = l;
+}
+
+static void ctiPqPush(CompactTrieIterator *it, uint32_t slot, float bound) {
+  if (it->pqLen == it->pqCap) {
+    it->pqCap = it->pqCap ? it->pqCap * 2 : 16;
+    it->pq = realloc(it->pq, it->pqCap * sizeof(*it->pq));
+  }
+  size_t i = it->pqLen++;
+  while (i > 0) {
+    size_t up = (i - 1) / 2;
+    if (it->pq[up].bound >= bound) {
+      break;
+    }
+    it->pq[i] = it->pq[up];
+    i = up;
+  }
+  it->pq[i].slot = slot;
+  it->pq[i].bound = bound;
+}
+
+static uint32_t ctiPqPop(CompactTrieIterator *it) {
+  uint32_t top = it->pq[0].slot;
+  it->pqLen--;
+  if (it->pqLen) {
+    uint32_t slot = it->pq[it->pqLen].slot;
+    float bound = it->pq[it->pqLen].bound;
+    size_t i = 0;
+    for (;;) {
+      size_t child = 2 * i + 1;
+      if (child >= it->pqLen) {
+        break;
+      }
+      if (child + 1 < it->pqLen && it->pq[child + 1].bound > it->pq[child].bound) {
+        child++;
+      }
+      if (it->pq[child].bound <= bound) {
+        break;
+      }
+      it->pq[i] = it->pq[child];
+      i = child;
+    }
+    it->pq[i].slot = slot;
+    it->pq[i].bound = bound;
+  }
+  return top;
+}
+
+/* Rebuild the full stored string of `slot` by walking the parent chain.
+ * Returns its rune length */
+static t_len ctiReconstruct(const CompactTrie *ct, uint32_t slot, rune *buf) {
+  size_t total = 0;
+  for (uint32_t s = slot; s != 0; s = ct->nodes[s].parent) {
+    total += ct->nodes[s].strLen;
+  }
+  size_t pos = total;
+  for (uint32_t s = slot; s != 0; s = ct->nodes[s].parent) {
+    const CompactTrieNode *cn = &ct->nodes[s];
+    pos -= cn->strLen;
+    memcpy(&buf[pos], &ct->runes[cn->strOff], cn->strLen * sizeof(rune));
+  }
+  return total;
+}
+
+void CompactTrieIterator_Init(const CompactTrie *ct, const rune *prefix, t_len plen,
+                              CompactTrieIterator *it) {
+  it->ct = ct;
+  it->pq = NULL;
+  it->pqLen = it->pqCap = 0;
+  it->minScore = 0;
+
+  /* Descend through the partially-matched region, folding label runes against
+   * the query just like FilterFunc folds for the DFA. Several nodes can match
+   * (children may share a folded rune), so this is a small worklist walk; the
+   * fully-matched subtree roots seed the best-first heap */
+  struct {
+    uint32_t slot;
+    t_len matched;
+  } *work = NULL;
+  size_t nwork = 0, workCap = 0;
+
+#define WORK_PUSH(s, m)                                         \
+  do {                                                          \
+    if (nwork == workCap) {                                     \
+      workCap = workCap ? workCap * 2 : 8;                      \
+      work = realloc(work, workCap * sizeof(*work));            \
+    }                                                           \
+    work[nwork].slot = (s);                                     \
+    work[nwork++].matched = (m);                                \
+  } while (0)
+
+  WORK_PUSH(0, 0);  // the root's label is empty and always "matches"
+  while (nwork) {
+    uint32_t slot = work[--nwork].slot;
+    t_len matched = work[nwork].matched;
+    const CompactTrieNode *cn = &ct->nodes[slot];
+    const rune *label = &ct->runes[cn->strOff];
+
+    t_len lp = 0;
+    while (lp < cn->strLen && matched < plen) {
+      if (runeFold(label[lp]) != prefix[matched]) {
+        goto next_work;  // dead branch
+      }
+      lp++;
+      matched++;
+    }
+    if (matched == plen) {
+      ctiPqPush(it, slot, cn->maxChildScore);
+    } else {
+      uint32_t lo, hi;
+      findChildRange(ct, cn, prefix[matched], &lo, &hi);
+      for (uint32_t c = lo; c < hi; c++) {
+        WORK_PUSH(c, matched);
+      }
+    }
+  next_work:;
+  }
+#undef WORK_PUSH
+  free(work);
+}
+
+int CompactTrieIterator_Next(CompactTrieIterator *it, rune **str, t_len *len, RSPayload *payload,
+                             float *score) {
+  const CompactTrie *ct = it->ct;
+  while (it->pqLen) {
+    // Best-first invariant: if the best remaining bound cannot beat the
+    // caller's k-th score, neither can anything below it - stop cold
+    if (it->pq[0].bound < it->minScore) {
+      return 0;
+    }
+    uint32_t slot = ctiPqPop(it);
+    const CompactTrieNode *cn = &ct->nodes[slot];
+
+    for (uint32_t c = cn->childBase; c < cn->childBase + cn->numChildren; c++) {
+      if (ct->nodes[c].maxChildScore >= it->minScore) {
+        ctiPqPush(it, c, ct->nodes[c].maxChildScore);
+      }
+    }
+
+    if ((cn->flags & TRIENODE_TERMINAL) && cn->strLen > 0) {
+      *str = it->buf;
+      *len = ctiReconstruct(ct, slot, it->buf);
+      *score = cn->score;
+      if (payload) {
+        payload->data = cn->payloadLen ? &ct->payloads[cn->payloadOff] : NULL;
+        payload->len = cn->payloadLen;
+      }
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void CompactTrieIterator_Cleanup(CompactTrieIterator *it) {
+  free(it->pq);
+  it->pq = NULL;
+  it->pqLen = it->pqCap = 0;
+}
@@ -0,0 +1,86 @@
+#ifndef __TRIE_COMPACT_H__
+#define __TRIE_COMPACT_H__
+
+#include "trie.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A packed, pointer-free snapshot of a TrieNode trie, for read-mostly suggest
+ * dictionaries. All nodes live in one arena, a node's children occupy a
+ * contiguous slot range addressed by offset, and the children's first label
+ * runes are mirrored into a per-trie array so descent binary-searches one
+ * cache line instead of chasing a pointer per probe. The snapshot is immutable;
+ * writers keep mutating the TrieNode trie and the snapshot is rebuilt lazily
+ * (see Trie_Search in trie_type.c). */
+
+typedef struct {
+  uint32_t strOff;      // offset of the label in the rune arena
+  uint32_t childBase;   // slot of the first child; children are contiguous
+  uint32_t parent;      // parent slot; emission reconstructs strings upwards
+  uint32_t payloadOff;  // offset into the payload arena (payloadLen == 0: none)
+  uint32_t payloadLen;
+  uint16_t strLen;
+  uint16_t numChildren;
+  uint16_t flags;  // TRIENODE_TERMINAL only; deleted nodes lose the flag
+  float score;
+  // Exact upper bound of any score in this subtree (own score included),
+  // recomputed during the build - the best-first traversal relies on it
+  float maxChildScore;
+} CompactTrieNode;
+
+typedef struct {
+  CompactTrieNode *nodes;  // node 0 is the root
+  uint32_t numNodes;
+  rune *runes;  // concatenated labels, original (unfolded) runes
+  uint32_t numRunes;
+  /* firstRune[slot]: FOLDED first label rune of nodes[slot]. A node's children
+   * being contiguous and slotted in folded-rune order, descent binary-searches
+   * firstRune[childBase .. +numChildren); several children may share a folded
+   * rune, so the search yields a range */
+  rune *firstRune;
+  char *payloads;
+  uint32_t payloadsLen;
+} CompactTrie;
+
+/* Build a packed snapshot of the trie rooted at n. Deleted nodes are carried
+ * as non-terminals, exactly as the TrieIterator treats them */
+CompactTrie *CompactTrie_Build(const TrieNode *n);
+
+void CompactTrie_Free(CompactTrie *ct);
+
+/* Best-first iterator over a prefix subtree: a max-heap of subtrees ordered
+ * by their score upper bound. Entries pop in true best-score order, and once
+ * the bound at the heap's top cannot beat the caller's minScore, iteration
+ * stops - FT.SUGGET touches only the nodes that can still matter */
+typedef struct {
+  const CompactTrie *ct;
+  rune buf[TRIE_MAX_STRING_LEN + 1];  // the emitted string is rebuilt here
+  struct {
+    uint32_t slot;
+    float bound;
+  } *pq;  // binary max-heap by bound
+  size_t pqLen, pqCap;
+  /* Same contract as TrieIterator.minScore: the caller raises it as its
+   * result heap fills up; subtrees bounded below it are never visited */
+  float minScore;
+} CompactTrieIterator;
+
+/* Position the iterator on the subtrees matching `prefix` (folded runes, like
+ * the DFA path; label runes are folded on the fly during comparison) */
+void CompactTrieIterator_Init(const CompactTrie *ct, const rune *prefix, t_len plen,
+                              CompactTrieIterator *it);
+
+/* Yield the next terminal entry under the prefix, best score first. Returns 0
+ * when exhausted or when nothing left can beat minScore. The string points
+ * into the iterator's internal buffer */
+int CompactTrieIterator_Next(CompactTrieIterator *it, rune **str, t_len *len, RSPayload *payload,
+                             float *score);
+
+void CompactTrieIterator_Cleanup(CompactTrieIterator *it);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
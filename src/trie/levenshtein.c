@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <sys/param.h>
 #include <string.h>
+#include <pthread.h>
 #include "levenshtein.h"
 #include "rune_util.h"
 
@@ -184,37 +185,141 @@ void dfa_build(dfaNode *parent, SparseAutomaton *a, Vector *cache) {
   //}
 }
 
-DFAFilter NewDFAFilter(rune *str, size_t len, int maxDist, int prefixMode) {
-  Vector *cache = NewVector(dfaNode *, 8);
+/*******************************************************************************
+ * Compiled-DFA LRU. Search-as-you-type traffic recompiles identical
+ * (term, maxDist) automata constantly, and the compiled graph depends only on
+ * the pattern - so fuzzy compilations (maxDist > 0) are kept in a small LRU
+ * and shared across queries, with no invalidation to speak of. Exact/prefix
+ * automata (maxDist == 0) are trivial chains and arrive as an unbounded
+ * stream of distinct prefixes, so they stay uncached. The list is guarded by
+ * its own mutex; entries are refcounted since a trie iteration can span GIL
+ * yields while another query evicts the entry it still walks.
+ ******************************************************************************/
+
+#define DFA_LRU_SIZE 32
+
+static CompiledDFA *dfaLruHead = NULL;
+static CompiledDFA *dfaLruTail = NULL;
+static size_t dfaLruCount = 0;
+static pthread_mutex_t dfaLruLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void compiledDFA_Free(CompiledDFA *c) {
+  for (int i = 0; i < Vector_Size(c->nodes); i++) {
+    dfaNode *dn;
+    Vector_Get(c->nodes, i, &dn);
+    if (dn) __dfaNode_free(dn);
+  }
+  Vector_Free(c->nodes);
+  free(c->str);
+  free(c);
+}
+
+/* Drop a reference. Called with dfaLruLock held */
+static void compiledDFA_Decref(CompiledDFA *c) {
+  if (--c->refcount == 0) {
+    compiledDFA_Free(c);
+  }
+}
 
-  SparseAutomaton a = NewSparseAutomaton(str, len, maxDist);
+static void dfaLru_Unlink(CompiledDFA *c) {
+  if (c->lruPrev) {
+    c->lruPrev->lruNext = c->lruNext;
+  } else {
+    dfaLruHead = c->lruNext;
+  }
+  if (c->lruNext) {
+    c->lruNext->lruPrev = c->lruPrev;
+  } else {
+    dfaLruTail = c->lruPrev;
+  }
+  c->lruPrev = c->lruNext = NULL;
+  dfaLruCount--;
+}
+
+static void dfaLru_PushFront(CompiledDFA *c) {
+  c->lruPrev = NULL;
+  c->lruNext = dfaLruHead;
+  if (dfaLruHead) {
+    dfaLruHead->lruPrev = c;
+  } else {
+    dfaLruTail = c;
+  }
+  dfaLruHead = c;
+  dfaLruCount++;
+}
 
+/* Compile the DFA graph for (str, len, maxDist). The returned entry owns its
+ * pattern copy and starts with a single reference held by the caller */
+static CompiledDFA *compiledDFA_New(const rune *str, size_t len, int maxDist) {
+  CompiledDFA *c = calloc(1, sizeof(*c));
+  c->str = malloc(len * sizeof(rune));
+  memcpy(c->str, str, len * sizeof(rune));
+  c->len = len;
+  c->maxDist = maxDist;
+  c->nodes = NewVector(dfaNode *, 8);
+  c->refcount = 1;
+
+  SparseAutomaton a = NewSparseAutomaton(c->str, len, maxDist);
   sparseVector *v = SparseAutomaton_Start(&a);
-  dfaNode *dr = __newDfaNode(0, v);
-  __dfn_putCache(cache, dr);
-  dfa_build(dr, &a, cache);
+  c->root = __newDfaNode(0, v);
+  __dfn_putCache(c->nodes, c->root);
+  dfa_build(c->root, &a, c->nodes);
+  return c;
+}
+
+DFAFilter NewDFAFilter(rune *str, size_t len, int maxDist, int prefixMode) {
+  CompiledDFA *c = NULL;
+
+  if (maxDist > 0) {
+    pthread_mutex_lock(&dfaLruLock);
+    for (CompiledDFA *cur = dfaLruHead; cur; cur = cur->lruNext) {
+      if (cur->maxDist == maxDist && cur->len == len &&
+          !memcmp(cur->str, str, len * sizeof(rune))) {
+        c = cur;
+        break;
+      }
+    }
+    if (c) {
+      if (c != dfaLruHead) {
+        dfaLru_Unlink(c);
+        dfaLru_PushFront(c);
+      }
+      c->refcount++;
+    }
+    pthread_mutex_unlock(&dfaLruLock);
+  }
+
+  if (!c) {
+    c = compiledDFA_New(str, len, maxDist);
+    if (maxDist > 0) {
+      pthread_mutex_lock(&dfaLruLock);
+      c->refcount++;  // the LRU's own reference
+      dfaLru_PushFront(c);
+      while (dfaLruCount > DFA_LRU_SIZE) {
+        CompiledDFA *victim = dfaLruTail;
+        dfaLru_Unlink(victim);
+        compiledDFA_Decref(victim);
+      }
+      pthread_mutex_unlock(&dfaLruLock);
+    }
+  }
 
   DFAFilter ret;
-  ret.cache = cache;
+  ret.compiled = c;
   ret.stack = NewVector(dfaNode *, 8);
   ret.distStack = NewVector(int, 8);
-  ret.a = a;
+  ret.a = NewSparseAutomaton(c->str, len, maxDist);
   ret.prefixMode = prefixMode;
-  Vector_Push(ret.stack, dr);
+  Vector_Push(ret.stack, c->root);
   Vector_Push(ret.distStack, (maxDist + 1));
 
   return ret;
 }
 
 void DFAFilter_Free(DFAFilter *fc) {
-  for (int i = 0; i < Vector_Size(fc->cache); i++) {
-    dfaNode *dn;
-    Vector_Get(fc->cache, i, &dn);
-
-    if (dn) __dfaNode_free(dn);
-  }
-
-  Vector_Free(fc->cache);
+  pthread_mutex_lock(&dfaLruLock);
+  compiledDFA_Decref(fc->compiled);
+  pthread_mutex_unlock(&dfaLruLock);
   Vector_Free(fc->stack);
   Vector_Free(fc->distStack);
 }
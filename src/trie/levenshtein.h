@@ -64,10 +64,24 @@ int SparseAutomaton_IsMatch(SparseAutomaton *a, sparseVector *v);
 /* Can the current state lead to a possible match, or is this a dead end? */
 int SparseAutomaton_CanMatch(SparseAutomaton *a, sparseVector *v);
 
+/* A compiled DFA graph for one (pattern, maxDist) pair. The graph depends
+ * only on the pattern, so fuzzy compilations are shared across queries
+ * through a small LRU and never invalidated. Entries are refcounted: a live
+ * filter may outlast the entry's eviction from the LRU */
+typedef struct CompiledDFA {
+    rune *str;  // owned copy of the pattern
+    size_t len;
+    int maxDist;
+    Vector *nodes;  // all dfaNodes of the graph, the root first
+    dfaNode *root;
+    int refcount;  // live filters + 1 while the entry sits in the LRU
+    struct CompiledDFA *lruPrev, *lruNext;
+} CompiledDFA;
+
 /* DFAFilter is a constructed DFA used to filter the traversal on the trie */
 typedef struct {
-    // a cache of the DFA states, allowing us to re-use the same state whenever we need it
-    Vector *cache;
+    // The compiled node graph - possibly shared with other filters via the LRU
+    CompiledDFA *compiled;
     // A stack of the states leading up to the current state
     Vector *stack;
     // A stack of the minimal distance for each state, used for prefix matching
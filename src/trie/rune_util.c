@@ -21,13 +21,63 @@ rune runeFold(rune r) {
   return __fold((uint32_t)r);
 }
 
+/* Is the buffer pure 7-bit ASCII? Such strings decode byte-wise: one rune per
+ * byte, and folding is plain lowercasing. This covers the vast majority of
+ * trie traffic and skips the libnu decode passes entirely */
+static inline int isAscii(const char *s, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if ((unsigned char)s[i] & 0x80) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Locale-independent ASCII lowercasing - the only case folding ASCII needs */
+static inline char asciiFold(char c) {
+  return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
+}
+
+/* Scratch arena for the non-ASCII conversion paths: grown once per thread and
+ * reused on every operation instead of allocating per call. Bounded by
+ * MAX_RUNESTR_LEN so it stays a few KB */
+static __thread uint32_t *runeScratch = NULL;
+static __thread size_t runeScratchCap = 0;
+
+static uint32_t *getRuneScratch(size_t n) {
+  if (runeScratchCap < n) {
+    runeScratch = realloc(runeScratch, n * sizeof(*runeScratch));
+    runeScratchCap = n;
+  }
+  return runeScratch;
+}
+
 char *runesToStr(const rune *in, size_t len, size_t *utflen) {
   if (len > MAX_RUNESTR_LEN) {
     if (utflen) *utflen = 0;
     return NULL;
   }
-  uint32_t unicode[len + 1];
-  for (int i = 0; i < len; i++) {
+
+  int ascii = 1;
+  for (size_t i = 0; i < len; i++) {
+    if (in[i] >= 0x80) {
+      ascii = 0;
+      break;
+    }
+  }
+  if (ascii) {
+    // One byte per rune - write directly, no widening pass
+    char *ret = malloc(len + 1);
+    for (size_t i = 0; i < len; i++) {
+      ret[i] = (char)in[i];
+    }
+    ret[len] = '\0';
+    *utflen = len;
+    return ret;
+  }
+
+  uint32_t *unicode = getRuneScratch(len + 1);
+  for (size_t i = 0; i < len; i++) {
     unicode[i] = (uint32_t)in[i];
   }
   unicode[len] = 0;
@@ -40,8 +90,22 @@ char *runesToStr(const rune *in, size_t len, size_t *utflen) {
 }
 
 /* implementation is identical to that of
- * strToRunes except for line where __fold is called */
+ * strToRunes except for the folding of each rune */
 rune *strToFoldedRunes(const char *str, size_t *len) {
+  size_t slen = strlen(str);
+  if (isAscii(str, slen)) {
+    if (slen > MAX_RUNESTR_LEN) {
+      if (len) *len = 0;
+      return NULL;
+    }
+    rune *ret = malloc((slen + 1) * sizeof(rune));
+    for (size_t i = 0; i < slen; i++) {
+      ret[i] = (rune)(unsigned char)asciiFold(str[i]);
+    }
+    ret[slen] = 0;
+    if (len) *len = slen;
+    return ret;
+  }
 
   ssize_t rlen = nu_strlen(str, nu_utf8_read);
   if (rlen > MAX_RUNESTR_LEN) {
@@ -49,21 +113,29 @@ rune *strToFoldedRunes(const char *str, size_t *len) {
     return NULL;
   }
 
-  uint32_t decoded[rlen + 1];
-  decoded[rlen] = 0;
-  nu_readstr(str, decoded, nu_utf8_read);
-
   rune *ret = calloc(rlen + 1, sizeof(rune));
-  for (int i = 0; i < rlen; i++) {
-    uint32_t runelike = decoded[i];
-    ret[i] = (rune)__fold(runelike);
-  }
+  strToFoldedRunesN(str, slen, ret);
   if (len) *len = rlen;
 
   return ret;
 }
 
 rune *strToRunes(const char *str, size_t *len) {
+  size_t slen = strlen(str);
+  if (isAscii(str, slen)) {
+    if (slen > MAX_RUNESTR_LEN) {
+      if (len) *len = 0;
+      return NULL;
+    }
+    rune *ret = malloc((slen + 1) * sizeof(rune));
+    for (size_t i = 0; i < slen; i++) {
+      ret[i] = (rune)(unsigned char)str[i];
+    }
+    ret[slen] = 0;
+    if (len) *len = slen;
+    return ret;
+  }
+
   // Determine the length
   ssize_t rlen = nu_strlen(str, nu_utf8_read);
   if (rlen > MAX_RUNESTR_LEN) {
@@ -72,7 +144,7 @@ rune *strToRunes(const char *str, size_t *len) {
   }
 
   rune *ret = malloc((rlen + 1) * sizeof(rune));
-  strToRunesN(str, strlen(str), ret);
+  strToRunesN(str, slen, ret);
   ret[rlen] = '\0';
   if (len) {
     *len = rlen;
@@ -81,6 +153,12 @@ rune *strToRunes(const char *str, size_t *len) {
 }
 
 size_t strToRunesN(const char *src, size_t slen, rune *out) {
+  if (isAscii(src, slen)) {
+    for (size_t i = 0; i < slen; i++) {
+      out[i] = (rune)(unsigned char)src[i];
+    }
+    return slen;
+  }
   const char *end = src + slen;
   size_t nout = 0;
   while (src < end) {
@@ -92,4 +170,24 @@ size_t strToRunesN(const char *src, size_t slen, rune *out) {
     out[nout++] = (rune)cp;
   }
   return nout;
+}
+
+size_t strToFoldedRunesN(const char *src, size_t slen, rune *out) {
+  if (isAscii(src, slen)) {
+    for (size_t i = 0; i < slen; i++) {
+      out[i] = (rune)(unsigned char)asciiFold(src[i]);
+    }
+    return slen;
+  }
+  const char *end = src + slen;
+  size_t nout = 0;
+  while (src < end) {
+    uint32_t cp;
+    src = nu_utf8_read(src, &cp);
+    if (cp == 0) {
+      break;
+    }
+    out[nout++] = (rune)__fold(cp);
+  }
+  return nout;
 }
\ No newline at end of file
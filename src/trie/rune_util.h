@@ -29,6 +29,10 @@ rune *strToRunes(const char *str, size_t *len);
 /* Decode a string to a rune in-place */
 size_t strToRunesN(const char *s, size_t slen, rune *outbuf);
 
+/* Decode a string into caller-provided storage, folding each rune. The output
+ * never exceeds one rune per input byte */
+size_t strToFoldedRunesN(const char *s, size_t slen, rune *outbuf);
+
 #ifdef __cplusplus
 }
 #endif
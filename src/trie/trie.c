@@ -26,7 +26,8 @@ TrieNode *__newTrieNode(rune *str, t_len offset, t_len len, const char *payload,
   n->numChildren = numChildren;
   n->score = score;
   n->flags = 0 | (terminal ? TRIENODE_TERMINAL : 0);
-  n->maxChildScore = 0;
+  // The bound includes the node's own score (matching optimizeChildren)
+  n->maxChildScore = terminal ? score : 0;
   n->sortmode = TRIENODE_SORTED_NONE;
   memcpy(n->str, str + offset, sizeof(rune) * (len - offset));
   if (payload != NULL && plen > 0) {
@@ -53,7 +54,7 @@ TrieNode *__trie_SplitNode(TrieNode *n, t_len offset) {
   TrieNode *newChild = __newTrieNode(n->str, offset, n->len, n->payload ? n->payload->data : NULL,
                                      n->payload ? n->payload->len : 0, n->numChildren, n->score,
                                      __trieNode_isTerminal(n));
-  newChild->maxChildScore = n->maxChildScore;
+  newChild->maxChildScore = MAX(newChild->maxChildScore, n->maxChildScore);
   newChild->flags = n->flags;
   TrieNode **children = __trieNode_children(n);
   TrieNode **newChildren = __trieNode_children(newChild);
@@ -94,7 +95,7 @@ TrieNode *__trieNode_MergeWithSingleChild(TrieNode *n) {
   TrieNode *merged = __newTrieNode(
       nstr, 0, n->len + ch->len, ch->payload ? ch->payload->data : NULL,
       ch->payload ? ch->payload->len : 0, ch->numChildren, ch->score, __trieNode_isTerminal(ch));
-  merged->maxChildScore = ch->maxChildScore;
+  merged->maxChildScore = MAX(merged->maxChildScore, ch->maxChildScore);
   merged->numChildren = ch->numChildren;
   merged->flags = ch->flags;
   TrieNode **children = __trieNode_children(ch);
@@ -124,6 +125,18 @@ void TrieNode_Print(TrieNode *n, int idx, int depth) {
   }
 }
 
+/* Recompute a node's score upper bound from its own score and its children's
+ * bounds. Needed on the update path: ADD_REPLACE may LOWER a score, and a
+ * bound that only ever ratchets up stops pruning anything over time */
+static void __trieNode_refreshMaxScore(TrieNode *n) {
+  float m = __trieNode_isTerminal(n) && !__trieNode_isDeleted(n) ? n->score : 0;
+  TrieNode **children = __trieNode_children(n);
+  for (t_len i = 0; i < n->numChildren; i++) {
+    m = MAX(m, children[i]->maxChildScore);
+  }
+  n->maxChildScore = m;
+}
+
 int TrieNode_Add(TrieNode **np, rune *str, t_len len, RSPayload *payload, float score,
                  TrieAddOp op) {
   if (score == 0 || len == 0) {
@@ -162,6 +175,8 @@ int TrieNode_Add(TrieNode **np, rune *str, t_len len, RSPayload *payload, float
       }
 
       __trieNode_children(n)[0] = newChild;
+      // The split node's own (new) score joins its bound
+      n->maxChildScore = MAX(n->maxChildScore, score);
     } else {
       // we add a child
       n = __trie_AddChild(n, str, offset, len, payload, score);
@@ -171,8 +186,6 @@ int TrieNode_Add(TrieNode **np, rune *str, t_len len, RSPayload *payload, float
     return 1;
   }
 
-  n->maxChildScore = MAX(n->maxChildScore, score);
-
   // we're inserting in an existing node - just replace the value
   if (offset == len) {
     int term = __trieNode_isTerminal(n);
@@ -199,6 +212,8 @@ int TrieNode_Add(TrieNode **np, rune *str, t_len len, RSPayload *payload, float
     n->flags |= TRIENODE_TERMINAL;
     // if it was deleted, make sure it's not now
     n->flags &= ~TRIENODE_DELETED;
+    // A replace may have lowered the score - recompute rather than ratchet
+    __trieNode_refreshMaxScore(n);
     *np = n;
     return (term && !deleted) ? 0 : 1;
   }
@@ -209,10 +224,13 @@ int TrieNode_Add(TrieNode **np, rune *str, t_len len, RSPayload *payload, float
     if (str[offset] == child->str[0]) {
       int rc = TrieNode_Add(&child, str + offset, len - offset, payload, score, op);
       __trieNode_children(n)[i] = child;
+      // The subtree's bound may have moved either way - recompute on unwind
+      __trieNode_refreshMaxScore(n);
       return rc;
     }
   }
   *np = __trie_AddChild(n, str, offset, len, payload, score);
+  (*np)->maxChildScore = MAX((*np)->maxChildScore, score);
   return 1;
 }
 
@@ -97,6 +97,9 @@ TrieNode *__trie_AddChild(TrieNode *n, rune *str, t_len offset, t_len len, RSPay
  * a single child holding The old score of n, and its score */
 TrieNode *__trie_SplitNode(TrieNode *n, t_len offset);
 
+/* Sort the children of a node by their maxChildScore (iteration order) */
+void __trieNode_sortChildren(TrieNode *n);
+
 typedef enum {
   ADD_REPLACE,
   ADD_INCR,
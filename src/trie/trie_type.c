@@ -6,6 +6,8 @@
 #include "rune_util.h"
 
 #include "trie_type.h"
+#include "../buffer.h"
+#include "../rmalloc.h"
 #include "../commands.h"
 #include <math.h>
 #include <sys/param.h>
@@ -18,6 +20,8 @@ Trie *NewTrie() {
   rune *rs = strToRunes("", 0);
   tree->root = __newTrieNode(rs, 0, 0, NULL, 0, 0, 0, 0);
   tree->size = 0;
+  tree->compact = NULL;
+  tree->dirty = 0;
   free(rs);
   return tree;
 }
@@ -38,7 +42,7 @@ typedef struct {
   } u;
 } runeBuf;
 
-static inline rune *runeBufFill(const char *s, size_t n, runeBuf *buf, size_t *len) {
+static inline rune *runeBufFill(const char *s, size_t n, runeBuf *buf, size_t *len, int fold) {
   /**
    * Assumption: the number of bytes in a utf8 string is always greater than the
    * number of codepoints it can produce.
@@ -52,7 +56,7 @@ static inline rune *runeBufFill(const char *s, size_t n, runeBuf *buf, size_t *l
     buf->isDynamic = 0;
     target = buf->u.s;
   }
-  *len = strToRunesN(s, n, target);
+  *len = fold ? strToFoldedRunesN(s, n, target) : strToRunesN(s, n, target);
   target[*len] = 0;
   return target;
 }
@@ -69,12 +73,13 @@ int Trie_InsertStringBuffer(Trie *t, const char *s, size_t len, double score, in
     return 0;
   }
   runeBuf buf;
-  rune *runes = runeBufFill(s, len, &buf, &len);
+  rune *runes = runeBufFill(s, len, &buf, &len, 0);
   int rc;
 
   if (runes && len && len < TRIE_MAX_STRING_LEN) {
     rc = TrieNode_Add(&t->root, runes, len, payload, (float)score, incr ? ADD_INCR : ADD_REPLACE);
     t->size += rc;
+    t->dirty++;  // even rc == 0 may have changed a score
   } else {
     rc = 0;
   }
@@ -91,6 +96,7 @@ int Trie_Delete(Trie *t, const char *s, size_t len) {
   }
   int rc = TrieNode_Delete(t->root, runes, len);
   t->size -= rc;
+  t->dirty++;  // the delete pass may restructure nodes even when rc == 0
   free(runes);
   return rc;
 }
@@ -117,16 +123,18 @@ static int cmpEntries(const void *p1, const void *p2, const void *udata) {
 }
 
 TrieIterator *Trie_Iterate(Trie *t, const char *prefix, size_t len, int maxDist, int prefixMode) {
+  runeBuf buf;
   size_t rlen;
-  rune *runes = strToFoldedRunes(prefix, &rlen);
-  if (!runes || rlen > TRIE_MAX_PREFIX) {
+  rune *runes = runeBufFill(prefix, len, &buf, &rlen, 1);
+  if (rlen > TRIE_MAX_PREFIX) {
+    runeBufFree(&buf);
     return NULL;
   }
   DFAFilter *fc = malloc(sizeof(*fc));
   *fc = NewDFAFilter(runes, rlen, maxDist, prefixMode);
 
   TrieIterator *it = TrieNode_Iterate(t->root, FilterFunc, StackPop, fc);
-  free(runes);
+  runeBufFree(&buf);
   return it;
 }
 
@@ -136,21 +144,41 @@ Vector *Trie_Search(Trie *tree, const char *s, size_t len, size_t num, int maxDi
   if (len > TRIE_MAX_PREFIX * sizeof(rune)) {
     return NULL;
   }
+  runeBuf buf;
   size_t rlen;
-  rune *runes = strToFoldedRunes(s, &rlen);
+  rune *runes = runeBufFill(s, len, &buf, &rlen, 1);
   // make sure query length does not overflow
-  if (!runes || rlen >= TRIE_MAX_PREFIX) {
-    free(runes);
+  if (rlen >= TRIE_MAX_PREFIX) {
+    runeBufFree(&buf);
     return NULL;
   }
 
   heap_t *pq = malloc(heap_sizeof(num));
   heap_init(pq, cmpEntries, NULL, num);
 
-  DFAFilter fc = NewDFAFilter(runes, rlen, maxDist, prefixMode);
+  /* Exact-prefix suggestions run over the packed snapshot: no pointer chasing
+   * in descent, binary search on the first-rune array. The snapshot is
+   * rebuilt here, lazily, once reads resume after a burst of writes. Fuzzy
+   * queries keep the DFA walk over the node trie */
+  int useCompact = maxDist == 0 && prefixMode;
+  if (useCompact && (!tree->compact || tree->dirty)) {
+    CompactTrie_Free(tree->compact);
+    tree->compact = CompactTrie_Build(tree->root);
+    tree->dirty = 0;
+  }
 
-  TrieIterator *it = TrieNode_Iterate(tree->root, FilterFunc, StackPop, &fc);
-  // TrieIterator *it = TrieNode_Iterate(tree->root,NULL, NULL, NULL);
+  DFAFilter fc;
+  TrieIterator *it = NULL;
+  CompactTrieIterator cit;
+  float *minScore;
+  if (useCompact) {
+    CompactTrieIterator_Init(tree->compact, runes, rlen, &cit);
+    minScore = &cit.minScore;
+  } else {
+    fc = NewDFAFilter(runes, rlen, maxDist, prefixMode);
+    it = TrieNode_Iterate(tree->root, FilterFunc, StackPop, &fc);
+    minScore = &it->minScore;
+  }
   rune *rstr;
   t_len slen;
   float score;
@@ -158,7 +186,8 @@ Vector *Trie_Search(Trie *tree, const char *s, size_t len, size_t num, int maxDi
 
   TrieSearchResult *pooledEntry = NULL;
   int dist = maxDist + 1;
-  while (TrieIterator_Next(it, &rstr, &slen, &payload, &score, &dist)) {
+  while (useCompact ? CompactTrieIterator_Next(&cit, &rstr, &slen, &payload, &score)
+                    : TrieIterator_Next(it, &rstr, &slen, &payload, &score, &dist)) {
     if (pooledEntry == NULL) {
       pooledEntry = malloc(sizeof(TrieSearchResult));
       pooledEntry->str = NULL;
@@ -187,11 +216,11 @@ Vector *Trie_Search(Trie *tree, const char *s, size_t len, size_t num, int maxDi
 
       if (heap_count(pq) == heap_size(pq)) {
         TrieSearchResult *qe = heap_peek(pq);
-        it->minScore = qe->score;
+        *minScore = qe->score;
       }
 
     } else {
-      if (ent->score >= it->minScore) {
+      if (ent->score >= *minScore) {
         pooledEntry = heap_poll(pq);
         free(pooledEntry->str);
         pooledEntry->str = NULL;
@@ -202,8 +231,8 @@ Vector *Trie_Search(Trie *tree, const char *s, size_t len, size_t num, int maxDi
 
         // get the new minimal score
         TrieSearchResult *qe = heap_peek(pq);
-        if (qe->score > it->minScore) {
-          it->minScore = qe->score;
+        if (qe->score > *minScore) {
+          *minScore = qe->score;
         }
 
       } else {
@@ -254,14 +283,203 @@ Vector *Trie_Search(Trie *tree, const char *s, size_t len, size_t num, int maxDi
     }
   }
 
-  free(runes);
-  TrieIterator_Free(it);
-  DFAFilter_Free(&fc);
+  runeBufFree(&buf);
+  if (useCompact) {
+    CompactTrieIterator_Cleanup(&cit);
+  } else {
+    TrieIterator_Free(it);
+    DFAFilter_Free(&fc);
+  }
   heap_free(pq);
 
   return ret;
 }
 
+/******************************************************************************
+ * Parallel expansion.
+ *
+ * Worst-case fuzzy walks (distance 2+) visit most of a large dictionary under
+ * the query thread. Since the trie is a tree, the root's subtrees are
+ * disjoint: each can be walked by its own task with its own DFA filter (the
+ * compiled graph is shared through the levenshtein LRU), and the per-subtree
+ * candidate lists concatenate back into exactly the serial traversal order.
+ * The submitting thread holds the GIL while it blocks on the join, so no
+ * writer can mutate the trie under the workers; the lazy child sorting each
+ * walk performs stays confined to its own subtree, with the root sorted up
+ * front by the coordinator.
+ ******************************************************************************/
+
+#include "../concurrent_ctx.h"
+#include <pthread.h>
+
+// Below this many terms the fan-out overhead beats the traversal win
+#define TRIE_PARALLEL_MIN_TERMS 5000
+
+// Matches the trie pool size - more tasks would only queue behind each other
+#define CONCURRENT_TRIE_TASKS 4
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  size_t pending;
+} ExpandJoin;
+
+typedef struct {
+  TrieNode **children;
+  size_t nchildren;
+  size_t offset, stride;  // this task walks children[offset], [offset+stride], ...
+  const rune *runes;      // folded pattern, borrowed from the coordinator
+  size_t rlen;
+  int maxDist, prefixMode;
+  size_t maxExpansions;
+  TrieExpansion **results;  // slot per child, so the merge keeps subtree order
+  size_t *counts;
+  ExpandJoin *join;
+} ExpandTask;
+
+static void expandSubtask(void *p) {
+  ExpandTask *t = p;
+  for (size_t i = t->offset; i < t->nchildren; i += t->stride) {
+    DFAFilter fc = NewDFAFilter((rune *)t->runes, t->rlen, t->maxDist, t->prefixMode);
+    TrieIterator *it = TrieNode_Iterate(t->children[i], FilterFunc, StackPop, &fc);
+
+    TrieExpansion *out = NULL;
+    size_t nout = 0, cap = 0;
+    rune *rstr;
+    t_len slen;
+    float score;
+    int dist = t->maxDist + 1;
+    while (TrieIterator_Next(it, &rstr, &slen, NULL, &score, &dist) &&
+           (nout < t->maxExpansions || t->maxExpansions == (size_t)-1)) {
+      if (nout == cap) {
+        cap = cap ? cap * 2 : 8;
+        out = realloc(out, cap * sizeof(*out));
+      }
+      out[nout].str = runesToStr(rstr, slen, &out[nout].len);
+      out[nout].score = score;
+      out[nout].dist = dist;
+      nout++;
+    }
+    TrieIterator_Free(it);
+    DFAFilter_Free(&fc);
+    t->results[i] = out;
+    t->counts[i] = nout;
+  }
+
+  ExpandJoin *j = t->join;
+  pthread_mutex_lock(&j->lock);
+  if (--j->pending == 0) {
+    pthread_cond_signal(&j->cond);
+  }
+  pthread_mutex_unlock(&j->lock);
+}
+
+TrieExpansion *Trie_ExpandParallel(Trie *t, const char *prefix, size_t len, int maxDist,
+                                   int prefixMode, size_t maxExpansions, size_t *nout) {
+  *nout = 0;
+  if (CONCURRENT_POOL_TRIE == -1 || t->size < TRIE_PARALLEL_MIN_TERMS) {
+    return NULL;  // fall back to the serial iterator
+  }
+  size_t nchildren = t->root->numChildren;
+  if (nchildren < 2) {
+    return NULL;
+  }
+
+  runeBuf buf;
+  size_t rlen;
+  rune *runes = runeBufFill(prefix, len, &buf, &rlen, 1);
+  if (rlen > TRIE_MAX_PREFIX) {
+    runeBufFree(&buf);
+    return NULL;
+  }
+
+  // The workers sort lazily inside their own subtrees; the root's child order
+  // must be fixed before partitioning
+  __trieNode_sortChildren(t->root);
+  TrieNode **children = __trieNode_children(t->root);
+
+  TrieExpansion **results = calloc(nchildren, sizeof(*results));
+  size_t *counts = calloc(nchildren, sizeof(*counts));
+
+  size_t ntasks = MIN(nchildren, CONCURRENT_TRIE_TASKS);
+  ExpandJoin join = {.pending = ntasks};
+  pthread_mutex_init(&join.lock, NULL);
+  pthread_cond_init(&join.cond, NULL);
+
+  ExpandTask tasks[CONCURRENT_TRIE_TASKS];
+  for (size_t i = 0; i < ntasks; i++) {
+    tasks[i] = (ExpandTask){
+        .children = children,
+        .nchildren = nchildren,
+        .offset = i,
+        .stride = ntasks,
+        .runes = runes,
+        .rlen = rlen,
+        .maxDist = maxDist,
+        .prefixMode = prefixMode,
+        .maxExpansions = maxExpansions,
+        .results = results,
+        .counts = counts,
+        .join = &join,
+    };
+    ConcurrentSearch_ThreadPoolRun(expandSubtask, &tasks[i], CONCURRENT_POOL_TRIE);
+  }
+
+  pthread_mutex_lock(&join.lock);
+  while (join.pending) {
+    pthread_mutex_unlock(&join.lock);
+    // Lend this thread to the scheduler instead of parking (see the
+    // preprocess join in document.c for the pattern)
+    if (ConcurrentSearch_StealOne()) {
+      pthread_mutex_lock(&join.lock);
+      continue;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += 1000000;  // 1ms backstop against wakeup races
+    if (ts.tv_nsec >= 1000000000) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&join.lock);
+    if (join.pending) {
+      pthread_cond_timedwait(&join.cond, &join.lock, &ts);
+    }
+  }
+  pthread_mutex_unlock(&join.lock);
+  pthread_mutex_destroy(&join.lock);
+  pthread_cond_destroy(&join.cond);
+  runeBufFree(&buf);
+
+  // Merge in subtree order - the exact order the serial walk would produce -
+  // and truncate at the global limit
+  TrieExpansion *merged = NULL;
+  size_t nmerged = 0, cap = 0;
+  for (size_t i = 0; i < nchildren; i++) {
+    for (size_t j = 0; j < counts[i]; j++) {
+      if (nmerged < maxExpansions || maxExpansions == (size_t)-1) {
+        if (nmerged == cap) {
+          cap = cap ? cap * 2 : 16;
+          merged = realloc(merged, cap * sizeof(*merged));
+        }
+        merged[nmerged++] = results[i][j];
+      } else {
+        free(results[i][j].str);
+      }
+    }
+    free(results[i]);
+  }
+  free(results);
+  free(counts);
+
+  *nout = nmerged;
+  if (!merged) {
+    // Ran to completion with zero candidates - still a definitive result
+    merged = malloc(sizeof(*merged));
+  }
+  return merged;
+}
+
 int Trie_RandomKey(Trie *t, char **str, t_len *len, double *score) {
   if (t->size == 0) {
     return 0;
@@ -285,6 +503,81 @@ int Trie_RandomKey(Trie *t, char **str, t_len *len, double *score) {
   return 1;
 }
 
+/******************************************************************************
+ * Compaction and fragmentation stats.
+ *
+ * Delete/update churn leaves marked-deleted nodes, dead payloads and
+ * one-child chains behind - __trieNode_optimizeChildren only merges along the
+ * path it happens to walk. The stats walk quantifies that waste so operators
+ * can schedule FT.SUGCOMPACT, which rebuilds the trie from its live entries:
+ * fresh inserts produce no deleted nodes and no mergeable chains.
+ ******************************************************************************/
+
+static void gatherStats(TrieNode *n, size_t depth, TrieStats *stats) {
+  size_t selfBytes = __trieNode_Sizeof(n->numChildren, n->len);
+  size_t payloadBytes = n->payload ? sizeof(TriePayload) + n->payload->len + 1 : 0;
+  stats->nodes++;
+  stats->memBytes += selfBytes + payloadBytes;
+  if (depth > stats->maxDepth) {
+    stats->maxDepth = depth;
+  }
+  stats->depthHist[MIN(depth, TRIE_STATS_DEPTH_BUCKETS - 1)]++;
+
+  if (__trieNode_isDeleted(n)) {
+    // The node itself may still be needed as a branch point, but its payload
+    // is dead weight; childless deleted nodes go away entirely
+    stats->deletedNodes++;
+    stats->wastedBytes += payloadBytes + (n->numChildren == 0 ? selfBytes : 0);
+  }
+  if (!__trieNode_isTerminal(n) && n->numChildren == 1 && depth > 0) {
+    // A rebuild merges this link into its child: one node header reclaimed
+    stats->singleChildNodes++;
+    stats->wastedBytes += sizeof(TrieNode);
+  }
+
+  for (t_len i = 0; i < n->numChildren; i++) {
+    gatherStats(__trieNode_children(n)[i], depth + 1, stats);
+  }
+}
+
+void Trie_GatherStats(const Trie *t, TrieStats *stats) {
+  memset(stats, 0, sizeof(*stats));
+  if (t->root) {
+    gatherStats(t->root, 0, stats);
+  }
+}
+
+size_t Trie_Compact(Trie *t) {
+  TrieStats before;
+  Trie_GatherStats(t, &before);
+
+  rune *rs = strToRunes("", 0);
+  TrieNode *newRoot = __newTrieNode(rs, 0, 0, NULL, 0, 0, 0, 0);
+  free(rs);
+  size_t size = 0;
+
+  // Replay every live entry into the fresh root; payloads are copied by the
+  // insert, so the old tree stays intact until the swap
+  TrieIterator *it = TrieNode_Iterate(t->root, NULL, NULL, NULL);
+  rune *rstr;
+  t_len slen;
+  float score;
+  RSPayload payload = {.data = NULL, .len = 0};
+  while (TrieIterator_Next(it, &rstr, &slen, &payload, &score, NULL)) {
+    size += TrieNode_Add(&newRoot, rstr, slen, payload.len ? &payload : NULL, score, ADD_REPLACE);
+  }
+  TrieIterator_Free(it);
+
+  TrieNode_Free(t->root);
+  t->root = newRoot;
+  t->size = size;
+  t->dirty++;  // the packed read snapshot must rebuild off the new tree
+
+  TrieStats after;
+  Trie_GatherStats(t, &after);
+  return before.memBytes > after.memBytes ? before.memBytes - after.memBytes : 0;
+}
+
 /***************************************************************
  *
  *                       Trie type methods
@@ -298,8 +591,154 @@ void *TrieType_RdbLoad(RedisModuleIO *rdb, int encver) {
   if (encver > TRIE_ENCVER_CURRENT) {
     return NULL;
   }
+  if (encver >= TRIE_ENCVER_IMAGE) {
+    size_t len;
+    char *blob = RedisModule_LoadStringBuffer(rdb, &len);
+    Trie *t = TrieType_DeserializeImage(blob, len);
+    RedisModule_Free(blob);
+    return t;
+  }
   return TrieType_GenericLoad(rdb, encver > TRIE_ENCVER_NOPAYLOADS);
 }
+/* ---- Flat image serialization ----
+ *
+ * The whole trie as one contiguous buffer: nodes in pre-order, each carrying
+ * its header, payload and rune string, children following recursively. Save is
+ * a single RDB string write; load is a single read plus one allocation per
+ * node - no per-key descent, no rune conversions, no re-sorting (child order
+ * and maxChildScore are preserved byte-exact).
+ *
+ *   header: u8 runeSize | u64 treeSize | u8 hasRoot
+ *   node:   u16 len | u16 numChildren | u8 (flags | sortmode << 2) |
+ *           f32 score | f32 maxChildScore | u32 payloadLen | payload bytes |
+ *           len * runeSize rune bytes | children, pre-order
+ */
+
+typedef struct {
+  const char *cur;
+  const char *end;
+  int err;
+} TrieImageReader;
+
+static int trieImageRead(TrieImageReader *r, void *dst, size_t n) {
+  if (r->err || (size_t)(r->end - r->cur) < n) {
+    r->err = 1;
+    return 0;
+  }
+  memcpy(dst, r->cur, n);
+  r->cur += n;
+  return 1;
+}
+
+static void trieImageWriteNode(BufferWriter *bw, TrieNode *n) {
+  Buffer_Write(bw, &n->len, sizeof(n->len));
+  Buffer_Write(bw, &n->numChildren, sizeof(n->numChildren));
+  uint8_t bits = n->flags | (n->sortmode << 2);
+  Buffer_Write(bw, &bits, sizeof(bits));
+  Buffer_Write(bw, &n->score, sizeof(n->score));
+  Buffer_Write(bw, &n->maxChildScore, sizeof(n->maxChildScore));
+  uint32_t plen = n->payload ? n->payload->len : 0;
+  Buffer_Write(bw, &plen, sizeof(plen));
+  if (plen) {
+    Buffer_Write(bw, n->payload->data, plen);
+  }
+  Buffer_Write(bw, n->str, n->len * sizeof(rune));
+  TrieNode **children = __trieNode_children(n);
+  for (t_len i = 0; i < n->numChildren; i++) {
+    trieImageWriteNode(bw, children[i]);
+  }
+}
+
+char *TrieType_SerializeImage(Trie *t, size_t *outlen) {
+  Buffer b;
+  Buffer_Init(&b, 64 * 1024);
+  BufferWriter bw = NewBufferWriter(&b);
+  uint8_t runeSize = sizeof(rune);
+  Buffer_Write(&bw, &runeSize, 1);
+  uint64_t size = t->size;
+  Buffer_Write(&bw, &size, sizeof(size));
+  uint8_t hasRoot = t->root != NULL;
+  Buffer_Write(&bw, &hasRoot, 1);
+  if (t->root) {
+    trieImageWriteNode(&bw, t->root);
+  }
+  *outlen = b.offset;
+  return b.data;
+}
+
+static TrieNode *trieImageReadNode(TrieImageReader *r, int depth) {
+  t_len len = 0, numChildren = 0;
+  uint8_t bits = 0;
+  float score = 0, maxChildScore = 0;
+  uint32_t plen = 0;
+  trieImageRead(r, &len, sizeof(len));
+  trieImageRead(r, &numChildren, sizeof(numChildren));
+  trieImageRead(r, &bits, sizeof(bits));
+  trieImageRead(r, &score, sizeof(score));
+  trieImageRead(r, &maxChildScore, sizeof(maxChildScore));
+  trieImageRead(r, &plen, sizeof(plen));
+  // each payload byte, rune and child record occupies at least one image byte:
+  // anything bigger than what remains is corruption
+  if (r->err || depth > TRIE_MAX_STRING_LEN ||
+      plen > (size_t)(r->end - r->cur) ||
+      (size_t)len * sizeof(rune) > (size_t)(r->end - r->cur) - plen) {
+    r->err = 1;
+    return NULL;
+  }
+  const char *payload = plen ? r->cur : NULL;
+  r->cur += plen;
+  rune str[TRIE_MAX_STRING_LEN + 1];
+  if (len > TRIE_MAX_STRING_LEN) {
+    r->err = 1;
+    return NULL;
+  }
+  trieImageRead(r, str, (size_t)len * sizeof(rune));
+  if (r->err) {
+    return NULL;
+  }
+
+  TrieNode *n = __newTrieNode(str, 0, len, payload, plen, numChildren, score,
+                              bits & TRIENODE_TERMINAL);
+  n->flags = bits & 0x3;
+  n->sortmode = (bits >> 2) & 0x3;
+  n->maxChildScore = maxChildScore;
+  TrieNode **children = __trieNode_children(n);
+  for (t_len i = 0; i < numChildren; i++) {
+    children[i] = trieImageReadNode(r, depth + 1);
+    if (!children[i]) {
+      // free what we built of this subtree and fail upward
+      n->numChildren = i;
+      TrieNode_Free(n);
+      return NULL;
+    }
+  }
+  return n;
+}
+
+Trie *TrieType_DeserializeImage(const char *blob, size_t len) {
+  TrieImageReader r = {.cur = blob, .end = blob + len};
+  uint8_t runeSize = 0, hasRoot = 0;
+  uint64_t size = 0;
+  trieImageRead(&r, &runeSize, 1);
+  trieImageRead(&r, &size, sizeof(size));
+  trieImageRead(&r, &hasRoot, 1);
+  if (r.err || runeSize != sizeof(rune)) {
+    return NULL;  // wrong build flavor (rune width) or torn image
+  }
+  Trie *t = NewTrie();
+  if (hasRoot) {
+    TrieNode *root = trieImageReadNode(&r, 0);
+    if (!root) {
+      TrieType_Free(t);
+      return NULL;
+    }
+    TrieNode_Free(t->root);
+    t->root = root;
+  }
+  t->size = size;
+  return t;
+}
+
 void *TrieType_GenericLoad(RedisModuleIO *rdb, int loadPayloads) {
 
   uint64_t elements = RedisModule_LoadUnsigned(rdb);
@@ -324,7 +763,10 @@ void *TrieType_GenericLoad(RedisModuleIO *rdb, int loadPayloads) {
 }
 
 void TrieType_RdbSave(RedisModuleIO *rdb, void *value) {
-  TrieType_GenericSave(rdb, (Trie *)value, 1);
+  size_t len = 0;
+  char *blob = TrieType_SerializeImage((Trie *)value, &len);
+  RedisModule_SaveStringBuffer(rdb, blob, len);
+  rm_free(blob);
 }
 
 void TrieType_GenericSave(RedisModuleIO *rdb, Trie *tree, int savePayloads) {
@@ -376,6 +818,7 @@ void TrieType_Free(void *value) {
 
     TrieNode_Free(tree->root);
   }
+  CompactTrie_Free(tree->compact);
 
   RedisModule_Free(tree);
 }
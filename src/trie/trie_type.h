@@ -4,6 +4,7 @@
 #include "../redismodule.h"
 
 #include "trie.h"
+#include "compact.h"
 #include "levenshtein.h"
 
 #ifdef __cplusplus
@@ -12,12 +13,19 @@ extern "C" {
 
 extern RedisModuleType *TrieType;
 
-#define TRIE_ENCVER_CURRENT 1
+#define TRIE_ENCVER_CURRENT 2
+// From this version up the whole trie is one flat image (single read/write)
+#define TRIE_ENCVER_IMAGE 2
 #define TRIE_ENCVER_NOPAYLOADS 0
 
 typedef struct {
   TrieNode *root;
   size_t size;
+  /* Packed read-path snapshot for prefix suggestions; NULL until the first
+   * search, rebuilt lazily when reads follow a burst of writes (dirty != 0).
+   * See compact.h */
+  CompactTrie *compact;
+  size_t dirty;  // modifications since `compact` was built
 } Trie;
 
 typedef struct {
@@ -46,13 +54,58 @@ Vector *Trie_Search(Trie *tree, const char *s, size_t len, size_t num, int maxDi
  * Otherwise we return an iterator to all strings within maxDist Levenshtein distance */
 TrieIterator *Trie_Iterate(Trie *t, const char *prefix, size_t len, int maxDist, int prefixMode);
 
+/* One candidate produced by Trie_ExpandParallel */
+typedef struct {
+  char *str;  // owned by the caller
+  size_t len;
+  float score;
+  int dist;
+} TrieExpansion;
+
+/* Expand the pattern by walking the root's subtrees in parallel on the trie
+ * pool, merging the per-subtree candidate lists in traversal order. Returns
+ * NULL when the walk is not worth parallelizing (small trie, no pool) and the
+ * caller should fall back to Trie_Iterate; otherwise an array of *nout
+ * expansions capped at maxExpansions ((size_t)-1 - unlimited), to be freed by
+ * the caller along with each entry's str */
+TrieExpansion *Trie_ExpandParallel(Trie *t, const char *prefix, size_t len, int maxDist,
+                                   int prefixMode, size_t maxExpansions, size_t *nout);
+
 /* Get a random key from the trie, and put the node's score in the score pointer. Returns 0 if the
  * trie is empty and we cannot do that */
 int Trie_RandomKey(Trie *t, char **str, t_len *len, double *score);
+
+#define TRIE_STATS_DEPTH_BUCKETS 16
+
+/* Fragmentation statistics for a suggestion trie (see FT.SUGSTATS) */
+typedef struct {
+  size_t nodes;             // total nodes, including the root
+  size_t deletedNodes;      // nodes marked deleted but still allocated
+  size_t singleChildNodes;  // non-terminal one-child links a rebuild would merge
+  size_t maxDepth;          // deepest node, in nodes from the root
+  size_t depthHist[TRIE_STATS_DEPTH_BUCKETS];  // node count per depth; last bucket clamps
+  size_t memBytes;          // bytes held by nodes and payloads
+  size_t wastedBytes;       // bytes a compaction would reclaim
+} TrieStats;
+
+void Trie_GatherStats(const Trie *t, TrieStats *stats);
+
+/* Rebuild the trie from its live entries, dropping deleted nodes, dead
+ * payloads and mergeable one-child chains. Returns the number of bytes
+ * reclaimed */
+size_t Trie_Compact(Trie *t);
 /* Commands related to the redis TrieType registration */
 int TrieType_Register(RedisModuleCtx *ctx);
 void *TrieType_GenericLoad(RedisModuleIO *rdb, int loadPayloads);
 void TrieType_GenericSave(RedisModuleIO *rdb, Trie *t, int savePayloads);
+
+/* Serialize the whole trie as one contiguous image (rm_malloc'd), nodes in
+ * pre-order with structure, scores and payloads preserved byte-exact */
+char *TrieType_SerializeImage(Trie *t, size_t *outlen);
+
+/* Rebuild a trie from an image: one read, one allocation per node. NULL on a
+ * malformed image or a rune-width mismatch */
+Trie *TrieType_DeserializeImage(const char *blob, size_t len);
 void *TrieType_RdbLoad(RedisModuleIO *rdb, int encver);
 void TrieType_RdbSave(RedisModuleIO *rdb, void *value);
 void TrieType_Digest(RedisModuleDigest *digest, void *value);
@@ -3,5 +3,6 @@
 void array_debug(void *pp) {
   const array_hdr_t *hdr = array_hdr(pp);
   printf("Array: %p, hdr@%p", pp, hdr);
-  printf("Len: %u. Cap: %u. ElemSize: %u\n", hdr->len, hdr->cap, hdr->elem_sz);
+  printf("Len: %u. Cap: %u%s. ElemSize: %u\n", hdr->len, array_cap_(hdr),
+         array_isinline_(hdr) ? " (inline)" : "", hdr->elem_sz);
 }
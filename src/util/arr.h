@@ -51,9 +51,17 @@ typedef struct {
   char buf[];
 } array_hdr_t;
 
+/* The high bit of cap marks an array living in caller-provided inline storage
+ * (see array_new_inline). Such an array is not heap-allocated: growing beyond
+ * the inline capacity copies it to the heap and clears the bit, and array_free
+ * on a still-inline array is a no-op */
+#define ARRAY_CAP_INLINE 0x80000000u
+#define array_cap_(hdr) ((hdr)->cap & ~ARRAY_CAP_INLINE)
+#define array_isinline_(hdr) ((hdr)->cap & ARRAY_CAP_INLINE)
+
 typedef void *array_t;
 /* Internal - calculate the array size for allocations */
-#define array_sizeof(hdr) (sizeof(array_hdr_t) + hdr->cap * hdr->elem_sz)
+#define array_sizeof(hdr) (sizeof(array_hdr_t) + array_cap_(hdr) * hdr->elem_sz)
 /* Internal - get a pointer to the array header */
 #define array_hdr(arr) ((array_hdr_t *)(((char *)arr) - sizeof(array_hdr_t)))
 /* Interanl - get a pointer to an element inside the array at a given index */
@@ -88,11 +96,48 @@ void array_debug(void *pp);
  *  */
 #define array_newlen(T, len) (T *)(array_new_sz(sizeof(T), len, len))
 
+/* Caller-provided in-situ storage for array_new_inline: room for the header
+ * plus N elements of type T, aligned for any element type */
+#define ARRAY_INLINE_STORAGE(T, N) \
+  struct {                         \
+    char bytes_[sizeof(array_hdr_t) + (N) * sizeof(T)] __attribute__((aligned(16))); \
+  }
+
+/* Internal - lay an array header over inline storage. Use array_new_inline */
+static inline array_t array_init_inline(array_hdr_t *hdr, uint32_t elem_sz, uint32_t cap) {
+  hdr->cap = cap | ARRAY_CAP_INLINE;
+  hdr->elem_sz = elem_sz;
+  hdr->len = 0;
+  return (array_t)hdr->buf;
+}
+
+/* Initialize an array of type T inside an ARRAY_INLINE_STORAGE(T, N) lvalue.
+ * Appends within the inline capacity touch no allocator; growing past it
+ * spills to the heap transparently. The storage must outlive the array (stack
+ * storage for a function-scoped array, or a field of the owning struct), and
+ * array_free stays correct whether or not the array ever spilled. e.g.
+ *
+ *  ARRAY_INLINE_STORAGE(int, 8) istorage;
+ *  int *arr = array_new_inline(int, istorage);
+ */
+#define array_new_inline(T, storage)                           \
+  (T *)array_init_inline((array_hdr_t *)(storage).bytes_, sizeof(T), \
+                         (sizeof((storage).bytes_) - sizeof(array_hdr_t)) / sizeof(T))
+
 static inline array_t array_ensure_cap(array_t arr, uint32_t cap) {
   array_hdr_t *hdr = array_hdr(arr);
-  if (cap > hdr->cap) {
-    hdr->cap = MAX(hdr->cap * 2, cap);
-    hdr = (array_hdr_t *)array_realloc_fn(hdr, array_sizeof(hdr));
+  if (cap > array_cap_(hdr)) {
+    uint32_t newcap = MAX(array_cap_(hdr) * 2, cap);
+    if (array_isinline_(hdr)) {
+      // spill out of the inline storage: from here on this is a normal heap array
+      array_hdr_t *heap = (array_hdr_t *)array_alloc_fn(sizeof(array_hdr_t) + newcap * hdr->elem_sz);
+      memcpy(heap, hdr, sizeof(array_hdr_t) + array_cap_(hdr) * hdr->elem_sz);
+      heap->cap = newcap;
+      hdr = heap;
+    } else {
+      hdr->cap = newcap;
+      hdr = (array_hdr_t *)array_realloc_fn(hdr, array_sizeof(hdr));
+    }
   }
   return (array_t)hdr->buf;
 }
@@ -186,7 +231,8 @@ static inline void *array_trimm(array_t arr, uint32_t len, uint32_t cap) {
   assert((cap == ARR_CAP_NOSHRINK || cap >= len) && "trimming len is greater then capacity");
   assert((len <= arr_hdr->len) && "trimming len is greater then current len");
   arr_hdr->len = len;
-  if (cap != ARR_CAP_NOSHRINK) {
+  if (cap != ARR_CAP_NOSHRINK && !array_isinline_(arr_hdr)) {
+    // inline arrays skip the shrink - their storage is fixed and costs nothing to keep
     arr_hdr->cap = cap;
     arr_hdr = (array_hdr_t *)array_realloc_fn(arr_hdr, array_sizeof(arr_hdr));
   }
@@ -198,7 +244,10 @@ static inline void *array_trimm(array_t arr, uint32_t len, uint32_t cap) {
 
 /* Free the array, without dealing with individual elements */
 static void array_free(array_t arr) {
-  array_free_fn(array_hdr(arr));
+  array_hdr_t *hdr = array_hdr(arr);
+  if (!array_isinline_(hdr)) {
+    array_free_fn(hdr);
+  }
 }
 
 /* Repeate the code in "blk" for each element in the array, and give it the name of "as".
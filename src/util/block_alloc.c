@@ -2,6 +2,32 @@
 #include <assert.h>
 #include <stdio.h>
 
+/* Process-wide counters (see BlkAllocGlobalStats). Relaxed atomics: the
+ * numbers guide sizing, they are not invariants */
+static size_t blkBlocksLive_g = 0;
+static size_t blkBlocksPeak_g = 0;
+static size_t blkBlocksTotal_g = 0;
+static size_t blkFixedAllocs_g = 0;
+static size_t blkFixedReuses_g = 0;
+
+static void blkStatBlockCreated(void) {
+  __atomic_add_fetch(&blkBlocksTotal_g, 1, __ATOMIC_RELAXED);
+  size_t live = __atomic_add_fetch(&blkBlocksLive_g, 1, __ATOMIC_RELAXED);
+  size_t peak = __atomic_load_n(&blkBlocksPeak_g, __ATOMIC_RELAXED);
+  while (live > peak &&
+         !__atomic_compare_exchange_n(&blkBlocksPeak_g, &peak, live, 1, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+  }
+}
+
+void BlkAlloc_GetGlobalStats(BlkAllocGlobalStats *out) {
+  out->blocksLive = __atomic_load_n(&blkBlocksLive_g, __ATOMIC_RELAXED);
+  out->blocksPeak = __atomic_load_n(&blkBlocksPeak_g, __ATOMIC_RELAXED);
+  out->blocksTotal = __atomic_load_n(&blkBlocksTotal_g, __ATOMIC_RELAXED);
+  out->fixedAllocs = __atomic_load_n(&blkFixedAllocs_g, __ATOMIC_RELAXED);
+  out->fixedReuses = __atomic_load_n(&blkFixedReuses_g, __ATOMIC_RELAXED);
+}
+
 static void freeCommon(BlkAlloc *blocks, BlkAllocCleaner cleaner, void *arg, size_t elemSize,
                        int reuse) {
   BlkAllocBlock *cur = blocks->root;
@@ -17,6 +43,7 @@ static void freeCommon(BlkAlloc *blocks, BlkAllocCleaner cleaner, void *arg, siz
       blocks->avail = cur;
     } else {
       free(cur);
+      __atomic_sub_fetch(&blkBlocksLive_g, 1, __ATOMIC_RELAXED);
     }
     cur = curNext;
   }
@@ -33,9 +60,12 @@ static void freeCommon(BlkAlloc *blocks, BlkAllocCleaner cleaner, void *arg, siz
     while (cur) {
       BlkAllocBlock *curNext = cur->next;
       free(cur);
+      __atomic_sub_fetch(&blkBlocksLive_g, 1, __ATOMIC_RELAXED);
       cur = curNext;
     }
   }
+  // Any outstanding free-list items lived in the dropped blocks
+  blocks->freeList = NULL;
 }
 
 void BlkAlloc_FreeAll(BlkAlloc *blocks, BlkAllocCleaner cleaner, void *arg, size_t elemSize) {
@@ -45,6 +75,7 @@ void BlkAlloc_FreeAll(BlkAlloc *blocks, BlkAllocCleaner cleaner, void *arg, size
 void BlkAlloc_Clear(BlkAlloc *blocks, BlkAllocCleaner cleaner, void *arg, size_t elemSize) {
   freeCommon(blocks, cleaner, arg, elemSize, 1);
   blocks->root = blocks->last = NULL;
+  blocks->freeList = NULL;
 }
 
 static BlkAllocBlock *getNewBlock(BlkAlloc *alloc, size_t blockSize) {
@@ -71,6 +102,7 @@ static BlkAllocBlock *getNewBlock(BlkAlloc *alloc, size_t blockSize) {
   }
 
   if (!block) {
+    blkStatBlockCreated();
     // printf("Allocating new block..\n");
     block = malloc(sizeof(*alloc->root) + blockSize);
     block->capacity = blockSize;
@@ -84,6 +116,23 @@ static BlkAllocBlock *getNewBlock(BlkAlloc *alloc, size_t blockSize) {
   return block;
 }
 
+void *BlkAlloc_AllocFixed(BlkAlloc *blocks, size_t elemSize, size_t blockSize) {
+  assert(elemSize >= sizeof(void *));
+  if (blocks->freeList) {
+    void *p = blocks->freeList;
+    blocks->freeList = *(void **)p;
+    __atomic_add_fetch(&blkFixedReuses_g, 1, __ATOMIC_RELAXED);
+    return p;
+  }
+  __atomic_add_fetch(&blkFixedAllocs_g, 1, __ATOMIC_RELAXED);
+  return BlkAlloc_Alloc(blocks, elemSize, blockSize);
+}
+
+void BlkAlloc_ReleaseFixed(BlkAlloc *blocks, void *item) {
+  *(void **)item = blocks->freeList;
+  blocks->freeList = item;
+}
+
 void *BlkAlloc_Alloc(BlkAlloc *blocks, size_t elemSize, size_t blockSize) {
   assert(blockSize >= elemSize);
   if (!blocks->root) {
@@ -20,6 +20,10 @@ typedef struct BlkAlloc {
 
   // Available blocks - used when recycling the allocator
   BlkAllocBlock *avail;
+
+  // Intrusive free list for the fixed-size mode (see BlkAlloc_AllocFixed):
+  // released items chain through their own first word
+  void *freeList;
 } BlkAlloc;
 
 // Initialize a block allocator
@@ -27,6 +31,7 @@ static inline void BlkAlloc_Init(BlkAlloc *alloc) {
   alloc->root = NULL;
   alloc->last = NULL;
   alloc->avail = NULL;
+  alloc->freeList = NULL;
 }
 
 /**
@@ -54,6 +59,32 @@ void BlkAlloc_FreeAll(BlkAlloc *alloc, BlkAllocCleaner cleaner, void *arg, size_
  */
 void BlkAlloc_Clear(BlkAlloc *alloc, BlkAllocCleaner cleaner, void *arg, size_t elemSize);
 
+/**
+ * Fixed-size mode: like BlkAlloc_Alloc, but items released through
+ * BlkAlloc_ReleaseFixed recycle within the allocator instead of waiting for
+ * a wholesale reset. elemSize must be at least a pointer wide (the free list
+ * chains through the item storage) and constant per allocator. FreeAll and
+ * Clear drop the free list along with the blocks.
+ *
+ * Beware combining ReleaseFixed with a block cleaner: the cleaner sweeps
+ * every used slot, including released items whose first word now holds the
+ * free-list link - only mix the two if the cleaner tolerates that.
+ */
+void *BlkAlloc_AllocFixed(BlkAlloc *alloc, size_t elemSize, size_t blockSize);
+void BlkAlloc_ReleaseFixed(BlkAlloc *alloc, void *item);
+
+/* Process-wide allocator counters for sizing these blind-tuned pools;
+ * queryable through FT.DEBUG BLKALLOC_STATS. Approximate under concurrency */
+typedef struct {
+  size_t blocksLive;      // blocks currently allocated (incl. recycled/avail)
+  size_t blocksPeak;      // high-water of blocksLive
+  size_t blocksTotal;     // blocks ever created
+  size_t fixedAllocs;     // fixed-mode allocations served fresh
+  size_t fixedReuses;     // fixed-mode allocations served from a free list
+} BlkAllocGlobalStats;
+
+void BlkAlloc_GetGlobalStats(BlkAllocGlobalStats *out);
+
 #ifdef __cplusplus
 }
 #endif
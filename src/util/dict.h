@@ -39,6 +39,10 @@
 #ifndef __DICT_H
 #define __DICT_H
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define DICT_OK 0
 #define DICT_ERR 1
 
@@ -185,4 +189,8 @@ dictEntry **dictFindEntryRefByPtrAndHash(dict *d, const void *oldptr, uint64_t h
 extern dictType dictTypeHeapStrings;
 extern dictType dictTypeHeapRedisStrings;
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __DICT_H */
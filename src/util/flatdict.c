@@ -0,0 +1,151 @@
+#include "flatdict.h"
+#include "fnv.h"
+#include "../rmalloc.h"
+#include <string.h>
+#include <emmintrin.h>
+
+/* Control byte values: empty and deleted have the high bit set so a stored
+ * 7-bit hash fragment (high bit clear) never collides with them */
+#define CTRL_EMPTY 0x80
+#define CTRL_DELETED 0xFE
+
+#define GROUP 16
+#define INITIAL_CAP 16  // power of two, >= GROUP
+
+typedef struct {
+  const char *key;
+  void *value;
+} FlatEntry;
+
+struct FlatDict {
+  uint8_t *ctrl;      // cap bytes (+ GROUP mirror bytes for wrap-free group loads)
+  FlatEntry *entries;
+  size_t cap;         // power of two
+  size_t size;        // live entries
+  size_t used;        // live + tombstones
+};
+
+static uint64_t fdHash(const char *key, size_t n) {
+  return fnv_64a_buf((void *)key, n, 0xcbf29ce484222325ULL);
+}
+
+static void fdInit(FlatDict *d, size_t cap) {
+  d->cap = cap;
+  d->size = 0;
+  d->used = 0;
+  d->ctrl = rm_malloc(cap + GROUP);
+  memset(d->ctrl, CTRL_EMPTY, cap + GROUP);
+  d->entries = rm_calloc(cap, sizeof(*d->entries));
+}
+
+FlatDict *FlatDict_New(void) {
+  FlatDict *d = rm_calloc(1, sizeof(*d));
+  fdInit(d, INITIAL_CAP);
+  return d;
+}
+
+void FlatDict_Free(FlatDict *d) {
+  if (!d) {
+    return;
+  }
+  rm_free(d->ctrl);
+  rm_free(d->entries);
+  rm_free(d);
+}
+
+size_t FlatDict_Size(const FlatDict *d) {
+  return d ? d->size : 0;
+}
+
+/* Find the slot holding `key`, or (size_t)-1. The group loads read the
+ * GROUP mirror bytes past the table end, which replicate the first bytes so
+ * a probe starting near the end needs no wrap handling within its group */
+static size_t fdFind(const FlatDict *d, const char *key, size_t n, uint64_t h) {
+  uint8_t frag = (h >> 57) & 0x7F;
+  size_t mask = d->cap - 1;
+  size_t pos = h & mask;
+  __m128i vfrag = _mm_set1_epi8((char)frag);
+  __m128i vempty = _mm_set1_epi8((char)CTRL_EMPTY);
+  for (size_t probes = 0; probes <= mask; probes += GROUP) {
+    __m128i grp = _mm_loadu_si128((const __m128i *)(d->ctrl + pos));
+    int cand = _mm_movemask_epi8(_mm_cmpeq_epi8(grp, vfrag));
+    while (cand) {
+      int bit = __builtin_ctz(cand);
+      size_t at = (pos + bit) & mask;
+      const FlatEntry *e = &d->entries[at];
+      if (strncmp(e->key, key, n) == 0 && e->key[n] == '\0') {
+        return at;
+      }
+      cand &= cand - 1;
+    }
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(grp, vempty))) {
+      return (size_t)-1;  // an empty slot ends the probe chain
+    }
+    pos = (pos + GROUP) & mask;
+  }
+  return (size_t)-1;
+}
+
+static void fdMirror(FlatDict *d, size_t at, uint8_t v) {
+  d->ctrl[at] = v;
+  if (at < GROUP) {
+    d->ctrl[d->cap + at] = v;  // keep the wrap mirror in sync
+  }
+}
+
+static void fdSetInternal(FlatDict *d, const char *key, void *value, uint64_t h);
+
+static void fdGrow(FlatDict *d) {
+  FlatDict old = *d;
+  fdInit(d, old.cap * 2);
+  for (size_t i = 0; i < old.cap; ++i) {
+    if (!(old.ctrl[i] & 0x80)) {
+      const FlatEntry *e = &old.entries[i];
+      fdSetInternal(d, e->key, e->value, fdHash(e->key, strlen(e->key)));
+    }
+  }
+  rm_free(old.ctrl);
+  rm_free(old.entries);
+}
+
+static void fdSetInternal(FlatDict *d, const char *key, void *value, uint64_t h) {
+  size_t n = strlen(key);
+  size_t found = fdFind(d, key, n, h);
+  if (found != (size_t)-1) {
+    d->entries[found].value = value;
+    return;
+  }
+  // keep at least 1/8 of the table empty so probe chains terminate quickly
+  if ((d->used + 1) * 8 >= d->cap * 7) {
+    fdGrow(d);
+  }
+  uint8_t frag = (h >> 57) & 0x7F;
+  size_t mask = d->cap - 1;
+  size_t pos = h & mask;
+  for (;;) {
+    if (d->ctrl[pos] & 0x80) {  // empty or deleted
+      if (d->ctrl[pos] == CTRL_EMPTY) {
+        d->used++;
+      }
+      fdMirror(d, pos, frag);
+      d->entries[pos].key = key;
+      d->entries[pos].value = value;
+      d->size++;
+      return;
+    }
+    pos = (pos + 1) & mask;
+  }
+}
+
+void FlatDict_Set(FlatDict *d, const char *key, void *value) {
+  fdSetInternal(d, key, value, fdHash(key, strlen(key)));
+}
+
+void *FlatDict_GetN(const FlatDict *d, const char *key, size_t n) {
+  size_t at = fdFind(d, key, n, fdHash(key, n));
+  return at == (size_t)-1 ? NULL : d->entries[at].value;
+}
+
+void *FlatDict_Get(const FlatDict *d, const char *key) {
+  return FlatDict_GetN(d, key, strlen(key));
+}
@@ -0,0 +1,42 @@
+#ifndef FLATDICT_H
+#define FLATDICT_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A flat open-addressing string map for hot lookup workloads: control bytes
+ * probed sixteen at a time with SSE2 (the Swiss-table layout), entries stored
+ * inline in one array - no per-entry allocation, no bucket chains. The API
+ * mirrors the subset of util/dict these call sites used; there is no
+ * incremental rehash and no safe iteration-during-mutation, which is exactly
+ * the trade the hot name-resolution maps (lookup keys, schema fields) can
+ * make. Sites that mutate while iterating stay on the chained dict.
+ *
+ * Keys are NUL-terminated strings, borrowed (never copied or freed); values
+ * are opaque pointers.
+ */
+typedef struct FlatDict FlatDict;
+
+FlatDict *FlatDict_New(void);
+void FlatDict_Free(FlatDict *d);
+
+/* Insert or replace. The key pointer must outlive the map */
+void FlatDict_Set(FlatDict *d, const char *key, void *value);
+
+/* NULL when absent (NULL values are not distinguishable from absence) */
+void *FlatDict_Get(const FlatDict *d, const char *key);
+
+/* Length-delimited probe, for keys that are not NUL-terminated */
+void *FlatDict_GetN(const FlatDict *d, const char *key, size_t n);
+
+size_t FlatDict_Size(const FlatDict *d);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
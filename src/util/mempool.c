@@ -4,6 +4,16 @@
 #include <stdio.h>
 #include <pthread.h>
 
+/* Per-thread cache of a shared pool: a small stack only its owner touches.
+ * Entries recycle on the thread that allocated them, so their cache lines
+ * (and, via first-touch, their pages' NUMA placement) stay with that thread */
+typedef struct mpThreadCache {
+  void **entries;
+  size_t top;
+  struct mempool_t *owner;
+  struct mpThreadCache *nextCache;  // owner's list, for destroy-time flush
+} mpThreadCache;
+
 typedef struct mempool_t {
   void **entries;
   size_t top;
@@ -12,8 +22,67 @@ typedef struct mempool_t {
   mempool_alloc_fn alloc;
   mempool_free_fn free;
   pthread_mutex_t lock;
+  // observability (see mempool_stats_t); maintained by the owning thread
+  // (plain increments on shared pools - the stats are documented approximate)
+  const char *name;  // non-NULL once registered
+  size_t numGets;
+  size_t numAllocs;
+  size_t numReleases;
+  size_t numOverflows;
+  struct mempool_t *nextRegistered;
+
+  /* Shared (per-thread cached) mode; see mempool_new_shared. For such pools
+   * `entries` above serves as the mutex-guarded global overflow list, sized
+   * lazily up to `max` */
+  int isShared;
+  size_t tcap;  // per-thread cache bound
+  pthread_key_t tlsKey;
+  mpThreadCache *caches;  // all caches ever created, guarded by `lock`
 } mempool_t;
 
+/* Registry of named pools, for stats export. Guarded by a mutex since pools
+ * are created lazily from multiple threads (thread-local tokenizer pools) */
+static mempool_t *registryHead_g = NULL;
+static pthread_mutex_t registryLock_g = PTHREAD_MUTEX_INITIALIZER;
+
+void mempool_register(mempool_t *p, const char *name) {
+  p->name = name;
+  pthread_mutex_lock(&registryLock_g);
+  p->nextRegistered = registryHead_g;
+  registryHead_g = p;
+  pthread_mutex_unlock(&registryLock_g);
+}
+
+void mempool_visit_registered(void (*cb)(const mempool_stats_t *stats, void *privdata),
+                              void *privdata) {
+  pthread_mutex_lock(&registryLock_g);
+  for (mempool_t *p = registryHead_g; p; p = p->nextRegistered) {
+    mempool_stats_t st = {.name = p->name,
+                          .numGets = p->numGets,
+                          .numAllocs = p->numAllocs,
+                          .numReleases = p->numReleases,
+                          .numOverflows = p->numOverflows,
+                          .currentInPool = p->top,
+                          .currentCap = p->cap};
+    cb(&st, privdata);
+  }
+  pthread_mutex_unlock(&registryLock_g);
+}
+
+static void mempool_unregister(mempool_t *p) {
+  if (!p->name) {
+    return;
+  }
+  pthread_mutex_lock(&registryLock_g);
+  for (mempool_t **pp = &registryHead_g; *pp; pp = &(*pp)->nextRegistered) {
+    if (*pp == p) {
+      *pp = p->nextRegistered;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&registryLock_g);
+}
+
 mempool_t *mempool_new(size_t cap, mempool_alloc_fn alloc, mempool_free_fn freefn) {
   return mempool_new_limited(cap, 0, alloc, freefn);
 }
@@ -29,6 +98,12 @@ mempool_t *mempool_new_limited(size_t cap, size_t max, mempool_alloc_fn alloc,
   p->cap = cap;
   p->max = max;
   p->top = 0;
+  p->name = NULL;
+  p->numGets = p->numAllocs = p->numReleases = p->numOverflows = 0;
+  p->nextRegistered = NULL;
+  p->isShared = 0;
+  p->tcap = 0;
+  p->caches = NULL;
   if (mempoolDisable_g == -1) {
     if (getenv("REDISEARCH_NO_MEMPOOL")) {
       fprintf(stderr, "[redisearch]: REDISEARCH_NO_MEMPOOL in environment. Disabling\n");
@@ -46,21 +121,95 @@ mempool_t *mempool_new_limited(size_t cap, size_t max, mempool_alloc_fn alloc,
   return p;
 }
 
+static mpThreadCache *mpGetCache(mempool_t *p) {
+  mpThreadCache *tc = pthread_getspecific(p->tlsKey);
+  if (!tc) {
+    tc = calloc(1, sizeof(*tc));
+    tc->entries = calloc(p->tcap, sizeof(void *));
+    tc->owner = p;
+    pthread_setspecific(p->tlsKey, tc);
+    pthread_mutex_lock(&p->lock);
+    tc->nextCache = p->caches;
+    p->caches = tc;
+    pthread_mutex_unlock(&p->lock);
+  }
+  return tc;
+}
+
+mempool_t *mempool_new_shared(size_t tcap, size_t overflow_max, mempool_alloc_fn alloc,
+                              mempool_free_fn freefn) {
+  mempool_t *p = mempool_new_limited(0, overflow_max, alloc, freefn);
+  if (mempoolDisable_g) {
+    // stays a plain disabled pool: get allocates, release frees
+    return p;
+  }
+  p->isShared = 1;
+  p->tcap = tcap;
+  pthread_mutex_init(&p->lock, NULL);
+  // No thread-exit destructor: the process-wide pools these serve outlive
+  // every worker, and destroy flushes the cache list
+  pthread_key_create(&p->tlsKey, NULL);
+  return p;
+}
+
 void *mempool_get(mempool_t *p) {
   void *ret = NULL;
+  p->numGets++;
+  if (p->isShared) {
+    mpThreadCache *tc = mpGetCache(p);
+    if (tc->top > 0) {
+      return tc->entries[--tc->top];
+    }
+    // local miss: one trip to the global overflow before allocating
+    pthread_mutex_lock(&p->lock);
+    if (p->top > 0) {
+      ret = p->entries[--p->top];
+    }
+    pthread_mutex_unlock(&p->lock);
+    if (!ret) {
+      ret = p->alloc();
+      p->numAllocs++;
+    }
+    return ret;
+  }
   if (p->top > 0) {
     ret = p->entries[--p->top];
 
   } else {
     ret = p->alloc();
+    p->numAllocs++;
   }
   return ret;
 }
 
 inline void mempool_release(mempool_t *p, void *ptr) {
+  p->numReleases++;
+  if (p->isShared) {
+    mpThreadCache *tc = mpGetCache(p);
+    if (tc->top < p->tcap) {
+      tc->entries[tc->top++] = ptr;
+      return;
+    }
+    // local cache full - spill to the bounded global overflow
+    pthread_mutex_lock(&p->lock);
+    if (!p->max || p->top < p->max) {
+      if (p->top == p->cap) {
+        p->cap += p->cap ? MIN(p->cap, 1024) : 16;
+        p->entries = realloc(p->entries, p->cap * sizeof(void *));
+      }
+      p->entries[p->top++] = ptr;
+      pthread_mutex_unlock(&p->lock);
+      return;
+    }
+    pthread_mutex_unlock(&p->lock);
+    p->numOverflows++;
+    p->free(ptr);
+    return;
+  }
   if (p->top == p->cap) {
     // This is a limited pool, and we can't outgrow ourselves now, just free the ptr immediately
     if (p->entries == NULL || (p->max && p->max == p->top)) {
+      p->numOverflows++;
       p->free(ptr);
       return;
     }
@@ -72,9 +221,22 @@ inline void mempool_release(mempool_t *p, void *ptr) {
 }
 
 void mempool_destroy(mempool_t *p) {
+  mempool_unregister(p);
   for (size_t i = 0; i < p->top; i++) {
     p->free(p->entries[i]);
   }
+  if (p->isShared) {
+    for (mpThreadCache *tc = p->caches; tc;) {
+      mpThreadCache *next = tc->nextCache;
+      for (size_t i = 0; i < tc->top; i++) {
+        p->free(tc->entries[i]);
+      }
+      free(tc->entries);
+      free(tc);
+      tc = next;
+    }
+    pthread_key_delete(p->tlsKey);
+  }
   free(p->entries);
   free(p);
 }
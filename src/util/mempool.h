@@ -26,6 +26,39 @@ struct mempool_t *mempool_new(size_t cap, mempool_alloc_fn alloc, mempool_free_f
 struct mempool_t *mempool_new_limited(size_t cap, size_t max_cap, mempool_alloc_fn alloc,
                                       mempool_free_fn free);
 
+/* Create a pool whose gets and releases go through a per-thread, size-bounded
+ * cache (tcap entries each) backed by a locked global overflow list (bounded
+ * by overflow_max, 0 = unbounded). Entries allocate, recycle and die on the
+ * same thread in the common case, so cache lines stop bouncing between
+ * workers and - through the kernel's first-touch policy - the backing pages
+ * stay local to the requesting thread's NUMA node without an explicit numa
+ * dependency. Each such pool consumes one TLS key: use it for the long-lived
+ * process-wide pools, not per-instance ones */
+struct mempool_t *mempool_new_shared(size_t tcap, size_t overflow_max, mempool_alloc_fn alloc,
+                                     mempool_free_fn free);
+
+/* Usage counters for a pool. Reads are unlocked and therefore approximate
+ * when the owning thread is active - they are for observability only */
+typedef struct {
+  const char *name;       // NULL if the pool was never registered
+  size_t numGets;         // total mempool_get calls
+  size_t numAllocs;       // gets that missed the pool and hit the allocator
+  size_t numReleases;     // total mempool_release calls
+  size_t numOverflows;    // releases freed immediately because the pool was full
+  size_t currentInPool;   // entries sitting in the pool right now
+  size_t currentCap;      // entry array capacity
+} mempool_stats_t;
+
+/* Register the pool under `name` (not copied - use a literal) in the global
+ * pool registry, making it visible to mempool_visit_registered(). Thread-local
+ * pools may register the same name once per thread; visitors see each one */
+void mempool_register(struct mempool_t *p, const char *name);
+
+/* Invoke cb for every registered pool. Safe against concurrent
+ * register/destroy; the stats themselves are unlocked snapshots */
+void mempool_visit_registered(void (*cb)(const mempool_stats_t *stats, void *privdata),
+                              void *privdata);
+
 /* Get an entry from the pool, allocating a new instance if unavailable */
 void *mempool_get(struct mempool_t *p);
 
@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "minmax_heap.h"
 
@@ -158,6 +159,80 @@ static void trickledown(heap_t* h, int i) {
   }
 }
 
+/* ----------------------------------------------------------------------------
+ * 4-ary min-heap mode. Children of i are 4i-2 .. 4i+1, parent of c is
+ * (c+2)/4 (1-based, like the min-max layout). The drain side (pop_max) sorts
+ * the array ascending once and pops from the tail; the sorter only starts
+ * popping max after its accumulation finished, so the sort happens once.
+ */
+#define DARY_MAX_SIZE 4096
+
+#define d4_first_child(i) ((i)*4 - 2)
+#define d4_parent(c) (((c) + 2) / 4)
+
+static void d4_siftup(heap_t* h, size_t i) {
+  void** d = h->data;
+  void* v = d[i];
+  while (i > 1) {
+    size_t p = d4_parent(i);
+    if (h->cmp(v, d[p], h->cmp_ctx) >= 0) {
+      break;
+    }
+    d[i] = d[p];
+    i = p;
+  }
+  d[i] = v;
+}
+
+static void d4_siftdown(heap_t* h, size_t i) {
+  void** d = h->data;
+  void* v = d[i];
+  size_t n = h->count;
+  for (;;) {
+    size_t c = d4_first_child(i);
+    if (c > n) {
+      break;
+    }
+    // pick the smallest of up to four children; the full-block case runs
+    // without per-child bounds checks
+    size_t m = c;
+    size_t last = c + 3 <= n ? c + 3 : n;
+    for (size_t j = c + 1; j <= last; j++) {
+      if (h->cmp(d[j], d[m], h->cmp_ctx) < 0) {
+        m = j;
+      }
+    }
+    if (h->cmp(d[m], v, h->cmp_ctx) >= 0) {
+      break;
+    }
+    d[i] = d[m];
+    i = m;
+  }
+  d[i] = v;
+}
+
+// qsort_r portability shim for the drain sort; thread-local, since sorters
+// on different query threads can drain concurrently
+static __thread heap_t* qsortHeap_g;
+static int d4_qsortCmp(const void* a, const void* b) {
+  return qsortHeap_g->cmp(*(void* const*)a, *(void* const*)b, qsortHeap_g->cmp_ctx);
+}
+
+static void d4_startDrain(heap_t* h) {
+  qsortHeap_g = h;
+  qsort(h->data + 1, h->count, sizeof(void*), d4_qsortCmp);
+  h->draining = 1;
+}
+
+/* inserts after a drain started re-enter heap order; the sorter never does
+ * this, but the API stays correct if someone else does */
+static void d4_reheapify(heap_t* h) {
+  for (size_t i = h->count / 4 + 1; i >= 1; i--) {
+    d4_siftdown(h, i);
+  }
+  h->draining = 0;
+}
+
 void mmh_insert(heap_t* h, void* value) {
   assert(value != NULL);
   h->count++;
@@ -167,10 +242,33 @@ void mmh_insert(heap_t* h, void* value) {
     h->data = realloc(h->data, (1 + h->size) * sizeof(void*));
   }
   h->data[h->count] = value;
+  if (h->dary) {
+    if (h->draining) {
+      d4_reheapify(h);
+    } else {
+      d4_siftup(h, h->count);
+    }
+    return;
+  }
   bubbleup(h, h->count);
 }
 
 void* mmh_pop_min(heap_t* h) {
+  if (h->dary && h->count) {
+    if (h->draining) {
+      // sorted ascending: the min sits at the front
+      void* d = h->data[1];
+      memmove(h->data + 1, h->data + 2, (h->count - 1) * sizeof(void*));
+      h->count--;
+      return d;
+    }
+    void* d = h->data[1];
+    h->data[1] = h->data[h->count--];
+    if (h->count) {
+      d4_siftdown(h, 1);
+    }
+    return d;
+  }
   if (h->count > 1) {
     void* d = h->data[1];
     h->data[1] = h->data[h->count--];
@@ -187,6 +285,15 @@ void* mmh_pop_min(heap_t* h) {
 }
 
 void* mmh_pop_max(heap_t* h) {
+  if (h->dary) {
+    if (!h->count) {
+      return NULL;
+    }
+    if (!h->draining) {
+      d4_startDrain(h);
+    }
+    return h->data[h->count--];
+  }
   if (h->count > 2) {
     int idx = 2;
     if (heap_lt(h, 2, 3)) idx = 3;
@@ -211,12 +318,27 @@ void* mmh_pop_max(heap_t* h) {
 
 void* mmh_peek_min(const heap_t* h) {
   if (h->count > 0) {
-    return h->data[1];
+    return h->data[1];  // root of both layouts; a draining 4-ary is sorted
   }
   return NULL;
 }
 
 void* mmh_peek_max(const heap_t* h) {
+  if (h->dary) {
+    if (!h->count) {
+      return NULL;
+    }
+    if (h->draining) {
+      return h->data[h->count];
+    }
+    void* m = h->data[1];
+    for (size_t i = 2; i <= h->count; i++) {
+      if (h->cmp(h->data[i], m, h->cmp_ctx) > 0) {
+        m = h->data[i];
+      }
+    }
+    return m;
+  }
   if (h->count > 2) {
     return heap_max(h, 2, 3);  // h->data[2], h->data[3]);
   }
@@ -246,6 +368,7 @@ heap_t* mmh_init_with_size(size_t size, mmh_cmp_func cmp, void* cmp_ctx, mmh_fre
   // inside the array i.e. => [0,(1),(2), ... (n)] so minimum viable size is 2
   size = size > 2 ? size : 2;
   heap_t* h = calloc(1, sizeof(heap_t));
+  h->dary = size <= DARY_MAX_SIZE;
   // We allocate 1 extra space because we start at index 1
   h->data = calloc(size + 1, sizeof(void*));
   h->count = 0;
@@ -13,6 +13,12 @@ typedef struct heap {
   void* cmp_ctx;
   void** data;
   mmh_free_func free_func;
+  // Small bounded heaps (the top-k sorter shape) run as a 4-ary min-heap
+  // with a lazy sorted drain instead of the min-max structure: fewer levels,
+  // fewer comparisons, and the elements stay in one linear array. Selected
+  // by the size given to mmh_init_with_size
+  int dary;
+  int draining;
 } heap_t;
 
 heap_t* mmh_init(mmh_cmp_func cmp, void* cmp_ctx, mmh_free_func free_func);
@@ -0,0 +1,199 @@
+#include "tdigest.h"
+#include <string.h>
+#include <math.h>
+
+typedef struct {
+  double mean;
+  double weight;
+} TDCentroid;
+
+struct TDigest {
+  double compression;
+  TDCentroid *centroids;
+  size_t numCentroids;
+  size_t capCentroids;
+
+  // insertion buffer, merged into the centroids when full
+  TDCentroid *buf;
+  size_t bufLen;
+  size_t bufCap;
+
+  double totalWeight;  // centroids only; buffered weight not included
+  double min, max;
+};
+
+TDigest *TDigest_New(double compression) {
+  if (compression < 20) {
+    compression = 20;
+  }
+  TDigest *td = calloc(1, sizeof(*td));
+  td->compression = compression;
+  td->capCentroids = (size_t)(2 * compression) + 16;
+  td->centroids = calloc(td->capCentroids, sizeof(*td->centroids));
+  td->bufCap = (size_t)(10 * compression);
+  td->buf = calloc(td->bufCap, sizeof(*td->buf));
+  td->min = INFINITY;
+  td->max = -INFINITY;
+  return td;
+}
+
+void TDigest_Free(TDigest *td) {
+  free(td->centroids);
+  free(td->buf);
+  free(td);
+}
+
+static int tdCmpCentroid(const void *a, const void *b) {
+  double ma = ((const TDCentroid *)a)->mean, mb = ((const TDCentroid *)b)->mean;
+  return ma < mb ? -1 : (ma > mb ? 1 : 0);
+}
+
+/* Merge the buffered points into the centroid list. Classic merging-digest
+ * pass: order everything by mean and greedily coalesce, capping each output
+ * centroid's weight at 4*n*q*(1-q)/compression so the tails stay precise */
+static void tdCompress(TDigest *td) {
+  if (!td->bufLen) {
+    return;
+  }
+  // the centroid list is already sorted - sort just the buffer and merge the
+  // two runs, instead of re-sorting everything
+  qsort(td->buf, td->bufLen, sizeof(*td->buf), tdCmpCentroid);
+  size_t total = td->numCentroids + td->bufLen;
+  TDCentroid *all = malloc(total * sizeof(*all));
+  {
+    size_t i = 0, j = 0, o = 0;
+    while (i < td->numCentroids && j < td->bufLen) {
+      all[o++] = td->centroids[i].mean <= td->buf[j].mean ? td->centroids[i++] : td->buf[j++];
+    }
+    while (i < td->numCentroids) all[o++] = td->centroids[i++];
+    while (j < td->bufLen) all[o++] = td->buf[j++];
+  }
+
+  double totalWeight = 0;
+  for (size_t i = 0; i < total; i++) {
+    totalWeight += all[i].weight;
+  }
+
+  size_t nout = 0;
+  TDCentroid cur = all[0];
+  double wSoFar = 0;
+  for (size_t i = 1; i < total; i++) {
+    double q = (wSoFar + cur.weight + all[i].weight / 2) / totalWeight;
+    double cap = 4 * totalWeight * q * (1 - q) / td->compression;
+    if (cur.weight + all[i].weight <= cap) {
+      // coalesce: weighted mean
+      cur.mean += (all[i].mean - cur.mean) * (all[i].weight / (cur.weight + all[i].weight));
+      cur.weight += all[i].weight;
+    } else {
+      wSoFar += cur.weight;
+      if (nout == td->capCentroids) {
+        // should not happen with the q(1-q) bound; grow defensively
+        td->capCentroids *= 2;
+        td->centroids = realloc(td->centroids, td->capCentroids * sizeof(*td->centroids));
+      }
+      td->centroids[nout++] = cur;
+      cur = all[i];
+    }
+  }
+  if (nout == td->capCentroids) {
+    td->capCentroids *= 2;
+    td->centroids = realloc(td->centroids, td->capCentroids * sizeof(*td->centroids));
+  }
+  td->centroids[nout++] = cur;
+
+  td->numCentroids = nout;
+  td->totalWeight = totalWeight;
+  td->bufLen = 0;
+  free(all);
+}
+
+void TDigest_Add(TDigest *td, double x, double weight) {
+  if (td->bufLen == td->bufCap) {
+    tdCompress(td);
+  }
+  td->buf[td->bufLen].mean = x;
+  td->buf[td->bufLen].weight = weight;
+  td->bufLen++;
+  if (x < td->min) td->min = x;
+  if (x > td->max) td->max = x;
+}
+
+double TDigest_TotalWeight(const TDigest *td) {
+  double w = td->totalWeight;
+  for (size_t i = 0; i < td->bufLen; i++) {
+    w += td->buf[i].weight;
+  }
+  return w;
+}
+
+double TDigest_Quantile(TDigest *td, double q) {
+  tdCompress(td);
+  if (!td->numCentroids) {
+    return 0;
+  }
+  if (q <= 0) {
+    return td->min;
+  }
+  if (q >= 1) {
+    return td->max;
+  }
+  if (td->numCentroids == 1) {
+    return td->centroids[0].mean;
+  }
+
+  double target = q * td->totalWeight;
+  double wSoFar = 0;
+  for (size_t i = 0; i < td->numCentroids; i++) {
+    TDCentroid *c = &td->centroids[i];
+    if (wSoFar + c->weight / 2 >= target) {
+      // interpolate between the previous centroid's midpoint and this one's
+      if (i == 0) {
+        double frac = target / (c->weight / 2);
+        double lo = td->min;
+        return lo + frac * (c->mean - lo);
+      }
+      TDCentroid *p = &td->centroids[i - 1];
+      double loW = wSoFar - p->weight / 2;
+      double hiW = wSoFar + c->weight / 2;
+      double frac = (target - loW) / (hiW - loW);
+      return p->mean + frac * (c->mean - p->mean);
+    }
+    wSoFar += c->weight;
+  }
+  // beyond the last midpoint - interpolate toward the max
+  TDCentroid *last = &td->centroids[td->numCentroids - 1];
+  double loW = td->totalWeight - last->weight / 2;
+  double frac = (target - loW) / (td->totalWeight - loW);
+  if (frac > 1) frac = 1;
+  return last->mean + frac * (td->max - last->mean);
+}
+
+void TDigest_Merge(TDigest *dst, const TDigest *src) {
+  for (size_t i = 0; i < src->numCentroids; i++) {
+    TDigest_Add(dst, src->centroids[i].mean, src->centroids[i].weight);
+  }
+  for (size_t i = 0; i < src->bufLen; i++) {
+    TDigest_Add(dst, src->buf[i].mean, src->buf[i].weight);
+  }
+  if (src->min < dst->min) dst->min = src->min;
+  if (src->max > dst->max) dst->max = src->max;
+}
+
+double TDigest_Compression(const TDigest *td) {
+  return td->compression;
+}
+
+size_t TDigest_NumCentroids(TDigest *td) {
+  tdCompress(td);
+  return td->numCentroids;
+}
+
+size_t TDigest_GetCentroids(TDigest *td, double *means, double *weights, size_t cap) {
+  tdCompress(td);  // fold any buffered points in first
+  size_t n = td->numCentroids < cap ? td->numCentroids : cap;
+  for (size_t i = 0; i < n; i++) {
+    means[i] = td->centroids[i].mean;
+    weights[i] = td->centroids[i].weight;
+  }
+  return n;
+}
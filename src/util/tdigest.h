@@ -0,0 +1,45 @@
+#ifndef RS_TDIGEST_H_
+#define RS_TDIGEST_H_
+
+#include <stdlib.h>
+
+/**
+ * A merging t-digest: an adaptive histogram for streaming quantile
+ * estimation. Inserts buffer into a scratch array and are periodically
+ * merged into the centroid list with a q(1-q) size limit, so accuracy is
+ * highest at the tails. Unlike the GK stream in quantile.c, two digests of
+ * equal compression can be merged, which is what partial-aggregation
+ * consumers need.
+ */
+typedef struct TDigest TDigest;
+
+/* Create a digest. Higher compression => more centroids => better accuracy.
+ * Memory is O(compression) */
+TDigest *TDigest_New(double compression);
+
+void TDigest_Free(TDigest *td);
+
+/* Add a value with the given weight (1 for plain samples) */
+void TDigest_Add(TDigest *td, double x, double weight);
+
+/* Estimate the value at quantile q (0..1). Returns 0 for an empty digest */
+double TDigest_Quantile(TDigest *td, double q);
+
+/* Fold `src` into `dst`. `src` is unchanged */
+void TDigest_Merge(TDigest *dst, const TDigest *src);
+
+/* Total weight added so far */
+double TDigest_TotalWeight(const TDigest *td);
+
+/* The digest's compression parameter */
+double TDigest_Compression(const TDigest *td);
+
+/* Number of centroids after folding the insertion buffer in */
+size_t TDigest_NumCentroids(TDigest *td);
+
+/* Copy up to `cap` centroids (flushing the insertion buffer first) into
+ * means/weights; returns the number copied. For partial-aggregation wire
+ * images: a digest rebuilt by weighted adds of these pairs is equivalent */
+size_t TDigest_GetCentroids(TDigest *td, double *means, double *weights, size_t cap);
+
+#endif
@@ -1,4 +1,5 @@
 #include "value.h"
+#include "rmalloc.h"
 #include "util/mempool.h"
 #include <pthread.h>
 
@@ -59,13 +60,14 @@ void RSValue_Clear(RSValue *v) {
           free(v->strval.str);
           break;
         case RSString_RMAlloc:
-          RedisModule_Free(v->strval.str);
+          rm_free(v->strval.str);
           break;
         case RSString_SDS:
           sdsfree(v->strval.str);
           break;
         case RSString_Const:
         case RSString_Volatile:
+        case RSString_Inline:
           break;
       }
       break;
@@ -139,11 +141,39 @@ inline void RSValue_SetConstString(RSValue *v, const char *str, size_t len) {
   v->strval.stype = RSString_Const;
 }
 
+/* Store the bytes in the value's own inline buffer. The incoming buffer is
+ * released per its type, so the caller's ownership contract is unchanged;
+ * the value ends up with no external allocation and nothing to free */
+static void valueSetInline(RSValue *v, char *str, uint32_t len, RSStringType t) {
+  memcpy(v->inl.data, str, len);
+  v->inl.data[len] = '\0';  // inline strings stay valid C strings
+  v->strval.str = v->inl.data;
+  v->strval.len = len;
+  v->strval.stype = RSString_Inline;
+  switch (t) {
+    case RSString_Malloc:
+      free(str);
+      break;
+    case RSString_RMAlloc:
+      rm_free(str);
+      break;
+    case RSString_SDS:
+      sdsfree(str);
+      break;
+    default:  // volatile/const borrow - nothing to release
+      break;
+  }
+}
+
 /* Wrap a string with length into a value object. Doesn't duplicate the string. Use strdup if
  * the value needs to be detached */
 inline RSValue *RS_StringVal(char *str, uint32_t len) {
   assert(len <= (UINT32_MAX >> 4));
   RSValue *v = RS_NewValue(RSValue_String);
+  if (len <= RSVALUE_INLINE_CAP) {
+    valueSetInline(v, str, len, RSString_Malloc);
+    return v;
+  }
   v->strval.str = str;
   v->strval.len = len;
   v->strval.stype = RSString_Malloc;
@@ -153,6 +183,12 @@ inline RSValue *RS_StringVal(char *str, uint32_t len) {
 /* Same as RS_StringVal but with explicit string type */
 inline RSValue *RS_StringValT(char *str, uint32_t len, RSStringType t) {
   RSValue *v = RS_NewValue(RSValue_String);
+  // Short owned or volatile strings move into the slot itself; const strings
+  // are cheaper left as borrows
+  if (t != RSString_Const && len <= RSVALUE_INLINE_CAP) {
+    valueSetInline(v, str, len, t);
+    return v;
+  }
   v->strval.str = str;
   v->strval.len = len;
   v->strval.stype = t;
@@ -507,6 +543,61 @@ int RSValue_Equal(const RSValue *v1, const RSValue *v2) {
   return RSValue_Cmp(v1, v2) == 0;
 }
 
+/* Serializing 10K-row aggregations spends real time in per-value "%.12g"
+ * calls, and the values are overwhelmingly integral (counts, sums) or
+ * repeated (group keys, constant scores). Integral values up to 12 digits
+ * print identically to "%.12g" through a direct digit emitter; everything
+ * else goes through a small per-thread memo of recent conversions before
+ * falling back to snprintf. The output is byte-identical to "%.12g" */
+#define NUM_MEMO_SLOTS 8
+
+static __thread struct {
+  double val;
+  uint8_t len;
+  uint8_t valid;
+  char str[24];
+} numMemo_tls[NUM_MEMO_SLOTS];
+static __thread uint8_t numMemoPos_tls;
+
+size_t RSValue_FormatNumber(double d, char *buf) {
+  // fast integral path: "%.12g" prints plain digits for up to 12 of them.
+  // The range check precedes the cast (out-of-range casts are undefined, and
+  // NaN fails every comparison); -0.0 is excluded (it prints "-0")
+  if (d > -1e12 && d < 1e12 && d == (double)(long long)d && !(d == 0 && signbit(d))) {
+    long long ll = (long long)d;
+    char tmp[24];
+    char *p = tmp + sizeof(tmp);
+    unsigned long long u = ll < 0 ? (unsigned long long)-ll : (unsigned long long)ll;
+    do {
+      *--p = '0' + u % 10;
+      u /= 10;
+    } while (u);
+    if (ll < 0) {
+      *--p = '-';
+    }
+    size_t n = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, n);
+    buf[n] = '\0';
+    return n;
+  }
+
+  for (int i = 0; i < NUM_MEMO_SLOTS; i++) {
+    if (numMemo_tls[i].valid && numMemo_tls[i].val == d) {
+      memcpy(buf, numMemo_tls[i].str, numMemo_tls[i].len + 1);
+      return numMemo_tls[i].len;
+    }
+  }
+  size_t n = snprintf(buf, 32, "%.12g", d);
+  if (n < sizeof(numMemo_tls[0].str)) {
+    uint8_t at = numMemoPos_tls++ % NUM_MEMO_SLOTS;
+    numMemo_tls[at].val = d;
+    numMemo_tls[at].len = n;
+    numMemo_tls[at].valid = 1;
+    memcpy(numMemo_tls[at].str, buf, n + 1);
+  }
+  return n;
+}
+
 /* Based on the value type, serialize the value into redis client response */
 int RSValue_SendReply(RedisModuleCtx *ctx, const RSValue *v, int isTyped) {
   v = RSValue_Dereference(v);
@@ -517,13 +608,13 @@ int RSValue_SendReply(RedisModuleCtx *ctx, const RSValue *v, int isTyped) {
     case RSValue_RedisString:
       return RedisModule_ReplyWithString(ctx, v->rstrval);
     case RSValue_Number: {
-      char buf[128];
-      snprintf(buf, sizeof(buf), "%.12g", v->numval);
+      char buf[32];
+      size_t n = RSValue_FormatNumber(v->numval, buf);
 
       if (isTyped) {
         return RedisModule_ReplyWithError(ctx, buf);
       } else {
-        return RedisModule_ReplyWithStringBuffer(ctx, buf, strlen(buf));
+        return RedisModule_ReplyWithStringBuffer(ctx, buf, n);
       }
     }
     case RSValue_Null:
@@ -45,8 +45,17 @@ typedef enum {
   RSString_SDS = 0x03,
   // Volatile strings are strings that need to be copied when retained
   RSString_Volatile = 0x04,
+  // The bytes live inside the value itself (strval.str points at the
+  // value's own inline buffer): no allocation, nothing to free, already
+  // persistent. Created automatically for short owned/volatile strings
+  RSString_Inline = 0x05,
 } RSStringType;
 
+/* Longest string stored inline in the value slot itself. One byte of the
+ * 16-byte slot is reserved for a NUL terminator: consumers like
+ * RSValue_ToNumber read inline strings as C strings */
+#define RSVALUE_INLINE_CAP 15
+
 #define RSVALUE_STATIC \
   { .allocated = 0 }
 
@@ -85,6 +94,13 @@ typedef struct RSValue {
 
     // reference to another value
     struct RSValue *ref;
+
+    // inline small-string storage: `data` lies past the fields strval uses,
+    // and strval.str points at it (see RSString_Inline)
+    struct {
+      char pad_[12];  // overlays strval's pointer/length/type
+      char data[RSVALUE_INLINE_CAP + 1];  // + NUL
+    } inl;
   };
   RSValueType t : 8;
   uint32_t refcount : 23;
@@ -348,6 +364,11 @@ static inline uint32_t RSValue_ArrayLen(const RSValue *arr) {
   return arr ? arr->arrval.len : 0;
 }
 
+/* Format a number exactly as "%.12g" would, through the integral fast path
+ * and the per-thread conversion memo. `buf` must hold at least 32 bytes;
+ * returns the length */
+size_t RSValue_FormatNumber(double d, char *buf);
+
 /* Based on the value type, serialize the value into redis client response */
 int RSValue_SendReply(RedisModuleCtx *ctx, const RSValue *v, int typed);
 
@@ -1,4 +1,5 @@
 #include "varint.h"
+#include "rmalloc.h"
 #include <assert.h>
 #include <ctype.h>
 #include <stdint.h>
@@ -113,3 +114,146 @@ size_t VVW_Write(VarintVectorWriter *w, uint32_t i) {
 size_t VVW_Truncate(VarintVectorWriter *w) {
   return Buffer_Truncate(&w->buf, 0);
 }
+
+/* ---- Elias-Fano packed offset vectors ---- */
+
+static inline void efSetBit(uint8_t *bm, size_t bit) {
+  bm[bit >> 3] |= 1u << (bit & 7);
+}
+
+size_t OffsetVector_PackedEncode(const uint32_t *pos, uint32_t n, Buffer *out) {
+  out->offset = 0;
+  BufferWriter bw = NewBufferWriter(out);
+  Buffer_WriteU8(&bw, OFFSETVECTOR_EF_TAG);
+  WriteVarint(n, &bw);
+
+  uint32_t U = pos[n - 1];
+  uint32_t l = 0;
+  while ((uint64_t)U >> (l + 1) >= n) {  // largest l with U/2^l >= n: ~log2(U/n)
+    l++;
+  }
+  Buffer_WriteU8(&bw, l);
+
+  size_t lowBytes = ((size_t)n * l + 7) / 8;
+  size_t highBits = ((size_t)(U >> l)) + n;
+  size_t highBytes = (highBits + 7) / 8;
+  WriteVarint(highBytes, &bw);
+
+  // fill both arrays in one zeroed scratch, then append it wholesale
+  char stack[512];
+  char *scratch = lowBytes + highBytes <= sizeof(stack) ? stack : rm_malloc(lowBytes + highBytes);
+  memset(scratch, 0, lowBytes + highBytes);
+  uint8_t *low = (uint8_t *)scratch, *high = (uint8_t *)scratch + lowBytes;
+  for (uint32_t i = 0; i < n; i++) {
+    if (l) {
+      size_t bit = (size_t)i * l;
+      uint64_t w = 0;
+      memcpy(&w, low + (bit >> 3), MIN(8, lowBytes - (bit >> 3)));
+      w |= (uint64_t)(pos[i] & ((1u << l) - 1)) << (bit & 7);
+      memcpy(low + (bit >> 3), &w, MIN(8, lowBytes - (bit >> 3)));
+    }
+    efSetBit(high, (size_t)(pos[i] >> l) + i);
+  }
+  Buffer_Write(&bw, scratch, lowBytes + highBytes);
+  if (scratch != stack) {
+    rm_free(scratch);
+  }
+  return out->offset;
+}
+
+int EFOffsetReader_Init(EFOffsetReader *r, const char *data, size_t len) {
+  Buffer b = {.data = (char *)data, .offset = len, .cap = len};
+  BufferReader br = NewBufferReader(&b);
+  BufferReader *rp = &br;
+  // a failed parse must leave a safe (empty) reader: callers may iterate anyway
+  memset(r, 0, sizeof(*r));
+  if (len < 4 || (uint8_t)data[0] != OFFSETVECTOR_EF_TAG) {
+    return 0;
+  }
+  Buffer_Skip(rp, 1);
+  uint32_t n = ReadVarint(rp);
+  uint8_t l = BUFFER_READ_BYTE(rp);
+  size_t highBytes = ReadVarint(rp);
+  size_t lowBytes = ((size_t)n * l + 7) / 8;
+  if (n == 0 || l > 31 || br.pos > len || lowBytes + highBytes != len - br.pos) {
+    return 0;
+  }
+  r->n = n;
+  r->lowBits = l;
+  r->low = (const uint8_t *)data + br.pos;
+  r->high = r->low + lowBytes;
+  r->end = (const uint8_t *)data + len;
+  r->highBits = highBytes * 8;
+  r->i = 0;
+  r->bitPos = 0;
+  return 1;
+}
+
+/* Load up to 8 bytes at `p`, bounded by the end of the blob */
+static inline uint64_t efLoad64(const uint8_t *p, const uint8_t *end) {
+  uint64_t w = 0;
+  memcpy(&w, p, MIN(8, (size_t)(end - p)));
+  return w;
+}
+
+static inline uint32_t efLow(const EFOffsetReader *r, uint32_t i) {
+  if (!r->lowBits) {
+    return 0;
+  }
+  size_t bit = (size_t)i * r->lowBits;
+  uint64_t w = efLoad64(r->low + (bit >> 3), r->end);
+  return (w >> (bit & 7)) & ((1u << r->lowBits) - 1);
+}
+
+/* Advance bitPos to the next set bit of the high bitmap, one word at a time */
+static inline int efSeekSetBit(EFOffsetReader *r) {
+  while (r->bitPos < r->highBits) {
+    size_t word = r->bitPos >> 6;
+    uint64_t w = efLoad64(r->high + word * 8, r->end);
+    w &= ~0ULL << (r->bitPos & 63);
+    if (w) {
+      r->bitPos = word * 64 + __builtin_ctzll(w);
+      return 1;
+    }
+    r->bitPos = (word + 1) * 64;
+  }
+  return 0;
+}
+
+uint32_t EFOffsetReader_Next(EFOffsetReader *r) {
+  if (r->i >= r->n || !efSeekSetBit(r)) {
+    return RS_OFFSETVECTOR_EOF;
+  }
+  uint32_t v = ((uint32_t)(r->bitPos - r->i) << r->lowBits) | efLow(r, r->i);
+  r->i++;
+  r->bitPos++;
+  return v;
+}
+
+uint32_t EFOffsetReader_SkipTo(EFOffsetReader *r, uint32_t x) {
+  uint32_t hx = x >> r->lowBits;
+  // fast-forward over whole words while every element in them has high < hx:
+  // an element's high value is its bit index minus its rank, so the last bit
+  // of a word bounds the word's largest possible high value
+  while (r->i < r->n) {
+    size_t word = r->bitPos >> 6;
+    size_t wordEnd = (word + 1) * 64;
+    if (wordEnd >= r->highBits || wordEnd - r->i < hx) {
+      // can't bound it (or the word may reach hx): fall to per-element scan
+      break;
+    }
+    uint64_t w = efLoad64(r->high + word * 8, r->end) & (~0ULL << (r->bitPos & 63));
+    uint32_t ones = __builtin_popcountll(w);
+    if ((uint32_t)(wordEnd - (r->i + ones)) < hx) {
+      // even the word's final bit would decode below hx: skip it wholesale
+      r->i += ones;
+      r->bitPos = wordEnd;
+      continue;
+    }
+    break;
+  }
+  uint32_t v;
+  while ((v = EFOffsetReader_Next(r)) != RS_OFFSETVECTOR_EOF && v < x) {
+  }
+  return v;
+}
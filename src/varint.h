@@ -41,6 +41,9 @@ static inline t_fieldMask ReadVarintFieldMask(BufferReader *b) {
 
 size_t WriteVarint(uint32_t value, BufferWriter *w);
 
+/* Append a varint directly to a buffer, which must have room reserved */
+size_t WriteVarintBuffer(uint32_t value, Buffer *buf);
+
 size_t WriteVarintFieldMask(t_fieldMask value, BufferWriter *w);
 
 typedef struct {
@@ -75,6 +78,54 @@ static inline void VVW_Reset(VarintVectorWriter *w) {
 #define VVW_OFFSETVECTOR_INIT(vvw) \
   { .data = VVW_GetByteData(vvw), .len = VVW_GetByteLength(vvw) }
 
+/* ---- Elias-Fano packed offset vectors (Index_PackedOffsets) ----
+ *
+ * An alternative wire format for RSOffsetVector payloads, selected per index:
+ * positions are split into `l` low bits, stored packed, and high bits, stored
+ * as a bitmap with bit (high_i + i) set. Space is n*(l + ~2) bits against the
+ * ~8 bits per position of small varint deltas, and the bitmap supports
+ * skipping to the first position >= x without decoding what came before.
+ *
+ * The blob starts with tag byte 0x00, which no varint-delta vector can start
+ * with: the first delta is the first token position, and positions are
+ * 1-based, while this varint flavor encodes 0 as the single byte 0x00 */
+#define OFFSETVECTOR_EF_TAG 0x00
+
+static inline int OffsetVector_IsPacked(const RSOffsetVector *v) {
+  return v->len > 0 && (uint8_t)v->data[0] == OFFSETVECTOR_EF_TAG;
+}
+
+/* Encode `n` (non-decreasing, 1-based) positions into `out`, replacing its
+ * contents. Returns the encoded size. n must be > 0 */
+size_t OffsetVector_PackedEncode(const uint32_t *pos, uint32_t n, Buffer *out);
+
+/* Sequential reader over a packed vector. Forward-only; Rewind restarts */
+typedef struct {
+  const uint8_t *low;
+  const uint8_t *high;
+  const uint8_t *end;  // end of the blob, bounding partial word loads
+  uint32_t n;
+  uint32_t lowBits;
+  size_t highBits;
+  uint32_t i;       // next element index
+  size_t bitPos;    // scan position in the high bitmap
+} EFOffsetReader;
+
+/* Returns 0 when the blob does not parse */
+int EFOffsetReader_Init(EFOffsetReader *r, const char *data, size_t len);
+
+/* Next position, or RS_OFFSETVECTOR_EOF at the end */
+uint32_t EFOffsetReader_Next(EFOffsetReader *r);
+
+/* First remaining position >= x (consumed), or RS_OFFSETVECTOR_EOF. Skips over
+ * the high bitmap by whole words without decoding the skipped elements */
+uint32_t EFOffsetReader_SkipTo(EFOffsetReader *r, uint32_t x);
+
+static inline void EFOffsetReader_Rewind(EFOffsetReader *r) {
+  r->i = 0;
+  r->bitPos = 0;
+}
+
 #ifdef __cplusplus
 }
 #endif